@@ -0,0 +1,34 @@
+# QuadGNSS fingerprint v1
+block_samples 16384
+samples 500000
+a4b6391a8f7ee01f
+843ec868996b4fc5
+ec4b4055727729de
+45bb0c3257bb1a7b
+43ea156653fb85c0
+39f307dc6a796a68
+2c7cd1c3e012fadb
+7ce1bcead6bd6b22
+311e2fbc996c784b
+a421bf38084e0e11
+22a966a2341c2e29
+90bdbcdc8faddf44
+ba537b764c3e95b3
+2c101d49bb0f63de
+852cc82176876bca
+9f447f687f64e6be
+ea42b4af249c32f4
+a8a6e9462363139b
+f9cc4165699a014a
+fda9044b21db72f9
+b791286e37260ae7
+fff1d868022779dc
+6c6f0bfbf5ba738d
+5f5417460691564a
+d55fc41a99e16030
+1707847b00a86f26
+40da2560a20b7631
+acc6d612f7eae4d7
+62fa378344a5d26b
+c0527c3646428108
+0ef69cc6fc0addc8
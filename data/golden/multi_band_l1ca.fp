@@ -0,0 +1,34 @@
+# QuadGNSS fingerprint v1
+block_samples 16384
+samples 500000
+48e7d7b5d49bb338
+3023c94d48c36fec
+8e3e666ee06fd7c0
+cfcac690682fcda8
+11f6eda68c52e1ce
+e7ee1e3278c5406f
+c5a704b861aa0f68
+d41518391b65a1ac
+295b1de5e7f3d339
+08157d63030dbaac
+ce1ebe3e22601685
+d2209b5594bfe6b1
+054bbd603b902d17
+4e9a2e8dd9dec17b
+1399ac0cc943a1ee
+9246dfa3ac9aac22
+d8c103c7f9455532
+94ff72d1c2c8b479
+4fb6e6f5757ed7c7
+7bda9fc168ac5178
+84c7f8a9939896a7
+5502d79874651721
+6391954c213b5dab
+8a5c52d31667b079
+09fbeeb1237a2856
+9048487f6d03371e
+efb99ab23f5fb562
+fd424751659e9830
+d4a1542a57d3f32c
+905c1a05487f3fe0
+111700fd598c8f86
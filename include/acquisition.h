@@ -0,0 +1,135 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "multi_band.h"
+
+namespace QuadGNSS {
+
+// Search parameters of the acquisition verifier
+struct AcquisitionSettings {
+    double sampling_rate_hz;
+    double center_frequency_hz;
+    double integration_ms = 10.0;              // Non-coherent span (at least two code periods are used)
+    double doppler_span_hz = 5000.0;           // Search +/- span around zero
+    double doppler_step_hz = 0.0;              // 0 = a third of the coherent bandwidth
+    double detection_ratio = 2.0;              // Peak over second peak (power) needed to declare a detection
+    size_t threads = 0;                        // 0 = hardware concurrency
+};
+
+// One PRN to search for, with optional truth to compare against
+struct AcquisitionTarget {
+    SignalBand band;
+    int prn;
+    int frequency_channel = 0;                 // FDMA channel k (GLONASS only)
+    bool has_truth = false;
+    double expected_code_phase_chips = 0.0;    // Code phase at the first sample
+    double expected_doppler_hz = 0.0;
+    double expected_cn0_dbhz = std::numeric_limits<double>::quiet_NaN();   // NaN = not checked
+};
+
+struct AcquisitionResult {
+    SignalBand band;
+    int prn;
+    bool pilot;                                // Searched on the pilot component
+    bool detected;
+    double peak_ratio;
+    double code_phase_chips;
+    double doppler_hz;
+    double cn0_dbhz;
+
+    // Differences to the target truth (NaN without truth)
+    double code_phase_error_chips;             // Wrapped to +/- half a code period
+    double doppler_error_hz;
+    double cn0_error_db;
+};
+
+struct AcquisitionTolerance {
+    double code_phase_chips = 0.25;
+    double doppler_hz = 25.0;
+    double cn0_db = 2.0;
+};
+
+/**
+ * Check a result against its truth
+ * @return true if the PRN was detected and every known truth value is within tolerance
+ */
+bool within_tolerance(const AcquisitionResult& result, const AcquisitionTolerance& tolerance = AcquisitionTolerance());
+
+/**
+ * Expected acquisition of a satellite, as the multi-band renderer draws it
+ * @param backbone Backbone updated for the block (geometry is extrapolated to block_time)
+ * @param satellite Satellite of the band's constellation
+ * @param band Signal band
+ * @param block_time GPS time of the first sample of the block (s)
+ * @throws QuadGNSSException if the satellite is not of the band's constellation
+ */
+AcquisitionTarget make_acquisition_target(const SatelliteBackbone& backbone, const BackboneSatellite& satellite,
+                                          SignalBand band, double block_time);
+
+/**
+ * Parallel FFT acquisition verifier
+ *
+ * Coarse search: each code period is carrier-wiped at the band's nominal
+ * offset (the satellite's channel offset for FDMA bands), averaged into a power-of-two number of bins and circularly
+ * correlated with the PRN replica by FFT for every Doppler bin; periods
+ * are combined non-coherently. (PRN, Doppler bin) pairs run in parallel.
+ *
+ * Fine stage, per detected PRN at the full sample rate: Doppler from the
+ * squared phase rotation between periods (immune to data and secondary
+ * code flips), code phase from early/prompt/late interpolation and C/N0
+ * from prompt power against correlations at distant code offsets. Code
+ * replicas come from the renderer's own code generators; BOC(1,1) replicas
+ * carry the subcarrier, and their early/late spacing stays inside the
+ * central peak of the BOC correlation.
+ */
+class AcquisitionEngine {
+public:
+    /**
+     * Constructor
+     * @param settings Search parameters
+     * @param codes Shared code cache (nullptr = private cache)
+     * @throws QuadGNSSException on invalid settings
+     */
+    explicit AcquisitionEngine(const AcquisitionSettings& settings, std::shared_ptr<BandCodeCache> codes = nullptr);
+
+    /**
+     * Samples a block must hold to search a band
+     * @param frequency_channel FDMA channel k searched (GLONASS only)
+     * @throws QuadGNSSException if the band does not fit the stream or is too coarsely sampled
+     */
+    size_t required_samples(SignalBand band, int frequency_channel = 0) const;
+
+    /**
+     * Search every target in one block
+     * @param samples Interleaved complex int16 block starting at the targets' reference time
+     * @param sample_count Block length
+     * @param targets PRNs to search
+     * @return One result per target, in target order
+     * @throws QuadGNSSException if the block is shorter than required_samples() of a target band
+     */
+    std::vector<AcquisitionResult> acquire(const std::complex<int16_t>* samples, size_t sample_count,
+                                           const std::vector<AcquisitionTarget>& targets);
+
+    uint64_t get_fft_count() const { return fft_count_; }
+    double get_last_elapsed() const { return last_elapsed_s_; }
+
+private:
+    struct BandPlan;
+    struct SearchTask;
+
+    AcquisitionSettings settings_;
+    std::shared_ptr<BandCodeCache> codes_;
+    uint64_t fft_count_;
+    double last_elapsed_s_;
+
+    BandPlan plan_band(SignalBand band, int frequency_channel) const;
+};
+
+} // namespace QuadGNSS
+
+#endif // ACQUISITION_H
@@ -0,0 +1,131 @@
+#ifndef ASYNC_FILE_SINK_H
+#define ASYNC_FILE_SINK_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+enum class FileSinkBackend {
+    AUTO = 0,           // io_uring if the kernel allows it, otherwise THREAD_POOL
+    IO_URING = 1,       // Registered-buffer writes through io_uring
+    THREAD_POOL = 2     // pwrite() from a pool of writer threads
+};
+
+struct FileSinkOptions {
+    FileSinkBackend backend = FileSinkBackend::AUTO;
+    size_t buffer_bytes = 4 * 1024 * 1024;       // Size of each write (multiple of 4 KiB)
+    uint32_t queue_depth = 8;                    // Writes in flight (= number of buffers)
+    bool direct_io = true;                       // O_DIRECT, dropped if the filesystem refuses it
+    uint32_t writer_threads = 2;                 // THREAD_POOL only
+};
+
+struct FileSinkStats {
+    FileSinkBackend backend;                     // Backend actually in use
+    bool direct_io;
+    bool registered_buffers;                     // io_uring fixed buffers active
+    uint64_t bytes_accepted;                     // Bytes passed to write()
+    uint64_t bytes_written;                      // Bytes completed on disk (incl. O_DIRECT tail padding)
+    uint64_t writes_submitted;
+    uint64_t writes_completed;
+    uint32_t in_flight;
+    uint32_t max_in_flight;
+    double mean_in_flight;                       // Queue depth sampled at each submission
+    uint64_t producer_stalls;                    // write() calls that waited for a free buffer
+    double elapsed_s;
+    double bandwidth_mb_s;                       // bytes_written / elapsed_s
+};
+
+class FileWriteEngine;
+
+/**
+ * Asynchronous file sink for long recordings
+ *
+ * write() copies samples into one of queue_depth page-aligned buffers. Each
+ * full buffer becomes a single large write at a fixed file offset, so up to
+ * queue_depth writes are in flight while the generator keeps running; the
+ * generator only waits when every buffer is still owned by the kernel.
+ *
+ * The io_uring backend registers the buffers once and submits
+ * IORING_OP_WRITE_FIXED requests; if io_uring is unavailable (old kernel,
+ * seccomp, container policy) AUTO falls back to a pthread writer pool. With
+ * O_DIRECT the final partial buffer is zero-padded to 4 KiB and the file is
+ * truncated back to its logical size on close().
+ */
+class AsyncFileSink {
+public:
+    /**
+     * Create (truncate) the output file and set up the write backend
+     * @param path Output file path
+     * @param options Buffering and backend options
+     * @throws QuadGNSSException if the file or the requested backend cannot be set up
+     */
+    AsyncFileSink(const std::string& path, const FileSinkOptions& options = FileSinkOptions());
+    ~AsyncFileSink();
+
+    AsyncFileSink(const AsyncFileSink&) = delete;
+    AsyncFileSink& operator=(const AsyncFileSink&) = delete;
+
+    /**
+     * Append bytes to the file
+     * @throws QuadGNSSException if an earlier write failed
+     */
+    void write(const void* data, size_t bytes);
+
+    /**
+     * Wait until every submitted write has completed
+     * The partially filled buffer stays staged until close().
+     */
+    void drain();
+
+    /**
+     * Write the staged tail, wait for all writes and close the file
+     * @throws QuadGNSSException if any write failed
+     */
+    void close();
+
+    FileSinkStats get_stats() const;
+    const std::string& get_path() const { return path_; }
+    const FileSinkOptions& get_options() const { return options_; }
+
+    static const char* backend_name(FileSinkBackend backend);
+
+private:
+    struct AlignedFree {
+        void operator()(char* data) const { std::free(data); }
+    };
+
+    struct Buffer {
+        std::unique_ptr<char, AlignedFree> data;   // std::aligned_alloc() block, freed even if the constructor throws
+        size_t length;                           // Bytes submitted
+        size_t done;                             // Bytes completed (short writes resubmit the rest)
+        uint64_t file_offset;
+    };
+
+    std::string path_;
+    FileSinkOptions options_;
+    int fd_;
+    std::unique_ptr<FileWriteEngine> engine_;
+    std::vector<Buffer> buffers_;
+    std::vector<uint32_t> free_buffers_;
+    int current_;                                // Buffer being filled, -1 if none
+    size_t current_fill_;
+    uint64_t file_offset_;
+    std::string error_;
+    FileSinkStats stats_;
+    double in_flight_sum_;
+    int64_t start_ns_;
+
+    uint32_t acquire_buffer();
+    void submit_buffer(uint32_t index, size_t length);
+    void reap(bool wait);
+    void check_error() const;
+};
+
+} // namespace QuadGNSS
+
+#endif // ASYNC_FILE_SINK_H
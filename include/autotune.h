@@ -0,0 +1,136 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "multi_band.h"
+#include "scenario.h"
+
+namespace QuadGNSS {
+
+// Work the generator is tuned for: what is rendered, not how
+struct TuningWorkload {
+    double sampling_rate_hz;
+    std::vector<BandStreamConfig> bands;
+    std::vector<StreamSatellite> satellites;
+
+    // Cache key: sample rate, bands and satellite count
+    std::string key() const;
+};
+
+/**
+ * Workload of a compiled scenario
+ * @return The plan's multi-band streams and the satellites rendered on them
+ */
+TuningWorkload workload_for_plan(const ExecutionPlan& plan);
+
+// One generator configuration
+struct TuningConfig {
+    double chunk_duration_s = 0.01;
+    int render_tile = 0;                       // MultiBandGenerator::set_render_tile() (0 = whole epoch)
+    size_t threads = 1;                        // Lanes rendering chunks in parallel
+    double msps = 0.0;                         // Measured stream throughput
+};
+
+struct AutotuneSettings {
+    std::vector<double> chunk_durations_s = {0.001, 0.002, 0.005, 0.01, 0.02};
+    std::vector<int> render_tiles = {0, 1024, 4096, 16384};
+    std::vector<size_t> threads;               // Empty = 1, 2, 4, ... and the hardware concurrency
+    double span_s = 0.04;                      // Signal rendered per measurement (at least one chunk per lane)
+    int repeats = 3;                           // Best of, to reject scheduler noise
+    double min_gain = 0.03;                    // Relative speed-up needed to move away from the current choice
+};
+
+/**
+ * Generator autotuner
+ *
+ * Micro-benchmarks MultiBandGenerator on the current host for one
+ * workload. The candidates are searched one axis at a time, starting
+ * from the built-in defaults: render tile (one lane, 10 ms chunks), then
+ * chunk duration, then lane count. A candidate only replaces the current
+ * choice when it is min_gain faster, so measurement noise does not trade
+ * the defaults for an equivalent configuration. Output samples are the
+ * same for every configuration; only throughput is compared.
+ */
+class Autotuner {
+public:
+    /**
+     * Constructor
+     * @param settings Candidates and measurement budget
+     * @param codes Shared code cache (nullptr = private cache)
+     */
+    explicit Autotuner(const AutotuneSettings& settings = AutotuneSettings(),
+                       std::shared_ptr<BandCodeCache> codes = nullptr);
+
+    /**
+     * Find the fastest configuration
+     * @return Winning configuration with its measured throughput
+     * @throws QuadGNSSException if the workload has no bands or no chunk duration fits the sample rate
+     */
+    TuningConfig tune(const TuningWorkload& workload);
+
+    /**
+     * Measure one configuration
+     * @return Stream samples per second (MSps), best of the configured repeats
+     */
+    double measure(const TuningWorkload& workload, const TuningConfig& config);
+
+    // Every configuration measured by tune(), in order
+    const std::vector<TuningConfig>& get_measurements() const { return measurements_; }
+
+private:
+    AutotuneSettings settings_;
+    std::shared_ptr<BandCodeCache> codes_;
+    std::vector<TuningConfig> measurements_;
+};
+
+/**
+ * Per-host tuning cache
+ *
+ * Maps (CPU model, workload key) to the winning configuration, so a
+ * tuning run on one machine is reused by every later start on the same
+ * kind of host and ignored on the others. The file is text: a
+ * "# QuadGNSS tuning v1" line, then one tab-separated entry per line
+ * (CPU model, workload key, chunk duration, render tile, threads, MSps).
+ */
+class TuningCache {
+public:
+    /**
+     * Open a cache file; a missing file is an empty cache
+     * @throws QuadGNSSException if the file exists but is malformed
+     */
+    explicit TuningCache(const std::string& path);
+
+    bool lookup(const std::string& cpu_model, const std::string& workload_key, TuningConfig& config) const;
+    void store(const std::string& cpu_model, const std::string& workload_key, const TuningConfig& config);
+
+    /**
+     * Write every entry back (atomically, through a temporary file)
+     * @throws QuadGNSSException if the file cannot be written
+     */
+    void save() const;
+
+    const std::string& get_path() const { return path_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    std::string path_;
+    std::map<std::pair<std::string, std::string>, TuningConfig> entries_;
+};
+
+/**
+ * CPU model of this host, as the cache key
+ * @return Model name from /proc/cpuinfo and the logical CPU count, e.g. "AMD EPYC 7B13 (8 threads)"
+ */
+std::string host_cpu_model();
+
+// $QUADGNSS_TUNING_CACHE, else ~/.quadgnss_tuning, else ./quadgnss_tuning
+std::string default_tuning_cache_path();
+
+} // namespace QuadGNSS
+
+#endif // AUTOTUNE_H
@@ -0,0 +1,218 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "autotune.h"
+#include "multi_band.h"
+#include "numa_placement.h"
+#include "scenario.h"
+
+namespace QuadGNSS {
+
+// Outcome of one batch job
+struct BatchJobResult {
+    std::string name;
+    bool ok;
+    std::string error;                         // Compile or run failure
+    size_t cores;                              // Cores the job was packed with
+    std::vector<std::string> bands;            // Signals rendered into the scenario stream
+    uint64_t chunks;
+    uint64_t samples;
+    double wall_s;                             // First chunk start to last chunk end
+    double msps;                               // Generated samples per second of wall time
+    double realtime_factor;                    // Scenario seconds per wall second
+    uint64_t checksum;                         // FNV-1a over the output chunks in order
+    bool tuned;                                // Render tile and core cap came from the tuning cache
+};
+
+// Process-wide view of one run() call
+struct BatchStats {
+    size_t jobs;
+    size_t failed;
+    size_t core_budget;
+    size_t worker_threads;                     // Started once, reused by every job and run()
+    size_t ephemeris_parses;                   // Distinct navigation files parsed
+    size_t code_tables;                        // Distinct spreading codes generated
+    size_t numa_nodes;                         // Nodes of the topology workers are placed on
+    size_t pinned_workers;                     // Workers pinned to a CPU (0 = floating)
+    double wall_s;
+    double aggregate_msps;
+};
+
+/**
+ * Multi-band signals rendered for a plan
+ * @return The plan's bands (ExecutionPlan::get_bands()) at the stream centre; every constellation has one
+ */
+std::vector<BandStreamConfig> bands_for_plan(const ExecutionPlan& plan);
+
+/**
+ * Check that a plan's stream is exactly what PlanRenderer renders
+ *
+ * A scenario pipeline runs chunk after chunk on the live stream (see
+ * quad_gnss_sim), so consumers that render chunks independently cannot
+ * honour it.
+ * @param consumer Name used in the error
+ * @throws QuadGNSSException if the plan has a processing pipeline
+ */
+void require_no_pipeline(const ExecutionPlan& plan, const std::string& consumer);
+
+/**
+ * Renderer of a plan's scenario stream
+ *
+ * Sets up a MultiBandGenerator with the plan's satellites, ephemerides,
+ * receiver trajectory and bands_for_plan() bands, and renders chunks of
+ * the single summed stream by index. Chunks are independent, so any
+ * number of renderers can share a plan and render chunks in any order.
+ */
+class PlanRenderer {
+public:
+    /**
+     * Constructor
+     * @param plan Compiled scenario
+     * @param codes Shared code cache (nullptr = private cache)
+     * @param render_tile Generator render tile (see MultiBandGenerator::set_render_tile)
+     */
+    PlanRenderer(std::shared_ptr<const ExecutionPlan> plan, std::shared_ptr<BandCodeCache> codes = nullptr,
+                 int render_tile = 0);
+
+    // The generator's receiver callback points back at the renderer
+    PlanRenderer(const PlanRenderer&) = delete;
+    PlanRenderer& operator=(const PlanRenderer&) = delete;
+
+    /**
+     * Render one chunk of the summed stream
+     * @param chunk Chunk index from the scenario start
+     * @param output get_chunk_samples() samples
+     */
+    void render(uint64_t chunk, std::complex<int16_t>* output);
+
+    /**
+     * Apply a control command from the next render() on
+     *
+     * Power and enable/disable change one rendered satellite; a receiver
+     * position replaces the plan's trajectory from then on. Chunks rendered
+     * afterwards are no longer a pure function of the plan.
+     * @return false if the command names a satellite that is not rendered
+     */
+    bool apply_command(const ControlCommand& command);
+
+    const ExecutionPlan& plan() const { return *plan_; }
+    const std::vector<BandStreamConfig>& get_bands() const { return generator_.get_bands(); }
+    const MultiBandGenerator& generator() const { return generator_; }
+
+private:
+    std::shared_ptr<const ExecutionPlan> plan_;
+    MultiBandGenerator generator_;
+    std::vector<std::vector<std::complex<int16_t>>> band_buffers_;
+    std::vector<std::complex<int16_t>*> buffers_;
+    bool receiver_fixed_ = false;              // A position command replaced the trajectory
+    double receiver_[3] = {0.0, 0.0, 0.0};
+};
+
+/**
+ * Batch scenario runner
+ *
+ * Runs many short scenarios in one process. Immutable state is built once
+ * and shared by every job: parsed ephemerides (EphemerisCache), spreading
+ * codes (BandCodeCache), carrier tables and the worker threads. Jobs are
+ * packed onto the core budget: each job asks for the "threads" of its
+ * scenario (capped by the budget), and jobs are started in list order
+ * whenever enough cores are free, letting smaller jobs fill gaps.
+ *
+ * A job renders the bands of its scenario plan (ExecutionPlan::get_bands()),
+ * so every constellation of the scenario is in the stream; a scenario with
+ * a constellation no band renders already fails to compile. Its chunks are
+ * independent (the renderer is a pure function of time), so the job's
+ * cores render chunks in parallel and write them to the scenario's file
+ * sinks at their final offsets. Other sink types are ignored; the per-job
+ * checksum identifies the stream instead.
+ *
+ * With a tuning cache, a job whose workload was tuned on this CPU model
+ * renders with the tuned tile and takes no more cores than the tuned
+ * lane count. The scenario chunk duration is kept: it fixes the file
+ * layout and the checksum.
+ *
+ * On hosts with more than one NUMA node the workers are pinned to CPUs
+ * taken from the nodes in turn (CpuTopology::placement). A lane allocates
+ * its renderer and chunk buffer on its own worker, so first touch puts
+ * them on the worker's node; the chunk buffer uses huge pages when large.
+ */
+class BatchRunner {
+public:
+    /**
+     * Constructor
+     * @param core_budget Concurrent cores (0 = hardware concurrency)
+     */
+    explicit BatchRunner(size_t core_budget = 0);
+    ~BatchRunner();
+
+    BatchRunner(const BatchRunner&) = delete;
+    BatchRunner& operator=(const BatchRunner&) = delete;
+
+    /**
+     * Queue a scenario; compile errors are reported as failed jobs by run()
+     * @param name Job name (the scenario name is used when empty)
+     */
+    void add_scenario(const std::string& json_text, const std::string& name = "",
+                      const std::string& base_dir = "");
+    void add_scenario_file(const std::string& path);
+
+    /**
+     * Pin the workers to CPUs of a topology
+     * @return Workers pinned; the others keep floating
+     */
+    size_t set_topology(const CpuTopology& topology);
+
+    // Apply tuned settings from this cache to later run()s (nullptr = untuned)
+    void set_tuning_cache(std::shared_ptr<const TuningCache> cache) { tuning_ = std::move(cache); }
+
+    /**
+     * Run every queued job and clear the queue
+     * @return One result per job, in the order the jobs were added
+     */
+    std::vector<BatchJobResult> run();
+
+    const BatchStats& get_stats() const { return stats_; }
+    EphemerisCache& ephemeris_cache() { return ephemeris_; }
+    const std::shared_ptr<BandCodeCache>& code_cache() const { return codes_; }
+
+private:
+    struct Job;
+
+    size_t core_budget_;
+    EphemerisCache ephemeris_;
+    std::shared_ptr<BandCodeCache> codes_;
+    std::shared_ptr<const TuningCache> tuning_;
+    std::vector<std::unique_ptr<Job>> pending_;
+    BatchStats stats_;
+
+    // Persistent workers; each one serves a lane of an active job at a time
+    std::vector<std::thread> workers_;
+    size_t numa_nodes_;
+    size_t pinned_workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::vector<Job*> queue_;                  // Jobs of the current run, in order
+    size_t next_queued_;
+    size_t cores_in_use_;
+    size_t jobs_outstanding_;
+    bool stopping_;
+
+    void worker_loop();
+    Job* claim_lane_locked();
+    void run_lane(Job& job);
+    void finish_job_locked(Job& job);
+};
+
+} // namespace QuadGNSS
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,262 @@
+#ifndef CONTROL_PLANE_H
+#define CONTROL_PLANE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+/**
+ * Bounded lock-free multi-producer, single-consumer command queue
+ *
+ * Each cell carries a sequence number (Vyukov bounded queue), so producers
+ * claim slots with one CAS and the consumer never waits on a producer.
+ * try_push() fails instead of blocking when the queue is full.
+ */
+class ControlCommandQueue {
+private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        ControlCommand command;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    uint64_t mask_;
+    alignas(64) std::atomic<uint64_t> enqueue_pos_;
+    alignas(64) uint64_t dequeue_pos_;          // Single consumer
+
+public:
+    /**
+     * Constructor
+     * @param capacity Queue capacity (rounded up to a power of two)
+     */
+    explicit ControlCommandQueue(size_t capacity = 1024);
+
+    ControlCommandQueue(const ControlCommandQueue&) = delete;
+    ControlCommandQueue& operator=(const ControlCommandQueue&) = delete;
+
+    /**
+     * Push a command (any thread)
+     * @return false if the queue is full
+     */
+    bool try_push(const ControlCommand& command);
+
+    /**
+     * Pop the oldest command (consumer thread only)
+     * @return false if the queue is empty
+     */
+    bool try_pop(ControlCommand& command);
+
+    size_t capacity() const { return static_cast<size_t>(mask_ + 1); }
+};
+
+/**
+ * Control commands waiting for their target sample (generation thread only)
+ *
+ * Commands drained from a ControlCommandQueue are kept ordered by target
+ * sample, stable for equal stamps, in storage allocated once by the
+ * constructor. A command arriving while every slot is taken is dropped
+ * and counted, so draining and applying never allocate.
+ */
+class ControlCommandSchedule {
+public:
+    /**
+     * Constructor
+     * @param capacity Most commands pending at once
+     */
+    explicit ControlCommandSchedule(size_t capacity = 1024);
+
+    ControlCommandSchedule(const ControlCommandSchedule&) = delete;
+    ControlCommandSchedule& operator=(const ControlCommandSchedule&) = delete;
+
+    /**
+     * Schedule a command
+     * @return false (and the command is counted as dropped) if the schedule is full
+     */
+    bool add(const ControlCommand& command);
+
+    /**
+     * Schedule every command waiting in a queue
+     * @return Commands dropped because the schedule was full
+     */
+    size_t drain(ControlCommandQueue& queue);
+
+    /**
+     * Apply, in order, every command due at a sample and remove it
+     * @param apply Callable taking the command and returning whether anything accepted it
+     * @return Commands applied or rejected
+     */
+    template <typename Apply>
+    size_t apply_due(uint64_t sample_index, Apply&& apply) {
+        size_t due = 0;
+        while (due < count_ && commands_[due].apply_at_sample <= sample_index) {
+            if (apply(static_cast<const ControlCommand&>(commands_[due]))) {
+                applied_++;
+            } else {
+                rejected_++;
+            }
+            due++;
+        }
+        std::move(commands_.get() + due, commands_.get() + count_, commands_.get());
+        count_ -= due;
+        return due;
+    }
+
+    // Target sample of the earliest pending command (UINT64_MAX when none is pending)
+    uint64_t next_sample() const;
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return capacity_; }
+    uint64_t get_applied_count() const { return applied_; }
+    uint64_t get_rejected_count() const { return rejected_; }   // Applied, but nothing accepted them
+    uint64_t get_dropped_count() const { return dropped_; }     // Never scheduled: the schedule was full
+
+private:
+    std::unique_ptr<ControlCommand[]> commands_;
+    size_t capacity_;
+    size_t count_;
+    uint64_t applied_;
+    uint64_t rejected_;
+    uint64_t dropped_;
+};
+
+// Text command parsing and validation
+class ControlCommandParser {
+public:
+    /**
+     * Parse one command line
+     *
+     * Grammar (one command per line, '#' starts a comment):
+     *   power   <constellation> <prn> <dbm>  [@<when>]
+     *   enable  <constellation> <prn>        [@<when>]
+     *   disable <constellation> <prn>        [@<when>]
+     *   position <x_m> <y_m> <z_m>           [@<when>]
+     * where <when> is an absolute sample index (@123456) or a delay in
+     * seconds relative to the current sample (@+0.25).
+     *
+     * @param line Command text
+     * @param current_sample Sample index used for relative timestamps
+     * @param sampling_rate_hz Sample rate used for relative timestamps
+     * @return Validated command
+     * @throws QuadGNSSException if the command is malformed or out of range
+     */
+    static ControlCommand parse(const std::string& line,
+                                uint64_t current_sample,
+                                double sampling_rate_hz);
+
+    /**
+     * Parse a constellation name (GPS, GLONASS, GALILEO, BEIDOU; case-insensitive)
+     * @throws QuadGNSSException if the name is unknown
+     */
+    static ConstellationType parse_constellation(const std::string& name);
+
+    /**
+     * Highest valid PRN for a constellation
+     */
+    static int max_prn(ConstellationType type);
+};
+
+/**
+ * Control command server
+ *
+ * Reads newline-terminated commands from stdin or a local UNIX socket on a
+ * background thread, validates them and pushes them into the queue. Replies
+ * "OK" or "ERR <reason>" per line (stdin replies go to stderr, since stdout
+ * carries the IQ stream). The generation thread is never involved.
+ */
+class ControlServer {
+public:
+    static constexpr size_t MAX_LINE_BYTES = 4096;  // Longer lines are rejected, not buffered
+
+    /**
+     * Constructor
+     * @param queue Destination queue drained by the generation thread (SignalOrchestrator, quad_gnss_sim)
+     * @param sampling_rate_hz Sample rate used for relative timestamps
+     * @param sample_clock Returns the current sample index (may be empty)
+     */
+    ControlServer(ControlCommandQueue& queue,
+                  double sampling_rate_hz,
+                  std::function<uint64_t()> sample_clock = nullptr);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    /**
+     * Restrict satellite commands to the satellites being generated
+     *
+     * Commands naming any other satellite are answered with an ERR reply
+     * instead of being queued (receiver commands are unaffected). Without a
+     * list, every PRN the parser accepts is queued. Call before start_*().
+     * @param satellites Constellation and PRN of every satellite, e.g. SignalOrchestrator::get_satellite_ids()
+     */
+    void set_satellites(const std::vector<std::pair<ConstellationType, int>>& satellites);
+
+    /**
+     * Start reading commands from standard input
+     * @throws QuadGNSSException if the server is already running
+     */
+    void start_stdin();
+
+    /**
+     * Start listening on a UNIX stream socket
+     * @param path Filesystem path of the socket (replaced if it exists)
+     * @throws QuadGNSSException if the socket cannot be created
+     */
+    void start_unix_socket(const std::string& path);
+
+    /**
+     * Stop the server thread and close all descriptors
+     */
+    void stop();
+
+    /**
+     * Parse, validate and enqueue one command line
+     * @return Reply text without trailing newline (empty for blank/comment lines)
+     */
+    std::string handle_line(const std::string& line);
+
+    uint64_t get_accepted_count() const { return accepted_.load(); }
+    uint64_t get_rejected_count() const { return rejected_.load(); }
+
+private:
+    ControlCommandQueue& queue_;
+    double sampling_rate_hz_;
+    std::function<uint64_t()> sample_clock_;
+    std::vector<std::pair<ConstellationType, int>> satellites_;   // Sorted; empty = not restricted
+
+    std::thread thread_;
+    int wake_pipe_[2];
+    int listen_fd_;
+    std::string socket_path_;
+
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> rejected_;
+
+    // Partial line of one input (stdin or a socket client)
+    struct LineBuffer {
+        std::string pending;
+        bool discarding = false;               // Skipping the rest of an overlong line
+    };
+
+    /**
+     * Append input and handle every complete line
+     * @return false when the pending line outgrew MAX_LINE_BYTES (it is dropped up to its newline)
+     */
+    bool consume(LineBuffer& buffer, const char* data, size_t size,
+                 const std::function<void(const std::string&)>& reply);
+
+    void run_stdin_loop();
+    void run_socket_loop();
+};
+
+} // namespace QuadGNSS
+
+#endif // CONTROL_PLANE_H
@@ -0,0 +1,47 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace QuadGNSS {
+
+/**
+ * Radix-2 complex FFT on split real/imaginary arrays
+ *
+ * Each butterfly stage walks contiguous runs of both arrays with a
+ * per-stage twiddle table, so the inner loop is unit-stride and the
+ * compiler vectorises it (SSE/AVX at -O2 and above) without intrinsics.
+ * Tables are built once; one instance may be shared by any number of
+ * threads.
+ */
+class Fft {
+public:
+    /**
+     * Constructor
+     * @param size Transform length (power of two)
+     * @throws QuadGNSSException if size is not a power of two
+     */
+    explicit Fft(size_t size);
+
+    size_t size() const { return size_; }
+
+    // In-place forward transform, natural order in and out
+    void forward(float* re, float* im) const { transform(re, im, 1.0f); }
+
+    // In-place inverse transform (unscaled)
+    void inverse(float* re, float* im) const { transform(re, im, -1.0f); }
+
+private:
+    size_t size_;
+    std::vector<float> twiddle_re_;            // Stage tables back to back: stage with span h at [h - 1, 2h - 1)
+    std::vector<float> twiddle_im_;
+    std::vector<uint32_t> reversed_;
+
+    void transform(float* re, float* im, float sign) const;
+};
+
+} // namespace QuadGNSS
+
+#endif // FFT_H
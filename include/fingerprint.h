@@ -0,0 +1,88 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+// Outcome of comparing a run against a golden record
+struct FingerprintComparison {
+    bool match;
+    uint64_t blocks_compared;
+    int64_t first_mismatch;                    // First differing block (-1 = none)
+    std::string message;                       // Human-readable summary
+};
+
+/**
+ * Per-block fingerprint of a sample stream
+ *
+ * Hashes the stream in fixed blocks of block_samples samples. Blocks are
+ * cut by sample count, not by append() calls, so a stream fingerprints the
+ * same however it was chunked, and a mismatch against a golden record
+ * points at the first block that changed.
+ *
+ * The hash is a 64-bit multiply-rotate over one (I, Q) word per sample,
+ * finalised per block with the block length; it is not cryptographic, only
+ * fast enough to leave on during regression runs of optimized builds.
+ *
+ * Records are text: a "# QuadGNSS fingerprint v1" line, "block_samples N",
+ * "samples N", then one hexadecimal hash per block (the last block may be
+ * partial).
+ */
+class StreamFingerprint {
+public:
+    static constexpr uint64_t DEFAULT_BLOCK_SAMPLES = 1 << 16;
+
+    /**
+     * Constructor
+     * @param block_samples Samples per hash
+     * @throws QuadGNSSException if block_samples is zero
+     */
+    explicit StreamFingerprint(uint64_t block_samples = DEFAULT_BLOCK_SAMPLES);
+
+    void append(const std::complex<int16_t>* samples, size_t count);
+
+    // Close the partial last block, if any (further append()s start a new block)
+    void finish();
+
+    /**
+     * Write the record (finish() is called first)
+     * @throws QuadGNSSException if the file cannot be written
+     */
+    void save(const std::string& path);
+
+    /**
+     * Read a record written by save()
+     * @throws QuadGNSSException if the file is missing or malformed
+     */
+    static StreamFingerprint load(const std::string& path);
+
+    const std::vector<uint64_t>& get_hashes() const { return hashes_; }
+    uint64_t get_block_samples() const { return block_samples_; }
+    uint64_t get_samples() const { return samples_; }
+
+private:
+    uint64_t block_samples_;
+    uint64_t samples_;
+    uint64_t block_fill_;                      // Samples in the open block
+    uint64_t state_;
+    std::vector<uint64_t> hashes_;
+
+    void close_block();
+};
+
+/**
+ * Compare a run against a golden record
+ * @param golden Stored record
+ * @param actual Fingerprint of the run under test (finished)
+ * @return Mismatch when block sizes, lengths or any block hash differ
+ */
+FingerprintComparison compare_fingerprints(const StreamFingerprint& golden, const StreamFingerprint& actual);
+
+} // namespace QuadGNSS
+
+#endif // FINGERPRINT_H
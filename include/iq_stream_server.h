@@ -0,0 +1,175 @@
+#ifndef IQ_STREAM_SERVER_H
+#define IQ_STREAM_SERVER_H
+
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+// What a subscriber's queue does when the subscriber falls behind
+enum class BackPressurePolicy {
+    DROP = 0,        // Discard new chunks while the queue is full
+    BLOCK = 1,       // Make publish() wait for the subscriber (stalls generation)
+    DECIMATE = 2     // While lagging, forward only every Nth chunk
+};
+
+// Optional per-chunk framing header (little-endian, precedes the IQ payload)
+#pragma pack(push, 1)
+struct StreamFrameHeader {
+    static constexpr uint32_t MAGIC = 0x51494746;  // "FGIQ"
+
+    uint32_t magic;
+    uint32_t header_bytes;                       // sizeof(StreamFrameHeader)
+    uint64_t sequence;                           // Chunk sequence number
+    uint64_t sample_index;                       // Absolute index of first sample
+    double time_gps;                             // GPS time of first sample (s)
+    uint32_t sample_count;                       // complex<int16_t> samples that follow
+    uint32_t reserved;
+};
+#pragma pack(pop)
+
+struct StreamClientOptions {
+    BackPressurePolicy policy = BackPressurePolicy::DROP;
+    bool framed = false;                         // Prefix each chunk with StreamFrameHeader
+    size_t max_queued_chunks = 16;               // Queue depth before the policy applies
+    uint32_t decimation = 4;                     // DECIMATE: forward 1 of N chunks while lagging
+};
+
+struct StreamClientStats {
+    int id;
+    std::string peer;
+    bool is_udp;
+    StreamClientOptions options;
+    uint64_t chunks_sent;
+    uint64_t chunks_dropped;
+    uint64_t bytes_sent;
+    size_t queued_chunks;
+};
+
+// Queue state summed over all subscribers
+struct StreamQueueStats {
+    size_t deepest_queue;                        // Chunks queued for the most lagging subscriber
+    size_t deepest_queue_limit;                  // That subscriber's max_queued_chunks
+    uint64_t chunks_dropped;                     // All subscribers, including ones that left
+};
+
+/**
+ * Multi-subscriber IQ streaming server
+ *
+ * The generator calls publish() once per chunk. The chunk is copied once
+ * into a shared, immutable buffer tagged with its sequence number; every
+ * subscriber queue holds a reference to that buffer. A single epoll thread
+ * drains the queues into non-blocking TCP sockets and UDP destinations.
+ *
+ * TCP subscribers may send one optional line to change their options:
+ *   SUBSCRIBE policy=drop|block|decimate framed=0|1 depth=<chunks> decimation=<n>
+ * UDP destinations always use DROP and are always framed; a chunk is split
+ * into datagrams of at most max_datagram_samples samples, each with its own
+ * header.
+ */
+class IQStreamServer {
+public:
+    explicit IQStreamServer(const StreamClientOptions& default_options = StreamClientOptions());
+    ~IQStreamServer();
+
+    IQStreamServer(const IQStreamServer&) = delete;
+    IQStreamServer& operator=(const IQStreamServer&) = delete;
+
+    /**
+     * Listen for TCP subscribers and start the I/O thread
+     * @param port TCP port (0 picks an ephemeral port)
+     * @param bind_address Local address to bind ("127.0.0.1" by default)
+     * @throws QuadGNSSException if the socket cannot be set up
+     */
+    void start(uint16_t port, const std::string& bind_address = "127.0.0.1");
+
+    /**
+     * Stop the I/O thread, release blocked publishers and close all sockets
+     */
+    void stop();
+
+    /**
+     * Add a UDP destination
+     * @return Subscriber id
+     * @throws QuadGNSSException if the address is invalid
+     */
+    int add_udp_destination(const std::string& host, uint16_t port,
+                            size_t max_datagram_samples = 2048);
+
+    /**
+     * Publish one chunk to all subscribers
+     * @param samples IQ samples (copied once into the shared chunk buffer)
+     * @param sample_count Number of samples
+     * @param sample_index Absolute index of the first sample
+     * @param time_gps GPS time of the first sample (s)
+     */
+    void publish(const std::complex<int16_t>* samples, uint32_t sample_count,
+                 uint64_t sample_index, double time_gps);
+
+    uint16_t get_port() const { return port_; }
+    size_t get_client_count() const;
+    std::vector<StreamClientStats> get_client_stats() const;
+    StreamQueueStats get_queue_stats() const;    // No allocation; cheap enough to call per chunk
+
+private:
+    struct Chunk {
+        StreamFrameHeader header;
+        std::vector<std::complex<int16_t>> samples;
+    };
+
+    struct Client {
+        int id;
+        int fd;
+        bool is_udp;
+        std::string peer;
+        StreamClientOptions options;
+        std::deque<std::shared_ptr<const Chunk>> queue;
+        size_t write_offset;                     // Bytes of queue.front() already sent
+        bool lagging;
+        size_t max_datagram_samples;
+        std::string control_line;                // Partial SUBSCRIBE line
+        uint64_t chunks_sent;
+        uint64_t chunks_dropped;
+        uint64_t bytes_sent;
+    };
+
+    StreamClientOptions default_options_;
+    int listen_fd_;
+    int epoll_fd_;
+    int wake_fd_;
+    uint16_t port_;
+    int next_client_id_;
+    uint64_t next_sequence_;
+    uint64_t departed_drops_;                    // Chunks dropped by subscribers already removed
+
+    mutable std::mutex mutex_;
+    std::condition_variable space_available_;
+    std::map<int, std::unique_ptr<Client>> clients_;   // Keyed by fd
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    void run_loop();
+    void accept_clients();
+    void handle_readable(Client& client);
+    void flush_client(Client& client);
+    void flush_udp_client(Client& client);
+    void remove_client(int fd);
+    void update_interest(const Client& client);
+    void wake();
+    bool enqueue(Client& client, const std::shared_ptr<const Chunk>& chunk,
+                 std::unique_lock<std::mutex>& lock);
+};
+
+} // namespace QuadGNSS
+
+#endif // IQ_STREAM_SERVER_H
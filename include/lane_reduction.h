@@ -0,0 +1,87 @@
+#ifndef LANE_REDUCTION_H
+#define LANE_REDUCTION_H
+
+#include <atomic>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QuadGNSS {
+
+/**
+ * Fixed-order parallel reduction of per-constellation lanes
+ *
+ * Every constellation renders into its own int16 lane; the lanes are then
+ * summed into the int32 accumulator in a pairwise tree fixed by lane
+ * index, ((l0 + l1) + (l2 + l3)) + ..., never in the order workers finish.
+ * The sum is split across workers by sample range, and each sample goes
+ * through the same tree whatever the range boundaries, so the result is
+ * identical for any thread count. Partial sums are exact int32; nothing
+ * is clamped before the final conversion.
+ *
+ * The workers are started once and sleep between calls; the calling
+ * thread always takes part, so one thread means no worker threads.
+ */
+class LaneReducer {
+public:
+    // Samples per reduction task: a tree level of a task stays in L1/L2
+    static constexpr int BLOCK_SAMPLES = 4096;
+
+    /**
+     * Constructor
+     * @param threads Threads including the caller (0 = hardware concurrency)
+     */
+    explicit LaneReducer(size_t threads = 0);
+    ~LaneReducer();
+
+    LaneReducer(const LaneReducer&) = delete;
+    LaneReducer& operator=(const LaneReducer&) = delete;
+
+    size_t get_threads() const { return workers_.size() + 1; }
+
+    /**
+     * Run task(worker, i) for i in [0, count) on the pool
+     *
+     * Tasks are handed out in index order; worker is in [0, get_threads()).
+     * The first exception thrown by a task is rethrown once all tasks stop.
+     */
+    void parallel_for(size_t count, const std::function<void(size_t, size_t)>& task);
+
+    /**
+     * Sum lanes into an accumulator in the fixed tree order
+     * @param lanes lane_count lanes of sample_count samples
+     * @param lane_count Number of lanes (0 clears the accumulator)
+     * @param accumulator sample_count samples, overwritten
+     * @param sample_count Samples per lane
+     */
+    void reduce(const std::complex<int16_t>* const* lanes, size_t lane_count,
+                std::complex<int32_t>* accumulator, int sample_count);
+
+private:
+    std::vector<std::thread> workers_;
+    std::vector<std::vector<std::complex<int32_t>>> scratch_;   // Tree levels, one set per thread
+
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    size_t running_ = 0;                       // Workers still inside the current job
+    bool stop_ = false;
+
+    const std::function<void(size_t, size_t)>* task_ = nullptr;
+    size_t task_count_ = 0;
+    std::atomic<size_t> next_task_{0};
+    std::exception_ptr error_;
+
+    void worker_loop(size_t worker);
+    void run_tasks(size_t worker);
+};
+
+} // namespace QuadGNSS
+
+#endif // LANE_REDUCTION_H
@@ -0,0 +1,125 @@
+#ifndef METRICS_ENDPOINT_H
+#define METRICS_ENDPOINT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "telemetry_snapshot.h"
+
+namespace QuadGNSS {
+
+// Outputs whose queues are reported by the metrics endpoint
+enum class MetricsOutput {
+    FILE = 0,        // AsyncFileSink writes in flight
+    STREAM = 1,      // Deepest IQStreamServer subscriber queue
+    COUNT = 2
+};
+
+// Generation counters published once per chunk
+struct GenerationMetrics {
+    static constexpr size_t CONSTELLATIONS = 4;        // Indexed by ConstellationType
+    static constexpr size_t MAX_STAGES = 8;
+    static constexpr size_t OUTPUTS = static_cast<size_t>(MetricsOutput::COUNT);
+
+    uint64_t chunks;                             // Chunks generated so far
+    uint64_t samples;                            // Samples generated so far
+    double sampling_rate_hz;
+    double wall_seconds;                         // Wall time since generation started
+    uint64_t clipped_samples;                    // Samples saturated to the int16 range
+    uint64_t underruns;                          // Chunks finished after their real-time deadline
+    uint64_t ring_slots_committed;               // Shared-memory ring slots written
+    uint32_t ring_slots;                         // Shared-memory ring size (0 = no ring)
+    uint32_t active_satellites[CONSTELLATIONS];
+    double stage_cpu_seconds[MAX_STAGES];        // Generation thread CPU time per stage
+    uint32_t queue_depth[OUTPUTS];
+    uint32_t queue_capacity[OUTPUTS];            // 0 = output not in use
+    uint64_t dropped_chunks[OUTPUTS];
+    int64_t publish_time_ns;                     // steady_clock time of the publish
+};
+
+/**
+ * Metrics channel between the generation thread and the metrics endpoint
+ *
+ * The generation thread fills staging() and publishes it once per chunk
+ * through a seqlock, so it never waits for a scrape. Stage CPU time is
+ * taken from the thread CPU clock at stage boundaries: one clock read per
+ * stage per chunk, nothing per sample.
+ */
+class MetricsChannel {
+public:
+    /**
+     * @param stage_names Names of the generation stages charged with charge_stage() (at most MAX_STAGES)
+     * @throws QuadGNSSException if there are too many stages
+     */
+    explicit MetricsChannel(const std::vector<std::string>& stage_names);
+
+    // Writer side (generation thread)
+    GenerationMetrics& staging() { return staging_; }
+    void start_stage_clock();                    // Stage boundary without charging a stage
+    void charge_stage(size_t stage);             // Charge CPU time since the last boundary to stage
+    void publish_staging();
+
+    // Reader side (any thread)
+    uint64_t read(GenerationMetrics& out) const { return published_.read(out); }
+    uint64_t version() const { return published_.version(); }
+    const std::vector<std::string>& get_stage_names() const { return stage_names_; }
+
+private:
+    SeqlockSnapshot<GenerationMetrics> published_;
+    GenerationMetrics staging_;                  // Writer-side scratch, never read by the endpoint
+    std::vector<std::string> stage_names_;
+    double stage_clock_s_;
+};
+
+// CPU time consumed by the calling thread (s)
+double thread_cpu_seconds();
+
+/**
+ * Prometheus text endpoint for a MetricsChannel
+ *
+ * A single thread accepts scrapes on a local port and answers
+ * GET /metrics (or /) with the latest published counters in the
+ * Prometheus text exposition format. Each scrape reads the channel once;
+ * the generation thread is never involved.
+ */
+class MetricsServer {
+public:
+    explicit MetricsServer(const MetricsChannel& channel);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * Listen for scrapes and start the server thread
+     * @param port TCP port (0 picks an ephemeral port)
+     * @param bind_address Local address to bind ("127.0.0.1" by default)
+     * @throws QuadGNSSException if the socket cannot be set up
+     */
+    void start(uint16_t port, const std::string& bind_address = "127.0.0.1");
+    void stop();
+
+    // Metrics page for the latest published counters
+    std::string render() const;
+
+    uint16_t get_port() const { return port_; }
+    uint64_t get_scrape_count() const { return scrapes_.load(std::memory_order_relaxed); }
+
+private:
+    const MetricsChannel& channel_;
+    int listen_fd_;
+    int wake_fd_;
+    uint16_t port_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> scrapes_;
+    std::thread thread_;
+
+    void run_loop();
+    void serve_client(int fd);
+};
+
+} // namespace QuadGNSS
+
+#endif // METRICS_ENDPOINT_H
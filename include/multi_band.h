@@ -0,0 +1,295 @@
+#ifndef MULTI_BAND_H
+#define MULTI_BAND_H
+
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+// Signals that can be rendered from the shared satellite backbone
+enum class SignalBand {
+    GPS_L1CA = 0,
+    GPS_L2C = 1,
+    GPS_L5 = 2,
+    GALILEO_E5A = 3,
+    GALILEO_E5B = 4,
+    BEIDOU_B2A = 5,
+    GALILEO_E1 = 6,
+    BEIDOU_B1I = 7,
+    GLONASS_L1OF = 8
+};
+
+// Static description of one band's signal structure
+struct BandInfo {
+    SignalBand band;
+    ConstellationType constellation;
+    const char* name;
+    double carrier_hz;                         // Nominal carrier frequency (Hz)
+    double chip_rate_hz;                       // Primary code chipping rate (chips/s)
+    uint32_t code_length;                      // Primary code length (chips)
+    bool has_pilot;                            // Dataless pilot code on Q (in phase on BOC(1,1) bands)
+    const char* data_secondary;                // Secondary code on the data channel ("0101...", nullptr if none)
+    const char* pilot_secondary;               // Secondary code on the pilot channel
+    double main_lobe_hz;                       // Half width of the main lobe (chip rate, twice it for BOC(1,1))
+    bool boc_subcarrier;                       // BOC(1,1): chips split by a square subcarrier, pilot in phase with data
+    double channel_spacing_hz;                 // FDMA carrier spacing per frequency channel (0 = CDMA)
+};
+
+/**
+ * Get the signal description of a band
+ * @param band Signal band
+ * @return Band description
+ * @throws QuadGNSSException if the band is unknown
+ */
+const BandInfo& get_band_info(SignalBand band);
+
+/**
+ * Carrier of one satellite on a band
+ * @param frequency_channel FDMA channel k of the satellite (ignored by CDMA bands)
+ */
+double band_carrier_hz(SignalBand band, int frequency_channel = 0);
+
+/**
+ * Check that one satellite's signal on a band fits a complex stream
+ * @return true if the main lobe around the satellite's carrier lies inside +/- sampling_rate_hz / 2
+ */
+bool band_fits_stream(SignalBand band, int frequency_channel, double center_frequency_hz, double sampling_rate_hz);
+
+// One satellite a stream has to carry
+struct StreamSatellite {
+    ConstellationType constellation;
+    int prn;
+    int frequency_channel;                     // FDMA channel k (GLONASS only, 0 otherwise)
+};
+
+/**
+ * Bands that render a set of satellites into one stream
+ *
+ * A band is rendered when its constellation has satellites and the band
+ * fits the stream for every one of them. Scenario validation, plan
+ * compilation and every plan consumer select bands with this function.
+ * @param unrendered Receives, once each, the constellations no band renders (nullptr = not needed)
+ * @return Rendered bands in SignalBand order
+ */
+std::vector<SignalBand> bands_for_stream(const std::vector<StreamSatellite>& satellites, double center_frequency_hz,
+                                         double sampling_rate_hz, std::vector<ConstellationType>* unrendered = nullptr);
+
+/**
+ * Generate the primary spreading code of one satellite on one band
+ * @param band Signal band
+ * @param prn Satellite PRN
+ * @param pilot true for the pilot (Q) component, false for the data (I) component
+ * @return code_length chips as +1/-1 (logic 0 -> +1, logic 1 -> -1)
+ * @throws QuadGNSSException if the PRN is out of range for the band
+ */
+std::vector<int8_t> generate_band_code(SignalBand band, int prn, bool pilot = false);
+
+/**
+ * Amplitude of one signal component as rendered
+ * @param band Signal band (power is split evenly between data and pilot when the band has a pilot)
+ * @param power_dbm Satellite power; -130 dBm renders at 1000 LSB
+ * @param gain_db Stream gain
+ * @return Amplitude of the data (and pilot) component in LSB
+ */
+double band_component_amplitude(SignalBand band, double power_dbm, double gain_db = 0.0);
+
+// Geometry of one satellite at the start of the current chunk
+struct SatelliteGeometry {
+    double range_m;                            // Geometric range to the receiver (m)
+    double range_rate_m_s;                     // Range rate over the chunk (m/s)
+    double clock_bias_s;                       // Satellite clock offset (s)
+};
+
+// One satellite of the shared backbone: everything that is not band specific
+struct BackboneSatellite {
+    int prn;
+    ConstellationType constellation;
+    bool is_active;
+    double power_dbm;
+    int frequency_channel;                     // FDMA channel k (GLONASS only, 0 otherwise)
+    EphemerisData ephemeris;
+    SatelliteGeometry geometry;                // Refreshed once per epoch by update()
+};
+
+/**
+ * Band-independent satellite state shared by all band renderers
+ *
+ * Orbit, clock and navigation data are evaluated once per chunk per
+ * satellite, no matter how many bands are rendered from them. Satellites
+ * without valid ephemeris follow a deterministic synthetic pass so that
+ * scenarios can run without RINEX files.
+ */
+class SatelliteBackbone {
+public:
+    static constexpr double NAV_BIT_RATE_HZ = 50.0;
+
+    SatelliteBackbone();
+
+    /**
+     * Add a satellite
+     * @param frequency_channel FDMA channel k (GLONASS only)
+     * @throws QuadGNSSException if the satellite already exists
+     */
+    void add_satellite(ConstellationType constellation, int prn, double power_dbm = -130.0, int frequency_channel = 0);
+
+    /**
+     * Attach parsed ephemeris (e.g. from RINEXParser) to the matching satellites
+     * @return Number of satellites that received ephemeris
+     */
+    size_t set_ephemeris(ConstellationType constellation, const std::map<int, EphemerisData>& ephemeris);
+
+    void set_receiver_position(double x_m, double y_m, double z_m);
+
+    /**
+     * Evaluate geometry and clock of every active satellite for one epoch
+     * @param time_now GPS time at the start of the epoch (s)
+     * @param duration_s Epoch duration (s)
+     */
+    void update(double time_now, double duration_s);
+
+    /**
+     * Navigation message bit shared by every band of a satellite
+     * @param satellite Satellite
+     * @param bit_index Bit number since GPS time zero at NAV_BIT_RATE_HZ
+     * @return 0 or 1
+     */
+    static int nav_bit(const BackboneSatellite& satellite, uint64_t bit_index);
+
+    std::vector<BackboneSatellite>& satellites() { return satellites_; }
+    const std::vector<BackboneSatellite>& satellites() const { return satellites_; }
+    double get_update_time() const { return update_time_; }
+    uint64_t get_geometry_evaluations() const { return geometry_evaluations_; }
+
+private:
+    std::vector<BackboneSatellite> satellites_;
+    double receiver_[3];
+    double update_time_;
+    uint64_t geometry_evaluations_;
+
+    double geometric_range(const BackboneSatellite& satellite, double time) const;
+};
+
+// One output stream of the multi-band generator
+struct BandStreamConfig {
+    SignalBand band;
+    double center_frequency_hz;                // Stream centre (0 = the band's carrier)
+    double gain_db = 0.0;
+};
+
+/**
+ * Thread-safe cache of spreading codes
+ *
+ * Codes are generated on first use and shared read-only afterwards, so
+ * any number of generators (for example concurrent batch jobs) build each
+ * table once.
+ */
+class BandCodeCache {
+public:
+    using Code = std::shared_ptr<const std::vector<int8_t>>;
+
+    /**
+     * Get (or generate) one code
+     * @throws QuadGNSSException as generate_band_code()
+     */
+    Code get(SignalBand band, int prn, bool pilot = false);
+
+    size_t size() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::tuple<SignalBand, int, bool>, Code> codes_;
+};
+
+class BandRenderer;
+
+/**
+ * Multi-band signal generator
+ *
+ * Owns a SatelliteBackbone and one renderer per band stream. The backbone
+ * is evaluated once per geometry epoch and every stream is then rendered,
+ * with its own frequency plan, into its own buffer. Codes are precomputed
+ * per satellite, so the per-band cost is the rendering loop alone.
+ *
+ * Output is a pure function of the absolute sample index: epochs lie on a
+ * fixed grid of GEOMETRY_EPOCH_S from GPS time zero, code and carrier
+ * phases advance in fixed point from the epoch start, and satellites are
+ * summed in backbone order. The same samples are produced bit for bit
+ * however the stream is cut into chunks or spread over threads.
+ */
+class MultiBandGenerator {
+public:
+    /**
+     * Constructor
+     * @param config Sampling configuration and receiver position
+     * @param codes Shared code cache (nullptr = private cache)
+     */
+    explicit MultiBandGenerator(const GlobalConfig& config, std::shared_ptr<BandCodeCache> codes = nullptr);
+    ~MultiBandGenerator();
+
+    MultiBandGenerator(const MultiBandGenerator&) = delete;
+    MultiBandGenerator& operator=(const MultiBandGenerator&) = delete;
+
+    static constexpr double GEOMETRY_EPOCH_S = 1e-3;
+
+    // Receiver position at a GPS time (s), evaluated at every geometry epoch
+    using ReceiverTrajectory = std::function<void(double time, double& x_m, double& y_m, double& z_m)>;
+
+    SatelliteBackbone& backbone() { return backbone_; }
+    const SatelliteBackbone& backbone() const { return backbone_; }
+
+    /**
+     * Add a band output stream
+     *
+     * FDMA bands are checked against the channels of the satellites already
+     * in the backbone; a satellite added later whose channel does not fit
+     * makes generate_chunk() throw.
+     * @return Stream index (buffer position in generate_chunk())
+     * @throws QuadGNSSException if the band does not fit the stream
+     */
+    size_t add_band(const BandStreamConfig& stream);
+
+    const std::vector<BandStreamConfig>& get_bands() const { return streams_; }
+
+    /**
+     * Move the receiver along a trajectory (replaces per-chunk set_receiver_position())
+     * @param trajectory Position callback (empty = static receiver)
+     */
+    void set_receiver_trajectory(ReceiverTrajectory trajectory) { trajectory_ = std::move(trajectory); }
+
+    /**
+     * Sum satellites in tiles of this many samples (keeps the accumulator in cache)
+     * @param samples Tile length (0 = a whole geometry epoch per pass); output is identical for any value
+     * @throws QuadGNSSException if samples is negative
+     */
+    void set_render_tile(int samples);
+    int get_render_tile() const { return render_tile_; }
+
+    /**
+     * Generate one chunk for every band stream
+     * @param buffers One buffer of sample_count samples per stream, in add_band() order
+     * @param sample_count Number of samples per stream
+     * @param time_now GPS time of the first sample (s), rounded to the sample grid
+     * @throws QuadGNSSException if no band was added or arguments are invalid
+     */
+    void generate_chunk(std::complex<int16_t>* const* buffers, int sample_count, double time_now);
+
+private:
+    GlobalConfig config_;
+    std::shared_ptr<BandCodeCache> codes_;
+    SatelliteBackbone backbone_;
+    std::vector<BandStreamConfig> streams_;
+    std::vector<std::unique_ptr<BandRenderer>> renderers_;
+    ReceiverTrajectory trajectory_;
+    int render_tile_;
+};
+
+} // namespace QuadGNSS
+
+#endif // MULTI_BAND_H
@@ -0,0 +1,118 @@
+#ifndef NUMA_PLACEMENT_H
+#define NUMA_PLACEMENT_H
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace QuadGNSS {
+
+/**
+ * CPU topology: which CPUs belong to which NUMA node
+ *
+ * Read from /sys/devices/system/node, or given as a map string with one
+ * CPU list per node separated by ';' ("0-7,16-23;8-15,24-31"). Node
+ * indices are kernel node numbers. Without NUMA information every online
+ * CPU is on node 0.
+ */
+class CpuTopology {
+public:
+    /**
+     * Topology of this host
+     */
+    static CpuTopology detect();
+
+    /**
+     * Topology from a map string
+     * @throws QuadGNSSException on malformed lists or CPUs listed twice
+     */
+    static CpuTopology parse(const std::string& map);
+
+    /**
+     * Parse a kernel CPU list ("0-3,8,10-11")
+     * @throws QuadGNSSException if malformed
+     */
+    static std::vector<int> parse_cpu_list(const std::string& list);
+
+    size_t node_count() const { return nodes_.size(); }
+    size_t cpu_count() const;
+    const std::vector<int>& cpus_of(size_t node) const { return nodes_[node]; }
+
+    // Node of a CPU (-1 if not in the map)
+    int node_of(int cpu) const;
+
+    /**
+     * CPU for each of a number of threads
+     *
+     * Nodes take turns (node 0's first CPU, node 1's first CPU, ...), so
+     * fewer threads than CPUs still use every socket's memory controller;
+     * more threads than CPUs wrap around.
+     */
+    std::vector<int> placement(size_t threads) const;
+
+    // Map string accepted by parse()
+    std::string describe() const;
+
+private:
+    std::vector<std::vector<int>> nodes_;
+};
+
+/**
+ * Pin a thread to one CPU
+ * @return false if the CPU is not available to this process
+ */
+bool pin_thread(std::thread& thread, int cpu);
+bool pin_current_thread(int cpu);
+
+/**
+ * NUMA node of each page of a range, as placed by the kernel (-1 = not resident or unknown)
+ */
+std::vector<int> page_nodes(const void* data, size_t bytes);
+
+/**
+ * Page-aligned buffer for large chunk memory
+ *
+ * Buffers of at least half a huge page come from 2 MB huge pages:
+ * reserved hugetlb pages when the host has them, otherwise transparent
+ * huge pages requested with madvise. Smaller buffers use normal pages.
+ * The memory is bound (preferred) to a NUMA node when one is given, and
+ * is zeroed by the constructing thread, so by default it is placed by
+ * first touch on that thread's node.
+ */
+class HugePageBuffer {
+public:
+    static constexpr size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+
+    /**
+     * Constructor
+     * @param bytes Usable size
+     * @param node NUMA node to prefer (-1 = first touch by this thread)
+     * @throws QuadGNSSException if no memory can be mapped
+     */
+    explicit HugePageBuffer(size_t bytes, int node = -1);
+    ~HugePageBuffer();
+
+    HugePageBuffer(const HugePageBuffer&) = delete;
+    HugePageBuffer& operator=(const HugePageBuffer&) = delete;
+
+    template <typename T>
+    T* as() const { return static_cast<T*>(data_); }
+
+    void* data() const { return data_; }
+    size_t size() const { return bytes_; }
+    size_t mapped_size() const { return mapped_; }
+
+    // Reserved hugetlb pages (true) or normal pages, possibly merged into transparent huge pages
+    bool hugetlb() const { return hugetlb_; }
+
+private:
+    void* data_ = nullptr;
+    size_t bytes_ = 0;
+    size_t mapped_ = 0;
+    bool hugetlb_ = false;
+};
+
+} // namespace QuadGNSS
+
+#endif // NUMA_PLACEMENT_H
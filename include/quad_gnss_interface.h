@@ -52,6 +52,13 @@ struct GlobalConfig {
         bool coherent_mode = false;
     } simulation;
     
+    // Receiver Position (ECEF)
+    struct {
+        double x_m = 0.0;
+        double y_m = 0.0;
+        double z_m = 0.0;
+    } receiver;
+    
     // Constructor with defaults
     GlobalConfig() 
         : sampling_rate_hz(DEFAULT_SAMPLING_RATE)
@@ -96,6 +103,9 @@ struct EphemerisData {
     double iodc;                                   // Issue of data, clock
     double iode;                                   // Issue of data, ephemeris
     
+    // GLONASS
+    int frequency_number;                           // FDMA channel k (-7..+6) broadcast for the slot
+    
     // Validity
     double week_number;                             // GPS week number
     bool is_valid;                                // Data validity flag
@@ -107,7 +117,7 @@ struct EphemerisData {
         , cuc(0.0), cus(0.0), crc(0.0), crs(0.0), cic(0.0), cis(0.0)
         , clock_bias(0.0), clock_drift(0.0), clock_drift_rate(0.0)
         , toe(0.0), toc(0.0), iodc(0.0), iode(0.0)
-        , week_number(0.0), is_valid(false) {}
+        , frequency_number(0), week_number(0.0), is_valid(false) {}
 };
 
 // Satellite Information Structure
@@ -130,6 +140,53 @@ struct SatelliteInfo {
         , power_dbm(-130.0), doppler_hz(0.0), is_active(true) {}
 };
 
+// Compact per-satellite status record (trivially copyable, published once per chunk)
+struct SatelliteStatus {
+    int32_t prn;                                // Pseudo-Random Number (satellite ID)
+    ConstellationType constellation;           // GNSS constellation
+    bool is_active;                            // Satellite is active in simulation
+    double frequency_hz;                        // Signal frequency (Hz)
+    double power_dbm;                          // Signal power (dBm)
+    double doppler_hz;                         // Doppler shift (Hz)
+    double carrier_phase_rad;                  // Carrier phase at end of chunk (rad)
+};
+
+// Runtime scenario change, applied by SignalOrchestrator at a given sample index
+enum class ControlCommandType {
+    SET_POWER = 0,                             // value[0] = power (dBm)
+    ENABLE_SATELLITE = 1,
+    DISABLE_SATELLITE = 2,
+    SET_RECEIVER_POSITION = 3                  // value[0..2] = ECEF x, y, z (m)
+};
+
+struct ControlCommand {
+    ControlCommandType type;
+    ConstellationType constellation;           // NONE for receiver-wide commands
+    int32_t prn;
+    double value[3];
+    uint64_t apply_at_sample;                  // Absolute sample index; 0 = next chunk boundary
+};
+
+// One output of a multi-antenna / multi-receiver run, rendered from the per-satellite sources
+struct OutputChannelConfig {
+    std::string name;                          // e.g. "base", "rover", "element-3"
+    double delay_s = 0.0;                      // Extra delay common to every satellite (s, >= 0, fractional samples allowed)
+    double phase_rad = 0.0;                    // Carrier phase rotation (rad)
+    double gain_db = 0.0;                      // Power relative to the generated signal (dB)
+    double baseline_m[3] = {0.0, 0.0, 0.0};    // Antenna position relative to the scenario receiver (ECEF m)
+};
+
+// Geometry of one rendered source (satellite), filled by ISatelliteConstellation::generate_sources()
+struct SourceGeometry {
+    bool active = false;                       // Source carried signal in this chunk
+    double line_of_sight[3] = {0.0, 0.0, 0.0}; // Receiver-to-satellite unit vector (ECEF); zero when unknown
+};
+
+class TelemetryChannel;
+class ControlCommandQueue;
+class ControlCommandSchedule;
+class LaneReducer;
+
 // Custom exception class for QuadGNSS errors
 class QuadGNSSException : public std::runtime_error {
 public:
@@ -194,6 +251,68 @@ public:
      * @return true if ready for signal generation
      */
     virtual bool is_ready() const = 0;
+    
+    /**
+     * Fill compact status records for the active satellites
+     * Called from the generation thread once per chunk; overrides must write
+     * straight into out and not allocate. The default reports no satellites.
+     * @param out Destination array for status records
+     * @param max_count Capacity of the destination array
+     * @return Number of records written
+     */
+    virtual size_t collect_status(SatelliteStatus* out, size_t max_count) const {
+        (void)out;
+        (void)max_count;
+        return 0;
+    }
+    
+    /**
+     * Apply a runtime scenario change
+     * Called from the generation thread between generate_chunk() calls.
+     * @param command Validated control command
+     * @return true if the command was applied to this constellation
+     */
+    virtual bool apply_command(const ControlCommand& command) {
+        (void)command;
+        return false;
+    }
+    
+    /**
+     * PRNs apply_command() can address, active or not
+     * Control front ends refuse commands naming any other satellite.
+     * @return Every satellite the provider models (empty if it accepts no satellite commands)
+     */
+    virtual std::vector<int> get_satellite_prns() const {
+        return {};
+    }
+    
+    /**
+     * Number of sources rendered by generate_sources()
+     * Multi-output rendering keeps delay history per source, so the count is
+     * fixed once configure() has run.
+     * @return Source count; the default renders the constellation as one source
+     */
+    virtual size_t source_count() const {
+        return 1;
+    }
+    
+    /**
+     * Generate each source (satellite) into its own buffer
+     * Used by multi-output rendering instead of generate_chunk(), so every
+     * output can apply its delay and phase per line of sight before summation.
+     * Every buffer is written; silent sources are zero and stay inactive.
+     * @param buffers source_count() buffers of sample_count samples
+     * @param geometry source_count() records, reset by the caller once per chunk
+     * @param sample_count Number of samples to generate
+     * @param time_now Current GPS time in seconds
+     */
+    virtual void generate_sources(std::complex<int16_t>* const* buffers,
+                                  SourceGeometry* geometry,
+                                  int sample_count,
+                                  double time_now) {
+        generate_chunk(buffers[0], sample_count, time_now);
+        geometry[0].active = true;
+    }
 };
 
 // Main orchestrator class for managing multiple constellations
@@ -224,6 +343,9 @@ public:
     
     /**
      * Generate mixed IQ signal from all active constellations
+     * Constellations render in parallel into their own lanes, which are summed
+     * in a fixed pairwise order (see LaneReducer): the output does not depend
+     * on the mixing thread count.
      * @param buffer Output buffer for mixed IQ samples
      * @param sample_count Number of samples to generate
      * @param time_now Current GPS time in seconds
@@ -233,6 +355,18 @@ public:
                          int sample_count, 
                          double time_now);
     
+    /**
+     * Set the threads that render and sum constellations (including the caller)
+     * @param threads Thread count (0 = hardware concurrency)
+     */
+    void set_mixing_threads(size_t threads);
+    
+    /**
+     * Get the mixing thread count
+     * @return Threads used by mix_all_signals() and the mix_all_outputs() variants
+     */
+    size_t get_mixing_threads() const;
+    
     /**
      * Get number of active constellations
      * @return Number of constellations
@@ -241,6 +375,7 @@ public:
     
     /**
      * Get list of all active satellites across all constellations
+     * Not safe to call concurrently with mix_all_signals(); monitoring threads use telemetry().
      * @return Vector of SatelliteInfo structures
      */
     std::vector<SatelliteInfo> get_all_satellites() const;
@@ -256,17 +391,127 @@ public:
      * @return Reference to configuration
      */
     const GlobalConfig& get_config() const;
+    
+    /**
+     * Get the frequency offsets assigned by initialize()
+     * @return Offset from the stream centre per constellation (Hz), empty before initialize()
+     */
+    const std::map<ConstellationType, double>& get_frequency_offsets() const;
+    
+    /**
+     * Get the telemetry channel published by mix_all_signals() once per chunk
+     * Safe to read from any number of threads without blocking generation.
+     * @return Reference to telemetry channel
+     */
+    const TelemetryChannel& telemetry() const;
+    
+    /**
+     * Attach a control queue drained by mix_all_signals() at chunk boundaries
+     * Commands stamped inside a chunk split generation at that sample.
+     * @param queue Queue fed by control producers (nullptr detaches)
+     */
+    void attach_control_queue(ControlCommandQueue* queue);
+    
+    /**
+     * Get the satellites control commands can address
+     * @return Constellation and PRN per satellite, from every provider's get_satellite_prns()
+     */
+    std::vector<std::pair<ConstellationType, int>> get_satellite_ids() const;
+    
+    // Longest per-output delay (common delay plus baseline path) accepted by set_outputs()
+    static constexpr double MAX_OUTPUT_DELAY_S = 1e-3;
+    
+    /**
+     * Configure multi-output rendering (base + rover, antenna array elements)
+     * Constellations still generate code, navigation data and orbits once per
+     * chunk, one buffer per satellite. Every output applies its own delay,
+     * phase and power to each satellite before summation; an antenna baseline
+     * b adds (|b| - b.u) / c of delay and the matching carrier rotation along
+     * each line of sight u. Resets the delay history.
+     *
+     * Sources are kept at the stream rate and carrier offset, not at chip
+     * rate. A chip-rate source would need an interpolating upconverter
+     * running at the stream rate. Placed per (source, output) pair it
+     * keeps memory small; placed once per source ahead of the delays, its
+     * filter alone costs more per sample than rendering the source at the
+     * stream rate directly. Either way it costs more CPU than the two-tap
+     * delay interpolation used now. The price is memory: one buffer of
+     * history plus one chunk per source, 4 bytes a sample (30 satellites,
+     * 10 ms chunks at 60 MSps: about 72 MB). Shorter chunks bound it.
+     * @param outputs One entry per output stream
+     * @throws QuadGNSSException if the list is empty or a delay is out of range
+     */
+    void set_outputs(const std::vector<OutputChannelConfig>& outputs);
+    
+    /**
+     * Get the configured outputs
+     * @return Output list (empty until set_outputs() is called)
+     */
+    const std::vector<OutputChannelConfig>& get_outputs() const;
+    
+    /**
+     * Generate every configured output into its own buffer
+     * @param buffers One buffer of sample_count samples per output
+     * @param sample_count Number of samples per output
+     * @param time_now Current GPS time in seconds
+     * @throws QuadGNSSException if no outputs are configured or generation fails
+     */
+    void mix_all_outputs(std::complex<int16_t>* const* buffers,
+                         int sample_count,
+                         double time_now);
+    
+    /**
+     * Generate every configured output interleaved sample by sample
+     * @param buffer sample_count * output count samples, ordered s0o0, s0o1, ..., s1o0, ...
+     * @param sample_count Number of samples per output
+     * @param time_now Current GPS time in seconds
+     * @throws QuadGNSSException if no outputs are configured or generation fails
+     */
+    void mix_all_outputs_interleaved(std::complex<int16_t>* buffer,
+                                     int sample_count,
+                                     double time_now);
 
 private:
     // Private member variables
     std::vector<std::unique_ptr<ISatelliteConstellation>> constellations_;
     GlobalConfig config_;
     bool initialized_;
+    std::map<ConstellationType, double> frequency_offsets_;
+    
+    // Telemetry publication state (written by the generation thread only)
+    std::unique_ptr<TelemetryChannel> telemetry_;
+    uint64_t chunk_index_;
+    uint64_t sample_index_;
+    
+    // Runtime control state (generation thread only)
+    ControlCommandQueue* control_queue_;
+    std::unique_ptr<ControlCommandSchedule> command_schedule_;
+    
+    // Shared baseband and multi-output rendering state (generation thread only)
+    std::unique_ptr<LaneReducer> reducer_;
+    std::vector<std::vector<std::complex<int16_t>>> lanes_;   // One per constellation
+    std::vector<const std::complex<int16_t>*> lane_pointers_;
+    std::vector<std::complex<int32_t>> accumulator_;
+    std::vector<OutputChannelConfig> outputs_;
+    std::vector<std::vector<std::complex<int16_t>>> sources_;   // Per satellite: delay history followed by the current chunk
+    std::vector<SourceGeometry> source_geometry_;
+    std::vector<char> source_was_active_;                       // Delay history may still hold signal
+    std::vector<size_t> source_offsets_;                        // First source of each constellation
+    std::vector<std::complex<int16_t>*> source_pointers_;
+    std::vector<std::complex<int16_t>*> interleaved_outputs_;  // First sample of each output in an interleaved buffer
+    std::vector<std::complex<float>> output_mix_;
+    int history_samples_;
     
     // Private helper methods
     void calculate_frequency_offsets();
     bool validate_configuration() const;
     void prevent_overflow(std::complex<int32_t>* accumulator, int sample_count);
+    void publish_telemetry(int sample_count, double time_now);
+    void drain_control_queue();
+    void apply_due_commands(uint64_t sample_index);
+    void generate_shared_baseband(int sample_count, double time_now, bool per_source = false);
+    void prepare_sources(int sample_count);
+    void render_outputs(std::complex<int16_t>* const* buffers, size_t stride, int sample_count);
 };
 
 // Factory class for creating constellation instances
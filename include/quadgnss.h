@@ -0,0 +1,148 @@
+#ifndef QUADGNSS_H
+#define QUADGNSS_H
+
+/**
+ * libquadgnss - embeddable QuadGNSS generator with a stable C ABI
+ *
+ * A simulation is created from a scenario document (the JSON format of
+ * scenario.h) and its IQ stream is pulled on the caller's thread, either
+ * copied into caller memory with quadgnss_fill() or borrowed chunk by
+ * chunk from an internal ring with quadgnss_acquire_chunk() and
+ * quadgnss_release_chunk(). Samples are interleaved int16 I/Q pairs, the
+ * same bytes the generator writes to its file sinks, and the stream is
+ * bit-identical to the scenario's file output. Scenario sinks are ignored.
+ *
+ * All four constellations render, each on every one of its bands that
+ * fits the stream: GPS L1 C/A, L2C and L5, GLONASS L1OF on the
+ * satellite's FDMA channel, Galileo E1 OS, E5a and E5b, BeiDou B1I and
+ * B2a. These are the bands the batch runner renders. quadgnss_create()
+ * fails for a scenario with a constellation none of whose bands fits.
+ *
+ * Every call returns a status (or a sentinel) instead of throwing; the
+ * message of the last failure on the calling thread is available from
+ * quadgnss_last_error(). One simulation must not be used from several
+ * threads at once; separate simulations are independent.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(QUADGNSS_BUILDING_LIBRARY)
+#    define QUADGNSS_API __declspec(dllexport)
+#  else
+#    define QUADGNSS_API
+#  endif
+#else
+#  define QUADGNSS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a declaration below changes incompatibly */
+#define QUADGNSS_ABI_VERSION 1
+
+/* Status codes */
+#define QUADGNSS_OK 0
+#define QUADGNSS_END_OF_STREAM 1         /* Every sample of the scenario has been delivered */
+#define QUADGNSS_ERROR_INVALID (-1)      /* Bad argument or scenario */
+#define QUADGNSS_ERROR_BUSY (-2)         /* Every ring chunk is borrowed */
+#define QUADGNSS_ERROR_FAILED (-3)       /* Generation failed */
+
+/* Opaque simulation handle */
+typedef struct quadgnss_sim quadgnss_sim;
+
+/* A chunk borrowed from the simulation's ring; valid until released */
+typedef struct quadgnss_chunk {
+    const int16_t* iq;                   /* samples * 2 values: I0, Q0, I1, Q1, ... */
+    size_t samples;
+    uint64_t first_sample;               /* Index of iq[0..1] from the scenario start */
+    double time_gps;                     /* GPS time of the first sample (s) */
+    uint32_t slot;                       /* Ring slot, for quadgnss_release_chunk() */
+} quadgnss_chunk;
+
+/* Ground truth of one satellite at a sample, as used to render it */
+typedef struct quadgnss_truth {
+    int32_t constellation;               /* 0 GPS, 1 GLONASS, 2 Galileo, 3 BeiDou */
+    int32_t prn;
+    double power_dbm;
+    double range_m;                      /* Geometric range to the receiver */
+    double range_rate_m_s;
+    double clock_bias_s;                 /* Satellite clock offset */
+    double receiver_ecef_m[3];
+} quadgnss_truth;
+
+QUADGNSS_API int quadgnss_abi_version(void);
+QUADGNSS_API const char* quadgnss_version(void);
+
+/* Message of the last failed call on this thread ("" if none) */
+QUADGNSS_API const char* quadgnss_last_error(void);
+
+/**
+ * Create a simulation from a scenario document
+ * @param scenario_json Scenario JSON text
+ * @param base_dir Directory relative paths in the scenario resolve against (NULL = current)
+ * @return Handle, or NULL on error (see quadgnss_last_error())
+ */
+QUADGNSS_API quadgnss_sim* quadgnss_create(const char* scenario_json, const char* base_dir);
+QUADGNSS_API quadgnss_sim* quadgnss_create_from_file(const char* path);
+
+/* Destroy a simulation; borrowed chunks become invalid. NULL is ignored. */
+QUADGNSS_API void quadgnss_destroy(quadgnss_sim* sim);
+
+QUADGNSS_API double quadgnss_sample_rate(const quadgnss_sim* sim);
+QUADGNSS_API double quadgnss_center_frequency(const quadgnss_sim* sim);
+QUADGNSS_API size_t quadgnss_chunk_samples(const quadgnss_sim* sim);
+QUADGNSS_API uint64_t quadgnss_total_samples(const quadgnss_sim* sim);
+
+/* Index of the next sample fill() or acquire_chunk() delivers */
+QUADGNSS_API uint64_t quadgnss_position(const quadgnss_sim* sim);
+
+/**
+ * Set the number of ring chunks that can be borrowed at once (default 4)
+ * @return QUADGNSS_OK, QUADGNSS_ERROR_INVALID for 0, QUADGNSS_ERROR_BUSY while chunks are borrowed
+ */
+QUADGNSS_API int quadgnss_set_ring_chunks(quadgnss_sim* sim, uint32_t chunks);
+
+/**
+ * Copy the next samples of the stream
+ *
+ * Whole chunks are rendered straight into iq; only a partial chunk at
+ * either end goes through the ring.
+ *
+ * @param iq Destination for samples * 2 int16 values
+ * @param samples Samples wanted
+ * @return Samples written (fewer only at the end of the stream), or a negative status;
+ *         QUADGNSS_ERROR_BUSY, with nothing written, when the request ends inside a
+ *         chunk and every ring chunk is borrowed
+ */
+QUADGNSS_API int64_t quadgnss_fill(quadgnss_sim* sim, int16_t* iq, size_t samples);
+
+/**
+ * Borrow the next chunk of the stream without copying
+ *
+ * The chunk normally holds quadgnss_chunk_samples() samples; it is
+ * shorter when fill() stopped inside a chunk. Chunks may be released in
+ * any order.
+ *
+ * @return QUADGNSS_OK, QUADGNSS_END_OF_STREAM, QUADGNSS_ERROR_BUSY or an error
+ */
+QUADGNSS_API int quadgnss_acquire_chunk(quadgnss_sim* sim, quadgnss_chunk* chunk);
+QUADGNSS_API int quadgnss_release_chunk(quadgnss_sim* sim, const quadgnss_chunk* chunk);
+
+/**
+ * Ground truth of every satellite at a sample
+ * @param sample Sample index from the scenario start (any, not just delivered ones)
+ * @param truth Destination for up to max_count records (may be NULL when max_count is 0)
+ * @return Number of satellites (may exceed max_count), or a negative status
+ */
+QUADGNSS_API int64_t quadgnss_get_truth(quadgnss_sim* sim, uint64_t sample, quadgnss_truth* truth,
+                                        size_t max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUADGNSS_H */
@@ -0,0 +1,96 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace QuadGNSS {
+
+/**
+ * Latency histogram with bounded relative error
+ *
+ * Log-linear buckets: values below 32 ns are exact, larger values fall in
+ * one of 32 buckets per power of two, so a percentile is within 3.2% of
+ * the recorded value. Fixed storage; record() never allocates, so it is
+ * safe on a real-time thread. Not thread-safe: one writer.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = SUB_BUCKETS * (64 - SUB_BUCKET_BITS + 1);
+
+    void record(uint64_t ns);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    /**
+     * Value at a quantile
+     * @param q Quantile in [0, 1] (0.999 = p99.9)
+     * @return Upper edge of the bucket holding it, capped at max() (0 if empty)
+     */
+    uint64_t percentile(double q) const;
+
+    static size_t bucket_of(uint64_t ns);
+    static uint64_t bucket_high(size_t bucket);
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+};
+
+struct RealtimeOptions {
+    bool lock_memory = true;                     // mlockall(MCL_CURRENT | MCL_FUTURE)
+    std::vector<int> cpus;                       // Generation thread affinity (empty = any CPU)
+    int fifo_priority = 0;                       // SCHED_FIFO priority 1-99 (0 = keep SCHED_OTHER)
+};
+
+/**
+ * Real-time settings for the calling thread, undone on destruction
+ *
+ * Locks current and future memory, pins the thread to the chosen CPUs and
+ * switches it to SCHED_FIFO. Each step that the process lacks permission
+ * for (CAP_IPC_LOCK / RLIMIT_MEMLOCK, CAP_SYS_NICE / RLIMIT_RTPRIO) or the
+ * host cannot honour is skipped with a warning, never an error, so a
+ * stream still runs, only without the guarantee. CPUs that the kernel did
+ * not isolate (isolcpus / nohz_full) are used but reported too.
+ */
+class RealtimeSession {
+public:
+    explicit RealtimeSession(const RealtimeOptions& options);
+    ~RealtimeSession();
+
+    RealtimeSession(const RealtimeSession&) = delete;
+    RealtimeSession& operator=(const RealtimeSession&) = delete;
+
+    bool memory_locked() const { return memory_locked_; }
+    bool pinned() const { return pinned_; }
+    bool fifo() const { return fifo_; }
+    const std::vector<std::string>& get_warnings() const { return warnings_; }
+
+    // CPUs the kernel keeps free of other tasks (/sys/devices/system/cpu/isolated)
+    static std::vector<int> isolated_cpus();
+
+private:
+    bool memory_locked_ = false;
+    bool pinned_ = false;
+    bool fifo_ = false;
+    std::vector<std::string> warnings_;
+
+    // Restored by the destructor
+    std::vector<char> old_affinity_;
+    int old_policy_ = 0;
+    int old_priority_ = 0;
+};
+
+} // namespace QuadGNSS
+
+#endif // REALTIME_H
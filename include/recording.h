@@ -0,0 +1,119 @@
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "batch_runner.h"
+
+namespace QuadGNSS {
+
+// Seek point of a recording
+struct RecordingCheckpoint {
+    uint64_t chunk;                            // Chunk index from the scenario start
+    uint64_t first_sample;
+    double time_gps;
+    uint64_t fingerprint;                      // StreamFingerprint hash of the chunk's samples
+};
+
+/**
+ * Procedural recording: a scenario stream stored as what generates it
+ *
+ * The scenario stream is a pure function of the sample index, so instead
+ * of its IQ a recording stores the scenario document (sinks removed), the
+ * navigation files it references, the seed and a seek index of
+ * checkpoints. Reading a range regenerates exactly the bytes the
+ * scenario's file sink would hold there, rendering its chunks in parallel.
+ *
+ * Each checkpoint carries the fingerprint of the chunk it starts at,
+ * taken when the recording was made; verify() regenerates those chunks
+ * to prove that this build still reproduces the recording bit-exactly.
+ *
+ * File layout (little-endian): "QGNSSREC", u32 version, then sections of
+ * u32 tag, u64 length and payload:
+ *   INFO  f64 sampling rate, f64 centre frequency, f64 start time,
+ *         u64 seed, u32 chunk samples, u64 total chunks
+ *   SCEN  scenario JSON with ephemeris paths renamed to the NAVF names
+ *   NAVF  u32 name length, name, file contents (one per navigation file)
+ *   SEEK  u32 checkpoint interval in chunks, then per checkpoint
+ *         u64 chunk, u64 first sample, f64 GPS time, u64 fingerprint
+ */
+class ProceduralRecording {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr double DEFAULT_CHECKPOINT_INTERVAL_S = 1.0;
+
+    /**
+     * Record a scenario
+     *
+     * Renders one chunk per checkpoint for its fingerprint; the rest of
+     * the stream is never generated.
+     *
+     * @param path Recording to write
+     * @param json_text Scenario document
+     * @param base_dir Directory relative ephemeris paths are resolved against
+     * @param checkpoint_interval_s Scenario time between checkpoints (rounded to whole chunks)
+     * @param threads Render threads (0 = hardware concurrency)
+     * @throws QuadGNSSException if the scenario is invalid or a file cannot be read or written
+     */
+    static void create(const std::string& path, const std::string& json_text, const std::string& base_dir = "",
+                       double checkpoint_interval_s = DEFAULT_CHECKPOINT_INTERVAL_S, size_t threads = 0);
+
+    /**
+     * Open a recording
+     * @throws QuadGNSSException if the file is missing, truncated or malformed
+     */
+    explicit ProceduralRecording(const std::string& path);
+
+    const ExecutionPlan& plan() const { return *plan_; }
+    const std::string& get_scenario() const { return scenario_; }
+    const std::vector<RecordingCheckpoint>& get_checkpoints() const { return checkpoints_; }
+    uint64_t get_total_samples() const;
+
+    // Checkpoint at or before a sample
+    const RecordingCheckpoint& checkpoint_for(uint64_t sample) const;
+
+    /**
+     * Regenerate a range of the stream
+     * @param first_sample Index of output[0] from the scenario start
+     * @param count Samples wanted
+     * @param output count samples
+     * @param threads Render threads (0 = hardware concurrency)
+     * @throws QuadGNSSException if the range runs past the end of the scenario
+     */
+    void read(uint64_t first_sample, size_t count, std::complex<int16_t>* output, size_t threads = 0);
+
+    /**
+     * Regenerate every checkpoint's chunk and compare its fingerprint
+     * @return Index of the first checkpoint that differs, or -1 if all match
+     */
+    int64_t verify(size_t threads = 0);
+
+private:
+    using ChunkTask = std::function<void(PlanRenderer&, uint64_t, std::vector<std::complex<int16_t>>&)>;
+
+    std::string scenario_;
+    std::shared_ptr<const ExecutionPlan> plan_;
+    std::vector<RecordingCheckpoint> checkpoints_;
+    uint32_t checkpoint_interval_ = 1;
+    std::shared_ptr<BandCodeCache> codes_ = std::make_shared<BandCodeCache>();
+    std::mutex renderers_mutex_;
+    std::vector<std::unique_ptr<PlanRenderer>> renderers_;   // Idle renderers, reused across reads
+
+    ProceduralRecording() = default;
+
+    int64_t verify_fingerprints(size_t threads, bool store);
+
+    // Run task(renderer, i, chunk-sized scratch) for i in [0, tasks) on up to threads workers
+    void render_chunks(uint64_t tasks, size_t threads, const ChunkTask& task);
+    std::unique_ptr<PlanRenderer> take_renderer();
+    void return_renderer(std::unique_ptr<PlanRenderer> renderer);
+};
+
+} // namespace QuadGNSS
+
+#endif // RECORDING_H
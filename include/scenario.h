@@ -0,0 +1,289 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "multi_band.h"
+#include "quad_gnss_interface.h"
+#include "stage_graph.h"
+
+namespace QuadGNSS {
+
+/**
+ * Minimal JSON document model
+ *
+ * Enough for scenario files: objects keep their keys sorted, numbers are
+ * doubles, and parse errors report line and column.
+ */
+class JsonValue {
+public:
+    enum class Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+    JsonValue() : type_(Type::NUL), bool_(false), number_(0.0) {}
+    static JsonValue make_bool(bool value);
+    static JsonValue make_number(double value);
+    static JsonValue make_string(const std::string& value);
+    static JsonValue make_array();
+    static JsonValue make_object();
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::NUL; }
+    bool is_bool() const { return type_ == Type::BOOL; }
+    bool is_number() const { return type_ == Type::NUMBER; }
+    bool is_string() const { return type_ == Type::STRING; }
+    bool is_array() const { return type_ == Type::ARRAY; }
+    bool is_object() const { return type_ == Type::OBJECT; }
+
+    bool as_bool() const { return bool_; }
+    double as_number() const { return number_; }
+    const std::string& as_string() const { return string_; }
+    const std::vector<JsonValue>& as_array() const { return array_; }
+    const std::map<std::string, JsonValue>& as_object() const { return object_; }
+
+    // Object member lookup (nullptr if absent or not an object)
+    const JsonValue* find(const std::string& key) const;
+
+    std::vector<JsonValue>& array_items() { return array_; }
+    std::map<std::string, JsonValue>& object_members() { return object_; }
+
+    static const char* type_name(Type type);
+
+private:
+    Type type_;
+    bool bool_;
+    double number_;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::map<std::string, JsonValue> object_;
+};
+
+/**
+ * Parse a JSON document
+ * @throws QuadGNSSException with line:column on malformed input
+ */
+JsonValue parse_json(const std::string& text);
+
+/**
+ * Write a JSON document on one line
+ *
+ * Numbers are written with 17 significant digits, so parse_json() of the
+ * result reproduces every value exactly. Comments are not preserved.
+ */
+std::string format_json(const JsonValue& value);
+
+/**
+ * Parsed navigation files shared across scenario compilations
+ *
+ * Each (file, format, constellation) is parsed once per process; plans
+ * hold the resulting tables by shared pointer.
+ */
+class EphemerisCache {
+public:
+    using Table = std::shared_ptr<const std::map<int, EphemerisData>>;
+
+    /**
+     * Get the parsed contents of a navigation file
+     * @param path RINEX file
+     * @param format "rinex2" (GPS only) or "rinex3"
+     * @param constellation Constellation to extract
+     */
+    Table load(const std::string& path, const std::string& format, ConstellationType constellation);
+
+    size_t get_parse_count() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::tuple<std::string, std::string, ConstellationType>, Table> tables_;
+    size_t parse_count_ = 0;
+};
+
+// One satellite of the resolved plan
+struct PlannedSatellite {
+    ConstellationType constellation;
+    int prn;
+    double power_dbm;
+    int glonass_channel;                       // FDMA channel k (GLONASS only)
+    double carrier_hz;                         // Carrier on the first band that renders it (per-channel for GLONASS)
+    double offset_hz;                          // Carrier minus stream centre frequency
+    bool has_ephemeris;
+};
+
+// One distinct carrier of the frequency plan (a rendered band, and a channel of it for GLONASS)
+struct PlannedCarrier {
+    ConstellationType constellation;
+    SignalBand band;
+    int glonass_channel;
+    double carrier_hz;
+    double offset_hz;
+    double half_bandwidth_hz;                  // Main-lobe half width that must fit in the stream
+    size_t satellite_count;
+};
+
+struct TrajectoryPoint {
+    double time_s;                             // Seconds after start_time_gps
+    double x_m, y_m, z_m;                      // ECEF
+};
+
+enum class ScenarioSinkType {
+    STDOUT = 0,
+    FILE = 1,
+    STREAM = 2,
+    SHARED_MEMORY = 3
+};
+
+struct PlannedSink {
+    ScenarioSinkType type;
+    std::string target;                        // File path or shared-memory name
+    std::string backend;                       // File sink backend: auto, uring or threads
+    uint16_t port = 0;                         // Stream port
+    uint32_t ring_slots = 0;                   // Shared-memory ring depth
+};
+
+struct ThreadLayout {
+    size_t requested_threads;                  // "threads" of the scenario (hardware concurrency if absent)
+    size_t generator_threads;
+    std::vector<std::vector<ConstellationType>> generator_assignment;   // Constellations per generator thread
+    size_t sink_threads;
+    size_t graph_workers;
+};
+
+/**
+ * Immutable execution plan compiled from a scenario
+ *
+ * Everything a run needs is resolved here once: satellites with their
+ * power and carriers, the signal bands that render them, the frequency plan, chunk and buffer sizes, the
+ * thread layout, sinks and the optional processing pipeline. Plans are
+ * shared as std::shared_ptr<const ExecutionPlan> and never change.
+ */
+class ExecutionPlan {
+public:
+    const std::string& get_name() const { return name_; }
+    const GlobalConfig& get_config() const { return config_; }
+    const std::vector<PlannedSatellite>& get_satellites() const { return satellites_; }
+    const std::vector<PlannedCarrier>& get_frequency_plan() const { return carriers_; }
+    // Bands rendered into the stream: bands_for_stream() of the satellites, at least one per constellation
+    const std::vector<SignalBand>& get_bands() const { return bands_; }
+    const std::map<ConstellationType, EphemerisCache::Table>& get_ephemeris() const { return ephemeris_; }
+    const std::vector<TrajectoryPoint>& get_trajectory() const { return trajectory_; }
+    const std::vector<PlannedSink>& get_sinks() const { return sinks_; }
+    const std::vector<StageSpec>& get_pipeline() const { return pipeline_; }
+    const ThreadLayout& get_thread_layout() const { return threads_; }
+
+    double get_chunk_duration() const { return chunk_duration_s_; }
+    int get_chunk_samples() const { return chunk_samples_; }
+    uint64_t get_total_chunks() const { return total_chunks_; }
+    size_t get_chunk_bytes() const { return chunk_bytes_; }
+    size_t get_file_buffer_bytes() const { return file_buffer_bytes_; }
+    uint64_t get_seed() const { return seed_; }
+
+    /**
+     * Receiver position at a scenario time (linear between trajectory points)
+     * @param time_s Seconds after start_time_gps
+     */
+    void receiver_position(double time_s, double& x_m, double& y_m, double& z_m) const;
+
+    // Human-readable summary
+    std::string describe() const;
+
+private:
+    friend class ScenarioCompiler;
+    ExecutionPlan() = default;
+
+    std::string name_;
+    GlobalConfig config_;
+    std::vector<PlannedSatellite> satellites_;
+    std::vector<PlannedCarrier> carriers_;
+    std::vector<SignalBand> bands_;
+    std::map<ConstellationType, EphemerisCache::Table> ephemeris_;
+    std::vector<TrajectoryPoint> trajectory_;
+    std::vector<PlannedSink> sinks_;
+    std::vector<StageSpec> pipeline_;
+    ThreadLayout threads_;
+    double chunk_duration_s_ = 0.0;
+    int chunk_samples_ = 0;
+    uint64_t total_chunks_ = 0;
+    size_t chunk_bytes_ = 0;
+    size_t file_buffer_bytes_ = 0;
+    uint64_t seed_ = 0;
+};
+
+/**
+ * Scenario file validation and compilation
+ *
+ * Scenario format (JSON):
+ * {
+ *   "name": "static-urban",
+ *   "sampling_rate_hz": 60e6, "center_frequency_hz": 1582e6,
+ *   "start_time_gps": 345600, "duration_s": 30, "chunk_duration_s": 0.01,
+ *   "threads": 4, "seed": 7,
+ *   "receiver": {"lat_deg": 48.1, "lon_deg": 11.6, "height_m": 520},
+ *   "trajectory": [{"t": 0, "x_m": ..., "y_m": ..., "z_m": ...}, ...],
+ *   "constellations": [
+ *     {"type": "GPS", "ephemeris": "brdc.rnx", "satellites": "all",
+ *      "power_dbm": -130, "exclude": [4], "power_overrides": {"7": -125}},
+ *     {"type": "GLONASS", "satellites": [1, 2, 8]}
+ *   ],
+ *   "sinks": [{"type": "file", "path": "out.iq", "backend": "auto"},
+ *             {"type": "stream", "port": 5555},
+ *             {"type": "shm", "name": "/quadgnss", "slots": 64},
+ *             {"type": "stdout"}],
+ *   "pipeline": [{"name": "generate", "type": "external"},
+ *                {"name": "sum", "type": "sum", "inputs": ["generate"]},
+ *                {"name": "gain", "type": "gain", "gain_db": -3, "inputs": ["sum"]},
+ *                {"name": "quantize", "type": "quantize", "inputs": ["gain"]},
+ *                {"name": "output", "type": "external", "inputs": ["quantize"]}]
+ * }
+ * Receiver and trajectory points take either x_m/y_m/z_m (ECEF) or
+ * lat_deg/lon_deg/height_m (WGS-84). Unknown keys are errors. Every
+ * constellation needs a signal band that fits the stream: at 1582 MHz
+ * and 60 MSps the example renders GPS L1 C/A and GLONASS L1OF.
+ *
+ * The pipeline runs in quad_gnss_sim between the rendered stream
+ * ("generate") and the sinks ("output"); batch jobs, recordings and the
+ * library reject scenarios that have one.
+ */
+class ScenarioCompiler {
+public:
+    /**
+     * Fast validation: syntax, schema, ranges and frequency plan
+     *
+     * Reports every problem with its JSON path. Ephemeris files are only
+     * checked for existence, not parsed. The frequency plan check is the
+     * band selection of compile() (bands_for_stream()) on the nominal
+     * GLONASS channels, so a valid scenario renders unless its broadcast
+     * channels differ.
+     *
+     * @param json_text Scenario document
+     * @return Error messages (empty if the scenario is valid)
+     */
+    static std::vector<std::string> validate(const std::string& json_text);
+
+    /**
+     * Validate and compile a scenario into an execution plan
+     * @param json_text Scenario document
+     * @param base_dir Directory that relative ephemeris paths are resolved against
+     * @param cache Shared navigation data (nullptr = parse privately)
+     * @throws QuadGNSSException listing every validation error
+     */
+    static std::shared_ptr<const ExecutionPlan> compile(const std::string& json_text,
+                                                        const std::string& base_dir = "",
+                                                        EphemerisCache* cache = nullptr);
+
+    /**
+     * Read, validate and compile a scenario file
+     * @throws QuadGNSSException if the file cannot be read or is invalid
+     */
+    static std::shared_ptr<const ExecutionPlan> compile_file(const std::string& path,
+                                                             EphemerisCache* cache = nullptr);
+
+    static const char* constellation_name(ConstellationType type);
+};
+
+} // namespace QuadGNSS
+
+#endif // SCENARIO_H
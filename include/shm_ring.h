@@ -0,0 +1,167 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <string>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+/**
+ * Shared-memory IQ ring transport
+ *
+ * One producer writes chunks of complex<int16_t> samples straight into slots
+ * of a POSIX shared-memory object (/dev/shm/<name>). Any number of consumer
+ * processes map the same pages and keep their own read cursor, so a slow
+ * consumer never stalls the producer; it detects the overwrite and counts an
+ * overrun instead.
+ *
+ * Layout: ShmRingHeader, then slot_count slots of
+ * [ShmRingSlotHeader | slot_capacity samples], each slot 4 KiB aligned.
+ */
+struct ShmRingHeader {
+    static constexpr uint64_t MAGIC = 0x51474e5353524e47ULL;  // "QGNSSRNG"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint64_t slot_capacity;                      // Samples per slot
+    uint64_t slot_stride_bytes;                  // Header + data, page aligned
+    double sampling_rate_hz;
+    alignas(64) std::atomic<uint64_t> write_sequence;   // Slots committed so far
+    std::atomic<uint32_t> producer_alive;
+};
+
+struct ShmRingSlotHeader {
+    std::atomic<uint64_t> sequence;              // 2*seq+1 while writing, 2*seq+2 once committed
+    uint64_t sample_index;                       // Absolute index of first sample
+    uint32_t sample_count;
+    double time_gps;                             // GPS time of first sample (s)
+};
+
+// Read-only view of one committed slot inside the mapping
+struct ShmRingChunk {
+    uint64_t sequence;                           // Slot sequence number (0-based)
+    uint64_t sample_index;
+    uint32_t sample_count;
+    double time_gps;
+    const std::complex<int16_t>* samples;        // Points into shared memory
+};
+
+// Producer side (single writer)
+class ShmRingProducer {
+public:
+    /**
+     * Create (or replace) a shared-memory ring
+     * @param name Shared-memory object name, e.g. "/quadgnss_iq"
+     * @param slot_count Number of slots in the ring
+     * @param slot_capacity Maximum samples per slot (one chunk)
+     * @param sampling_rate_hz Sample rate recorded in the header
+     * @throws QuadGNSSException if the object cannot be created or mapped
+     */
+    ShmRingProducer(const std::string& name, uint32_t slot_count,
+                    uint64_t slot_capacity, double sampling_rate_hz);
+    ~ShmRingProducer();
+
+    ShmRingProducer(const ShmRingProducer&) = delete;
+    ShmRingProducer& operator=(const ShmRingProducer&) = delete;
+
+    /**
+     * Claim the next slot for writing
+     * @return Pointer to slot_capacity samples inside shared memory
+     */
+    std::complex<int16_t>* begin_write();
+
+    /**
+     * Publish the slot claimed by begin_write()
+     * @param sample_count Samples written (<= slot_capacity)
+     * @param sample_index Absolute index of the first sample
+     * @param time_gps GPS time of the first sample (s)
+     */
+    void commit(uint32_t sample_count, uint64_t sample_index, double time_gps);
+
+    /**
+     * Fault in every slot page now, so the first lap around the ring takes no page faults
+     * @throws QuadGNSSException once a slot has been written
+     */
+    void prefault();
+
+    uint64_t get_slot_capacity() const { return header_->slot_capacity; }
+    uint32_t get_slot_count() const { return header_->slot_count; }
+    uint64_t get_write_sequence() const { return header_->write_sequence.load(std::memory_order_relaxed); }
+    const std::string& get_name() const { return name_; }
+
+private:
+    std::string name_;
+    void* mapping_;
+    size_t mapping_bytes_;
+    ShmRingHeader* header_;
+    uint64_t next_sequence_;
+    bool writing_;
+
+    ShmRingSlotHeader* slot_header(uint64_t sequence) const;
+};
+
+// Consumer side (one instance per reader, any process)
+class ShmRingConsumer {
+public:
+    /**
+     * Attach to an existing ring
+     * Starts at the oldest slot still guaranteed intact, or at the newest one if from_latest is set.
+     * @param name Shared-memory object name used by the producer
+     * @param from_latest Skip history and start with the next committed slot
+     * @throws QuadGNSSException if the ring does not exist or the header is invalid
+     */
+    explicit ShmRingConsumer(const std::string& name, bool from_latest = false);
+    ~ShmRingConsumer();
+
+    ShmRingConsumer(const ShmRingConsumer&) = delete;
+    ShmRingConsumer& operator=(const ShmRingConsumer&) = delete;
+
+    /**
+     * Borrow the next committed slot without copying
+     * The view stays valid until release(); the producer may overwrite it if
+     * the consumer falls a full ring behind, which release() reports.
+     * @param chunk Filled with the slot view
+     * @return false if no new slot is available
+     */
+    bool acquire(ShmRingChunk& chunk);
+
+    /**
+     * Finish with the slot returned by acquire()
+     * @return false if the producer overwrote the slot while it was borrowed
+     */
+    bool release();
+
+    /**
+     * Copy the next committed slot into a local buffer
+     * @param buffer Destination (at least slot_capacity samples)
+     * @param chunk Metadata of the copied slot (samples points at buffer)
+     * @return false if no new slot is available
+     */
+    bool read_copy(std::complex<int16_t>* buffer, ShmRingChunk& chunk);
+
+    uint64_t get_overrun_count() const { return overruns_; }
+    uint64_t get_read_cursor() const { return cursor_; }
+    uint64_t get_slot_capacity() const { return header_->slot_capacity; }
+    double get_sampling_rate() const { return header_->sampling_rate_hz; }
+    bool is_producer_alive() const { return header_->producer_alive.load(std::memory_order_acquire) != 0; }
+
+private:
+    void* mapping_;
+    size_t mapping_bytes_;
+    const ShmRingHeader* header_;
+    uint64_t cursor_;                            // Next slot sequence to read
+    uint64_t overruns_;                          // Slots lost to the producer lapping us
+    bool borrowed_;
+
+    const ShmRingSlotHeader* slot_header(uint64_t sequence) const;
+    bool catch_up();
+};
+
+} // namespace QuadGNSS
+
+#endif // SHM_RING_H
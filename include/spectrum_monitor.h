@@ -0,0 +1,215 @@
+#ifndef SPECTRUM_MONITOR_H
+#define SPECTRUM_MONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fft.h"
+#include "stage_graph.h"
+
+namespace QuadGNSS {
+
+struct SpectrumMonitorConfig {
+    double sampling_rate_hz;
+    double center_frequency_hz;
+    size_t fft_size = 4096;                    // Welch segment length (power of two)
+    size_t min_segment_spacing = 4;            // Analyse at most one segment in this many
+    double cpu_budget = 0.04;                  // Monitor time as a fraction of generation wall time (headroom under 5%
+                                               // for the first, unmeasured segment and the final snapshot)
+    double snapshot_interval_s = 1.0;          // Stream time between snapshots
+    std::string snapshot_path;                 // Rewritten atomically at every snapshot ("" = none)
+    size_t queue_segments = 8;                 // Segments buffered for the analysis thread
+    double occupancy_threshold_db = 3.0;       // In-band excess over the noise floor to count as present
+    double unexpected_threshold_db = 6.0;      // Excess outside every band to report (above chip-edge sidelobes)
+};
+
+// Expected main lobe of one constellation in the stream
+struct SpectrumBand {
+    std::string name;
+    double offset_hz;                          // Centre relative to the stream centre frequency
+    double half_width_hz;                      // Main lobe half width
+};
+
+enum class BandStatus {
+    OK = 0,
+    MISSING = 1,                               // No power above the floor in the expected lobe
+    OFFSET = 2,                                // Power present but its centroid is off the expected centre
+    OUTSIDE_STREAM = 3                         // Expected centre is outside +/- fs/2
+};
+
+struct BandOccupancy {
+    std::string name;
+    double expected_offset_hz;
+    double measured_offset_hz;                 // Power-weighted centroid of the excess over the floor
+    double excess_db;                          // Mean in-lobe PSD over the noise floor
+    BandStatus status;
+};
+
+// Occupied span not covered by any expected band (e.g. a provider at the wrong offset)
+struct OccupiedSpan {
+    double low_hz;
+    double high_hz;
+    double peak_excess_db;
+};
+
+struct SpectrumSnapshot {
+    uint64_t index;
+    double time_s;                             // Stream time at the end of the snapshot interval
+    double resolution_hz;
+    uint64_t segments;                         // Segments averaged into this snapshot
+    double floor_db;                           // Noise floor estimate (dB LSB^2/Hz)
+    std::vector<float> psd_db;                 // DC-centred, bin k at (k - fft_size/2) * resolution_hz
+    std::vector<BandOccupancy> bands;
+    std::vector<OccupiedSpan> unexpected;
+
+    bool all_bands_ok() const;
+};
+
+struct SpectrumMonitorStats {
+    uint64_t segments_analysed;
+    uint64_t segments_skipped;                 // Candidates dropped by the CPU budget or a full queue
+    uint64_t snapshots;
+    double tap_seconds;                        // CPU time spent in tap() on the generation thread
+    double analysis_seconds;                   // CPU time of the analysis thread
+};
+
+const char* band_status_name(BandStatus status);
+
+// Main lobe half width of a constellation's open-service signal in the composite stream (Hz)
+double main_lobe_half_width_hz(ConstellationType type);
+
+/**
+ * Expected bands for a set of frequency offsets
+ * @param offsets Offset per constellation, e.g. SignalOrchestrator::get_frequency_offsets()
+ */
+std::vector<SpectrumBand> expected_spectrum_bands(const std::map<ConstellationType, double>& offsets);
+
+/**
+ * Streaming Welch spectrum monitor
+ *
+ * tap() runs on the generation thread and only copies selected segments
+ * into a preallocated pool. A background thread windows, transforms and
+ * averages them, and at every snapshot interval reports where each
+ * expected main lobe actually is.
+ *
+ * Segments are decimated by a CPU credit: every tap() earns cpu_budget
+ * times the wall time since the previous tap, every analysed segment
+ * spends its measured cost, and a segment is only taken while the credit
+ * is positive. Total monitor cost therefore stays within the budget plus
+ * one segment, whatever the machine or stream rate; a slower machine
+ * just averages fewer segments.
+ */
+class SpectrumMonitor {
+public:
+    /**
+     * Constructor
+     * @param config Monitor configuration
+     * @param bands Expected bands to check in every snapshot
+     * @throws QuadGNSSException on invalid configuration
+     */
+    SpectrumMonitor(const SpectrumMonitorConfig& config, const std::vector<SpectrumBand>& bands);
+    ~SpectrumMonitor();
+
+    SpectrumMonitor(const SpectrumMonitor&) = delete;
+    SpectrumMonitor& operator=(const SpectrumMonitor&) = delete;
+
+    /**
+     * Offer one generated chunk (generation thread)
+     * @param samples Chunk samples
+     * @param sample_count Samples in the chunk
+     * @param time_now Stream time of the first sample (s)
+     */
+    void tap(const std::complex<int16_t>* samples, int sample_count, double time_now);
+
+    /**
+     * Emit a snapshot of everything tapped so far and wait for the analysis thread
+     * @throws QuadGNSSException if writing the snapshot file failed
+     */
+    void flush();
+
+    // Most recent snapshot (index 0 with no bands before the first one)
+    SpectrumSnapshot latest_snapshot() const;
+
+    SpectrumMonitorStats get_stats() const;
+    const std::vector<SpectrumBand>& get_bands() const { return bands_; }
+
+private:
+    struct WorkItem {
+        int slot;                              // Segment slot, -1 for a snapshot marker
+        double time_s;
+    };
+
+    SpectrumMonitorConfig config_;
+    std::vector<SpectrumBand> bands_;
+    Fft fft_;
+    std::vector<float> window_;
+    double window_power_;
+
+    // Segment pool: slots move free -> filling (tap) -> queued -> free (analysis)
+    std::vector<std::vector<std::complex<int16_t>>> slots_;
+    std::vector<int> free_slots_;
+    std::deque<WorkItem> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable idle_;
+    bool busy_;
+    bool stopping_;
+    std::thread worker_;
+
+    // Generation thread state
+    int fill_slot_;
+    size_t fill_count_;
+    size_t skip_remaining_;
+    double credit_s_;
+    double charged_s_;
+    bool have_last_tap_;
+    std::chrono::steady_clock::time_point last_tap_;
+    double next_snapshot_time_;
+    double stream_time_;                       // End of the last tapped chunk
+    double tap_seconds_;
+    uint64_t segments_admitted_;
+    uint64_t segments_skipped_;
+
+    // Analysis thread state
+    std::vector<float> segment_re_;
+    std::vector<float> segment_im_;
+    std::vector<double> accumulator_;
+    uint64_t accumulated_segments_;
+    std::atomic<double> analysis_seconds_;
+    std::atomic<uint64_t> segments_analysed_;
+    uint64_t snapshot_count_;
+    SpectrumSnapshot latest_;
+    std::string error_;
+
+    void run_worker();
+    void analyse_segment(const std::complex<int16_t>* samples);
+    void emit_snapshot(double time_s);
+    void evaluate_bands(SpectrumSnapshot& snapshot, const std::vector<double>& psd) const;
+    void write_snapshot(const SpectrumSnapshot& snapshot) const;
+    void enqueue(const WorkItem& item);
+};
+
+// Sink stage feeding a spectrum monitor from an int16 stream
+class SpectrumTapStage : public IStage {
+public:
+    explicit SpectrumTapStage(SpectrumMonitor& monitor) : monitor_(monitor) {}
+    StageKind kind() const override { return StageKind::SINK; }
+    std::vector<PortType> input_types() const override { return {PortType::COMPLEX_INT16}; }
+    void process(const StageBuffer* inputs, const StageBuffer*, int sample_count, double time_now) override;
+
+private:
+    SpectrumMonitor& monitor_;
+};
+
+} // namespace QuadGNSS
+
+#endif // SPECTRUM_MONITOR_H
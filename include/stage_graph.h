@@ -0,0 +1,348 @@
+#ifndef STAGE_GRAPH_H
+#define STAGE_GRAPH_H
+
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+// Sample format carried by a stage port
+enum class PortType {
+    COMPLEX_INT16 = 0,                         // Provider / output format
+    COMPLEX_FLOAT = 1                          // Processing format
+};
+
+enum class StageKind {
+    SOURCE = 0,                                // No inputs, one output
+    TRANSFORM = 1,                             // One input, one output
+    COMBINER = 2,                              // Several inputs, one output
+    SINK = 3                                   // Inputs only
+};
+
+// View of one pooled buffer handed to a stage
+struct StageBuffer {
+    PortType type;
+    void* data;
+    int samples;
+
+    std::complex<int16_t>* ci16() const { return static_cast<std::complex<int16_t>*>(data); }
+    std::complex<float>* cf32() const { return static_cast<std::complex<float>*>(data); }
+};
+
+/**
+ * Processing stage of a generation pipeline
+ *
+ * Stages never own sample memory: the graph hands every stage pooled
+ * input and output buffers for the current chunk. Element-wise transforms
+ * (same input and output type, output sample i depends only on input
+ * sample i) implement process_inplace() and are fused with their producer.
+ */
+class IStage {
+public:
+    virtual ~IStage() = default;
+
+    virtual StageKind kind() const = 0;
+    virtual std::vector<PortType> input_types() const = 0;
+    virtual PortType output_type() const { return PortType::COMPLEX_FLOAT; }
+
+    /**
+     * Process one chunk
+     * @param inputs One buffer per input port (nullptr for sources)
+     * @param output Output buffer (nullptr for sinks)
+     * @param sample_count Samples in the chunk
+     * @param time_now Time of the first sample (s)
+     */
+    virtual void process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) = 0;
+
+    // Element-wise transforms only
+    virtual bool is_elementwise() const { return false; }
+
+    /**
+     * Process a tile of an element-wise transform in place
+     * @param buffer Buffer holding the producer's output
+     * @param offset First sample of the tile
+     * @param count Samples in the tile
+     * @param time_now Time of the first sample of the chunk (s)
+     */
+    virtual void process_inplace(const StageBuffer& buffer, int offset, int count, double time_now) {
+        (void)buffer; (void)offset; (void)count; (void)time_now;
+    }
+
+    // Called once per chunk before the first tile
+    virtual void begin_chunk(int sample_count, double time_now) { (void)sample_count; (void)time_now; }
+};
+
+// Built-in stages
+
+// Pulls samples from a constellation provider
+class ConstellationSourceStage : public IStage {
+public:
+    explicit ConstellationSourceStage(ISatelliteConstellation& constellation) : constellation_(constellation) {}
+    StageKind kind() const override { return StageKind::SOURCE; }
+    std::vector<PortType> input_types() const override { return {}; }
+    PortType output_type() const override { return PortType::COMPLEX_INT16; }
+    void process(const StageBuffer*, const StageBuffer* output, int sample_count, double time_now) override;
+
+private:
+    ISatelliteConstellation& constellation_;
+};
+
+// Sums N int16 streams into one float stream (no intermediate clipping)
+class SumCombinerStage : public IStage {
+public:
+    explicit SumCombinerStage(size_t input_count);
+    StageKind kind() const override { return StageKind::COMBINER; }
+    std::vector<PortType> input_types() const override;
+    void process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) override;
+
+private:
+    size_t input_count_;
+};
+
+// Scales by a gain in dB
+class GainStage : public IStage {
+public:
+    explicit GainStage(double gain_db);
+    StageKind kind() const override { return StageKind::TRANSFORM; }
+    std::vector<PortType> input_types() const override { return {PortType::COMPLEX_FLOAT}; }
+    bool is_elementwise() const override { return true; }
+    void process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) override;
+    void process_inplace(const StageBuffer& buffer, int offset, int count, double time_now) override;
+
+private:
+    float gain_;
+};
+
+// Phase-continuous frequency shift
+class FrequencyShiftStage : public IStage {
+public:
+    FrequencyShiftStage(double shift_hz, double sampling_rate_hz);
+    StageKind kind() const override { return StageKind::TRANSFORM; }
+    std::vector<PortType> input_types() const override { return {PortType::COMPLEX_FLOAT}; }
+    bool is_elementwise() const override { return true; }
+    void begin_chunk(int sample_count, double time_now) override;
+    void process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) override;
+    void process_inplace(const StageBuffer& buffer, int offset, int count, double time_now) override;
+
+private:
+    double cycles_per_sample_;
+    double sampling_rate_hz_;
+    double chunk_start_cycles_;
+};
+
+// Additive white Gaussian noise; deterministic for a given seed
+class NoiseStage : public IStage {
+public:
+    NoiseStage(double sigma, uint64_t seed);
+    StageKind kind() const override { return StageKind::TRANSFORM; }
+    std::vector<PortType> input_types() const override { return {PortType::COMPLEX_FLOAT}; }
+    bool is_elementwise() const override { return true; }
+    void process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) override;
+    void process_inplace(const StageBuffer& buffer, int offset, int count, double time_now) override;
+
+private:
+    std::mt19937_64 generator_;
+    std::normal_distribution<float> distribution_;
+};
+
+// Rounds and saturates float samples to int16
+class QuantizeStage : public IStage {
+public:
+    StageKind kind() const override { return StageKind::TRANSFORM; }
+    std::vector<PortType> input_types() const override { return {PortType::COMPLEX_FLOAT}; }
+    PortType output_type() const override { return PortType::COMPLEX_INT16; }
+    void process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) override;
+};
+
+// Fills int16 chunks from a callback (a generator outside the provider interface, a ring, ...)
+class CallbackSourceStage : public IStage {
+public:
+    using Callback = std::function<void(std::complex<int16_t>*, int, double)>;
+
+    explicit CallbackSourceStage(Callback callback) : callback_(std::move(callback)) {}
+    StageKind kind() const override { return StageKind::SOURCE; }
+    std::vector<PortType> input_types() const override { return {}; }
+    PortType output_type() const override { return PortType::COMPLEX_INT16; }
+    void process(const StageBuffer*, const StageBuffer* output, int sample_count, double time_now) override;
+
+private:
+    Callback callback_;
+};
+
+// Hands int16 chunks to a callback (file, socket, stdout, ...)
+class CallbackSinkStage : public IStage {
+public:
+    using Callback = std::function<void(const std::complex<int16_t>*, int, double)>;
+
+    explicit CallbackSinkStage(Callback callback) : callback_(std::move(callback)) {}
+    StageKind kind() const override { return StageKind::SINK; }
+    std::vector<PortType> input_types() const override { return {PortType::COMPLEX_INT16}; }
+    void process(const StageBuffer* inputs, const StageBuffer*, int sample_count, double time_now) override;
+
+private:
+    Callback callback_;
+};
+
+/**
+ * Dataflow graph of processing stages
+ *
+ * compile() validates port types, orders the stages, fuses chains of
+ * element-wise transforms into their producer and assigns pooled buffers
+ * from the lifetime of every intermediate result, so run() allocates
+ * nothing. Stages of the same topological level run concurrently on the
+ * graph's worker threads.
+ */
+class StageGraph {
+public:
+    static constexpr int FUSED_TILE_SAMPLES = 2048;   // Fused chains run tile by tile to stay in cache
+
+    /**
+     * Constructor
+     * @param worker_threads Worker threads (0 = run every stage on the caller's thread)
+     */
+    explicit StageGraph(size_t worker_threads = 0);
+    ~StageGraph();
+
+    StageGraph(const StageGraph&) = delete;
+    StageGraph& operator=(const StageGraph&) = delete;
+
+    /**
+     * Add a stage
+     * @param name Unique stage name
+     * @return Stage id
+     * @throws QuadGNSSException if the name is taken or the graph is compiled
+     */
+    size_t add_stage(const std::string& name, std::unique_ptr<IStage> stage);
+
+    /**
+     * Connect the output of one stage to an input port of another
+     * @throws QuadGNSSException on unknown stages, bad ports or type mismatch
+     */
+    void connect(size_t from, size_t to, size_t input_port = 0);
+    void connect(const std::string& from, const std::string& to, size_t input_port = 0);
+
+    /**
+     * Have a stage write its output straight into caller memory
+     *
+     * Before every run() the graph asks target for the chunk's buffer (room
+     * for max_samples samples of the stage's output type) and uses it in
+     * place of a pooled buffer: the stage, any element-wise transforms fused
+     * after it and its consumers all work in that memory, so a sink can
+     * publish the chunk where it already is (e.g. a shared-memory ring slot).
+     * @param target Returns the buffer for the next chunk; must not return nullptr
+     * @throws QuadGNSSException for sinks, unknown stages or a compiled graph
+     */
+    void set_output_target(size_t stage, std::function<void*()> target);
+
+    /**
+     * Validate and plan the graph
+     * @param max_samples Largest chunk passed to run()
+     * @throws QuadGNSSException on unconnected inputs, cycles or a graph without sinks
+     */
+    void compile(int max_samples);
+
+    /**
+     * Run every stage for one chunk
+     * @throws QuadGNSSException if not compiled or sample_count exceeds max_samples
+     */
+    void run(int sample_count, double time_now);
+
+    size_t find_stage(const std::string& name) const;
+    bool is_compiled() const { return compiled_; }
+    size_t get_stage_count() const { return nodes_.size(); }
+    size_t get_task_count() const { return tasks_.size(); }
+    size_t get_fused_stage_count() const { return fused_stages_; }
+    size_t get_buffer_count() const { return pool_.size(); }
+    size_t get_level_count() const { return levels_.size(); }
+
+private:
+    struct Node {
+        std::string name;
+        std::unique_ptr<IStage> stage;
+        std::vector<long> inputs;              // Producer node per input port (-1 = unconnected)
+        std::vector<size_t> consumers;
+        size_t task = 0;                       // Task that executes this node
+        std::function<void*()> output_target;  // Caller memory for the output (empty = pooled)
+    };
+
+    // Unit of scheduling: one stage plus the element-wise stages fused after it
+    struct Task {
+        size_t head;
+        std::vector<size_t> fused;
+        std::vector<size_t> input_buffers;     // Pool slot per input port
+        long output_buffer = -1;               // Pool slot (-1 for sinks)
+        size_t level = 0;
+    };
+
+    struct PoolBuffer {
+        PortType type;
+        std::vector<std::complex<float>> storage;   // Sized for the largest sample type
+        std::function<void*()> target;              // Set for caller memory (storage stays empty)
+        void* external = nullptr;                   // This chunk's caller buffer
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<Task> tasks_;
+    std::vector<std::vector<size_t>> levels_;
+    std::vector<PoolBuffer> pool_;
+    size_t fused_stages_;
+    int max_samples_;
+    bool compiled_;
+
+    // Worker pool: one level at a time
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::vector<size_t>* current_level_;
+    size_t next_task_;
+    size_t pending_tasks_;
+    int chunk_samples_;
+    double chunk_time_;
+    uint64_t generation_;
+    bool stopping_;
+    std::string task_error_;
+
+    StageBuffer view(size_t slot, int sample_count);
+    void execute_task(size_t task_index, int sample_count, double time_now);
+    void worker_loop();
+};
+
+// Declarative description of one stage, e.g. from a scenario file
+struct StageSpec {
+    std::string name;
+    std::string type;                          // sum, gain, frequency_shift, noise, quantize or external
+    std::map<std::string, double> params;
+    std::vector<std::string> inputs;           // Producer names, in input port order
+};
+
+/**
+ * Build a graph from declarative stage specs
+ *
+ * Stages of type "external" are taken from external_stages by name
+ * (constellation sources, sinks and anything else the caller wires in).
+ *
+ * @param specs Stage descriptions in any order
+ * @param external_stages Caller-provided stages (moved from)
+ * @param config Sampling configuration
+ * @param worker_threads Graph worker threads
+ * @throws QuadGNSSException on unknown types, missing parameters or bad wiring
+ */
+std::unique_ptr<StageGraph> build_stage_graph(const std::vector<StageSpec>& specs,
+                                              std::map<std::string, std::unique_ptr<IStage>>& external_stages,
+                                              const GlobalConfig& config,
+                                              size_t worker_threads = 0);
+
+} // namespace QuadGNSS
+
+#endif // STAGE_GRAPH_H
@@ -0,0 +1,143 @@
+#ifndef TELEMETRY_SNAPSHOT_H
+#define TELEMETRY_SNAPSHOT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+// Per-chunk telemetry published by the generation thread
+struct TelemetrySnapshot {
+    // All four constellations fully populated: GPS 32, GLONASS 24 slots, Galileo 36, BeiDou 63
+    static constexpr size_t MAX_SATELLITES = 32 + 24 + 36 + 63;
+
+    uint64_t chunk_index;                        // Chunks generated before this snapshot
+    uint64_t sample_index;                       // First sample index of the chunk
+    uint32_t sample_count;                       // Samples in the chunk
+    double time_gps;                             // GPS time at start of chunk (s)
+    uint64_t commands_applied;                   // Control commands applied so far
+    uint64_t commands_rejected;                  // Control commands no constellation accepted
+    uint64_t commands_dropped;                   // Control commands lost to a full schedule
+    uint32_t satellite_count;                    // Valid entries in satellites[]
+    SatelliteStatus satellites[MAX_SATELLITES];
+};
+
+/**
+ * Single-writer, multi-reader seqlock
+ *
+ * The writer never blocks or waits for readers. Readers retry while a publish
+ * is in flight. The payload is held in relaxed atomic words, so a torn read is
+ * detected by the sequence check instead of being undefined behaviour.
+ */
+template <typename T>
+class SeqlockSnapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock payload must be trivially copyable");
+
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence_;
+    alignas(64) std::atomic<uint64_t> words_[WORD_COUNT];
+
+    bool read_once(T& out, uint64_t& seq_before) const {
+        seq_before = sequence_.load(std::memory_order_acquire);
+        if (seq_before & 1) {
+            return false;
+        }
+
+        unsigned char* dst = reinterpret_cast<unsigned char*>(&out);
+        for (size_t w = 0; w < WORD_COUNT; ++w) {
+            uint64_t word = words_[w].load(std::memory_order_relaxed);
+            size_t bytes = std::min(sizeof(uint64_t), sizeof(T) - w * sizeof(uint64_t));
+            std::memcpy(dst + w * sizeof(uint64_t), &word, bytes);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.load(std::memory_order_relaxed) == seq_before;
+    }
+
+public:
+    SeqlockSnapshot() : sequence_(0) {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SeqlockSnapshot(const SeqlockSnapshot&) = delete;
+    SeqlockSnapshot& operator=(const SeqlockSnapshot&) = delete;
+
+    /**
+     * Publish a new value (single writer thread only)
+     * @param value Value to publish
+     */
+    void publish(const T& value) {
+        uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t w = 0; w < WORD_COUNT; ++w) {
+            uint64_t word = 0;
+            size_t bytes = std::min(sizeof(uint64_t), sizeof(T) - w * sizeof(uint64_t));
+            std::memcpy(&word, src + w * sizeof(uint64_t), bytes);
+            words_[w].store(word, std::memory_order_relaxed);
+        }
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Attempt a single consistent read
+     * @param out Destination for the value
+     * @return false if a publish overlapped the read
+     */
+    bool try_read(T& out) const {
+        uint64_t seq;
+        return read_once(out, seq);
+    }
+
+    /**
+     * Read the latest consistent value, retrying until no publish overlaps
+     * @param out Destination for the value
+     * @return Number of values published so far (0 if nothing published yet)
+     */
+    uint64_t read(T& out) const {
+        uint64_t seq;
+        while (!read_once(out, seq)) {
+        }
+        return seq / 2;
+    }
+
+    /**
+     * Number of completed publishes
+     */
+    uint64_t version() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+};
+
+// Telemetry channel owned by SignalOrchestrator
+class TelemetryChannel {
+private:
+    SeqlockSnapshot<TelemetrySnapshot> published_;
+    TelemetrySnapshot staging_;                  // Writer-side scratch, never read by monitors
+
+public:
+    TelemetryChannel() : staging_() {}
+
+    // Writer side (generation thread)
+    TelemetrySnapshot& staging() { return staging_; }
+    void publish_staging() { published_.publish(staging_); }
+
+    // Reader side (any thread)
+    uint64_t read(TelemetrySnapshot& out) const { return published_.read(out); }
+    bool try_read(TelemetrySnapshot& out) const { return published_.try_read(out); }
+    uint64_t version() const { return published_.version(); }
+};
+
+} // namespace QuadGNSS
+
+#endif // TELEMETRY_SNAPSHOT_H
@@ -0,0 +1,107 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Compiled in unless the build sets QUADGNSS_TRACING=0; switched on at run time by Tracer::start()
+#ifndef QUADGNSS_TRACING
+#define QUADGNSS_TRACING 1
+#endif
+
+namespace QuadGNSS {
+
+struct TraceStats {
+    uint64_t events;                           // Recorded begin and end events
+    uint64_t dropped;                          // Events that found their thread's buffer full
+    size_t threads;                            // Threads that recorded anything
+};
+
+/**
+ * Timeline tracer: begin/end events per thread
+ *
+ * Each thread appends to its own fixed-size buffer; nothing is shared on
+ * the recording path, so it takes no lock and never allocates after the
+ * thread's first event. A begin is only recorded if the buffer still has
+ * room for the ends of every open scope, so the timeline stays balanced
+ * when a buffer fills up; later events are counted as dropped.
+ *
+ * Switched off, a trace point costs one relaxed load and a branch.
+ * start(), stop() and the writers belong to one controlling thread;
+ * write after stop(). Names and categories must be string literals (or
+ * otherwise outlive the trace): only the pointer is stored.
+ */
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = size_t(1) << 18;     // 12 MB per tracing thread
+
+    // Clear earlier events and start recording
+    static void start(size_t events_per_thread = DEFAULT_EVENTS_PER_THREAD);
+    static void stop();
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Record the start of a slice on the calling thread
+     * @param arg_name Name of an integer argument shown with the slice (nullptr = none)
+     * @return false if not recorded (tracing off or buffer full); skip the end() then
+     */
+    static bool begin(const char* category, const char* name, const char* arg_name = nullptr, int64_t arg = 0);
+    static void end(const char* category, const char* name);
+
+    // Name shown for the calling thread; kept across start() calls
+    static void set_thread_name(const std::string& name);
+
+    static TraceStats stats();
+
+    /**
+     * Write the recorded events
+     * @param path ".json" gives Chrome trace JSON, anything else Perfetto protobuf
+     * @throws QuadGNSSException if the file cannot be written
+     */
+    static void write(const std::string& path);
+    static void write_chrome_json(const std::string& path);
+    static void write_perfetto(const std::string& path);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Slice covering the enclosing scope
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name, const char* arg_name = nullptr, int64_t arg = 0)
+        : category_(category), name_(name)
+        , active_(Tracer::enabled() && Tracer::begin(category, name, arg_name, arg)) {}
+    ~TraceScope() {
+        if (active_) Tracer::end(category_, name_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* category_;
+    const char* name_;
+    bool active_;
+};
+
+} // namespace QuadGNSS
+
+#if QUADGNSS_TRACING
+#define QGNSS_TRACE_CONCAT_(a, b) a##b
+#define QGNSS_TRACE_CONCAT(a, b) QGNSS_TRACE_CONCAT_(a, b)
+#define QGNSS_TRACE_SCOPE(category, name) \
+    ::QuadGNSS::TraceScope QGNSS_TRACE_CONCAT(qgnss_trace_, __LINE__)(category, name)
+#define QGNSS_TRACE_SCOPE_ARG(category, name, arg_name, arg) \
+    ::QuadGNSS::TraceScope QGNSS_TRACE_CONCAT(qgnss_trace_, __LINE__)(category, name, arg_name, static_cast<int64_t>(arg))
+#define QGNSS_TRACE_THREAD_NAME(name) ::QuadGNSS::Tracer::set_thread_name(name)
+#else
+#define QGNSS_TRACE_SCOPE(category, name) ((void)0)
+#define QGNSS_TRACE_SCOPE_ARG(category, name, arg_name, arg) ((void)0)
+#define QGNSS_TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+#endif // TRACE_H
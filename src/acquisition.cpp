@@ -0,0 +1,424 @@
+#include "../include/acquisition.h"
+#include "../include/fft.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr double SPEED_OF_LIGHT = 299792458.0;
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+constexpr int FLOOR_OFFSETS = 16;                    // Code offsets averaged for the C/N0 noise floor
+
+// Unit phasor exp(-j*2*pi*frequency*i/fs), kept exact by re-seeding every block
+class Oscillator {
+public:
+    Oscillator(double frequency_hz, double sampling_rate_hz, size_t first_sample)
+        : cycles_per_sample_(frequency_hz / sampling_rate_hz), index_(first_sample) {
+        double angle = -2.0 * M_PI * cycles_per_sample_;
+        step_re_ = std::cos(angle);
+        step_im_ = std::sin(angle);
+        seed();
+    }
+
+    // Multiply a sample by the current phasor and advance
+    std::complex<float> mix(float re, float im) {
+        std::complex<float> value(static_cast<float>(re * re_ - im * im_), static_cast<float>(re * im_ + im * re_));
+        double next_re = re_ * step_re_ - im_ * step_im_;
+        im_ = re_ * step_im_ + im_ * step_re_;
+        re_ = next_re;
+        if ((++index_ & (RESEED_INTERVAL - 1)) == 0) seed();
+        return value;
+    }
+
+private:
+    static constexpr size_t RESEED_INTERVAL = 4096;
+
+    double cycles_per_sample_;
+    size_t index_;
+    double re_, im_;
+    double step_re_, step_im_;
+
+    void seed() {
+        double cycles = cycles_per_sample_ * static_cast<double>(index_);
+        double angle = -2.0 * M_PI * (cycles - std::floor(cycles));
+        re_ = std::cos(angle);
+        im_ = std::sin(angle);
+    }
+};
+
+// Run body(index) for index in [0, count) on up to `threads` threads
+template <typename Body>
+void parallel_for(size_t count, size_t threads, Body body) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            body(i);
+        }
+    };
+    size_t extra = std::min(threads, count) > 0 ? std::min(threads, count) - 1 : 0;
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < extra; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+double wrap_chips(double chips, double length) {
+    double wrapped = std::fmod(chips, length);
+    if (wrapped < -length / 2.0) wrapped += length;
+    if (wrapped >= length / 2.0) wrapped -= length;
+    return wrapped;
+}
+
+// Replica value at a code position: the chip, split by the square subcarrier on BOC(1,1) bands
+float replica_chip(const std::vector<int8_t>& code, double chip, bool boc) {
+    float value = code[static_cast<size_t>(chip)];
+    return boc && chip - std::floor(chip) >= 0.5 ? -value : value;
+}
+
+} // namespace
+
+// Coarse search layout of one band in the current stream
+struct AcquisitionEngine::BandPlan {
+    const BandInfo* info;
+    bool pilot;
+    double carrier_hz;                         // The searched channel's carrier for FDMA bands
+    double if_hz;
+    double period_s;
+    double samples_per_period;                 // Possibly fractional
+    size_t bins;                               // FFT size per code period
+    size_t periods;
+    size_t required_samples;
+};
+
+// Coarse result of one (target, Doppler bin) pair
+struct AcquisitionEngine::SearchTask {
+    size_t target;
+    double doppler_hz;
+    float peak;
+    float second_peak;
+    size_t peak_bin;
+};
+
+bool within_tolerance(const AcquisitionResult& result, const AcquisitionTolerance& tolerance) {
+    if (!result.detected) return false;
+    if (!std::isnan(result.code_phase_error_chips) &&
+        std::abs(result.code_phase_error_chips) > tolerance.code_phase_chips) return false;
+    if (!std::isnan(result.doppler_error_hz) && std::abs(result.doppler_error_hz) > tolerance.doppler_hz) return false;
+    if (!std::isnan(result.cn0_error_db) && std::abs(result.cn0_error_db) > tolerance.cn0_db) return false;
+    return true;
+}
+
+AcquisitionTarget make_acquisition_target(const SatelliteBackbone& backbone, const BackboneSatellite& satellite,
+                                          SignalBand band, double block_time) {
+    const BandInfo& info = get_band_info(band);
+    if (satellite.constellation != info.constellation) {
+        throw QuadGNSSException(std::string("Satellite is not of the constellation of ") + info.name);
+    }
+
+    // Same propagation as the renderer, evaluated at the first sample of the block
+    const SatelliteGeometry& g = satellite.geometry;
+    double range = g.range_m + g.range_rate_m_s * (block_time - backbone.get_update_time());
+    double delay = range / SPEED_OF_LIGHT - g.clock_bias_s;
+    double transmit_chips = (block_time - delay) * info.chip_rate_hz;
+    double length = static_cast<double>(info.code_length);
+
+    AcquisitionTarget target;
+    const int channel = info.channel_spacing_hz != 0.0 ? satellite.frequency_channel : 0;
+    target.band = band;
+    target.prn = satellite.prn;
+    target.frequency_channel = channel;
+    target.has_truth = true;
+    target.expected_code_phase_chips = transmit_chips - std::floor(transmit_chips / length) * length;
+    target.expected_doppler_hz = -band_carrier_hz(band, channel) * g.range_rate_m_s / SPEED_OF_LIGHT;
+    return target;
+}
+
+AcquisitionEngine::AcquisitionEngine(const AcquisitionSettings& settings, std::shared_ptr<BandCodeCache> codes)
+    : settings_(settings), codes_(codes ? std::move(codes) : std::make_shared<BandCodeCache>())
+    , fft_count_(0), last_elapsed_s_(0.0) {
+    if (settings_.sampling_rate_hz <= 0.0 || settings_.integration_ms <= 0.0 || settings_.doppler_span_hz < 0.0 ||
+        settings_.doppler_step_hz < 0.0 || settings_.detection_ratio <= 1.0) {
+        throw QuadGNSSException("Invalid acquisition settings");
+    }
+    if (settings_.threads == 0) {
+        settings_.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+AcquisitionEngine::BandPlan AcquisitionEngine::plan_band(SignalBand band, int frequency_channel) const {
+    BandPlan plan;
+    plan.info = &get_band_info(band);
+    plan.pilot = plan.info->has_pilot;
+    plan.carrier_hz = band_carrier_hz(band, frequency_channel);
+    plan.if_hz = plan.carrier_hz - settings_.center_frequency_hz;
+    if (!band_fits_stream(band, frequency_channel, settings_.center_frequency_hz, settings_.sampling_rate_hz)) {
+        throw QuadGNSSException(std::string(plan.info->name) + " does not fit the stream bandwidth");
+    }
+
+    const double length = static_cast<double>(plan.info->code_length);
+    plan.period_s = length / plan.info->chip_rate_hz;
+    plan.samples_per_period = settings_.sampling_rate_hz * plan.period_s;
+
+    // Power-of-two bins per period: no more than the samples, no finer than 8 bins per chip,
+    // and at least one per chip (one per subcarrier half chip for BOC)
+    double limit = std::min(plan.samples_per_period, 8.0 * length);
+    plan.bins = 1;
+    while (static_cast<double>(plan.bins * 2) <= limit) plan.bins *= 2;
+    if (static_cast<double>(plan.bins) < (plan.info->boc_subcarrier ? 2.0 : 1.0) * length) {
+        throw QuadGNSSException(std::string(plan.info->name) + " is sampled too coarsely for acquisition");
+    }
+
+    // Three periods minimum: the fine stage needs two complete code epochs
+    plan.periods = std::max<size_t>(3, static_cast<size_t>(std::llround(settings_.integration_ms * 1e-3 / plan.period_s)));
+    plan.required_samples = static_cast<size_t>(std::ceil(plan.periods * plan.samples_per_period));
+    return plan;
+}
+
+size_t AcquisitionEngine::required_samples(SignalBand band, int frequency_channel) const {
+    return plan_band(band, frequency_channel).required_samples;
+}
+
+std::vector<AcquisitionResult> AcquisitionEngine::acquire(const std::complex<int16_t>* samples, size_t sample_count,
+                                                          const std::vector<AcquisitionTarget>& targets) {
+    auto start = std::chrono::steady_clock::now();
+    const double fs = settings_.sampling_rate_hz;
+
+    // Per-carrier layout and carrier-wiped, bin-averaged periods shared by every PRN of the band (and channel)
+    using CarrierKey = std::pair<SignalBand, int>;
+    auto key_of = [](const AcquisitionTarget& target) { return CarrierKey(target.band, target.frequency_channel); };
+    std::map<CarrierKey, BandPlan> plans;
+    std::map<CarrierKey, std::vector<std::vector<std::complex<float>>>> baseband;
+    for (const auto& target : targets) {
+        if (plans.count(key_of(target))) continue;
+        BandPlan plan = plan_band(target.band, target.frequency_channel);
+        if (sample_count < plan.required_samples) {
+            throw QuadGNSSException(std::string("Block too short to acquire ") + plan.info->name);
+        }
+        auto& periods = baseband[key_of(target)];
+        periods.assign(plan.periods, std::vector<std::complex<float>>(plan.bins));
+        Oscillator oscillator(plan.if_hz, fs, 0);
+        const double bins_per_sample = static_cast<double>(plan.bins) / plan.samples_per_period;
+        for (size_t k = 0; k < plan.periods; ++k) {
+            double period_start = k * plan.samples_per_period;
+            size_t first = static_cast<size_t>(std::ceil(period_start));
+            size_t last = std::min(plan.required_samples, static_cast<size_t>(std::ceil(period_start + plan.samples_per_period)));
+            for (size_t i = first; i < last; ++i) {
+                size_t bin = std::min(plan.bins - 1, static_cast<size_t>((i - period_start) * bins_per_sample));
+                periods[k][bin] += oscillator.mix(samples[i].real(), samples[i].imag());
+            }
+        }
+        plans.emplace(key_of(target), plan);
+    }
+
+    // Conjugate replica spectra (split re/im), one chip value per bin centre
+    struct Replica { std::vector<float> re, im; };
+    std::vector<Replica> replicas(targets.size());
+    std::vector<BandCodeCache::Code> codes(targets.size());
+    std::atomic<uint64_t> ffts{0};
+    for (size_t t = 0; t < targets.size(); ++t) {
+        const BandPlan& plan = plans.at(key_of(targets[t]));
+        codes[t] = codes_->get(targets[t].band, targets[t].prn, plan.pilot);
+        const double chips_per_bin = static_cast<double>(plan.info->code_length) / plan.bins;
+        replicas[t].re.resize(plan.bins);
+        replicas[t].im.assign(plan.bins, 0.0f);
+        for (size_t j = 0; j < plan.bins; ++j) {
+            replicas[t].re[j] = replica_chip(*codes[t], (j + 0.5) * chips_per_bin, plan.info->boc_subcarrier);
+        }
+        Fft(plan.bins).forward(replicas[t].re.data(), replicas[t].im.data());
+        for (auto& value : replicas[t].im) value = -value;
+        ffts++;
+    }
+
+    // Coarse search over (target, Doppler bin)
+    std::vector<SearchTask> tasks;
+    for (size_t t = 0; t < targets.size(); ++t) {
+        const BandPlan& plan = plans.at(key_of(targets[t]));
+        double step = settings_.doppler_step_hz > 0.0 ? settings_.doppler_step_hz : 1.0 / (3.0 * plan.period_s);
+        int half_bins = static_cast<int>(std::floor(settings_.doppler_span_hz / step));
+        for (int d = -half_bins; d <= half_bins; ++d) {
+            tasks.push_back(SearchTask{t, d * step, 0.0f, 0.0f, 0});
+        }
+    }
+
+    parallel_for(tasks.size(), settings_.threads, [&](size_t index) {
+        SearchTask& task = tasks[index];
+        const BandPlan& plan = plans.at(key_of(targets[task.target]));
+        const auto& periods = baseband.at(key_of(targets[task.target]));
+        const size_t n = plan.bins;
+        Fft fft(n);
+
+        // Residual Doppler across one period, relative to the period start
+        std::vector<float> rot_re(n), rot_im(n);
+        Oscillator oscillator(task.doppler_hz, fs * plan.bins / plan.samples_per_period, 0);
+        for (size_t j = 0; j < n; ++j) {
+            std::complex<float> value = oscillator.mix(1.0f, 0.0f);
+            rot_re[j] = value.real();
+            rot_im[j] = value.imag();
+        }
+
+        std::vector<float> work_re(n), work_im(n);
+        std::vector<float> power(n, 0.0f);
+        const float* c_re = replicas[task.target].re.data();
+        const float* c_im = replicas[task.target].im.data();
+        float* w_re = work_re.data();
+        float* w_im = work_im.data();
+        for (const auto& period : periods) {
+            const float* p = reinterpret_cast<const float*>(period.data());
+            for (size_t j = 0; j < n; ++j) {
+                w_re[j] = p[2 * j] * rot_re[j] - p[2 * j + 1] * rot_im[j];
+                w_im[j] = p[2 * j] * rot_im[j] + p[2 * j + 1] * rot_re[j];
+            }
+            fft.forward(w_re, w_im);
+            for (size_t j = 0; j < n; ++j) {
+                float re = w_re[j] * c_re[j] - w_im[j] * c_im[j];
+                w_im[j] = w_re[j] * c_im[j] + w_im[j] * c_re[j];
+                w_re[j] = re;
+            }
+            fft.inverse(w_re, w_im);
+            for (size_t j = 0; j < n; ++j) {
+                power[j] += w_re[j] * w_re[j] + w_im[j] * w_im[j];
+            }
+        }
+        ffts += 2 * periods.size();
+
+        size_t peak = static_cast<size_t>(std::max_element(power.begin(), power.end()) - power.begin());
+        // BOC(1,1) correlates at -1/2 one chip either side of the peak
+        size_t exclusion = (plan.info->boc_subcarrier ? 2 : 1) * n / plan.info->code_length + 2;
+        float second = 0.0f;
+        for (size_t j = 0; j < n; ++j) {
+            size_t distance = j > peak ? j - peak : peak - j;
+            if (std::min(distance, n - distance) > exclusion) second = std::max(second, power[j]);
+        }
+        task.peak = power[peak];
+        task.second_peak = second;
+        task.peak_bin = peak;
+    });
+
+    // Best Doppler bin per target
+    std::vector<const SearchTask*> best(targets.size(), nullptr);
+    for (const auto& task : tasks) {
+        if (!best[task.target] || task.peak > best[task.target]->peak) best[task.target] = &task;
+    }
+
+    std::vector<AcquisitionResult> results(targets.size());
+    for (size_t t = 0; t < targets.size(); ++t) {
+        const BandPlan& plan = plans.at(key_of(targets[t]));
+        const SearchTask& task = *best[t];
+        AcquisitionResult& r = results[t];
+        r.band = targets[t].band;
+        r.prn = targets[t].prn;
+        r.pilot = plan.pilot;
+        r.peak_ratio = task.second_peak > 0.0f ? task.peak / task.second_peak : std::numeric_limits<double>::infinity();
+        r.detected = r.peak_ratio >= settings_.detection_ratio;
+        // Peak at lag tau means the block is the replica advanced by tau bins
+        r.code_phase_chips = static_cast<double>((plan.bins - task.peak_bin) % plan.bins) *
+                             plan.info->code_length / plan.bins;
+        r.doppler_hz = task.doppler_hz;
+        r.cn0_dbhz = NaN;
+    }
+
+    // Fine stage at the full sample rate for every detection
+    parallel_for(targets.size(), settings_.threads, [&](size_t t) {
+        AcquisitionResult& r = results[t];
+        if (!r.detected) return;
+        const BandPlan& plan = plans.at(key_of(targets[t]));
+        const std::vector<int8_t>& code = *codes[t];
+        const double length = static_cast<double>(plan.info->code_length);
+        const size_t total = plan.required_samples;
+
+        std::vector<std::complex<float>> wiped(total);
+        auto wipe = [&](double doppler_hz) {
+            Oscillator oscillator(plan.if_hz + doppler_hz, fs, 0);
+            for (size_t i = 0; i < total; ++i) {
+                wiped[i] = oscillator.mix(samples[i].real(), samples[i].imag());
+            }
+        };
+
+        // Prompt per complete code epoch of the signal; offset shifts the replica only
+        double phase = r.code_phase_chips;
+        double doppler = r.doppler_hz;
+        auto epochs = [&](double offset_chips) {
+            double step = plan.info->chip_rate_hz * (1.0 + doppler / plan.carrier_hz) / fs;
+            std::vector<std::complex<double>> prompt;
+            for (size_t e = 1;; ++e) {
+                size_t first = static_cast<size_t>(std::ceil((e * length - phase) / step));
+                size_t last = static_cast<size_t>(std::ceil(((e + 1) * length - phase) / step));
+                if (last > total) break;
+                double chip = std::fmod(phase + first * step + offset_chips, length);
+                if (chip < 0.0) chip += length;
+                double sum_re = 0.0, sum_im = 0.0;
+                for (size_t i = first; i < last; ++i) {
+                    if (chip >= length) chip -= length;
+                    float sign = replica_chip(code, chip, plan.info->boc_subcarrier);
+                    sum_re += sign * wiped[i].real();
+                    sum_im += sign * wiped[i].imag();
+                    chip += step;
+                }
+                prompt.push_back(std::complex<double>(sum_re, sum_im));
+            }
+            return prompt;
+        };
+        auto mean_power = [](const std::vector<std::complex<double>>& values) {
+            double sum = 0.0;
+            for (const auto& v : values) sum += std::norm(v);
+            return values.empty() ? 0.0 : sum / values.size();
+        };
+
+        // Doppler: rotation between epochs, squared so symbol flips cancel
+        wipe(doppler);
+        std::vector<std::complex<double>> prompt = epochs(0.0);
+        std::complex<double> rotation(0.0, 0.0);
+        for (size_t e = 1; e < prompt.size(); ++e) {
+            std::complex<double> product = prompt[e] * std::conj(prompt[e - 1]);
+            rotation += product * product;
+        }
+        doppler += std::arg(rotation) / (2.0 * 2.0 * M_PI * plan.period_s);
+        wipe(doppler);
+
+        // Code phase: early/late interpolation on the correlation triangle (BOC: its central peak,
+        // which falls to zero within a third of a chip)
+        const double spacing = plan.info->boc_subcarrier ? 1.0 / 6.0 : 0.5;
+        double early = std::sqrt(mean_power(epochs(-spacing)));
+        double middle = std::sqrt(mean_power(epochs(0.0)));
+        double late = std::sqrt(mean_power(epochs(spacing)));
+        double shift = late >= early ? spacing * (late - early) / (2.0 * std::max(middle - early, 1e-9))
+                                     : spacing * (late - early) / (2.0 * std::max(middle - late, 1e-9));
+        phase = std::fmod(phase + std::max(-spacing, std::min(spacing, shift)) + length, length);
+
+        // C/N0: prompt power against the correlation floor at distant code offsets
+        double signal = mean_power(epochs(0.0));
+        double floor_power = 0.0;
+        for (int n = 1; n <= FLOOR_OFFSETS; ++n) {
+            floor_power += mean_power(epochs(n * length / (FLOOR_OFFSETS + 1) + 0.5)) / FLOOR_OFFSETS;
+        }
+        double snr = floor_power > 0.0 ? (signal - floor_power) / floor_power : 1e12;
+        r.cn0_dbhz = 10.0 * std::log10(std::max(snr, 1e-3) / plan.period_s);
+        r.code_phase_chips = phase;
+        r.doppler_hz = doppler;
+    });
+
+    for (size_t t = 0; t < targets.size(); ++t) {
+        AcquisitionResult& r = results[t];
+        const AcquisitionTarget& target = targets[t];
+        const double length = static_cast<double>(get_band_info(target.band).code_length);
+        r.code_phase_error_chips = target.has_truth && r.detected
+            ? wrap_chips(r.code_phase_chips - target.expected_code_phase_chips, length) : NaN;
+        r.doppler_error_hz = target.has_truth && r.detected ? r.doppler_hz - target.expected_doppler_hz : NaN;
+        r.cn0_error_db = r.detected && !std::isnan(target.expected_cn0_dbhz) ? r.cn0_dbhz - target.expected_cn0_dbhz : NaN;
+    }
+
+    fft_count_ += ffts.load();
+    last_elapsed_s_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return results;
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,138 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include "../include/acquisition.h"
+#include "../include/batch_runner.h"
+
+using namespace QuadGNSS;
+
+// Verify a capture rendered from a scenario (e.g. by quad_gnss_sim --batch) against the scenario truth
+int main(int argc, char* argv[]) {
+    std::string scenario_path;
+    std::string input_path;
+    int blocks = 5;
+    double noise_sigma = 0.0;
+    AcquisitionSettings settings;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+            scenario_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            input_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--blocks") == 0 && i + 1 < argc) {
+            blocks = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--integration-ms") == 0 && i + 1 < argc) {
+            settings.integration_ms = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--doppler-span") == 0 && i + 1 < argc) {
+            settings.doppler_span_hz = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--noise-sigma") == 0 && i + 1 < argc) {
+            noise_sigma = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            settings.threads = static_cast<size_t>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " --scenario file.json --input capture.iq [--blocks N]"
+                      << " [--integration-ms ms] [--doppler-span Hz] [--noise-sigma LSB] [--threads N]" << std::endl;
+            return 1;
+        }
+    }
+    if (scenario_path.empty() || input_path.empty()) {
+        std::cerr << "--scenario and --input are required" << std::endl;
+        return 1;
+    }
+
+    try {
+        std::shared_ptr<const ExecutionPlan> plan = ScenarioCompiler::compile_file(scenario_path);
+        const GlobalConfig& config = plan->get_config();
+        require_no_pipeline(*plan, "quad_gnss_verify");
+        std::vector<BandStreamConfig> bands = bands_for_plan(*plan);
+
+        settings.sampling_rate_hz = config.sampling_rate_hz;
+        settings.center_frequency_hz = config.center_frequency_hz;
+        AcquisitionEngine engine(settings);
+        size_t block_samples = 0;
+        for (const auto& band : bands) {
+            const BandInfo& info = get_band_info(band.band);
+            for (const auto& sat : plan->get_satellites()) {
+                if (sat.constellation != info.constellation) continue;
+                int channel = info.channel_spacing_hz != 0.0 ? sat.glonass_channel : 0;
+                block_samples = std::max(block_samples, engine.required_samples(band.band, channel));
+            }
+        }
+
+        std::ifstream input(input_path, std::ios::binary | std::ios::ate);
+        if (!input) {
+            throw QuadGNSSException("Cannot open capture: " + input_path);
+        }
+        size_t total_samples = static_cast<size_t>(input.tellg()) / sizeof(std::complex<int16_t>);
+        if (total_samples < block_samples) {
+            throw QuadGNSSException("Capture is shorter than one acquisition block");
+        }
+
+        SatelliteBackbone backbone;
+        for (const auto& sat : plan->get_satellites()) {
+            backbone.add_satellite(sat.constellation, sat.prn, sat.power_dbm, sat.glonass_channel);
+        }
+        for (const auto& entry : plan->get_ephemeris()) {
+            backbone.set_ephemeris(entry.first, *entry.second);
+        }
+
+        AcquisitionTolerance tolerance;
+        size_t checked = 0, passed = 0;
+        double elapsed = 0.0;
+        std::vector<std::complex<int16_t>> block(block_samples);
+        for (int b = 0; b < blocks; ++b) {
+            size_t first = (total_samples - block_samples) / static_cast<size_t>(blocks) * static_cast<size_t>(b);
+            input.seekg(static_cast<std::streamoff>(first * sizeof(std::complex<int16_t>)));
+            input.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block_samples * sizeof(std::complex<int16_t>)));
+
+            double offset_s = first / config.sampling_rate_hz;
+            double block_time = config.simulation.start_time_gps + offset_s;
+            double x, y, z;
+            plan->receiver_position(offset_s, x, y, z);
+            backbone.set_receiver_position(x, y, z);
+            backbone.update(block_time, block_samples / config.sampling_rate_hz);
+
+            std::vector<AcquisitionTarget> targets;
+            for (const auto& band : bands) {
+                for (const auto& sat : backbone.satellites()) {
+                    if (sat.constellation != get_band_info(band.band).constellation) continue;
+                    AcquisitionTarget target = make_acquisition_target(backbone, sat, band.band, block_time);
+                    if (noise_sigma > 0.0) {
+                        double amplitude = band_component_amplitude(band.band, sat.power_dbm);
+                        target.expected_cn0_dbhz = 10.0 * std::log10(amplitude * amplitude * config.sampling_rate_hz /
+                                                                     (2.0 * noise_sigma * noise_sigma));
+                    }
+                    targets.push_back(target);
+                }
+            }
+
+            std::vector<AcquisitionResult> results = engine.acquire(block.data(), block.size(), targets);
+            elapsed += engine.get_last_elapsed();
+            std::cout << "Block " << b << " at +" << std::fixed << std::setprecision(3) << offset_s << " s" << std::endl;
+            for (const auto& r : results) {
+                bool ok = within_tolerance(r, tolerance);
+                checked++;
+                passed += ok ? 1 : 0;
+                std::cout << "  " << (ok ? "✅ " : "❌ ") << get_band_info(r.band).name << " PRN " << std::setw(2) << r.prn;
+                if (!r.detected) {
+                    std::cout << " not detected (peak ratio " << std::setprecision(2) << r.peak_ratio << ")" << std::endl;
+                    continue;
+                }
+                std::cout << std::setprecision(3) << "  phase err " << std::setw(7) << r.code_phase_error_chips
+                          << " chips  Doppler " << std::setprecision(1) << std::setw(8) << r.doppler_hz << " Hz (err "
+                          << r.doppler_error_hz << ")  C/N0 " << r.cn0_dbhz << " dB-Hz";
+                if (!std::isnan(r.cn0_error_db)) std::cout << " (err " << r.cn0_error_db << ")";
+                std::cout << std::endl;
+            }
+        }
+
+        std::cout << passed << "/" << checked << " acquisitions match the scenario truth, "
+                  << engine.get_fft_count() << " FFTs in " << std::setprecision(2) << elapsed << " s" << std::endl;
+        return passed == checked ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,498 @@
+#include "../include/async_file_sink.h"
+#include "../include/trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr size_t BLOCK_BYTES = 4096;         // O_DIRECT alignment for buffers, offsets and lengths
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t round_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+struct WriteCompletion {
+    uint32_t index;
+    int64_t result;                          // Bytes written or -errno
+};
+
+// Backend that executes buffer writes asynchronously
+class FileWriteEngine {
+public:
+    virtual ~FileWriteEngine() = default;
+    virtual void submit(uint32_t index, const char* data, size_t length, uint64_t offset) = 0;
+    virtual void reap(std::vector<WriteCompletion>& completions, bool wait) = 0;
+    virtual FileSinkBackend kind() const = 0;
+    virtual bool registered_buffers() const { return false; }
+};
+
+namespace {
+
+// io_uring through the raw system calls (no liburing dependency)
+class UringWriteEngine : public FileWriteEngine {
+public:
+    UringWriteEngine(int fd, const std::vector<iovec>& buffers)
+        : fd_(fd), ring_fd_(-1), sq_ring_(nullptr), cq_ring_(nullptr), sqes_(nullptr)
+        , sq_ring_bytes_(0), cq_ring_bytes_(0), sqe_bytes_(0), registered_(false) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(buffers.size()), &params));
+        if (ring_fd_ < 0) {
+            throw QuadGNSSException(std::string("io_uring_setup failed: ") + std::strerror(errno));
+        }
+
+        sq_ring_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_bytes_ = cq_ring_bytes_ = std::max(sq_ring_bytes_, cq_ring_bytes_);
+        }
+
+        sq_ring_ = mmap(nullptr, sq_ring_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_
+                               : mmap(nullptr, cq_ring_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                      ring_fd_, IORING_OFF_CQ_RING);
+        sqe_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqe_bytes_, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+        if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+            std::string reason = std::strerror(errno);
+            if (sq_ring_ == MAP_FAILED) sq_ring_ = nullptr;
+            if (cq_ring_ == MAP_FAILED) cq_ring_ = nullptr;
+            if (sqes_ == MAP_FAILED) sqes_ = nullptr;
+            release();
+            throw QuadGNSSException("Cannot map io_uring rings: " + reason);
+        }
+
+        char* sq = static_cast<char*>(sq_ring_);
+        char* cq = static_cast<char*>(cq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // Pinning the buffers once saves the per-write page lookup; it needs
+        // RLIMIT_MEMLOCK headroom, so plain IORING_OP_WRITE is the fallback.
+        registered_ = syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+                              buffers.data(), static_cast<unsigned>(buffers.size())) == 0;
+    }
+
+    ~UringWriteEngine() override {
+        release();
+    }
+
+    void submit(uint32_t index, const char* data, size_t length, uint64_t offset) override {
+        QGNSS_TRACE_SCOPE_ARG("output", "io_uring submit", "bytes", length);
+        // The sink never has more writes in flight than there are SQ entries
+        unsigned tail = *sq_tail_;
+        unsigned slot = tail & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[slot];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = registered_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(data);
+        sqe->len = static_cast<uint32_t>(length);
+        sqe->off = offset;
+        sqe->buf_index = static_cast<uint16_t>(registered_ ? index : 0);
+        sqe->user_data = index;
+        sq_array_[slot] = slot;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+        while (syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0) < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                throw QuadGNSSException(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+        }
+    }
+
+    void reap(std::vector<WriteCompletion>& completions, bool wait) override {
+        for (;;) {
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            while (head != tail) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                completions.push_back(WriteCompletion{static_cast<uint32_t>(cqe.user_data), cqe.res});
+                head++;
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            if (!completions.empty() || !wait) {
+                return;
+            }
+            if (syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR) {
+                throw QuadGNSSException(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+        }
+    }
+
+    FileSinkBackend kind() const override { return FileSinkBackend::IO_URING; }
+    bool registered_buffers() const override { return registered_; }
+
+private:
+    int fd_;
+    int ring_fd_;
+    void* sq_ring_;
+    void* cq_ring_;
+    io_uring_sqe* sqes_;
+    size_t sq_ring_bytes_;
+    size_t cq_ring_bytes_;
+    size_t sqe_bytes_;
+    bool registered_;
+
+    unsigned* sq_tail_;
+    unsigned sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+
+    void release() {
+        if (sqes_) munmap(sqes_, sqe_bytes_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_bytes_);
+        if (sq_ring_) munmap(sq_ring_, sq_ring_bytes_);
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+        sqes_ = nullptr;
+        sq_ring_ = cq_ring_ = nullptr;
+        ring_fd_ = -1;
+    }
+};
+
+// Portable fallback: blocking pwrite() on a small pool of writer threads
+class ThreadPoolWriteEngine : public FileWriteEngine {
+public:
+    ThreadPoolWriteEngine(int fd, uint32_t thread_count) : fd_(fd), stopping_(false) {
+        for (uint32_t i = 0; i < std::max<uint32_t>(1, thread_count); ++i) {
+            workers_.emplace_back(&ThreadPoolWriteEngine::worker_loop, this);
+        }
+    }
+
+    ~ThreadPoolWriteEngine() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        job_ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void submit(uint32_t index, const char* data, size_t length, uint64_t offset) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(Job{index, data, length, offset});
+        }
+        job_ready_.notify_one();
+    }
+
+    void reap(std::vector<WriteCompletion>& completions, bool wait) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wait) {
+            job_done_.wait(lock, [this]() { return !completed_.empty(); });
+        }
+        completions.insert(completions.end(), completed_.begin(), completed_.end());
+        completed_.clear();
+    }
+
+    FileSinkBackend kind() const override { return FileSinkBackend::THREAD_POOL; }
+
+private:
+    struct Job {
+        uint32_t index;
+        const char* data;
+        size_t length;
+        uint64_t offset;
+    };
+
+    int fd_;
+    bool stopping_;
+    std::mutex mutex_;
+    std::condition_variable job_ready_;
+    std::condition_variable job_done_;
+    std::deque<Job> jobs_;
+    std::vector<WriteCompletion> completed_;
+    std::vector<std::thread> workers_;
+
+    void worker_loop() {
+        QGNSS_TRACE_THREAD_NAME("file writer");
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                job_ready_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty()) {
+                    return;
+                }
+                job = jobs_.front();
+                jobs_.pop_front();
+            }
+
+            QGNSS_TRACE_SCOPE_ARG("output", "pwrite", "bytes", job.length);
+            int64_t result = 0;
+            while (static_cast<size_t>(result) < job.length) {
+                ssize_t n = pwrite(fd_, job.data + result, job.length - result,
+                                   static_cast<off_t>(job.offset + result));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) {
+                    result = n < 0 ? -errno : -EIO;
+                    break;
+                }
+                result += n;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                completed_.push_back(WriteCompletion{job.index, result});
+            }
+            job_done_.notify_one();
+        }
+    }
+};
+
+} // namespace
+
+AsyncFileSink::AsyncFileSink(const std::string& path, const FileSinkOptions& options)
+    : path_(path), options_(options), fd_(-1), current_(-1), current_fill_(0), file_offset_(0)
+    , in_flight_sum_(0.0), start_ns_(now_ns()) {
+    if (options.buffer_bytes == 0 || options.buffer_bytes % BLOCK_BYTES != 0 ||
+        options.buffer_bytes > (1u << 30)) {
+        throw QuadGNSSException("File sink buffer size must be a non-zero multiple of 4096 bytes up to 1 GiB");
+    }
+    if (options.queue_depth == 0 || options.queue_depth > 1024) {
+        throw QuadGNSSException("File sink queue depth must be between 1 and 1024");
+    }
+
+    std::memset(&stats_, 0, sizeof(stats_));
+
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    bool direct = options.direct_io;
+    fd_ = ::open(path.c_str(), flags | (direct ? O_DIRECT : 0), 0644);
+    if (fd_ < 0 && direct && errno == EINVAL) {
+        direct = false;  // tmpfs and some network filesystems refuse O_DIRECT
+        fd_ = ::open(path.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+        throw QuadGNSSException("Cannot open output file " + path + ": " + std::strerror(errno));
+    }
+    stats_.direct_io = direct;
+
+    std::vector<iovec> iovecs;
+    for (uint32_t i = 0; i < options.queue_depth; ++i) {
+        std::unique_ptr<char, AlignedFree> data(static_cast<char*>(std::aligned_alloc(BLOCK_BYTES, options.buffer_bytes)));
+        if (!data) {
+            close();
+            throw QuadGNSSException("Cannot allocate file sink buffers");
+        }
+        std::memset(data.get(), 0, options.buffer_bytes);  // Fault the pages in before recording starts
+        iovecs.push_back(iovec{data.get(), options.buffer_bytes});
+        buffers_.push_back(Buffer{std::move(data), 0, 0, 0});
+        free_buffers_.push_back(options.queue_depth - 1 - i);
+    }
+
+    if (options.backend != FileSinkBackend::THREAD_POOL) {
+        try {
+            engine_ = std::make_unique<UringWriteEngine>(fd_, iovecs);
+        } catch (const QuadGNSSException&) {
+            if (options.backend == FileSinkBackend::IO_URING) {
+                close();
+                throw;
+            }
+        }
+    }
+    if (!engine_) {
+        engine_ = std::make_unique<ThreadPoolWriteEngine>(fd_, options.writer_threads);
+    }
+    stats_.backend = engine_->kind();
+    stats_.registered_buffers = engine_->registered_buffers();
+}
+
+AsyncFileSink::~AsyncFileSink() {
+    try {
+        close();
+    } catch (const std::exception&) {
+        // Errors are only reported through an explicit close()
+    }
+}
+
+const char* AsyncFileSink::backend_name(FileSinkBackend backend) {
+    switch (backend) {
+        case FileSinkBackend::IO_URING: return "io_uring";
+        case FileSinkBackend::THREAD_POOL: return "thread-pool";
+        default: return "auto";
+    }
+}
+
+void AsyncFileSink::write(const void* data, size_t bytes) {
+    check_error();
+    if (fd_ < 0) {
+        throw QuadGNSSException("Write to closed file sink " + path_);
+    }
+
+    const char* input = static_cast<const char*>(data);
+    stats_.bytes_accepted += bytes;
+    while (bytes > 0) {
+        if (current_ < 0) {
+            current_ = static_cast<int>(acquire_buffer());
+            current_fill_ = 0;
+        }
+        size_t count = std::min(bytes, options_.buffer_bytes - current_fill_);
+        std::memcpy(buffers_[current_].data.get() + current_fill_, input, count);
+        current_fill_ += count;
+        input += count;
+        bytes -= count;
+
+        if (current_fill_ == options_.buffer_bytes) {
+            submit_buffer(static_cast<uint32_t>(current_), current_fill_);
+            current_ = -1;
+        }
+    }
+}
+
+uint32_t AsyncFileSink::acquire_buffer() {
+    if (free_buffers_.empty()) {
+        stats_.producer_stalls++;
+        while (free_buffers_.empty()) {
+            reap(true);
+            check_error();
+        }
+    }
+    uint32_t index = free_buffers_.back();
+    free_buffers_.pop_back();
+    return index;
+}
+
+void AsyncFileSink::submit_buffer(uint32_t index, size_t length) {
+    Buffer& buffer = buffers_[index];
+    buffer.length = length;
+    buffer.done = 0;
+    buffer.file_offset = file_offset_;
+    file_offset_ += length;
+
+    engine_->submit(index, buffer.data.get(), length, buffer.file_offset);
+    stats_.writes_submitted++;
+    stats_.in_flight++;
+    stats_.max_in_flight = std::max(stats_.max_in_flight, stats_.in_flight);
+    in_flight_sum_ += stats_.in_flight;
+
+    reap(false);
+}
+
+void AsyncFileSink::reap(bool wait) {
+    std::vector<WriteCompletion> completions;
+    engine_->reap(completions, wait);
+
+    for (const WriteCompletion& completion : completions) {
+        Buffer& buffer = buffers_[completion.index];
+        if (completion.result <= 0) {
+            if (error_.empty()) {
+                error_ = "Write to " + path_ + " failed: " +
+                         (completion.result < 0 ? std::strerror(static_cast<int>(-completion.result))
+                                                : "no progress");
+            }
+        } else {
+            buffer.done += static_cast<size_t>(completion.result);
+            stats_.bytes_written += static_cast<uint64_t>(completion.result);
+            if (buffer.done < buffer.length) {
+                // Short write: resubmit the remainder of the same buffer
+                engine_->submit(completion.index, buffer.data.get() + buffer.done, buffer.length - buffer.done,
+                                buffer.file_offset + buffer.done);
+                continue;
+            }
+        }
+        stats_.writes_completed++;
+        stats_.in_flight--;
+        free_buffers_.push_back(completion.index);
+    }
+}
+
+void AsyncFileSink::drain() {
+    while (stats_.in_flight > 0) {
+        reap(true);
+    }
+    check_error();
+}
+
+void AsyncFileSink::close() {
+    if (fd_ < 0) {
+        return;
+    }
+
+    if (engine_) {
+        size_t padding = 0;
+        if (current_ >= 0 && current_fill_ > 0) {
+            size_t length = current_fill_;
+            if (stats_.direct_io) {
+                length = round_up(current_fill_, BLOCK_BYTES);
+                padding = length - current_fill_;
+                std::memset(buffers_[current_].data.get() + current_fill_, 0, padding);
+            }
+            submit_buffer(static_cast<uint32_t>(current_), length);
+        } else if (current_ >= 0) {
+            free_buffers_.push_back(static_cast<uint32_t>(current_));
+        }
+        current_ = -1;
+
+        while (stats_.in_flight > 0) {
+            reap(true);
+        }
+        engine_.reset();
+
+        if (padding > 0 && error_.empty() &&
+            ftruncate(fd_, static_cast<off_t>(stats_.bytes_accepted)) != 0) {
+            error_ = "Cannot trim O_DIRECT padding from " + path_ + ": " + std::strerror(errno);
+        }
+    }
+
+    stats_.elapsed_s = (now_ns() - start_ns_) * 1e-9;
+    if (::close(fd_) != 0 && error_.empty()) {
+        error_ = "Cannot close " + path_ + ": " + std::strerror(errno);
+    }
+    fd_ = -1;
+    check_error();
+}
+
+FileSinkStats AsyncFileSink::get_stats() const {
+    FileSinkStats stats = stats_;
+    if (fd_ >= 0) {
+        stats.elapsed_s = (now_ns() - start_ns_) * 1e-9;
+    }
+    stats.mean_in_flight = stats.writes_submitted ? in_flight_sum_ / stats.writes_submitted : 0.0;
+    stats.bandwidth_mb_s = stats.elapsed_s > 0.0 ? stats.bytes_written / stats.elapsed_s / 1e6 : 0.0;
+    return stats;
+}
+
+void AsyncFileSink::check_error() const {
+    if (!error_.empty()) {
+        throw QuadGNSSException(error_);
+    }
+}
+
+} // namespace QuadGNSS
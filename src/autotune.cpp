@@ -0,0 +1,293 @@
+#include "../include/autotune.h"
+#include "../include/batch_runner.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace QuadGNSS {
+
+namespace {
+
+const char* const CACHE_HEADER = "# QuadGNSS tuning v1";
+constexpr double TUNING_START_TIME = 345600.0;       // Any GPS time; throughput does not depend on it
+constexpr double DEFAULT_CHUNK_DURATION_S = 0.01;
+
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+bool whole_samples(double sampling_rate_hz, double duration_s) {
+    double samples = sampling_rate_hz * duration_s;
+    return samples >= 1.0 && std::abs(samples - std::round(samples)) < 1e-6;
+}
+
+std::unique_ptr<MultiBandGenerator> build_generator(const TuningWorkload& workload, int render_tile,
+                                                    const std::shared_ptr<BandCodeCache>& codes) {
+    GlobalConfig config;
+    config.sampling_rate_hz = workload.sampling_rate_hz;
+    auto generator = std::make_unique<MultiBandGenerator>(config, codes);
+    for (const auto& sat : workload.satellites) {
+        generator->backbone().add_satellite(sat.constellation, sat.prn, -130.0, sat.frequency_channel);
+    }
+    for (const auto& band : workload.bands) {
+        generator->add_band(band);
+    }
+    generator->set_render_tile(render_tile);
+    return generator;
+}
+
+} // namespace
+
+std::string TuningWorkload::key() const {
+    std::ostringstream key;
+    key << std::llround(sampling_rate_hz) << " Hz |";
+    for (size_t i = 0; i < bands.size(); ++i) {
+        key << (i ? " + " : " ") << get_band_info(bands[i].band).name;
+    }
+    key << " | " << satellites.size() << " satellites";
+    return key.str();
+}
+
+TuningWorkload workload_for_plan(const ExecutionPlan& plan) {
+    TuningWorkload workload;
+    workload.sampling_rate_hz = plan.get_config().sampling_rate_hz;
+    workload.bands = bands_for_plan(plan);
+    for (const auto& sat : plan.get_satellites()) {
+        workload.satellites.push_back(StreamSatellite{sat.constellation, sat.prn, sat.glonass_channel});
+    }
+    return workload;
+}
+
+// Autotuner
+
+Autotuner::Autotuner(const AutotuneSettings& settings, std::shared_ptr<BandCodeCache> codes)
+    : settings_(settings), codes_(codes ? std::move(codes) : std::make_shared<BandCodeCache>()) {
+    settings_.repeats = std::max(1, settings_.repeats);
+}
+
+double Autotuner::measure(const TuningWorkload& workload, const TuningConfig& config) {
+    const double fs = workload.sampling_rate_hz;
+    const int chunk_samples = static_cast<int>(std::llround(fs * config.chunk_duration_s));
+    const size_t lanes = std::max<size_t>(1, config.threads);
+    const uint64_t chunks = std::max<uint64_t>(
+        lanes, static_cast<uint64_t>(std::ceil(settings_.span_s / config.chunk_duration_s - 1e-9)));
+
+    // Generators are built here so configuration errors surface on the caller's thread
+    std::vector<std::unique_ptr<MultiBandGenerator>> generators;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        generators.push_back(build_generator(workload, config.render_tile, codes_));
+    }
+
+    double best = 0.0;
+    for (int repeat = 0; repeat < settings_.repeats; ++repeat) {
+        std::atomic<uint64_t> next_chunk{0};
+        std::atomic<size_t> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            threads.emplace_back([&, lane] {
+                MultiBandGenerator& generator = *generators[lane];
+                std::vector<std::vector<std::complex<int16_t>>> band_buffers(
+                    workload.bands.size(), std::vector<std::complex<int16_t>>(chunk_samples));
+                std::vector<std::complex<int16_t>*> buffers;
+                for (auto& buffer : band_buffers) buffers.push_back(buffer.data());
+
+                // Untimed warm-up: code tables, carrier table and buffers are touched on this thread
+                generator.generate_chunk(buffers.data(), chunk_samples, TUNING_START_TIME);
+                ready.fetch_add(1);
+                while (!go.load()) std::this_thread::yield();
+
+                uint64_t chunk;
+                while ((chunk = next_chunk.fetch_add(1)) < chunks) {
+                    generator.generate_chunk(buffers.data(), chunk_samples,
+                                             TUNING_START_TIME + static_cast<double>(chunk) * config.chunk_duration_s);
+                }
+            });
+        }
+        while (ready.load() < lanes) std::this_thread::yield();
+        auto start = std::chrono::steady_clock::now();
+        go.store(true);
+        for (auto& thread : threads) thread.join();
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (wall > 0.0) {
+            best = std::max(best, static_cast<double>(chunks) * chunk_samples / wall / 1e6);
+        }
+    }
+    return best;
+}
+
+TuningConfig Autotuner::tune(const TuningWorkload& workload) {
+    if (workload.bands.empty()) {
+        throw QuadGNSSException("Nothing to tune: the workload has no bands");
+    }
+    std::vector<double> chunk_durations;
+    for (double duration : settings_.chunk_durations_s) {
+        if (whole_samples(workload.sampling_rate_hz, duration)) chunk_durations.push_back(duration);
+    }
+    if (chunk_durations.empty()) {
+        throw QuadGNSSException("No candidate chunk duration holds a whole number of samples");
+    }
+    std::vector<size_t> thread_counts = settings_.threads;
+    if (thread_counts.empty()) {
+        size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t n = 1; n < hardware; n *= 2) thread_counts.push_back(n);
+        thread_counts.push_back(hardware);
+    }
+
+    // Start from the built-in defaults, then one axis at a time
+    TuningConfig best;
+    if (std::find(chunk_durations.begin(), chunk_durations.end(), DEFAULT_CHUNK_DURATION_S) == chunk_durations.end()) {
+        best.chunk_duration_s = chunk_durations.front();
+    }
+    measurements_.clear();
+    best.msps = measure(workload, best);
+    measurements_.push_back(best);
+
+    auto consider = [&](TuningConfig candidate) {
+        candidate.msps = measure(workload, candidate);
+        measurements_.push_back(candidate);
+        if (candidate.msps > best.msps * (1.0 + settings_.min_gain)) {
+            best = candidate;
+        }
+    };
+    const TuningConfig start = best;
+    for (int tile : settings_.render_tiles) {
+        if (tile == start.render_tile || tile < 0) continue;
+        TuningConfig candidate = best;
+        candidate.render_tile = tile;
+        consider(candidate);
+    }
+    const double tuned_chunk = best.chunk_duration_s;
+    for (double duration : chunk_durations) {
+        if (duration == tuned_chunk) continue;
+        TuningConfig candidate = best;
+        candidate.chunk_duration_s = duration;
+        consider(candidate);
+    }
+    const size_t tuned_threads = best.threads;
+    for (size_t threads : thread_counts) {
+        if (threads == tuned_threads || threads == 0) continue;
+        TuningConfig candidate = best;
+        candidate.threads = threads;
+        consider(candidate);
+    }
+    return best;
+}
+
+// TuningCache
+
+TuningCache::TuningCache(const std::string& path) : path_(path) {
+    std::ifstream in(path);
+    if (!in) {
+        return;
+    }
+    std::string line;
+    std::getline(in, line);
+    if (trim(line) != CACHE_HEADER) {
+        throw QuadGNSSException("Malformed tuning cache: " + path);
+    }
+    int line_number = 1;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (trim(line).empty()) continue;
+
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) fields.push_back(field);
+
+        TuningConfig config;
+        char* end[4] = {nullptr, nullptr, nullptr, nullptr};
+        bool ok = fields.size() == 6;
+        if (ok) {
+            config.chunk_duration_s = std::strtod(fields[2].c_str(), &end[0]);
+            config.render_tile = static_cast<int>(std::strtol(fields[3].c_str(), &end[1], 10));
+            config.threads = static_cast<size_t>(std::strtoul(fields[4].c_str(), &end[2], 10));
+            config.msps = std::strtod(fields[5].c_str(), &end[3]);
+            for (int i = 0; i < 4; ++i) ok = ok && end[i] != fields[i + 2].c_str() && trim(end[i]).empty();
+            ok = ok && config.chunk_duration_s > 0.0 && config.render_tile >= 0 && config.threads > 0;
+        }
+        if (!ok) {
+            throw QuadGNSSException("Malformed tuning cache: " + path + " (line " + std::to_string(line_number) + ")");
+        }
+        entries_[{fields[0], fields[1]}] = config;
+    }
+}
+
+bool TuningCache::lookup(const std::string& cpu_model, const std::string& workload_key, TuningConfig& config) const {
+    auto it = entries_.find({cpu_model, workload_key});
+    if (it == entries_.end()) {
+        return false;
+    }
+    config = it->second;
+    return true;
+}
+
+void TuningCache::store(const std::string& cpu_model, const std::string& workload_key, const TuningConfig& config) {
+    entries_[{cpu_model, workload_key}] = config;
+}
+
+void TuningCache::save() const {
+    const std::string temporary = path_ + ".tmp";
+    {
+        std::ofstream out(temporary);
+        if (!out) {
+            throw QuadGNSSException("Cannot write tuning cache: " + path_);
+        }
+        out << CACHE_HEADER << "\n" << std::setprecision(10);
+        for (const auto& entry : entries_) {
+            const TuningConfig& config = entry.second;
+            out << entry.first.first << "\t" << entry.first.second << "\t" << config.chunk_duration_s << "\t"
+                << config.render_tile << "\t" << config.threads << "\t" << config.msps << "\n";
+        }
+        if (!out.flush()) {
+            throw QuadGNSSException("Cannot write tuning cache: " + path_);
+        }
+    }
+    if (std::rename(temporary.c_str(), path_.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw QuadGNSSException("Cannot write tuning cache: " + path_);
+    }
+}
+
+std::string host_cpu_model() {
+    std::string model;
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (model.empty() && std::getline(cpuinfo, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = trim(line.substr(0, colon));
+        if (key == "model name" || key == "Hardware" || key == "cpu model" || key == "Processor") {
+            model = trim(line.substr(colon + 1));
+        }
+    }
+    std::replace(model.begin(), model.end(), '\t', ' ');
+    if (model.empty()) {
+        model = "unknown CPU";
+    }
+    return model + " (" + std::to_string(std::max(1u, std::thread::hardware_concurrency())) + " threads)";
+}
+
+std::string default_tuning_cache_path() {
+    const char* path = std::getenv("QUADGNSS_TUNING_CACHE");
+    if (path && *path) {
+        return path;
+    }
+    const char* home = std::getenv("HOME");
+    if (home && *home) {
+        return std::string(home) + "/.quadgnss_tuning";
+    }
+    return "quadgnss_tuning";
+}
+
+} // namespace QuadGNSS
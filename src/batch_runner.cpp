@@ -0,0 +1,409 @@
+#include "../include/batch_runner.h"
+#include "../include/trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 1469598103934665603ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t fnv1a(const void* data, size_t bytes, uint64_t hash = FNV_OFFSET) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash = (hash ^ p[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+} // namespace
+
+std::vector<BandStreamConfig> bands_for_plan(const ExecutionPlan& plan) {
+    std::vector<BandStreamConfig> bands;
+    for (SignalBand band : plan.get_bands()) {
+        bands.push_back(BandStreamConfig{band, plan.get_config().center_frequency_hz});
+    }
+    return bands;
+}
+
+void require_no_pipeline(const ExecutionPlan& plan, const std::string& consumer) {
+    if (!plan.get_pipeline().empty()) {
+        throw QuadGNSSException(consumer + " renders chunks independently and cannot run the scenario pipeline "
+                                "(only quad_gnss_sim does)");
+    }
+}
+
+// PlanRenderer
+
+PlanRenderer::PlanRenderer(std::shared_ptr<const ExecutionPlan> plan, std::shared_ptr<BandCodeCache> codes,
+                           int render_tile)
+    : plan_(std::move(plan)), generator_(plan_->get_config(), std::move(codes)) {
+    const ExecutionPlan& p = *plan_;
+    for (const auto& sat : p.get_satellites()) {
+        generator_.backbone().add_satellite(sat.constellation, sat.prn, sat.power_dbm, sat.glonass_channel);
+    }
+    for (const auto& entry : p.get_ephemeris()) {
+        generator_.backbone().set_ephemeris(entry.first, *entry.second);
+    }
+    for (const auto& band : bands_for_plan(p)) {
+        generator_.add_band(band);
+    }
+    generator_.set_render_tile(render_tile);
+    // Receiver follows the plan (or a commanded position) on the generator's epoch grid, not per chunk
+    const double start_time = p.get_config().simulation.start_time_gps;
+    generator_.set_receiver_trajectory([this, start_time](double time, double& x, double& y, double& z) {
+        if (receiver_fixed_) {
+            x = receiver_[0];
+            y = receiver_[1];
+            z = receiver_[2];
+        } else {
+            plan_->receiver_position(time - start_time, x, y, z);
+        }
+    });
+
+    // A single band renders straight into the output; several are summed from their own buffers
+    const size_t band_count = generator_.get_bands().size();
+    if (band_count > 1) {
+        band_buffers_.assign(band_count, std::vector<std::complex<int16_t>>(p.get_chunk_samples()));
+        for (auto& buffer : band_buffers_) buffers_.push_back(buffer.data());
+    }
+}
+
+void PlanRenderer::render(uint64_t chunk, std::complex<int16_t>* output) {
+    const ExecutionPlan& p = *plan_;
+    const int sample_count = p.get_chunk_samples();
+    const double time = p.get_config().simulation.start_time_gps + static_cast<double>(chunk) * p.get_chunk_duration();
+    if (band_buffers_.empty()) {
+        generator_.generate_chunk(&output, sample_count, time);
+        return;
+    }
+
+    generator_.generate_chunk(buffers_.data(), sample_count, time);
+    // Bands share the scenario centre frequency: sum into one stream
+    QGNSS_TRACE_SCOPE("mix", "bands");
+    for (int i = 0; i < sample_count; ++i) {
+        int32_t re = 0, im = 0;
+        for (const auto& buffer : band_buffers_) {
+            re += buffer[i].real();
+            im += buffer[i].imag();
+        }
+        output[i] = std::complex<int16_t>(static_cast<int16_t>(std::max(-32768, std::min(32767, re))),
+                                          static_cast<int16_t>(std::max(-32768, std::min(32767, im))));
+    }
+}
+
+bool PlanRenderer::apply_command(const ControlCommand& command) {
+    if (command.type == ControlCommandType::SET_RECEIVER_POSITION) {
+        receiver_fixed_ = true;
+        std::copy(command.value, command.value + 3, receiver_);
+        return true;
+    }
+    for (auto& sat : generator_.backbone().satellites()) {
+        if (sat.constellation != command.constellation || sat.prn != command.prn) continue;
+        switch (command.type) {
+            case ControlCommandType::SET_POWER:
+                sat.power_dbm = command.value[0];
+                break;
+            case ControlCommandType::ENABLE_SATELLITE:
+                sat.is_active = true;
+                break;
+            case ControlCommandType::DISABLE_SATELLITE:
+                sat.is_active = false;
+                break;
+            case ControlCommandType::SET_RECEIVER_POSITION:
+                break;
+        }
+        return true;
+    }
+    return false;
+}
+
+// BatchRunner
+
+struct BatchRunner::Job {
+    std::string name;
+    std::shared_ptr<const ExecutionPlan> plan;
+    std::vector<BandStreamConfig> bands;
+    std::vector<int> fds;
+    BatchJobResult result;
+
+    size_t cores = 1;
+    int render_tile = 0;
+    bool started = false;
+    size_t lanes_started = 0;
+    size_t lanes_active = 0;
+    std::atomic<uint64_t> next_chunk{0};
+    std::vector<uint64_t> chunk_hashes;
+    std::string error;                         // Guarded by the runner mutex
+    std::chrono::steady_clock::time_point start_time;
+    std::chrono::steady_clock::time_point end_time;
+};
+
+BatchRunner::BatchRunner(size_t core_budget)
+    : core_budget_(core_budget ? core_budget : std::max(1u, std::thread::hardware_concurrency()))
+    , codes_(std::make_shared<BandCodeCache>())
+    , stats_{}, numa_nodes_(1), pinned_workers_(0)
+    , next_queued_(0), cores_in_use_(0), jobs_outstanding_(0), stopping_(false) {
+    for (size_t i = 0; i < core_budget_; ++i) {
+        workers_.emplace_back(&BatchRunner::worker_loop, this);
+    }
+    // Single-node hosts keep the scheduler's placement
+    CpuTopology topology = CpuTopology::detect();
+    if (topology.node_count() > 1) {
+        set_topology(topology);
+    }
+}
+
+BatchRunner::~BatchRunner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t BatchRunner::set_topology(const CpuTopology& topology) {
+    std::vector<int> cpus = topology.placement(workers_.size());
+    pinned_workers_ = 0;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        pinned_workers_ += pin_thread(workers_[i], cpus[i]) ? 1 : 0;
+    }
+    numa_nodes_ = topology.node_count();
+    return pinned_workers_;
+}
+
+void BatchRunner::add_scenario(const std::string& json_text, const std::string& name, const std::string& base_dir) {
+    auto job = std::make_unique<Job>();
+    job->name = name;
+    try {
+        job->plan = ScenarioCompiler::compile(json_text, base_dir, &ephemeris_);
+        if (job->name.empty()) job->name = job->plan->get_name();
+        require_no_pipeline(*job->plan, "a batch job");
+        job->bands = bands_for_plan(*job->plan);
+    } catch (const std::exception& e) {
+        job->error = e.what();
+        job->plan.reset();
+    }
+    if (job->name.empty()) job->name = "job " + std::to_string(pending_.size() + 1);
+    pending_.push_back(std::move(job));
+}
+
+void BatchRunner::add_scenario_file(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        auto job = std::make_unique<Job>();
+        job->name = path;
+        job->error = "Cannot open scenario file: " + path;
+        pending_.push_back(std::move(job));
+        return;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    size_t slash = path.find_last_of('/');
+    add_scenario(text.str(), "", slash == std::string::npos ? "" : path.substr(0, slash));
+    if (!pending_.back()->plan) pending_.back()->name = path;
+}
+
+std::vector<BatchJobResult> BatchRunner::run() {
+    auto run_start = std::chrono::steady_clock::now();
+    std::vector<Job*> runnable;
+    const std::string cpu_model = tuning_ ? host_cpu_model() : "";
+
+    for (auto& job : pending_) {
+        job->result = BatchJobResult{job->name, false, job->error, 0, {}, 0, 0, 0.0, 0.0, 0.0, 0, false};
+        if (!job->plan) continue;
+
+        const ExecutionPlan& plan = *job->plan;
+        job->cores = std::min(core_budget_, std::max<size_t>(1, plan.get_thread_layout().requested_threads));
+        TuningConfig tuned;
+        if (tuning_ && tuning_->lookup(cpu_model, workload_for_plan(plan).key(), tuned)) {
+            job->cores = std::min(job->cores, tuned.threads);
+            job->render_tile = tuned.render_tile;
+            job->result.tuned = true;
+        }
+        job->chunk_hashes.assign(plan.get_total_chunks(), 0);
+        for (const auto& band : job->bands) {
+            job->result.bands.push_back(get_band_info(band.band).name);
+        }
+
+        // File sinks are preallocated; chunks land at their final offsets from any lane
+        bool opened = true;
+        for (const auto& sink : plan.get_sinks()) {
+            if (sink.type != ScenarioSinkType::FILE) continue;
+            int fd = ::open(sink.target.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(plan.get_total_chunks() * plan.get_chunk_bytes())) != 0) {
+                job->error = "Cannot create " + sink.target + ": " + std::strerror(errno);
+                if (fd >= 0) ::close(fd);
+                opened = false;
+                break;
+            }
+            job->fds.push_back(fd);
+        }
+        if (!opened) {
+            for (int fd : job->fds) ::close(fd);
+            job->fds.clear();
+            job->result.error = job->error;
+            continue;
+        }
+        runnable.push_back(job.get());
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queue_ = runnable;
+        next_queued_ = 0;
+        jobs_outstanding_ = runnable.size();
+        work_cv_.notify_all();
+        done_cv_.wait(lock, [this] { return jobs_outstanding_ == 0; });
+        queue_.clear();
+    }
+
+    std::vector<BatchJobResult> results;
+    uint64_t total_samples = 0;
+    stats_ = BatchStats{};
+    for (auto& job : pending_) {
+        results.push_back(job->result);
+        total_samples += job->result.ok ? job->result.samples : 0;
+        stats_.failed += job->result.ok ? 0 : 1;
+    }
+    stats_.jobs = pending_.size();
+    stats_.core_budget = core_budget_;
+    stats_.worker_threads = workers_.size();
+    stats_.ephemeris_parses = ephemeris_.get_parse_count();
+    stats_.code_tables = codes_->size();
+    stats_.numa_nodes = numa_nodes_;
+    stats_.pinned_workers = pinned_workers_;
+    stats_.wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+    stats_.aggregate_msps = stats_.wall_s > 0.0 ? total_samples / stats_.wall_s / 1e6 : 0.0;
+    pending_.clear();
+    return results;
+}
+
+BatchRunner::Job* BatchRunner::claim_lane_locked() {
+    // Another lane for a running job that still has chunks left
+    for (size_t i = 0; i < next_queued_; ++i) {
+        Job* job = queue_[i];
+        if (job->started && job->lanes_started < job->cores &&
+            job->next_chunk.load() < job->plan->get_total_chunks()) {
+            job->lanes_started++;
+            job->lanes_active++;
+            return job;
+        }
+    }
+
+    // Start the first waiting job that fits the free cores
+    for (size_t i = 0; i < queue_.size(); ++i) {
+        Job* job = queue_[i];
+        if (job->started || job->cores > core_budget_ - cores_in_use_) continue;
+        job->started = true;
+        job->start_time = std::chrono::steady_clock::now();
+        job->lanes_started = 1;
+        job->lanes_active = 1;
+        cores_in_use_ += job->cores;
+        next_queued_ = std::max(next_queued_, i + 1);
+        return job;
+    }
+    return nullptr;
+}
+
+void BatchRunner::worker_loop() {
+    QGNSS_TRACE_THREAD_NAME("batch worker");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        Job* job = nullptr;
+        work_cv_.wait(lock, [&] { return stopping_ || (job = claim_lane_locked()) != nullptr; });
+        if (stopping_) return;
+
+        lock.unlock();
+        run_lane(*job);
+        lock.lock();
+
+        if (--job->lanes_active == 0 && job->next_chunk.load() >= job->plan->get_total_chunks()) {
+            finish_job_locked(*job);
+        }
+    }
+}
+
+void BatchRunner::run_lane(Job& job) {
+    const ExecutionPlan& plan = *job.plan;
+    const int sample_count = plan.get_chunk_samples();
+    const uint64_t total_chunks = plan.get_total_chunks();
+
+    try {
+        // Per-lane renderer and buffer, first touched on this worker's node; codes, carrier tables
+        // and ephemerides are shared
+        PlanRenderer renderer(job.plan, codes_, job.render_tile);
+        HugePageBuffer buffer(static_cast<size_t>(sample_count) * sizeof(std::complex<int16_t>));
+        std::complex<int16_t>* output = buffer.as<std::complex<int16_t>>();
+
+        while (true) {
+            uint64_t chunk = job.next_chunk.fetch_add(1);
+            if (chunk >= total_chunks) break;
+            QGNSS_TRACE_SCOPE_ARG("batch", "chunk", "chunk", chunk);
+            renderer.render(chunk, output);
+
+            size_t bytes = static_cast<size_t>(sample_count) * sizeof(std::complex<int16_t>);
+            job.chunk_hashes[chunk] = fnv1a(output, bytes);
+            for (int fd : job.fds) {
+                QGNSS_TRACE_SCOPE("output", "write");
+                const char* data = reinterpret_cast<const char*>(output);
+                size_t written = 0;
+                while (written < bytes) {
+                    ssize_t n = ::pwrite(fd, data + written, bytes - written,
+                                         static_cast<off_t>(chunk * bytes + written));
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n <= 0) {
+                        throw QuadGNSSException(std::string("Write failed: ") + std::strerror(errno));
+                    }
+                    written += static_cast<size_t>(n);
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (job.error.empty()) job.error = e.what();
+        job.next_chunk.store(total_chunks);    // Stop the other lanes
+    }
+}
+
+void BatchRunner::finish_job_locked(Job& job) {
+    const ExecutionPlan& plan = *job.plan;
+    job.end_time = std::chrono::steady_clock::now();
+    for (int fd : job.fds) ::close(fd);
+    job.fds.clear();
+
+    BatchJobResult& result = job.result;
+    result.ok = job.error.empty();
+    result.error = job.error;
+    result.cores = job.cores;
+    result.chunks = plan.get_total_chunks();
+    result.samples = result.chunks * static_cast<uint64_t>(plan.get_chunk_samples());
+    result.wall_s = std::chrono::duration<double>(job.end_time - job.start_time).count();
+    result.msps = result.wall_s > 0.0 ? result.samples / result.wall_s / 1e6 : 0.0;
+    result.realtime_factor = result.wall_s > 0.0 ? result.chunks * plan.get_chunk_duration() / result.wall_s : 0.0;
+    result.checksum = FNV_OFFSET;
+    for (uint64_t hash : job.chunk_hashes) {
+        result.checksum = fnv1a(&hash, sizeof(hash), result.checksum);
+    }
+
+    cores_in_use_ -= job.cores;
+    jobs_outstanding_--;
+    work_cv_.notify_all();                     // Freed cores may admit waiting jobs
+    if (jobs_outstanding_ == 0) {
+        done_cv_.notify_all();
+    }
+}
+
+} // namespace QuadGNSS
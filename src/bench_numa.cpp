@@ -0,0 +1,108 @@
+/**
+ * Cross-node traffic saved by pinned, first-touch chunk buffers
+ *
+ * Usage: bench_numa [threads] [MB per thread] [numa map]
+ *
+ * Each thread repeatedly writes and sums its own chunk buffer, as a batch
+ * lane does with the chunks it renders. Two layouts are compared:
+ *  - floating: buffers are std::vector allocated and zeroed by the main
+ *    thread, threads are left to the scheduler
+ *  - pinned: threads are pinned by CpuTopology::placement() and allocate
+ *    their HugePageBuffer themselves
+ * For each it reports GB/s and the fraction of buffer pages on the node
+ * of the thread using them; the remainder is traffic across sockets.
+ */
+
+#include "../include/numa_placement.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sched.h>
+
+using namespace QuadGNSS;
+
+static constexpr int PASSES = 20;
+
+// Write and read back one buffer; the sum keeps the reads alive
+static uint64_t sweep(uint64_t* __restrict data, size_t words, uint64_t seed) {
+    for (size_t i = 0; i < words; ++i) {
+        data[i] = seed + i;
+    }
+    uint64_t sum = 0;
+    for (size_t i = 0; i < words; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+struct LayoutResult {
+    double gb_per_s;
+    size_t pages;
+    size_t local_pages;
+};
+
+static LayoutResult run_layout(const CpuTopology& topology, size_t threads, size_t bytes, bool pinned) {
+    std::vector<std::vector<uint64_t>> shared;
+    if (!pinned) {
+        shared.assign(threads, std::vector<uint64_t>(bytes / sizeof(uint64_t)));
+    }
+    const std::vector<int> cpus = topology.placement(threads);
+    std::vector<size_t> pages(threads, 0), local(threads, 0);
+    std::vector<uint64_t> sums(threads, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::unique_ptr<HugePageBuffer> own;
+            uint64_t* data;
+            if (pinned) {
+                pin_current_thread(cpus[t]);
+                own.reset(new HugePageBuffer(bytes));
+                data = own->as<uint64_t>();
+            } else {
+                data = shared[t].data();
+            }
+            for (int pass = 0; pass < PASSES; ++pass) {
+                sums[t] += sweep(data, bytes / sizeof(uint64_t), pass);
+            }
+            // Where the pages are, seen from where this thread ran last
+            const int node = topology.node_of(sched_getcpu());
+            std::vector<int> nodes = page_nodes(data, bytes);
+            pages[t] = nodes.size();
+            local[t] = static_cast<size_t>(std::count(nodes.begin(), nodes.end(), node));
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    LayoutResult result{2.0 * PASSES * threads * bytes / seconds / 1e9, 0, 0};
+    for (size_t t = 0; t < threads; ++t) {
+        result.pages += pages[t];
+        result.local_pages += local[t];
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    CpuTopology topology = argc > 3 ? CpuTopology::parse(argv[3]) : CpuTopology::detect();
+    const size_t threads = argc > 1 ? std::max(1, std::atoi(argv[1])) : topology.cpu_count();
+    const size_t bytes = (argc > 2 ? std::max(1, std::atoi(argv[2])) : 64) * (size_t(1) << 20);
+
+    std::printf("%zu thread(s), %zu MB each, %zu node(s) [%s]\n", threads, bytes >> 20, topology.node_count(),
+                topology.describe().c_str());
+    const char* names[2] = {"floating", "pinned"};
+    for (int pinned = 0; pinned < 2; ++pinned) {
+        LayoutResult r = run_layout(topology, threads, bytes, pinned == 1);
+        std::printf("  %-8s %7.2f GB/s, %5.1f%% of pages local\n", names[pinned], r.gb_per_s,
+                    r.pages ? 100.0 * r.local_pages / r.pages : 0.0);
+    }
+    return 0;
+}
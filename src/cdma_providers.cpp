@@ -1,6 +1,7 @@
 #include "../include/quad_gnss_interface.h"
 #include "../include/rinex_parser.h"
 #include <cmath>
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
@@ -13,12 +14,13 @@
 namespace QuadGNSS {
 
 // Helper class for NCO (Numerically Controlled Oscillator)
+// A sample's phase follows from its absolute index, so mixing does not depend
+// on where the stream started or how it is cut into chunks.
 class DigitalNCO {
 private:
     double sample_rate_hz_;
     double frequency_hz_;
-    double phase_;
-    double phase_increment_;
+    double cycles_per_sample_;  // Fractional cycles per sample
     
     // Precomputed sine/cosine lookup table for efficiency
     static constexpr size_t LUT_SIZE = 16384;
@@ -28,8 +30,7 @@ public:
     DigitalNCO(double sample_rate_hz) 
         : sample_rate_hz_(sample_rate_hz)
         , frequency_hz_(0.0)
-        , phase_(0.0)
-        , phase_increment_(0.0)
+        , cycles_per_sample_(0.0)
         , lookup_table_(LUT_SIZE) {
         
         // Precompute sine/cosine lookup table
@@ -42,37 +43,35 @@ public:
         }
     }
     
-    void set_frequency(double frequency_hz) {
-        frequency_hz_ = frequency_hz;
-        phase_increment_ = 2.0 * M_PI * frequency_hz_ / sample_rate_hz_;
+    void set_sample_rate(double sample_rate_hz) {
+        sample_rate_hz_ = sample_rate_hz;
+        set_frequency(frequency_hz_);
     }
     
-    void reset_phase() {
-        phase_ = 0.0;
+    void set_frequency(double frequency_hz) {
+        frequency_hz_ = frequency_hz;
+        double cycles = frequency_hz_ / sample_rate_hz_;
+        cycles_per_sample_ = cycles - std::floor(cycles);
     }
     
-    // Generate complex carrier samples
-    void generate_samples(std::complex<float>* buffer, int count) {
+    // Generate complex carrier samples starting at an absolute sample index
+    void generate_samples(std::complex<float>* buffer, int count, int64_t first_sample) {
         for (int i = 0; i < count; ++i) {
-            // Convert phase to table index
-            size_t index = static_cast<size_t>(phase_ * LUT_SIZE / (2.0 * M_PI)) % LUT_SIZE;
+            // Whole cycles are dropped before converting the phase to a table index
+            double cycles = cycles_per_sample_ * static_cast<double>(first_sample + i);
+            cycles -= std::floor(cycles);
+            size_t index = static_cast<size_t>(cycles * LUT_SIZE) % LUT_SIZE;
             buffer[i] = lookup_table_[index];
-            
-            // Advance phase
-            phase_ += phase_increment_;
-            if (phase_ >= 2.0 * M_PI) {
-                phase_ -= 2.0 * M_PI;
-            }
         }
     }
     
     // Mix signal with carrier (complex multiplication)
     void mix_signal(const std::complex<int16_t>* input, 
                    std::complex<int16_t>* output, 
-                   int count) {
+                   int count, int64_t first_sample) {
         
         std::vector<std::complex<float>> carrier(count);
-        generate_samples(carrier.data(), count);
+        generate_samples(carrier.data(), count, first_sample);
         
         for (int i = 0; i < count; ++i) {
             // Convert int16_t to float for multiplication
@@ -111,12 +110,79 @@ protected:
         int prn;
         double doppler_hz;
         double power_dbm;
-        double code_phase_chips;
-        double carrier_phase_rad;
+        double code_phase_chips;            // Position in the spreading code (chips)
+        double carrier_phase_rad;           // Carrier phase at the end of the last chunk (reported only)
         bool is_active;
         EphemerisData ephemeris;  // Loaded ephemeris data
+        double amplitude_scale = 1.0;  // Linear gain from runtime power changes
+        int code_chip = 1;                  // Current spreading chip (+1/-1)
+        int64_t doppler_epoch = -1;         // Geometry epoch the Doppler was evaluated for
+        int64_t epoch_start_sample = 0;     // Absolute index of that epoch's first sample
+        double epoch_phase_cycles = 0.0;    // Carrier phase at the epoch start, in cycles [0, 1)
     };
     
+    // Doppler is re-evaluated on a fixed grid of sample epochs, not per chunk
+    static constexpr double DOPPLER_EPOCH_S = 1e-3;
+    
+    /**
+     * Absolute index of the first sample of a chunk
+     * Sample times are derived from this index, so they do not depend on how
+     * the stream is cut into chunks.
+     */
+    int64_t first_sample_index(double time_now) const {
+        return std::llround(time_now * config_.sampling_rate_hz);
+    }
+    
+    double sample_time(int64_t sample_index) const {
+        return static_cast<double>(sample_index) / config_.sampling_rate_hz;
+    }
+    
+    int64_t doppler_epoch_samples() const {
+        return std::max<int64_t>(1, std::llround(DOPPLER_EPOCH_S * config_.sampling_rate_hz));
+    }
+    
+    static double wrap_cycles(double cycles) {
+        return cycles - std::floor(cycles);
+    }
+    
+    /**
+     * Refresh a satellite's Doppler when the sample enters a new epoch
+     * The carrier phase is integrated across the boundary with the outgoing
+     * epoch's frequency, so a Doppler step changes the slope, not the phase.
+     * The first epoch of a stream (or one reached by a seek) is anchored to
+     * absolute time.
+     */
+    void update_doppler(SatelliteConfig& sat, int64_t sample_index) {
+        const int64_t epoch_samples = doppler_epoch_samples();
+        int64_t epoch = sample_index / epoch_samples;
+        if (epoch == sat.doppler_epoch) return;
+        
+        const int64_t epoch_start = epoch * epoch_samples;
+        double doppler = sat.ephemeris.is_valid
+            ? calculate_satellite_position(sat.ephemeris, sample_time(epoch_start)).doppler
+            : sat.doppler_hz;
+        if (sat.doppler_epoch >= 0 && epoch == sat.doppler_epoch + 1) {
+            sat.epoch_phase_cycles = wrap_cycles(sat.epoch_phase_cycles +
+                                                 cycles_per_sample(sat) * static_cast<double>(epoch_samples));
+        } else {
+            sat.epoch_phase_cycles = wrap_cycles((carrier_frequency_hz_ + doppler) * sample_time(epoch_start));
+        }
+        sat.doppler_epoch = epoch;
+        sat.epoch_start_sample = epoch_start;
+        sat.doppler_hz = doppler;
+    }
+    
+    // Fractional carrier cycles per sample; whole cycles are dropped before scaling by a sample count
+    double cycles_per_sample(const SatelliteConfig& sat) const {
+        return wrap_cycles((carrier_frequency_hz_ + sat.doppler_hz) / config_.sampling_rate_hz);
+    }
+    
+    // Carrier phase (rad) of a sample inside the satellite's current Doppler epoch
+    double carrier_phase(const SatelliteConfig& sat, int64_t sample_index) const {
+        double offset = static_cast<double>(sample_index - sat.epoch_start_sample);
+        return 2.0 * M_PI * wrap_cycles(sat.epoch_phase_cycles + wrap_cycles(cycles_per_sample(sat) * offset));
+    }
+    
     std::vector<SatelliteConfig> active_satellites_;
     
 public:
@@ -160,8 +226,57 @@ public:
         return info;
     }
     
+    size_t collect_status(SatelliteStatus* out, size_t max_count) const override {
+        size_t count = 0;
+        for (const auto& sat : active_satellites_) {
+            if (!sat.is_active) continue;
+            if (count >= max_count) break;
+            out[count++] = SatelliteStatus{sat.prn, constellation_type_, sat.is_active,
+                                           carrier_frequency_hz_ + frequency_offset_hz_,
+                                           sat.power_dbm, sat.doppler_hz, sat.carrier_phase_rad};
+        }
+        return count;
+    }
+    
+    bool apply_command(const ControlCommand& command) override {
+        if (command.type == ControlCommandType::SET_RECEIVER_POSITION) {
+            config_.receiver.x_m = command.value[0];
+            config_.receiver.y_m = command.value[1];
+            config_.receiver.z_m = command.value[2];
+            return true;
+        }
+        
+        for (auto& sat : active_satellites_) {
+            if (sat.prn != command.prn) continue;
+            switch (command.type) {
+                case ControlCommandType::SET_POWER:
+                    sat.amplitude_scale *= std::pow(10.0, (command.value[0] - sat.power_dbm) / 20.0);
+                    sat.power_dbm = command.value[0];
+                    return true;
+                case ControlCommandType::ENABLE_SATELLITE:
+                    sat.is_active = true;
+                    return true;
+                case ControlCommandType::DISABLE_SATELLITE:
+                    sat.is_active = false;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+    
+    std::vector<int> get_satellite_prns() const override {
+        std::vector<int> prns;
+        for (const auto& sat : active_satellites_) {
+            prns.push_back(sat.prn);
+        }
+        return prns;
+    }
+    
     void configure(const GlobalConfig& config) override {
         config_ = config;
+        nco_.set_sample_rate(config.sampling_rate_hz);
         
         // Initialize default satellite configuration
         initialize_default_satellites();
@@ -173,9 +288,62 @@ public:
         return configured_ && ephemeris_loaded_ && !active_satellites_.empty();
     }
     
+    size_t source_count() const override {
+        return active_satellites_.size();
+    }
+    
+    void generate_sources(std::complex<int16_t>* const* buffers, SourceGeometry* geometry,
+                          int sample_count, double time_now) override {
+        if (!is_ready()) {
+            throw QuadGNSSException("CDMA provider not ready for signal generation");
+        }
+        
+        for (size_t k = 0; k < active_satellites_.size(); ++k) {
+            SatelliteConfig& sat = active_satellites_[k];
+            std::fill(buffers[k], buffers[k] + sample_count, std::complex<int16_t>(0, 0));
+            if (!sat.is_active) continue;
+            
+            render_satellite(sat, buffers[k], sample_count, time_now);
+            apply_frequency_offset(buffers[k], sample_count, first_sample_index(time_now));
+            
+            geometry[k].active = true;
+            line_of_sight(sat, time_now, geometry[k].line_of_sight);
+        }
+    }
+    
 protected:
     virtual void initialize_default_satellites() = 0;
     
+    /**
+     * Add one satellite's signal to a buffer
+     * @param sat Active satellite; its code, carrier and status state advance
+     * @param buffer Destination, added to with int16 saturation
+     * @param sample_count Number of samples to render
+     * @param time_now Time of buffer[0] in seconds
+     */
+    virtual void render_satellite(SatelliteConfig& sat, std::complex<int16_t>* buffer,
+                                  int sample_count, double time_now) = 0;
+    
+    // Apply frequency offset using digital mixing (NCO); first_sample is buffer[0]'s absolute index
+    void apply_frequency_offset(std::complex<int16_t>* buffer, int sample_count, int64_t first_sample) {
+        if (std::abs(frequency_offset_hz_) > 1.0) {  // Only mix if significant offset
+            std::vector<std::complex<int16_t>> mixed_signal(sample_count);
+            nco_.mix_signal(buffer, mixed_signal.data(), sample_count, first_sample);
+            std::copy(mixed_signal.begin(), mixed_signal.end(), buffer);
+        }
+    }
+    
+    // Receiver-to-satellite unit vector (ECEF); zero without valid ephemeris
+    void line_of_sight(const SatelliteConfig& sat, double time_sec, double* los) const {
+        los[0] = los[1] = los[2] = 0.0;
+        if (!sat.ephemeris.is_valid) return;
+        SatellitePosition pos = calculate_satellite_position(sat.ephemeris, time_sec);
+        if (pos.range <= 0.0) return;
+        los[0] = (pos.x - config_.receiver.x_m) / pos.range;
+        los[1] = (pos.y - config_.receiver.y_m) / pos.range;
+        los[2] = (pos.z - config_.receiver.z_m) / pos.range;
+    }
+    
     // Helper method to calculate frequency offset from center frequency
     double calculate_frequency_offset(double center_freq_hz) const {
         return carrier_frequency_hz_ - center_freq_hz;
@@ -222,10 +390,6 @@ protected:
         // Radius
         double r = a * (1.0 - eph.e * std::cos(E));
         
-        // Position in orbital plane
-        double x_orb = r * std::cos(nu);
-        double y_orb = r * std::sin(nu);
-        
         // Corrected arguments
         double u = nu + eph.cuc * std::cos(2.0 * nu) + eph.cus * std::sin(2.0 * nu);
         double r_corr = r + eph.crc * std::cos(2.0 * nu) + eph.crs * std::sin(2.0 * nu);
@@ -240,8 +404,10 @@ protected:
         pos.z = r_corr * std::sin(u) * std::sin(i_corr);
         
         // Simplified range and Doppler calculation
-        // Assuming user at origin for now
-        pos.range = std::sqrt(pos.x * pos.x + pos.y * pos.y + pos.z * pos.z);
+        double dx = pos.x - config_.receiver.x_m;
+        double dy = pos.y - config_.receiver.y_m;
+        double dz = pos.z - config_.receiver.z_m;
+        pos.range = std::sqrt(dx * dx + dy * dy + dz * dz);
         
         // Relative velocity for Doppler (simplified)
         double v_rel = std::sqrt(mu / (a * a * a)) * eph.sqrt_a * eph.e * std::sin(nu);
@@ -251,24 +417,84 @@ protected:
     }
 };
 
-// GPS L1 C/A Provider
-class GpsL1Provider : public CDMAProviderBase {
+/**
+ * GPS L1 C/A ranging codes (IS-GPS-200)
+ *
+ * Each 1023-chip Gold code is G1 XOR G2i, where G2i is the XOR of the two
+ * G2 stages selected for the PRN. Both 10-stage registers start from all
+ * ones. The codes are built once and packed 64 chips per word so a chip
+ * depends only on its absolute index, never on where rendering started.
+ */
+class GpsCaCodeTable {
+public:
+    static constexpr int NUM_PRNS = 37;
+    static constexpr int CODE_LENGTH = 1023;
+    static constexpr int WORDS_PER_CODE = (CODE_LENGTH + 63) / 64;
+    
+    static const GpsCaCodeTable& instance() {
+        static const GpsCaCodeTable table;
+        return table;
+    }
+    
+    // Code chip (0 or 1); prn must be 1-37
+    int chip(int prn, int chip_index) const {
+        const uint64_t* code = &words_[static_cast<size_t>(prn - 1) * WORDS_PER_CODE];
+        return static_cast<int>((code[chip_index >> 6] >> (chip_index & 63)) & 1);
+    }
+    
+    // Unpacked code (0/1 per chip)
+    std::vector<uint8_t> code(int prn) const {
+        if (prn < 1 || prn > NUM_PRNS) {
+            throw QuadGNSSException("GPS C/A PRN out of range (1-37): " + std::to_string(prn));
+        }
+        std::vector<uint8_t> chips(CODE_LENGTH);
+        for (int c = 0; c < CODE_LENGTH; ++c) {
+            chips[c] = static_cast<uint8_t>(chip(prn, c));
+        }
+        return chips;
+    }
+    
 private:
-    // GPS C/A Code generation state (persistent across chunks)
-    struct GPSCodeState {
-        // G1 LFSR: x^10 + x^3 + 1
-        unsigned int g1_register;  // 10-bit register
-        // G2 LFSR: x^10 + x^9 + x^8 + x^6 + x^3 + x^2 + 1  
-        unsigned int g2_register;  // 10-bit register
-        int chip_count;          // Current position in 1023-chip sequence
-        
-        GPSCodeState() : g1_register(0x3FF), g2_register(0x3FF), chip_count(0) {}
-    };
+    // G2 phase-selector stages (IS-GPS-200 Table 3-Ia)
+    static const int phase_taps[NUM_PRNS][2];
     
-    // Tap delay table for GPS PRNs 1-37 (from ICD-GPS-200)
-    static const int gps_tap_delays[37][2];
+    std::vector<uint64_t> words_;
     
-    std::map<int, GPSCodeState> code_states_;  // Per-satellite state
+    GpsCaCodeTable() : words_(static_cast<size_t>(NUM_PRNS) * WORDS_PER_CODE, 0) {
+        for (int prn = 1; prn <= NUM_PRNS; ++prn) {
+            // Bit n-1 holds stage n
+            unsigned int g1 = 0x3FF;
+            unsigned int g2 = 0x3FF;
+            const int tap1 = phase_taps[prn - 1][0] - 1;
+            const int tap2 = phase_taps[prn - 1][1] - 1;
+            uint64_t* code = &words_[static_cast<size_t>(prn - 1) * WORDS_PER_CODE];
+            
+            for (int c = 0; c < CODE_LENGTH; ++c) {
+                unsigned int bit = ((g1 >> 9) ^ (g2 >> tap1) ^ (g2 >> tap2)) & 1;
+                code[c >> 6] |= static_cast<uint64_t>(bit) << (c & 63);
+                
+                // G1: 1 + x^3 + x^10
+                unsigned int f1 = ((g1 >> 2) ^ (g1 >> 9)) & 1;
+                // G2: 1 + x^2 + x^3 + x^6 + x^8 + x^9 + x^10
+                unsigned int f2 = ((g2 >> 1) ^ (g2 >> 2) ^ (g2 >> 5) ^ (g2 >> 7) ^ (g2 >> 8) ^ (g2 >> 9)) & 1;
+                g1 = ((g1 << 1) | f1) & 0x3FF;
+                g2 = ((g2 << 1) | f2) & 0x3FF;
+            }
+        }
+    }
+};
+
+const int GpsCaCodeTable::phase_taps[GpsCaCodeTable::NUM_PRNS][2] = {
+    {2, 6},   {3, 7},   {4, 8},   {5, 9},   {1, 9},   {2, 10},  {1, 8},   {2, 9},
+    {3, 10},  {2, 3},   {3, 4},   {5, 6},   {6, 7},   {7, 8},   {8, 9},   {9, 10},
+    {1, 4},   {2, 5},   {3, 6},   {4, 7},   {5, 8},   {6, 9},   {1, 3},   {4, 6},
+    {5, 7},   {6, 8},   {7, 9},   {8, 10},  {1, 6},   {2, 7},   {3, 8},   {4, 9},
+    {5, 10},  {4, 10},  {1, 7},   {2, 8},   {4, 10}
+};
+
+// GPS L1 C/A Provider
+class GpsL1Provider : public CDMAProviderBase {
+private:
     std::map<int, EphemerisData> ephemeris_data_;  // Loaded ephemeris data
     
 public:
@@ -310,130 +536,73 @@ public:
         // Clear output buffer
         std::fill(buffer, buffer + sample_count, std::complex<int16_t>(0, 0));
         
+        // Generate signals for each active GPS satellite
+        for (auto& sat : active_satellites_) {
+            if (sat.is_active) {
+                render_satellite(sat, buffer, sample_count, time_now);
+            }
+        }
+        
+        apply_frequency_offset(buffer, sample_count, first_sample_index(time_now));
+    }
+    
+protected:
+    void render_satellite(SatelliteConfig& sat, std::complex<int16_t>* buffer,
+                          int sample_count, double time_now) override {
         // GPS signal parameters
         const double chip_rate = 1.023e6;  // GPS L1 C/A chip rate
-        const double carrier_freq = 1575.42e6;  // GPS L1 carrier frequency
-        const double samples_per_chip = config_.sampling_rate_hz / chip_rate;
+        const GpsCaCodeTable& codes = GpsCaCodeTable::instance();
         
-        // Generate signals for each active GPS satellite
-        for (auto& sat : active_satellites_) {
-            if (!sat.is_active) continue;
+        if (sat.prn < 1 || sat.prn > GpsCaCodeTable::NUM_PRNS) {
+            throw QuadGNSSException("No GPS C/A code for PRN " + std::to_string(sat.prn));
+        }
+        
+        // Generate GPS L1 C/A spread spectrum signal
+        const int64_t first_sample = first_sample_index(time_now);
+        for (int i = 0; i < sample_count; ++i) {
+            update_doppler(sat, first_sample + i);
+            double time = sample_time(first_sample + i);
             
-            // Initialize code state if not exists
-            if (code_states_.find(sat.prn) == code_states_.end()) {
-                code_states_[sat.prn] = GPSCodeState();
-                // Set initial G2 state based on PRN tap delay
-                if (sat.prn >= 1 && sat.prn <= 37) {
-                    int delay = gps_tap_delays[sat.prn-1][1];
-                    unsigned int g2_init = 0x3FF;
-                    for (int i = 0; i < delay; ++i) {
-                        // Advance G2 register
-                        unsigned int feedback = ((g2_init >> 2) & 1) ^ ((g2_init >> 9) & 1) ^ 
-                                            ((g2_init >> 8) & 1) ^ ((g2_init >> 6) & 1) ^ 
-                                            ((g2_init >> 3) & 1) ^ ((g2_init >> 1) & 1) ^ ((g2_init >> 0) & 1);
-                        g2_init = ((feedback & 1) << 9) | (g2_init >> 1);
-                    }
-                    code_states_[sat.prn].g2_register = g2_init;
-                }
-            }
+            // Calculate chip position
+            double chip_position = time * chip_rate;
+            int64_t chip_count = static_cast<int64_t>(std::floor(chip_position));
+            int chip_index = static_cast<int>(chip_count % GpsCaCodeTable::CODE_LENGTH);
+            sat.code_phase_chips = std::fmod(chip_position, 1023.0);
             
-            GPSCodeState& state = code_states_[sat.prn];
+            int gold_chip = codes.chip(sat.prn, chip_index);
+            sat.code_chip = (gold_chip == 1) ? 1 : -1;
             
-            // Calculate satellite position and Doppler from ephemeris
-            SatellitePosition sat_pos = {0, 0, 0, 0, 0};
-            if (sat.ephemeris.is_valid) {
-                sat_pos = calculate_satellite_position(sat.ephemeris, time_now);
-                sat.doppler_hz = sat_pos.doppler;
-            }
+            // Convert chip to BPSK signal (+1/-1)
+            int chip_value = sat.code_chip;
             
-            // Generate GPS L1 C/A spread spectrum signal
-            for (int i = 0; i < sample_count; ++i) {
-                double time = time_now + static_cast<double>(i) / config_.sampling_rate_hz;
-                
-                // Calculate chip position
-                double chip_position = time * chip_rate;
-                int chip_index = static_cast<int>(chip_position) % 1023;
-                
-                // Generate Gold code chip if at new position
-                if (chip_index != state.chip_count) {
-                    state.chip_count = chip_index;
-                    
-                    // G1 LFSR feedback: x^10 + x^3 + 1
-                    unsigned int g1_feedback = ((state.g1_register >> 2) & 1) ^ ((state.g1_register >> 9) & 1);
-                    
-                    // G2 LFSR feedback: x^10 + x^9 + x^8 + x^6 + x^3 + x^2 + 1
-                    unsigned int g2_feedback = ((state.g2_register >> 2) & 1) ^ ((state.g2_register >> 9) & 1) ^ 
-                                            ((state.g2_register >> 8) & 1) ^ ((state.g2_register >> 6) & 1) ^ 
-                                            ((state.g2_register >> 3) & 1) ^ ((state.g2_register >> 1) & 1) ^ 
-                                            ((state.g2_register >> 0) & 1);
-                    
-                    // Get output chips
-                    int g1_chip = (state.g1_register >> 9) & 1;
-                    int g2_chip = (state.g2_register >> 9) & 1;
-                    
-                    // Apply G2 tap delay for this PRN
-                    int tap_delay = gps_tap_delays[sat.prn-1][1];
-                    unsigned int g2_delayed = state.g2_register;
-                    for (int d = 0; d < tap_delay; ++d) {
-                        unsigned int feedback = ((g2_delayed >> 2) & 1) ^ ((g2_delayed >> 9) & 1) ^ 
-                                            ((g2_delayed >> 8) & 1) ^ ((g2_delayed >> 6) & 1) ^ 
-                                            ((g2_delayed >> 3) & 1) ^ ((g2_delayed >> 1) & 1) ^ 
-                                            ((g2_delayed >> 0) & 1);
-                        g2_delayed = ((feedback & 1) << 9) | (g2_delayed >> 1);
-                    }
-                    int g2_delayed_chip = (g2_delayed >> 9) & 1;
-                    
-                    // Gold code chip = G1 XOR G2_delayed
-                    int gold_chip = g1_chip ^ g2_delayed_chip;
-                    
-                    // Store current chip value for this sample
-                    sat.code_phase_chips = gold_chip;
-                    
-                    // Advance registers for next chip
-                    state.g1_register = ((g1_feedback & 1) << 9) | (state.g1_register >> 1);
-                    state.g2_register = ((g2_feedback & 1) << 9) | (state.g2_register >> 1);
-                }
-                
-                // Convert chip to BPSK signal (+1/-1)
-                int chip_value = (sat.code_phase_chips == 1) ? 1 : -1;
-                
-                // Apply carrier modulation (BPSK at carrier frequency with Doppler)
-                double carrier_phase = 2.0 * M_PI * (carrier_freq + sat.doppler_hz) * time + sat.carrier_phase_rad;
-                double carrier = std::cos(carrier_phase);
-                
-                // Generate signal sample
-                double signal_value = chip_value * carrier * 1000.0;  // Scale for int16 range
+            // Apply carrier modulation (BPSK at carrier frequency with Doppler)
+            double carrier = std::cos(carrier_phase(sat, first_sample + i));
+            
+            // Generate signal sample
+            double signal_value = chip_value * carrier * 1000.0 * sat.amplitude_scale;  // Scale for int16 range
+            
+            // Convert to complex (I-only for BPSK)
+            std::complex<int16_t> sample(
+                static_cast<int16_t>(signal_value),
+                0
+            );
+            
+            // Add to main buffer with overflow protection
+            if (i < sample_count) {  // Buffer saturation check
+                int32_t new_i = static_cast<int32_t>(buffer[i].real()) + static_cast<int32_t>(sample.real());
+                int32_t new_q = static_cast<int32_t>(buffer[i].imag()) + static_cast<int32_t>(sample.imag());
                 
-                // Convert to complex (I-only for BPSK)
-                std::complex<int16_t> sample(
-                    static_cast<int16_t>(signal_value),
-                    0
+                // Clamp to int16 range to prevent overflow
+                buffer[i] = std::complex<int16_t>(
+                    static_cast<int16_t>(std::max(-32768, std::min(32767, new_i))),
+                    static_cast<int16_t>(std::max(-32768, std::min(32767, new_q)))
                 );
-                
-                // Add to main buffer with overflow protection
-                if (i < sample_count) {  // Buffer saturation check
-                    int32_t new_i = static_cast<int32_t>(buffer[i].real()) + static_cast<int32_t>(sample.real());
-                    int32_t new_q = static_cast<int32_t>(buffer[i].imag()) + static_cast<int32_t>(sample.imag());
-                    
-                    // Clamp to int16 range to prevent overflow
-                    buffer[i] = std::complex<int16_t>(
-                        static_cast<int16_t>(std::max(-32768, std::min(32767, new_i))),
-                        static_cast<int16_t>(std::max(-32768, std::min(32767, new_q)))
-                    );
-                }
             }
-            
-            // Update carrier phase for continuity
-            sat.carrier_phase_rad += 2.0 * M_PI * (carrier_freq + sat.doppler_hz) * sample_count / config_.sampling_rate_hz;
-            sat.carrier_phase_rad = fmod(sat.carrier_phase_rad, 2.0 * M_PI);
         }
         
-        // Apply frequency offset using digital mixing (NCO)
-        if (std::abs(frequency_offset_hz_) > 1.0) {  // Only mix if significant offset
-            std::vector<std::complex<int16_t>> mixed_signal(sample_count);
-            nco_.mix_signal(buffer, mixed_signal.data(), sample_count);
-            std::copy(mixed_signal.begin(), mixed_signal.end(), buffer);
-        }
+        // Phase at the end of the chunk, for status only
+        update_doppler(sat, first_sample + sample_count);
+        sat.carrier_phase_rad = carrier_phase(sat, first_sample + sample_count);
     }
     
 private:
@@ -452,46 +621,70 @@ private:
             active_satellites_.push_back(sat);
         }
     }
-    
-    void generate_gps_signal_placeholder(std::complex<int16_t>* buffer, 
-                                         int sample_count, 
-                                         double time_now, 
-                                         SatelliteConfig& sat) {
-        // This function is no longer used - replaced by real implementation
-        std::fill(buffer, buffer + sample_count, std::complex<int16_t>(0, 0));
-    }
 };
 
-// GPS C/A Code Tap Delay Table (PRN 1-37)
-const int GpsL1Provider::gps_tap_delays[37][2] = {
-    {2, 6},   {3, 7},   {4, 8},   {5, 9},   {1, 9},   {2, 10},  {1, 8},   {2, 9},
-    {3, 10},  {2, 3},   {3, 4},   {5, 6},   {6, 7},   {7, 8},   {8, 9},   {9, 10},
-    {1, 4},   {2, 5},   {3, 6},   {4, 7},   {5, 8},   {6, 9},   {1, 3},   {4, 6},
-    {5, 7},   {6, 8},   {7, 9},   {8, 10},  {1, 6},   {2, 7},   {3, 8},   {4, 9},
-    {5, 10},  {4, 10},  {1, 7},   {2, 8},   {4, 10}
+/**
+ * Galileo E1 tiered codes
+ *
+ * The primary code is 4092 chips of a 12-stage LFSR seeded from the PRN;
+ * the 25-chip secondary code comes from a 5-stage LFSR and advances one
+ * chip per primary period. Both are built once so a chip depends only on
+ * its absolute index.
+ */
+class GalileoE1CodeTable {
+public:
+    static constexpr int NUM_PRNS = 36;
+    static constexpr int CODE_LENGTH = 4092;
+    static constexpr int SECONDARY_LENGTH = 25;
+    static constexpr int WORDS_PER_CODE = (CODE_LENGTH + 63) / 64;
+    
+    static const GalileoE1CodeTable& instance() {
+        static const GalileoE1CodeTable table;
+        return table;
+    }
+    
+    // Primary code chip (0 or 1); prn must be 1-36
+    int chip(int prn, int chip_index) const {
+        const uint64_t* code = &words_[static_cast<size_t>(prn - 1) * WORDS_PER_CODE];
+        return static_cast<int>((code[chip_index >> 6] >> (chip_index & 63)) & 1);
+    }
+    
+    // Secondary code chip for a primary code period
+    int secondary_chip(int prn, int64_t period) const {
+        int index = static_cast<int>(((period % SECONDARY_LENGTH) + SECONDARY_LENGTH) % SECONDARY_LENGTH);
+        return static_cast<int>((secondary_[prn - 1] >> index) & 1);
+    }
+    
+private:
+    std::vector<uint64_t> words_;
+    std::vector<uint32_t> secondary_;
+    
+    GalileoE1CodeTable()
+        : words_(static_cast<size_t>(NUM_PRNS) * WORDS_PER_CODE, 0), secondary_(NUM_PRNS, 0) {
+        for (int prn = 1; prn <= NUM_PRNS; ++prn) {
+            // PRN-based seeds
+            unsigned int primary = (0x800 + ((prn * 13) & 0xFFF)) & 0xFFF;
+            unsigned int secondary = (0x10 + ((prn * 3) & 0x1F)) & 0x1F;
+            uint64_t* code = &words_[static_cast<size_t>(prn - 1) * WORDS_PER_CODE];
+            
+            for (int c = 0; c < CODE_LENGTH; ++c) {
+                code[c >> 6] |= static_cast<uint64_t>((primary >> 11) & 1) << (c & 63);
+                unsigned int feedback = (primary ^ (primary >> 2) ^ (primary >> 3) ^ (primary >> 5) ^
+                                         (primary >> 6) ^ (primary >> 9) ^ (primary >> 10) ^ (primary >> 11)) & 1;
+                primary = (feedback << 11) | (primary >> 1);
+            }
+            for (int c = 0; c < SECONDARY_LENGTH; ++c) {
+                secondary_[prn - 1] |= ((secondary >> 4) & 1u) << c;
+                unsigned int feedback = ((secondary >> 2) ^ (secondary >> 4)) & 1;
+                secondary = (feedback << 4) | (secondary >> 1);
+            }
+        }
+    }
 };
 
 // Galileo E1 OS Provider
 class GalileoE1Provider : public CDMAProviderBase {
 private:
-    // Galileo E1 Code generation state (persistent across chunks)
-    struct GalileoCodeState {
-        // Galileo E1 uses tiered codes with primary and secondary sequences
-        unsigned int primary_lfsr;     // Primary code LFSR (4092 chips)
-        unsigned int secondary_lfsr;     // Secondary code LFSR (25 chips)
-        int primary_chip_count;         // Current position in primary code
-        int secondary_chip_count;       // Current position in secondary code
-        int boc_phase;                 // BOC subcarrier phase
-        
-        GalileoCodeState() : primary_lfsr(0xFFF), secondary_lfsr(0x1F), 
-                           primary_chip_count(0), secondary_chip_count(0), boc_phase(0) {}
-    };
-    
-    // Galileo E1 tiered code polynomials (from Galileo ICD)
-    static const unsigned int GALILEO_PRIMARY_POLY = 0x921;  // Primary code polynomial
-    static const unsigned int GALILEO_SECONDARY_POLY = 0x12;  // Secondary code polynomial (25 chips)
-    
-    std::map<int, GalileoCodeState> code_states_;  // Per-satellite state
     std::map<int, EphemerisData> ephemeris_data_;  // Loaded ephemeris data
     
 public:
@@ -532,121 +725,84 @@ public:
         
         std::fill(buffer, buffer + sample_count, std::complex<int16_t>(0, 0));
         
+        // Generate signals for each active Galileo satellite
+        for (auto& sat : active_satellites_) {
+            if (sat.is_active) {
+                render_satellite(sat, buffer, sample_count, time_now);
+            }
+        }
+        
+        apply_frequency_offset(buffer, sample_count, first_sample_index(time_now));
+    }
+    
+protected:
+    void render_satellite(SatelliteConfig& sat, std::complex<int16_t>* buffer,
+                          int sample_count, double time_now) override {
         // Galileo E1 signal parameters
         const double chip_rate = 1.023e6;  // Galileo E1 chip rate (same as GPS)
-        const double carrier_freq = 1575.42e6;  // Galileo E1 carrier frequency
         const double boc_subcarrier_rate = 1.023e6;  // BOC(1,1) subcarrier frequency
-        const double samples_per_chip = config_.sampling_rate_hz / chip_rate;
         
-        // Generate signals for each active Galileo satellite
-        for (auto& sat : active_satellites_) {
-            if (!sat.is_active) continue;
+        const GalileoE1CodeTable& codes = GalileoE1CodeTable::instance();
+        
+        if (sat.prn < 1 || sat.prn > GalileoE1CodeTable::NUM_PRNS) {
+            throw QuadGNSSException("No Galileo E1 code for PRN " + std::to_string(sat.prn));
+        }
+        
+        // Generate Galileo E1 OS spread spectrum signal with BOC(1,1) modulation
+        const int64_t first_sample = first_sample_index(time_now);
+        for (int i = 0; i < sample_count; ++i) {
+            update_doppler(sat, first_sample + i);
+            double time = sample_time(first_sample + i);
             
-            // Initialize code state if not exists
-            if (code_states_.find(sat.prn) == code_states_.end()) {
-                code_states_[sat.prn] = GalileoCodeState();
-                // Set initial registers based on PRN
-                unsigned int primary_seed = 0x800 + ((sat.prn * 13) & 0xFFF);  // PRN-based seed
-                unsigned int secondary_seed = 0x10 + ((sat.prn * 3) & 0x1F);
-                code_states_[sat.prn].primary_lfsr = primary_seed & 0xFFF;
-                code_states_[sat.prn].secondary_lfsr = secondary_seed & 0x1F;
-            }
+            // Calculate chip position
+            double chip_position = time * chip_rate;
+            int64_t chip_count = static_cast<int64_t>(std::floor(chip_position));
+            int64_t period = chip_count / GalileoE1CodeTable::CODE_LENGTH;
+            int chip_index = static_cast<int>(chip_count - period * GalileoE1CodeTable::CODE_LENGTH);
+            sat.code_phase_chips = std::fmod(chip_position, 4092.0);
             
-            GalileoCodeState& state = code_states_[sat.prn];
+            // Tiered code: primary XOR secondary
+            int tiered_chip = codes.chip(sat.prn, chip_index) ^ codes.secondary_chip(sat.prn, period);
+            sat.code_chip = (tiered_chip == 1) ? 1 : -1;
             
-            // Generate Galileo E1 OS spread spectrum signal with BOC(1,1) modulation
-            for (int i = 0; i < sample_count; ++i) {
-                double time = time_now + static_cast<double>(i) / config_.sampling_rate_hz;
-                
-                // Calculate chip position
-                double chip_position = time * chip_rate;
-                int primary_chip_index = static_cast<int>(chip_position) % 4092;
-                int secondary_chip_index = (primary_chip_index / 4092) % 25;  // Secondary repeats every 25 primary chips
-                
-                // Generate tiered code chip if at new position
-                if (primary_chip_index != state.primary_chip_count) {
-                    state.primary_chip_count = primary_chip_index;
-                    state.secondary_chip_count = secondary_chip_index;
-                    
-                    // Primary code LFSR feedback (12-bit LFSR)
-                    unsigned int primary_feedback = ((state.primary_lfsr >> 0) & 1) ^ 
-                                                 ((state.primary_lfsr >> 2) & 1) ^ 
-                                                 ((state.primary_lfsr >> 3) & 1) ^ 
-                                                 ((state.primary_lfsr >> 5) & 1) ^ 
-                                                 ((state.primary_lfsr >> 6) & 1) ^ 
-                                                 ((state.primary_lfsr >> 9) & 1) ^ 
-                                                 ((state.primary_lfsr >> 10) & 1) ^ 
-                                                 ((state.primary_lfsr >> 11) & 1);
-                    
-                    // Secondary code LFSR feedback (5-bit LFSR)
-                    unsigned int secondary_feedback = ((state.secondary_lfsr >> 2) & 1) ^ 
-                                                  ((state.secondary_lfsr >> 4) & 1);
-                    
-                    // Get output chips
-                    int primary_chip = (state.primary_lfsr >> 11) & 1;
-                    int secondary_chip = (state.secondary_lfsr >> 4) & 1;
-                    
-                    // Tiered code: Primary XOR Secondary
-                    int tiered_chip = primary_chip ^ secondary_chip;
-                    
-                    // Store current chip value for this sample
-                    sat.code_phase_chips = tiered_chip;
-                    
-                    // Advance registers for next chip
-                    state.primary_lfsr = ((primary_feedback & 1) << 11) | (state.primary_lfsr >> 1);
-                    state.secondary_lfsr = ((secondary_feedback & 1) << 4) | (state.secondary_lfsr >> 1);
-                }
-                
-                // Convert tiered code to BPSK signal (+1/-1)
-                int chip_value = (sat.code_phase_chips == 1) ? 1 : -1;
-                
-                // Generate BOC(1,1) subcarrier
-                double boc_phase = 2.0 * M_PI * boc_subcarrier_rate * time + state.boc_phase;
-                double boc_subcarrier = std::cos(boc_phase);  // BOC(1,1) uses cosine
-                
-                // Apply BOC modulation: multiply code by subcarrier
-                int boc_modulated_chip = chip_value * ((boc_subcarrier > 0) ? 1 : -1);
-                
-                // Apply carrier modulation (BOC-modulated BPSK at carrier frequency with Doppler)
-                double carrier_phase = 2.0 * M_PI * (carrier_freq + sat.doppler_hz) * time + sat.carrier_phase_rad;
-                double carrier = std::cos(carrier_phase);
-                
-                // Generate signal sample
-                double signal_value = boc_modulated_chip * carrier * 800.0;  // Scale for int16 range (BOC typically lower power)
+            // Convert tiered code to BPSK signal (+1/-1)
+            int chip_value = sat.code_chip;
+            
+            // Generate BOC(1,1) subcarrier
+            double boc_phase = 2.0 * M_PI * boc_subcarrier_rate * time;
+            double boc_subcarrier = std::cos(boc_phase);  // BOC(1,1) uses cosine
+            
+            // Apply BOC modulation: multiply code by subcarrier
+            int boc_modulated_chip = chip_value * ((boc_subcarrier > 0) ? 1 : -1);
+            
+            // Apply carrier modulation (BOC-modulated BPSK at carrier frequency with Doppler)
+            double carrier = std::cos(carrier_phase(sat, first_sample + i));
+            
+            // Generate signal sample
+            double signal_value = boc_modulated_chip * carrier * 800.0 * sat.amplitude_scale;  // Scale for int16 range (BOC typically lower power)
+            
+            // Convert to complex (I-only for BOC-BPSK)
+            std::complex<int16_t> sample(
+                static_cast<int16_t>(signal_value),
+                0
+            );
+            
+            // Add to main buffer with overflow protection
+            if (i < sample_count) {  // Buffer saturation check
+                int32_t new_i = static_cast<int32_t>(buffer[i].real()) + static_cast<int32_t>(sample.real());
+                int32_t new_q = static_cast<int32_t>(buffer[i].imag()) + static_cast<int32_t>(sample.imag());
                 
-                // Convert to complex (I-only for BOC-BPSK)
-                std::complex<int16_t> sample(
-                    static_cast<int16_t>(signal_value),
-                    0
+                // Clamp to int16 range to prevent overflow
+                buffer[i] = std::complex<int16_t>(
+                    static_cast<int16_t>(std::max(-32768, std::min(32767, new_i))),
+                    static_cast<int16_t>(std::max(-32768, std::min(32767, new_q)))
                 );
-                
-                // Add to main buffer with overflow protection
-                if (i < sample_count) {  // Buffer saturation check
-                    int32_t new_i = static_cast<int32_t>(buffer[i].real()) + static_cast<int32_t>(sample.real());
-                    int32_t new_q = static_cast<int32_t>(buffer[i].imag()) + static_cast<int32_t>(sample.imag());
-                    
-                    // Clamp to int16 range to prevent overflow
-                    buffer[i] = std::complex<int16_t>(
-                        static_cast<int16_t>(std::max(-32768, std::min(32767, new_i))),
-                        static_cast<int16_t>(std::max(-32768, std::min(32767, new_q)))
-                    );
-                }
             }
-            
-            // Update carrier and BOC phases for continuity
-            sat.carrier_phase_rad += 2.0 * M_PI * (carrier_freq + sat.doppler_hz) * sample_count / config_.sampling_rate_hz;
-            sat.carrier_phase_rad = fmod(sat.carrier_phase_rad, 2.0 * M_PI);
-            
-            state.boc_phase += 2.0 * M_PI * boc_subcarrier_rate * sample_count / config_.sampling_rate_hz;
-            state.boc_phase = fmod(state.boc_phase, 2.0 * M_PI);
         }
         
-        // Apply frequency offset using digital mixing
-        if (std::abs(frequency_offset_hz_) > 1.0) {
-            std::vector<std::complex<int16_t>> mixed_signal(sample_count);
-            nco_.mix_signal(buffer, mixed_signal.data(), sample_count);
-            std::copy(mixed_signal.begin(), mixed_signal.end(), buffer);
-        }
+        // Phase at the end of the chunk, for status only
+        update_doppler(sat, first_sample + sample_count);
+        sat.carrier_phase_rad = carrier_phase(sat, first_sample + sample_count);
     }
     
 private:
@@ -665,34 +821,112 @@ private:
             active_satellites_.push_back(sat);
         }
     }
+};
+
+/**
+ * BeiDou B1I ranging codes (BDS-SIS-ICD-B1I)
+ *
+ * Each primary code is G1 XOR G2, where G2's output is the XOR of the
+ * phase-assignment stages chosen by the PRN: two stages for PRN 1-37, three
+ * for PRN 38-63. Both 11-stage registers start from 01010101010 and are
+ * reset after 2046 chips (a truncated 2047-chip Gold code). The codes are
+ * built once and packed 64 chips per word.
+ * MEO/IGSO satellites also carry the 20-bit Neumann-Hoffman code, one NH
+ * chip per 1 ms code period; GEO satellites (PRN 1-5, 59-63) do not.
+ */
+class BeidouB1ICodeTable {
+public:
+    static constexpr int NUM_PRNS = 63;
+    static constexpr int CODE_LENGTH = 2046;
+    static constexpr int WORDS_PER_CODE = (CODE_LENGTH + 63) / 64;
+    static constexpr uint32_t NH_CODE = 0x4D4E;   // 00000100110101001110, first chip in bit 19
+    static constexpr int NH_LENGTH = 20;
+    
+    static const BeidouB1ICodeTable& instance() {
+        static const BeidouB1ICodeTable table;
+        return table;
+    }
+    
+    // Primary code chip (0 or 1); prn must be 1-63
+    int chip(int prn, int chip_index) const {
+        const uint64_t* code = &words_[static_cast<size_t>(prn - 1) * WORDS_PER_CODE];
+        return static_cast<int>((code[chip_index >> 6] >> (chip_index & 63)) & 1);
+    }
+    
+    static bool is_geo(int prn) {
+        return prn <= 5 || prn >= 59;
+    }
+    
+    // Secondary (NH) chip for a code period; always 0 for GEO satellites
+    static int nh_chip(int prn, int64_t period) {
+        if (is_geo(prn)) {
+            return 0;
+        }
+        int index = static_cast<int>(((period % NH_LENGTH) + NH_LENGTH) % NH_LENGTH);
+        return static_cast<int>((NH_CODE >> (NH_LENGTH - 1 - index)) & 1);
+    }
     
-    void generate_galileo_signal_placeholder(std::complex<int16_t>* buffer, 
-                                            int sample_count, 
-                                            double time_now, 
-                                            SatelliteConfig& sat) {
-        // This function is no longer used - replaced by real implementation
-        std::fill(buffer, buffer + sample_count, std::complex<int16_t>(0, 0));
+    // Unpacked primary code (0/1 per chip)
+    std::vector<uint8_t> code(int prn) const {
+        if (prn < 1 || prn > NUM_PRNS) {
+            throw QuadGNSSException("BeiDou B1I PRN out of range (1-63): " + std::to_string(prn));
+        }
+        std::vector<uint8_t> chips(CODE_LENGTH);
+        for (int c = 0; c < CODE_LENGTH; ++c) {
+            chips[c] = static_cast<uint8_t>(chip(prn, c));
+        }
+        return chips;
+    }
+    
+private:
+    // G2 phase-assignment stages; 0 marks the unused third stage of PRN 1-37
+    static const int phase_taps[NUM_PRNS][3];
+    
+    std::vector<uint64_t> words_;
+    
+    BeidouB1ICodeTable() : words_(static_cast<size_t>(NUM_PRNS) * WORDS_PER_CODE, 0) {
+        for (int prn = 1; prn <= NUM_PRNS; ++prn) {
+            // Bit n-1 holds stage n
+            const unsigned int initial = 0x2AA;  // Stages 1..11 = 0 1 0 1 0 1 0 1 0 1 0
+            unsigned int g1 = initial;
+            unsigned int g2 = initial;
+            const int tap1 = phase_taps[prn - 1][0] - 1;
+            const int tap2 = phase_taps[prn - 1][1] - 1;
+            const int tap3 = phase_taps[prn - 1][2] - 1;
+            uint64_t* code = &words_[static_cast<size_t>(prn - 1) * WORDS_PER_CODE];
+            
+            for (int c = 0; c < CODE_LENGTH; ++c) {
+                unsigned int bit = ((g1 >> 10) ^ (g2 >> tap1) ^ (g2 >> tap2) ^
+                                    (tap3 >= 0 ? g2 >> tap3 : 0)) & 1;
+                code[c >> 6] |= static_cast<uint64_t>(bit) << (c & 63);
+                
+                // G1: 1 + x + x^7 + x^8 + x^9 + x^10 + x^11
+                unsigned int f1 = (g1 ^ (g1 >> 6) ^ (g1 >> 7) ^ (g1 >> 8) ^ (g1 >> 9) ^ (g1 >> 10)) & 1;
+                // G2: 1 + x + x^2 + x^3 + x^4 + x^5 + x^8 + x^9 + x^11
+                unsigned int f2 = (g2 ^ (g2 >> 1) ^ (g2 >> 2) ^ (g2 >> 3) ^ (g2 >> 4) ^ (g2 >> 7) ^
+                                   (g2 >> 8) ^ (g2 >> 10)) & 1;
+                g1 = ((g1 << 1) | f1) & 0x7FF;
+                g2 = ((g2 << 1) | f2) & 0x7FF;
+            }
+        }
     }
 };
 
+const int BeidouB1ICodeTable::phase_taps[BeidouB1ICodeTable::NUM_PRNS][3] = {
+    {1, 3, 0},  {1, 4, 0},  {1, 5, 0},  {1, 6, 0},  {1, 8, 0},  {1, 9, 0},  {1, 10, 0}, {1, 11, 0},
+    {2, 7, 0},  {3, 4, 0},  {3, 5, 0},  {3, 6, 0},  {3, 8, 0},  {3, 9, 0},  {3, 10, 0}, {3, 11, 0},
+    {4, 5, 0},  {4, 6, 0},  {4, 8, 0},  {4, 9, 0},  {4, 10, 0}, {4, 11, 0}, {5, 6, 0},  {5, 8, 0},
+    {5, 9, 0},  {5, 10, 0}, {5, 11, 0}, {6, 8, 0},  {6, 9, 0},  {6, 10, 0}, {6, 11, 0}, {8, 9, 0},
+    {8, 10, 0}, {8, 11, 0}, {9, 10, 0}, {9, 11, 0}, {10, 11, 0},
+    {1, 2, 7},  {1, 3, 4},  {1, 3, 6},  {1, 3, 8},  {1, 3, 10}, {1, 3, 11}, {1, 4, 5},  {1, 4, 9},
+    {1, 5, 6},  {1, 5, 8},  {1, 5, 10}, {1, 5, 11}, {1, 6, 9},  {1, 7, 8},  {1, 7, 9},  {1, 7, 11},
+    {1, 8, 10}, {1, 9, 11}, {1, 10, 11}, {2, 3, 7}, {2, 3, 9},  {2, 3, 11}, {2, 4, 5},  {2, 4, 7},
+    {2, 4, 9},  {2, 5, 6}
+};
+
 // Beidou B1I Provider
 class BeidouB1Provider : public CDMAProviderBase {
 private:
-    // BeiDou B1I Code generation state (persistent across chunks)
-    struct BeidouCodeState {
-        // BeiDou B1I uses 11-bit linear shift registers
-        unsigned int lfsr1_register;  // First 11-bit LFSR
-        unsigned int lfsr2_register;  // Second 11-bit LFSR
-        int chip_count;               // Current position in 2046-chip sequence
-        
-        BeidouCodeState() : lfsr1_register(0x7FF), lfsr2_register(0x7FF), chip_count(0) {}
-    };
-    
-    // BeiDou B1I polynomial coefficients (from BDS-SIS-ICD-B1I)
-    static const unsigned int BEIDOU_POLY1 = 0x405;  // x^11 + x^9 + x^8 + x^5 + x^2 + 1
-    static const unsigned int BEIDOU_POLY2 = 0x679;  // x^11 + x^10 + x^8 + x^7 + x^4 + x^3 + 1
-    
-    std::map<int, BeidouCodeState> code_states_;  // Per-satellite state
     std::map<int, EphemerisData> ephemeris_data_;  // Loaded ephemeris data
     
 public:
@@ -733,125 +967,83 @@ public:
         
         std::fill(buffer, buffer + sample_count, std::complex<int16_t>(0, 0));
         
+        // Generate signals for each active Beidou satellite
+        for (auto& sat : active_satellites_) {
+            if (sat.is_active) {
+                render_satellite(sat, buffer, sample_count, time_now);
+            }
+        }
+        
+        apply_frequency_offset(buffer, sample_count, first_sample_index(time_now));
+    }
+    
+protected:
+    void render_satellite(SatelliteConfig& sat, std::complex<int16_t>* buffer,
+                          int sample_count, double time_now) override {
         // BeiDou B1I signal parameters
         const double chip_rate = 2.046e6;  // BeiDou B1I chip rate (2x GPS)
-        const double carrier_freq = 1561.098e6;  // BeiDou B1I carrier frequency
-        const double samples_per_chip = config_.sampling_rate_hz / chip_rate;
+        const BeidouB1ICodeTable& codes = BeidouB1ICodeTable::instance();
         
-        // Generate signals for each active Beidou satellite
-        for (auto& sat : active_satellites_) {
-            if (!sat.is_active) continue;
+        if (sat.prn < 1 || sat.prn > BeidouB1ICodeTable::NUM_PRNS) {
+            throw QuadGNSSException("No BeiDou B1I code for PRN " + std::to_string(sat.prn));
+        }
+        
+        // Generate BeiDou B1I spread spectrum signal
+        const int64_t first_sample = first_sample_index(time_now);
+        for (int i = 0; i < sample_count; ++i) {
+            update_doppler(sat, first_sample + i);
+            double time = sample_time(first_sample + i);
             
-            // Initialize code state if not exists
-            if (code_states_.find(sat.prn) == code_states_.end()) {
-                code_states_[sat.prn] = BeidouCodeState();
-                // Set initial registers based on PRN (different seeds for different satellites)
-                unsigned int seed1 = 0x400 + (sat.prn & 0x3FF);  // PRN-based seed
-                unsigned int seed2 = 0x600 + ((sat.prn * 7) & 0x3FF);
-                code_states_[sat.prn].lfsr1_register = seed1 & 0x7FF;
-                code_states_[sat.prn].lfsr2_register = seed2 & 0x7FF;
-            }
+            // Calculate chip position
+            double chip_position = time * chip_rate;
+            int64_t chip_count = static_cast<int64_t>(std::floor(chip_position));
+            int64_t period = chip_count / BeidouB1ICodeTable::CODE_LENGTH;
+            int chip_index = static_cast<int>(chip_count - period * BeidouB1ICodeTable::CODE_LENGTH);
+            sat.code_phase_chips = std::fmod(chip_position, 2046.0);
             
-            BeidouCodeState& state = code_states_[sat.prn];
+            // Primary code chip, with the NH overlay on MEO/IGSO satellites
+            int code_bit = codes.chip(sat.prn, chip_index) ^ BeidouB1ICodeTable::nh_chip(sat.prn, period);
+            sat.code_chip = (code_bit == 1) ? 1 : -1;
             
-            // Generate BeiDou B1I spread spectrum signal
-            for (int i = 0; i < sample_count; ++i) {
-                double time = time_now + static_cast<double>(i) / config_.sampling_rate_hz;
-                
-                // Calculate chip position
-                double chip_position = time * chip_rate;
-                int chip_index = static_cast<int>(chip_position) % 2046;
-                
-                // Generate CSS code chip if at new position
-                if (chip_index != state.chip_count) {
-                    state.chip_count = chip_index;
-                    
-                    // LFSR1 feedback for polynomial x^11 + x^9 + x^8 + x^5 + x^2 + 1
-                    unsigned int lfsr1_feedback = ((state.lfsr1_register >> 2) & 1) ^ 
-                                                ((state.lfsr1_register >> 5) & 1) ^ 
-                                                ((state.lfsr1_register >> 8) & 1) ^ 
-                                                ((state.lfsr1_register >> 9) & 1) ^ 
-                                                ((state.lfsr1_register >> 10) & 1);
-                    
-                    // LFSR2 feedback for polynomial x^11 + x^10 + x^8 + x^7 + x^4 + x^3 + 1
-                    unsigned int lfsr2_feedback = ((state.lfsr2_register >> 3) & 1) ^ 
-                                                ((state.lfsr2_register >> 4) & 1) ^ 
-                                                ((state.lfsr2_register >> 7) & 1) ^ 
-                                                ((state.lfsr2_register >> 8) & 1) ^ 
-                                                ((state.lfsr2_register >> 9) & 1) ^ 
-                                                ((state.lfsr2_register >> 10) & 1);
-                    
-                    // Get output chips from LFSRs
-                    int lfsr1_chip = (state.lfsr1_register >> 10) & 1;
-                    int lfsr2_chip = (state.lfsr2_register >> 10) & 1;
-                    
-                    // CSS (Chip Sequence Selection) - combine LFSRs
-                    // Different combination for each PRN to create unique sequences
-                    int css_chip;
-                    switch (sat.prn % 4) {
-                        case 0: css_chip = lfsr1_chip ^ lfsr2_chip; break;
-                        case 1: css_chip = lfsr1_chip & (~lfsr2_chip & 1); break;
-                        case 2: css_chip = (~lfsr1_chip & 1) ^ lfsr2_chip; break;
-                        case 3: css_chip = lfsr1_chip; break;
-                        default: css_chip = lfsr1_chip ^ lfsr2_chip; break;
-                    }
-                    
-                    // Store current chip value for this sample
-                    sat.code_phase_chips = css_chip;
-                    
-                    // Advance registers for next chip
-                    state.lfsr1_register = ((lfsr1_feedback & 1) << 10) | (state.lfsr1_register >> 1);
-                    state.lfsr2_register = ((lfsr2_feedback & 1) << 10) | (state.lfsr2_register >> 1);
-                }
-                
-                // Convert chip to BPSK signal (+1/-1)
-                int chip_value = (sat.code_phase_chips == 1) ? 1 : -1;
-                
-                // Apply carrier modulation (BPSK at carrier frequency with Doppler)
-                double carrier_phase = 2.0 * M_PI * (carrier_freq + sat.doppler_hz) * time + sat.carrier_phase_rad;
-                double carrier = std::cos(carrier_phase);
-                
-                // Generate signal sample
-                double signal_value = chip_value * carrier * 900.0;  // Scale for int16 range (slightly lower power)
+            // Convert chip to BPSK signal (+1/-1)
+            int chip_value = sat.code_chip;
+            
+            // Apply carrier modulation (BPSK at carrier frequency with Doppler)
+            double carrier = std::cos(carrier_phase(sat, first_sample + i));
+            
+            // Generate signal sample
+            double signal_value = chip_value * carrier * 900.0 * sat.amplitude_scale;  // Scale for int16 range (slightly lower power)
+            
+            // Convert to complex (I-only for BPSK)
+            std::complex<int16_t> sample(
+                static_cast<int16_t>(signal_value),
+                0
+            );
+            
+            // Add to main buffer with overflow protection
+            if (i < sample_count) {  // Buffer saturation check
+                int32_t new_i = static_cast<int32_t>(buffer[i].real()) + static_cast<int32_t>(sample.real());
+                int32_t new_q = static_cast<int32_t>(buffer[i].imag()) + static_cast<int32_t>(sample.imag());
                 
-                // Convert to complex (I-only for BPSK)
-                std::complex<int16_t> sample(
-                    static_cast<int16_t>(signal_value),
-                    0
+                // Clamp to int16 range to prevent overflow
+                buffer[i] = std::complex<int16_t>(
+                    static_cast<int16_t>(std::max(-32768, std::min(32767, new_i))),
+                    static_cast<int16_t>(std::max(-32768, std::min(32767, new_q)))
                 );
-                
-                // Add to main buffer with overflow protection
-                if (i < sample_count) {  // Buffer saturation check
-                    int32_t new_i = static_cast<int32_t>(buffer[i].real()) + static_cast<int32_t>(sample.real());
-                    int32_t new_q = static_cast<int32_t>(buffer[i].imag()) + static_cast<int32_t>(sample.imag());
-                    
-                    // Clamp to int16 range to prevent overflow
-                    buffer[i] = std::complex<int16_t>(
-                        static_cast<int16_t>(std::max(-32768, std::min(32767, new_i))),
-                        static_cast<int16_t>(std::max(-32768, std::min(32767, new_q)))
-                    );
-                }
             }
-            
-            // Update carrier phase for continuity
-            sat.carrier_phase_rad += 2.0 * M_PI * (carrier_freq + sat.doppler_hz) * sample_count / config_.sampling_rate_hz;
-            sat.carrier_phase_rad = fmod(sat.carrier_phase_rad, 2.0 * M_PI);
         }
         
-        // Apply frequency offset using digital mixing
-        if (std::abs(frequency_offset_hz_) > 1.0) {
-            std::vector<std::complex<int16_t>> mixed_signal(sample_count);
-            nco_.mix_signal(buffer, mixed_signal.data(), sample_count);
-            std::copy(mixed_signal.begin(), mixed_signal.end(), buffer);
-        }
+        // Phase at the end of the chunk, for status only
+        update_doppler(sat, first_sample + sample_count);
+        sat.carrier_phase_rad = carrier_phase(sat, first_sample + sample_count);
     }
     
 private:
     void initialize_default_satellites() override {
         active_satellites_.clear();
         
-        // Initialize default Beidou satellites (PRN 1-37)
-        for (int prn = 1; prn <= 37; ++prn) {
+        // Initialize default Beidou satellites (PRN 1-63)
+        for (int prn = 1; prn <= BeidouB1ICodeTable::NUM_PRNS; ++prn) {
             SatelliteConfig sat;
             sat.prn = prn;
             sat.doppler_hz = 0.0;
@@ -862,14 +1054,6 @@ private:
             active_satellites_.push_back(sat);
         }
     }
-    
-    void generate_beidou_signal_placeholder(std::complex<int16_t>* buffer, 
-                                             int sample_count, 
-                                             double time_now, 
-                                             SatelliteConfig& sat) {
-        // This function is no longer used - replaced by real implementation
-        std::fill(buffer, buffer + sample_count, std::complex<int16_t>(0, 0));
-    }
 };
 
 // Update the factory to create these new providers
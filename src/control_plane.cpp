@@ -0,0 +1,457 @@
+#include "../include/control_plane.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+// ControlCommandQueue
+
+ControlCommandQueue::ControlCommandQueue(size_t capacity)
+    : enqueue_pos_(0), dequeue_pos_(0) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    cells_.reset(new Cell[size]);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool ControlCommandQueue::try_push(const ControlCommand& command) {
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells_[pos & mask_];
+        uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.command = command;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ControlCommandQueue::try_pop(ControlCommand& command) {
+    Cell& cell = cells_[dequeue_pos_ & mask_];
+    uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<int64_t>(seq) - static_cast<int64_t>(dequeue_pos_ + 1) < 0) {
+        return false;  // Empty, or producer still writing this cell
+    }
+    command = cell.command;
+    cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+    dequeue_pos_++;
+    return true;
+}
+
+// ControlCommandSchedule
+
+ControlCommandSchedule::ControlCommandSchedule(size_t capacity)
+    : commands_(new ControlCommand[capacity > 0 ? capacity : 1]), capacity_(capacity > 0 ? capacity : 1)
+    , count_(0), applied_(0), rejected_(0), dropped_(0) {
+}
+
+bool ControlCommandSchedule::add(const ControlCommand& command) {
+    if (count_ == capacity_) {
+        dropped_++;
+        return false;
+    }
+    ControlCommand* end = commands_.get() + count_;
+    ControlCommand* at = std::upper_bound(commands_.get(), end, command,
+                                          [](const ControlCommand& a, const ControlCommand& b) {
+                                              return a.apply_at_sample < b.apply_at_sample;
+                                          });
+    std::move_backward(at, end, end + 1);
+    *at = command;
+    count_++;
+    return true;
+}
+
+size_t ControlCommandSchedule::drain(ControlCommandQueue& queue) {
+    size_t dropped = 0;
+    ControlCommand command;
+    while (queue.try_pop(command)) {
+        dropped += add(command) ? 0 : 1;
+    }
+    return dropped;
+}
+
+uint64_t ControlCommandSchedule::next_sample() const {
+    return count_ > 0 ? commands_[0].apply_at_sample : UINT64_MAX;
+}
+
+// ControlCommandParser
+
+ConstellationType ControlCommandParser::parse_constellation(const std::string& name) {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    if (upper == "GPS") return ConstellationType::GPS;
+    if (upper == "GLONASS") return ConstellationType::GLONASS;
+    if (upper == "GALILEO") return ConstellationType::GALILEO;
+    if (upper == "BEIDOU") return ConstellationType::BEIDOU;
+    throw QuadGNSSException("Unknown constellation '" + name + "'");
+}
+
+int ControlCommandParser::max_prn(ConstellationType type) {
+    switch (type) {
+        case ConstellationType::GPS: return 32;
+        case ConstellationType::GLONASS: return 24;
+        case ConstellationType::GALILEO: return 36;
+        case ConstellationType::BEIDOU: return 63;
+        default: return 0;
+    }
+}
+
+namespace {
+
+double parse_number(const std::string& token, const char* what) {
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(token, &used);
+    } catch (...) {
+        used = 0;
+    }
+    if (used != token.size() || !std::isfinite(value)) {
+        throw QuadGNSSException(std::string("Invalid ") + what + " '" + token + "'");
+    }
+    return value;
+}
+
+uint64_t parse_when(const std::string& token, uint64_t current_sample, double sampling_rate_hz) {
+    std::string spec = token.substr(1);
+    if (!spec.empty() && spec[0] == '+') {
+        double delay_s = parse_number(spec.substr(1), "delay");
+        if (delay_s < 0.0 || sampling_rate_hz <= 0.0 || delay_s * sampling_rate_hz > 1e18) {
+            throw QuadGNSSException("Invalid relative timestamp '" + token + "'");
+        }
+        return current_sample + static_cast<uint64_t>(std::llround(delay_s * sampling_rate_hz));
+    }
+    if (spec.empty() || spec.find_first_not_of("0123456789") != std::string::npos) {
+        throw QuadGNSSException("Invalid sample timestamp '" + token + "'");
+    }
+    try {
+        return std::stoull(spec);
+    } catch (const std::out_of_range&) {
+        throw QuadGNSSException("Sample timestamp out of range '" + token + "'");
+    }
+}
+
+} // namespace
+
+ControlCommand ControlCommandParser::parse(const std::string& line,
+                                           uint64_t current_sample,
+                                           double sampling_rate_hz) {
+    std::string text = line.substr(0, line.find('#'));
+    std::istringstream stream(text);
+    std::vector<std::string> tokens;
+    std::string token;
+    while (stream >> token) {
+        tokens.push_back(token);
+    }
+    if (tokens.empty()) {
+        throw QuadGNSSException("Empty command");
+    }
+
+    ControlCommand command{};
+    command.constellation = ConstellationType::NONE;
+    command.prn = -1;
+
+    if (tokens.back()[0] == '@') {
+        command.apply_at_sample = parse_when(tokens.back(), current_sample, sampling_rate_hz);
+        tokens.pop_back();
+        if (tokens.empty()) {
+            throw QuadGNSSException("Timestamp without a command");
+        }
+    }
+
+    const std::string& verb = tokens[0];
+    if (verb == "position") {
+        if (tokens.size() != 4) {
+            throw QuadGNSSException("Usage: position <x_m> <y_m> <z_m> [@when]");
+        }
+        command.type = ControlCommandType::SET_RECEIVER_POSITION;
+        double radius_sq = 0.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            command.value[axis] = parse_number(tokens[axis + 1], "coordinate");
+            radius_sq += command.value[axis] * command.value[axis];
+        }
+        if (radius_sq > 1e8 * 1e8) {
+            throw QuadGNSSException("Receiver position outside 100000 km of Earth centre");
+        }
+        return command;
+    }
+
+    if (verb == "power") {
+        command.type = ControlCommandType::SET_POWER;
+        if (tokens.size() != 4) {
+            throw QuadGNSSException("Usage: power <constellation> <prn> <dbm> [@when]");
+        }
+    } else if (verb == "enable" || verb == "disable") {
+        command.type = (verb == "enable") ? ControlCommandType::ENABLE_SATELLITE
+                                          : ControlCommandType::DISABLE_SATELLITE;
+        if (tokens.size() != 3) {
+            throw QuadGNSSException("Usage: " + verb + " <constellation> <prn> [@when]");
+        }
+    } else {
+        throw QuadGNSSException("Unknown command '" + verb + "'");
+    }
+
+    command.constellation = parse_constellation(tokens[1]);
+    double prn = parse_number(tokens[2], "PRN");
+    if (prn != std::floor(prn) || prn < 1 || prn > max_prn(command.constellation)) {
+        throw QuadGNSSException("PRN " + tokens[2] + " out of range for " +
+                                ConstellationFactory::get_constellation_name(command.constellation));
+    }
+    command.prn = static_cast<int32_t>(prn);
+
+    if (command.type == ControlCommandType::SET_POWER) {
+        command.value[0] = parse_number(tokens[3], "power");
+        if (command.value[0] < -200.0 || command.value[0] > -50.0) {
+            throw QuadGNSSException("Power must be within -200..-50 dBm");
+        }
+    }
+    return command;
+}
+
+// ControlServer
+
+ControlServer::ControlServer(ControlCommandQueue& queue,
+                             double sampling_rate_hz,
+                             std::function<uint64_t()> sample_clock)
+    : queue_(queue)
+    , sampling_rate_hz_(sampling_rate_hz)
+    , sample_clock_(std::move(sample_clock))
+    , wake_pipe_{-1, -1}
+    , listen_fd_(-1)
+    , accepted_(0)
+    , rejected_(0) {
+}
+
+ControlServer::~ControlServer() {
+    stop();
+}
+
+void ControlServer::set_satellites(const std::vector<std::pair<ConstellationType, int>>& satellites) {
+    satellites_ = satellites;
+    std::sort(satellites_.begin(), satellites_.end());
+}
+
+std::string ControlServer::handle_line(const std::string& line) {
+    std::string text = line.substr(0, line.find('#'));
+    if (text.find_first_not_of(" \t\r\n") == std::string::npos) {
+        return "";
+    }
+
+    try {
+        uint64_t now = sample_clock_ ? sample_clock_() : 0;
+        ControlCommand command = ControlCommandParser::parse(text, now, sampling_rate_hz_);
+        if (!satellites_.empty() && command.constellation != ConstellationType::NONE &&
+            !std::binary_search(satellites_.begin(), satellites_.end(),
+                                std::make_pair(command.constellation, static_cast<int>(command.prn)))) {
+            rejected_++;
+            return "ERR " + ConstellationFactory::get_constellation_name(command.constellation) + " PRN " +
+                   std::to_string(command.prn) + " is not generated";
+        }
+        if (!queue_.try_push(command)) {
+            rejected_++;
+            return "ERR control queue full";
+        }
+        accepted_++;
+        return "OK";
+    } catch (const QuadGNSSException& e) {
+        rejected_++;
+        return std::string("ERR ") + e.what();
+    } catch (const std::exception& e) {
+        // Anything the parser did not anticipate is still just a bad line
+        rejected_++;
+        return std::string("ERR invalid command: ") + e.what();
+    }
+}
+
+bool ControlServer::consume(LineBuffer& buffer, const char* data, size_t size,
+                            const std::function<void(const std::string&)>& reply) {
+    buffer.pending.append(data, size);
+    size_t newline;
+    while ((newline = buffer.pending.find('\n')) != std::string::npos) {
+        if (buffer.discarding) {
+            buffer.discarding = false;  // Tail of an overlong line
+        } else {
+            std::string text = handle_line(buffer.pending.substr(0, newline));
+            if (!text.empty()) reply(text);
+        }
+        buffer.pending.erase(0, newline + 1);
+    }
+    if (buffer.pending.size() > MAX_LINE_BYTES) {
+        buffer.pending.clear();
+        if (!buffer.discarding) {
+            buffer.discarding = true;
+            rejected_++;
+            reply("ERR line longer than " + std::to_string(MAX_LINE_BYTES) + " bytes");
+            return false;
+        }
+    }
+    return true;
+}
+
+void ControlServer::start_stdin() {
+    if (thread_.joinable()) {
+        throw QuadGNSSException("Control server already running");
+    }
+    if (pipe(wake_pipe_) != 0) {
+        throw QuadGNSSException("Cannot create control wake pipe: " + std::string(std::strerror(errno)));
+    }
+    thread_ = std::thread(&ControlServer::run_stdin_loop, this);
+}
+
+void ControlServer::start_unix_socket(const std::string& path) {
+    if (thread_.joinable()) {
+        throw QuadGNSSException("Control server already running");
+    }
+
+    sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        throw QuadGNSSException("Invalid control socket path: " + path);
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw QuadGNSSException("Cannot create control socket: " + std::string(std::strerror(errno)));
+    }
+    unlink(path.c_str());
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 8) != 0) {
+        std::string reason = std::strerror(errno);
+        close(listen_fd_);
+        listen_fd_ = -1;
+        throw QuadGNSSException("Cannot listen on control socket " + path + ": " + reason);
+    }
+    socket_path_ = path;
+
+    if (pipe(wake_pipe_) != 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        throw QuadGNSSException("Cannot create control wake pipe: " + std::string(std::strerror(errno)));
+    }
+    thread_ = std::thread(&ControlServer::run_socket_loop, this);
+}
+
+void ControlServer::stop() {
+    if (thread_.joinable()) {
+        char byte = 0;
+        ssize_t ignored = write(wake_pipe_[1], &byte, 1);
+        (void)ignored;
+        thread_.join();
+    }
+    for (int& fd : wake_pipe_) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        unlink(socket_path_.c_str());
+    }
+}
+
+void ControlServer::run_stdin_loop() {
+    LineBuffer buffer;
+    char chunk[512];
+    auto reply = [](const std::string& text) { std::cerr << "control: " << text << std::endl; };
+
+    for (;;) {
+        pollfd fds[2] = {{wake_pipe_[0], POLLIN, 0}, {STDIN_FILENO, POLLIN, 0}};
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[0].revents) {
+            return;
+        }
+        if (fds[1].revents) {
+            ssize_t n = read(STDIN_FILENO, chunk, sizeof(chunk));
+            if (n <= 0) {
+                return;  // stdin closed
+            }
+            consume(buffer, chunk, static_cast<size_t>(n), reply);
+        }
+    }
+}
+
+void ControlServer::run_socket_loop() {
+    std::map<int, LineBuffer> clients;  // fd -> partial line
+    char chunk[512];
+
+    for (;;) {
+        std::vector<pollfd> fds;
+        fds.push_back({wake_pipe_[0], POLLIN, 0});
+        fds.push_back({listen_fd_, POLLIN, 0});
+        for (const auto& client : clients) {
+            fds.push_back({client.first, POLLIN, 0});
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents) {
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            int client_fd = accept(listen_fd_, nullptr, nullptr);
+            if (client_fd >= 0) {
+                clients[client_fd];
+            }
+        }
+
+        for (size_t i = 2; i < fds.size(); ++i) {
+            if (!fds[i].revents) continue;
+            int fd = fds[i].fd;
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                close(fd);
+                clients.erase(fd);
+                continue;
+            }
+
+            bool within_limit = consume(clients[fd], chunk, static_cast<size_t>(n), [fd](const std::string& text) {
+                std::string line = text + '\n';
+                ssize_t ignored = send(fd, line.data(), line.size(), MSG_NOSIGNAL);
+                (void)ignored;
+            });
+            if (!within_limit) {
+                // A client streaming text without newlines is dropped rather than buffered
+                close(fd);
+                clients.erase(fd);
+            }
+        }
+    }
+
+    for (const auto& client : clients) {
+        close(client.first);
+    }
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,60 @@
+#include "../include/fft.h"
+#include <cmath>
+#include <utility>
+#include "../include/quad_gnss_interface.h"
+
+namespace QuadGNSS {
+
+Fft::Fft(size_t size) : size_(size), twiddle_re_(size > 1 ? size - 1 : 0), twiddle_im_(size > 1 ? size - 1 : 0), reversed_(size) {
+    if (size == 0 || (size & (size - 1)) != 0) {
+        throw QuadGNSSException("FFT size must be a power of two");
+    }
+    for (size_t half = 1; half < size; half *= 2) {
+        for (size_t k = 0; k < half; ++k) {
+            double angle = -M_PI * static_cast<double>(k) / static_cast<double>(half);
+            twiddle_re_[half - 1 + k] = static_cast<float>(std::cos(angle));
+            twiddle_im_[half - 1 + k] = static_cast<float>(std::sin(angle));
+        }
+    }
+    int bits = 0;
+    while ((size_t(1) << bits) < size) bits++;
+    for (size_t i = 0; i < size; ++i) {
+        size_t r = 0;
+        for (int b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        reversed_[i] = static_cast<uint32_t>(r);
+    }
+}
+
+void Fft::transform(float* re, float* im, float sign) const {
+    for (size_t i = 0; i < size_; ++i) {
+        size_t j = reversed_[i];
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    for (size_t half = 1; half < size_; half *= 2) {
+        const float* wr = twiddle_re_.data() + half - 1;
+        const float* wi = twiddle_im_.data() + half - 1;
+        for (size_t start = 0; start < size_; start += 2 * half) {
+            float* __restrict ar = re + start;
+            float* __restrict ai = im + start;
+            float* __restrict br = re + start + half;
+            float* __restrict bi = im + start + half;
+            for (size_t k = 0; k < half; ++k) {
+                float w_im = sign * wi[k];
+                float odd_re = br[k] * wr[k] - bi[k] * w_im;
+                float odd_im = br[k] * w_im + bi[k] * wr[k];
+                br[k] = ar[k] - odd_re;
+                bi[k] = ai[k] - odd_im;
+                ar[k] += odd_re;
+                ai[k] += odd_im;
+            }
+        }
+    }
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,157 @@
+#include "../include/fingerprint.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr uint64_t HASH_SEED = 0x9E3779B97F4A7C15ULL;
+constexpr uint64_t HASH_MULTIPLIER = 0xFF51AFD7ED558CCDULL;
+const char* const RECORD_HEADER = "# QuadGNSS fingerprint v1";
+
+uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// splitmix64 finaliser
+uint64_t finalise(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+} // namespace
+
+StreamFingerprint::StreamFingerprint(uint64_t block_samples)
+    : block_samples_(block_samples), samples_(0), block_fill_(0), state_(HASH_SEED) {
+    if (block_samples_ == 0) {
+        throw QuadGNSSException("Fingerprint block size must be positive");
+    }
+}
+
+void StreamFingerprint::append(const std::complex<int16_t>* samples, size_t count) {
+    while (count > 0) {
+        size_t take = static_cast<size_t>(std::min<uint64_t>(count, block_samples_ - block_fill_));
+        uint64_t h = state_;
+        for (size_t i = 0; i < take; ++i) {
+            // Word built arithmetically, so records are independent of host byte order
+            uint64_t word = static_cast<uint16_t>(samples[i].real()) |
+                            (static_cast<uint64_t>(static_cast<uint16_t>(samples[i].imag())) << 16);
+            h = rotl((h ^ word) * HASH_MULTIPLIER, 29);
+        }
+        state_ = h;
+        samples += take;
+        count -= take;
+        block_fill_ += take;
+        samples_ += take;
+        if (block_fill_ == block_samples_) {
+            close_block();
+        }
+    }
+}
+
+void StreamFingerprint::close_block() {
+    hashes_.push_back(finalise(state_ ^ block_fill_));
+    state_ = HASH_SEED;
+    block_fill_ = 0;
+}
+
+void StreamFingerprint::finish() {
+    if (block_fill_ > 0) {
+        close_block();
+    }
+}
+
+void StreamFingerprint::save(const std::string& path) {
+    finish();
+    std::ofstream out(path);
+    if (!out) {
+        throw QuadGNSSException("Cannot write fingerprint record: " + path);
+    }
+    out << RECORD_HEADER << "\n";
+    out << "block_samples " << block_samples_ << "\n";
+    out << "samples " << samples_ << "\n";
+    char line[24];
+    for (uint64_t hash : hashes_) {
+        std::snprintf(line, sizeof(line), "%016" PRIx64 "\n", hash);
+        out << line;
+    }
+    if (!out.flush()) {
+        throw QuadGNSSException("Cannot write fingerprint record: " + path);
+    }
+}
+
+StreamFingerprint StreamFingerprint::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw QuadGNSSException("Cannot open fingerprint record: " + path);
+    }
+    std::string header, key;
+    uint64_t block_samples = 0, samples = 0;
+    std::getline(in, header);
+    if (header != RECORD_HEADER || !(in >> key >> block_samples) || key != "block_samples" ||
+        !(in >> key >> samples) || key != "samples" || block_samples == 0) {
+        throw QuadGNSSException("Malformed fingerprint record: " + path);
+    }
+
+    StreamFingerprint record(block_samples);
+    record.samples_ = samples;
+    std::string hex;
+    while (in >> hex) {
+        char* end = nullptr;
+        uint64_t hash = std::strtoull(hex.c_str(), &end, 16);
+        if (hex.size() != 16 || *end != '\0') {
+            throw QuadGNSSException("Malformed fingerprint record: " + path);
+        }
+        record.hashes_.push_back(hash);
+    }
+    if (record.hashes_.size() != (samples + block_samples - 1) / block_samples) {
+        throw QuadGNSSException("Fingerprint record is truncated: " + path);
+    }
+    return record;
+}
+
+FingerprintComparison compare_fingerprints(const StreamFingerprint& golden, const StreamFingerprint& actual) {
+    FingerprintComparison result{false, 0, -1, ""};
+    std::ostringstream message;
+    if (golden.get_block_samples() != actual.get_block_samples()) {
+        message << "block size differs: golden " << golden.get_block_samples() << ", actual "
+                << actual.get_block_samples();
+        result.message = message.str();
+        return result;
+    }
+
+    const auto& expected = golden.get_hashes();
+    const auto& hashes = actual.get_hashes();
+    size_t common = std::min(expected.size(), hashes.size());
+    for (size_t i = 0; i < common; ++i) {
+        result.blocks_compared++;
+        if (expected[i] != hashes[i]) {
+            result.first_mismatch = static_cast<int64_t>(i);
+            message << "block " << i << " (samples from " << i * golden.get_block_samples() << ") differs";
+            result.message = message.str();
+            return result;
+        }
+    }
+    if (golden.get_samples() != actual.get_samples()) {
+        result.first_mismatch = static_cast<int64_t>(common);
+        message << "length differs: golden " << golden.get_samples() << " samples, actual " << actual.get_samples();
+        result.message = message.str();
+        return result;
+    }
+
+    result.match = true;
+    message << result.blocks_compared << " blocks match";
+    result.message = message.str();
+    return result;
+}
+
+} // namespace QuadGNSS
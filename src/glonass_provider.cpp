@@ -1,10 +1,10 @@
 #include "../include/quad_gnss_interface.h"
 #include <cmath>
+#include <cstdint>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
 #include <iostream>
-#include <immintrin.h>  // For AVX2 intrinsics
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -22,10 +22,73 @@ struct GlonassChannel {
     double doppler_hz;          // Doppler shift
     double phase_rad;           // Current phase for coherent generation
     bool is_active;             // Channel is active
+    float amplitude_scale;      // Linear gain from runtime power changes
     
     GlonassChannel() : prn(-1), channel_number(0), frequency_hz(1602e6), 
                        delta_f_hz(0.0), power_dbm(-130.0), doppler_hz(0.0),
-                       phase_rad(0.0), is_active(false) {}
+                       phase_rad(0.0), is_active(false), amplitude_scale(1.0f) {}
+};
+
+/**
+ * GLONASS L1OF chip table shared by every channel
+ *
+ * One navigation string lasts 2 s: 85 data bits at 50 bps (1.7 s) followed by
+ * the 0.3 s time mark. Each data bit is sent as two 10 ms symbols combined
+ * with the 100 Hz meander, and each time-mark symbol is one of its 30 chips.
+ * The table holds ST code XOR meander / time mark for every chip of the
+ * string, packed 64 chips per word, so only the satellite's data bit is left
+ * to apply as a sign.
+ */
+class GlonassStringTable {
+public:
+    static constexpr int ST_CODE_LENGTH = 511;
+    static constexpr int64_t CHIP_RATE_HZ = 511000;
+    static constexpr uint32_t STRING_CHIPS = 2 * 511000;        // 2 s string
+    static constexpr uint32_t CHIPS_PER_SYMBOL = 5110;          // 10 ms meander / time-mark symbol
+    static constexpr uint32_t CHIPS_PER_BIT = 2 * CHIPS_PER_SYMBOL;
+    static constexpr int DATA_BITS = 85;
+    static constexpr int DATA_SYMBOLS = 2 * DATA_BITS;
+    static constexpr const char* TIME_MARK = "111110001101110101000010010110";
+    
+    static const GlonassStringTable& instance() {
+        static const GlonassStringTable table;
+        return table;
+    }
+    
+    /**
+     * Standard accuracy ranging code: 9-stage m-sequence 1 + x^5 + x^9,
+     * registers initialised to all ones, output taken from stage 7
+     */
+    static std::vector<uint8_t> st_code() {
+        std::vector<uint8_t> code(ST_CODE_LENGTH);
+        uint16_t reg = 0x1FF;  // Bit n-1 holds stage n
+        for (int i = 0; i < ST_CODE_LENGTH; ++i) {
+            code[i] = static_cast<uint8_t>((reg >> 6) & 1);
+            uint16_t feedback = ((reg >> 4) ^ (reg >> 8)) & 1;
+            reg = static_cast<uint16_t>(((reg << 1) | feedback) & 0x1FF);
+        }
+        return code;
+    }
+    
+    // Chip bit (0 or 1) at a position within the string, before the data bit
+    int chip(uint32_t string_chip) const {
+        return static_cast<int>((words_[string_chip >> 6] >> (string_chip & 63)) & 1);
+    }
+    
+private:
+    std::vector<uint64_t> words_;
+    
+    GlonassStringTable() : words_((STRING_CHIPS + 63) / 64, 0) {
+        const std::vector<uint8_t> code = st_code();
+        for (uint32_t c = 0; c < STRING_CHIPS; ++c) {
+            uint32_t symbol = c / CHIPS_PER_SYMBOL;
+            int overlay = symbol < DATA_SYMBOLS ? static_cast<int>(symbol & 1)
+                                                : TIME_MARK[symbol - DATA_SYMBOLS] - '0';
+            if (code[c % ST_CODE_LENGTH] ^ overlay) {
+                words_[c >> 6] |= uint64_t(1) << (c & 63);
+            }
+        }
+    }
 };
 
 // FDMA Signal Generator for individual GLONASS channels
@@ -35,30 +98,46 @@ private:
     double frequency_hz_;
     double sample_rate_hz_;
     double delta_f_hz_;
-    double phase_increment_;
-    double current_phase_;
+    uint64_t string_bits_[2];   // 85 transmitted data bits of the current string, bit i = data bit i
     
-    // Precomputed phase table for efficiency (8K entries)
+    // Precomputed phase table for efficiency (8K entries, shared by every channel)
     static constexpr size_t PHASE_TABLE_SIZE = 8192;
-    std::vector<std::complex<float>> phase_table_;
+    static constexpr int PHASE_TABLE_SHIFT = 19;    // 32-bit phase -> 13-bit table index
+    
+    static const std::vector<std::complex<float>>& phase_table() {
+        static const std::vector<std::complex<float>> table = [] {
+            std::vector<std::complex<float>> entries(PHASE_TABLE_SIZE);
+            for (size_t i = 0; i < PHASE_TABLE_SIZE; ++i) {
+                double angle = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(PHASE_TABLE_SIZE);
+                entries[i] = std::complex<float>(static_cast<float>(std::cos(angle)),
+                                                 static_cast<float>(std::sin(angle)));
+            }
+            return entries;
+        }();
+        return table;
+    }
+    
+    // Phase advance per sample in 1/2^32 cycles (negative frequencies wrap)
+    uint32_t phase_step(double frequency_hz) const {
+        return static_cast<uint32_t>(static_cast<int64_t>(std::llround(frequency_hz / sample_rate_hz_ * 4294967296.0)));
+    }
+    
+    float data_sign(uint32_t string_chip, float amplitude) const {
+        uint32_t bit = string_chip / GlonassStringTable::CHIPS_PER_BIT;
+        bool set = bit < GlonassStringTable::DATA_BITS && ((string_bits_[bit >> 6] >> (bit & 63)) & 1);
+        return set ? -amplitude : amplitude;
+    }
     
 public:
-    GlonassChannelGenerator(double sample_rate_hz) 
+    explicit GlonassChannelGenerator(double sample_rate_hz) 
         : channel_number_(0), frequency_hz_(1602e6), sample_rate_hz_(sample_rate_hz),
-          delta_f_hz_(0.0), phase_increment_(0.0), current_phase_(0.0),
-          phase_table_(PHASE_TABLE_SIZE) {
-        
-        // Precompute complex exponential lookup table
-        for (size_t i = 0; i < PHASE_TABLE_SIZE; ++i) {
-            double angle = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(PHASE_TABLE_SIZE);
-            phase_table_[i] = std::complex<float>(
-                static_cast<float>(std::cos(angle)),
-                static_cast<float>(std::sin(angle))
-            );
-        }
+          delta_f_hz_(0.0), string_bits_{0, 0} {
+        phase_table();
+        GlonassStringTable::instance();
     }
     
-    void configure(int channel_number, double base_frequency, double power_dbm) {
+    // Power is not held here: accumulate() takes the channel's amplitude scale per call
+    void configure(int channel_number, double base_frequency) {
         channel_number_ = channel_number;
         
         // GLONASS frequency formula: 1602 MHz + (k * 0.5625 MHz)
@@ -67,58 +146,70 @@ public:
         // Calculate frequency offset for mixing
         // This is the key difference from CDMA - each satellite has different frequency
         delta_f_hz_ = frequency_hz_ - base_frequency;
-        
-        // Calculate phase increment for coherent signal generation
-        phase_increment_ = 2.0 * M_PI * frequency_hz_ / sample_rate_hz_;
     }
     
-    void reset_phase() {
-        current_phase_ = 0.0;
+    /**
+     * Set the data bits broadcast in every string (relative code, Hamming bits included)
+     * @param bits Up to 85 bits, 0 or 1, in transmission order; missing bits are 0
+     */
+    void set_string_bits(const std::vector<uint8_t>& bits) {
+        if (bits.size() > static_cast<size_t>(GlonassStringTable::DATA_BITS)) {
+            throw QuadGNSSException("A GLONASS string carries at most 85 data bits");
+        }
+        string_bits_[0] = string_bits_[1] = 0;
+        for (size_t i = 0; i < bits.size(); ++i) {
+            if (bits[i]) {
+                string_bits_[i >> 6] |= uint64_t(1) << (i & 63);
+            }
+        }
     }
     
-    // Generate GLONASS signal with FDMA frequency rotation
-    void generate_signal(std::complex<int16_t>* output, int sample_count, double time_start) {
-        // TODO: Paste PRN Code Gen from glonass-sdr-sim here
-        // TODO: Generate 511-chip m-sequence spreading code
-        // TODO: Apply BPSK modulation at satellite frequency
-        // TODO: Incorporate navigation data
+    /**
+     * Add this channel's signal to an accumulator tile
+     *
+     * Channel offset, Doppler and master-LO shift are one phasor. The carrier
+     * phase and the chip position are both derived from the absolute sample
+     * index, so tiles and chunks can be cut anywhere without changing the
+     * samples. Chip timing is exact for whole-Hz sampling rates.
+     *
+     * @param tile Accumulator of sample_count samples
+     * @param first_sample Absolute sample index of tile[0]
+     * @param shift_hz Doppler plus master-LO shift
+     * @param amplitude_scale Linear gain from runtime power changes
+     */
+    void accumulate(std::complex<float>* tile, int sample_count, int64_t first_sample, double shift_hz,
+                    float amplitude_scale) const {
+        const GlonassStringTable& string_table = GlonassStringTable::instance();
+        constexpr float SCALE_FACTOR = 0.7f;  // Prevent overflow during summation
+        const float amplitude = 1000.0f * SCALE_FACTOR * amplitude_scale;
         
-        const double chip_rate = 511e3;  // GLONASS L1 chip rate (511 kHz)
-        const double sample_time = 1.0 / sample_rate_hz_;
+        // Chip position within the 2 s string: string_chip + remainder / fs chips
+        const int64_t fs = std::max<int64_t>(1, std::llround(sample_rate_hz_));
+        const int64_t string_samples = 2 * fs;
+        const int64_t offset = ((first_sample % string_samples) + string_samples) % string_samples;
+        uint32_t string_chip = static_cast<uint32_t>(offset * GlonassStringTable::CHIP_RATE_HZ / fs);
+        int64_t remainder = offset * GlonassStringTable::CHIP_RATE_HZ % fs;
+        float sign = data_sign(string_chip, amplitude);
         
-        // SIMD-optimized loop for performance
-        // This is the CPU-intensive part - multiple frequency rotations and summations
+        const uint32_t carrier_step = phase_step(delta_f_hz_ + shift_hz);
+        uint32_t carrier_phase = carrier_step * static_cast<uint32_t>(first_sample);
+        const std::complex<float>* table = phase_table().data();
         
-        #pragma omp parallel for simd if(sample_count > 1000)
         for (int i = 0; i < sample_count; ++i) {
-            double time = time_start + (i * sample_time);
-            
-            // Generate base BPSK signal (placeholder)
-            double chip_phase = 2.0 * M_PI * chip_rate * time;
-            int16_t bpsk_signal = (std::cos(chip_phase) > 0) ? 1000 : -1000;
+            float chip = string_table.chip(string_chip) ? -sign : sign;
+            tile[i] += chip * table[carrier_phase >> PHASE_TABLE_SHIFT];
+            carrier_phase += carrier_step;
             
-            // Apply FDMA frequency rotation: exp(j*2*pi*delta_f*t)
-            double rotation_phase = 2.0 * M_PI * delta_f_hz_ * time + current_phase_;
-            
-            // Use lookup table for efficient complex exponential calculation
-            size_t table_index = static_cast<size_t>(rotation_phase * PHASE_TABLE_SIZE / (2.0 * M_PI)) % PHASE_TABLE_SIZE;
-            std::complex<float> rotation = phase_table_[table_index];
-            
-            // Apply rotation and scaling
-            std::complex<float> mixed_signal = std::complex<float>(bpsk_signal, 0.0f) * rotation;
-            
-            // Convert to int16_t with appropriate scaling
-            constexpr float SCALE_FACTOR = 0.7f;  // Prevent overflow during summation
-            output[i] = std::complex<int16_t>(
-                static_cast<int16_t>(mixed_signal.real() * SCALE_FACTOR),
-                static_cast<int16_t>(mixed_signal.imag() * SCALE_FACTOR)
-            );
-        }
-        
-        // Update phase for next chunk (maintain phase continuity)
-        current_phase_ += 2.0 * M_PI * delta_f_hz_ * sample_count * sample_time;
-        if (current_phase_ >= 2.0 * M_PI) {
-            current_phase_ -= 2.0 * M_PI;
+            remainder += GlonassStringTable::CHIP_RATE_HZ;
+            while (remainder >= fs) {
+                remainder -= fs;
+                if (++string_chip == GlonassStringTable::STRING_CHIPS) {
+                    string_chip = 0;
+                }
+                if (string_chip % GlonassStringTable::CHIPS_PER_BIT == 0) {
+                    sign = data_sign(string_chip, amplitude);
+                }
+            }
         }
     }
     
@@ -132,7 +223,7 @@ class GlonassL1Provider : public ISatelliteConstellation {
 private:
     ConstellationType constellation_type_;
     double carrier_frequency_hz_;
-    double center_frequency_hz_;  // Master LO frequency for mixing
+    double frequency_offset_hz_;  // Carrier relative to the master LO
     bool configured_;
     bool ephemeris_loaded_;
     
@@ -140,77 +231,18 @@ private:
     std::vector<GlonassChannel> channels_;
     std::vector<std::unique_ptr<GlonassChannelGenerator>> channel_generators_;
     
-    // Signal accumulation buffer (per satellite)
-    std::vector<std::vector<std::complex<int16_t>>> satellite_buffers_;
+    // Shared accumulator tile: every channel adds into it while it is in L1, then it is quantized once
+    static constexpr int TILE_SAMPLES = 4096;
+    std::vector<std::complex<float>> tile_;
+    std::vector<int> active_channels_;
     
     GlobalConfig config_;
-    
-    // AVX2-optimized summation function
-    void avx2_sum_channels(std::complex<int16_t>* output, int sample_count) {
-        // TODO: Implement AVX2 intrinsics for high-performance summation
-        // This will significantly improve performance for multiple FDMA channels
-        
-        if (satellite_buffers_.empty()) {
-            return;
-        }
-        
-        // Clear output buffer
-        std::fill(output, output + sample_count, std::complex<int16_t>(0, 0));
-        
-        /*
-         * AVX2 Implementation Note:
-         * 
-         * Use _mm256_loadu_si256() to load 8 complex samples (16 int16_t) at once
-         * Use _mm256_add_epi16() for vectorized addition
-         * Use _mm256_storeu_si256() to store results back to memory
-         * 
-         * Example structure:
-         * 
-         * __m256i sum_lo, sum_hi;
-         * for (int i = 0; i < sample_count; i += 16) {
-         *     sum_lo = _mm256_loadu_si256((__m256i*)&output[i]);
-         *     sum_hi = _mm256_loadu_si256((__m256i*)&output[i + 8]);
-         *     
-         *     for (const auto& buffer : satellite_buffers_) {
-         *         __m256i buf_lo = _mm256_loadu_si256((__m256i*)&buffer[i]);
-         *         __m256i buf_hi = _mm256_loadu_si256((__m256i*)&buffer[i + 8]);
-         *         sum_lo = _mm256_add_epi16(sum_lo, buf_lo);
-         *         sum_hi = _mm256_add_epi16(sum_hi, buf_hi);
-         *     }
-         *     
-         *     _mm256_storeu_si256((__m256i*)&output[i], sum_lo);
-         *     _mm256_storeu_si256((__m256i*)&output[i + 8], sum_hi);
-         * }
-         */
-        
-        // SIMD-fallback implementation for now
-        #pragma omp parallel for simd if(sample_count > 1000 && satellite_buffers_.size() > 4)
-        for (int i = 0; i < sample_count; ++i) {
-            int32_t sum_real = 0;
-            int32_t sum_imag = 0;
-            
-            // Accumulate all satellite signals
-            for (const auto& buffer : satellite_buffers_) {
-                sum_real += buffer[i].real();
-                sum_imag += buffer[i].imag();
-            }
-            
-            // Clamp to int16_t range to prevent overflow
-            constexpr int16_t MAX_VAL = 32767;
-            constexpr int16_t MIN_VAL = -32768;
-            
-            output[i] = std::complex<int16_t>(
-                std::max(MIN_VAL, std::min(MAX_VAL, static_cast<int16_t>(sum_real))),
-                std::max(MIN_VAL, std::min(MAX_VAL, static_cast<int16_t>(sum_imag)))
-            );
-        }
-    }
 
 public:
     GlonassL1Provider() 
         : constellation_type_(ConstellationType::GLONASS)
         , carrier_frequency_hz_(1602e6)  // GLONASS L1 center frequency
-        , center_frequency_hz_(1582e6)    // Default master LO
+        , frequency_offset_hz_(0.0)      // Carrier at the master LO until set_frequency_offset()
         , configured_(false)
         , ephemeris_loaded_(false) {
         
@@ -236,59 +268,38 @@ public:
             throw QuadGNSSException("GLONASS L1 Provider not ready for signal generation");
         }
         
-        // Clear output buffer
-        std::fill(buffer, buffer + sample_count, std::complex<int16_t>(0, 0));
-        
-        // Resize satellite buffers if needed
-        satellite_buffers_.resize(14);
-        for (auto& buf : satellite_buffers_) {
-            buf.resize(sample_count);
-        }
-        
-        // Generate signals for each active GLONASS satellite
+        // Configure the generator of each active GLONASS satellite
         // This is the core FDMA logic - each satellite has different frequency
-        int active_channels = 0;
-        
+        active_channels_.clear();
         for (int i = 0; i < 14; ++i) {
             if (!channels_[i].is_active) {
                 continue;
             }
+            channel_generators_[i]->configure(channels_[i].channel_number, carrier_frequency_hz_);
+            active_channels_.push_back(i);
+        }
+        
+        // Render tile by tile: channel offset, Doppler and master-LO shift are folded into each
+        // channel's phasor, so nothing is held per channel and the output is written once
+        const int64_t first_sample = std::llround(time_now * config_.sampling_rate_hz);
+        tile_.resize(TILE_SAMPLES);
+        for (int done = 0; done < sample_count; done += TILE_SAMPLES) {
+            const int count = std::min(TILE_SAMPLES, sample_count - done);
+            std::fill(tile_.begin(), tile_.begin() + count, std::complex<float>(0.0f, 0.0f));
             
-            // Configure channel generator for this satellite
-            channel_generators_[i]->configure(
-                channels_[i].channel_number,
-                carrier_frequency_hz_,
-                channels_[i].power_dbm
-            );
-            
-            // Generate satellite signal with its specific frequency rotation
-            // This is where FDMA happens: exp(j*2*pi*delta_f*t)
-            channel_generators_[i]->generate_signal(
-                satellite_buffers_[i].data(),
-                sample_count,
-                time_now
-            );
-            
-            active_channels++;
+            for (int i : active_channels_) {
+                channel_generators_[i]->accumulate(tile_.data(), count, first_sample + done,
+                                                   channels_[i].doppler_hz + frequency_offset_hz_,
+                                                   channels_[i].amplitude_scale);
+            }
             
-            // Apply Doppler shift if needed (additional frequency rotation)
-            if (std::abs(channels_[i].doppler_hz) > 1.0) {
-                apply_doppler_shift(satellite_buffers_[i].data(), sample_count, 
-                                  channels_[i].doppler_hz, time_now);
+            // Clamp to int16_t range to prevent overflow
+            for (int i = 0; i < count; ++i) {
+                buffer[done + i] = std::complex<int16_t>(
+                    static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, std::nearbyint(tile_[i].real())))),
+                    static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, std::nearbyint(tile_[i].imag())))));
             }
         }
-        
-        if (active_channels == 0) {
-            // No active satellites - return empty signal
-            return;
-        }
-        
-        // SUM all active satellite signals together into final buffer
-        // This is the CPU-intensive part that benefits from AVX2/SIMD
-        avx2_sum_channels(buffer, sample_count);
-        
-        // Apply final frequency offset to match master LO
-        apply_master_lo_offset(buffer, sample_count);
     }
     
     void load_ephemeris(const std::string& file_path) override {
@@ -306,9 +317,9 @@ public:
     }
     
     void set_frequency_offset(double offset_hz) override {
-        // For GLONASS FDMA, this affects the overall frequency offset
+        // For GLONASS FDMA, this is the master-LO shift shared by every channel
         // Individual satellite frequencies are handled by channel generators
-        center_frequency_hz_ = carrier_frequency_hz_ + offset_hz;
+        frequency_offset_hz_ = offset_hz;
     }
     
     ConstellationType get_constellation_type() const override {
@@ -336,6 +347,48 @@ public:
         return info;
     }
     
+    size_t collect_status(SatelliteStatus* out, size_t max_count) const override {
+        size_t count = 0;
+        for (const auto& channel : channels_) {
+            if (!channel.is_active) continue;
+            if (count >= max_count) break;
+            out[count++] = SatelliteStatus{channel.prn, constellation_type_, channel.is_active,
+                                           channel.frequency_hz, channel.power_dbm,
+                                           channel.doppler_hz, channel.phase_rad};
+        }
+        return count;
+    }
+    
+    bool apply_command(const ControlCommand& command) override {
+        for (auto& channel : channels_) {
+            if (channel.prn != command.prn) continue;
+            switch (command.type) {
+                case ControlCommandType::SET_POWER:
+                    channel.amplitude_scale *= static_cast<float>(
+                        std::pow(10.0, (command.value[0] - channel.power_dbm) / 20.0));
+                    channel.power_dbm = command.value[0];
+                    return true;
+                case ControlCommandType::ENABLE_SATELLITE:
+                    channel.is_active = true;
+                    return true;
+                case ControlCommandType::DISABLE_SATELLITE:
+                    channel.is_active = false;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+    
+    std::vector<int> get_satellite_prns() const override {
+        std::vector<int> prns;
+        for (const auto& channel : channels_) {
+            prns.push_back(channel.prn);
+        }
+        return prns;
+    }
+    
     void configure(const GlobalConfig& config) override {
         config_ = config;
         
@@ -362,62 +415,6 @@ private:
             channels_[i].power_dbm = -128.0;  // Typical GLONASS signal power
         }
     }
-    
-    void apply_doppler_shift(std::complex<int16_t>* buffer, int sample_count, 
-                            double doppler_hz, double time_start) {
-        // Additional frequency rotation for Doppler shift
-        const double sample_rate = config_.sampling_rate_hz;
-        const double phase_increment = 2.0 * M_PI * doppler_hz / sample_rate;
-        
-        #pragma omp parallel for simd if(sample_count > 1000)
-        for (int i = 0; i < sample_count; ++i) {
-            double time = time_start + (i / sample_rate);
-            double doppler_phase = 2.0 * M_PI * doppler_hz * time;
-            
-            // Apply Doppler rotation
-            std::complex<float> doppler_rotation(
-                static_cast<float>(std::cos(doppler_phase)),
-                static_cast<float>(std::sin(doppler_phase))
-            );
-            
-            std::complex<float> signal(buffer[i].real(), buffer[i].imag());
-            std::complex<float> rotated = signal * doppler_rotation;
-            
-            buffer[i] = std::complex<int16_t>(
-                static_cast<int16_t>(rotated.real()),
-                static_cast<int16_t>(rotated.imag())
-            );
-        }
-    }
-    
-    void apply_master_lo_offset(std::complex<int16_t>* buffer, int sample_count) {
-        // Apply overall frequency offset to match master LO frequency
-        double overall_offset = center_frequency_hz_ - config_.center_frequency_hz;
-        
-        if (std::abs(overall_offset) < 1.0) {
-            return;  // No significant offset needed
-        }
-        
-        const double sample_rate = config_.sampling_rate_hz;
-        const double phase_increment = 2.0 * M_PI * overall_offset / sample_rate;
-        
-        #pragma omp parallel for simd if(sample_count > 1000)
-        for (int i = 0; i < sample_count; ++i) {
-            double phase = phase_increment * i;
-            std::complex<float> rotation(
-                static_cast<float>(std::cos(phase)),
-                static_cast<float>(std::sin(phase))
-            );
-            
-            std::complex<float> signal(buffer[i].real(), buffer[i].imag());
-            std::complex<float> rotated = signal * rotation;
-            
-            buffer[i] = std::complex<int16_t>(
-                static_cast<int16_t>(rotated.real()),
-                static_cast<int16_t>(rotated.imag())
-            );
-        }
-    }
 };
 
 // Update the factory to create GLONASS provider
@@ -0,0 +1,533 @@
+#include "../include/iq_stream_server.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+namespace {
+
+void set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+std::string describe_peer(const sockaddr_in& addr) {
+    char text[INET_ADDRSTRLEN] = {0};
+    inet_ntop(AF_INET, &addr.sin_addr, text, sizeof(text));
+    return std::string(text) + ":" + std::to_string(ntohs(addr.sin_port));
+}
+
+bool parse_policy(const std::string& value, BackPressurePolicy& policy) {
+    if (value == "drop") policy = BackPressurePolicy::DROP;
+    else if (value == "block") policy = BackPressurePolicy::BLOCK;
+    else if (value == "decimate") policy = BackPressurePolicy::DECIMATE;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+IQStreamServer::IQStreamServer(const StreamClientOptions& default_options)
+    : default_options_(default_options)
+    , listen_fd_(-1)
+    , epoll_fd_(-1)
+    , wake_fd_(-1)
+    , port_(0)
+    , next_client_id_(1)
+    , next_sequence_(0)
+    , departed_drops_(0)
+    , running_(false) {
+}
+
+IQStreamServer::~IQStreamServer() {
+    stop();
+}
+
+void IQStreamServer::start(uint16_t port, const std::string& bind_address) {
+    if (running_) {
+        throw QuadGNSSException("IQ stream server already running");
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+        throw QuadGNSSException("Invalid stream bind address: " + bind_address);
+    }
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (listen_fd_ < 0 ||
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 16) != 0) {
+        std::string reason = std::strerror(errno);
+        stop();
+        throw QuadGNSSException("Cannot listen for IQ stream clients on " + bind_address + ":" +
+                                std::to_string(port) + ": " + reason);
+    }
+    set_nonblocking(listen_fd_);
+
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    epoll_fd_ = epoll_create1(0);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK);
+    if (epoll_fd_ < 0 || wake_fd_ < 0) {
+        std::string reason = std::strerror(errno);
+        stop();
+        throw QuadGNSSException("Cannot create stream server event loop: " + reason);
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event);
+    event.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+
+    running_ = true;
+    thread_ = std::thread(&IQStreamServer::run_loop, this);
+}
+
+void IQStreamServer::stop() {
+    if (running_.exchange(false)) {
+        wake();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : clients_) {
+        close(entry.first);
+    }
+    clients_.clear();
+    space_available_.notify_all();
+
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+int IQStreamServer::add_udp_destination(const std::string& host, uint16_t port,
+                                        size_t max_datagram_samples) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        throw QuadGNSSException("Invalid UDP destination address: " + host);
+    }
+    if (max_datagram_samples == 0 ||
+        sizeof(StreamFrameHeader) + max_datagram_samples * sizeof(std::complex<int16_t>) > 65507) {
+        throw QuadGNSSException("UDP datagram size must be between 1 and 16000 samples");
+    }
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::string reason = std::strerror(errno);
+        if (fd >= 0) close(fd);
+        throw QuadGNSSException("Cannot open UDP destination " + host + ": " + reason);
+    }
+    set_nonblocking(fd);
+
+    auto client = std::make_unique<Client>();
+    client->fd = fd;
+    client->is_udp = true;
+    client->peer = describe_peer(addr);
+    client->options = default_options_;
+    client->options.policy = BackPressurePolicy::DROP;
+    client->options.framed = true;
+    client->write_offset = 0;
+    client->lagging = false;
+    client->max_datagram_samples = max_datagram_samples;
+    client->chunks_sent = client->chunks_dropped = client->bytes_sent = 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    client->id = next_client_id_++;
+    int id = client->id;
+    clients_[fd] = std::move(client);
+    return id;
+}
+
+void IQStreamServer::publish(const std::complex<int16_t>* samples, uint32_t sample_count,
+                             uint64_t sample_index, double time_gps) {
+    auto chunk = std::make_shared<Chunk>();
+    chunk->header.magic = StreamFrameHeader::MAGIC;
+    chunk->header.header_bytes = sizeof(StreamFrameHeader);
+    chunk->header.sample_index = sample_index;
+    chunk->header.time_gps = time_gps;
+    chunk->header.sample_count = sample_count;
+    chunk->header.reserved = 0;
+    chunk->samples.assign(samples, samples + sample_count);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    chunk->header.sequence = next_sequence_++;
+    std::shared_ptr<const Chunk> shared = std::move(chunk);
+
+    std::vector<int> fds;
+    fds.reserve(clients_.size());
+    for (const auto& entry : clients_) {
+        fds.push_back(entry.first);
+    }
+    for (int fd : fds) {
+        auto it = clients_.find(fd);
+        if (it != clients_.end()) {
+            enqueue(*it->second, shared, lock);
+        }
+    }
+    lock.unlock();
+    wake();
+}
+
+bool IQStreamServer::enqueue(Client& client, const std::shared_ptr<const Chunk>& chunk,
+                             std::unique_lock<std::mutex>& lock) {
+    const size_t depth = std::max<size_t>(1, client.options.max_queued_chunks);
+
+    switch (client.options.policy) {
+        case BackPressurePolicy::BLOCK: {
+            int fd = client.fd;
+            int id = client.id;
+            auto has_space = [&]() {
+                auto it = clients_.find(fd);
+                return !running_ || it == clients_.end() || it->second->id != id ||
+                       it->second->queue.size() < depth;
+            };
+            if (!has_space()) {
+                wake();
+                space_available_.wait(lock, has_space);
+            }
+            auto it = clients_.find(fd);
+            if (!running_ || it == clients_.end() || it->second->id != id) {
+                return false;  // Subscriber went away while we waited
+            }
+            it->second->queue.push_back(chunk);
+            return true;
+        }
+        case BackPressurePolicy::DECIMATE: {
+            // Half full counts as lagging; a one-chunk queue lags only when full
+            if (client.queue.size() >= std::max<size_t>(1, depth / 2)) {
+                client.lagging = true;
+            } else if (client.queue.empty()) {
+                client.lagging = false;
+            }
+            uint32_t decimation = std::max<uint32_t>(1, client.options.decimation);
+            if (client.queue.size() >= depth ||
+                (client.lagging && chunk->header.sequence % decimation != 0)) {
+                client.chunks_dropped++;
+                return false;
+            }
+            client.queue.push_back(chunk);
+            return true;
+        }
+        case BackPressurePolicy::DROP:
+        default:
+            if (client.queue.size() >= depth) {
+                client.chunks_dropped++;
+                return false;
+            }
+            client.queue.push_back(chunk);
+            return true;
+    }
+}
+
+size_t IQStreamServer::get_client_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clients_.size();
+}
+
+std::vector<StreamClientStats> IQStreamServer::get_client_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<StreamClientStats> stats;
+    for (const auto& entry : clients_) {
+        const Client& c = *entry.second;
+        stats.push_back(StreamClientStats{c.id, c.peer, c.is_udp, c.options,
+                                          c.chunks_sent, c.chunks_dropped, c.bytes_sent,
+                                          c.queue.size()});
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const StreamClientStats& a, const StreamClientStats& b) { return a.id < b.id; });
+    return stats;
+}
+
+StreamQueueStats IQStreamServer::get_queue_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StreamQueueStats stats{0, default_options_.max_queued_chunks, departed_drops_};
+    for (const auto& entry : clients_) {
+        const Client& c = *entry.second;
+        if (c.queue.size() > stats.deepest_queue) {
+            stats.deepest_queue = c.queue.size();
+            stats.deepest_queue_limit = c.options.max_queued_chunks;
+        }
+        stats.chunks_dropped += c.chunks_dropped;
+    }
+    return stats;
+}
+
+void IQStreamServer::wake() {
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void IQStreamServer::run_loop() {
+    epoll_event events[32];
+
+    while (running_) {
+        int count = epoll_wait(epoll_fd_, events, 32, 100);
+        if (count < 0 && errno != EINTR) {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool flush_all = false;
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t value;
+                ssize_t ignored = read(wake_fd_, &value, sizeof(value));
+                (void)ignored;
+                flush_all = true;
+            } else if (fd == listen_fd_) {
+                accept_clients();
+            } else {
+                auto it = clients_.find(fd);
+                if (it == clients_.end()) continue;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    if (!it->second->is_udp) {
+                        remove_client(fd);
+                        continue;
+                    }
+                    // ICMP unreachable on a UDP destination: clear the error, keep streaming
+                    int error = 0;
+                    socklen_t length = sizeof(error);
+                    getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                }
+                if (events[i].events & EPOLLIN) {
+                    handle_readable(*it->second);
+                    if (clients_.find(fd) == clients_.end()) continue;
+                }
+                if (events[i].events & EPOLLOUT) {
+                    flush_client(*it->second);
+                }
+            }
+        }
+
+        if (flush_all) {
+            std::vector<int> fds;
+            for (const auto& entry : clients_) {
+                if (!entry.second->queue.empty()) fds.push_back(entry.first);
+            }
+            for (int fd : fds) {
+                auto it = clients_.find(fd);
+                if (it != clients_.end()) flush_client(*it->second);
+            }
+        }
+    }
+}
+
+void IQStreamServer::accept_clients() {
+    for (;;) {
+        sockaddr_in addr{};
+        socklen_t len = sizeof(addr);
+        int fd = accept(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        if (fd < 0) {
+            return;
+        }
+        set_nonblocking(fd);
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        auto client = std::make_unique<Client>();
+        client->id = next_client_id_++;
+        client->fd = fd;
+        client->is_udp = false;
+        client->peer = describe_peer(addr);
+        client->options = default_options_;
+        client->write_offset = 0;
+        client->lagging = false;
+        client->max_datagram_samples = 0;
+        client->chunks_sent = client->chunks_dropped = client->bytes_sent = 0;
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+        clients_[fd] = std::move(client);
+    }
+}
+
+void IQStreamServer::handle_readable(Client& client) {
+    char buffer[256];
+    ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        remove_client(client.fd);
+        return;
+    }
+    if (n < 0) {
+        return;
+    }
+
+    client.control_line.append(buffer, static_cast<size_t>(n));
+    size_t newline;
+    while ((newline = client.control_line.find('\n')) != std::string::npos) {
+        std::istringstream line(client.control_line.substr(0, newline));
+        client.control_line.erase(0, newline + 1);
+
+        std::string token;
+        line >> token;
+        if (token != "SUBSCRIBE") continue;
+
+        // Options only change between chunks, never mid-frame
+        StreamClientOptions options = client.options;
+        while (line >> token) {
+            size_t eq = token.find('=');
+            if (eq == std::string::npos) continue;
+            std::string key = token.substr(0, eq);
+            std::string value = token.substr(eq + 1);
+            if (key == "policy") {
+                parse_policy(value, options.policy);
+            } else if (key == "framed") {
+                options.framed = (value == "1");
+            } else if (key == "depth") {
+                options.max_queued_chunks = std::max(1, std::atoi(value.c_str()));
+            } else if (key == "decimation") {
+                options.decimation = static_cast<uint32_t>(std::max(1, std::atoi(value.c_str())));
+            }
+        }
+        if (client.write_offset == 0) {
+            client.options = options;
+        }
+    }
+    if (client.control_line.size() > 1024) {
+        client.control_line.clear();  // Not a control client, ignore its bytes
+    }
+}
+
+void IQStreamServer::flush_client(Client& client) {
+    if (client.is_udp) {
+        flush_udp_client(client);
+        return;
+    }
+
+    while (!client.queue.empty()) {
+        const Chunk& chunk = *client.queue.front();
+        size_t header_bytes = client.options.framed ? sizeof(StreamFrameHeader) : 0;
+        size_t payload_bytes = chunk.samples.size() * sizeof(std::complex<int16_t>);
+        size_t total = header_bytes + payload_bytes;
+
+        iovec iov[2];
+        int iov_count = 0;
+        size_t offset = client.write_offset;
+        if (offset < header_bytes) {
+            iov[iov_count].iov_base = const_cast<char*>(reinterpret_cast<const char*>(&chunk.header)) + offset;
+            iov[iov_count].iov_len = header_bytes - offset;
+            iov_count++;
+            offset = header_bytes;
+        }
+        iov[iov_count].iov_base = const_cast<char*>(reinterpret_cast<const char*>(chunk.samples.data())) +
+                                  (offset - header_bytes);
+        iov[iov_count].iov_len = total - offset;
+        iov_count++;
+
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = iov_count;
+        ssize_t sent = sendmsg(client.fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            remove_client(client.fd);
+            return;
+        }
+
+        client.bytes_sent += static_cast<uint64_t>(sent);
+        client.write_offset += static_cast<size_t>(sent);
+        if (client.write_offset < total) {
+            break;  // Socket buffer full mid-frame
+        }
+        client.write_offset = 0;
+        client.queue.pop_front();
+        client.chunks_sent++;
+        space_available_.notify_all();
+    }
+    update_interest(client);
+}
+
+void IQStreamServer::flush_udp_client(Client& client) {
+    std::vector<char> datagram(sizeof(StreamFrameHeader) +
+                               client.max_datagram_samples * sizeof(std::complex<int16_t>));
+
+    while (!client.queue.empty()) {
+        const Chunk& chunk = *client.queue.front();
+        size_t sample_offset = client.write_offset;
+
+        while (sample_offset < chunk.samples.size()) {
+            size_t count = std::min(client.max_datagram_samples, chunk.samples.size() - sample_offset);
+            StreamFrameHeader header = chunk.header;
+            header.sample_index += sample_offset;
+            header.sample_count = static_cast<uint32_t>(count);
+            std::memcpy(datagram.data(), &header, sizeof(header));
+            std::memcpy(datagram.data() + sizeof(header), chunk.samples.data() + sample_offset,
+                        count * sizeof(std::complex<int16_t>));
+
+            size_t bytes = sizeof(header) + count * sizeof(std::complex<int16_t>);
+            ssize_t sent = send(client.fd, datagram.data(), bytes, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    client.write_offset = sample_offset;
+                    update_interest(client);
+                    return;
+                }
+                // ICMP unreachable and similar: datagram lost, keep streaming
+            } else {
+                client.bytes_sent += static_cast<uint64_t>(sent);
+            }
+            sample_offset += count;
+        }
+
+        client.write_offset = 0;
+        client.queue.pop_front();
+        client.chunks_sent++;
+    }
+    update_interest(client);
+}
+
+void IQStreamServer::update_interest(const Client& client) {
+    epoll_event event{};
+    event.events = (client.is_udp ? 0u : uint32_t(EPOLLIN)) | (client.queue.empty() ? 0u : uint32_t(EPOLLOUT));
+    event.data.fd = client.fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client.fd, &event) != 0 && errno == ENOENT) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client.fd, &event);
+    }
+}
+
+void IQStreamServer::remove_client(int fd) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    auto it = clients_.find(fd);
+    if (it != clients_.end()) {
+        departed_drops_ += it->second->chunks_dropped;
+        clients_.erase(it);
+    }
+    space_available_.notify_all();
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,167 @@
+#include "../include/lane_reduction.h"
+#include "../include/quad_gnss_interface.h"
+#include "../include/trace.h"
+#include <algorithm>
+#include <functional>
+
+namespace QuadGNSS {
+
+namespace {
+
+// Reduction kernels over interleaved I/Q words; plain loops the compiler vectorizes
+
+void widen(const int16_t* __restrict a, int32_t* __restrict out, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = a[i];
+    }
+}
+
+void widen_add(const int16_t* __restrict a, const int16_t* __restrict b, int32_t* __restrict out, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = static_cast<int32_t>(a[i]) + static_cast<int32_t>(b[i]);
+    }
+}
+
+void add(const int32_t* __restrict a, const int32_t* __restrict b, int32_t* __restrict out, int n) {
+    for (int i = 0; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+void accumulate(int32_t* __restrict acc, const int32_t* __restrict b, int n) {
+    for (int i = 0; i < n; ++i) {
+        acc[i] += b[i];
+    }
+}
+
+} // namespace
+
+LaneReducer::LaneReducer(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    scratch_.resize(threads);
+    for (size_t worker = 1; worker < threads; ++worker) {
+        workers_.emplace_back(&LaneReducer::worker_loop, this, worker);
+    }
+}
+
+LaneReducer::~LaneReducer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void LaneReducer::parallel_for(size_t count, const std::function<void(size_t, size_t)>& task) {
+    if (count == 0) return;
+    if (workers_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(0, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        task_count_ = count;
+        next_task_ = 0;
+        error_ = nullptr;
+        running_ = workers_.size();
+        generation_++;
+    }
+    start_cv_.notify_all();
+    run_tasks(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return running_ == 0; });
+        task_ = nullptr;
+        error = error_;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void LaneReducer::worker_loop(size_t worker) {
+    QGNSS_TRACE_THREAD_NAME("mix worker " + std::to_string(worker));
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        run_tasks(worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--running_ == 0) done_cv_.notify_one();
+        }
+    }
+}
+
+void LaneReducer::run_tasks(size_t worker) {
+    for (size_t i = next_task_++; i < task_count_; i = next_task_++) {
+        try {
+            (*task_)(worker, i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+            next_task_ = task_count_;          // Skip what is left
+        }
+    }
+}
+
+void LaneReducer::reduce(const std::complex<int16_t>* const* lanes, size_t lane_count,
+                         std::complex<int32_t>* accumulator, int sample_count) {
+    if (sample_count <= 0) return;
+    if (lane_count == 0) {
+        std::fill(accumulator, accumulator + sample_count, std::complex<int32_t>(0, 0));
+        return;
+    }
+
+    // Level 0 pairs lanes into (lane_count + 1) / 2 partial sums; the first lives in the accumulator
+    const size_t partials = (lane_count + 1) / 2;
+    const size_t blocks = (static_cast<size_t>(sample_count) + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES;
+    for (auto& scratch : scratch_) {
+        scratch.resize((partials - 1) * BLOCK_SAMPLES);
+    }
+
+    // Passed by reference so std::function does not allocate per call
+    auto reduce_block = [&](size_t worker, size_t block) {
+        const size_t first = block * BLOCK_SAMPLES;
+        const int n = 2 * static_cast<int>(std::min<size_t>(BLOCK_SAMPLES, sample_count - first));
+        auto partial = [&](size_t k) {
+            return reinterpret_cast<int32_t*>(k == 0 ? accumulator + first
+                                                     : scratch_[worker].data() + (k - 1) * BLOCK_SAMPLES);
+        };
+        auto lane = [&](size_t l) { return reinterpret_cast<const int16_t*>(lanes[l] + first); };
+
+        for (size_t k = 0; k < lane_count / 2; ++k) {
+            widen_add(lane(2 * k), lane(2 * k + 1), partial(k), n);
+        }
+        if (lane_count % 2) {
+            widen(lane(lane_count - 1), partial(partials - 1), n);
+        }
+
+        // Higher levels pair partial sums in place: t[k] = t[2k] + t[2k + 1], an odd one moves down
+        for (size_t m = partials; m > 1; m = (m + 1) / 2) {
+            accumulate(partial(0), partial(1), n);
+            for (size_t k = 1; k < m / 2; ++k) {
+                add(partial(2 * k), partial(2 * k + 1), partial(k), n);
+            }
+            if (m % 2) {
+                std::copy(partial(m - 1), partial(m - 1) + n, partial(m / 2));
+            }
+        }
+    };
+    parallel_for(blocks, std::ref(reduce_block));
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,310 @@
+#include "../include/quadgnss.h"
+#include "../include/batch_runner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#ifndef QUADGNSS_VERSION_STRING
+#define QUADGNSS_VERSION_STRING "1.0.0"
+#endif
+
+using namespace QuadGNSS;
+
+namespace {
+
+constexpr uint32_t DEFAULT_RING_CHUNKS = 4;
+
+thread_local std::string last_error;
+
+int fail(int status, const std::string& message) {
+    last_error = message;
+    return status;
+}
+
+// One chunk buffer of the ring
+struct Slot {
+    std::vector<std::complex<int16_t>> samples;
+    uint64_t chunk = 0;
+    size_t offset = 0;                         // First sample not yet delivered
+    bool borrowed = false;
+};
+
+} // namespace
+
+struct quadgnss_sim {
+    std::shared_ptr<const ExecutionPlan> plan;
+    std::unique_ptr<PlanRenderer> renderer;
+    SatelliteBackbone truth;                   // Evaluated on demand, apart from the renderer's
+    std::vector<Slot> ring;
+    int partial = -1;                          // Slot holding a chunk fill() stopped inside
+    uint64_t next_chunk = 0;                   // Next chunk to render
+
+    size_t chunk_samples() const { return static_cast<size_t>(plan->get_chunk_samples()); }
+
+    int free_slot() const {
+        for (size_t i = 0; i < ring.size(); ++i) {
+            if (!ring[i].borrowed && static_cast<int>(i) != partial) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void render_into(Slot& slot) {
+        slot.chunk = next_chunk;
+        slot.offset = 0;
+        renderer->render(next_chunk, slot.samples.data());
+        next_chunk++;
+    }
+};
+
+namespace {
+
+quadgnss_sim* create(std::shared_ptr<const ExecutionPlan> plan) {
+    require_no_pipeline(*plan, "libquadgnss");
+    auto sim = std::make_unique<quadgnss_sim>();
+    sim->plan = std::move(plan);
+    sim->renderer = std::make_unique<PlanRenderer>(sim->plan);
+    for (const auto& sat : sim->plan->get_satellites()) {
+        sim->truth.add_satellite(sat.constellation, sat.prn, sat.power_dbm, sat.glonass_channel);
+    }
+    for (const auto& entry : sim->plan->get_ephemeris()) {
+        sim->truth.set_ephemeris(entry.first, *entry.second);
+    }
+    sim->ring.resize(DEFAULT_RING_CHUNKS);
+    for (auto& slot : sim->ring) {
+        slot.samples.resize(sim->chunk_samples());
+    }
+    last_error.clear();
+    return sim.release();
+}
+
+} // namespace
+
+extern "C" {
+
+int quadgnss_abi_version(void) {
+    return QUADGNSS_ABI_VERSION;
+}
+
+const char* quadgnss_version(void) {
+    return QUADGNSS_VERSION_STRING;
+}
+
+const char* quadgnss_last_error(void) {
+    return last_error.c_str();
+}
+
+quadgnss_sim* quadgnss_create(const char* scenario_json, const char* base_dir) {
+    if (!scenario_json) {
+        fail(QUADGNSS_ERROR_INVALID, "No scenario document");
+        return nullptr;
+    }
+    try {
+        return create(ScenarioCompiler::compile(scenario_json, base_dir ? base_dir : ""));
+    } catch (const std::exception& e) {
+        fail(QUADGNSS_ERROR_INVALID, e.what());
+        return nullptr;
+    }
+}
+
+quadgnss_sim* quadgnss_create_from_file(const char* path) {
+    if (!path) {
+        fail(QUADGNSS_ERROR_INVALID, "No scenario path");
+        return nullptr;
+    }
+    try {
+        return create(ScenarioCompiler::compile_file(path));
+    } catch (const std::exception& e) {
+        fail(QUADGNSS_ERROR_INVALID, e.what());
+        return nullptr;
+    }
+}
+
+void quadgnss_destroy(quadgnss_sim* sim) {
+    delete sim;
+}
+
+double quadgnss_sample_rate(const quadgnss_sim* sim) {
+    return sim ? sim->plan->get_config().sampling_rate_hz : 0.0;
+}
+
+double quadgnss_center_frequency(const quadgnss_sim* sim) {
+    return sim ? sim->plan->get_config().center_frequency_hz : 0.0;
+}
+
+size_t quadgnss_chunk_samples(const quadgnss_sim* sim) {
+    return sim ? sim->chunk_samples() : 0;
+}
+
+uint64_t quadgnss_total_samples(const quadgnss_sim* sim) {
+    return sim ? sim->plan->get_total_chunks() * sim->chunk_samples() : 0;
+}
+
+uint64_t quadgnss_position(const quadgnss_sim* sim) {
+    if (!sim) return 0;
+    uint64_t position = sim->next_chunk * sim->chunk_samples();
+    if (sim->partial >= 0) {
+        position -= sim->chunk_samples() - sim->ring[sim->partial].offset;
+    }
+    return position;
+}
+
+int quadgnss_set_ring_chunks(quadgnss_sim* sim, uint32_t chunks) {
+    if (!sim || chunks == 0) {
+        return fail(QUADGNSS_ERROR_INVALID, "The ring needs at least one chunk");
+    }
+    for (const auto& slot : sim->ring) {
+        if (slot.borrowed) {
+            return fail(QUADGNSS_ERROR_BUSY, "Cannot resize the ring while chunks are borrowed");
+        }
+    }
+    try {
+        std::vector<Slot> ring(chunks);
+        if (sim->partial >= 0) {
+            ring[0] = std::move(sim->ring[sim->partial]);
+            sim->partial = 0;
+        }
+        for (auto& slot : ring) {
+            slot.samples.resize(sim->chunk_samples());
+        }
+        sim->ring = std::move(ring);
+    } catch (const std::exception& e) {
+        return fail(QUADGNSS_ERROR_FAILED, e.what());
+    }
+    return QUADGNSS_OK;
+}
+
+int64_t quadgnss_fill(quadgnss_sim* sim, int16_t* iq, size_t samples) {
+    if (!sim || (!iq && samples)) {
+        return fail(QUADGNSS_ERROR_INVALID, "Null simulation or buffer");
+    }
+    const size_t chunk = sim->chunk_samples();
+    const uint64_t total_chunks = sim->plan->get_total_chunks();
+    // A request ending mid-chunk needs a ring slot for the rest of that chunk (a pending
+    // partial frees its own slot once drained); refuse before writing rather than come up short
+    if (sim->partial < 0 && samples % chunk != 0 && sim->next_chunk + samples / chunk < total_chunks &&
+        sim->free_slot() < 0) {
+        return fail(QUADGNSS_ERROR_BUSY, "Every ring chunk is borrowed");
+    }
+    size_t written = 0;
+    try {
+        while (written < samples) {
+            if (sim->partial >= 0) {
+                Slot& slot = sim->ring[sim->partial];
+                size_t take = std::min(samples - written, chunk - slot.offset);
+                std::memcpy(iq + 2 * written, slot.samples.data() + slot.offset, take * sizeof(slot.samples[0]));
+                slot.offset += take;
+                written += take;
+                if (slot.offset == chunk) sim->partial = -1;
+                continue;
+            }
+            if (sim->next_chunk >= total_chunks) {
+                break;
+            }
+            if (samples - written >= chunk) {
+                // Whole chunk: render in place, no copy
+                sim->renderer->render(sim->next_chunk++, reinterpret_cast<std::complex<int16_t>*>(iq + 2 * written));
+                written += chunk;
+                continue;
+            }
+            int free = sim->free_slot();
+            if (free < 0) {
+                return fail(QUADGNSS_ERROR_BUSY, "Every ring chunk is borrowed");
+            }
+            sim->render_into(sim->ring[free]);
+            sim->partial = free;
+        }
+    } catch (const std::exception& e) {
+        return fail(QUADGNSS_ERROR_FAILED, e.what());
+    }
+    return static_cast<int64_t>(written);
+}
+
+int quadgnss_acquire_chunk(quadgnss_sim* sim, quadgnss_chunk* chunk) {
+    if (!sim || !chunk) {
+        return fail(QUADGNSS_ERROR_INVALID, "Null simulation or chunk");
+    }
+    int index = sim->partial;
+    if (index >= 0) {
+        sim->partial = -1;                     // Hand out what fill() left of this chunk
+    } else {
+        if (sim->next_chunk >= sim->plan->get_total_chunks()) {
+            return QUADGNSS_END_OF_STREAM;
+        }
+        index = sim->free_slot();
+        if (index < 0) {
+            return fail(QUADGNSS_ERROR_BUSY, "Every ring chunk is borrowed");
+        }
+        try {
+            sim->render_into(sim->ring[index]);
+        } catch (const std::exception& e) {
+            return fail(QUADGNSS_ERROR_FAILED, e.what());
+        }
+    }
+
+    Slot& slot = sim->ring[index];
+    slot.borrowed = true;
+    const GlobalConfig& config = sim->plan->get_config();
+    chunk->iq = reinterpret_cast<const int16_t*>(slot.samples.data() + slot.offset);
+    chunk->samples = sim->chunk_samples() - slot.offset;
+    chunk->first_sample = slot.chunk * sim->chunk_samples() + slot.offset;
+    chunk->time_gps = config.simulation.start_time_gps + static_cast<double>(chunk->first_sample) / config.sampling_rate_hz;
+    chunk->slot = static_cast<uint32_t>(index);
+    return QUADGNSS_OK;
+}
+
+int quadgnss_release_chunk(quadgnss_sim* sim, const quadgnss_chunk* chunk) {
+    if (!sim || !chunk || chunk->slot >= sim->ring.size()) {
+        return fail(QUADGNSS_ERROR_INVALID, "Not a chunk of this simulation");
+    }
+    Slot& slot = sim->ring[chunk->slot];
+    if (!slot.borrowed || chunk->iq != reinterpret_cast<const int16_t*>(slot.samples.data() + slot.offset)) {
+        return fail(QUADGNSS_ERROR_INVALID, "Chunk is not borrowed");
+    }
+    slot.borrowed = false;
+    return QUADGNSS_OK;
+}
+
+int64_t quadgnss_get_truth(quadgnss_sim* sim, uint64_t sample, quadgnss_truth* truth, size_t max_count) {
+    if (!sim || (!truth && max_count)) {
+        return fail(QUADGNSS_ERROR_INVALID, "Null simulation or truth buffer");
+    }
+    try {
+        // Same epoch grid and interpolation as the renderer
+        const GlobalConfig& config = sim->plan->get_config();
+        const double fs = config.sampling_rate_hz;
+        const double start_time = config.simulation.start_time_gps;
+        const int64_t epoch_samples = std::max<int64_t>(1, std::llround(MultiBandGenerator::GEOMETRY_EPOCH_S * fs));
+        const int64_t absolute = std::llround(start_time * fs) + static_cast<int64_t>(sample);
+        const int64_t epoch_start = (absolute >= 0 ? absolute / epoch_samples
+                                                   : -((-absolute + epoch_samples - 1) / epoch_samples)) * epoch_samples;
+        const double epoch_time = static_cast<double>(epoch_start) / fs;
+        const double into_epoch = static_cast<double>(absolute - epoch_start) / fs;
+
+        double receiver[3];
+        sim->plan->receiver_position(epoch_time - start_time, receiver[0], receiver[1], receiver[2]);
+        sim->truth.set_receiver_position(receiver[0], receiver[1], receiver[2]);
+        sim->truth.update(epoch_time, static_cast<double>(epoch_samples) / fs);
+
+        size_t count = 0;
+        for (const auto& sat : sim->truth.satellites()) {
+            if (!sat.is_active) continue;
+            if (count < max_count) {
+                quadgnss_truth& out = truth[count];
+                out.constellation = static_cast<int32_t>(sat.constellation);
+                out.prn = sat.prn;
+                out.power_dbm = sat.power_dbm;
+                out.range_m = sat.geometry.range_m + sat.geometry.range_rate_m_s * into_epoch;
+                out.range_rate_m_s = sat.geometry.range_rate_m_s;
+                out.clock_bias_s = sat.geometry.clock_bias_s;
+                std::copy(receiver, receiver + 3, out.receiver_ecef_m);
+            }
+            count++;
+        }
+        return static_cast<int64_t>(count);
+    } catch (const std::exception& e) {
+        return fail(QUADGNSS_ERROR_FAILED, e.what());
+    }
+}
+
+} // extern "C"
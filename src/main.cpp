@@ -6,6 +6,29 @@
 #include <csignal>
 #include <complex>
 #include <vector>
+#include <memory>
+#include <string>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include "../include/shm_ring.h"
+#include "../include/iq_stream_server.h"
+#include "../include/async_file_sink.h"
+#include "../include/scenario.h"
+#include "../include/batch_runner.h"
+#include "../include/spectrum_monitor.h"
+#include "../include/fingerprint.h"
+#include "../include/autotune.h"
+#include "../include/recording.h"
+#include "../include/realtime.h"
+#include "../include/trace.h"
+#include "../include/metrics_endpoint.h"
+#include "../include/stage_graph.h"
+#include "../include/control_plane.h"
 
 // Simple definitions for demo
 #ifndef M_PI
@@ -24,19 +47,285 @@ struct BroadSpectrumConfig {
     static constexpr double BEIDOU_WEIGHT = 1.0;              // BeiDou B1
     static constexpr double GLONASS_WEIGHT = 0.8;             // GLONASS L1 slightly attenuated
     
+    // Carrier offsets from the centre frequency
+    static constexpr double GPS_OFFSET_HZ = 1575.42e6 - CENTER_FREQ_HZ;       // -6.08 MHz
+    static constexpr double GLONASS_OFFSET_HZ = 1602.0e6 - CENTER_FREQ_HZ;    // +20.5 MHz
+    static constexpr double GALILEO_OFFSET_HZ = 1575.42e6 - CENTER_FREQ_HZ;   // -6.08 MHz
+    static constexpr double BEIDOU_OFFSET_HZ = 1561.1e6 - CENTER_FREQ_HZ;     // -20.4 MHz
+    
     static constexpr int CHUNK_SIZE = static_cast<int>(SAMPLE_RATE_HZ * CHUNK_DURATION_SEC);
 };
 
+// Samples with a component at int16 full scale: what a saturating renderer clipped
+static uint64_t count_full_scale(const std::complex<int16_t>* samples, int count) {
+    uint64_t clipped = 0;
+    for (int i = 0; i < count; ++i) {
+        int16_t re = samples[i].real(), im = samples[i].imag();
+        clipped += (re == INT16_MAX || re == INT16_MIN || im == INT16_MAX || im == INT16_MIN) ? 1 : 0;
+    }
+    return clipped;
+}
+
+/**
+ * Check that a scenario pipeline fits between the rendered stream and the outputs
+ *
+ * The generator supplies two external stages: "generate" (the rendered
+ * int16 stream) and "output" (one int16 input feeding every sink); it also
+ * adds a "monitor" sink next to "output".
+ * @throws QuadGNSS::QuadGNSSException naming the offending stage
+ */
+static void check_pipeline(const std::vector<QuadGNSS::StageSpec>& pipeline) {
+    if (pipeline.empty()) return;
+    bool has_generate = false, has_output = false;
+    for (const auto& spec : pipeline) {
+        if (spec.name == "monitor") {
+            throw QuadGNSS::QuadGNSSException("Pipeline stage name \"monitor\" is reserved");
+        }
+        if (spec.type != "external") continue;
+        if (spec.name == "generate" && spec.inputs.empty()) {
+            has_generate = true;
+        } else if (spec.name == "output" && spec.inputs.size() == 1) {
+            has_output = true;
+        } else {
+            throw QuadGNSS::QuadGNSSException("Pipeline external stage \"" + spec.name +
+                                              "\" is not provided (use \"generate\" without inputs, \"output\" with one)");
+        }
+    }
+    if (!has_generate || !has_output) {
+        throw QuadGNSS::QuadGNSSException("Pipeline needs the external stages \"generate\" and \"output\"");
+    }
+}
+
 // Simple signal generation class
 class GNSSSignalGenerator {
 private:
     double sample_rate_;
+    double center_frequency_hz_;
+    double chunk_duration_s_;
+    int chunk_size_;
+    double start_time_;
     double current_time_;
+    double duration_s_;      // 0 = run until interrupted
     bool running_;
     
+    // Scenario rendered instead of the demo tones, with its processing pipeline
+    std::shared_ptr<const QuadGNSS::ExecutionPlan> plan_;
+    std::unique_ptr<QuadGNSS::PlanRenderer> renderer_;
+    
+    // Optional control commands (stdin or a UNIX socket), applied to the renderer at chunk boundaries
+    std::unique_ptr<QuadGNSS::ControlCommandQueue> control_queue_;
+    std::unique_ptr<QuadGNSS::ControlServer> control_server_;
+    std::unique_ptr<QuadGNSS::ControlCommandSchedule> command_schedule_;   // Same scheduling as SignalOrchestrator
+    std::atomic<uint64_t> next_sample_;                       // Sample clock for relative command timestamps
+    
+    // Optional shared-memory output (the stage feeding the outputs writes straight into ring slots)
+    std::unique_ptr<QuadGNSS::ShmRingProducer> shm_ring_;
+    
+    // Optional TCP/UDP streaming output (replaces stdout)
+    std::unique_ptr<QuadGNSS::IQStreamServer> stream_server_;
+    
+    // Optional asynchronous file output (replaces stdout)
+    std::unique_ptr<QuadGNSS::AsyncFileSink> file_sink_;
+    
+    // Optional spectrum monitor checking the frequency plan on the generated stream
+    std::unique_ptr<QuadGNSS::SpectrumMonitor> spectrum_monitor_;
+    
+    // Optional per-block fingerprint of the generated stream, written and/or checked at the end
+    std::unique_ptr<QuadGNSS::StreamFingerprint> fingerprint_;
+    std::string fingerprint_path_;
+    std::string golden_path_;
+    bool fingerprint_ok_;
+    
+    // Optional real-time mode: chunks released on a fixed schedule, production latency recorded
+    bool realtime_;
+    QuadGNSS::RealtimeOptions realtime_options_;
+    QuadGNSS::LatencyHistogram chunk_latency_;
+    uint64_t deadline_misses_;
+    
+    // Optional Prometheus endpoint, fed once per chunk
+    std::unique_ptr<QuadGNSS::MetricsChannel> metrics_;
+    std::unique_ptr<QuadGNSS::MetricsServer> metrics_server_;
+    uint32_t active_satellites_[QuadGNSS::GenerationMetrics::CONSTELLATIONS];   // Signals in the generated stream
+    uint64_t clipped_samples_;
+    
+    // Generation stages charged with CPU time in the metrics
+    enum MetricsStage { STAGE_GENERATE = 0, STAGE_MONITOR = 1, STAGE_OUTPUT = 2 };
+    
+    // generate -> monitor, output; stages see the absolute index of the chunk being run
+    std::unique_ptr<QuadGNSS::StageGraph> graph_;
+    uint64_t chunk_first_sample_;
+    bool inline_graph_;
+    
 public:
-    GNSSSignalGenerator() : sample_rate_(BroadSpectrumConfig::SAMPLE_RATE_HZ), 
-                           current_time_(0.0), running_(false) {}
+    GNSSSignalGenerator() : sample_rate_(BroadSpectrumConfig::SAMPLE_RATE_HZ),
+                           center_frequency_hz_(BroadSpectrumConfig::CENTER_FREQ_HZ),
+                           chunk_duration_s_(BroadSpectrumConfig::CHUNK_DURATION_SEC),
+                           chunk_size_(BroadSpectrumConfig::CHUNK_SIZE),
+                           start_time_(0.0), current_time_(0.0), duration_s_(0.0), running_(false),
+                           next_sample_(0),
+                           fingerprint_ok_(true), realtime_(false), deadline_misses_(0),
+                           active_satellites_{1, 1, 1, 1},    // Demo: one tone per constellation
+                           clipped_samples_(0), chunk_first_sample_(0), inline_graph_(true) {}
+    
+    void enable_shared_memory_output(const std::string& name, uint32_t ring_slots = 64) {
+        // 64 slots = 640 ms of history at 10 ms chunks
+        shm_ring_ = std::make_unique<QuadGNSS::ShmRingProducer>(
+            name, ring_slots, chunk_size_, sample_rate_);
+    }
+    
+    void enable_stream_output(uint16_t port) {
+        stream_server_ = std::make_unique<QuadGNSS::IQStreamServer>();
+        stream_server_->start(port);
+    }
+    
+    void enable_file_output(const std::string& path, QuadGNSS::FileSinkBackend backend) {
+        QuadGNSS::FileSinkOptions options;
+        options.backend = backend;
+        file_sink_ = std::make_unique<QuadGNSS::AsyncFileSink>(path, options);
+    }
+    
+    // Check the generated stream against its frequency plan (the scenario's bands once a plan is applied)
+    void enable_spectrum_monitor(const std::string& snapshot_path) {
+        QuadGNSS::SpectrumMonitorConfig config;
+        config.sampling_rate_hz = sample_rate_;
+        config.center_frequency_hz = center_frequency_hz_;
+        config.snapshot_path = snapshot_path;
+        if (renderer_) {
+            // One band per carrier of the plan: every rendered signal, and every GLONASS channel
+            std::vector<QuadGNSS::SpectrumBand> bands;
+            for (const auto& carrier : plan_->get_frequency_plan()) {
+                std::string name = QuadGNSS::get_band_info(carrier.band).name;
+                if (carrier.constellation == QuadGNSS::ConstellationType::GLONASS) {
+                    name += " k=" + std::to_string(carrier.glonass_channel);
+                }
+                bands.push_back(QuadGNSS::SpectrumBand{name, carrier.offset_hz, carrier.half_bandwidth_hz});
+            }
+            spectrum_monitor_ = std::make_unique<QuadGNSS::SpectrumMonitor>(config, bands);
+            return;
+        }
+        std::map<QuadGNSS::ConstellationType, double> offsets = {
+            {QuadGNSS::ConstellationType::GPS, BroadSpectrumConfig::GPS_OFFSET_HZ},
+            {QuadGNSS::ConstellationType::GLONASS, BroadSpectrumConfig::GLONASS_OFFSET_HZ},
+            {QuadGNSS::ConstellationType::GALILEO, BroadSpectrumConfig::GALILEO_OFFSET_HZ},
+            {QuadGNSS::ConstellationType::BEIDOU, BroadSpectrumConfig::BEIDOU_OFFSET_HZ}};
+        spectrum_monitor_ = std::make_unique<QuadGNSS::SpectrumMonitor>(config, QuadGNSS::expected_spectrum_bands(offsets));
+    }
+    
+    /**
+     * Fingerprint the generated stream
+     * @param record_path Record to write at the end ("" = none)
+     * @param golden_path Golden record to compare against at the end ("" = none)
+     * @param block_samples Samples per hash
+     */
+    void enable_fingerprint(const std::string& record_path, const std::string& golden_path, uint64_t block_samples) {
+        fingerprint_ = std::make_unique<QuadGNSS::StreamFingerprint>(block_samples);
+        fingerprint_path_ = record_path;
+        golden_path_ = golden_path;
+    }
+    
+    bool fingerprint_ok() const {
+        return fingerprint_ok_;
+    }
+    
+    /**
+     * Stream in real time: memory locked, ring pre-faulted, generation thread pinned and
+     * optionally SCHED_FIFO; missing permissions only produce warnings
+     */
+    void enable_realtime(const QuadGNSS::RealtimeOptions& options) {
+        realtime_ = true;
+        realtime_options_ = options;
+    }
+    
+    /**
+     * Serve generation counters in Prometheus text format on 127.0.0.1
+     * @param port TCP port (0 picks an ephemeral port)
+     * @throws QuadGNSS::QuadGNSSException if the port cannot be bound
+     */
+    void enable_metrics(uint16_t port) {
+        metrics_ = std::make_unique<QuadGNSS::MetricsChannel>(std::vector<std::string>{"generate", "monitor", "output"});
+        metrics_server_ = std::make_unique<QuadGNSS::MetricsServer>(*metrics_);
+        metrics_server_->start(port);
+    }
+    
+    /**
+     * Accept control commands for the applied scenario (see ControlCommandParser for the grammar)
+     *
+     * Commands take effect at the first chunk boundary at or after their
+     * target sample; replies go to stderr for stdin, to the client otherwise.
+     * @param source "-" for stdin, otherwise the path of a UNIX socket to listen on
+     * @throws QuadGNSS::QuadGNSSException if no scenario is applied or the socket cannot be created
+     */
+    void enable_control(const std::string& source) {
+        if (!renderer_) {
+            throw QuadGNSS::QuadGNSSException("Control commands need a scenario (--scenario)");
+        }
+        control_queue_ = std::make_unique<QuadGNSS::ControlCommandQueue>();
+        command_schedule_ = std::make_unique<QuadGNSS::ControlCommandSchedule>(control_queue_->capacity());
+        control_server_ = std::make_unique<QuadGNSS::ControlServer>(*control_queue_, sample_rate_,
+                                                                     [this] { return next_sample_.load(); });
+        // Commands for satellites outside the plan are refused when they arrive
+        std::vector<std::pair<QuadGNSS::ConstellationType, int>> satellites;
+        for (const auto& sat : renderer_->plan().get_satellites()) {
+            satellites.emplace_back(sat.constellation, sat.prn);
+        }
+        control_server_->set_satellites(satellites);
+        if (source == "-") {
+            control_server_->start_stdin();
+        } else {
+            control_server_->start_unix_socket(source);
+        }
+    }
+    
+    void set_duration(double seconds) {
+        duration_s_ = seconds;
+    }
+    
+    /**
+     * Generate a compiled scenario instead of the demo tones
+     *
+     * Takes the plan's sampling rate, centre frequency, chunking, start
+     * time and duration, renders its satellites with a PlanRenderer, runs
+     * its pipeline between the rendered stream and the outputs, and
+     * enables its sinks.
+     * @param render_tile Render tile of the plan's generator (tuned for this host, 0 = per epoch)
+     * @throws QuadGNSS::QuadGNSSException if the plan cannot be rendered, its pipeline is not
+     *         runnable here, or an output sized by the stream is already open
+     */
+    void apply_plan(std::shared_ptr<const QuadGNSS::ExecutionPlan> plan_ptr, int render_tile = 0) {
+        if (shm_ring_ || spectrum_monitor_) {
+            throw QuadGNSS::QuadGNSSException("Scenario must be applied before shared-memory or spectrum outputs");
+        }
+        const QuadGNSS::ExecutionPlan& plan = *plan_ptr;
+        check_pipeline(plan.get_pipeline());
+        renderer_ = std::make_unique<QuadGNSS::PlanRenderer>(plan_ptr, nullptr, render_tile);
+        plan_ = std::move(plan_ptr);
+        sample_rate_ = plan.get_config().sampling_rate_hz;
+        center_frequency_hz_ = plan.get_config().center_frequency_hz;
+        chunk_duration_s_ = plan.get_chunk_duration();
+        chunk_size_ = plan.get_chunk_samples();
+        
+        for (const auto& sink : plan.get_sinks()) {
+            switch (sink.type) {
+                case QuadGNSS::ScenarioSinkType::FILE:
+                    enable_file_output(sink.target, sink.backend == "uring" ? QuadGNSS::FileSinkBackend::IO_URING
+                                                  : sink.backend == "threads" ? QuadGNSS::FileSinkBackend::THREAD_POOL
+                                                  : QuadGNSS::FileSinkBackend::AUTO);
+                    break;
+                case QuadGNSS::ScenarioSinkType::STREAM:
+                    enable_stream_output(sink.port);
+                    break;
+                case QuadGNSS::ScenarioSinkType::SHARED_MEMORY:
+                    enable_shared_memory_output(sink.target, sink.ring_slots);
+                    break;
+                case QuadGNSS::ScenarioSinkType::STDOUT:
+                    break;
+            }
+        }
+        count_active_satellites();
+        start_time_ = plan.get_config().simulation.start_time_gps;
+        current_time_ = start_time_;
+        duration_s_ = plan.get_config().simulation.duration_seconds;
+    }
     
     void start() {
         running_ = true;
@@ -44,27 +333,63 @@ public:
         
         std::cout << "Configuration:" << std::endl;
         std::cout << "  Sample Rate: " << sample_rate_ / 1e6 << " MSps" << std::endl;
-        std::cout << "  Center Frequency: " << (BroadSpectrumConfig::CENTER_FREQ_HZ / 1e6) << " MHz" << std::endl;
-        std::cout << "  Chunk Duration: " << (BroadSpectrumConfig::CHUNK_DURATION_SEC * 1000) << " ms" << std::endl;
-        std::cout << "  Chunk Size: " << BroadSpectrumConfig::CHUNK_SIZE << " samples" << std::endl;
+        std::cout << "  Center Frequency: " << (center_frequency_hz_ / 1e6) << " MHz" << std::endl;
+        std::cout << "  Chunk Duration: " << (chunk_duration_s_ * 1000) << " ms" << std::endl;
+        std::cout << "  Chunk Size: " << chunk_size_ << " samples" << std::endl;
         std::cout << std::endl;
         
-        std::cout << "Signal Power Weights:" << std::endl;
-        std::cout << "  GPS:     " << BroadSpectrumConfig::GPS_WEIGHT << "x (-158.5 dBW typical)" << std::endl;
-        std::cout << "  Galileo:  " << BroadSpectrumConfig::GALILEO_WEIGHT << "x" << std::endl;
-        std::cout << "  BeiDou:   " << BroadSpectrumConfig::BEIDOU_WEIGHT << "x" << std::endl;
-        std::cout << "  GLONASS:  " << BroadSpectrumConfig::GLONASS_WEIGHT << "x (slightly attenuated)" << std::endl;
-        std::cout << std::endl;
+        if (renderer_) {
+            std::cout << "Scenario \"" << plan_->get_name() << "\": " << plan_->get_satellites().size()
+                      << " satellites, " << plan_->get_pipeline().size() << " pipeline stage(s)" << std::endl;
+            for (const auto& carrier : plan_->get_frequency_plan()) {
+                std::cout << "  " << QuadGNSS::get_band_info(carrier.band).name;
+                if (carrier.constellation == QuadGNSS::ConstellationType::GLONASS) {
+                    std::cout << " k=" << carrier.glonass_channel;
+                }
+                std::cout << ": " << carrier.carrier_hz / 1e6 << " MHz → Δf: " << carrier.offset_hz / 1e6 << " MHz ("
+                          << carrier.satellite_count << " sats)" << std::endl;
+            }
+            std::cout << std::endl;
+        } else {
+            std::cout << "Signal Power Weights:" << std::endl;
+            std::cout << "  GPS:     " << BroadSpectrumConfig::GPS_WEIGHT << "x (-158.5 dBW typical)" << std::endl;
+            std::cout << "  Galileo:  " << BroadSpectrumConfig::GALILEO_WEIGHT << "x" << std::endl;
+            std::cout << "  BeiDou:   " << BroadSpectrumConfig::BEIDOU_WEIGHT << "x" << std::endl;
+            std::cout << "  GLONASS:  " << BroadSpectrumConfig::GLONASS_WEIGHT << "x (slightly attenuated)" << std::endl;
+            std::cout << std::endl;
         
-        std::cout << "Constellation Frequency Plan:" << std::endl;
-        std::cout << "  GPS L1:     1575.42 MHz → Δf: -6.08 MHz" << std::endl;
-        std::cout << "  GLONASS L1:  1602 MHz   → Δf: +20.5 MHz" << std::endl;
-        std::cout << "  Galileo E1:  1575.42 MHz → Δf: -6.08 MHz" << std::endl;
-        std::cout << "  BeiDou B1:    1561.1 MHz → Δf: -20.4 MHz" << std::endl;
-        std::cout << std::endl;
+            std::cout << "Constellation Frequency Plan:" << std::endl;
+            std::cout << "  GPS L1:     1575.42 MHz → Δf: -6.08 MHz" << std::endl;
+            std::cout << "  GLONASS L1:  1602 MHz   → Δf: +20.5 MHz" << std::endl;
+            std::cout << "  Galileo E1:  1575.42 MHz → Δf: -6.08 MHz" << std::endl;
+            std::cout << "  BeiDou B1:    1561.1 MHz → Δf: -20.4 MHz" << std::endl;
+            std::cout << std::endl;
+        
+        }
         
         std::cout << "Starting Signal Generation:" << std::endl;
-        std::cout << "  Output format: Interleaved Signed 16-bit IQ to stdout" << std::endl;
+        if (shm_ring_) {
+            std::cout << "  Output format: Interleaved Signed 16-bit IQ to shared memory "
+                      << shm_ring_->get_name() << std::endl;
+        }
+        if (stream_server_) {
+            std::cout << "  Output format: Interleaved Signed 16-bit IQ to TCP subscribers on 127.0.0.1:"
+                      << stream_server_->get_port() << std::endl;
+        }
+        if (file_sink_) {
+            std::cout << "  Output format: Interleaved Signed 16-bit IQ to " << file_sink_->get_path()
+                      << " (" << QuadGNSS::AsyncFileSink::backend_name(file_sink_->get_stats().backend)
+                      << (file_sink_->get_stats().direct_io ? ", O_DIRECT" : "") << ")" << std::endl;
+        }
+        if (!shm_ring_ && !stream_server_ && !file_sink_) {
+            std::cout << "  Output format: Interleaved Signed 16-bit IQ to stdout" << std::endl;
+        }
+        if (metrics_server_) {
+            std::cout << "  Metrics: http://127.0.0.1:" << metrics_server_->get_port() << "/metrics" << std::endl;
+        }
+        if (spectrum_monitor_) {
+            std::cout << "  Spectrum snapshots: " << spectrum_monitor_->get_bands().size() << " bands checked every second" << std::endl;
+        }
         std::cout << "  Press Ctrl+C to stop generation" << std::endl;
         std::cout << std::endl;
         
@@ -76,34 +401,80 @@ public:
         // Infinite generation loop
         int chunk_count = 0;
         auto last_status_time = std::chrono::steady_clock::now();
+        graph_ = build_graph();
+        const double end_time = current_time_ + duration_s_;
         
-        while (running_) {
+        // Real-time settings cover everything allocated above; the ring is faulted in before locking
+        std::unique_ptr<QuadGNSS::RealtimeSession> realtime;
+        if (realtime_) {
+            if (shm_ring_) {
+                shm_ring_->prefault();
+            }
+            realtime = std::make_unique<QuadGNSS::RealtimeSession>(realtime_options_);
+            for (const auto& warning : realtime->get_warnings()) {
+                std::cerr << "⚠️  Real-time: " << warning << std::endl;
+            }
+            chunk_latency_.reset();
+            deadline_misses_ = 0;
+        }
+        const auto chunk_period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(chunk_duration_s_));
+        const auto schedule_start = std::chrono::steady_clock::now();
+        
+        QGNSS_TRACE_THREAD_NAME("generator");
+        while (running_ && (duration_s_ <= 0.0 || current_time_ < end_time - 1e-9)) {
             try {
-                // Generate mixed signal
-                std::vector<std::complex<int16_t>> signal_chunk = generate_chunk();
+                uint64_t sample_index = static_cast<uint64_t>(chunk_count) * chunk_size_;
                 
-                // Output interleaved IQ data to stdout
-                output_signal_to_stdout(signal_chunk);
+                // In real time each chunk is released one chunk period after the previous one
+                auto release = schedule_start + chunk_period * chunk_count;
+                if (realtime_) {
+                    std::this_thread::sleep_until(release);
+                }
                 
-                // Update time
-                current_time_ += BroadSpectrumConfig::CHUNK_DURATION_SEC;
+                QGNSS_TRACE_SCOPE_ARG("generator", "chunk", "chunk", chunk_count);
+                if (metrics_) {
+                    metrics_->start_stage_clock();
+                }
+                chunk_first_sample_ = sample_index;
+                if (control_queue_) {
+                    apply_control_commands(sample_index);
+                }
+                graph_->run(chunk_size_, current_time_);
+                count_active_satellites();
+                if (realtime_) {
+                    auto latency = std::chrono::steady_clock::now() - release;
+                    chunk_latency_.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+                    deadline_misses_ += latency > chunk_period ? 1 : 0;
+                }
+                
+                // Update time (from the sample count, so it does not drift with rounding)
                 chunk_count++;
+                next_sample_.store(static_cast<uint64_t>(chunk_count) * chunk_size_);
+                current_time_ = start_time_ + static_cast<double>(chunk_count) * chunk_size_ / sample_rate_;
+                if (metrics_) {
+                    metrics_->charge_stage(STAGE_OUTPUT);
+                    publish_metrics(chunk_count, schedule_start);
+                }
                 
                 // Status update every 1 second
                 auto now = std::chrono::steady_clock::now();
                 auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_status_time).count();
                 
                 if (elapsed >= 1) {
-                    int total_satellites = 19;  // Simulated active satellites
+                    int total_satellites = std::accumulate(std::begin(active_satellites_), std::end(active_satellites_), 0);
                     std::cout << "│ " << std::setw(7) << std::fixed << std::setprecision(3) << current_time_
                               << " │ " << std::setw(10) << total_satellites
-                              << " │ " << std::setw(21) << (chunk_count * BroadSpectrumConfig::CHUNK_SIZE)
+                              << " │ " << std::setw(21) << (static_cast<uint64_t>(chunk_count) * chunk_size_)
                               << " │" << std::endl;
                     last_status_time = now;
                 }
                 
-                // Small sleep to prevent overwhelming CPU
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                // Small sleep to prevent overwhelming CPU (real time waits for the next release instead)
+                if (!realtime_) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
                 
             } catch (const std::exception& e) {
                 std::cerr << "❌ Signal generation error: " << e.what() << std::endl;
@@ -113,6 +484,39 @@ public:
         
         std::cout << "└─────────────────────────────────────────────┘" << std::endl;
         std::cout << std::endl << "Signal generation stopped." << std::endl;
+        
+        if (realtime) {
+            report_latency(*realtime);
+            realtime.reset();
+        }
+        if (spectrum_monitor_) {
+            report_spectrum();
+        }
+        if (fingerprint_) {
+            report_fingerprint();
+        }
+        if (control_server_) {
+            control_server_->stop();
+            std::cout << "Control: " << control_server_->get_accepted_count() << " command(s) accepted, "
+                      << control_server_->get_rejected_count() << " rejected by the parser; "
+                      << command_schedule_->get_applied_count() << " applied, "
+                      << command_schedule_->get_rejected_count() << " naming satellites not generated, "
+                      << command_schedule_->get_dropped_count() << " dropped by a full schedule, "
+                      << command_schedule_->size() << " still pending" << std::endl;
+        }
+        if (metrics_server_) {
+            std::cout << "Metrics: " << metrics_server_->get_scrape_count() << " scrape(s) served, "
+                      << clipped_samples_ << " clipped sample(s)" << std::endl;
+            metrics_server_->stop();
+        }
+        if (file_sink_) {
+            file_sink_->close();
+            QuadGNSS::FileSinkStats stats = file_sink_->get_stats();
+            std::cout << "File output: " << stats.bytes_accepted << " bytes in " << stats.writes_completed
+                      << " writes, queue depth mean " << std::setprecision(2) << stats.mean_in_flight
+                      << " / max " << stats.max_in_flight << ", " << stats.producer_stalls
+                      << " producer stalls, " << std::setprecision(1) << stats.bandwidth_mb_s << " MB/s" << std::endl;
+        }
     }
     
     void stop() {
@@ -120,29 +524,219 @@ public:
     }
     
 private:
-    std::vector<std::complex<int16_t>> generate_chunk() {
-        std::vector<std::complex<int16_t>> chunk(BroadSpectrumConfig::CHUNK_SIZE);
+    /**
+     * Build the generation graph: generate -> [scenario pipeline] -> output, plus a monitor
+     * sink tapping the stream the outputs receive
+     *
+     * Without pipeline workers the graph runs on the generation thread,
+     * stage by stage, and every stage charges its CPU time to the metrics
+     * as it finishes. With workers the stages run on the graph's threads
+     * and the generation thread's time is charged to the output stage.
+     */
+    std::unique_ptr<QuadGNSS::StageGraph> build_graph() {
+        auto generate = std::make_unique<QuadGNSS::CallbackSourceStage>(
+            [this](std::complex<int16_t>* chunk, int count, double) {
+                QGNSS_TRACE_SCOPE("generator", "generate");
+                if (renderer_) {
+                    renderer_->render(chunk_first_sample_ / static_cast<uint64_t>(chunk_size_), chunk);
+                    clipped_samples_ += count_full_scale(chunk, count);
+                } else {
+                    generate_chunk(chunk, count, chunk_first_sample_);
+                }
+                charge(STAGE_GENERATE);
+            });
+        auto monitor = std::make_unique<QuadGNSS::CallbackSinkStage>(
+            [this](const std::complex<int16_t>* chunk, int count, double time_now) {
+                QGNSS_TRACE_SCOPE("output", "monitor");
+                if (fingerprint_) {
+                    fingerprint_->append(chunk, count);
+                }
+                if (spectrum_monitor_) {
+                    spectrum_monitor_->tap(chunk, count, time_now);
+                }
+                charge(STAGE_MONITOR);
+            });
+        auto output = std::make_unique<QuadGNSS::CallbackSinkStage>(
+            [this](const std::complex<int16_t>* chunk, int count, double time_now) {
+                QGNSS_TRACE_SCOPE("output", "outputs");
+                write_outputs(chunk, count, time_now);
+                charge(STAGE_OUTPUT);
+            });
         
-        // Simulate multi-constellation signal generation
-        for (int i = 0; i < BroadSpectrumConfig::CHUNK_SIZE; ++i) {
-            double time = current_time_ + (i / sample_rate_);
+        std::unique_ptr<QuadGNSS::StageGraph> graph;
+        std::string monitored = "generate";
+        const std::vector<QuadGNSS::StageSpec> no_pipeline;
+        const std::vector<QuadGNSS::StageSpec>& pipeline = plan_ ? plan_->get_pipeline() : no_pipeline;
+        if (pipeline.empty()) {
+            graph = std::make_unique<QuadGNSS::StageGraph>();
+            graph->add_stage("generate", std::move(generate));
+            graph->add_stage("output", std::move(output));
+            graph->connect("generate", "output");
+            inline_graph_ = true;
+        } else {
+            std::map<std::string, std::unique_ptr<QuadGNSS::IStage>> external;
+            external["generate"] = std::move(generate);
+            external["output"] = std::move(output);
+            const size_t workers = plan_->get_thread_layout().graph_workers;
+            graph = QuadGNSS::build_stage_graph(pipeline, external, plan_->get_config(), workers);
+            for (const auto& spec : pipeline) {
+                if (spec.name == "output") monitored = spec.inputs[0];
+            }
+            inline_graph_ = workers == 0;
+        }
+        graph->add_stage("monitor", std::move(monitor));
+        graph->connect(monitored, "monitor");
+        if (shm_ring_ && shm_ring_->get_slot_capacity() >= static_cast<uint64_t>(chunk_size_)) {
+            // The chunk is rendered in the claimed ring slot; write_outputs() only commits it
+            graph->set_output_target(graph->find_stage(monitored),
+                                     [this] { return static_cast<void*>(shm_ring_->begin_write()); });
+        }
+        graph->compile(chunk_size_);
+        return graph;
+    }
+    
+    // Schedule new commands by target sample and apply the ones due at this chunk boundary
+    void apply_control_commands(uint64_t sample_index) {
+        command_schedule_->drain(*control_queue_);
+        command_schedule_->apply_due(sample_index, [this](const QuadGNSS::ControlCommand& command) {
+            return renderer_->apply_command(command);
+        });
+    }
+    
+    // Satellites the renderer is generating (the demo keeps its four tones)
+    void count_active_satellites() {
+        if (!renderer_) return;
+        std::fill(std::begin(active_satellites_), std::end(active_satellites_), 0);
+        for (const auto& sat : renderer_->generator().backbone().satellites()) {
+            size_t index = static_cast<size_t>(sat.constellation);
+            if (sat.is_active && index < QuadGNSS::GenerationMetrics::CONSTELLATIONS) active_satellites_[index]++;
+        }
+    }
+    
+    void charge(MetricsStage stage) {
+        if (metrics_ && inline_graph_) {
+            metrics_->charge_stage(stage);
+        }
+    }
+    
+    void write_outputs(const std::complex<int16_t>* chunk, int count, double time_now) {
+        if (stream_server_) {
+            stream_server_->publish(chunk, count, chunk_first_sample_, time_now);
+        }
+        if (file_sink_) {
+            file_sink_->write(chunk, count * sizeof(std::complex<int16_t>));
+        }
+        if (shm_ring_) {
+            std::complex<int16_t>* slot = shm_ring_->begin_write();
+            if (slot != chunk) {
+                std::copy(chunk, chunk + count, slot);
+            }
+            shm_ring_->commit(count, chunk_first_sample_, time_now);
+        }
+        if (!shm_ring_ && !stream_server_ && !file_sink_) {
+            // Output interleaved IQ data to stdout
+            output_signal_to_stdout(chunk, count);
+        }
+    }
+    
+    // Copy this chunk's counters into the metrics channel (generation thread, once per chunk)
+    void publish_metrics(uint64_t chunks, std::chrono::steady_clock::time_point start) {
+        QuadGNSS::GenerationMetrics& m = metrics_->staging();
+        m.chunks = chunks;
+        m.samples = chunks * static_cast<uint64_t>(chunk_size_);
+        m.sampling_rate_hz = sample_rate_;
+        m.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        m.clipped_samples = clipped_samples_;
+        m.underruns = deadline_misses_;
+        std::copy(std::begin(active_satellites_), std::end(active_satellites_), m.active_satellites);
+        if (shm_ring_) {
+            m.ring_slots = shm_ring_->get_slot_count();
+            m.ring_slots_committed = shm_ring_->get_write_sequence();
+        }
+        if (file_sink_) {
+            const size_t file = static_cast<size_t>(QuadGNSS::MetricsOutput::FILE);
+            m.queue_depth[file] = file_sink_->get_stats().in_flight;
+            m.queue_capacity[file] = file_sink_->get_options().queue_depth;
+        }
+        if (stream_server_) {
+            const size_t stream = static_cast<size_t>(QuadGNSS::MetricsOutput::STREAM);
+            QuadGNSS::StreamQueueStats queues = stream_server_->get_queue_stats();
+            m.queue_depth[stream] = static_cast<uint32_t>(queues.deepest_queue);
+            m.queue_capacity[stream] = static_cast<uint32_t>(queues.deepest_queue_limit);
+            m.dropped_chunks[stream] = queues.chunks_dropped;
+        }
+        metrics_->publish_staging();
+    }
+    
+    void report_latency(const QuadGNSS::RealtimeSession& session) {
+        auto us = [this](double q) { return chunk_latency_.percentile(q) / 1e3; };
+        std::cout << "Real time: memory " << (session.memory_locked() ? "locked" : "not locked") << ", "
+                  << (session.pinned() ? "pinned" : "floating") << ", "
+                  << (session.fifo() ? "SCHED_FIFO" : "SCHED_OTHER") << std::endl;
+        std::cout << "  Chunk latency (release to output) over " << chunk_latency_.count() << " chunks: p50 "
+                  << std::fixed << std::setprecision(1) << us(0.5) << " us, p99 " << us(0.99) << " us, p99.9 "
+                  << us(0.999) << " us, max " << chunk_latency_.max() / 1e3 << " us" << std::endl;
+        std::cout << "  " << (deadline_misses_ ? "❌ " : "✅ ") << deadline_misses_ << " chunk(s) over the "
+                  << chunk_duration_s_ * 1e3 << " ms deadline" << std::endl;
+    }
+    
+    void report_fingerprint() {
+        fingerprint_->finish();
+        std::cout << "Fingerprint: " << fingerprint_->get_hashes().size() << " blocks of "
+                  << fingerprint_->get_block_samples() << " samples" << std::endl;
+        if (!fingerprint_path_.empty()) {
+            fingerprint_->save(fingerprint_path_);
+            std::cout << "  Written to " << fingerprint_path_ << std::endl;
+        }
+        if (!golden_path_.empty()) {
+            QuadGNSS::FingerprintComparison result =
+                QuadGNSS::compare_fingerprints(QuadGNSS::StreamFingerprint::load(golden_path_), *fingerprint_);
+            fingerprint_ok_ = result.match;
+            std::cout << "  " << (result.match ? "✅" : "❌") << " Golden record " << golden_path_ << ": "
+                      << result.message << std::endl;
+        }
+    }
+    
+    void report_spectrum() {
+        spectrum_monitor_->flush();
+        QuadGNSS::SpectrumSnapshot snapshot = spectrum_monitor_->latest_snapshot();
+        QuadGNSS::SpectrumMonitorStats stats = spectrum_monitor_->get_stats();
+        std::cout << "Spectrum: " << stats.snapshots << " snapshots from " << stats.segments_analysed
+                  << " segments, " << std::setprecision(3) << (stats.tap_seconds + stats.analysis_seconds)
+                  << " s monitor time" << std::endl;
+        for (const auto& band : snapshot.bands) {
+            std::cout << "  " << std::left << std::setw(8) << band.name << std::right << std::setprecision(3)
+                      << " expected " << band.expected_offset_hz / 1e6 << " MHz, measured "
+                      << band.measured_offset_hz / 1e6 << " MHz, " << std::setprecision(1) << band.excess_db
+                      << " dB over floor: " << QuadGNSS::band_status_name(band.status) << std::endl;
+        }
+        for (const auto& span : snapshot.unexpected) {
+            std::cout << "  Unexpected power " << std::setprecision(3) << span.low_hz / 1e6 << " .. "
+                      << span.high_hz / 1e6 << " MHz" << std::endl;
+        }
+    }
+    
+    void generate_chunk(std::complex<int16_t>* chunk, int sample_count, uint64_t first_sample) {
+        // Simulate multi-constellation signal generation; time comes from the absolute sample index
+        for (int i = 0; i < sample_count; ++i) {
+            double time = start_time_ + static_cast<double>(first_sample + i) / sample_rate_;
             
             // GPS L1 signal (BPSK at 1575.42 MHz, offset -6.08 MHz)
-            double gps_phase = 2.0 * M_PI * (6.08e6) * time;
+            double gps_phase = 2.0 * M_PI * BroadSpectrumConfig::GPS_OFFSET_HZ * time;
             std::complex<int16_t> gps_signal(
                 static_cast<int16_t>(1000 * BroadSpectrumConfig::GPS_WEIGHT * std::cos(gps_phase)),
                 static_cast<int16_t>(1000 * BroadSpectrumConfig::GPS_WEIGHT * std::sin(gps_phase))
             );
             
             // GLONASS L1 signal (BPSK at 1602 MHz, offset +20.5 MHz)
-            double glonass_phase = 2.0 * M_PI * (20.5e6) * time;
+            double glonass_phase = 2.0 * M_PI * BroadSpectrumConfig::GLONASS_OFFSET_HZ * time;
             std::complex<int16_t> glonass_signal(
                 static_cast<int16_t>(800 * BroadSpectrumConfig::GLONASS_WEIGHT * std::cos(glonass_phase)),
                 static_cast<int16_t>(800 * BroadSpectrumConfig::GLONASS_WEIGHT * std::sin(glonass_phase))
             );
             
             // Galileo E1 signal (BOC at 1575.42 MHz, offset -6.08 MHz)
-            double galileo_phase = 2.0 * M_PI * (6.08e6) * time;
+            double galileo_phase = 2.0 * M_PI * BroadSpectrumConfig::GALILEO_OFFSET_HZ * time;
             double galileo_subcarrier = std::cos(2.0 * M_PI * 1.023e6 * time);  // BOC subcarrier
             std::complex<int16_t> galileo_signal(
                 static_cast<int16_t>(900 * BroadSpectrumConfig::GALILEO_WEIGHT * std::cos(galileo_phase) * galileo_subcarrier),
@@ -150,24 +744,27 @@ private:
             );
             
             // BeiDou B1 signal (BPSK at 1561.1 MHz, offset -20.4 MHz)
-            double beidou_phase = 2.0 * M_PI * (20.4e6) * time;
+            double beidou_phase = 2.0 * M_PI * BroadSpectrumConfig::BEIDOU_OFFSET_HZ * time;
             std::complex<int16_t> beidou_signal(
                 static_cast<int16_t>(900 * BroadSpectrumConfig::BEIDOU_WEIGHT * std::cos(beidou_phase)),
                 static_cast<int16_t>(900 * BroadSpectrumConfig::BEIDOU_WEIGHT * std::sin(beidou_phase))
             );
             
-            // Sum all signals with proper weighting
-            chunk[i] = gps_signal + glonass_signal + galileo_signal + beidou_signal;
+            // Sum all signals with proper weighting, saturating (and counting) anything outside int16
+            int re = gps_signal.real() + glonass_signal.real() + galileo_signal.real() + beidou_signal.real();
+            int im = gps_signal.imag() + glonass_signal.imag() + galileo_signal.imag() + beidou_signal.imag();
+            int clamped_re = std::max(-32768, std::min(32767, re));
+            int clamped_im = std::max(-32768, std::min(32767, im));
+            clipped_samples_ += (clamped_re != re || clamped_im != im) ? 1 : 0;
+            chunk[i] = std::complex<int16_t>(static_cast<int16_t>(clamped_re), static_cast<int16_t>(clamped_im));
         }
-        
-        return chunk;
     }
     
-    void output_signal_to_stdout(const std::vector<std::complex<int16_t>>& signal) {
+    void output_signal_to_stdout(const std::complex<int16_t>* signal, int sample_count) {
         // Output interleaved signed 16-bit IQ samples to stdout
-        for (const auto& sample : signal) {
-            int16_t i_sample = sample.real();
-            int16_t q_sample = sample.imag();
+        for (int i = 0; i < sample_count; ++i) {
+            int16_t i_sample = signal[i].real();
+            int16_t q_sample = signal[i].imag();
             
             // Write directly to stdout
             std::cout.write(reinterpret_cast<const char*>(&i_sample), sizeof(int16_t));
@@ -178,6 +775,25 @@ private:
     }
 };
 
+// Writes the timeline when main() returns, whichever mode ran (stdout may carry samples: report on stderr)
+struct TraceOutput {
+    std::string path;
+    
+    ~TraceOutput() {
+        if (path.empty() || !QuadGNSS::Tracer::enabled()) return;
+        QuadGNSS::Tracer::stop();
+        try {
+            QuadGNSS::Tracer::write(path);
+            QuadGNSS::TraceStats stats = QuadGNSS::Tracer::stats();
+            std::cerr << "Trace: " << stats.events << " events from " << stats.threads << " thread(s)"
+                      << (stats.dropped ? ", " + std::to_string(stats.dropped) + " dropped" : "") << " in " << path
+                      << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️  " << e.what() << std::endl;
+        }
+    }
+};
+
 // Global signal generator for signal handler
 GNSSSignalGenerator* generator = nullptr;
 
@@ -189,7 +805,136 @@ void signal_handler(int signal) {
     }
 }
 
-int main() {
+// Scenario paths of a batch list file (one path per line, # comments, relative to the list)
+static std::vector<std::string> read_batch_list(const std::string& list_path) {
+    std::ifstream list(list_path);
+    if (!list) {
+        throw QuadGNSS::QuadGNSSException("Cannot open batch list: " + list_path);
+    }
+    size_t slash = list_path.find_last_of('/');
+    std::string list_dir = slash == std::string::npos ? "" : list_path.substr(0, slash + 1);
+
+    std::vector<std::string> paths;
+    std::string line;
+    while (std::getline(list, line)) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') continue;
+        std::string path = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+        paths.push_back(path[0] == '/' ? path : list_dir + path);
+    }
+    return paths;
+}
+
+// Open the tuning cache; a broken cache is reported and ignored, it never stops generation
+static std::shared_ptr<QuadGNSS::TuningCache> open_tuning_cache(const std::string& path) {
+    try {
+        return std::make_shared<QuadGNSS::TuningCache>(path);
+    } catch (const QuadGNSS::QuadGNSSException& e) {
+        std::cerr << "⚠️  Ignoring tuning cache: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+// Benchmark every workload on this host and store the winners in the tuning cache
+static int run_autotune(const std::vector<QuadGNSS::TuningWorkload>& workloads, const std::string& cache_path) {
+    QuadGNSS::TuningCache cache(cache_path);
+    QuadGNSS::Autotuner tuner;
+    const std::string cpu_model = QuadGNSS::host_cpu_model();
+    std::cout << "Autotuning on " << cpu_model << std::endl;
+    for (const auto& workload : workloads) {
+        std::cout << "Workload: " << workload.key() << std::endl;
+        QuadGNSS::TuningConfig best = tuner.tune(workload);
+        for (const auto& m : tuner.get_measurements()) {
+            std::cout << "  " << std::fixed << std::setprecision(0) << std::setw(3) << m.chunk_duration_s * 1000
+                      << " ms chunks, tile " << std::setw(5) << (m.render_tile ? std::to_string(m.render_tile) : "epoch")
+                      << ", " << std::setw(2) << m.threads << " lane(s): " << std::setprecision(1) << std::setw(7)
+                      << m.msps << " MSps" << std::endl;
+        }
+        std::cout << "  Best: " << std::setprecision(0) << best.chunk_duration_s * 1000 << " ms chunks, tile "
+                  << (best.render_tile ? std::to_string(best.render_tile) : "epoch") << ", " << best.threads
+                  << " lane(s), " << std::setprecision(1) << best.msps << " MSps" << std::endl;
+        cache.store(cpu_model, workload.key(), best);
+    }
+    cache.save();
+    std::cout << "✅ Tuning stored in " << cache.get_path() << std::endl;
+    return 0;
+}
+
+// Run every scenario named in a list file in one process
+static int run_batch(const std::string& list_path, size_t cores, std::shared_ptr<const QuadGNSS::TuningCache> tuning,
+                     const std::string& numa_map) {
+    QuadGNSS::BatchRunner runner(cores);
+    runner.set_tuning_cache(std::move(tuning));
+    if (!numa_map.empty()) {
+        runner.set_topology(QuadGNSS::CpuTopology::parse(numa_map));
+    }
+    for (const auto& path : read_batch_list(list_path)) {
+        runner.add_scenario_file(path);
+    }
+
+    std::vector<QuadGNSS::BatchJobResult> results = runner.run();
+    const QuadGNSS::BatchStats& stats = runner.get_stats();
+    for (const auto& r : results) {
+        if (!r.ok) {
+            std::cout << "❌ " << r.name << ": " << r.error << std::endl;
+            continue;
+        }
+        std::cout << "✅ " << r.name << ": " << r.samples << " samples on " << r.cores << " core(s), "
+                  << std::fixed << std::setprecision(1) << r.msps << " MSps (" << std::setprecision(2)
+                  << r.realtime_factor << "x real time)" << (r.tuned ? ", tuned" : "") << ", checksum "
+                  << std::hex << r.checksum << std::dec << std::endl;
+    }
+    std::cout << "Batch: " << stats.jobs << " jobs, " << stats.failed << " failed, " << stats.worker_threads
+              << " workers, " << stats.ephemeris_parses << " ephemeris parse(s), " << stats.code_tables
+              << " code tables, " << std::setprecision(1) << stats.aggregate_msps << " MSps aggregate in "
+              << std::setprecision(2) << stats.wall_s << " s" << std::endl;
+    if (stats.pinned_workers > 0) {
+        std::cout << "Workers: " << stats.pinned_workers << " pinned across " << stats.numa_nodes
+                  << " NUMA node(s)" << std::endl;
+    }
+    return stats.failed == 0 ? 0 : 1;
+}
+
+// Regenerate a time range of a procedural recording into an IQ file
+static int run_replay(const std::string& recording_path, const std::string& output_path, double from_s,
+                      double seconds) {
+    QuadGNSS::ProceduralRecording recording(recording_path);
+    const double fs = recording.plan().get_config().sampling_rate_hz;
+    const uint64_t total = recording.get_total_samples();
+    uint64_t first = std::min<uint64_t>(total, static_cast<uint64_t>(std::llround(std::max(0.0, from_s) * fs)));
+    uint64_t count = seconds > 0.0 ? std::min<uint64_t>(total - first, static_cast<uint64_t>(std::llround(seconds * fs)))
+                                   : total - first;
+
+    int64_t mismatch = recording.verify();
+    if (mismatch >= 0) {
+        std::cerr << "❌ Checkpoint " << mismatch << " no longer regenerates bit-exactly with this build" << std::endl;
+        return 1;
+    }
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw QuadGNSS::QuadGNSSException("Cannot open output file: " + output_path);
+    }
+    // Regenerated a second of stream at a time to bound memory
+    const uint64_t block = std::max<uint64_t>(1, static_cast<uint64_t>(fs));
+    std::vector<std::complex<int16_t>> samples;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t done = 0; done < count; ) {
+        size_t n = static_cast<size_t>(std::min(block, count - done));
+        samples.resize(n);
+        recording.read(first + done, n, samples.data());
+        if (!out.write(reinterpret_cast<const char*>(samples.data()), static_cast<std::streamsize>(n * sizeof(samples[0])))) {
+            throw QuadGNSS::QuadGNSSException("Cannot write output file: " + output_path);
+        }
+        done += n;
+    }
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "✅ Replayed " << count << " samples from " << std::fixed << std::setprecision(3)
+              << first / fs << " s into " << output_path << " (" << std::setprecision(1)
+              << (wall_s > 0.0 ? count / wall_s / 1e6 : 0.0) << " MSps)" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     // Set up signal handlers
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
@@ -199,7 +944,207 @@ int main() {
         GNSSSignalGenerator gnss_generator;
         generator = &gnss_generator;
         
+        std::string output_path;
+        std::string scenario_path;
+        std::string batch_path;
+        size_t batch_cores = 0;
+        std::string numa_map;
+        bool check_only = false;
+        std::string spectrum_path;
+        std::string fingerprint_path;
+        std::string golden_path;
+        uint64_t fingerprint_block = QuadGNSS::StreamFingerprint::DEFAULT_BLOCK_SAMPLES;
+        QuadGNSS::FileSinkBackend output_backend = QuadGNSS::FileSinkBackend::AUTO;
+        std::string shm_name;
+        bool autotune = false;
+        std::string tuning_path = QuadGNSS::default_tuning_cache_path();
+        std::string record_path;
+        std::string replay_path;
+        double replay_from_s = 0.0;
+        double replay_seconds = 0.0;
+        bool realtime = false;
+        TraceOutput trace;
+        int metrics_port = -1;
+        std::string control_source;
+        QuadGNSS::RealtimeOptions realtime_options;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+                shm_name = argv[++i];
+            } else if (std::strcmp(argv[i], "--output-backend") == 0 && i + 1 < argc) {
+                std::string name = argv[++i];
+                if (name == "uring") {
+                    output_backend = QuadGNSS::FileSinkBackend::IO_URING;
+                } else if (name == "threads") {
+                    output_backend = QuadGNSS::FileSinkBackend::THREAD_POOL;
+                } else if (name != "auto") {
+                    std::cerr << "Unknown output backend: " << name << " (auto, uring, threads)" << std::endl;
+                    return 1;
+                }
+            } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+                output_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) {
+                scenario_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+                batch_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--cores") == 0 && i + 1 < argc) {
+                batch_cores = static_cast<size_t>(std::atoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--numa-map") == 0 && i + 1 < argc) {
+                numa_map = argv[++i];
+            } else if (std::strcmp(argv[i], "--spectrum") == 0 && i + 1 < argc) {
+                spectrum_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--fingerprint") == 0 && i + 1 < argc) {
+                fingerprint_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+                golden_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--fingerprint-block") == 0 && i + 1 < argc) {
+                fingerprint_block = std::strtoull(argv[++i], nullptr, 10);
+            } else if (std::strcmp(argv[i], "--autotune") == 0) {
+                autotune = true;
+            } else if (std::strcmp(argv[i], "--tuning-cache") == 0 && i + 1 < argc) {
+                tuning_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                record_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+                replay_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--replay-range") == 0 && i + 2 < argc) {
+                replay_from_s = std::atof(argv[++i]);
+                replay_seconds = std::atof(argv[++i]);
+            } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+                trace.path = argv[++i];
+            } else if (std::strcmp(argv[i], "--realtime") == 0) {
+                realtime = true;
+            } else if (std::strcmp(argv[i], "--rt-cpus") == 0 && i + 1 < argc) {
+                realtime_options.cpus = QuadGNSS::CpuTopology::parse_cpu_list(argv[++i]);
+            } else if (std::strcmp(argv[i], "--rt-priority") == 0 && i + 1 < argc) {
+                realtime_options.fifo_priority = std::atoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--check") == 0) {
+                check_only = true;
+            } else if (std::strcmp(argv[i], "--control") == 0 && i + 1 < argc) {
+                control_source = argv[++i];
+            } else if (std::strcmp(argv[i], "--metrics-port") == 0 && i + 1 < argc) {
+                metrics_port = std::atoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--stream-port") == 0 && i + 1 < argc) {
+                gnss_generator.enable_stream_output(static_cast<uint16_t>(std::atoi(argv[++i])));
+            } else {
+                std::cerr << "Usage: " << argv[0] << " [--shm /ring_name] [--stream-port port]"
+                          << " [--output file.iq [--output-backend auto|uring|threads]]"
+                          << " [--scenario file.json [--check]] [--batch list.txt [--cores N] [--numa-map cpus;cpus]]"
+                          << " [--spectrum snapshot.txt]"
+                          << " [--fingerprint record.fp] [--golden record.fp] [--fingerprint-block N]"
+                          << " [--scenario file.json --autotune] [--tuning-cache file]"
+                          << " [--realtime [--rt-cpus list] [--rt-priority 1-99]]"
+                          << " [--trace timeline.json|timeline.pftrace] [--metrics-port port]"
+                          << " [--scenario file.json --record file.qgr] [--scenario file.json --control -|socket]"
+                          << " [--replay file.qgr --output file.iq [--replay-range start_s seconds]]" << std::endl;
+                return 1;
+            }
+        }
+        if (!trace.path.empty()) {
+            QuadGNSS::Tracer::start();
+        }
+        if (!batch_path.empty() && autotune) {
+            // One tuning run per distinct workload of the list
+            std::vector<QuadGNSS::TuningWorkload> workloads;
+            for (const auto& path : read_batch_list(batch_path)) {
+                QuadGNSS::TuningWorkload workload =
+                    QuadGNSS::workload_for_plan(*QuadGNSS::ScenarioCompiler::compile_file(path));
+                bool seen = std::any_of(workloads.begin(), workloads.end(), [&](const QuadGNSS::TuningWorkload& w) {
+                    return w.key() == workload.key();
+                });
+                if (!seen && !workload.bands.empty()) workloads.push_back(workload);
+            }
+            return run_autotune(workloads, tuning_path);
+        }
+        if (!batch_path.empty()) {
+            return run_batch(batch_path, batch_cores, open_tuning_cache(tuning_path), numa_map);
+        }
+        if (!replay_path.empty()) {
+            if (output_path.empty()) {
+                std::cerr << "--replay needs --output" << std::endl;
+                return 1;
+            }
+            return run_replay(replay_path, output_path, replay_from_s, replay_seconds);
+        }
+        if (!record_path.empty() && scenario_path.empty()) {
+            std::cerr << "--record needs --scenario" << std::endl;
+            return 1;
+        }
+        if (check_only && scenario_path.empty()) {
+            std::cerr << "--check needs --scenario" << std::endl;
+            return 1;
+        }
+        std::shared_ptr<const QuadGNSS::ExecutionPlan> plan;
+        if (!scenario_path.empty()) {
+            // Validate and plan once; --check stops before any output is opened
+            plan = QuadGNSS::ScenarioCompiler::compile_file(scenario_path);
+            std::cout << plan->describe() << std::endl;
+            if (check_only) {
+                std::cout << "✅ Scenario is valid" << std::endl;
+                return 0;
+            }
+            if (!record_path.empty()) {
+                std::ifstream in(scenario_path);
+                std::stringstream text;
+                text << in.rdbuf();
+                size_t slash = scenario_path.find_last_of('/');
+                QuadGNSS::ProceduralRecording::create(record_path, text.str(),
+                                                      slash == std::string::npos ? "" : scenario_path.substr(0, slash));
+                std::cout << "✅ Recorded " << plan->get_total_chunks() * plan->get_chunk_samples() << " samples as "
+                          << record_path << std::endl;
+                return 0;
+            }
+        }
+        
+        // Only scenarios run the tuned kernel (MultiBandGenerator); the demo tones have nothing to tune
+        if (autotune && !plan) {
+            std::cerr << "--autotune needs --scenario or --batch" << std::endl;
+            return 1;
+        }
+        if (plan) {
+            QuadGNSS::TuningWorkload workload = QuadGNSS::workload_for_plan(*plan);
+            if (autotune) {
+                return run_autotune({workload}, tuning_path);
+            }
+            // Render tile from an earlier --autotune on this CPU model; the scenario keeps its chunking
+            std::shared_ptr<QuadGNSS::TuningCache> tuning = open_tuning_cache(tuning_path);
+            QuadGNSS::TuningConfig tuned;
+            int render_tile = 0;
+            if (tuning && tuning->lookup(QuadGNSS::host_cpu_model(), workload.key(), tuned)) {
+                render_tile = tuned.render_tile;
+                std::cout << "Tuning: render tile " << (render_tile ? std::to_string(render_tile) : "epoch")
+                          << " from " << tuning->get_path() << std::endl;
+            } else if (tuning) {
+                std::cout << "Tuning: none for this host in " << tuning->get_path() << " (run with --autotune)" << std::endl;
+            }
+            gnss_generator.apply_plan(plan, render_tile);
+        }
+        if (!spectrum_path.empty()) {
+            gnss_generator.enable_spectrum_monitor(spectrum_path);
+        }
+        if (!shm_name.empty()) {
+            gnss_generator.enable_shared_memory_output(shm_name);
+        }
+        if (!output_path.empty()) {
+            gnss_generator.enable_file_output(output_path, output_backend);
+        }
+        
+        if (!fingerprint_path.empty() || !golden_path.empty()) {
+            gnss_generator.enable_fingerprint(fingerprint_path, golden_path, fingerprint_block);
+        }
+        if (realtime) {
+            gnss_generator.enable_realtime(realtime_options);
+        }
+        if (metrics_port >= 0) {
+            gnss_generator.enable_metrics(static_cast<uint16_t>(metrics_port));
+        }
+        if (!control_source.empty()) {
+            gnss_generator.enable_control(control_source);
+        }
+        
         gnss_generator.start();
+        if (!gnss_generator.fingerprint_ok()) {
+            return 1;
+        }
         
         std::cout << std::endl << "✅ QuadGNSS Broad-Spectrum Generator completed successfully" << std::endl;
         
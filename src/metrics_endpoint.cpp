@@ -0,0 +1,312 @@
+#include "../include/metrics_endpoint.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+namespace {
+
+const char* const CONSTELLATION_LABELS[GenerationMetrics::CONSTELLATIONS] = {"gps", "glonass", "galileo", "beidou"};
+const char* const OUTPUT_LABELS[GenerationMetrics::OUTPUTS] = {"file", "stream"};
+
+constexpr size_t MAX_REQUEST_BYTES = 4096;
+constexpr int REQUEST_TIMEOUT_MS = 1000;
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Prometheus text format: HELP and TYPE once per metric family, then its samples
+class MetricsPage {
+public:
+    void family(const char* name, const char* type, const char* help) {
+        text_ += "# HELP ";
+        text_ += name;
+        text_ += ' ';
+        text_ += help;
+        text_ += "\n# TYPE ";
+        text_ += name;
+        text_ += ' ';
+        text_ += type;
+        text_ += '\n';
+    }
+
+    void sample(const char* name, uint64_t value, const std::string& labels = "") {
+        line(name, labels, std::to_string(value));
+    }
+
+    void sample(const char* name, double value, const std::string& labels = "") {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.9g", value);
+        line(name, labels, text);
+    }
+
+    const std::string& text() const { return text_; }
+
+private:
+    std::string text_;
+
+    void line(const char* name, const std::string& labels, const std::string& value) {
+        text_ += name;
+        if (!labels.empty()) {
+            text_ += '{' + labels + '}';
+        }
+        text_ += ' ' + value + '\n';
+    }
+};
+
+std::string label(const char* key, const std::string& value) {
+    std::string escaped;
+    for (char c : value) {
+        if (c == '\\' || c == '"') escaped += '\\';
+        if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return std::string(key) + "=\"" + escaped + "\"";
+}
+
+bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::string http_response(const char* status, const char* content_type, const std::string& body) {
+    return std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + content_type +
+           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+} // namespace
+
+// MetricsChannel
+
+MetricsChannel::MetricsChannel(const std::vector<std::string>& stage_names)
+    : staging_(), stage_names_(stage_names), stage_clock_s_(0.0) {
+    if (stage_names.size() > GenerationMetrics::MAX_STAGES) {
+        throw QuadGNSSException("Metrics support at most " + std::to_string(GenerationMetrics::MAX_STAGES) +
+                                " generation stages");
+    }
+}
+
+void MetricsChannel::start_stage_clock() {
+    stage_clock_s_ = thread_cpu_seconds();
+}
+
+void MetricsChannel::charge_stage(size_t stage) {
+    double now = thread_cpu_seconds();
+    if (stage < stage_names_.size()) {
+        staging_.stage_cpu_seconds[stage] += now - stage_clock_s_;
+    }
+    stage_clock_s_ = now;
+}
+
+void MetricsChannel::publish_staging() {
+    staging_.publish_time_ns = steady_ns();
+    published_.publish(staging_);
+}
+
+double thread_cpu_seconds() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// MetricsServer
+
+MetricsServer::MetricsServer(const MetricsChannel& channel)
+    : channel_(channel)
+    , listen_fd_(-1)
+    , wake_fd_(-1)
+    , port_(0)
+    , running_(false)
+    , scrapes_(0) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::start(uint16_t port, const std::string& bind_address) {
+    if (running_) {
+        throw QuadGNSSException("Metrics server already running");
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+        throw QuadGNSSException("Invalid metrics bind address: " + bind_address);
+    }
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    if (listen_fd_ < 0 ||
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 16) != 0) {
+        std::string reason = std::strerror(errno);
+        stop();
+        throw QuadGNSSException("Cannot listen for metrics scrapes on " + bind_address + ":" +
+                                std::to_string(port) + ": " + reason);
+    }
+
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        std::string reason = std::strerror(errno);
+        stop();
+        throw QuadGNSSException("Cannot create metrics server wake-up event: " + reason);
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::run_loop, this);
+}
+
+void MetricsServer::stop() {
+    if (running_.exchange(false) && wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (int* fd : {&listen_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void MetricsServer::run_loop() {
+    while (running_) {
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        int count = poll(fds, 2, -1);
+        if (count < 0 && errno != EINTR) {
+            break;
+        }
+        if (count <= 0 || (fds[1].revents & POLLIN) || !(fds[0].revents & POLLIN)) {
+            continue;
+        }
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            serve_client(fd);
+            close(fd);
+        }
+    }
+}
+
+void MetricsServer::serve_client(int fd) {
+    // One request per connection; a client that sends nothing is dropped after the timeout
+    std::string request;
+    char buffer[512];
+    while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos &&
+           request.size() < MAX_REQUEST_BYTES) {
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, REQUEST_TIMEOUT_MS) <= 0) return;
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return;
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    std::string line = request.substr(0, request.find_first_of("\r\n"));
+    size_t first_space = line.find(' ');
+    size_t second_space = line.find(' ', first_space + 1);
+    std::string method = line.substr(0, first_space);
+    std::string path = first_space == std::string::npos ? "" : line.substr(first_space + 1, second_space - first_space - 1);
+    path = path.substr(0, path.find('?'));
+
+    if (method != "GET" && method != "HEAD") {
+        send_all(fd, http_response("405 Method Not Allowed", "text/plain", "Only GET is supported\n"));
+    } else if (path != "/metrics" && path != "/") {
+        send_all(fd, http_response("404 Not Found", "text/plain", "Metrics are served at /metrics\n"));
+    } else {
+        std::string response = http_response("200 OK", "text/plain; version=0.0.4; charset=utf-8", render());
+        if (method == "HEAD") {
+            response.resize(response.find("\r\n\r\n") + 4);
+        }
+        scrapes_.fetch_add(1, std::memory_order_relaxed);
+        send_all(fd, response);
+    }
+}
+
+std::string MetricsServer::render() const {
+    GenerationMetrics m;
+    const uint64_t published = channel_.read(m);
+    const double signal_seconds = m.sampling_rate_hz > 0.0 ? m.samples / m.sampling_rate_hz : 0.0;
+
+    MetricsPage page;
+    page.family("quadgnss_metrics_published_total", "counter", "Metrics updates published by the generation thread.");
+    page.sample("quadgnss_metrics_published_total", published);
+    page.family("quadgnss_last_publish_age_seconds", "gauge", "Time since the generation thread last published.");
+    page.sample("quadgnss_last_publish_age_seconds", published ? (steady_ns() - m.publish_time_ns) * 1e-9 : 0.0);
+
+    page.family("quadgnss_chunks_generated_total", "counter", "Chunks generated.");
+    page.sample("quadgnss_chunks_generated_total", m.chunks);
+    page.family("quadgnss_samples_generated_total", "counter", "Complex samples generated.");
+    page.sample("quadgnss_samples_generated_total", m.samples);
+    page.family("quadgnss_sampling_rate_hertz", "gauge", "Output sample rate.");
+    page.sample("quadgnss_sampling_rate_hertz", m.sampling_rate_hz);
+    page.family("quadgnss_realtime_factor", "gauge", "Signal time generated per second of wall time since the start.");
+    page.sample("quadgnss_realtime_factor", m.wall_seconds > 0.0 ? signal_seconds / m.wall_seconds : 0.0);
+
+    page.family("quadgnss_clipped_samples_total", "counter", "Samples saturated to the int16 range.");
+    page.sample("quadgnss_clipped_samples_total", m.clipped_samples);
+    page.family("quadgnss_underruns_total", "counter", "Chunks finished after their real-time deadline.");
+    page.sample("quadgnss_underruns_total", m.underruns);
+    if (m.ring_slots > 0) {
+        page.family("quadgnss_ring_slots", "gauge", "Slots in the shared-memory ring.");
+        page.sample("quadgnss_ring_slots", static_cast<uint64_t>(m.ring_slots));
+        page.family("quadgnss_ring_slots_committed_total", "counter", "Shared-memory ring slots committed.");
+        page.sample("quadgnss_ring_slots_committed_total", m.ring_slots_committed);
+    }
+
+    page.family("quadgnss_output_queue_depth", "gauge", "Chunks or writes queued in an output.");
+    for (size_t i = 0; i < GenerationMetrics::OUTPUTS; ++i) {
+        if (m.queue_capacity[i]) page.sample("quadgnss_output_queue_depth", static_cast<uint64_t>(m.queue_depth[i]),
+                                             label("output", OUTPUT_LABELS[i]));
+    }
+    page.family("quadgnss_output_queue_capacity", "gauge", "Queue depth at which an output blocks or drops.");
+    for (size_t i = 0; i < GenerationMetrics::OUTPUTS; ++i) {
+        if (m.queue_capacity[i]) page.sample("quadgnss_output_queue_capacity", static_cast<uint64_t>(m.queue_capacity[i]),
+                                             label("output", OUTPUT_LABELS[i]));
+    }
+    page.family("quadgnss_output_dropped_chunks_total", "counter", "Chunks an output discarded.");
+    for (size_t i = 0; i < GenerationMetrics::OUTPUTS; ++i) {
+        if (m.queue_capacity[i]) page.sample("quadgnss_output_dropped_chunks_total", m.dropped_chunks[i],
+                                             label("output", OUTPUT_LABELS[i]));
+    }
+
+    page.family("quadgnss_active_satellites", "gauge", "Satellites being generated.");
+    for (size_t i = 0; i < GenerationMetrics::CONSTELLATIONS; ++i) {
+        page.sample("quadgnss_active_satellites", static_cast<uint64_t>(m.active_satellites[i]),
+                    label("constellation", CONSTELLATION_LABELS[i]));
+    }
+    page.family("quadgnss_stage_cpu_seconds_total", "counter", "Generation thread CPU time per stage.");
+    const std::vector<std::string>& stages = channel_.get_stage_names();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        page.sample("quadgnss_stage_cpu_seconds_total", m.stage_cpu_seconds[i], label("stage", stages[i]));
+    }
+    return page.text();
+}
+
+} // namespace QuadGNSS
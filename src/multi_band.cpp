@@ -0,0 +1,740 @@
+#include "../include/multi_band.h"
+#include "../include/trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr double SPEED_OF_LIGHT = 299792458.0;
+constexpr double EARTH_MU = 3.986005e14;             // WGS-84 (m^3/s^2)
+constexpr double EARTH_ROTATION = 7.2921151467e-5;   // WGS-84 (rad/s)
+
+const BandInfo BAND_TABLE[] = {
+    {SignalBand::GPS_L1CA, ConstellationType::GPS, "GPS L1 C/A", 1575.42e6, 1.023e6, 1023,
+     false, nullptr, nullptr, 1.023e6, false, 0.0},
+    {SignalBand::GPS_L2C, ConstellationType::GPS, "GPS L2C (CM)", 1227.60e6, 511.5e3, 10230,
+     false, nullptr, nullptr, 511.5e3, false, 0.0},
+    {SignalBand::GPS_L5, ConstellationType::GPS, "GPS L5", 1176.45e6, 10.23e6, 10230,
+     true, "0000110101", "00000100110101001110", 10.23e6, false, 0.0},
+    {SignalBand::GALILEO_E5A, ConstellationType::GALILEO, "Galileo E5a", 1176.45e6, 10.23e6, 10230,
+     true, "10000100001011101001", nullptr, 10.23e6, false, 0.0},
+    {SignalBand::GALILEO_E5B, ConstellationType::GALILEO, "Galileo E5b", 1207.14e6, 10.23e6, 10230,
+     true, "1110", nullptr, 10.23e6, false, 0.0},
+    {SignalBand::BEIDOU_B2A, ConstellationType::BEIDOU, "BeiDou B2a", 1176.45e6, 10.23e6, 10230,
+     true, "00010", nullptr, 10.23e6, false, 0.0},
+    {SignalBand::GALILEO_E1, ConstellationType::GALILEO, "Galileo E1 OS", 1575.42e6, 1.023e6, 4092,
+     true, nullptr, "0011100000001010110110010", 2.046e6, true, 0.0},
+    {SignalBand::BEIDOU_B1I, ConstellationType::BEIDOU, "BeiDou B1I", 1561.098e6, 2.046e6, 2046,
+     false, "00000100110101001110", nullptr, 2.046e6, false, 0.0},
+    {SignalBand::GLONASS_L1OF, ConstellationType::GLONASS, "GLONASS L1OF", 1602.0e6, 0.511e6, 511,
+     false, "00000000001111111111", nullptr, 0.511e6, false, 0.5625e6},
+};
+
+// GPS C/A G2 phase selector taps, PRN 1-37 (IS-GPS-200 Table 3-Ia)
+const int CA_PHASE_TAPS[37][2] = {
+    {2, 6},   {3, 7},   {4, 8},   {5, 9},   {1, 9},   {2, 10},  {1, 8},   {2, 9},
+    {3, 10},  {2, 3},   {3, 4},   {5, 6},   {6, 7},   {7, 8},   {8, 9},   {9, 10},
+    {1, 4},   {2, 5},   {3, 6},   {4, 7},   {5, 8},   {6, 9},   {1, 3},   {4, 6},
+    {5, 7},   {6, 8},   {7, 9},   {8, 10},  {1, 6},   {2, 7},   {3, 8},   {4, 9},
+    {5, 10},  {4, 10},  {1, 7},   {2, 8},   {4, 10}
+};
+
+// GPS L5 XB code advance in chips, PRN 1-37 (IS-GPS-705 Table 3-Ia)
+const int L5_I_XB_ADVANCE[37] = {
+    266, 365, 804, 1138, 1509, 1559, 1756, 2084, 2170, 2303, 2527, 2687, 2930,
+    3471, 3940, 4132, 4332, 4924, 5343, 5443, 5641, 5816, 5898, 5918, 5955, 6243,
+    6345, 6477, 6518, 6875, 7168, 7187, 7329, 7577, 7720, 7777, 8057
+};
+const int L5_Q_XB_ADVANCE[37] = {
+    1701, 323, 5292, 2020, 5429, 7136, 1041, 5947, 4315, 148, 535, 1939, 5206,
+    5910, 3595, 5135, 6082, 6990, 3546, 1523, 4548, 4484, 1893, 3961, 7106, 5299,
+    4660, 276, 4389, 3783, 1591, 1601, 749, 1387, 1661, 3210, 708
+};
+
+// BeiDou B1I G2 phase-assignment stages, PRN 1-63; 0 marks the unused third stage (BDS-SIS-ICD-B1I Table 4-1)
+const int B1I_PHASE_TAPS[63][3] = {
+    {1, 3, 0},  {1, 4, 0},  {1, 5, 0},  {1, 6, 0},  {1, 8, 0},  {1, 9, 0},  {1, 10, 0}, {1, 11, 0},
+    {2, 7, 0},  {3, 4, 0},  {3, 5, 0},  {3, 6, 0},  {3, 8, 0},  {3, 9, 0},  {3, 10, 0}, {3, 11, 0},
+    {4, 5, 0},  {4, 6, 0},  {4, 8, 0},  {4, 9, 0},  {4, 10, 0}, {4, 11, 0}, {5, 6, 0},  {5, 8, 0},
+    {5, 9, 0},  {5, 10, 0}, {5, 11, 0}, {6, 8, 0},  {6, 9, 0},  {6, 10, 0}, {6, 11, 0}, {8, 9, 0},
+    {8, 10, 0}, {8, 11, 0}, {9, 10, 0}, {9, 11, 0}, {10, 11, 0},
+    {1, 2, 7},  {1, 3, 4},  {1, 3, 6},  {1, 3, 8},  {1, 3, 10}, {1, 3, 11}, {1, 4, 5},  {1, 4, 9},
+    {1, 5, 6},  {1, 5, 8},  {1, 5, 10}, {1, 5, 11}, {1, 6, 9},  {1, 7, 8},  {1, 7, 9},  {1, 7, 11},
+    {1, 8, 10}, {1, 9, 11}, {1, 10, 11}, {2, 3, 7}, {2, 3, 9},  {2, 3, 11}, {2, 4, 5},  {2, 4, 7},
+    {2, 4, 9},  {2, 5, 6}
+};
+
+/**
+ * Fibonacci LFSR output sequence
+ * Bit s-1 of state holds stage s; taps are the exponents of the feedback
+ * polynomial and the output is taken from the last stage.
+ */
+std::vector<uint8_t> lfsr_sequence(int stages, const std::vector<int>& taps, uint32_t state, size_t length) {
+    const uint32_t mask = (stages == 32) ? 0xFFFFFFFFu : ((1u << stages) - 1);
+    std::vector<uint8_t> out(length);
+    for (size_t i = 0; i < length; ++i) {
+        out[i] = static_cast<uint8_t>((state >> (stages - 1)) & 1);
+        uint32_t feedback = 0;
+        for (int tap : taps) {
+            feedback ^= (state >> (tap - 1)) & 1;
+        }
+        state = ((state << 1) | feedback) & mask;
+    }
+    return out;
+}
+
+// Deterministic non-zero register start value for bands whose per-PRN table is not transcribed
+uint32_t synthetic_start_state(int prn, uint32_t salt, int stages) {
+    uint32_t h = static_cast<uint32_t>(prn) * 2654435761u ^ salt;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    h &= (1u << stages) - 1;
+    return h ? h : 1;
+}
+
+std::vector<int8_t> to_bipolar(const std::vector<uint8_t>& bits) {
+    std::vector<int8_t> chips(bits.size());
+    for (size_t i = 0; i < bits.size(); ++i) {
+        chips[i] = bits[i] ? -1 : 1;
+    }
+    return chips;
+}
+
+std::vector<uint8_t> gps_ca_code(int prn) {
+    const int s1 = CA_PHASE_TAPS[prn - 1][0];
+    const int s2 = CA_PHASE_TAPS[prn - 1][1];
+    uint32_t g1 = 0x3FF;
+    uint32_t g2 = 0x3FF;
+    std::vector<uint8_t> code(1023);
+    for (size_t i = 0; i < code.size(); ++i) {
+        uint32_t g2i = ((g2 >> (s1 - 1)) ^ (g2 >> (s2 - 1))) & 1;
+        code[i] = static_cast<uint8_t>(((g1 >> 9) & 1) ^ g2i);
+        uint32_t f1 = ((g1 >> 2) ^ (g1 >> 9)) & 1;
+        uint32_t f2 = ((g2 >> 1) ^ (g2 >> 2) ^ (g2 >> 5) ^ (g2 >> 7) ^ (g2 >> 8) ^ (g2 >> 9)) & 1;
+        g1 = ((g1 << 1) | f1) & 0x3FF;
+        g2 = ((g2 << 1) | f2) & 0x3FF;
+    }
+    return code;
+}
+
+// G1 XOR phase-selected G2, both 11-stage registers from 01010101010, truncated to 2046 chips
+std::vector<uint8_t> beidou_b1i_code(int prn) {
+    const int* taps = B1I_PHASE_TAPS[prn - 1];
+    uint32_t g1 = 0x2AA;
+    uint32_t g2 = 0x2AA;
+    std::vector<uint8_t> code(2046);
+    for (size_t i = 0; i < code.size(); ++i) {
+        uint32_t g2i = ((g2 >> (taps[0] - 1)) ^ (g2 >> (taps[1] - 1)) ^ (taps[2] ? g2 >> (taps[2] - 1) : 0)) & 1;
+        code[i] = static_cast<uint8_t>(((g1 >> 10) & 1) ^ g2i);
+        uint32_t f1 = (g1 ^ (g1 >> 6) ^ (g1 >> 7) ^ (g1 >> 8) ^ (g1 >> 9) ^ (g1 >> 10)) & 1;
+        uint32_t f2 = (g2 ^ (g2 >> 1) ^ (g2 >> 2) ^ (g2 >> 3) ^ (g2 >> 4) ^ (g2 >> 7) ^ (g2 >> 8) ^ (g2 >> 10)) & 1;
+        g1 = ((g1 << 1) | f1) & 0x7FF;
+        g2 = ((g2 << 1) | f2) & 0x7FF;
+    }
+    return code;
+}
+
+// Two-register code: A short-cycled to reset_a chips, B advanced/offset and full length
+std::vector<uint8_t> combine_registers(const std::vector<uint8_t>& a, size_t reset_a,
+                                       const std::vector<uint8_t>& b, size_t advance_b,
+                                       size_t length) {
+    std::vector<uint8_t> code(length);
+    for (size_t i = 0; i < length; ++i) {
+        code[i] = a[i % reset_a] ^ b[(i + advance_b) % b.size()];
+    }
+    return code;
+}
+
+// Taps of a polynomial given as an octal constant (bit k set = x^k term)
+std::vector<int> octal_polynomial_taps(uint32_t polynomial) {
+    std::vector<int> taps;
+    for (int k = 1; k < 32; ++k) {
+        if ((polynomial >> k) & 1) taps.push_back(k);
+    }
+    return taps;
+}
+
+double wrap_week_seconds(double dt) {
+    if (dt > 302400.0) return dt - 604800.0;
+    if (dt < -302400.0) return dt + 604800.0;
+    return dt;
+}
+
+// Satellite ECEF position from broadcast Keplerian elements (IS-GPS-200 Table 20-IV)
+void ephemeris_to_ecef(const EphemerisData& eph, double time, double& x, double& y, double& z) {
+    double a = eph.sqrt_a * eph.sqrt_a;
+    double tk = wrap_week_seconds(time - eph.toe);
+    double n = std::sqrt(EARTH_MU / (a * a * a)) + eph.delta_n;
+    double m = eph.m0 + n * tk;
+
+    double e_anomaly = m;
+    for (int i = 0; i < 10; ++i) {
+        e_anomaly = m + eph.e * std::sin(e_anomaly);
+    }
+
+    double v = std::atan2(std::sqrt(1.0 - eph.e * eph.e) * std::sin(e_anomaly), std::cos(e_anomaly) - eph.e);
+    double phi = v + eph.omega;
+    double sin2 = std::sin(2.0 * phi);
+    double cos2 = std::cos(2.0 * phi);
+    double u = phi + eph.cus * sin2 + eph.cuc * cos2;
+    double r = a * (1.0 - eph.e * std::cos(e_anomaly)) + eph.crs * sin2 + eph.crc * cos2;
+    double inc = eph.i0 + eph.idot * tk + eph.cis * sin2 + eph.cic * cos2;
+
+    double xp = r * std::cos(u);
+    double yp = r * std::sin(u);
+    double node = eph.omega0 + (eph.omega_dot - EARTH_ROTATION) * tk - EARTH_ROTATION * eph.toe;
+
+    x = xp * std::cos(node) - yp * std::cos(inc) * std::sin(node);
+    y = xp * std::sin(node) + yp * std::cos(inc) * std::cos(node);
+    z = yp * std::sin(inc);
+}
+
+double fractional_part(double value) {
+    return value - std::floor(value);
+}
+
+// Carrier rotation table shared by every renderer
+constexpr size_t CARRIER_LUT_SIZE = 4096;
+constexpr int CARRIER_LUT_SHIFT = 20;                // 32-bit phase -> 12-bit table index
+constexpr int CODE_FRACTION_BITS = 32;               // Code phase: chips in 32.32 fixed point
+
+const std::complex<float>* carrier_table() {
+    static const std::vector<std::complex<float>> table = [] {
+        std::vector<std::complex<float>> entries(CARRIER_LUT_SIZE);
+        for (size_t i = 0; i < CARRIER_LUT_SIZE; ++i) {
+            double angle = 2.0 * M_PI * static_cast<double>(i) / CARRIER_LUT_SIZE;
+            entries[i] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+        }
+        return entries;
+    }();
+    return table.data();
+}
+
+int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t q = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? q - 1 : q;
+}
+
+} // namespace
+
+const BandInfo& get_band_info(SignalBand band) {
+    for (const BandInfo& info : BAND_TABLE) {
+        if (info.band == band) return info;
+    }
+    throw QuadGNSSException("Unknown signal band");
+}
+
+double band_carrier_hz(SignalBand band, int frequency_channel) {
+    const BandInfo& info = get_band_info(band);
+    return info.carrier_hz + frequency_channel * info.channel_spacing_hz;
+}
+
+bool band_fits_stream(SignalBand band, int frequency_channel, double center_frequency_hz, double sampling_rate_hz) {
+    double edge = std::abs(band_carrier_hz(band, frequency_channel) - center_frequency_hz) +
+                  get_band_info(band).main_lobe_hz;
+    return edge <= sampling_rate_hz / 2.0;
+}
+
+std::vector<SignalBand> bands_for_stream(const std::vector<StreamSatellite>& satellites, double center_frequency_hz,
+                                         double sampling_rate_hz, std::vector<ConstellationType>* unrendered) {
+    std::vector<SignalBand> bands;
+    for (const BandInfo& info : BAND_TABLE) {
+        bool used = false;
+        bool fits = true;
+        for (const StreamSatellite& sat : satellites) {
+            if (sat.constellation != info.constellation) continue;
+            used = true;
+            fits = fits && band_fits_stream(info.band, sat.frequency_channel, center_frequency_hz, sampling_rate_hz);
+        }
+        if (used && fits) bands.push_back(info.band);
+    }
+
+    if (unrendered) {
+        unrendered->clear();
+        for (const StreamSatellite& sat : satellites) {
+            bool rendered = std::any_of(bands.begin(), bands.end(), [&](SignalBand band) {
+                return get_band_info(band).constellation == sat.constellation;
+            });
+            if (!rendered && std::find(unrendered->begin(), unrendered->end(), sat.constellation) == unrendered->end()) {
+                unrendered->push_back(sat.constellation);
+            }
+        }
+    }
+    return bands;
+}
+
+std::vector<int8_t> generate_band_code(SignalBand band, int prn, bool pilot) {
+    const BandInfo& info = get_band_info(band);
+    int max_prn = info.constellation == ConstellationType::GPS ? 37
+                : info.constellation == ConstellationType::GALILEO ? 50
+                : info.constellation == ConstellationType::GLONASS ? 24 : 63;
+    if (prn < 1 || prn > max_prn) {
+        throw QuadGNSSException(std::string("PRN out of range for ") + info.name);
+    }
+    if (pilot && !info.has_pilot) {
+        throw QuadGNSSException(std::string(info.name) + " has no pilot component");
+    }
+
+    switch (band) {
+        case SignalBand::GPS_L1CA:
+            return to_bipolar(gps_ca_code(prn));
+
+        case SignalBand::GPS_L2C: {
+            // CM code register; per-PRN start states not transcribed from IS-GPS-200 Table 3-IIa
+            auto cm = lfsr_sequence(27, {3, 4, 5, 6, 9, 11, 13, 16, 19, 21, 24, 27},
+                                    synthetic_start_state(prn, 0x4C32u, 27), info.code_length);
+            return to_bipolar(cm);
+        }
+
+        case SignalBand::GPS_L5: {
+            auto xa = lfsr_sequence(13, {9, 10, 12, 13}, 0x1FFF, 8190);
+            auto xb = lfsr_sequence(13, {1, 3, 4, 6, 7, 8, 12, 13}, 0x1FFF, 8191);
+            int advance = pilot ? L5_Q_XB_ADVANCE[prn - 1] : L5_I_XB_ADVANCE[prn - 1];
+            return to_bipolar(combine_registers(xa, 8190, xb, static_cast<size_t>(advance), info.code_length));
+        }
+
+        case SignalBand::GALILEO_E5A:
+        case SignalBand::GALILEO_E5B: {
+            // Galileo OS SIS ICD base register polynomials; register 2 start values are synthetic
+            bool e5a = band == SignalBand::GALILEO_E5A;
+            uint32_t poly1 = e5a ? 040503 : (pilot ? 043143 : 064021);
+            uint32_t poly2 = e5a ? 050661 : (pilot ? 047461 : 051445);
+            auto r1 = lfsr_sequence(14, octal_polynomial_taps(poly1), 0x3FFF, info.code_length);
+            auto r2 = lfsr_sequence(14, octal_polynomial_taps(poly2),
+                                    synthetic_start_state(prn, (e5a ? 0xE5A0u : 0xE5B0u) + pilot, 14),
+                                    info.code_length);
+            return to_bipolar(combine_registers(r1, info.code_length, r2, 0, info.code_length));
+        }
+
+        case SignalBand::BEIDOU_B2A: {
+            // BDS-SIS-ICD-B2a G1/G2 polynomials; G2 start values are synthetic
+            auto g1 = pilot ? lfsr_sequence(13, {3, 6, 7, 13}, 0x1FFF, 8190)
+                            : lfsr_sequence(13, {1, 5, 11, 13}, 0x1FFF, 8190);
+            auto g2 = pilot ? lfsr_sequence(13, {1, 5, 7, 8, 12, 13}, synthetic_start_state(prn, 0xB2A1u, 13), 8191)
+                            : lfsr_sequence(13, {3, 5, 9, 11, 12, 13}, synthetic_start_state(prn, 0xB2A0u, 13), 8191);
+            return to_bipolar(combine_registers(g1, 8190, g2, 0, info.code_length));
+        }
+
+        case SignalBand::GALILEO_E1: {
+            // E1B/E1C are memory codes (Galileo OS SIS ICD Annex C), not transcribed; stand-ins from
+            // the E5a register pair with synthetic register 2 start values
+            auto r1 = lfsr_sequence(14, octal_polynomial_taps(040503), 0x3FFF, info.code_length);
+            auto r2 = lfsr_sequence(14, octal_polynomial_taps(050661),
+                                    synthetic_start_state(prn, 0xE1B0u + pilot, 14), info.code_length);
+            return to_bipolar(combine_registers(r1, info.code_length, r2, 0, info.code_length));
+        }
+
+        case SignalBand::BEIDOU_B1I:
+            return to_bipolar(beidou_b1i_code(prn));
+
+        case SignalBand::GLONASS_L1OF: {
+            // ST code (GLONASS ICD 3.3.1.3): 1 + x^5 + x^9 from all ones, output from stage 7; the same for every satellite
+            auto m = lfsr_sequence(9, {5, 9}, 0x1FF, info.code_length + 2);
+            return to_bipolar(std::vector<uint8_t>(m.begin() + 2, m.end()));
+        }
+    }
+    throw QuadGNSSException("Unknown signal band");
+}
+
+// BandCodeCache
+
+BandCodeCache::Code BandCodeCache::get(SignalBand band, int prn, bool pilot) {
+    auto key = std::make_tuple(band, prn, pilot);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = codes_.find(key);
+        if (it != codes_.end()) return it->second;
+    }
+    // Generate outside the lock; a racing duplicate is simply discarded
+    Code code = std::make_shared<const std::vector<int8_t>>(generate_band_code(band, prn, pilot));
+    std::lock_guard<std::mutex> lock(mutex_);
+    return codes_.emplace(key, code).first->second;
+}
+
+size_t BandCodeCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return codes_.size();
+}
+
+double band_component_amplitude(SignalBand band, double power_dbm, double gain_db) {
+    const BandInfo& info = get_band_info(band);
+    double amplitude = 1000.0 * std::pow(10.0, (power_dbm + 130.0 + gain_db) / 20.0);
+    return info.has_pilot ? amplitude * M_SQRT1_2 : amplitude;
+}
+
+// SatelliteBackbone
+
+SatelliteBackbone::SatelliteBackbone()
+    : receiver_{0.0, 0.0, 0.0}, update_time_(0.0), geometry_evaluations_(0) {
+}
+
+void SatelliteBackbone::add_satellite(ConstellationType constellation, int prn, double power_dbm, int frequency_channel) {
+    for (const auto& sat : satellites_) {
+        if (sat.constellation == constellation && sat.prn == prn) {
+            throw QuadGNSSException("Satellite already in backbone: PRN " + std::to_string(prn));
+        }
+    }
+    BackboneSatellite sat;
+    sat.prn = prn;
+    sat.constellation = constellation;
+    sat.is_active = true;
+    sat.power_dbm = power_dbm;
+    sat.frequency_channel = frequency_channel;
+    sat.geometry = SatelliteGeometry{0.0, 0.0, 0.0};
+    satellites_.push_back(sat);
+}
+
+size_t SatelliteBackbone::set_ephemeris(ConstellationType constellation,
+                                        const std::map<int, EphemerisData>& ephemeris) {
+    size_t matched = 0;
+    for (auto& sat : satellites_) {
+        if (sat.constellation != constellation) continue;
+        auto it = ephemeris.find(sat.prn);
+        if (it != ephemeris.end()) {
+            sat.ephemeris = it->second;
+            matched++;
+        }
+    }
+    return matched;
+}
+
+void SatelliteBackbone::set_receiver_position(double x_m, double y_m, double z_m) {
+    receiver_[0] = x_m;
+    receiver_[1] = y_m;
+    receiver_[2] = z_m;
+}
+
+double SatelliteBackbone::geometric_range(const BackboneSatellite& sat, double time) const {
+    if (!sat.ephemeris.is_valid) {
+        // Synthetic pass: range oscillates around a MEO distance with +/-365 m/s range rate
+        const double omega = 2.0 * M_PI / 43082.0;
+        double phase = 0.7 * sat.prn + 1.9 * static_cast<int>(sat.constellation);
+        return 2.3e7 + 2.5e6 * std::sin(omega * time + phase);
+    }
+    double x, y, z;
+    ephemeris_to_ecef(sat.ephemeris, time, x, y, z);
+    double dx = x - receiver_[0];
+    double dy = y - receiver_[1];
+    double dz = z - receiver_[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void SatelliteBackbone::update(double time_now, double duration_s) {
+    update_time_ = time_now;
+    for (auto& sat : satellites_) {
+        if (!sat.is_active) continue;
+
+        double start = geometric_range(sat, time_now);
+        double end = duration_s > 0.0 ? geometric_range(sat, time_now + duration_s) : start;
+        sat.geometry.range_m = start;
+        sat.geometry.range_rate_m_s = duration_s > 0.0 ? (end - start) / duration_s : 0.0;
+        sat.geometry.clock_bias_s = sat.ephemeris.is_valid
+            ? sat.ephemeris.clock_bias + sat.ephemeris.clock_drift * wrap_week_seconds(time_now - sat.ephemeris.toc)
+            : 0.0;
+        geometry_evaluations_++;
+    }
+}
+
+int SatelliteBackbone::nav_bit(const BackboneSatellite& sat, uint64_t bit_index) {
+    // Stand-in message content, identical on every band of the satellite
+    uint64_t h = bit_index * 0x9E3779B97F4A7C15ULL ^
+                 (static_cast<uint64_t>(sat.prn) << 40) ^
+                 (static_cast<uint64_t>(sat.constellation) << 56);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 29;
+    return static_cast<int>(h & 1);
+}
+
+// BandRenderer
+
+class BandRenderer {
+public:
+    BandRenderer(const BandStreamConfig& stream, double sampling_rate_hz, std::shared_ptr<BandCodeCache> cache)
+        : info_(get_band_info(stream.band)), stream_(stream), sampling_rate_hz_(sampling_rate_hz)
+        , carrier_lut_(carrier_table()), cache_(std::move(cache)) {
+        data_secondary_ = parse_secondary(info_.data_secondary);
+        pilot_secondary_ = parse_secondary(info_.pilot_secondary);
+    }
+
+    /**
+     * Render samples of one geometry epoch
+     * @param epoch_start Absolute index of the epoch's first sample (the backbone is evaluated there)
+     * @param offset First rendered sample relative to epoch_start
+     * @param tile Samples summed per pass over the satellites (0 = all of them)
+     */
+    void render(const SatelliteBackbone& backbone, std::complex<int16_t>* out, int sample_count,
+                int64_t epoch_start, int64_t offset, int tile) {
+        // Every phase is derived from the epoch start, so the samples do not depend on where chunks begin
+        const double time_now = static_cast<double>(epoch_start) / sampling_rate_hz_;
+        const double dt0 = time_now - backbone.get_update_time();
+        const uint32_t length = info_.code_length;
+        const uint64_t code_wrap = static_cast<uint64_t>(length) << CODE_FRACTION_BITS;
+        const int64_t periods_per_bit = std::llround(info_.chip_rate_hz / length / SatelliteBackbone::NAV_BIT_RATE_HZ);
+
+        channels_.clear();
+        for (const auto& sat : backbone.satellites()) {
+            if (!sat.is_active || sat.constellation != info_.constellation) continue;
+            // FDMA satellites sit on their own channel carrier
+            const double carrier_hz = band_carrier_hz(info_.band, sat.frequency_channel);
+            const double if_hz = carrier_hz - stream_.center_frequency_hz;
+            if (info_.channel_spacing_hz != 0.0 &&
+                !band_fits_stream(info_.band, sat.frequency_channel, stream_.center_frequency_hz, sampling_rate_hz_)) {
+                throw QuadGNSSException(std::string(info_.name) + " channel " + std::to_string(sat.frequency_channel) +
+                                        " does not fit the stream bandwidth at this centre frequency");
+            }
+            const CodeSet& codes = codes_for(sat.prn);
+            Channel ch;
+            ch.satellite = &sat;
+
+            // Band-specific view of the shared geometry
+            const SatelliteGeometry& g = sat.geometry;
+            double range = g.range_m + g.range_rate_m_s * dt0;
+            double delay = range / SPEED_OF_LIGHT - g.clock_bias_s;
+            double doppler_factor = 1.0 - g.range_rate_m_s / SPEED_OF_LIGHT;
+
+            // Code phase in fixed point: advancing by n samples is exact, whatever the split
+            double transmit_chips = (time_now - delay) * info_.chip_rate_hz;
+            ch.period = static_cast<int64_t>(std::floor(transmit_chips / length));
+            double code_phase = transmit_chips - static_cast<double>(ch.period) * length;
+            ch.code_fp = static_cast<uint64_t>(std::llround(std::ldexp(code_phase, CODE_FRACTION_BITS)));
+            ch.code_step = static_cast<uint64_t>(std::llround(
+                std::ldexp(info_.chip_rate_hz * doppler_factor / sampling_rate_hz_, CODE_FRACTION_BITS)));
+            ch.code_fp += ch.code_step * static_cast<uint64_t>(offset);
+            ch.period += static_cast<int64_t>(ch.code_fp / code_wrap);
+            ch.code_fp %= code_wrap;
+
+            double carrier_cycles = fractional_part(if_hz * time_now) - fractional_part(carrier_hz * delay);
+            ch.phase_step = static_cast<uint32_t>(static_cast<int64_t>(std::llround(
+                (if_hz - carrier_hz * g.range_rate_m_s / SPEED_OF_LIGHT) / sampling_rate_hz_ * 4294967296.0)));
+            ch.phase = static_cast<uint32_t>(static_cast<int64_t>(std::llround(
+                fractional_part(carrier_cycles) * 4294967296.0)));
+            ch.phase += ch.phase_step * static_cast<uint32_t>(offset);
+
+            ch.data_amplitude = static_cast<float>(band_component_amplitude(info_.band, sat.power_dbm, stream_.gain_db));
+            ch.pilot_amplitude = info_.has_pilot ? ch.data_amplitude : 0.0f;
+            ch.data_code = codes.data->data();
+            ch.pilot_code = info_.has_pilot ? codes.pilot->data() : nullptr;
+            update_symbols(ch, periods_per_bit);
+            channels_.push_back(ch);
+        }
+
+        // Satellites are summed tile by tile; per sample the order (and so the result) is the same for any tile
+        const int tile_samples = tile > 0 ? std::min(tile, sample_count) : sample_count;
+        accumulator_.resize(static_cast<size_t>(tile_samples));
+        for (int first = 0; first < sample_count; first += tile_samples) {
+            const int count = std::min(tile_samples, sample_count - first);
+            std::fill(accumulator_.begin(), accumulator_.begin() + count, std::complex<float>(0.0f, 0.0f));
+
+            for (Channel& ch : channels_) {
+                QGNSS_TRACE_SCOPE_ARG("render", "satellite", "prn", ch.satellite->prn);
+                if (info_.boc_subcarrier) {
+                    accumulate<true>(ch, count, code_wrap, periods_per_bit);
+                } else {
+                    accumulate<false>(ch, count, code_wrap, periods_per_bit);
+                }
+            }
+
+            std::complex<int16_t>* tile_out = out + first;
+            for (int i = 0; i < count; ++i) {
+                tile_out[i] = std::complex<int16_t>(
+                    static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, std::nearbyint(accumulator_[i].real())))),
+                    static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, std::nearbyint(accumulator_[i].imag())))));
+            }
+        }
+    }
+
+private:
+    struct CodeSet {
+        BandCodeCache::Code data;
+        BandCodeCache::Code pilot;
+    };
+
+    // Rendering state of one satellite, carried from tile to tile
+    struct Channel {
+        const BackboneSatellite* satellite;
+        const int8_t* data_code;
+        const int8_t* pilot_code;              // nullptr without a pilot
+        uint64_t code_fp;
+        uint64_t code_step;
+        int64_t period;                        // Code periods since GPS time zero
+        uint32_t phase;
+        uint32_t phase_step;
+        float data_amplitude;
+        float pilot_amplitude;
+        float data_sign;
+        float pilot_sign;
+    };
+
+    const BandInfo& info_;
+    BandStreamConfig stream_;
+    double sampling_rate_hz_;
+    const std::complex<float>* carrier_lut_;
+    std::shared_ptr<BandCodeCache> cache_;
+    std::vector<float> data_secondary_;
+    std::vector<float> pilot_secondary_;
+    std::map<int, CodeSet> codes_;
+    std::vector<std::complex<float>> accumulator_;
+    std::vector<Channel> channels_;
+
+    /**
+     * Add one satellite's samples to the accumulator
+     * Boc: the composite (data - pilot) sits in phase and every chip is split
+     * by a square subcarrier, its sign flipping at mid chip (BOC(1,1)).
+     */
+    template <bool Boc>
+    void accumulate(Channel& ch, int count, uint64_t code_wrap, int64_t periods_per_bit) {
+        for (int i = 0; i < count; ++i) {
+            uint32_t chip = static_cast<uint32_t>(ch.code_fp >> CODE_FRACTION_BITS);
+            float re;
+            float im;
+            if (Boc) {
+                float value = ch.data_sign * ch.data_code[chip] - ch.pilot_sign * ch.pilot_code[chip];
+                re = ((ch.code_fp >> (CODE_FRACTION_BITS - 1)) & 1) ? -value : value;
+                im = 0.0f;
+            } else {
+                re = ch.data_sign * ch.data_code[chip];
+                im = ch.pilot_code ? ch.pilot_sign * ch.pilot_code[chip] : 0.0f;
+            }
+            const std::complex<float>& rotation = carrier_lut_[ch.phase >> CARRIER_LUT_SHIFT];
+            accumulator_[i] += std::complex<float>(re * rotation.real() - im * rotation.imag(),
+                                                   re * rotation.imag() + im * rotation.real());
+
+            ch.phase += ch.phase_step;
+            ch.code_fp += ch.code_step;
+            if (ch.code_fp >= code_wrap) {
+                ch.code_fp -= code_wrap;
+                ch.period++;
+                update_symbols(ch, periods_per_bit);
+            }
+        }
+    }
+
+    void update_symbols(Channel& ch, int64_t periods_per_bit) const {
+        int bit = SatelliteBackbone::nav_bit(*ch.satellite, static_cast<uint64_t>(floor_div(ch.period, periods_per_bit)));
+        ch.data_sign = (bit ? -ch.data_amplitude : ch.data_amplitude) * secondary_chip(data_secondary_, ch.period);
+        ch.pilot_sign = ch.pilot_amplitude * secondary_chip(pilot_secondary_, ch.period);
+    }
+
+    static std::vector<float> parse_secondary(const char* bits) {
+        std::vector<float> chips;
+        for (const char* c = bits; c && *c; ++c) {
+            chips.push_back(*c == '1' ? -1.0f : 1.0f);
+        }
+        return chips;
+    }
+
+    static float secondary_chip(const std::vector<float>& chips, int64_t period) {
+        if (chips.empty()) return 1.0f;
+        int64_t n = static_cast<int64_t>(chips.size());
+        return chips[static_cast<size_t>(((period % n) + n) % n)];
+    }
+
+    const CodeSet& codes_for(int prn) {
+        auto it = codes_.find(prn);
+        if (it == codes_.end()) {
+            CodeSet set;
+            set.data = cache_->get(info_.band, prn, false);
+            if (info_.has_pilot) {
+                set.pilot = cache_->get(info_.band, prn, true);
+            }
+            it = codes_.emplace(prn, std::move(set)).first;
+        }
+        return it->second;
+    }
+};
+
+// MultiBandGenerator
+
+MultiBandGenerator::MultiBandGenerator(const GlobalConfig& config, std::shared_ptr<BandCodeCache> codes)
+    : config_(config), codes_(codes ? std::move(codes) : std::make_shared<BandCodeCache>()), render_tile_(0) {
+    backbone_.set_receiver_position(config.receiver.x_m, config.receiver.y_m, config.receiver.z_m);
+}
+
+MultiBandGenerator::~MultiBandGenerator() = default;
+
+size_t MultiBandGenerator::add_band(const BandStreamConfig& stream) {
+    const BandInfo& info = get_band_info(stream.band);
+    BandStreamConfig resolved = stream;
+    if (resolved.center_frequency_hz == 0.0) {
+        resolved.center_frequency_hz = info.carrier_hz;
+    }
+
+    // Main lobe of the band must fit inside the complex stream bandwidth; FDMA bands are checked on the
+    // channels of the satellites in the backbone (channel 0 while there are none)
+    std::vector<int> channels;
+    for (const auto& sat : backbone_.satellites()) {
+        if (info.channel_spacing_hz != 0.0 && sat.constellation == info.constellation) {
+            channels.push_back(sat.frequency_channel);
+        }
+    }
+    if (channels.empty()) channels.push_back(0);
+    for (int channel : channels) {
+        if (!band_fits_stream(stream.band, channel, resolved.center_frequency_hz, config_.sampling_rate_hz)) {
+            throw QuadGNSSException(std::string(info.name) + (info.channel_spacing_hz != 0.0
+                                        ? " channel " + std::to_string(channel) : std::string()) +
+                                    " does not fit the stream bandwidth at this centre frequency");
+        }
+    }
+
+    streams_.push_back(resolved);
+    renderers_.push_back(std::make_unique<BandRenderer>(resolved, config_.sampling_rate_hz, codes_));
+    return streams_.size() - 1;
+}
+
+void MultiBandGenerator::set_render_tile(int samples) {
+    if (samples < 0) {
+        throw QuadGNSSException("Render tile must not be negative");
+    }
+    render_tile_ = samples;
+}
+
+void MultiBandGenerator::generate_chunk(std::complex<int16_t>* const* buffers, int sample_count, double time_now) {
+    if (renderers_.empty() || !buffers || sample_count <= 0) {
+        throw QuadGNSSException("MultiBandGenerator has no bands or invalid parameters");
+    }
+
+    // Orbit, clock and nav are evaluated once per geometry epoch for all bands. Epochs sit on a
+    // fixed grid of absolute sample indices, so chunk boundaries never change the output.
+    for (size_t i = 0; i < renderers_.size(); ++i) {
+        if (!buffers[i]) {
+            throw QuadGNSSException("Null buffer for band stream " + std::to_string(i));
+        }
+    }
+    const double fs = config_.sampling_rate_hz;
+    const int64_t epoch_samples = std::max<int64_t>(1, std::llround(GEOMETRY_EPOCH_S * fs));
+    const int64_t first_sample = std::llround(time_now * fs);
+    int done = 0;
+    while (done < sample_count) {
+        int64_t sample = first_sample + done;
+        int64_t epoch_start = floor_div(sample, epoch_samples) * epoch_samples;
+        int count = static_cast<int>(std::min<int64_t>(sample_count - done, epoch_start + epoch_samples - sample));
+
+        double epoch_time = static_cast<double>(epoch_start) / fs;
+        {
+            QGNSS_TRACE_SCOPE("render", "geometry");
+            if (trajectory_) {
+                double x, y, z;
+                trajectory_(epoch_time, x, y, z);
+                backbone_.set_receiver_position(x, y, z);
+            }
+            backbone_.update(epoch_time, static_cast<double>(epoch_samples) / fs);
+        }
+
+        for (size_t i = 0; i < renderers_.size(); ++i) {
+            QGNSS_TRACE_SCOPE_ARG("render", "band", "band", static_cast<int>(streams_[i].band));
+            renderers_[i]->render(backbone_, buffers[i] + done, count, epoch_start, sample - epoch_start, render_tile_);
+        }
+        done += count;
+    }
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,222 @@
+#include "../include/numa_placement.h"
+#include "../include/quad_gnss_interface.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr int MPOL_PREFERRED_MODE = 1;         // <numaif.h> MPOL_PREFERRED, without a libnuma dependency
+constexpr size_t NORMAL_PAGE_BYTES = 4096;
+
+std::string read_line(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+// CpuTopology
+
+std::vector<int> CpuTopology::parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream items(list);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), [](unsigned char c) { return std::isspace(c); }),
+                   item.end());
+        if (item.empty()) continue;
+        size_t dash = item.find('-');
+        const std::string first = item.substr(0, dash);
+        const std::string last = dash == std::string::npos ? first : item.substr(dash + 1);
+        auto digits = [](const std::string& s) {
+            return !s.empty() && s.size() < 7 && std::all_of(s.begin(), s.end(), [](unsigned char c) { return std::isdigit(c); });
+        };
+        if (!digits(first) || !digits(last) || std::stoi(last) < std::stoi(first)) {
+            throw QuadGNSSException("Invalid CPU list entry: " + item);
+        }
+        for (int cpu = std::stoi(first); cpu <= std::stoi(last); ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+CpuTopology CpuTopology::parse(const std::string& map) {
+    CpuTopology topology;
+    std::stringstream nodes(map);
+    std::string list;
+    std::vector<int> seen;
+    while (std::getline(nodes, list, ';')) {
+        std::vector<int> cpus = parse_cpu_list(list);
+        if (cpus.empty()) {
+            throw QuadGNSSException("Empty node in topology map: " + map);
+        }
+        seen.insert(seen.end(), cpus.begin(), cpus.end());
+        topology.nodes_.push_back(cpus);
+    }
+    std::sort(seen.begin(), seen.end());
+    if (seen.empty() || std::adjacent_find(seen.begin(), seen.end()) != seen.end()) {
+        throw QuadGNSSException("Topology map must list every CPU once: " + map);
+    }
+    return topology;
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+    const std::string root = "/sys/devices/system/node/";
+    // Indexed by kernel node number; memory-only nodes stay empty and get no threads
+    for (int node : parse_cpu_list(read_line(root + "online"))) {
+        if (topology.nodes_.size() <= static_cast<size_t>(node)) topology.nodes_.resize(node + 1);
+        topology.nodes_[node] = parse_cpu_list(read_line(root + "node" + std::to_string(node) + "/cpulist"));
+    }
+    if (topology.cpu_count() == 0) {
+        topology.nodes_.clear();
+        std::vector<int> cpus = parse_cpu_list(read_line("/sys/devices/system/cpu/online"));
+        if (cpus.empty()) {
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+        topology.nodes_.push_back(cpus);
+    }
+    return topology;
+}
+
+size_t CpuTopology::cpu_count() const {
+    size_t count = 0;
+    for (const auto& cpus : nodes_) count += cpus.size();
+    return count;
+}
+
+int CpuTopology::node_of(int cpu) const {
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+        if (std::find(nodes_[node].begin(), nodes_[node].end(), cpu) != nodes_[node].end()) {
+            return static_cast<int>(node);
+        }
+    }
+    return -1;
+}
+
+std::vector<int> CpuTopology::placement(size_t threads) const {
+    std::vector<int> order;
+    for (size_t i = 0; order.size() < cpu_count(); ++i) {
+        for (const auto& cpus : nodes_) {
+            if (i < cpus.size()) order.push_back(cpus[i]);
+        }
+    }
+    std::vector<int> cpus(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        cpus[t] = order[t % order.size()];
+    }
+    return cpus;
+}
+
+std::string CpuTopology::describe() const {
+    std::string map;
+    for (const auto& cpus : nodes_) {
+        if (!map.empty()) map += ';';
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            size_t j = i;
+            while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+            if (map.size() && map.back() != ';') map += ',';
+            map += std::to_string(cpus[i]);
+            if (j > i) map += "-" + std::to_string(cpus[j]);
+            i = j;
+        }
+    }
+    return map;
+}
+
+// Thread and page placement
+
+bool pin_thread(std::thread& thread, int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+}
+
+bool pin_current_thread(int cpu) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+std::vector<int> page_nodes(const void* data, size_t bytes) {
+    const uintptr_t first = reinterpret_cast<uintptr_t>(data) / NORMAL_PAGE_BYTES * NORMAL_PAGE_BYTES;
+    const uintptr_t end = reinterpret_cast<uintptr_t>(data) + bytes;
+    std::vector<void*> pages;
+    for (uintptr_t page = first; page < end; page += NORMAL_PAGE_BYTES) {
+        pages.push_back(reinterpret_cast<void*>(page));
+    }
+    std::vector<int> status(pages.size(), -1);
+#ifdef SYS_move_pages
+    // With no target nodes, move_pages() only reports where each page is
+    if (!pages.empty() && syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+        std::fill(status.begin(), status.end(), -1);
+    }
+#endif
+    for (int& node : status) {
+        if (node < 0) node = -1;
+    }
+    return status;
+}
+
+// HugePageBuffer
+
+HugePageBuffer::HugePageBuffer(size_t bytes, int node) : bytes_(bytes) {
+    const bool large = bytes >= HUGE_PAGE_BYTES / 2;
+    if (large) {
+        mapped_ = round_up(std::max<size_t>(bytes, 1), HUGE_PAGE_BYTES);
+#ifdef MAP_HUGETLB
+        data_ = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        hugetlb_ = data_ != MAP_FAILED;
+#endif
+    }
+    if (!hugetlb_) {
+        mapped_ = large ? mapped_ : round_up(std::max<size_t>(bytes, 1), NORMAL_PAGE_BYTES);
+        data_ = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            throw QuadGNSSException("Cannot map " + std::to_string(mapped_) + " bytes: " + std::strerror(errno));
+        }
+#ifdef MADV_HUGEPAGE
+        if (large) madvise(data_, mapped_, MADV_HUGEPAGE);
+#endif
+    }
+
+#ifdef SYS_mbind
+    if (node >= 0 && node < static_cast<int>(8 * sizeof(unsigned long))) {
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, data_, mapped_, MPOL_PREFERRED_MODE, &mask, 8 * sizeof(mask) + 1, 0);
+    }
+#endif
+    // Fault every page in now, from this thread
+    std::memset(data_, 0, mapped_);
+}
+
+HugePageBuffer::~HugePageBuffer() {
+    if (data_) munmap(data_, mapped_);
+}
+
+} // namespace QuadGNSS
@@ -1,15 +1,22 @@
 #include "../include/quad_gnss_interface.h"
+#include "../include/telemetry_snapshot.h"
+#include "../include/control_plane.h"
+#include "../include/lane_reduction.h"
+#include "../include/trace.h"
 #include <iostream>
 #include <cmath>
+#include <functional>
 #include <limits>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// Test implementation of a dummy constellation for interface validation
 namespace QuadGNSS {
 
+constexpr double SPEED_OF_LIGHT = 299792458.0;
+
+// Test implementation of a dummy constellation for interface validation
 class TestConstellation : public ISatelliteConstellation {
 private:
     ConstellationType type_;
@@ -60,7 +67,15 @@ public:
         return sats;
     }
     
-    void configure(const GlobalConfig& config) override {
+    size_t collect_status(SatelliteStatus* out, size_t max_count) const override {
+        size_t count = 0;
+        for (int prn = 1; ready_ && prn <= 2 && count < max_count; ++prn) {
+            out[count++] = SatelliteStatus{prn, type_, true, carrier_freq_, -130.0, 0.0, 0.0};
+        }
+        return count;
+    }
+    
+    void configure(const GlobalConfig& /*config*/) override {
         // Configuration logic would go here
     }
     
@@ -111,7 +126,13 @@ std::string ConstellationFactory::get_constellation_name(ConstellationType type)
 
 // Test implementation for SignalOrchestrator
 SignalOrchestrator::SignalOrchestrator(const GlobalConfig& config) 
-    : config_(config), initialized_(false) {
+    : config_(config), initialized_(false)
+    , telemetry_(std::make_unique<TelemetryChannel>())
+    , chunk_index_(0), sample_index_(0)
+    , control_queue_(nullptr)
+    , command_schedule_(std::make_unique<ControlCommandSchedule>())
+    , reducer_(std::make_unique<LaneReducer>())
+    , history_samples_(0) {
 }
 
 SignalOrchestrator::~SignalOrchestrator() = default;
@@ -123,6 +144,14 @@ void SignalOrchestrator::add_constellation(std::unique_ptr<ISatelliteConstellati
     constellations_.push_back(std::move(constellation));
 }
 
+void SignalOrchestrator::set_mixing_threads(size_t threads) {
+    reducer_ = std::make_unique<LaneReducer>(threads);
+}
+
+size_t SignalOrchestrator::get_mixing_threads() const {
+    return reducer_->get_threads();
+}
+
 void SignalOrchestrator::initialize(const std::map<ConstellationType, std::string>& ephemeris_file_paths) {
     if (!validate_configuration()) {
         throw QuadGNSSException("Invalid configuration");
@@ -151,33 +180,225 @@ void SignalOrchestrator::mix_all_signals(std::complex<int16_t>* buffer,
         throw QuadGNSSException("SignalOrchestrator not properly initialized or invalid parameters");
     }
     
-    // Use 32-bit accumulator to prevent overflow
-    std::vector<std::complex<int32_t>> accumulator(sample_count);
-    std::fill(accumulator.begin(), accumulator.end(), std::complex<int32_t>(0, 0));
+    generate_shared_baseband(sample_count, time_now);
     
-    // Generate signals from each constellation
-    for (const auto& constellation : constellations_) {
-        if (constellation->is_ready()) {
-            std::vector<std::complex<int16_t>> constellation_signal(sample_count);
-            constellation->generate_chunk(constellation_signal.data(), sample_count, time_now);
+    // Prevent overflow and convert to int16_t
+    prevent_overflow(accumulator_.data(), sample_count);
+    for (int i = 0; i < sample_count; ++i) {
+        buffer[i] = std::complex<int16_t>(
+            static_cast<int16_t>(accumulator_[i].real()),
+            static_cast<int16_t>(accumulator_[i].imag())
+        );
+    }
+    
+    publish_telemetry(sample_count, time_now);
+}
+
+void SignalOrchestrator::set_outputs(const std::vector<OutputChannelConfig>& outputs) {
+    if (outputs.empty()) {
+        throw QuadGNSSException("Multi-output mode needs at least one output");
+    }
+    
+    int max_delay_samples = 0;
+    for (const auto& output : outputs) {
+        // A baseline delays each line of sight by between 0 and 2|b|/c
+        double baseline = std::sqrt(output.baseline_m[0] * output.baseline_m[0] +
+                                    output.baseline_m[1] * output.baseline_m[1] +
+                                    output.baseline_m[2] * output.baseline_m[2]);
+        double max_delay = output.delay_s + 2.0 * baseline / SPEED_OF_LIGHT;
+        if (!(output.delay_s >= 0.0 && max_delay <= MAX_OUTPUT_DELAY_S)) {
+            throw QuadGNSSException("Output delay out of range for " + output.name);
+        }
+        max_delay_samples = std::max(max_delay_samples,
+                                     static_cast<int>(std::floor(max_delay * config_.sampling_rate_hz)));
+    }
+    
+    outputs_ = outputs;
+    interleaved_outputs_.assign(outputs.size(), nullptr);
+    // Interpolation between two samples reaches one sample past the integer delay
+    history_samples_ = max_delay_samples + 1;
+    sources_.clear();
+}
+
+const std::vector<OutputChannelConfig>& SignalOrchestrator::get_outputs() const {
+    return outputs_;
+}
+
+void SignalOrchestrator::mix_all_outputs(std::complex<int16_t>* const* buffers,
+                                         int sample_count,
+                                         double time_now) {
+    if (!initialized_ || !buffers || sample_count <= 0 || outputs_.empty()) {
+        throw QuadGNSSException("SignalOrchestrator not properly initialized or invalid parameters");
+    }
+    
+    generate_shared_baseband(sample_count, time_now, true);
+    render_outputs(buffers, 1, sample_count);
+    publish_telemetry(sample_count, time_now);
+}
+
+void SignalOrchestrator::mix_all_outputs_interleaved(std::complex<int16_t>* buffer,
+                                                     int sample_count,
+                                                     double time_now) {
+    if (!initialized_ || !buffer || sample_count <= 0 || outputs_.empty()) {
+        throw QuadGNSSException("SignalOrchestrator not properly initialized or invalid parameters");
+    }
+    
+    // Output o starts at sample o and advances by the output count
+    for (size_t o = 0; o < interleaved_outputs_.size(); ++o) {
+        interleaved_outputs_[o] = buffer + o;
+    }
+    
+    generate_shared_baseband(sample_count, time_now, true);
+    render_outputs(interleaved_outputs_.data(), outputs_.size(), sample_count);
+    publish_telemetry(sample_count, time_now);
+}
+
+void SignalOrchestrator::generate_shared_baseband(int sample_count, double time_now, bool per_source) {
+    // Each constellation renders into its own lane; the 32-bit accumulator is their sum.
+    // Multi-output rendering keeps every satellite in its own source buffer instead.
+    if (per_source) {
+        prepare_sources(sample_count);
+    } else {
+        lanes_.resize(constellations_.size());
+        lane_pointers_.resize(constellations_.size());
+        for (size_t c = 0; c < lanes_.size(); ++c) {
+            lanes_[c].resize(sample_count);
+            lane_pointers_[c] = lanes_[c].data();
+        }
+        accumulator_.resize(sample_count);
+    }
+    
+    // Pick up control commands; ones stamped inside this chunk split generation there
+    drain_control_queue();
+    
+    int offset = 0;
+    while (offset < sample_count) {
+        uint64_t segment_start = sample_index_ + static_cast<uint64_t>(offset);
+        apply_due_commands(segment_start);
+        
+        int segment_end = sample_count;
+        uint64_t next_at = command_schedule_->next_sample();
+        if (next_at < sample_index_ + static_cast<uint64_t>(sample_count)) {
+            segment_end = static_cast<int>(next_at - sample_index_);
+        }
+        int segment_count = segment_end - offset;
+        double segment_time = time_now + offset / config_.sampling_rate_hz;
+        
+        // Constellations are independent, so they render concurrently; idle ones leave silence
+        auto render = [&](size_t, size_t c) {
+            QGNSS_TRACE_SCOPE_ARG("provider", "constellation", "type", static_cast<int>(constellations_[c]->get_constellation_type()));
+            if (per_source) {
+                std::complex<int16_t>** pointers = source_pointers_.data() + source_offsets_[c];
+                size_t count = source_offsets_[c + 1] - source_offsets_[c];
+                for (size_t s = 0; s < count; ++s) {
+                    pointers[s] = sources_[source_offsets_[c] + s].data() + history_samples_ + offset;
+                }
+                if (constellations_[c]->is_ready()) {
+                    constellations_[c]->generate_sources(pointers, source_geometry_.data() + source_offsets_[c],
+                                                         segment_count, segment_time);
+                } else {
+                    for (size_t s = 0; s < count; ++s) {
+                        std::fill(pointers[s], pointers[s] + segment_count, std::complex<int16_t>(0, 0));
+                    }
+                }
+                return;
+            }
+            std::complex<int16_t>* lane = lanes_[c].data() + offset;
+            if (constellations_[c]->is_ready()) {
+                constellations_[c]->generate_chunk(lane, segment_count, segment_time);
+            } else {
+                std::fill(lane, lane + segment_count, std::complex<int16_t>(0, 0));
+            }
+        };
+        reducer_->parallel_for(constellations_.size(), std::ref(render));
+        offset = segment_end;
+    }
+    
+    if (per_source) return;
+    QGNSS_TRACE_SCOPE("mix", "reduce");
+    reducer_->reduce(lane_pointers_.data(), lane_pointers_.size(), accumulator_.data(), sample_count);
+}
+
+void SignalOrchestrator::prepare_sources(int sample_count) {
+    source_offsets_.resize(constellations_.size() + 1);
+    size_t total = 0;
+    for (size_t c = 0; c < constellations_.size(); ++c) {
+        source_offsets_[c] = total;
+        total += constellations_[c]->source_count();
+    }
+    source_offsets_.back() = total;
+    
+    // New or reset sources start from a silent delay history
+    if (sources_.size() != total) {
+        sources_.assign(total, std::vector<std::complex<int16_t>>(history_samples_, std::complex<int16_t>(0, 0)));
+        source_was_active_.assign(total, 0);
+    }
+    for (auto& source : sources_) {
+        source.resize(history_samples_ + sample_count);
+    }
+    source_geometry_.assign(total, SourceGeometry{});
+    source_pointers_.resize(total);
+}
+
+void SignalOrchestrator::render_outputs(std::complex<int16_t>* const* buffers, size_t stride, int sample_count) {
+    QGNSS_TRACE_SCOPE("mix", "outputs");
+    // The baseline delay differs per line of sight, so every satellite is
+    // delayed and rotated on its own and only then summed.
+    output_mix_.resize(sample_count);
+    
+    const float max_val = std::numeric_limits<int16_t>::max();
+    const float min_val = std::numeric_limits<int16_t>::min();
+    
+    for (size_t o = 0; o < outputs_.size(); ++o) {
+        const OutputChannelConfig& output = outputs_[o];
+        const double* b = output.baseline_m;
+        double baseline = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]);
+        double amplitude = std::pow(10.0, output.gain_db / 20.0);
+        std::fill(output_mix_.begin(), output_mix_.end(), std::complex<float>(0.0f, 0.0f));
+        
+        for (size_t s = 0; s < sources_.size(); ++s) {
+            const SourceGeometry& geometry = source_geometry_[s];
+            if (!geometry.active && !source_was_active_[s]) continue;
             
-            // Add to accumulator
+            // Extra path along this line of sight, kept non-negative by the |b| bias
+            const double* u = geometry.line_of_sight;
+            double path_s = (baseline - (b[0] * u[0] + b[1] * u[1] + b[2] * u[2])) / SPEED_OF_LIGHT;
+            double delay_samples = (output.delay_s + path_s) * config_.sampling_rate_hz;
+            int whole = static_cast<int>(std::floor(delay_samples));
+            float frac = static_cast<float>(delay_samples - whole);
+            double phase = output.phase_rad - 2.0 * M_PI * config_.center_frequency_hz * path_s;
+            float rot_re = static_cast<float>(amplitude * std::cos(phase));
+            float rot_im = static_cast<float>(amplitude * std::sin(phase));
+            
+            const std::complex<int16_t>* newer = sources_[s].data() + history_samples_ - whole;
+            const std::complex<int16_t>* older = newer - 1;
+            std::complex<float>* mix = output_mix_.data();
             for (int i = 0; i < sample_count; ++i) {
-                accumulator[i] += std::complex<int32_t>(
-                    constellation_signal[i].real(),
-                    constellation_signal[i].imag()
-                );
+                float re = static_cast<float>(newer[i].real());
+                float im = static_cast<float>(newer[i].imag());
+                if (frac != 0.0f) {
+                    re += frac * (static_cast<float>(older[i].real()) - re);
+                    im += frac * (static_cast<float>(older[i].imag()) - im);
+                }
+                mix[i] += std::complex<float>(re * rot_re - im * rot_im, re * rot_im + im * rot_re);
             }
         }
+        
+        std::complex<int16_t>* out = buffers[o];
+        for (int i = 0; i < sample_count; ++i) {
+            float y_re = std::nearbyint(output_mix_[i].real());
+            float y_im = std::nearbyint(output_mix_[i].imag());
+            out[i * stride] = std::complex<int16_t>(
+                static_cast<int16_t>(std::max(min_val, std::min(max_val, y_re))),
+                static_cast<int16_t>(std::max(min_val, std::min(max_val, y_im)))
+            );
+        }
     }
     
-    // Prevent overflow and convert to int16_t
-    prevent_overflow(accumulator.data(), sample_count);
-    for (int i = 0; i < sample_count; ++i) {
-        buffer[i] = std::complex<int16_t>(
-            static_cast<int16_t>(accumulator[i].real()),
-            static_cast<int16_t>(accumulator[i].imag())
-        );
+    // Keep the newest samples of every source as delay history for the next chunk
+    for (size_t s = 0; s < sources_.size(); ++s) {
+        std::copy(sources_[s].end() - history_samples_, sources_[s].end(), sources_[s].begin());
+        source_was_active_[s] = source_geometry_[s].active;
     }
 }
 
@@ -206,9 +427,82 @@ const GlobalConfig& SignalOrchestrator::get_config() const {
     return config_;
 }
 
+const std::map<ConstellationType, double>& SignalOrchestrator::get_frequency_offsets() const {
+    return frequency_offsets_;
+}
+
+const TelemetryChannel& SignalOrchestrator::telemetry() const {
+    return *telemetry_;
+}
+
+void SignalOrchestrator::attach_control_queue(ControlCommandQueue* queue) {
+    control_queue_ = queue;
+}
+
+std::vector<std::pair<ConstellationType, int>> SignalOrchestrator::get_satellite_ids() const {
+    std::vector<std::pair<ConstellationType, int>> ids;
+    for (const auto& constellation : constellations_) {
+        for (int prn : constellation->get_satellite_prns()) {
+            ids.emplace_back(constellation->get_constellation_type(), prn);
+        }
+    }
+    return ids;
+}
+
+void SignalOrchestrator::drain_control_queue() {
+    if (control_queue_) {
+        command_schedule_->drain(*control_queue_);
+    }
+}
+
+void SignalOrchestrator::apply_due_commands(uint64_t sample_index) {
+    command_schedule_->apply_due(sample_index, [this](const ControlCommand& command) {
+        bool applied = false;
+        for (auto& constellation : constellations_) {
+            if (command.constellation == ConstellationType::NONE ||
+                command.constellation == constellation->get_constellation_type()) {
+                applied = constellation->apply_command(command) || applied;
+            }
+        }
+        if (command.type == ControlCommandType::SET_RECEIVER_POSITION) {
+            config_.receiver.x_m = command.value[0];
+            config_.receiver.y_m = command.value[1];
+            config_.receiver.z_m = command.value[2];
+            applied = true;
+        }
+        return applied;
+    });
+}
+
+void SignalOrchestrator::publish_telemetry(int sample_count, double time_now) {
+    TelemetrySnapshot& snapshot = telemetry_->staging();
+    snapshot.chunk_index = chunk_index_;
+    snapshot.sample_index = sample_index_;
+    snapshot.sample_count = static_cast<uint32_t>(sample_count);
+    snapshot.time_gps = time_now;
+    snapshot.commands_applied = command_schedule_->get_applied_count();
+    snapshot.commands_rejected = command_schedule_->get_rejected_count();
+    snapshot.commands_dropped = command_schedule_->get_dropped_count();
+    
+    size_t count = 0;
+    for (const auto& constellation : constellations_) {
+        if (constellation->is_ready()) {
+            count += constellation->collect_status(snapshot.satellites + count,
+                                                   TelemetrySnapshot::MAX_SATELLITES - count);
+        }
+    }
+    snapshot.satellite_count = static_cast<uint32_t>(count);
+    
+    telemetry_->publish_staging();
+    
+    chunk_index_++;
+    sample_index_ += static_cast<uint64_t>(sample_count);
+}
+
 void SignalOrchestrator::calculate_frequency_offsets() {
     double center_freq = config_.center_frequency_hz;
     double min_offset = 0.0;
+    frequency_offsets_.clear();
     
     // Find minimum frequency offset from center
     for (const auto& constellation : constellations_) {
@@ -222,6 +516,7 @@ void SignalOrchestrator::calculate_frequency_offsets() {
         double carrier_freq = constellation->get_carrier_frequency();
         double offset = carrier_freq - center_freq - min_offset;
         constellation->set_frequency_offset(offset);
+        frequency_offsets_[constellation->get_constellation_type()] = offset;
     }
 }
 
@@ -0,0 +1,139 @@
+#include "../include/realtime.h"
+#include "../include/numa_placement.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+namespace QuadGNSS {
+
+// LatencyHistogram
+
+size_t LatencyHistogram::bucket_of(uint64_t ns) {
+    if (ns < SUB_BUCKETS) return static_cast<size_t>(ns);
+    const int exponent = 63 - __builtin_clzll(ns);             // >= SUB_BUCKET_BITS
+    const int shift = exponent - SUB_BUCKET_BITS;
+    return SUB_BUCKETS * (shift + 1) + static_cast<size_t>((ns >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucket_high(size_t bucket) {
+    if (bucket < SUB_BUCKETS) return bucket;
+    const int shift = static_cast<int>(bucket / SUB_BUCKETS) - 1;
+    const uint64_t low = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return low + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    buckets_[bucket_of(ns)]++;
+    count_++;
+    sum_ += ns;
+    max_ = std::max(max_, ns);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+    buckets_.fill(0);
+    count_ = sum_ = max_ = 0;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::min(1.0, std::max(0.0, q)) * count_)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) return std::min(bucket_high(i), max_);
+    }
+    return max_;
+}
+
+// RealtimeSession
+
+RealtimeSession::RealtimeSession(const RealtimeOptions& options) {
+    cpu_set_t affinity;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(affinity), &affinity) == 0) {
+        old_affinity_.assign(reinterpret_cast<const char*>(&affinity), reinterpret_cast<const char*>(&affinity + 1));
+    }
+    sched_param param{};
+    pthread_getschedparam(pthread_self(), &old_policy_, &param);
+    old_priority_ = param.sched_priority;
+
+    if (options.lock_memory) {
+        memory_locked_ = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+        if (!memory_locked_) {
+            warnings_.push_back(std::string("Memory not locked (needs CAP_IPC_LOCK or a larger RLIMIT_MEMLOCK): ") +
+                                std::strerror(errno));
+        }
+    }
+
+    if (!options.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : options.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        int error = CPU_COUNT(&set) > 0 ? pthread_setaffinity_np(pthread_self(), sizeof(set), &set) : EINVAL;
+        pinned_ = error == 0;
+        if (!pinned_) {
+            std::string list;
+            for (int cpu : options.cpus) list += (list.empty() ? "" : ",") + std::to_string(cpu);
+            warnings_.push_back("Cannot pin the generation thread to CPUs " + list + ": " + std::strerror(error));
+        }
+        const std::vector<int> isolated = isolated_cpus();
+        for (int cpu : options.cpus) {
+            if (std::find(isolated.begin(), isolated.end(), cpu) == isolated.end()) {
+                warnings_.push_back("CPU " + std::to_string(cpu) + " is not isolated (isolcpus); other tasks may preempt");
+            }
+        }
+    }
+
+    if (options.fifo_priority > 0) {
+        sched_param fifo{};
+        fifo.sched_priority = std::min(options.fifo_priority, sched_get_priority_max(SCHED_FIFO));
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &fifo);
+        fifo_ = error == 0;
+        if (!fifo_) {
+            warnings_.push_back("SCHED_FIFO not available (needs CAP_SYS_NICE or RLIMIT_RTPRIO): " +
+                                std::string(std::strerror(error)));
+        }
+    }
+}
+
+RealtimeSession::~RealtimeSession() {
+    if (fifo_) {
+        sched_param param{};
+        param.sched_priority = old_priority_;
+        pthread_setschedparam(pthread_self(), old_policy_, &param);
+    }
+    if (pinned_ && old_affinity_.size() == sizeof(cpu_set_t)) {
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), reinterpret_cast<const cpu_set_t*>(old_affinity_.data()));
+    }
+    if (memory_locked_) {
+        munlockall();
+    }
+}
+
+std::vector<int> RealtimeSession::isolated_cpus() {
+    std::ifstream in("/sys/devices/system/cpu/isolated");
+    std::string line;
+    std::getline(in, line);
+    try {
+        return CpuTopology::parse_cpu_list(line);
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,393 @@
+#include "../include/recording.h"
+#include "../include/fingerprint.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+namespace {
+
+const char MAGIC[8] = {'Q', 'G', 'N', 'S', 'S', 'R', 'E', 'C'};
+
+uint32_t tag(const char (&name)[5]) {
+    uint32_t value;
+    std::memcpy(&value, name, 4);
+    return value;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_section(std::string& out, uint32_t section_tag, const std::string& payload) {
+    put(out, section_tag);
+    put(out, static_cast<uint64_t>(payload.size()));
+    out += payload;
+}
+
+// Bounds-checked reader over a recording's bytes
+class Cursor {
+public:
+    Cursor(const std::string& data, size_t begin, size_t end) : data_(data), pos_(begin), end_(end) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string bytes(size_t count) {
+        const char* p = take(count);
+        return std::string(p, count);
+    }
+
+    size_t position() const { return pos_; }
+    bool done() const { return pos_ == end_; }
+
+private:
+    const std::string& data_;
+    size_t pos_;
+    size_t end_;
+
+    const char* take(size_t count) {
+        if (count > end_ - pos_) {
+            throw QuadGNSSException("Recording is truncated");
+        }
+        const char* p = data_.data() + pos_;
+        pos_ += count;
+        return p;
+    }
+};
+
+std::string read_file(const std::string& path, const std::string& what) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw QuadGNSSException("Cannot read " + what + ": " + path);
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+size_t thread_count(size_t threads, size_t tasks) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return std::max<size_t>(1, std::min(threads, tasks));
+}
+
+// Navigation files are stored by base name; anything that could leave the extraction directory is refused
+bool safe_name(const std::string& name) {
+    return !name.empty() && name.find('/') == std::string::npos && name != "." && name != "..";
+}
+
+} // namespace
+
+void ProceduralRecording::create(const std::string& path, const std::string& json_text, const std::string& base_dir,
+                                 double checkpoint_interval_s, size_t threads) {
+    if (!(checkpoint_interval_s > 0.0)) {
+        throw QuadGNSSException("Checkpoint interval must be positive");
+    }
+    // Compiling first reports scenario errors against the user's own document and paths
+    ProceduralRecording recording;
+    recording.plan_ = ScenarioCompiler::compile(json_text, base_dir);
+    const ExecutionPlan& plan = *recording.plan_;
+    require_no_pipeline(plan, "a procedural recording");
+
+    // Embed the navigation files under their base names; the stream replaces every sink
+    JsonValue root = parse_json(json_text);
+    root.object_members().erase("sinks");
+    std::vector<std::pair<std::string, std::string>> nav_files;
+    auto constellations = root.object_members().find("constellations");
+    if (constellations != root.object_members().end()) {
+        for (auto& item : constellations->second.array_items()) {
+            auto ephemeris = item.object_members().find("ephemeris");
+            if (ephemeris == item.object_members().end() || ephemeris->second.as_string().empty()) continue;
+            std::string file = ephemeris->second.as_string();
+            if (!base_dir.empty() && file[0] != '/') {
+                file = base_dir + "/" + file;
+            }
+            std::string name = file.substr(file.find_last_of('/') + 1);
+            name = "nav" + std::to_string(nav_files.size()) + "_" + (safe_name(name) ? name : "file");
+            nav_files.emplace_back(name, read_file(file, "navigation file"));
+            ephemeris->second = JsonValue::make_string(name);
+        }
+    }
+    recording.scenario_ = format_json(root);
+
+    // Fingerprint the first chunk of every checkpoint
+    const uint64_t total_chunks = plan.get_total_chunks();
+    const double fs = plan.get_config().sampling_rate_hz;
+    const double interval = std::round(checkpoint_interval_s / plan.get_chunk_duration());
+    recording.checkpoint_interval_ = static_cast<uint32_t>(std::max(1.0, std::min(interval, 4.0e9)));
+    for (uint64_t chunk = 0; chunk < total_chunks; chunk += recording.checkpoint_interval_) {
+        uint64_t first_sample = chunk * static_cast<uint64_t>(plan.get_chunk_samples());
+        recording.checkpoints_.push_back(
+            {chunk, first_sample, plan.get_config().simulation.start_time_gps + first_sample / fs, 0});
+    }
+    recording.verify_fingerprints(threads, true);
+
+    std::string info;
+    put(info, plan.get_config().sampling_rate_hz);
+    put(info, plan.get_config().center_frequency_hz);
+    put(info, plan.get_config().simulation.start_time_gps);
+    put(info, plan.get_seed());
+    put(info, static_cast<uint32_t>(plan.get_chunk_samples()));
+    put(info, total_chunks);
+
+    std::string seek;
+    put(seek, recording.checkpoint_interval_);
+    for (const auto& checkpoint : recording.checkpoints_) {
+        put(seek, checkpoint.chunk);
+        put(seek, checkpoint.first_sample);
+        put(seek, checkpoint.time_gps);
+        put(seek, checkpoint.fingerprint);
+    }
+
+    std::string out(MAGIC, sizeof(MAGIC));
+    put(out, FORMAT_VERSION);
+    put_section(out, tag("INFO"), info);
+    put_section(out, tag("SCEN"), recording.scenario_);
+    for (const auto& nav : nav_files) {
+        std::string payload;
+        put(payload, static_cast<uint32_t>(nav.first.size()));
+        payload += nav.first;
+        payload += nav.second;
+        put_section(out, tag("NAVF"), payload);
+    }
+    put_section(out, tag("SEEK"), seek);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(out.data(), static_cast<std::streamsize>(out.size())) || !file.flush()) {
+        throw QuadGNSSException("Cannot write recording: " + path);
+    }
+}
+
+ProceduralRecording::ProceduralRecording(const std::string& path) {
+    const std::string data = read_file(path, "recording");
+    if (data.size() < sizeof(MAGIC) + 4 || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw QuadGNSSException("Not a QuadGNSS recording: " + path);
+    }
+    Cursor file(data, sizeof(MAGIC), data.size());
+    uint32_t version = file.get<uint32_t>();
+    if (version != FORMAT_VERSION) {
+        throw QuadGNSSException("Unsupported recording version " + std::to_string(version) + ": " + path);
+    }
+
+    double sampling_rate = 0.0, center_frequency = 0.0, start_time = 0.0;
+    uint64_t seed = 0, total_chunks = 0;
+    uint32_t chunk_samples = 0;
+    bool has_info = false, has_scenario = false, has_seek = false;
+    std::vector<std::pair<std::string, std::string>> nav_files;
+    while (!file.done()) {
+        uint32_t section = file.get<uint32_t>();
+        uint64_t length = file.get<uint64_t>();
+        if (length > data.size() - file.position()) {
+            throw QuadGNSSException("Recording is truncated");
+        }
+        Cursor payload(data, file.position(), file.position() + length);
+        file.bytes(length);
+
+        if (section == tag("INFO")) {
+            sampling_rate = payload.get<double>();
+            center_frequency = payload.get<double>();
+            start_time = payload.get<double>();
+            seed = payload.get<uint64_t>();
+            chunk_samples = payload.get<uint32_t>();
+            total_chunks = payload.get<uint64_t>();
+            has_info = true;
+        } else if (section == tag("SCEN")) {
+            scenario_ = payload.bytes(length);
+            has_scenario = true;
+        } else if (section == tag("NAVF")) {
+            uint32_t name_length = payload.get<uint32_t>();
+            std::string name = payload.bytes(name_length);
+            if (!safe_name(name)) {
+                throw QuadGNSSException("Recording has an invalid navigation file name: " + name);
+            }
+            nav_files.emplace_back(name, payload.bytes(length - 4 - name_length));
+        } else if (section == tag("SEEK")) {
+            checkpoint_interval_ = payload.get<uint32_t>();
+            while (!payload.done()) {
+                RecordingCheckpoint checkpoint;
+                checkpoint.chunk = payload.get<uint64_t>();
+                checkpoint.first_sample = payload.get<uint64_t>();
+                checkpoint.time_gps = payload.get<double>();
+                checkpoint.fingerprint = payload.get<uint64_t>();
+                checkpoints_.push_back(checkpoint);
+            }
+            has_seek = true;
+        }
+        // Unknown sections are skipped so later writers can add optional data
+    }
+    if (!has_info || !has_scenario || !has_seek || checkpoint_interval_ == 0) {
+        throw QuadGNSSException("Recording is missing sections: " + path);
+    }
+
+    // The plan is compiled against the embedded navigation files, extracted to a private directory
+    std::string dir_template = (std::getenv("TMPDIR") ? std::string(std::getenv("TMPDIR")) : "/tmp") + "/quadgnss_rec_XXXXXX";
+    std::vector<char> dir(dir_template.begin(), dir_template.end());
+    dir.push_back('\0');
+    if (!mkdtemp(dir.data())) {
+        throw QuadGNSSException("Cannot create a directory for the recording's navigation files");
+    }
+    std::vector<std::string> extracted;
+    try {
+        for (const auto& nav : nav_files) {
+            extracted.push_back(std::string(dir.data()) + "/" + nav.first);
+            std::ofstream out(extracted.back(), std::ios::binary);
+            if (!out.write(nav.second.data(), static_cast<std::streamsize>(nav.second.size()))) {
+                throw QuadGNSSException("Cannot extract navigation file: " + extracted.back());
+            }
+        }
+        plan_ = ScenarioCompiler::compile(scenario_, dir.data());
+    } catch (...) {
+        for (const auto& name : extracted) std::remove(name.c_str());
+        rmdir(dir.data());
+        throw;
+    }
+    for (const auto& name : extracted) std::remove(name.c_str());
+    rmdir(dir.data());
+
+    const GlobalConfig& config = plan_->get_config();
+    if (config.sampling_rate_hz != sampling_rate || config.center_frequency_hz != center_frequency ||
+        config.simulation.start_time_gps != start_time || plan_->get_seed() != seed ||
+        static_cast<uint32_t>(plan_->get_chunk_samples()) != chunk_samples ||
+        plan_->get_total_chunks() != total_chunks) {
+        throw QuadGNSSException("Recording header does not match its scenario: " + path);
+    }
+    for (size_t i = 0; i < checkpoints_.size(); ++i) {
+        if (checkpoints_[i].chunk != i * checkpoint_interval_ ||
+            checkpoints_[i].first_sample != checkpoints_[i].chunk * chunk_samples) {
+            throw QuadGNSSException("Recording seek index is inconsistent: " + path);
+        }
+    }
+    if (checkpoints_.size() != (total_chunks + checkpoint_interval_ - 1) / checkpoint_interval_) {
+        throw QuadGNSSException("Recording seek index is incomplete: " + path);
+    }
+}
+
+uint64_t ProceduralRecording::get_total_samples() const {
+    return plan_->get_total_chunks() * static_cast<uint64_t>(plan_->get_chunk_samples());
+}
+
+const RecordingCheckpoint& ProceduralRecording::checkpoint_for(uint64_t sample) const {
+    if (checkpoints_.empty()) {
+        throw QuadGNSSException("Recording has no checkpoints");
+    }
+    uint64_t chunk = sample / static_cast<uint64_t>(plan_->get_chunk_samples());
+    return checkpoints_[std::min<uint64_t>(chunk / checkpoint_interval_, checkpoints_.size() - 1)];
+}
+
+void ProceduralRecording::read(uint64_t first_sample, size_t count, std::complex<int16_t>* output, size_t threads) {
+    if (count == 0) return;
+    if (first_sample > get_total_samples() || count > get_total_samples() - first_sample) {
+        throw QuadGNSSException("Range runs past the end of the recording");
+    }
+    const uint64_t chunk_samples = static_cast<uint64_t>(plan_->get_chunk_samples());
+    const uint64_t first_chunk = first_sample / chunk_samples;
+    const uint64_t end_sample = first_sample + count;
+    const uint64_t chunks = (end_sample + chunk_samples - 1) / chunk_samples - first_chunk;
+
+    render_chunks(chunks, threads, [&](PlanRenderer& renderer, uint64_t task, std::vector<std::complex<int16_t>>& scratch) {
+        uint64_t chunk = first_chunk + task;
+        uint64_t chunk_start = chunk * chunk_samples;
+        if (chunk_start >= first_sample && chunk_start + chunk_samples <= end_sample) {
+            renderer.render(chunk, output + (chunk_start - first_sample));      // Whole chunk: in place
+            return;
+        }
+        renderer.render(chunk, scratch.data());
+        uint64_t from = std::max(chunk_start, first_sample);
+        uint64_t to = std::min(chunk_start + chunk_samples, end_sample);
+        std::copy(scratch.begin() + (from - chunk_start), scratch.begin() + (to - chunk_start),
+                  output + (from - first_sample));
+    });
+}
+
+int64_t ProceduralRecording::verify(size_t threads) {
+    return verify_fingerprints(threads, false);
+}
+
+int64_t ProceduralRecording::verify_fingerprints(size_t threads, bool store) {
+    std::vector<uint64_t> fingerprints(checkpoints_.size());
+    const uint64_t chunk_samples = static_cast<uint64_t>(plan_->get_chunk_samples());
+    render_chunks(checkpoints_.size(), threads,
+                  [&](PlanRenderer& renderer, uint64_t task, std::vector<std::complex<int16_t>>& scratch) {
+        renderer.render(checkpoints_[task].chunk, scratch.data());
+        StreamFingerprint fingerprint(chunk_samples);
+        fingerprint.append(scratch.data(), scratch.size());
+        fingerprint.finish();
+        fingerprints[task] = fingerprint.get_hashes()[0];
+    });
+    for (size_t i = 0; i < checkpoints_.size(); ++i) {
+        if (store) {
+            checkpoints_[i].fingerprint = fingerprints[i];
+        } else if (checkpoints_[i].fingerprint != fingerprints[i]) {
+            return static_cast<int64_t>(i);
+        }
+    }
+    return -1;
+}
+
+void ProceduralRecording::render_chunks(uint64_t tasks, size_t threads, const ChunkTask& task) {
+    const size_t workers = thread_count(threads, static_cast<size_t>(std::min<uint64_t>(tasks, SIZE_MAX)));
+    std::atomic<uint64_t> next{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto work = [&]() {
+        try {
+            std::unique_ptr<PlanRenderer> renderer = take_renderer();
+            std::vector<std::complex<int16_t>> scratch(static_cast<size_t>(plan_->get_chunk_samples()));
+            for (uint64_t i = next++; i < tasks; i = next++) {
+                task(*renderer, i, scratch);
+            }
+            return_renderer(std::move(renderer));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            next = tasks;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < workers; ++i) {
+        pool.emplace_back(work);
+    }
+    work();                                    // The calling thread is one of the workers
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+std::unique_ptr<PlanRenderer> ProceduralRecording::take_renderer() {
+    {
+        std::lock_guard<std::mutex> lock(renderers_mutex_);
+        if (!renderers_.empty()) {
+            std::unique_ptr<PlanRenderer> renderer = std::move(renderers_.back());
+            renderers_.pop_back();
+            return renderer;
+        }
+    }
+    return std::make_unique<PlanRenderer>(plan_, codes_);
+}
+
+void ProceduralRecording::return_renderer(std::unique_ptr<PlanRenderer> renderer) {
+    std::lock_guard<std::mutex> lock(renderers_mutex_);
+    renderers_.push_back(std::move(renderer));
+}
+
+} // namespace QuadGNSS
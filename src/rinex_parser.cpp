@@ -180,6 +180,28 @@ std::map<int, EphemerisData> RINEXParser::parse_rinex3(const std::string& filena
         if (is_target_satellite && line.length() > 22) {
             int prn = parse_int(line, 1, 2);  // PRN is after constellation letter
             
+            if (constellation == ConstellationType::GLONASS) {
+                // State-vector record: epoch line and three orbit lines (fields at columns 4, 23, 42, 61)
+                EphemerisData glonass;
+                glonass.prn = prn;
+                glonass.constellation = constellation;
+                glonass.clock_bias = -parse_dbl(line, 23, 19);     // -TauN
+                glonass.clock_drift = parse_dbl(line, 42, 19);     // +GammaN
+                std::string orbit;
+                bool complete = true;
+                for (int n = 1; n <= 3 && complete; ++n) {
+                    complete = static_cast<bool>(std::getline(file, orbit)) && orbit.length() > 61;
+                    if (complete && n == 2) {
+                        glonass.frequency_number = static_cast<int>(parse_dbl(orbit, 61, 19));
+                    }
+                }
+                // The orbit is not modelled (is_valid stays false); the slot and its channel are kept
+                if (complete) {
+                    ephemeris_data[prn] = glonass;
+                }
+                continue;
+            }
+            
             // Ephemeris record - parse orbital parameters
             if (line.length() > 68) {
                 current_eph.prn = prn;
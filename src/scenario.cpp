@@ -0,0 +1,1076 @@
+#include "../include/scenario.h"
+#include "../include/rinex_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+// JsonValue
+
+JsonValue JsonValue::make_bool(bool value) {
+    JsonValue v;
+    v.type_ = Type::BOOL;
+    v.bool_ = value;
+    return v;
+}
+
+JsonValue JsonValue::make_number(double value) {
+    JsonValue v;
+    v.type_ = Type::NUMBER;
+    v.number_ = value;
+    return v;
+}
+
+JsonValue JsonValue::make_string(const std::string& value) {
+    JsonValue v;
+    v.type_ = Type::STRING;
+    v.string_ = value;
+    return v;
+}
+
+JsonValue JsonValue::make_array() {
+    JsonValue v;
+    v.type_ = Type::ARRAY;
+    return v;
+}
+
+JsonValue JsonValue::make_object() {
+    JsonValue v;
+    v.type_ = Type::OBJECT;
+    return v;
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    if (type_ != Type::OBJECT) return nullptr;
+    auto it = object_.find(key);
+    return it == object_.end() ? nullptr : &it->second;
+}
+
+const char* JsonValue::type_name(Type type) {
+    switch (type) {
+        case Type::NUL: return "null";
+        case Type::BOOL: return "boolean";
+        case Type::NUMBER: return "number";
+        case Type::STRING: return "string";
+        case Type::ARRAY: return "array";
+        case Type::OBJECT: return "object";
+    }
+    return "unknown";
+}
+
+namespace {
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text), pos_(0) {}
+
+    JsonValue parse_document() {
+        JsonValue value = parse_value(0);
+        skip_whitespace();
+        if (pos_ != text_.size()) fail("unexpected trailing characters");
+        return value;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+    const std::string& text_;
+    size_t pos_;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        size_t line = 1, column = 1;
+        for (size_t i = 0; i < pos_ && i < text_.size(); ++i) {
+            if (text_[i] == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+        }
+        throw QuadGNSSException("JSON " + std::to_string(line) + ":" + std::to_string(column) + ": " + message);
+    }
+
+    void skip_whitespace() {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                pos_++;
+            } else if (c == '#' || (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '/')) {
+                // Line comments are accepted so scenarios can be annotated
+                while (pos_ < text_.size() && text_[pos_] != '\n') pos_++;
+            } else {
+                break;
+            }
+        }
+    }
+
+    bool consume_literal(const char* literal) {
+        size_t length = std::char_traits<char>::length(literal);
+        if (text_.compare(pos_, length, literal) == 0) {
+            pos_ += length;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parse_value(int depth) {
+        if (depth > MAX_DEPTH) fail("nesting too deep");
+        skip_whitespace();
+        if (pos_ >= text_.size()) fail("unexpected end of input");
+
+        char c = text_[pos_];
+        if (c == '{') return parse_object(depth);
+        if (c == '[') return parse_array(depth);
+        if (c == '"') return JsonValue::make_string(parse_string());
+        if (consume_literal("true")) return JsonValue::make_bool(true);
+        if (consume_literal("false")) return JsonValue::make_bool(false);
+        if (consume_literal("null")) return JsonValue();
+        if (c == '-' || (c >= '0' && c <= '9')) return parse_number();
+        fail(std::string("unexpected character '") + c + "'");
+    }
+
+    JsonValue parse_number() {
+        const char* start = text_.c_str() + pos_;
+        char* end = nullptr;
+        double value = std::strtod(start, &end);
+        if (end == start || !std::isfinite(value)) fail("invalid number");
+        pos_ += static_cast<size_t>(end - start);
+        return JsonValue::make_number(value);
+    }
+
+    static void append_utf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    std::string parse_string() {
+        pos_++;  // Opening quote
+        std::string out;
+        while (true) {
+            if (pos_ >= text_.size()) fail("unterminated string");
+            char c = text_[pos_++];
+            if (c == '"') return out;
+            if (static_cast<unsigned char>(c) < 0x20) fail("control character in string");
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) fail("unterminated escape");
+            char e = text_[pos_++];
+            switch (e) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (pos_ + 4 > text_.size()) fail("truncated \\u escape");
+                    uint32_t code = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        char h = text_[pos_++];
+                        code <<= 4;
+                        if (h >= '0' && h <= '9') code |= static_cast<uint32_t>(h - '0');
+                        else if (h >= 'a' && h <= 'f') code |= static_cast<uint32_t>(h - 'a' + 10);
+                        else if (h >= 'A' && h <= 'F') code |= static_cast<uint32_t>(h - 'A' + 10);
+                        else fail("invalid \\u escape");
+                    }
+                    append_utf8(out, code);
+                    break;
+                }
+                default:
+                    fail(std::string("invalid escape \\") + e);
+            }
+        }
+    }
+
+    JsonValue parse_array(int depth) {
+        pos_++;  // '['
+        JsonValue array = JsonValue::make_array();
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == ']') {
+            pos_++;
+            return array;
+        }
+        while (true) {
+            array.array_items().push_back(parse_value(depth + 1));
+            skip_whitespace();
+            if (pos_ >= text_.size()) fail("unterminated array");
+            char c = text_[pos_++];
+            if (c == ']') return array;
+            if (c != ',') fail("expected ',' or ']'");
+        }
+    }
+
+    JsonValue parse_object(int depth) {
+        pos_++;  // '{'
+        JsonValue object = JsonValue::make_object();
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == '}') {
+            pos_++;
+            return object;
+        }
+        while (true) {
+            skip_whitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') fail("expected object key");
+            std::string key = parse_string();
+            if (object.object_members().count(key)) fail("duplicate key \"" + key + "\"");
+            skip_whitespace();
+            if (pos_ >= text_.size() || text_[pos_] != ':') fail("expected ':'");
+            pos_++;
+            object.object_members()[key] = parse_value(depth + 1);
+            skip_whitespace();
+            if (pos_ >= text_.size()) fail("unterminated object");
+            char c = text_[pos_++];
+            if (c == '}') return object;
+            if (c != ',') fail("expected ',' or '}'");
+        }
+    }
+};
+
+} // namespace
+
+JsonValue parse_json(const std::string& text) {
+    return JsonParser(text).parse_document();
+}
+
+namespace {
+
+void format_string(const std::string& text, std::string& out) {
+    out += '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+void format_value(const JsonValue& value, std::string& out) {
+    switch (value.type()) {
+        case JsonValue::Type::NUL: out += "null"; break;
+        case JsonValue::Type::BOOL: out += value.as_bool() ? "true" : "false"; break;
+        case JsonValue::Type::NUMBER: {
+            char number[32];
+            std::snprintf(number, sizeof(number), "%.17g", value.as_number());
+            out += number;
+            break;
+        }
+        case JsonValue::Type::STRING: format_string(value.as_string(), out); break;
+        case JsonValue::Type::ARRAY: {
+            out += '[';
+            for (size_t i = 0; i < value.as_array().size(); ++i) {
+                if (i) out += ", ";
+                format_value(value.as_array()[i], out);
+            }
+            out += ']';
+            break;
+        }
+        case JsonValue::Type::OBJECT: {
+            out += '{';
+            bool first = true;
+            for (const auto& member : value.as_object()) {
+                if (!first) out += ", ";
+                first = false;
+                format_string(member.first, out);
+                out += ": ";
+                format_value(member.second, out);
+            }
+            out += '}';
+            break;
+        }
+    }
+}
+
+} // namespace
+
+std::string format_json(const JsonValue& value) {
+    std::string out;
+    format_value(value, out);
+    return out;
+}
+
+// Scenario validation
+
+namespace {
+
+struct ConstellationRules {
+    ConstellationType type;
+    const char* name;
+    int max_prn;
+};
+
+const ConstellationRules CONSTELLATION_RULES[] = {
+    {ConstellationType::GPS, "GPS", 32},
+    {ConstellationType::GLONASS, "GLONASS", 24},     // PRN = orbital slot
+    {ConstellationType::GALILEO, "GALILEO", 36},
+    {ConstellationType::BEIDOU, "BEIDOU", 63},
+};
+
+const ConstellationRules* find_rules(const std::string& name) {
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+    for (const auto& rules : CONSTELLATION_RULES) {
+        if (upper == rules.name) return &rules;
+    }
+    return nullptr;
+}
+
+const ConstellationRules& rules_for(ConstellationType type) {
+    for (const auto& rules : CONSTELLATION_RULES) {
+        if (rules.type == type) return rules;
+    }
+    throw QuadGNSSException("Unknown constellation");
+}
+
+// Nominal FDMA channel of each GLONASS orbital slot; antipodal slots share a channel
+const int GLONASS_SLOT_CHANNELS[24] = {1, -4, 5, 6, 1, -4, 5, 6, -2, -7, 0, -1,
+                                       -2, -7, 0, -1, 4, -3, 3, 2, 4, -3, 3, 2};
+
+/**
+ * FDMA channel of a GLONASS slot
+ * @param ephemeris Parsed navigation data (nullptr = none); its broadcast frequency number wins
+ */
+int glonass_channel(int slot, const std::map<int, EphemerisData>* ephemeris = nullptr) {
+    if (ephemeris) {
+        auto it = ephemeris->find(slot);
+        if (it != ephemeris->end()) return it->second.frequency_number;
+    }
+    return GLONASS_SLOT_CHANNELS[slot - 1];
+}
+
+// Why no band of a constellation renders: the satellites' carriers do not fit the stream
+std::string unrendered_message(const ConstellationRules& rules, double sampling_rate_hz, double center_frequency_hz) {
+    std::ostringstream message;
+    message << "no " << rules.name << " signal band fits the +/-" << sampling_rate_hz / 2e6 << " MHz stream at "
+            << center_frequency_hz / 1e6 << " MHz";
+    return message.str();
+}
+
+void geodetic_to_ecef(double lat_deg, double lon_deg, double height_m, double& x, double& y, double& z) {
+    const double a = 6378137.0;
+    const double f = 1.0 / 298.257223563;
+    const double e2 = f * (2.0 - f);
+    double lat = lat_deg * M_PI / 180.0;
+    double lon = lon_deg * M_PI / 180.0;
+    double n = a / std::sqrt(1.0 - e2 * std::sin(lat) * std::sin(lat));
+    x = (n + height_m) * std::cos(lat) * std::cos(lon);
+    y = (n + height_m) * std::cos(lat) * std::sin(lon);
+    z = (n * (1.0 - e2) + height_m) * std::sin(lat);
+}
+
+struct ConstellationDraft {
+    const ConstellationRules* rules = nullptr;
+    std::string path;                          // JSON path for messages
+    std::string ephemeris_file;
+    std::string ephemeris_format = "rinex3";
+    bool all_satellites = false;
+    std::vector<int> prns;
+    std::vector<int> exclude;
+    double power_dbm = -130.0;
+    std::map<int, double> power_overrides;
+};
+
+struct ScenarioDraft {
+    std::string name = "scenario";
+    double sampling_rate_hz = GlobalConfig::DEFAULT_SAMPLING_RATE;
+    double center_frequency_hz = GlobalConfig::DEFAULT_CENTER_FREQ;
+    double start_time_gps = 0.0;
+    double duration_s = 60.0;
+    double chunk_duration_s = 0.01;
+    size_t threads = 0;                        // 0 = hardware concurrency
+    uint64_t seed = 1;
+    std::vector<TrajectoryPoint> trajectory;
+    std::vector<ConstellationDraft> constellations;
+    std::vector<PlannedSink> sinks;
+    std::vector<StageSpec> pipeline;
+};
+
+// Schema reader that records every error with its JSON path instead of stopping at the first
+class ScenarioReader {
+public:
+    explicit ScenarioReader(std::vector<std::string>& errors) : errors_(errors) {}
+
+    void read(const JsonValue& root, ScenarioDraft& draft, const std::string& base_dir) {
+        if (!root.is_object()) {
+            error("$", "scenario must be a JSON object");
+            return;
+        }
+        check_keys(root, "$", {"name", "sampling_rate_hz", "center_frequency_hz", "start_time_gps", "duration_s",
+                               "chunk_duration_s", "threads", "seed", "receiver", "trajectory",
+                               "constellations", "sinks", "pipeline"});
+
+        draft.name = string(root, "name", "$", draft.name);
+        draft.sampling_rate_hz = number(root, "sampling_rate_hz", "$", draft.sampling_rate_hz, 1e5, 500e6);
+        draft.center_frequency_hz = number(root, "center_frequency_hz", "$", draft.center_frequency_hz, 1e8, 3e9);
+        draft.start_time_gps = number(root, "start_time_gps", "$", draft.start_time_gps, 0.0, 1e10);
+        draft.duration_s = number(root, "duration_s", "$", draft.duration_s, 1e-6, 1e7);
+        draft.chunk_duration_s = number(root, "chunk_duration_s", "$", draft.chunk_duration_s, 1e-5, 1.0);
+        draft.threads = static_cast<size_t>(integer(root, "threads", "$", 0, 0, 1024));
+        draft.seed = static_cast<uint64_t>(integer(root, "seed", "$", 1, 0, 9.0e15));
+
+        double chunk_samples = draft.sampling_rate_hz * draft.chunk_duration_s;
+        if (std::abs(chunk_samples - std::round(chunk_samples)) > 1e-6 * chunk_samples) {
+            error("$.chunk_duration_s", "chunk must hold a whole number of samples (" +
+                  std::to_string(chunk_samples) + " at this sample rate)");
+        }
+
+        read_position_sources(root, draft);
+        read_constellations(root, draft, base_dir);
+        read_sinks(root, draft);
+        read_pipeline(root, draft);
+    }
+
+private:
+    std::vector<std::string>& errors_;
+
+    void error(const std::string& path, const std::string& message) {
+        errors_.push_back(path + ": " + message);
+    }
+
+    void check_keys(const JsonValue& object, const std::string& path, std::initializer_list<const char*> allowed) {
+        for (const auto& member : object.as_object()) {
+            bool known = false;
+            for (const char* key : allowed) {
+                known = known || member.first == key;
+            }
+            if (!known) error(path, "unknown key \"" + member.first + "\"");
+        }
+    }
+
+    bool expect(const JsonValue& value, JsonValue::Type type, const std::string& path) {
+        if (value.type() == type) return true;
+        error(path, std::string("expected ") + JsonValue::type_name(type) + ", got " + JsonValue::type_name(value.type()));
+        return false;
+    }
+
+    double number(const JsonValue& object, const std::string& key, const std::string& path,
+                  double fallback, double min, double max, bool required = false) {
+        const JsonValue* value = object.find(key);
+        std::string member = path + "." + key;
+        if (!value) {
+            if (required) error(member, "required");
+            return fallback;
+        }
+        if (!expect(*value, JsonValue::Type::NUMBER, member)) return fallback;
+        double v = value->as_number();
+        if (v < min || v > max) {
+            std::ostringstream range;
+            range << "value " << v << " outside [" << min << ", " << max << "]";
+            error(member, range.str());
+            return fallback;
+        }
+        return v;
+    }
+
+    int64_t integer(const JsonValue& object, const std::string& key, const std::string& path,
+                    int64_t fallback, double min, double max) {
+        double v = number(object, key, path, static_cast<double>(fallback), min, max);
+        if (v != std::floor(v)) {
+            error(path + "." + key, "must be an integer");
+            return fallback;
+        }
+        return static_cast<int64_t>(v);
+    }
+
+    std::string string(const JsonValue& object, const std::string& key, const std::string& path,
+                       const std::string& fallback, bool required = false) {
+        const JsonValue* value = object.find(key);
+        std::string member = path + "." + key;
+        if (!value) {
+            if (required) error(member, "required");
+            return fallback;
+        }
+        if (!expect(*value, JsonValue::Type::STRING, member)) return fallback;
+        if (value->as_string().empty()) {
+            error(member, "must not be empty");
+            return fallback;
+        }
+        return value->as_string();
+    }
+
+    std::vector<int> prn_list(const JsonValue& value, const std::string& path, const ConstellationRules& rules) {
+        std::vector<int> prns;
+        if (!expect(value, JsonValue::Type::ARRAY, path)) return prns;
+        for (size_t i = 0; i < value.as_array().size(); ++i) {
+            const JsonValue& item = value.as_array()[i];
+            std::string item_path = path + "[" + std::to_string(i) + "]";
+            if (!expect(item, JsonValue::Type::NUMBER, item_path)) continue;
+            double prn = item.as_number();
+            if (prn != std::floor(prn) || prn < 1 || prn > rules.max_prn) {
+                std::ostringstream message;
+                message << "PRN " << prn << " out of range for " << rules.name << " (1-" << rules.max_prn << ")";
+                error(item_path, message.str());
+                continue;
+            }
+            if (std::find(prns.begin(), prns.end(), static_cast<int>(prn)) != prns.end()) {
+                error(item_path, "duplicate PRN " + std::to_string(static_cast<int>(prn)));
+                continue;
+            }
+            prns.push_back(static_cast<int>(prn));
+        }
+        return prns;
+    }
+
+    bool position(const JsonValue& object, const std::string& path, double& x, double& y, double& z) {
+        bool ecef = object.find("x_m") || object.find("y_m") || object.find("z_m");
+        bool geodetic = object.find("lat_deg") || object.find("lon_deg") || object.find("height_m");
+        if (ecef == geodetic) {
+            error(path, "give either x_m/y_m/z_m or lat_deg/lon_deg/height_m");
+            return false;
+        }
+        size_t before = errors_.size();
+        if (ecef) {
+            x = number(object, "x_m", path, 0.0, -1e8, 1e8, true);
+            y = number(object, "y_m", path, 0.0, -1e8, 1e8, true);
+            z = number(object, "z_m", path, 0.0, -1e8, 1e8, true);
+        } else {
+            double lat = number(object, "lat_deg", path, 0.0, -90.0, 90.0, true);
+            double lon = number(object, "lon_deg", path, 0.0, -180.0, 180.0, true);
+            double height = number(object, "height_m", path, 0.0, -1e4, 1e8);
+            geodetic_to_ecef(lat, lon, height, x, y, z);
+        }
+        return errors_.size() == before;
+    }
+
+    void read_position_sources(const JsonValue& root, ScenarioDraft& draft) {
+        const JsonValue* receiver = root.find("receiver");
+        const JsonValue* trajectory = root.find("trajectory");
+        if (receiver && trajectory) {
+            error("$", "use either receiver or trajectory, not both");
+            return;
+        }
+        if (!receiver && !trajectory) {
+            error("$", "receiver or trajectory is required");
+            return;
+        }
+
+        if (receiver) {
+            if (!expect(*receiver, JsonValue::Type::OBJECT, "$.receiver")) return;
+            check_keys(*receiver, "$.receiver", {"x_m", "y_m", "z_m", "lat_deg", "lon_deg", "height_m"});
+            TrajectoryPoint point{0.0, 0.0, 0.0, 0.0};
+            if (position(*receiver, "$.receiver", point.x_m, point.y_m, point.z_m)) {
+                draft.trajectory.push_back(point);
+            }
+            return;
+        }
+
+        if (!expect(*trajectory, JsonValue::Type::ARRAY, "$.trajectory")) return;
+        if (trajectory->as_array().empty()) {
+            error("$.trajectory", "needs at least one point");
+        }
+        for (size_t i = 0; i < trajectory->as_array().size(); ++i) {
+            const JsonValue& item = trajectory->as_array()[i];
+            std::string path = "$.trajectory[" + std::to_string(i) + "]";
+            if (!expect(item, JsonValue::Type::OBJECT, path)) continue;
+            check_keys(item, path, {"t", "x_m", "y_m", "z_m", "lat_deg", "lon_deg", "height_m"});
+            TrajectoryPoint point{number(item, "t", path, 0.0, 0.0, 1e7, true), 0.0, 0.0, 0.0};
+            if (!position(item, path, point.x_m, point.y_m, point.z_m)) continue;
+            if (!draft.trajectory.empty() && point.time_s <= draft.trajectory.back().time_s) {
+                error(path + ".t", "trajectory times must increase");
+                continue;
+            }
+            draft.trajectory.push_back(point);
+        }
+    }
+
+    void read_constellations(const JsonValue& root, ScenarioDraft& draft, const std::string& base_dir) {
+        const JsonValue* list = root.find("constellations");
+        if (!list) {
+            error("$.constellations", "required");
+            return;
+        }
+        if (!expect(*list, JsonValue::Type::ARRAY, "$.constellations")) return;
+        if (list->as_array().empty()) {
+            error("$.constellations", "needs at least one constellation");
+        }
+
+        for (size_t i = 0; i < list->as_array().size(); ++i) {
+            const JsonValue& item = list->as_array()[i];
+            std::string path = "$.constellations[" + std::to_string(i) + "]";
+            if (!expect(item, JsonValue::Type::OBJECT, path)) continue;
+            check_keys(item, path, {"type", "ephemeris", "ephemeris_format", "satellites", "exclude",
+                                    "power_dbm", "power_overrides"});
+
+            ConstellationDraft c;
+            c.path = path;
+            std::string type = string(item, "type", path, "", true);
+            c.rules = find_rules(type);
+            if (!c.rules) {
+                if (!type.empty()) error(path + ".type", "unknown constellation \"" + type + "\"");
+                continue;
+            }
+            for (const auto& other : draft.constellations) {
+                if (other.rules == c.rules) error(path + ".type", std::string(c.rules->name) + " listed twice");
+            }
+
+            c.power_dbm = number(item, "power_dbm", path, c.power_dbm, -200.0, -50.0);
+            c.ephemeris_file = string(item, "ephemeris", path, "");
+            c.ephemeris_format = string(item, "ephemeris_format", path, c.ephemeris_format);
+            if (c.ephemeris_format != "rinex3" && c.ephemeris_format != "rinex2") {
+                error(path + ".ephemeris_format", "expected \"rinex2\" or \"rinex3\"");
+            } else if (c.ephemeris_format == "rinex2" && c.rules->type != ConstellationType::GPS) {
+                error(path + ".ephemeris_format", "RINEX 2 navigation files are only supported for GPS");
+            }
+            if (!c.ephemeris_file.empty()) {
+                if (!base_dir.empty() && c.ephemeris_file[0] != '/') {
+                    c.ephemeris_file = base_dir + "/" + c.ephemeris_file;
+                }
+                if (access(c.ephemeris_file.c_str(), R_OK) != 0) {
+                    error(path + ".ephemeris", "cannot read " + c.ephemeris_file);
+                }
+            }
+
+            const JsonValue* satellites = item.find("satellites");
+            if (!satellites) {
+                error(path + ".satellites", "required (PRN list or \"all\")");
+            } else if (satellites->is_string()) {
+                if (satellites->as_string() == "all") {
+                    c.all_satellites = true;
+                } else {
+                    error(path + ".satellites", "expected a PRN list or \"all\"");
+                }
+            } else {
+                c.prns = prn_list(*satellites, path + ".satellites", *c.rules);
+                if (c.prns.empty() && satellites->is_array()) error(path + ".satellites", "empty PRN list");
+            }
+            if (const JsonValue* exclude = item.find("exclude")) {
+                c.exclude = prn_list(*exclude, path + ".exclude", *c.rules);
+            }
+
+            if (const JsonValue* overrides = item.find("power_overrides")) {
+                std::string opath = path + ".power_overrides";
+                if (expect(*overrides, JsonValue::Type::OBJECT, opath)) {
+                    for (const auto& member : overrides->as_object()) {
+                        char* end = nullptr;
+                        long prn = std::strtol(member.first.c_str(), &end, 10);
+                        if (*end != '\0' || prn < 1 || prn > c.rules->max_prn) {
+                            error(opath, "\"" + member.first + "\" is not a " + c.rules->name + " PRN");
+                            continue;
+                        }
+                        std::string member_path = opath + "." + member.first;
+                        if (!expect(member.second, JsonValue::Type::NUMBER, member_path)) continue;
+                        double power = member.second.as_number();
+                        if (power < -200.0 || power > -50.0) {
+                            std::ostringstream range;
+                            range << "value " << power << " outside [-200, -50]";
+                            error(member_path, range.str());
+                            continue;
+                        }
+                        c.power_overrides[static_cast<int>(prn)] = power;
+                    }
+                }
+            }
+
+            check_frequency_plan(draft, c);
+            draft.constellations.push_back(c);
+        }
+    }
+
+    // Same band selection as compile() and every plan consumer, on the nominal GLONASS channels
+    void check_frequency_plan(const ScenarioDraft& draft, const ConstellationDraft& c) {
+        std::vector<int> prns = c.prns;
+        if (c.all_satellites) {
+            for (int prn = 1; prn <= c.rules->max_prn; ++prn) prns.push_back(prn);
+        }
+        std::vector<StreamSatellite> satellites;
+        for (int prn : prns) {
+            if (std::find(c.exclude.begin(), c.exclude.end(), prn) != c.exclude.end()) continue;
+            int channel = c.rules->type == ConstellationType::GLONASS ? glonass_channel(prn) : 0;
+            satellites.push_back(StreamSatellite{c.rules->type, prn, channel});
+        }
+        if (!satellites.empty() &&
+            bands_for_stream(satellites, draft.center_frequency_hz, draft.sampling_rate_hz).empty()) {
+            error(c.path, unrendered_message(*c.rules, draft.sampling_rate_hz, draft.center_frequency_hz));
+        }
+    }
+
+    void read_sinks(const JsonValue& root, ScenarioDraft& draft) {
+        const JsonValue* list = root.find("sinks");
+        if (!list) {
+            draft.sinks.push_back(PlannedSink{ScenarioSinkType::STDOUT, "", "", 0, 0});
+            return;
+        }
+        if (!expect(*list, JsonValue::Type::ARRAY, "$.sinks")) return;
+
+        for (size_t i = 0; i < list->as_array().size(); ++i) {
+            const JsonValue& item = list->as_array()[i];
+            std::string path = "$.sinks[" + std::to_string(i) + "]";
+            if (!expect(item, JsonValue::Type::OBJECT, path)) continue;
+
+            PlannedSink sink{ScenarioSinkType::STDOUT, "", "", 0, 0};
+            std::string type = string(item, "type", path, "", true);
+            if (type == "stdout") {
+                check_keys(item, path, {"type"});
+            } else if (type == "file") {
+                check_keys(item, path, {"type", "path", "backend"});
+                sink.type = ScenarioSinkType::FILE;
+                sink.target = string(item, "path", path, "", true);
+                sink.backend = string(item, "backend", path, "auto");
+                if (sink.backend != "auto" && sink.backend != "uring" && sink.backend != "threads") {
+                    error(path + ".backend", "expected auto, uring or threads");
+                }
+            } else if (type == "stream") {
+                check_keys(item, path, {"type", "port"});
+                sink.type = ScenarioSinkType::STREAM;
+                sink.port = static_cast<uint16_t>(integer(item, "port", path, 0, 0, 65535));
+            } else if (type == "shm") {
+                check_keys(item, path, {"type", "name", "slots"});
+                sink.type = ScenarioSinkType::SHARED_MEMORY;
+                sink.target = string(item, "name", path, "", true);
+                sink.ring_slots = static_cast<uint32_t>(integer(item, "slots", path, 64, 2, 65536));
+                if (!sink.target.empty() && sink.target[0] != '/') {
+                    error(path + ".name", "shared-memory names start with '/'");
+                }
+            } else {
+                if (!type.empty()) error(path + ".type", "unknown sink \"" + type + "\" (stdout, file, stream, shm)");
+                continue;
+            }
+
+            for (const auto& other : draft.sinks) {
+                if (other.type == sink.type && other.target == sink.target && other.port == sink.port) {
+                    error(path, "duplicate sink");
+                }
+            }
+            draft.sinks.push_back(sink);
+        }
+        if (draft.sinks.empty()) {
+            error("$.sinks", "needs at least one sink");
+        }
+    }
+
+    void read_pipeline(const JsonValue& root, ScenarioDraft& draft) {
+        const JsonValue* list = root.find("pipeline");
+        if (!list || !expect(*list, JsonValue::Type::ARRAY, "$.pipeline")) return;
+
+        static const std::map<std::string, std::vector<std::string>> REQUIRED_PARAMS = {
+            {"sum", {}}, {"gain", {"gain_db"}}, {"frequency_shift", {"shift_hz"}},
+            {"noise", {"sigma"}}, {"quantize", {}}, {"external", {}}
+        };
+
+        for (size_t i = 0; i < list->as_array().size(); ++i) {
+            const JsonValue& item = list->as_array()[i];
+            std::string path = "$.pipeline[" + std::to_string(i) + "]";
+            if (!expect(item, JsonValue::Type::OBJECT, path)) continue;
+
+            StageSpec spec;
+            spec.name = string(item, "name", path, "", true);
+            spec.type = string(item, "type", path, "", true);
+            auto required = REQUIRED_PARAMS.find(spec.type);
+            if (!spec.type.empty() && required == REQUIRED_PARAMS.end()) {
+                error(path + ".type", "unknown stage type \"" + spec.type + "\"");
+            }
+            for (const auto& member : item.as_object()) {
+                const std::string& key = member.first;
+                if (key == "name" || key == "type") continue;
+                if (key == "inputs") {
+                    if (!expect(member.second, JsonValue::Type::ARRAY, path + ".inputs")) continue;
+                    for (const auto& input : member.second.as_array()) {
+                        if (expect(input, JsonValue::Type::STRING, path + ".inputs")) {
+                            spec.inputs.push_back(input.as_string());
+                        }
+                    }
+                } else if (expect(member.second, JsonValue::Type::NUMBER, path + "." + key)) {
+                    spec.params[key] = member.second.as_number();
+                }
+            }
+            if (required != REQUIRED_PARAMS.end()) {
+                for (const auto& param : required->second) {
+                    if (!spec.params.count(param)) error(path + "." + param, "required for " + spec.type);
+                }
+            }
+            for (const auto& other : draft.pipeline) {
+                if (!spec.name.empty() && other.name == spec.name) error(path + ".name", "duplicate stage " + spec.name);
+            }
+            draft.pipeline.push_back(spec);
+        }
+
+        for (size_t i = 0; i < draft.pipeline.size(); ++i) {
+            for (const auto& input : draft.pipeline[i].inputs) {
+                bool known = std::any_of(draft.pipeline.begin(), draft.pipeline.end(),
+                                         [&](const StageSpec& s) { return s.name == input; });
+                if (!known) error("$.pipeline[" + std::to_string(i) + "].inputs", "unknown stage \"" + input + "\"");
+            }
+        }
+    }
+};
+
+std::string format_errors(const std::vector<std::string>& errors) {
+    std::string message = "Invalid scenario (" + std::to_string(errors.size()) + " error" +
+                          (errors.size() == 1 ? "" : "s") + ")";
+    for (const auto& e : errors) {
+        message += "\n  " + e;
+    }
+    return message;
+}
+
+bool read_draft(const std::string& json_text, const std::string& base_dir,
+                ScenarioDraft& draft, std::vector<std::string>& errors) {
+    JsonValue root;
+    try {
+        root = parse_json(json_text);
+    } catch (const QuadGNSSException& e) {
+        errors.push_back(e.what());
+        return false;
+    }
+    ScenarioReader(errors).read(root, draft, base_dir);
+    return errors.empty();
+}
+
+} // namespace
+
+// EphemerisCache
+
+EphemerisCache::Table EphemerisCache::load(const std::string& path, const std::string& format,
+                                           ConstellationType constellation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto key = std::make_tuple(path, format, constellation);
+    auto it = tables_.find(key);
+    if (it != tables_.end()) return it->second;
+
+    Table table = std::make_shared<const std::map<int, EphemerisData>>(
+        format == "rinex2" ? RINEXParser::parse_gps_rinex2(path) : RINEXParser::parse_rinex3(path, constellation));
+    parse_count_++;
+    tables_[key] = table;
+    return table;
+}
+
+size_t EphemerisCache::get_parse_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return parse_count_;
+}
+
+// ExecutionPlan
+
+void ExecutionPlan::receiver_position(double time_s, double& x_m, double& y_m, double& z_m) const {
+    const TrajectoryPoint* a = &trajectory_.front();
+    const TrajectoryPoint* b = a;
+    if (time_s > trajectory_.back().time_s) {
+        a = b = &trajectory_.back();
+    } else {
+        for (size_t i = 1; i < trajectory_.size(); ++i) {
+            if (time_s <= trajectory_[i].time_s) {
+                a = &trajectory_[i - 1];
+                b = &trajectory_[i];
+                break;
+            }
+        }
+    }
+    double span = b->time_s - a->time_s;
+    double w = span > 0.0 ? std::max(0.0, std::min(1.0, (time_s - a->time_s) / span)) : 0.0;
+    x_m = a->x_m + w * (b->x_m - a->x_m);
+    y_m = a->y_m + w * (b->y_m - a->y_m);
+    z_m = a->z_m + w * (b->z_m - a->z_m);
+}
+
+std::string ExecutionPlan::describe() const {
+    std::ostringstream out;
+    out << "Scenario '" << name_ << "'\n";
+    out << "  Stream: " << config_.sampling_rate_hz / 1e6 << " MSps at " << config_.center_frequency_hz / 1e6
+        << " MHz, " << config_.simulation.duration_seconds << " s from GPS time " << config_.simulation.start_time_gps
+        << "\n";
+    out << "  Chunks: " << total_chunks_ << " x " << chunk_samples_ << " samples (" << chunk_bytes_
+        << " bytes), file buffers " << file_buffer_bytes_ << " bytes\n";
+    out << "  Satellites: " << satellites_.size() << "\n";
+    out << "  Frequency plan:\n";
+    for (const auto& carrier : carriers_) {
+        out << "    " << get_band_info(carrier.band).name;
+        if (carrier.constellation == ConstellationType::GLONASS) out << " k=" << carrier.glonass_channel;
+        out << " " << carrier.carrier_hz / 1e6 << " MHz (offset " << carrier.offset_hz / 1e6 << " MHz, "
+            << carrier.satellite_count << " sats)\n";
+    }
+    out << "  Threads: " << threads_.generator_threads << " generator, " << threads_.sink_threads << " sink, "
+        << threads_.graph_workers << " pipeline\n";
+    out << "  Sinks: " << sinks_.size() << ", pipeline stages: " << pipeline_.size() << "\n";
+    return out.str();
+}
+
+// ScenarioCompiler
+
+const char* ScenarioCompiler::constellation_name(ConstellationType type) {
+    return rules_for(type).name;
+}
+
+std::vector<std::string> ScenarioCompiler::validate(const std::string& json_text) {
+    ScenarioDraft draft;
+    std::vector<std::string> errors;
+    read_draft(json_text, "", draft, errors);
+    return errors;
+}
+
+std::shared_ptr<const ExecutionPlan> ScenarioCompiler::compile_file(const std::string& path, EphemerisCache* cache) {
+    std::ifstream in(path);
+    if (!in) {
+        throw QuadGNSSException("Cannot open scenario file: " + path);
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    size_t slash = path.find_last_of('/');
+    return compile(text.str(), slash == std::string::npos ? "" : path.substr(0, slash), cache);
+}
+
+std::shared_ptr<const ExecutionPlan> ScenarioCompiler::compile(const std::string& json_text,
+                                                               const std::string& base_dir,
+                                                               EphemerisCache* cache) {
+    ScenarioDraft draft;
+    std::vector<std::string> errors;
+    if (!read_draft(json_text, base_dir, draft, errors)) {
+        throw QuadGNSSException(format_errors(errors));
+    }
+
+    std::shared_ptr<ExecutionPlan> plan(new ExecutionPlan());
+    plan->name_ = draft.name;
+    plan->seed_ = draft.seed;
+    plan->trajectory_ = draft.trajectory;
+    plan->sinks_ = draft.sinks;
+    plan->pipeline_ = draft.pipeline;
+
+    GlobalConfig& config = plan->config_;
+    config.sampling_rate_hz = draft.sampling_rate_hz;
+    config.center_frequency_hz = draft.center_frequency_hz;
+    config.simulation.start_time_gps = draft.start_time_gps;
+    config.simulation.duration_seconds = draft.duration_s;
+    config.active_constellations.clear();
+    plan->receiver_position(0.0, config.receiver.x_m, config.receiver.y_m, config.receiver.z_m);
+
+    // Expensive part: parse navigation data (once per process with a shared cache)
+    EphemerisCache private_cache;
+    EphemerisCache& ephemeris_cache = cache ? *cache : private_cache;
+    for (const auto& c : draft.constellations) {
+        if (c.ephemeris_file.empty()) continue;
+        EphemerisCache::Table ephemeris = ephemeris_cache.load(c.ephemeris_file, c.ephemeris_format, c.rules->type);
+        if (ephemeris->empty()) {
+            throw QuadGNSSException(c.path + ".ephemeris: no " + c.rules->name + " records in " + c.ephemeris_file);
+        }
+        plan->ephemeris_[c.rules->type] = ephemeris;
+    }
+
+    // Resolve satellites
+    std::vector<std::pair<ConstellationType, size_t>> load;
+    for (const auto& c : draft.constellations) {
+        auto eph = plan->ephemeris_.find(c.rules->type);
+        std::vector<int> prns = c.prns;
+        if (c.all_satellites) {
+            if (eph != plan->ephemeris_.end()) {
+                for (const auto& entry : *eph->second) {
+                    if (entry.first >= 1 && entry.first <= c.rules->max_prn) prns.push_back(entry.first);
+                }
+            } else {
+                for (int prn = 1; prn <= c.rules->max_prn; ++prn) prns.push_back(prn);
+            }
+        }
+
+        size_t count = 0;
+        for (int prn : prns) {
+            if (std::find(c.exclude.begin(), c.exclude.end(), prn) != c.exclude.end()) continue;
+            PlannedSatellite sat{};
+            sat.constellation = c.rules->type;
+            sat.prn = prn;
+            auto power = c.power_overrides.find(prn);
+            sat.power_dbm = power != c.power_overrides.end() ? power->second : c.power_dbm;
+            sat.glonass_channel = c.rules->type != ConstellationType::GLONASS ? 0
+                                : glonass_channel(prn, eph != plan->ephemeris_.end() ? eph->second.get() : nullptr);
+            sat.has_ephemeris = eph != plan->ephemeris_.end() && eph->second->count(prn) > 0;
+            plan->satellites_.push_back(sat);
+            count++;
+        }
+        if (count == 0) {
+            throw QuadGNSSException(c.path + ": no satellites left after exclusions");
+        }
+        config.active_constellations.push_back(c.rules->type);
+        load.emplace_back(c.rules->type, count);
+    }
+
+    // Bands: validation assumed the nominal GLONASS channels; the broadcast ones may sit elsewhere
+    std::vector<StreamSatellite> stream;
+    for (const auto& sat : plan->satellites_) {
+        stream.push_back(StreamSatellite{sat.constellation, sat.prn, sat.glonass_channel});
+    }
+    std::vector<ConstellationType> unrendered;
+    plan->bands_ = bands_for_stream(stream, config.center_frequency_hz, config.sampling_rate_hz, &unrendered);
+    for (ConstellationType type : unrendered) {
+        auto c = std::find_if(draft.constellations.begin(), draft.constellations.end(),
+                              [&](const ConstellationDraft& d) { return d.rules->type == type; });
+        throw QuadGNSSException(c->path + ": " + unrendered_message(*c->rules, config.sampling_rate_hz,
+                                                                    config.center_frequency_hz) +
+                                " on the broadcast channels");
+    }
+
+    // Satellite carriers and the frequency plan: one entry per rendered band and channel
+    for (auto& sat : plan->satellites_) {
+        for (SignalBand band : plan->bands_) {
+            const BandInfo& info = get_band_info(band);
+            if (info.constellation != sat.constellation) continue;
+            int channel = info.channel_spacing_hz != 0.0 ? sat.glonass_channel : 0;
+            double carrier = band_carrier_hz(band, channel);
+            if (sat.carrier_hz == 0.0) {
+                sat.carrier_hz = carrier;
+                sat.offset_hz = carrier - config.center_frequency_hz;
+            }
+            auto it = std::find_if(plan->carriers_.begin(), plan->carriers_.end(), [&](const PlannedCarrier& entry) {
+                return entry.band == band && entry.glonass_channel == channel;
+            });
+            if (it != plan->carriers_.end()) {
+                it->satellite_count++;
+                continue;
+            }
+            plan->carriers_.push_back(PlannedCarrier{sat.constellation, band, channel, carrier,
+                                                     carrier - config.center_frequency_hz, info.main_lobe_hz, 1});
+        }
+    }
+
+    // Buffers
+    plan->chunk_duration_s_ = draft.chunk_duration_s;
+    plan->chunk_samples_ = static_cast<int>(std::llround(draft.sampling_rate_hz * draft.chunk_duration_s));
+    plan->total_chunks_ = static_cast<uint64_t>(std::ceil(draft.duration_s / draft.chunk_duration_s - 1e-9));
+    plan->chunk_bytes_ = static_cast<size_t>(plan->chunk_samples_) * sizeof(std::complex<int16_t>);
+    const size_t page = 4096;
+    plan->file_buffer_bytes_ = (std::max<size_t>(plan->chunk_bytes_, 1 << 20) + page - 1) / page * page;
+
+    // Thread layout: constellations packed onto generator threads by satellite count (largest first)
+    size_t threads = draft.threads ? draft.threads : std::max(1u, std::thread::hardware_concurrency());
+    ThreadLayout& layout = plan->threads_;
+    layout.requested_threads = threads;
+    layout.generator_threads = std::max<size_t>(1, std::min(threads, load.size()));
+    layout.generator_assignment.assign(layout.generator_threads, {});
+    std::vector<size_t> thread_load(layout.generator_threads, 0);
+    std::stable_sort(load.begin(), load.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (const auto& entry : load) {
+        size_t target = static_cast<size_t>(std::min_element(thread_load.begin(), thread_load.end()) - thread_load.begin());
+        layout.generator_assignment[target].push_back(entry.first);
+        thread_load[target] += entry.second;
+    }
+    layout.sink_threads = 0;
+    for (const auto& sink : plan->sinks_) {
+        if (sink.type == ScenarioSinkType::FILE) layout.sink_threads += sink.backend == "uring" ? 1 : 2;
+        if (sink.type == ScenarioSinkType::STREAM) layout.sink_threads += 1;
+    }
+    layout.graph_workers = plan->pipeline_.empty() ? 0 : (threads > layout.generator_threads ? threads - layout.generator_threads : 0);
+
+    return plan;
+}
+
+} // namespace QuadGNSS
@@ -0,0 +1,254 @@
+#include "../include/shm_ring.h"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr size_t PAGE_BYTES = 4096;
+constexpr size_t SLOT_HEADER_BYTES = 64;     // Sample data starts cache-line aligned
+
+static_assert(sizeof(ShmRingHeader) <= PAGE_BYTES, "Ring header must fit in one page");
+static_assert(sizeof(ShmRingSlotHeader) <= SLOT_HEADER_BYTES, "Slot header too large");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory ring needs lock-free 64-bit atomics");
+
+size_t round_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t slot_stride(uint64_t slot_capacity) {
+    return round_up(SLOT_HEADER_BYTES + slot_capacity * sizeof(std::complex<int16_t>), PAGE_BYTES);
+}
+
+} // namespace
+
+// ShmRingProducer
+
+ShmRingProducer::ShmRingProducer(const std::string& name, uint32_t slot_count,
+                                 uint64_t slot_capacity, double sampling_rate_hz)
+    : name_(name), mapping_(nullptr), mapping_bytes_(0), header_(nullptr)
+    , next_sequence_(0), writing_(false) {
+    if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos) {
+        throw QuadGNSSException("Shared-memory ring name must look like /name: " + name);
+    }
+    if (slot_count < 2 || slot_capacity == 0) {
+        throw QuadGNSSException("Shared-memory ring needs at least 2 slots of non-zero capacity");
+    }
+
+    size_t stride = slot_stride(slot_capacity);
+    mapping_bytes_ = PAGE_BYTES + stride * slot_count;
+
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw QuadGNSSException("Cannot create shared-memory ring " + name + ": " + std::strerror(errno));
+    }
+    if (ftruncate(fd, static_cast<off_t>(mapping_bytes_)) != 0) {
+        std::string reason = std::strerror(errno);
+        close(fd);
+        shm_unlink(name.c_str());
+        throw QuadGNSSException("Cannot size shared-memory ring " + name + ": " + reason);
+    }
+    mapping_ = mmap(nullptr, mapping_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        shm_unlink(name.c_str());
+        throw QuadGNSSException("Cannot map shared-memory ring " + name + ": " + std::strerror(errno));
+    }
+
+    // Fresh pages are zero, so every slot starts with sequence 0 (never committed)
+    header_ = new (mapping_) ShmRingHeader();
+    header_->version = ShmRingHeader::VERSION;
+    header_->slot_count = slot_count;
+    header_->slot_capacity = slot_capacity;
+    header_->slot_stride_bytes = stride;
+    header_->sampling_rate_hz = sampling_rate_hz;
+    header_->write_sequence.store(0, std::memory_order_relaxed);
+    header_->producer_alive.store(1, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < slot_count; ++i) {
+        new (slot_header(i)) ShmRingSlotHeader();
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = ShmRingHeader::MAGIC;
+}
+
+ShmRingProducer::~ShmRingProducer() {
+    if (mapping_) {
+        header_->producer_alive.store(0, std::memory_order_release);
+        munmap(mapping_, mapping_bytes_);
+        shm_unlink(name_.c_str());
+    }
+}
+
+ShmRingSlotHeader* ShmRingProducer::slot_header(uint64_t sequence) const {
+    unsigned char* base = static_cast<unsigned char*>(mapping_) + PAGE_BYTES;
+    return reinterpret_cast<ShmRingSlotHeader*>(
+        base + (sequence % header_->slot_count) * header_->slot_stride_bytes);
+}
+
+std::complex<int16_t>* ShmRingProducer::begin_write() {
+    ShmRingSlotHeader* slot = slot_header(next_sequence_);
+    slot->sequence.store(2 * next_sequence_ + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    writing_ = true;
+    return reinterpret_cast<std::complex<int16_t>*>(
+        reinterpret_cast<unsigned char*>(slot) + SLOT_HEADER_BYTES);
+}
+
+void ShmRingProducer::commit(uint32_t sample_count, uint64_t sample_index, double time_gps) {
+    if (!writing_) {
+        throw QuadGNSSException("ShmRingProducer::commit() without begin_write()");
+    }
+    if (sample_count > header_->slot_capacity) {
+        throw QuadGNSSException("Chunk larger than shared-memory slot capacity");
+    }
+
+    ShmRingSlotHeader* slot = slot_header(next_sequence_);
+    slot->sample_index = sample_index;
+    slot->sample_count = sample_count;
+    slot->time_gps = time_gps;
+    slot->sequence.store(2 * next_sequence_ + 2, std::memory_order_release);
+
+    next_sequence_++;
+    header_->write_sequence.store(next_sequence_, std::memory_order_release);
+    writing_ = false;
+}
+
+void ShmRingProducer::prefault() {
+    if (next_sequence_ != 0 || writing_) {
+        throw QuadGNSSException("ShmRingProducer::prefault() after the first write");
+    }
+    // Sample areas are still zero and unseen by consumers; writing zero allocates each page
+    for (uint32_t i = 0; i < header_->slot_count; ++i) {
+        volatile unsigned char* slot = reinterpret_cast<unsigned char*>(slot_header(i));
+        for (size_t offset = SLOT_HEADER_BYTES; offset < header_->slot_stride_bytes; offset += PAGE_BYTES) {
+            slot[offset] = 0;
+        }
+    }
+}
+
+// ShmRingConsumer
+
+ShmRingConsumer::ShmRingConsumer(const std::string& name, bool from_latest)
+    : mapping_(nullptr), mapping_bytes_(0), header_(nullptr)
+    , cursor_(0), overruns_(0), borrowed_(false) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw QuadGNSSException("Cannot open shared-memory ring " + name + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < PAGE_BYTES) {
+        close(fd);
+        throw QuadGNSSException("Shared-memory ring " + name + " is truncated");
+    }
+    mapping_bytes_ = static_cast<size_t>(info.st_size);
+    mapping_ = mmap(nullptr, mapping_bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw QuadGNSSException("Cannot map shared-memory ring " + name + ": " + std::strerror(errno));
+    }
+
+    header_ = static_cast<const ShmRingHeader*>(mapping_);
+    uint64_t magic = header_->magic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (magic != ShmRingHeader::MAGIC || header_->version != ShmRingHeader::VERSION ||
+        header_->slot_stride_bytes != slot_stride(header_->slot_capacity) ||
+        mapping_bytes_ < PAGE_BYTES + header_->slot_stride_bytes * header_->slot_count) {
+        munmap(mapping_, mapping_bytes_);
+        mapping_ = nullptr;
+        throw QuadGNSSException("Shared-memory ring " + name + " has an invalid header");
+    }
+
+    uint64_t written = header_->write_sequence.load(std::memory_order_acquire);
+    uint64_t history = header_->slot_count - 1;
+    cursor_ = from_latest ? written : (written > history ? written - history : 0);
+}
+
+ShmRingConsumer::~ShmRingConsumer() {
+    if (mapping_) {
+        munmap(mapping_, mapping_bytes_);
+    }
+}
+
+const ShmRingSlotHeader* ShmRingConsumer::slot_header(uint64_t sequence) const {
+    const unsigned char* base = static_cast<const unsigned char*>(mapping_) + PAGE_BYTES;
+    return reinterpret_cast<const ShmRingSlotHeader*>(
+        base + (sequence % header_->slot_count) * header_->slot_stride_bytes);
+}
+
+bool ShmRingConsumer::catch_up() {
+    uint64_t written = header_->write_sequence.load(std::memory_order_acquire);
+    if (cursor_ >= written) {
+        return false;
+    }
+
+    // The slot after the newest committed one may already be under rewrite
+    uint64_t history = header_->slot_count - 1;
+    if (written - cursor_ > history) {
+        overruns_ += written - history - cursor_;
+        cursor_ = written - history;
+    }
+    return true;
+}
+
+bool ShmRingConsumer::acquire(ShmRingChunk& chunk) {
+    if (borrowed_) {
+        throw QuadGNSSException("ShmRingConsumer::acquire() while a slot is still borrowed");
+    }
+
+    while (catch_up()) {
+        const ShmRingSlotHeader* slot = slot_header(cursor_);
+        uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+        if (seq != 2 * cursor_ + 2) {
+            // Producer lapped us between catch_up() and here
+            overruns_++;
+            cursor_++;
+            continue;
+        }
+
+        chunk.sequence = cursor_;
+        chunk.sample_index = slot->sample_index;
+        chunk.sample_count = slot->sample_count;
+        chunk.time_gps = slot->time_gps;
+        chunk.samples = reinterpret_cast<const std::complex<int16_t>*>(
+            reinterpret_cast<const unsigned char*>(slot) + SLOT_HEADER_BYTES);
+        borrowed_ = true;
+        return true;
+    }
+    return false;
+}
+
+bool ShmRingConsumer::release() {
+    if (!borrowed_) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    bool intact = slot_header(cursor_)->sequence.load(std::memory_order_relaxed) == 2 * cursor_ + 2;
+    if (!intact) {
+        overruns_++;
+    }
+    cursor_++;
+    borrowed_ = false;
+    return intact;
+}
+
+bool ShmRingConsumer::read_copy(std::complex<int16_t>* buffer, ShmRingChunk& chunk) {
+    while (acquire(chunk)) {
+        std::memcpy(buffer, chunk.samples, chunk.sample_count * sizeof(std::complex<int16_t>));
+        if (release()) {
+            chunk.samples = buffer;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace QuadGNSS
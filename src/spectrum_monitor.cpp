@@ -0,0 +1,421 @@
+#include "../include/spectrum_monitor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <time.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace QuadGNSS {
+
+namespace {
+
+constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+constexpr size_t FLOOR_BLOCKS = 128;                 // Bins are averaged in this many blocks for the floor estimate
+constexpr double MAX_CREDIT_S = 1.0;                 // Seconds of generation whose budget may be saved up
+
+// CPU time of the calling thread; unlike wall time it does not count preemption by the generator
+double thread_cpu_seconds() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+} // namespace
+
+const char* band_status_name(BandStatus status) {
+    switch (status) {
+        case BandStatus::OK: return "OK";
+        case BandStatus::MISSING: return "MISSING";
+        case BandStatus::OFFSET: return "OFFSET";
+        case BandStatus::OUTSIDE_STREAM: return "OUTSIDE_STREAM";
+    }
+    return "UNKNOWN";
+}
+
+double main_lobe_half_width_hz(ConstellationType type) {
+    switch (type) {
+        case ConstellationType::GPS: return 1.023e6;                   // BPSK(1)
+        case ConstellationType::GALILEO: return 2.046e6;               // BOC(1,1) outer nulls
+        case ConstellationType::BEIDOU: return 2.046e6;                // BPSK(2)
+        case ConstellationType::GLONASS: return 7 * 0.5625e6 + 0.511e6;   // FDMA channels -7..+6
+        default: throw QuadGNSSException("No main lobe for unknown constellation");
+    }
+}
+
+std::vector<SpectrumBand> expected_spectrum_bands(const std::map<ConstellationType, double>& offsets) {
+    std::vector<SpectrumBand> bands;
+    for (const auto& entry : offsets) {
+        const char* name = entry.first == ConstellationType::GPS ? "GPS"
+                         : entry.first == ConstellationType::GLONASS ? "GLONASS"
+                         : entry.first == ConstellationType::GALILEO ? "Galileo"
+                         : entry.first == ConstellationType::BEIDOU ? "BeiDou" : "Unknown";
+        bands.push_back(SpectrumBand{name, entry.second, main_lobe_half_width_hz(entry.first)});
+    }
+    return bands;
+}
+
+bool SpectrumSnapshot::all_bands_ok() const {
+    return std::all_of(bands.begin(), bands.end(), [](const BandOccupancy& b) { return b.status == BandStatus::OK; });
+}
+
+SpectrumMonitor::SpectrumMonitor(const SpectrumMonitorConfig& config, const std::vector<SpectrumBand>& bands)
+    : config_(config), bands_(bands), fft_(config.fft_size), window_(config.fft_size), window_power_(0.0)
+    , busy_(false), stopping_(false)
+    , fill_slot_(-1), fill_count_(0), skip_remaining_(0), credit_s_(0.0), charged_s_(0.0), have_last_tap_(false)
+    , next_snapshot_time_(NaN), stream_time_(0.0), tap_seconds_(0.0), segments_admitted_(0), segments_skipped_(0)
+    , segment_re_(config.fft_size), segment_im_(config.fft_size)
+    , accumulator_(config.fft_size, 0.0), accumulated_segments_(0)
+    , analysis_seconds_(0.0), segments_analysed_(0), snapshot_count_(0) {
+    if (config_.sampling_rate_hz <= 0.0 || config_.fft_size < 64 || config_.min_segment_spacing == 0 ||
+        !(config_.cpu_budget > 0.0 && config_.cpu_budget <= 1.0) || config_.snapshot_interval_s <= 0.0 ||
+        config_.queue_segments == 0 || config_.occupancy_threshold_db <= 0.0 || config_.unexpected_threshold_db <= 0.0) {
+        throw QuadGNSSException("Invalid spectrum monitor configuration");
+    }
+    for (const auto& band : bands_) {
+        if (band.half_width_hz <= 0.0) {
+            throw QuadGNSSException("Spectrum band " + band.name + " has no width");
+        }
+    }
+
+    const size_t n = config_.fft_size;
+    for (size_t k = 0; k < n; ++k) {
+        window_[k] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * k / n));
+        window_power_ += static_cast<double>(window_[k]) * window_[k];
+    }
+    slots_.assign(config_.queue_segments, std::vector<std::complex<int16_t>>(n));
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        free_slots_.push_back(static_cast<int>(i));
+    }
+    latest_ = SpectrumSnapshot{0, 0.0, config_.sampling_rate_hz / n, 0, NaN, {}, {}, {}};
+
+    worker_ = std::thread(&SpectrumMonitor::run_worker, this);
+}
+
+SpectrumMonitor::~SpectrumMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_all();
+    worker_.join();
+}
+
+void SpectrumMonitor::enqueue(const WorkItem& item) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(item);
+    }
+    work_ready_.notify_one();
+}
+
+void SpectrumMonitor::tap(const std::complex<int16_t>* samples, int sample_count, double time_now) {
+    auto start = std::chrono::steady_clock::now();
+    const double cpu_start = thread_cpu_seconds();
+    if (!samples || sample_count <= 0) return;
+
+    // Earn budget for the generation time since the last tap, pay for the analysis done meanwhile
+    if (have_last_tap_) {
+        double wall = std::chrono::duration<double>(start - last_tap_).count();
+        credit_s_ = std::min(credit_s_ + config_.cpu_budget * wall, config_.cpu_budget * MAX_CREDIT_S);
+    }
+    double analysed_s = analysis_seconds_.load();
+    credit_s_ -= analysed_s - charged_s_;
+    charged_s_ = analysed_s;
+    last_tap_ = start;
+    have_last_tap_ = true;
+
+    // Snapshot markers go ahead of this chunk's segments
+    if (std::isnan(next_snapshot_time_)) {
+        next_snapshot_time_ = time_now + config_.snapshot_interval_s;
+    }
+    while (time_now >= next_snapshot_time_) {
+        enqueue(WorkItem{-1, next_snapshot_time_});
+        next_snapshot_time_ += config_.snapshot_interval_s;
+    }
+
+    const size_t n = config_.fft_size;
+    const size_t count = static_cast<size_t>(sample_count);
+    size_t i = 0;
+    while (i < count) {
+        if (fill_slot_ < 0) {
+            if (skip_remaining_ > 0) {
+                size_t skip = std::min(skip_remaining_, count - i);
+                skip_remaining_ -= skip;
+                i += skip;
+                continue;
+            }
+
+            // Queued segments and the candidate are paid in advance at the mean measured cost;
+            // the first one is measured alone
+            uint64_t analysed = segments_analysed_.load();
+            double estimate = analysed > 0 ? analysed_s / analysed : 0.0;
+            double in_flight = static_cast<double>(segments_admitted_ - analysed) * estimate;
+            bool admit = credit_s_ - in_flight - estimate > 0.0 && !(analysed == 0 && segments_admitted_ > 0);
+            if (admit) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!free_slots_.empty()) {
+                    fill_slot_ = free_slots_.back();
+                    free_slots_.pop_back();
+                }
+            }
+            if (fill_slot_ < 0) {
+                segments_skipped_++;
+                skip_remaining_ = n;
+                continue;
+            }
+            fill_count_ = 0;
+            segments_admitted_++;
+        }
+
+        size_t copy = std::min(n - fill_count_, count - i);
+        std::copy(samples + i, samples + i + copy, slots_[fill_slot_].data() + fill_count_);
+        fill_count_ += copy;
+        i += copy;
+        if (fill_count_ == n) {
+            enqueue(WorkItem{fill_slot_, time_now});
+            fill_slot_ = -1;
+            skip_remaining_ = (config_.min_segment_spacing - 1) * n;
+        }
+    }
+
+    stream_time_ = time_now + sample_count / config_.sampling_rate_hz;
+    // CPU time, like the analysis: a tap preempted under load has not used the budget
+    double spent = thread_cpu_seconds() - cpu_start;
+    tap_seconds_ += spent;
+    credit_s_ -= spent;
+}
+
+void SpectrumMonitor::flush() {
+    enqueue(WorkItem{-1, stream_time_});
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+    if (!error_.empty()) {
+        throw QuadGNSSException(error_);
+    }
+}
+
+SpectrumSnapshot SpectrumMonitor::latest_snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latest_;
+}
+
+SpectrumMonitorStats SpectrumMonitor::get_stats() const {
+    SpectrumMonitorStats stats;
+    stats.segments_analysed = segments_analysed_.load();
+    stats.segments_skipped = segments_skipped_;
+    stats.tap_seconds = tap_seconds_;
+    stats.analysis_seconds = analysis_seconds_.load();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.snapshots = snapshot_count_;
+    return stats;
+}
+
+void SpectrumMonitor::run_worker() {
+    for (;;) {
+        WorkItem item;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) break;
+            item = queue_.front();
+            queue_.pop_front();
+            busy_ = true;
+        }
+
+        double start = thread_cpu_seconds();
+        if (item.slot >= 0) {
+            analyse_segment(slots_[item.slot].data());
+        } else {
+            try {
+                emit_snapshot(item.time_s);
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = e.what();
+            }
+        }
+        analysis_seconds_.store(analysis_seconds_.load() + thread_cpu_seconds() - start);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (item.slot >= 0) {
+            free_slots_.push_back(item.slot);
+            segments_analysed_++;
+        }
+        busy_ = false;
+        if (queue_.empty()) idle_.notify_all();
+    }
+}
+
+void SpectrumMonitor::analyse_segment(const std::complex<int16_t>* samples) {
+    const size_t n = config_.fft_size;
+    std::vector<float>& re = segment_re_;
+    std::vector<float>& im = segment_im_;
+    for (size_t k = 0; k < n; ++k) {
+        re[k] = samples[k].real() * window_[k];
+        im[k] = samples[k].imag() * window_[k];
+    }
+    fft_.forward(re.data(), im.data());
+    for (size_t k = 0; k < n; ++k) {
+        accumulator_[k] += static_cast<double>(re[k]) * re[k] + static_cast<double>(im[k]) * im[k];
+    }
+    accumulated_segments_++;
+}
+
+void SpectrumMonitor::emit_snapshot(double time_s) {
+    if (accumulated_segments_ == 0) return;
+
+    // Welch average in LSB^2/Hz, rotated so that DC sits at fft_size/2
+    const size_t n = config_.fft_size;
+    const double scale = 1.0 / (accumulated_segments_ * config_.sampling_rate_hz * window_power_);
+    std::vector<double> psd(n);
+    SpectrumSnapshot snapshot;
+    snapshot.psd_db.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        psd[k] = std::max(accumulator_[(k + n / 2) % n] * scale, 1e-30);
+        snapshot.psd_db[k] = static_cast<float>(10.0 * std::log10(psd[k]));
+    }
+    snapshot.time_s = time_s;
+    snapshot.resolution_hz = config_.sampling_rate_hz / n;
+    snapshot.segments = accumulated_segments_;
+    evaluate_bands(snapshot, psd);
+
+    std::fill(accumulator_.begin(), accumulator_.end(), 0.0);
+    accumulated_segments_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot.index = ++snapshot_count_;
+        latest_ = snapshot;
+    }
+    if (!config_.snapshot_path.empty()) {
+        write_snapshot(snapshot);
+    }
+}
+
+void SpectrumMonitor::evaluate_bands(SpectrumSnapshot& snapshot, const std::vector<double>& psd) const {
+    const size_t n = psd.size();
+    const double resolution = snapshot.resolution_hz;
+    auto bin_frequency = [&](size_t k) { return (static_cast<double>(k) - n / 2.0) * resolution; };
+
+    // Noise floor: lower quartile of block means, robust to the occupied part of the band
+    const size_t block = std::max<size_t>(1, n / FLOOR_BLOCKS);
+    std::vector<double> means(n / block, 0.0);
+    for (size_t b = 0; b < means.size(); ++b) {
+        for (size_t k = b * block; k < (b + 1) * block; ++k) means[b] += psd[k];
+        means[b] /= block;
+    }
+    std::vector<double> sorted = means;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 4, sorted.end());
+    const double floor = sorted[sorted.size() / 4];
+    const double unexpected = std::pow(10.0, config_.unexpected_threshold_db / 10.0);
+    snapshot.floor_db = 10.0 * std::log10(floor);
+
+    snapshot.bands.clear();
+    std::vector<double> guards;
+    for (const auto& band : bands_) {
+        BandOccupancy result{band.name, band.offset_hz, NaN, NaN, BandStatus::OUTSIDE_STREAM};
+        if (std::abs(band.offset_hz) < config_.sampling_rate_hz / 2.0) {
+            long low = std::max(0L, static_cast<long>(std::ceil((band.offset_hz - band.half_width_hz) / resolution)) + static_cast<long>(n / 2));
+            long high = std::min(static_cast<long>(n) - 1, static_cast<long>(std::floor((band.offset_hz + band.half_width_hz) / resolution)) + static_cast<long>(n / 2));
+            double sum = 0.0, excess = 0.0, moment = 0.0;
+            for (long k = low; k <= high; ++k) {
+                double above = std::max(0.0, psd[k] - floor);
+                sum += psd[k];
+                excess += above;
+                moment += above * bin_frequency(k);
+            }
+            result.excess_db = 10.0 * std::log10(sum / (high - low + 1) / floor);
+
+            // Sidelobes fall off as 1/(pi*f/w)^2 from the lobe peak; nearer than where they drop
+            // under the unexpected-power threshold, power is attributed to this band
+            double peak = 0.0;
+            for (size_t b = low / block; b <= static_cast<size_t>(high) / block; ++b) peak = std::max(peak, means[b]);
+            guards.push_back(std::max(band.half_width_hz,
+                                      band.half_width_hz / M_PI * std::sqrt(peak / floor / (unexpected - 1.0))));
+            result.measured_offset_hz = excess > 0.0 ? moment / excess : NaN;
+            double tolerance = std::max(2.0 * resolution, 0.1 * band.half_width_hz);
+            if (result.excess_db < config_.occupancy_threshold_db) {
+                result.status = BandStatus::MISSING;
+            } else if (std::abs(result.measured_offset_hz - band.offset_hz) > tolerance) {
+                result.status = BandStatus::OFFSET;
+            } else {
+                result.status = BandStatus::OK;
+            }
+        }
+        if (guards.size() < snapshot.bands.size() + 1) guards.push_back(band.half_width_hz);
+        snapshot.bands.push_back(result);
+    }
+
+    // Occupied blocks away from every expected lobe and its visible sidelobes
+    snapshot.unexpected.clear();
+    bool open = false;
+    for (size_t b = 0; b < means.size(); ++b) {
+        double low = bin_frequency(b * block);
+        double high = bin_frequency((b + 1) * block - 1) + resolution;
+        bool guarded = false;
+        for (size_t i = 0; i < bands_.size() && !guarded; ++i) {
+            // Sidelobes past +/- fs/2 alias back into the stream
+            double centre = std::remainder((low + high) / 2.0 - bands_[i].offset_hz, config_.sampling_rate_hz);
+            guarded = std::abs(centre) < guards[i] + (high - low) / 2.0;
+        }
+        bool occupied = !guarded && means[b] > floor * unexpected;
+        if (occupied && !open) {
+            snapshot.unexpected.push_back(OccupiedSpan{low, high, 0.0});
+        }
+        if (occupied) {
+            snapshot.unexpected.back().high_hz = high;
+            snapshot.unexpected.back().peak_excess_db =
+                std::max(snapshot.unexpected.back().peak_excess_db, 10.0 * std::log10(means[b] / floor));
+        }
+        open = occupied;
+    }
+}
+
+void SpectrumMonitor::write_snapshot(const SpectrumSnapshot& snapshot) const {
+    std::string text;
+    char line[256];
+    std::snprintf(line, sizeof(line), "# QuadGNSS spectrum snapshot %llu\n# time_s %.6f\n",
+                  static_cast<unsigned long long>(snapshot.index), snapshot.time_s);
+    text += line;
+    std::snprintf(line, sizeof(line), "# center_frequency_hz %.1f sampling_rate_hz %.1f resolution_hz %.3f segments %llu\n",
+                  config_.center_frequency_hz, config_.sampling_rate_hz, snapshot.resolution_hz,
+                  static_cast<unsigned long long>(snapshot.segments));
+    text += line;
+    std::snprintf(line, sizeof(line), "# floor_db %.2f\n# band name expected_offset_hz measured_offset_hz excess_db status\n",
+                  snapshot.floor_db);
+    text += line;
+    for (const auto& band : snapshot.bands) {
+        std::snprintf(line, sizeof(line), "band %s %.1f %.1f %.2f %s\n", band.name.c_str(), band.expected_offset_hz,
+                      band.measured_offset_hz, band.excess_db, band_status_name(band.status));
+        text += line;
+    }
+    for (const auto& span : snapshot.unexpected) {
+        std::snprintf(line, sizeof(line), "unexpected %.1f %.1f %.2f\n", span.low_hz, span.high_hz, span.peak_excess_db);
+        text += line;
+    }
+    text += "# offset_hz psd_db\n";
+    const size_t n = snapshot.psd_db.size();
+    for (size_t k = 0; k < n; ++k) {
+        std::snprintf(line, sizeof(line), "%.1f %.2f\n", (static_cast<double>(k) - n / 2.0) * snapshot.resolution_hz,
+                      snapshot.psd_db[k]);
+        text += line;
+    }
+
+    // Readers never see a half-written snapshot
+    const std::string temporary = config_.snapshot_path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "w");
+    bool ok = file && std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = file && std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temporary.c_str(), config_.snapshot_path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw QuadGNSSException("Cannot write spectrum snapshot " + config_.snapshot_path);
+    }
+}
+
+void SpectrumTapStage::process(const StageBuffer* inputs, const StageBuffer*, int sample_count, double time_now) {
+    monitor_.tap(inputs[0].ci16(), sample_count, time_now);
+}
+
+} // namespace QuadGNSS
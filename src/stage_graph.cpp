@@ -0,0 +1,537 @@
+#include "../include/stage_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace QuadGNSS {
+
+namespace {
+
+const char* port_type_name(PortType type) {
+    return type == PortType::COMPLEX_INT16 ? "complex<int16>" : "complex<float>";
+}
+
+void copy_input(const StageBuffer& input, const StageBuffer& output, int sample_count) {
+    if (input.data != output.data) {
+        std::memcpy(output.cf32(), input.cf32(), sizeof(std::complex<float>) * sample_count);
+    }
+}
+
+} // namespace
+
+// Built-in stages
+
+void ConstellationSourceStage::process(const StageBuffer*, const StageBuffer* output, int sample_count, double time_now) {
+    constellation_.generate_chunk(output->ci16(), sample_count, time_now);
+}
+
+SumCombinerStage::SumCombinerStage(size_t input_count) : input_count_(input_count) {
+    if (input_count == 0) {
+        throw QuadGNSSException("Sum stage needs at least one input");
+    }
+}
+
+std::vector<PortType> SumCombinerStage::input_types() const {
+    return std::vector<PortType>(input_count_, PortType::COMPLEX_INT16);
+}
+
+void SumCombinerStage::process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double) {
+    std::complex<float>* out = output->cf32();
+    const std::complex<int16_t>* first = inputs[0].ci16();
+    for (int i = 0; i < sample_count; ++i) {
+        out[i] = std::complex<float>(first[i].real(), first[i].imag());
+    }
+    for (size_t port = 1; port < input_count_; ++port) {
+        const std::complex<int16_t>* in = inputs[port].ci16();
+        for (int i = 0; i < sample_count; ++i) {
+            out[i] += std::complex<float>(in[i].real(), in[i].imag());
+        }
+    }
+}
+
+GainStage::GainStage(double gain_db) : gain_(static_cast<float>(std::pow(10.0, gain_db / 20.0))) {
+}
+
+void GainStage::process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) {
+    copy_input(inputs[0], *output, sample_count);
+    process_inplace(*output, 0, sample_count, time_now);
+}
+
+void GainStage::process_inplace(const StageBuffer& buffer, int offset, int count, double) {
+    std::complex<float>* samples = buffer.cf32() + offset;
+    for (int i = 0; i < count; ++i) {
+        samples[i] *= gain_;
+    }
+}
+
+FrequencyShiftStage::FrequencyShiftStage(double shift_hz, double sampling_rate_hz)
+    : cycles_per_sample_(shift_hz / sampling_rate_hz), sampling_rate_hz_(sampling_rate_hz)
+    , chunk_start_cycles_(0.0) {
+    if (sampling_rate_hz <= 0.0) {
+        throw QuadGNSSException("Frequency shift needs a positive sampling rate");
+    }
+}
+
+void FrequencyShiftStage::begin_chunk(int, double time_now) {
+    // Phase follows absolute time, so chunks of any size line up
+    double cycles = cycles_per_sample_ * sampling_rate_hz_ * time_now;
+    chunk_start_cycles_ = cycles - std::floor(cycles);
+}
+
+void FrequencyShiftStage::process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) {
+    copy_input(inputs[0], *output, sample_count);
+    begin_chunk(sample_count, time_now);
+    process_inplace(*output, 0, sample_count, time_now);
+}
+
+void FrequencyShiftStage::process_inplace(const StageBuffer& buffer, int offset, int count, double) {
+    std::complex<float>* samples = buffer.cf32() + offset;
+    for (int i = 0; i < count; ++i) {
+        double cycles = chunk_start_cycles_ + cycles_per_sample_ * (offset + i);
+        double angle = 2.0 * M_PI * (cycles - std::floor(cycles));
+        samples[i] *= std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+}
+
+NoiseStage::NoiseStage(double sigma, uint64_t seed)
+    : generator_(seed), distribution_(0.0f, static_cast<float>(sigma)) {
+    if (sigma < 0.0) {
+        throw QuadGNSSException("Noise sigma must be non-negative");
+    }
+}
+
+void NoiseStage::process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double time_now) {
+    copy_input(inputs[0], *output, sample_count);
+    process_inplace(*output, 0, sample_count, time_now);
+}
+
+void NoiseStage::process_inplace(const StageBuffer& buffer, int offset, int count, double) {
+    std::complex<float>* samples = buffer.cf32() + offset;
+    for (int i = 0; i < count; ++i) {
+        float re = distribution_(generator_);
+        float im = distribution_(generator_);
+        samples[i] += std::complex<float>(re, im);
+    }
+}
+
+void QuantizeStage::process(const StageBuffer* inputs, const StageBuffer* output, int sample_count, double) {
+    const std::complex<float>* in = inputs[0].cf32();
+    std::complex<int16_t>* out = output->ci16();
+    for (int i = 0; i < sample_count; ++i) {
+        float re = std::max(-32768.0f, std::min(32767.0f, std::nearbyint(in[i].real())));
+        float im = std::max(-32768.0f, std::min(32767.0f, std::nearbyint(in[i].imag())));
+        out[i] = std::complex<int16_t>(static_cast<int16_t>(re), static_cast<int16_t>(im));
+    }
+}
+
+void CallbackSourceStage::process(const StageBuffer*, const StageBuffer* output, int sample_count, double time_now) {
+    callback_(output->ci16(), sample_count, time_now);
+}
+
+void CallbackSinkStage::process(const StageBuffer* inputs, const StageBuffer*, int sample_count, double time_now) {
+    callback_(inputs[0].ci16(), sample_count, time_now);
+}
+
+// StageGraph
+
+StageGraph::StageGraph(size_t worker_threads)
+    : fused_stages_(0), max_samples_(0), compiled_(false)
+    , current_level_(nullptr), next_task_(0), pending_tasks_(0)
+    , chunk_samples_(0), chunk_time_(0.0), generation_(0), stopping_(false) {
+    for (size_t i = 0; i < worker_threads; ++i) {
+        workers_.emplace_back(&StageGraph::worker_loop, this);
+    }
+}
+
+StageGraph::~StageGraph() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t StageGraph::add_stage(const std::string& name, std::unique_ptr<IStage> stage) {
+    if (compiled_) {
+        throw QuadGNSSException("Cannot add stages to a compiled graph");
+    }
+    if (!stage || name.empty()) {
+        throw QuadGNSSException("Stage needs a name and an implementation");
+    }
+    for (const auto& node : nodes_) {
+        if (node.name == name) {
+            throw QuadGNSSException("Duplicate stage name: " + name);
+        }
+    }
+    if (stage->is_elementwise() && (stage->kind() != StageKind::TRANSFORM ||
+                                    stage->input_types().size() != 1 ||
+                                    stage->input_types()[0] != stage->output_type())) {
+        throw QuadGNSSException("Element-wise stage " + name + " must be a same-type transform");
+    }
+
+    Node node;
+    node.name = name;
+    node.inputs.assign(stage->input_types().size(), -1);
+    node.stage = std::move(stage);
+    nodes_.push_back(std::move(node));
+    return nodes_.size() - 1;
+}
+
+size_t StageGraph::find_stage(const std::string& name) const {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i].name == name) return i;
+    }
+    throw QuadGNSSException("Unknown stage: " + name);
+}
+
+void StageGraph::connect(const std::string& from, const std::string& to, size_t input_port) {
+    connect(find_stage(from), find_stage(to), input_port);
+}
+
+void StageGraph::set_output_target(size_t stage, std::function<void*()> target) {
+    if (compiled_) {
+        throw QuadGNSSException("Cannot retarget a compiled graph");
+    }
+    if (stage >= nodes_.size()) {
+        throw QuadGNSSException("Unknown stage id");
+    }
+    if (nodes_[stage].stage->kind() == StageKind::SINK || !target) {
+        throw QuadGNSSException("Output target of " + nodes_[stage].name + " needs a stage with an output");
+    }
+    nodes_[stage].output_target = std::move(target);
+}
+
+void StageGraph::connect(size_t from, size_t to, size_t input_port) {
+    if (compiled_) {
+        throw QuadGNSSException("Cannot rewire a compiled graph");
+    }
+    if (from >= nodes_.size() || to >= nodes_.size()) {
+        throw QuadGNSSException("Unknown stage id");
+    }
+    Node& producer = nodes_[from];
+    Node& consumer = nodes_[to];
+    if (producer.stage->kind() == StageKind::SINK) {
+        throw QuadGNSSException("Sink " + producer.name + " has no output");
+    }
+    if (input_port >= consumer.inputs.size()) {
+        throw QuadGNSSException("Stage " + consumer.name + " has no input port " + std::to_string(input_port));
+    }
+    if (consumer.inputs[input_port] != -1) {
+        throw QuadGNSSException("Input " + std::to_string(input_port) + " of " + consumer.name + " is already connected");
+    }
+    PortType produced = producer.stage->output_type();
+    PortType expected = consumer.stage->input_types()[input_port];
+    if (produced != expected) {
+        throw QuadGNSSException("Type mismatch " + producer.name + " (" + port_type_name(produced) + ") -> " +
+                                consumer.name + " (" + port_type_name(expected) + ")");
+    }
+    consumer.inputs[input_port] = static_cast<long>(from);
+    producer.consumers.push_back(to);
+}
+
+void StageGraph::compile(int max_samples) {
+    if (compiled_) {
+        throw QuadGNSSException("Graph is already compiled");
+    }
+    if (max_samples <= 0) {
+        throw QuadGNSSException("max_samples must be positive");
+    }
+
+    bool has_sink = false;
+    for (const auto& node : nodes_) {
+        for (size_t port = 0; port < node.inputs.size(); ++port) {
+            if (node.inputs[port] < 0) {
+                throw QuadGNSSException("Input " + std::to_string(port) + " of " + node.name + " is not connected");
+            }
+        }
+        if (node.stage->kind() == StageKind::SINK) {
+            has_sink = true;
+        } else if (node.consumers.empty()) {
+            throw QuadGNSSException("Output of " + node.name + " is not consumed");
+        }
+    }
+    if (!has_sink) {
+        throw QuadGNSSException("Graph has no sink");
+    }
+
+    // Topological order (Kahn)
+    std::vector<size_t> missing(nodes_.size());
+    std::vector<size_t> order;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        missing[i] = nodes_[i].inputs.size();
+        if (missing[i] == 0) order.push_back(i);
+    }
+    for (size_t k = 0; k < order.size(); ++k) {
+        for (size_t consumer : nodes_[order[k]].consumers) {
+            if (--missing[consumer] == 0) order.push_back(consumer);
+        }
+    }
+    if (order.size() != nodes_.size()) {
+        throw QuadGNSSException("Stage graph contains a cycle");
+    }
+
+    // Fuse element-wise transforms into a producer that feeds only them
+    tasks_.clear();
+    fused_stages_ = 0;
+    std::vector<size_t> output_node;               // Node whose output a task publishes
+    for (size_t index : order) {
+        Node& node = nodes_[index];
+        if (node.stage->is_elementwise()) {
+            size_t producer = static_cast<size_t>(node.inputs[0]);
+            if (nodes_[producer].consumers.size() == 1) {
+                node.task = nodes_[producer].task;
+                tasks_[node.task].fused.push_back(index);
+                output_node[node.task] = index;
+                fused_stages_++;
+                continue;
+            }
+        }
+        Task task;
+        task.head = index;
+        node.task = tasks_.size();
+        tasks_.push_back(task);
+        output_node.push_back(index);
+    }
+
+    // Levels: a task runs after every task it reads from
+    size_t level_count = 0;
+    for (auto& task : tasks_) {
+        task.level = 0;
+        for (long producer : nodes_[task.head].inputs) {
+            task.level = std::max(task.level, tasks_[nodes_[producer].task].level + 1);
+        }
+        level_count = std::max(level_count, task.level + 1);
+    }
+    levels_.assign(level_count, {});
+    for (size_t t = 0; t < tasks_.size(); ++t) {
+        levels_[tasks_[t].level].push_back(t);
+    }
+
+    // Last level at which each task's output is read
+    std::vector<size_t> last_use(tasks_.size(), 0);
+    for (size_t t = 0; t < tasks_.size(); ++t) {
+        for (size_t consumer : nodes_[output_node[t]].consumers) {
+            last_use[t] = std::max(last_use[t], tasks_[nodes_[consumer].task].level);
+        }
+    }
+
+    // Interval allocation: a slot is reused once its last reader's level has finished
+    pool_.clear();
+    std::vector<long> slot_free_after;              // Level after which the slot is free (-1 = never used)
+    for (size_t level = 0; level < levels_.size(); ++level) {
+        for (size_t t : levels_[level]) {
+            Task& task = tasks_[t];
+            if (nodes_[task.head].stage->kind() == StageKind::SINK) continue;
+
+            PortType type = nodes_[task.head].stage->output_type();
+            std::function<void*()> target = nodes_[task.head].output_target;
+            for (size_t index : task.fused) {
+                if (nodes_[index].output_target) target = nodes_[index].output_target;
+            }
+            if (target) {
+                // Caller memory is never shared with another task
+                PoolBuffer buffer;
+                buffer.type = type;
+                buffer.target = std::move(target);
+                pool_.push_back(std::move(buffer));
+                slot_free_after.push_back(0);
+                task.output_buffer = static_cast<long>(pool_.size() - 1);
+                continue;
+            }
+
+            long slot = -1;
+            for (size_t s = 0; s < pool_.size(); ++s) {
+                if (pool_[s].type == type && !pool_[s].target && slot_free_after[s] < static_cast<long>(level)) {
+                    slot = static_cast<long>(s);
+                    break;
+                }
+            }
+            if (slot < 0) {
+                PoolBuffer buffer;
+                buffer.type = type;
+                buffer.storage.assign(static_cast<size_t>(max_samples), std::complex<float>(0.0f, 0.0f));
+                pool_.push_back(std::move(buffer));
+                slot_free_after.push_back(0);
+                slot = static_cast<long>(pool_.size() - 1);
+            }
+            slot_free_after[slot] = static_cast<long>(last_use[t]);
+            task.output_buffer = slot;
+        }
+    }
+    for (auto& task : tasks_) {
+        for (long producer : nodes_[task.head].inputs) {
+            task.input_buffers.push_back(static_cast<size_t>(tasks_[nodes_[producer].task].output_buffer));
+        }
+    }
+
+    max_samples_ = max_samples;
+    compiled_ = true;
+}
+
+StageBuffer StageGraph::view(size_t slot, int sample_count) {
+    PoolBuffer& buffer = pool_[slot];
+    return StageBuffer{buffer.type, buffer.target ? buffer.external : buffer.storage.data(), sample_count};
+}
+
+void StageGraph::execute_task(size_t task_index, int sample_count, double time_now) {
+    const Task& task = tasks_[task_index];
+    StageBuffer inputs[16];
+    std::vector<StageBuffer> many_inputs;
+    StageBuffer* input_views = inputs;
+    if (task.input_buffers.size() > 16) {
+        many_inputs.resize(task.input_buffers.size());
+        input_views = many_inputs.data();
+    }
+    for (size_t port = 0; port < task.input_buffers.size(); ++port) {
+        input_views[port] = view(task.input_buffers[port], sample_count);
+    }
+
+    StageBuffer output{};
+    bool has_output = task.output_buffer >= 0;
+    if (has_output) {
+        output = view(static_cast<size_t>(task.output_buffer), sample_count);
+    }
+    nodes_[task.head].stage->process(task.input_buffers.empty() ? nullptr : input_views,
+                                     has_output ? &output : nullptr, sample_count, time_now);
+
+    if (task.fused.empty()) return;
+    for (size_t index : task.fused) {
+        nodes_[index].stage->begin_chunk(sample_count, time_now);
+    }
+    for (int offset = 0; offset < sample_count; offset += FUSED_TILE_SAMPLES) {
+        int count = std::min(FUSED_TILE_SAMPLES, sample_count - offset);
+        for (size_t index : task.fused) {
+            nodes_[index].stage->process_inplace(output, offset, count, time_now);
+        }
+    }
+}
+
+void StageGraph::run(int sample_count, double time_now) {
+    if (!compiled_) {
+        throw QuadGNSSException("Stage graph is not compiled");
+    }
+    if (sample_count <= 0 || sample_count > max_samples_) {
+        throw QuadGNSSException("Chunk of " + std::to_string(sample_count) + " samples exceeds the compiled maximum");
+    }
+    for (auto& buffer : pool_) {
+        if (!buffer.target) continue;
+        buffer.external = buffer.target();
+        if (!buffer.external) {
+            throw QuadGNSSException("Stage output target returned no buffer");
+        }
+    }
+
+    for (const auto& level : levels_) {
+        if (workers_.empty() || level.size() == 1) {
+            for (size_t t : level) {
+                execute_task(t, sample_count, time_now);
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        current_level_ = &level;
+        next_task_ = 0;
+        pending_tasks_ = level.size();
+        chunk_samples_ = sample_count;
+        chunk_time_ = time_now;
+        task_error_.clear();
+        generation_++;
+        work_cv_.notify_all();
+        done_cv_.wait(lock, [this] { return pending_tasks_ == 0; });
+        current_level_ = nullptr;
+        if (!task_error_.empty()) {
+            throw QuadGNSSException("Stage failed: " + task_error_);
+        }
+    }
+}
+
+void StageGraph::worker_loop() {
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_cv_.wait(lock, [&] { return stopping_ || (current_level_ && generation_ != seen_generation); });
+        if (stopping_) return;
+
+        // Claim tasks of the current level until none are left
+        while (current_level_ && next_task_ < current_level_->size()) {
+            size_t task = (*current_level_)[next_task_++];
+            int sample_count = chunk_samples_;
+            double time_now = chunk_time_;
+            lock.unlock();
+            std::string error;
+            try {
+                execute_task(task, sample_count, time_now);
+            } catch (const std::exception& e) {
+                error = nodes_[tasks_[task].head].name + ": " + e.what();
+            }
+            lock.lock();
+            if (!error.empty() && task_error_.empty()) {
+                task_error_ = error;
+            }
+            if (--pending_tasks_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+        seen_generation = generation_;
+    }
+}
+
+// Declarative construction
+
+std::unique_ptr<StageGraph> build_stage_graph(const std::vector<StageSpec>& specs,
+                                              std::map<std::string, std::unique_ptr<IStage>>& external_stages,
+                                              const GlobalConfig& config,
+                                              size_t worker_threads) {
+    auto graph = std::make_unique<StageGraph>(worker_threads);
+
+    auto param = [](const StageSpec& spec, const std::string& key) {
+        auto it = spec.params.find(key);
+        if (it == spec.params.end()) {
+            throw QuadGNSSException("Stage " + spec.name + " (" + spec.type + ") needs parameter " + key);
+        }
+        return it->second;
+    };
+
+    for (const auto& spec : specs) {
+        std::unique_ptr<IStage> stage;
+        if (spec.type == "sum") {
+            stage = std::make_unique<SumCombinerStage>(spec.inputs.size());
+        } else if (spec.type == "gain") {
+            stage = std::make_unique<GainStage>(param(spec, "gain_db"));
+        } else if (spec.type == "frequency_shift") {
+            stage = std::make_unique<FrequencyShiftStage>(param(spec, "shift_hz"), config.sampling_rate_hz);
+        } else if (spec.type == "noise") {
+            auto seed = spec.params.find("seed");
+            stage = std::make_unique<NoiseStage>(param(spec, "sigma"),
+                                                 seed == spec.params.end() ? 1 : static_cast<uint64_t>(seed->second));
+        } else if (spec.type == "quantize") {
+            stage = std::make_unique<QuantizeStage>();
+        } else if (spec.type == "external") {
+            auto it = external_stages.find(spec.name);
+            if (it == external_stages.end() || !it->second) {
+                throw QuadGNSSException("No external stage provided for " + spec.name);
+            }
+            stage = std::move(it->second);
+        } else {
+            throw QuadGNSSException("Unknown stage type '" + spec.type + "' for " + spec.name);
+        }
+        graph->add_stage(spec.name, std::move(stage));
+    }
+
+    for (const auto& spec : specs) {
+        for (size_t port = 0; port < spec.inputs.size(); ++port) {
+            graph->connect(spec.inputs[port], spec.name, port);
+        }
+    }
+    return graph;
+}
+
+} // namespace QuadGNSS
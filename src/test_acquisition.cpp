@@ -0,0 +1,220 @@
+#include "../include/acquisition.h"
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace QuadGNSS;
+
+struct Satellite {
+    int prn;
+    double power_dbm;
+};
+
+// Render one band with the multi-band generator and add white noise (sigma in LSB per component)
+static std::vector<std::complex<int16_t>> render_block(MultiBandGenerator& generator, size_t samples,
+                                                       double time_now, double noise_sigma) {
+    std::vector<std::complex<int16_t>> block(samples);
+    std::complex<int16_t>* buffers[1] = {block.data()};
+    generator.generate_chunk(buffers, static_cast<int>(samples), time_now);
+
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, noise_sigma);
+    for (auto& s : block) {
+        if (noise_sigma == 0.0) break;
+        double re = s.real() + noise(rng);
+        double im = s.imag() + noise(rng);
+        s = std::complex<int16_t>(static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, std::round(re)))),
+                                  static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, std::round(im)))));
+    }
+    return block;
+}
+
+static void print_results(const std::vector<AcquisitionResult>& results) {
+    for (const auto& r : results) {
+        std::cout << "  " << get_band_info(r.band).name << " PRN " << std::setw(2) << r.prn;
+        if (!r.detected) {
+            std::cout << "  not detected (peak ratio " << std::setprecision(2) << std::fixed << r.peak_ratio << ")" << std::endl;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(3) << "  phase " << std::setw(9) << r.code_phase_chips
+                  << " (err " << std::setw(6) << r.code_phase_error_chips << ")  Doppler " << std::setprecision(1)
+                  << std::setw(7) << r.doppler_hz << " Hz (err " << std::setw(5) << r.doppler_error_hz
+                  << ")  C/N0 " << r.cn0_dbhz << " dB-Hz";
+        if (!std::isnan(r.cn0_error_db)) std::cout << " (err " << r.cn0_error_db << ")";
+        std::cout << "  ratio " << r.peak_ratio << std::endl;
+    }
+}
+
+bool test_l1_with_noise() {
+    std::cout << "=== L1 C/A Acquisition Test ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 5e6;
+    config.center_frequency_hz = 1575.42e6 - 1.25e6;           // Signal at +1.25 MHz, non-integer samples per chip
+    config.receiver.x_m = 4027894.0;
+    config.receiver.y_m = 307046.0;
+    config.receiver.z_m = 4919474.0;
+
+    const double gain_db = -20.0;
+    const double noise_sigma = 889.0;                          // 45 dB-Hz at -130 dBm
+    const Satellite satellites[] = {{1, -130.0}, {5, -128.0}, {9, -132.0}, {14, -126.0}, {22, -130.0}};
+
+    MultiBandGenerator generator(config);
+    for (const auto& s : satellites) {
+        generator.backbone().add_satellite(ConstellationType::GPS, s.prn, s.power_dbm);
+    }
+    generator.add_band(BandStreamConfig{SignalBand::GPS_L1CA, config.center_frequency_hz, gain_db});
+
+    AcquisitionSettings settings;
+    settings.sampling_rate_hz = config.sampling_rate_hz;
+    settings.center_frequency_hz = config.center_frequency_hz;
+    AcquisitionEngine engine(settings);
+
+    const double time_now = 345600.0;
+    size_t samples = engine.required_samples(SignalBand::GPS_L1CA);
+    auto block = render_block(generator, samples, time_now, noise_sigma);
+
+    std::vector<AcquisitionTarget> targets;
+    for (const auto& sat : generator.backbone().satellites()) {
+        AcquisitionTarget target = make_acquisition_target(generator.backbone(), sat, SignalBand::GPS_L1CA, time_now);
+        double amplitude = band_component_amplitude(SignalBand::GPS_L1CA, sat.power_dbm, gain_db);
+        target.expected_cn0_dbhz = 10.0 * std::log10(amplitude * amplitude * config.sampling_rate_hz /
+                                                     (2.0 * noise_sigma * noise_sigma));
+        targets.push_back(target);
+    }
+    AcquisitionTarget absent;
+    absent.band = SignalBand::GPS_L1CA;
+    absent.prn = 30;
+    targets.push_back(absent);
+
+    auto results = engine.acquire(block.data(), block.size(), targets);
+    print_results(results);
+    std::cout << "  " << samples << " samples, " << engine.get_fft_count() << " FFTs in "
+              << std::setprecision(3) << engine.get_last_elapsed() << " s" << std::endl;
+
+    bool ok = results.size() == 6 && !results[5].detected;
+    for (size_t i = 0; i < 5 && ok; ++i) {
+        ok = within_tolerance(results[i]) && !std::isnan(results[i].cn0_error_db);
+    }
+    return ok;
+}
+
+bool test_e5a_pilot_and_threads() {
+    std::cout << "=== E5a Pilot Acquisition Test ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 25e6;                            // Incommensurate with the chip rate: sub-sample phase resolution
+    config.center_frequency_hz = 1176.45e6;
+    config.receiver.x_m = -2694685.0;
+    config.receiver.y_m = -4293642.0;
+    config.receiver.z_m = 3857878.0;
+
+    MultiBandGenerator generator(config);
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 11, -128.0);
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 19, -131.0);
+    generator.add_band(BandStreamConfig{SignalBand::GALILEO_E5A, 0.0});
+
+    AcquisitionSettings settings;
+    settings.sampling_rate_hz = config.sampling_rate_hz;
+    settings.center_frequency_hz = config.center_frequency_hz;
+    settings.integration_ms = 4.0;
+    settings.threads = 1;
+    AcquisitionEngine serial(settings);
+    settings.threads = 3;
+    AcquisitionEngine parallel(settings);
+
+    const double time_now = 2000.25;
+    auto block = render_block(generator, serial.required_samples(SignalBand::GALILEO_E5A), time_now, 0.0);
+    std::vector<AcquisitionTarget> targets;
+    for (const auto& sat : generator.backbone().satellites()) {
+        targets.push_back(make_acquisition_target(generator.backbone(), sat, SignalBand::GALILEO_E5A, time_now));
+    }
+
+    auto one = serial.acquire(block.data(), block.size(), targets);
+    auto three = parallel.acquire(block.data(), block.size(), targets);
+    print_results(three);
+    std::cout << "  1 thread " << std::setprecision(3) << serial.get_last_elapsed() << " s, 3 threads "
+              << parallel.get_last_elapsed() << " s" << std::endl;
+
+    bool ok = one.size() == 2 && one[0].pilot && within_tolerance(one[0]) && within_tolerance(one[1]);
+    for (size_t i = 0; i < one.size() && ok; ++i) {
+        ok = one[i].code_phase_chips == three[i].code_phase_chips && one[i].doppler_hz == three[i].doppler_hz &&
+             one[i].cn0_dbhz == three[i].cn0_dbhz;
+    }
+
+    // A block shorter than the search span is rejected
+    try {
+        serial.acquire(block.data(), 1000, targets);
+        ok = false;
+    } catch (const QuadGNSSException&) {
+    }
+    return ok;
+}
+
+// Galileo E1 (BOC(1,1) pilot) and GLONASS L1OF (one IF per FDMA channel) in one summed stream
+bool test_e1_and_glonass() {
+    std::cout << "=== E1 BOC and GLONASS FDMA Acquisition Test ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 40e6;
+    config.center_frequency_hz = 1588.7e6;
+    config.receiver.x_m = 4027894.0;
+    config.receiver.y_m = 307046.0;
+    config.receiver.z_m = 4919474.0;
+
+    MultiBandGenerator generator(config);
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 11, -128.0);
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 19, -130.0);
+    generator.backbone().add_satellite(ConstellationType::GLONASS, 2, -130.0, -4);
+    generator.backbone().add_satellite(ConstellationType::GLONASS, 1, -130.0, 1);
+    generator.backbone().add_satellite(ConstellationType::GLONASS, 9, -131.0, -2);
+    generator.add_band(BandStreamConfig{SignalBand::GALILEO_E1, config.center_frequency_hz});
+    generator.add_band(BandStreamConfig{SignalBand::GLONASS_L1OF, config.center_frequency_hz});
+
+    AcquisitionSettings settings;
+    settings.sampling_rate_hz = config.sampling_rate_hz;
+    settings.center_frequency_hz = config.center_frequency_hz;
+    AcquisitionEngine engine(settings);
+    size_t samples = std::max(engine.required_samples(SignalBand::GALILEO_E1),
+                              engine.required_samples(SignalBand::GLONASS_L1OF, -4));
+
+    const double time_now = 345600.5;
+    std::vector<std::complex<int16_t>> e1(samples), glonass(samples), block(samples);
+    std::complex<int16_t>* buffers[2] = {e1.data(), glonass.data()};
+    generator.generate_chunk(buffers, static_cast<int>(samples), time_now);
+    for (size_t i = 0; i < samples; ++i) {
+        block[i] = std::complex<int16_t>(static_cast<int16_t>(e1[i].real() + glonass[i].real()),
+                                         static_cast<int16_t>(e1[i].imag() + glonass[i].imag()));
+    }
+
+    std::vector<AcquisitionTarget> targets;
+    for (const auto& sat : generator.backbone().satellites()) {
+        SignalBand band = sat.constellation == ConstellationType::GALILEO ? SignalBand::GALILEO_E1
+                                                                          : SignalBand::GLONASS_L1OF;
+        targets.push_back(make_acquisition_target(generator.backbone(), sat, band, time_now));
+    }
+    // GLONASS slot 9 searched on the wrong channel is not found
+    AcquisitionTarget wrong_channel = targets.back();
+    wrong_channel.frequency_channel = 3;
+    targets.push_back(wrong_channel);
+
+    auto results = engine.acquire(block.data(), block.size(), targets);
+    print_results(results);
+
+    bool ok = results.size() == 6 && results[0].pilot && !results[5].detected;
+    for (size_t i = 0; i < 5 && ok; ++i) {
+        ok = within_tolerance(results[i]);
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = test_l1_with_noise();
+    ok = test_e5a_pilot_and_threads() && ok;
+    ok = test_e1_and_glonass() && ok;
+
+    if (ok) {
+        std::cout << "✅ Acquisition tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Acquisition tests failed" << std::endl;
+    return 1;
+}
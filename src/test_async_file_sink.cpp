@@ -0,0 +1,136 @@
+#include "../include/async_file_sink.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static uint8_t pattern_byte(uint64_t position) {
+    return static_cast<uint8_t>(position * 7 + (position >> 13));
+}
+
+static bool file_matches(const std::string& path, uint64_t expected_size) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (contents.size() != expected_size) {
+        std::cout << "  Size " << contents.size() << ", expected " << expected_size << std::endl;
+        return false;
+    }
+    for (uint64_t i = 0; i < expected_size; ++i) {
+        if (static_cast<uint8_t>(contents[i]) != pattern_byte(i)) {
+            std::cout << "  Mismatch at byte " << i << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_round_trip(FileSinkBackend backend, bool direct_io) {
+    const std::string path = "async_sink_test_" + std::to_string(getpid()) + ".bin";
+
+    FileSinkOptions options;
+    options.backend = backend;
+    options.buffer_bytes = 64 * 1024;
+    options.queue_depth = 4;
+    options.direct_io = direct_io;
+
+    // Odd-sized writes straddle buffer boundaries and leave an unaligned tail
+    const size_t write_bytes = 10007;
+    const int write_count = 333;
+    std::vector<char> block(write_bytes);
+
+    FileSinkStats stats;
+    try {
+        AsyncFileSink sink(path, options);
+        uint64_t position = 0;
+        for (int w = 0; w < write_count; ++w) {
+            for (size_t i = 0; i < write_bytes; ++i) {
+                block[i] = static_cast<char>(pattern_byte(position + i));
+            }
+            sink.write(block.data(), write_bytes);
+            position += write_bytes;
+        }
+        sink.close();
+        stats = sink.get_stats();
+    } catch (const QuadGNSSException& e) {
+        if (backend == FileSinkBackend::IO_URING) {
+            std::cout << "  io_uring unavailable here, skipped (" << e.what() << ")" << std::endl;
+            return true;
+        }
+        std::cout << "  " << e.what() << std::endl;
+        std::remove(path.c_str());
+        return false;
+    }
+
+    uint64_t total = static_cast<uint64_t>(write_bytes) * write_count;
+    bool ok = file_matches(path, total);
+    std::remove(path.c_str());
+
+    std::cout << "  " << AsyncFileSink::backend_name(stats.backend)
+              << (stats.direct_io ? " O_DIRECT" : " buffered")
+              << (stats.registered_buffers ? " fixed-buffers" : "")
+              << ": " << stats.writes_completed << " writes, max depth " << stats.max_in_flight
+              << ", mean depth " << stats.mean_in_flight
+              << ", stalls " << stats.producer_stalls
+              << ", " << stats.bandwidth_mb_s << " MB/s" << std::endl;
+
+    uint64_t expected_writes = (total + options.buffer_bytes - 1) / options.buffer_bytes;
+    ok = ok && stats.bytes_accepted == total && stats.bytes_written >= total &&
+         stats.writes_submitted == expected_writes && stats.writes_completed == expected_writes &&
+         stats.in_flight == 0 && stats.max_in_flight >= 1 && stats.max_in_flight <= options.queue_depth;
+    if (backend != FileSinkBackend::AUTO) {
+        ok = ok && stats.backend == backend;
+    }
+    return ok;
+}
+
+bool test_invalid_configuration() {
+    FileSinkOptions unaligned;
+    unaligned.buffer_bytes = 5000;
+    try {
+        AsyncFileSink sink("async_sink_unused.bin", unaligned);
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+
+    try {
+        AsyncFileSink sink("/nonexistent-directory/out.bin");
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+
+    const std::string path = "async_sink_closed_" + std::to_string(getpid()) + ".bin";
+    AsyncFileSink sink(path);
+    sink.close();
+    std::remove(path.c_str());
+    try {
+        char byte = 0;
+        sink.write(&byte, 1);
+        return false;
+    } catch (const QuadGNSSException&) {
+        return true;
+    }
+}
+
+int main() {
+    std::cout << "=== Async File Sink Round-Trip Test ===" << std::endl;
+    bool ok = test_round_trip(FileSinkBackend::THREAD_POOL, true);
+    ok = test_round_trip(FileSinkBackend::THREAD_POOL, false) && ok;
+    ok = test_round_trip(FileSinkBackend::IO_URING, true) && ok;
+    ok = test_round_trip(FileSinkBackend::IO_URING, false) && ok;
+    ok = test_round_trip(FileSinkBackend::AUTO, true) && ok;
+
+    std::cout << "=== Async File Sink Configuration Test ===" << std::endl;
+    ok = test_invalid_configuration() && ok;
+
+    if (ok) {
+        std::cout << "✅ Async file sink tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Async file sink tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,167 @@
+#include "../include/autotune.h"
+#include "../include/batch_runner.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static TuningWorkload small_workload() {
+    TuningWorkload workload;
+    workload.sampling_rate_hz = 4.092e6;
+    workload.bands.push_back({SignalBand::GPS_L1CA, 1575.42e6});
+    for (int prn : {2, 7, 13, 24}) {
+        workload.satellites.push_back(StreamSatellite{ConstellationType::GPS, prn, 0});
+    }
+    return workload;
+}
+
+static std::string scenario(const std::string& output) {
+    return R"({"name": "tuned", "sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "start_time_gps": 2000, "duration_s": 0.02, "chunk_duration_s": 0.005, "threads": 2,
+        "receiver": {"x_m": 4027894.0, "y_m": 307046.0, "z_m": 4919474.0},
+        "constellations": [{"type": "GPS", "satellites": [3, 12, 17], "power_dbm": -125}],
+        "sinks": [{"type": "file", "path": ")" + output + R"("}]})";
+}
+
+bool test_tune() {
+    std::cout << "=== Autotuner Search Test ===" << std::endl;
+    AutotuneSettings settings;
+    settings.chunk_durations_s = {1e-7, 0.001, 0.0025, 0.01};     // 1e-7 s is under one sample: skipped
+    settings.render_tiles = {0, 512};
+    settings.threads = {1, 2};
+    settings.span_s = 0.004;
+    settings.repeats = 1;
+    Autotuner tuner(settings);
+
+    TuningConfig best = tuner.tune(small_workload());
+    const auto& measured = tuner.get_measurements();
+    for (const auto& m : measured) {
+        std::cout << "  " << m.chunk_duration_s * 1000 << " ms, tile " << m.render_tile << ", " << m.threads
+                  << " lane(s): " << m.msps << " MSps" << std::endl;
+    }
+
+    // Defaults first, then one axis at a time: 1 + 1 tile + 2 chunk durations + 1 lane count
+    bool ok = measured.size() == 5 && measured[0].chunk_duration_s == 0.01 && measured[0].render_tile == 0 &&
+              measured[0].threads == 1;
+    ok = ok && std::all_of(measured.begin(), measured.end(), [](const TuningConfig& m) { return m.msps > 0.0; });
+    ok = ok && std::any_of(measured.begin(), measured.end(), [&](const TuningConfig& m) {
+        return m.chunk_duration_s == best.chunk_duration_s && m.render_tile == best.render_tile &&
+               m.threads == best.threads && m.msps == best.msps;
+    });
+    std::cout << "  Best: " << best.chunk_duration_s * 1000 << " ms, tile " << best.render_tile << ", "
+              << best.threads << " lane(s)" << std::endl;
+
+    // Workloads that cannot be tuned are errors
+    int errors = 0;
+    try {
+        TuningWorkload empty = small_workload();
+        empty.bands.clear();
+        tuner.tune(empty);
+    } catch (const QuadGNSSException&) {
+        errors++;
+    }
+    try {
+        AutotuneSettings odd = settings;
+        odd.chunk_durations_s = {1e-7, 1.3e-7};
+        Autotuner(odd).tune(small_workload());
+    } catch (const QuadGNSSException&) {
+        errors++;
+    }
+    return ok && errors == 2;
+}
+
+bool test_cache() {
+    std::cout << "=== Tuning Cache Test ===" << std::endl;
+    const std::string path = "tuning_" + std::to_string(getpid()) + ".txt";
+    std::remove(path.c_str());
+
+    std::string host = host_cpu_model();
+    std::cout << "  Host: " << host << std::endl;
+    bool ok = !host.empty() && host.find('\t') == std::string::npos && host.find(" threads)") != std::string::npos;
+
+    TuningConfig config;
+    ok = ok && TuningCache(path).size() == 0 && !TuningCache(path).lookup(host, "any", config);
+
+    TuningCache cache(path);
+    TuningConfig fast{0.002, 4096, 3, 187.5};
+    TuningConfig other{0.02, 0, 1, 12.0};
+    cache.store(host, small_workload().key(), fast);
+    cache.store("Some Other CPU (64 threads)", small_workload().key(), other);
+    cache.save();
+
+    TuningCache reloaded(path);
+    ok = ok && reloaded.size() == 2 && reloaded.lookup(host, small_workload().key(), config);
+    ok = ok && config.chunk_duration_s == 0.002 && config.render_tile == 4096 && config.threads == 3 &&
+         config.msps == 187.5;
+    ok = ok && !reloaded.lookup(host, "8000000 Hz | GPS L1 C/A | 4 satellites", config);
+    std::cout << "  Key: " << small_workload().key() << std::endl;
+    ok = ok && small_workload().key() == "4092000 Hz | GPS L1 C/A | 4 satellites";
+
+    // Malformed files are rejected, not half-read
+    const char* broken[] = {"not a tuning cache\n",
+                            "# QuadGNSS tuning v1\ncpu\tkey\t0.01\t0\n",
+                            "# QuadGNSS tuning v1\ncpu\tkey\t0.01\tbig\t1\t5\n",
+                            "# QuadGNSS tuning v1\ncpu\tkey\t0.01\t0\t0\t5\n"};
+    int rejected = 0;
+    for (const char* text : broken) {
+        std::ofstream(path) << text;
+        try {
+            TuningCache bad(path);
+        } catch (const QuadGNSSException&) {
+            rejected++;
+        }
+    }
+    std::cout << "  " << rejected << "/4 malformed caches rejected" << std::endl;
+    std::remove(path.c_str());
+    return ok && rejected == 4;
+}
+
+bool test_batch_tuning() {
+    std::cout << "=== Batch Runner Tuning Test ===" << std::endl;
+    const std::string pid = std::to_string(getpid());
+    const std::string untuned_path = "tuned_" + pid + "_a.iq";
+    const std::string tuned_path = "tuned_" + pid + "_b.iq";
+    const std::string cache_path = "tuning_" + pid + "_batch.txt";
+
+    BatchRunner probe(2);
+    probe.add_scenario(scenario(untuned_path));
+    auto untuned = probe.run();
+
+    auto plan = ScenarioCompiler::compile(scenario(untuned_path));
+    TuningWorkload workload = workload_for_plan(*plan);
+    bool ok = workload.satellites.size() == 3 && workload.bands.size() == 1 &&
+              workload.bands[0].band == SignalBand::GPS_L1CA;
+
+    auto cache = std::make_shared<TuningCache>(cache_path);
+    cache->store(host_cpu_model(), workload.key(), TuningConfig{0.001, 700, 1, 50.0});
+    BatchRunner runner(2);
+    runner.set_tuning_cache(cache);
+    runner.add_scenario(scenario(tuned_path));
+    auto tuned = runner.run();
+
+    ok = ok && untuned.size() == 1 && tuned.size() == 1 && untuned[0].ok && tuned[0].ok;
+    ok = ok && !untuned[0].tuned && untuned[0].cores == 2 && tuned[0].tuned && tuned[0].cores == 1;
+    ok = ok && tuned[0].checksum == untuned[0].checksum && tuned[0].chunks == untuned[0].chunks;
+    std::cout << "  Untuned " << untuned[0].cores << " core(s), tuned " << (ok ? tuned[0].cores : 0)
+              << " core(s) with tile 700: " << (ok ? "same stream" : "MISMATCH") << std::endl;
+
+    std::remove(untuned_path.c_str());
+    std::remove(tuned_path.c_str());
+    return ok;
+}
+
+int main() {
+    bool ok = test_tune();
+    ok = test_cache() && ok;
+    ok = test_batch_tuning() && ok;
+
+    if (ok) {
+        std::cout << "✅ Autotune tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Autotune tests failed" << std::endl;
+    return 1;
+}
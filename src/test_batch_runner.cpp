@@ -0,0 +1,251 @@
+#include "../include/batch_runner.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static std::string field(double value) {
+    std::ostringstream out;
+    out << std::setw(19) << std::scientific << std::setprecision(12) << value;
+    return out.str();
+}
+
+// Two GPS satellites in the column layout RINEXParser::parse_gps_rinex2() reads
+static void write_gps_nav(const std::string& path) {
+    std::ofstream out(path);
+    out << "     2.11           N: GPS NAV DATA                         RINEX VERSION / TYPE\n";
+    out << "                                                            END OF HEADER\n";
+    const int prns[2] = {3, 7};
+    for (int k = 0; k < 2; ++k) {
+        std::string record = " " + std::to_string(prns[k]) + "  " + std::to_string(prns[k]);
+        record.resize(22, ' ');
+        out << record << field(40) << field(345600) << field(0.0) << "\n";
+        out << field(1e-12) << field(2e-5 * (k + 1)) << field(40) << field(-30.0) << "\n";
+        out << field(4.5e-9) << field(0.4 + 2.1 * k) << field(1e-6) << field(8e-3) << "\n";
+        out << field(5e-6) << field(5153.6) << field(345600) << field(1e-8) << "\n";
+        out << field(1.1 + 1.3 * k) << field(2e-8) << field(0.96) << field(200.0) << "\n";
+        out << field(-0.5) << field(-8e-9) << field(1e-10) << field(0.0) << "\n";
+    }
+}
+
+static std::string nav_scenario(const std::string& nav, const std::string& name, double lat, double power,
+                                int threads, const std::string& output) {
+    std::ostringstream json;
+    json << R"({"name": ")" << name << R"(", "sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "start_time_gps": 345600, "duration_s": 0.03, "chunk_duration_s": 0.005, "threads": )" << threads << R"(,
+        "receiver": {"lat_deg": )" << lat << R"(, "lon_deg": 11.6, "height_m": 500},
+        "constellations": [{"type": "GPS", "ephemeris": ")" << nav << R"(", "ephemeris_format": "rinex2",
+                            "satellites": "all", "power_dbm": )" << power << R"(}])";
+    if (!output.empty()) {
+        json << R"(, "sinks": [{"type": "file", "path": ")" << output << R"("}])";
+    }
+    json << "}";
+    return json.str();
+}
+
+// Moving receiver without ephemeris: the backbone flies synthetic passes
+static std::string trajectory_scenario() {
+    return R"({"name": "drive", "sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "start_time_gps": 1000, "duration_s": 0.02, "chunk_duration_s": 0.005, "threads": 1,
+        "trajectory": [{"t": 0, "x_m": 4e6, "y_m": 8e5, "z_m": 4.9e6},
+                       {"t": 0.02, "x_m": 4.0002e6, "y_m": 8e5, "z_m": 4.9e6}],
+        "constellations": [{"type": "GPS", "satellites": [3, 12], "power_dbm": -125}]})";
+}
+
+static uint64_t file_checksum(const std::string& path, size_t chunk_bytes) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    uint64_t combined = 1469598103934665603ULL;
+    for (size_t offset = 0; offset + chunk_bytes <= data.size(); offset += chunk_bytes) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (size_t i = 0; i < chunk_bytes; ++i) {
+            hash = (hash ^ static_cast<uint8_t>(data[offset + i])) * 1099511628211ULL;
+        }
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&hash);
+        for (size_t i = 0; i < sizeof(hash); ++i) {
+            combined = (combined ^ bytes[i]) * 1099511628211ULL;
+        }
+    }
+    return data.empty() ? 0 : combined;
+}
+
+static void print_results(const std::vector<BatchJobResult>& results, const BatchStats& stats) {
+    for (const auto& r : results) {
+        std::cout << "  " << std::left << std::setw(10) << r.name << std::right;
+        if (!r.ok) {
+            std::cout << " FAILED: " << r.error.substr(0, 90) << std::endl;
+            continue;
+        }
+        std::cout << " cores " << r.cores << ", " << r.chunks << " chunks, " << std::fixed << std::setprecision(1)
+                  << r.msps << " MSps, " << std::setprecision(2) << r.realtime_factor << "x real time, checksum "
+                  << std::hex << r.checksum << std::dec << std::endl;
+    }
+    std::cout << "  Batch: " << stats.jobs << " jobs (" << stats.failed << " failed), " << stats.worker_threads
+              << " workers, " << stats.ephemeris_parses << " ephemeris parse(s), " << stats.code_tables
+              << " code tables, " << std::setprecision(1) << stats.aggregate_msps << " MSps aggregate" << std::endl;
+}
+
+bool test_shared_state_batch() {
+    std::cout << "=== Batch Runner Test ===" << std::endl;
+    const std::string pid = std::to_string(getpid());
+    const std::string nav = "batch_test_" + pid + ".rnx";
+    const std::string output = "batch_test_" + pid + ".iq";
+    write_gps_nav(nav);
+
+    BatchRunner runner(2);
+    runner.add_scenario(nav_scenario(nav, "munich", 48.1, -130.0, 1, ""));
+    runner.add_scenario(nav_scenario(nav, "madrid", 40.4, -127.0, 1, ""));
+    runner.add_scenario(nav_scenario(nav, "sydney", -33.9, -133.0, 2, output));
+    runner.add_scenario(trajectory_scenario());
+    runner.add_scenario(R"({"receiver": {"x_m": 1, "y_m": 2, "z_m": 3},
+                            "constellations": [{"type": "GPS", "satellites": [99]}]})", "broken");
+    auto results = runner.run();
+    BatchStats first = runner.get_stats();
+    print_results(results, first);
+
+    bool ok = results.size() == 5 && !results[4].ok && results[4].name == "broken" && first.failed == 1;
+    for (size_t i = 0; i < 4 && ok; ++i) {
+        ok = results[i].ok && results[i].samples > 0;
+    }
+    ok = ok && results[0].bands.size() == 1 && results[0].bands[0] == get_band_info(SignalBand::GPS_L1CA).name &&
+         results[2].cores == 2 && results[0].cores == 1 && results[2].chunks == 6;
+
+    // Different positions and power give different streams
+    ok = ok && results[0].checksum != results[1].checksum && results[1].checksum != results[2].checksum;
+
+    // The file holds the chunks in order even though two lanes wrote them
+    uint64_t on_disk = file_checksum(output, 20460 * sizeof(std::complex<int16_t>));
+    ok = ok && on_disk == results[2].checksum;
+
+    // Navigation file parsed once for three jobs; L1 C/A codes for PRN 3, 7 and 12
+    ok = ok && first.ephemeris_parses == 1 && first.code_tables == 3 && first.worker_threads == 2;
+
+    // A second batch on the same runner reuses everything; one core gives identical output
+    runner.add_scenario(nav_scenario(nav, "sydney-1", -33.9, -133.0, 1, ""));
+    runner.add_scenario(trajectory_scenario());
+    auto again = runner.run();
+    const BatchStats& second = runner.get_stats();
+    print_results(again, second);
+    ok = ok && again.size() == 2 && again[0].ok && again[1].ok && again[0].cores == 1 &&
+         again[0].checksum == results[2].checksum && again[1].checksum == results[3].checksum &&
+         second.ephemeris_parses == 1 && second.code_tables == 3 && second.worker_threads == 2;
+
+    std::remove(nav.c_str());
+    std::remove(output.c_str());
+    return ok;
+}
+
+// Constellations without a band at the stream centre, and pipelines, fail the job instead of vanishing from it
+bool test_l1_constellations() {
+    std::cout << "=== L1 Constellation Test ===" << std::endl;
+    BatchRunner runner(1);
+    runner.add_scenario(R"({"name": "l1-mix", "sampling_rate_hz": 20e6, "center_frequency_hz": 1568e6,
+        "duration_s": 0.01, "receiver": {"x_m": 4e6, "y_m": 8e5, "z_m": 4.9e6},
+        "constellations": [{"type": "GPS", "satellites": [3]}, {"type": "GALILEO", "satellites": [1, 4]},
+                           {"type": "BEIDOU", "satellites": [19]}]})");
+    runner.add_scenario(trajectory_scenario());
+    // Pipelines run on the live stream only; a batch job would silently skip them
+    std::string piped = trajectory_scenario();
+    piped.insert(piped.size() - 1, R"(, "pipeline": [{"name": "generate", "type": "external"},
+        {"name": "output", "type": "external", "inputs": ["generate"]}])");
+    runner.add_scenario(piped);
+    auto results = runner.run();
+    print_results(results, runner.get_stats());
+
+    bool ok = results.size() == 3 && results[0].ok &&
+              results[0].bands == std::vector<std::string>{"GPS L1 C/A", "Galileo E1 OS", "BeiDou B1I"} &&
+              results[1].ok && !results[2].ok && results[2].error.find("pipeline") != std::string::npos;
+
+    // GLONASS renders on its FDMA channel (slot 1 is k=+1)
+    PlanRenderer renderer(ScenarioCompiler::compile(R"({"sampling_rate_hz": 4.092e6, "center_frequency_hz": 1602e6,
+        "duration_s": 0.01, "receiver": {"x_m": 4e6, "y_m": 8e5, "z_m": 4.9e6},
+        "constellations": [{"type": "GLONASS", "satellites": [1]}]})"));
+    std::vector<std::complex<int16_t>> chunk(renderer.plan().get_chunk_samples());
+    renderer.render(0, chunk.data());
+    ok = ok && renderer.get_bands().size() == 1 && renderer.get_bands()[0].band == SignalBand::GLONASS_L1OF &&
+         std::any_of(chunk.begin(), chunk.end(), [](const std::complex<int16_t>& v) { return v.real() != 0; });
+    return ok;
+}
+
+// The shipped four-constellation scenario runs as a batch job, cut to two chunks and redirected to a temporary file
+bool test_quad_fixture(const std::string& fixture) {
+    std::cout << "=== Quad Constellation Fixture Test ===" << std::endl;
+    std::ifstream in(fixture);
+    if (!in) {
+        std::cout << "  Cannot open " << (fixture.empty() ? "<no fixture given>" : fixture) << std::endl;
+        return false;
+    }
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const std::string output = "batch_quad_" + std::to_string(getpid()) + ".iq";
+    auto replace = [&json](const std::string& from, const std::string& to) {
+        size_t at = json.find(from);
+        if (at == std::string::npos) return false;
+        json.replace(at, from.size(), to);
+        return true;
+    };
+    bool ok = replace("\"duration_s\": 30", "\"duration_s\": 0.02") && replace("static_quad.iq", output);
+
+    BatchRunner runner(1);
+    runner.add_scenario(json);
+    auto results = runner.run();
+    print_results(results, runner.get_stats());
+    ok = ok && results.size() == 1 && results[0].ok && results[0].chunks == 2 &&
+         results[0].bands == std::vector<std::string>{"GPS L1 C/A", "Galileo E1 OS", "BeiDou B1I", "GLONASS L1OF"};
+    if (!results.empty()) {
+        std::cout << "  Bands:";
+        for (const auto& band : results[0].bands) std::cout << " [" << band << "]";
+        std::cout << std::endl;
+    }
+
+    // 600000 samples per chunk; the file holds the stream the checksum describes
+    ok = ok && file_checksum(output, 600000 * sizeof(std::complex<int16_t>)) == results[0].checksum;
+    std::remove(output.c_str());
+    return ok;
+}
+
+// Control commands change the rendered stream from the next chunk on
+bool test_renderer_commands() {
+    std::cout << "=== Renderer Command Test ===" << std::endl;
+    auto plan = ScenarioCompiler::compile(trajectory_scenario());
+    PlanRenderer renderer(plan);
+    std::vector<std::complex<int16_t>> before(plan->get_chunk_samples()), after(before.size());
+    renderer.render(1, before.data());
+
+    ControlCommand command{ControlCommandType::DISABLE_SATELLITE, ConstellationType::GPS, 3, {0.0, 0.0, 0.0}, 0};
+    bool ok = renderer.apply_command(command);
+    command.prn = 12;
+    ok = ok && renderer.apply_command(command);
+    command.prn = 7;
+    ok = ok && !renderer.apply_command(command);   // Not in the plan
+    renderer.render(1, after.data());
+    bool silent = std::all_of(after.begin(), after.end(), [](const std::complex<int16_t>& v) { return v == std::complex<int16_t>(0, 0); });
+
+    command = ControlCommand{ControlCommandType::ENABLE_SATELLITE, ConstellationType::GPS, 3, {0.0, 0.0, 0.0}, 0};
+    ok = ok && renderer.apply_command(command);
+    command.prn = 12;
+    ok = ok && renderer.apply_command(command);
+    renderer.render(1, after.data());
+    std::cout << "  Disabled stream " << (silent ? "silent" : "not silent") << ", re-enabled stream "
+              << (after == before ? "matches" : "differs") << std::endl;
+    return ok && silent && after == before;
+}
+
+int main(int argc, char** argv) {
+    bool ok = test_shared_state_batch();
+    ok = test_renderer_commands() && ok;
+    ok = test_l1_constellations() && ok;
+    ok = test_quad_fixture(argc > 1 ? argv[1] : "") && ok;
+
+    if (ok) {
+        std::cout << "✅ Batch runner tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Batch runner tests failed" << std::endl;
+    return 1;
+}
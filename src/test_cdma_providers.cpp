@@ -1,10 +1,18 @@
+#include "../include/multi_band.h"
 #include "../include/quad_gnss_interface.h"
 #include "../src/cdma_providers.cpp"
 #include <iostream>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <set>
+#include <unistd.h>
 
 using namespace QuadGNSS;
 
+// Header-only navigation file: providers load it and fall back to zero Doppler
+static const std::string mock_ephemeris_path = "mock_ephemeris_" + std::to_string(getpid()) + ".rnx";
+
 void test_cdma_providers() {
     std::cout << "=== CDMA Providers Test ===" << std::endl << std::endl;
     
@@ -43,7 +51,7 @@ void test_cdma_providers() {
             std::cout << "  Frequency Offset: " << freq_offset / 1e6 << " MHz" << std::endl;
             
             // Load mock ephemeris
-            provider->load_ephemeris("mock_ephemeris.dat");
+            provider->load_ephemeris(mock_ephemeris_path);
             
             // Check readiness
             std::cout << "  Ready for signal generation: " << (provider->is_ready() ? "YES" : "NO") << std::endl;
@@ -111,7 +119,7 @@ void test_digital_mixing() {
     // Create GPS provider
     auto gps_provider = ConstellationFactory::create_constellation(ConstellationType::GPS);
     gps_provider->configure(config);
-    gps_provider->load_ephemeris("mock_ephemeris.dat");
+    gps_provider->load_ephemeris(mock_ephemeris_path);
     
     std::cout << "GPS L1 Provider Details:" << std::endl;
     std::cout << "  Carrier: " << gps_provider->get_carrier_frequency() / 1e6 << " MHz" << std::endl;
@@ -145,16 +153,319 @@ void test_digital_mixing() {
     std::cout << std::endl << "=== Digital Mixing Test Complete ===" << std::endl;
 }
 
+// Reference B1I code, written out as the ICD shift registers: stages 1..11, output from stage 11
+// (tap3 = 0 for the two-stage phase assignments of PRN 1-37)
+static std::vector<int> reference_b1i_code(int tap1, int tap2, int tap3) {
+    int g1[12], g2[12];
+    for (int s = 1; s <= 11; ++s) {
+        g1[s] = g2[s] = (s % 2 == 0) ? 1 : 0;  // 01010101010
+    }
+    std::vector<int> code;
+    for (int c = 0; c < 2046; ++c) {
+        code.push_back(g1[11] ^ g2[tap1] ^ g2[tap2] ^ (tap3 ? g2[tap3] : 0));
+        int f1 = g1[1] ^ g1[7] ^ g1[8] ^ g1[9] ^ g1[10] ^ g1[11];
+        int f2 = g2[1] ^ g2[2] ^ g2[3] ^ g2[4] ^ g2[5] ^ g2[8] ^ g2[9] ^ g2[11];
+        for (int s = 11; s > 1; --s) {
+            g1[s] = g1[s - 1];
+            g2[s] = g2[s - 1];
+        }
+        g1[1] = f1;
+        g2[1] = f2;
+    }
+    return code;
+}
+
+static int max_cross_correlation(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    int worst = 0;
+    const int n = static_cast<int>(a.size());
+    for (int lag = 0; lag < n; ++lag) {
+        int sum = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += (a[i] ^ b[(i + lag) % n]) ? -1 : 1;
+        }
+        worst = std::max(worst, std::abs(sum));
+    }
+    return worst;
+}
+
+bool test_beidou_b1i_codes() {
+    std::cout << std::endl << "=== BeiDou B1I Code Table Test ===" << std::endl;
+    const int taps[63][3] = {
+        {1, 3}, {1, 4}, {1, 5}, {1, 6}, {1, 8}, {1, 9}, {1, 10}, {1, 11}, {2, 7},
+        {3, 4}, {3, 5}, {3, 6}, {3, 8}, {3, 9}, {3, 10}, {3, 11}, {4, 5}, {4, 6}, {4, 8}, {4, 9}, {4, 10}, {4, 11},
+        {5, 6}, {5, 8}, {5, 9}, {5, 10}, {5, 11}, {6, 8}, {6, 9}, {6, 10}, {6, 11}, {8, 9}, {8, 10}, {8, 11},
+        {9, 10}, {9, 11}, {10, 11},
+        {1, 2, 7}, {1, 3, 4}, {1, 3, 6}, {1, 3, 8}, {1, 3, 10}, {1, 3, 11}, {1, 4, 5}, {1, 4, 9}, {1, 5, 6},
+        {1, 5, 8}, {1, 5, 10}, {1, 5, 11}, {1, 6, 9}, {1, 7, 8}, {1, 7, 9}, {1, 7, 11}, {1, 8, 10}, {1, 9, 11},
+        {1, 10, 11}, {2, 3, 7}, {2, 3, 9}, {2, 3, 11}, {2, 4, 5}, {2, 4, 7}, {2, 4, 9}, {2, 5, 6}};
+    const BeidouB1ICodeTable& table = BeidouB1ICodeTable::instance();
+
+    int matching = 0;
+    std::set<std::vector<uint8_t>> distinct;
+    for (int prn = 1; prn <= 63; ++prn) {
+        std::vector<int> reference = reference_b1i_code(taps[prn - 1][0], taps[prn - 1][1], taps[prn - 1][2]);
+        std::vector<uint8_t> code = table.code(prn);
+        if (std::equal(code.begin(), code.end(), reference.begin())) {
+            matching++;
+        }
+        distinct.insert(code);
+    }
+    std::cout << "  Primary codes matching the ICD registers: " << matching << "/63, distinct: "
+              << distinct.size() << std::endl;
+
+    // The multi-band renderer's B1I codes are the provider's, chip for chip
+    int renderer_matching = 0;
+    for (int prn = 1; prn <= 63; ++prn) {
+        std::vector<int8_t> rendered = generate_band_code(SignalBand::BEIDOU_B1I, prn);
+        std::vector<uint8_t> code = table.code(prn);
+        bool same = rendered.size() == code.size();
+        for (size_t c = 0; same && c < code.size(); ++c) {
+            same = rendered[c] == (code[c] ? -1 : 1);
+        }
+        renderer_matching += same ? 1 : 0;
+    }
+    std::cout << "  Multi-band B1I codes matching the provider: " << renderer_matching << "/63" << std::endl;
+
+    // Truncating the 2047-chip Gold codes lifts their bound of 65, but it stays under 10% of the peak
+    int worst = std::max({max_cross_correlation(table.code(1), table.code(2)),
+                          max_cross_correlation(table.code(6), table.code(7)),
+                          max_cross_correlation(table.code(9), table.code(37)),
+                          max_cross_correlation(table.code(37), table.code(38)),
+                          max_cross_correlation(table.code(45), table.code(63))});
+    std::cout << "  Worst cross-correlation (5 pairs, all lags): " << worst << "/2046" << std::endl;
+
+    int rejected = 0;
+    for (int prn : {0, 64}) {
+        try {
+            table.code(prn);
+        } catch (const QuadGNSSException&) {
+            rejected++;
+        }
+    }
+
+    // The provider's output must follow code XOR NH chip for chip: at 5.20366 MSps the
+    // 1561.098 MHz carrier is exactly 300 cycles per sample, so each sample is about +/-900
+    GlobalConfig config;
+    config.sampling_rate_hz = 5.20366e6;
+    config.center_frequency_hz = 1561.098e6;
+    const char* nh = "00000100110101001110";
+    const std::string nav_path = "b1i_nav_" + std::to_string(getpid()) + ".rnx";
+    std::ofstream(nav_path) << "     3.04           N: GNSS NAV DATA    C: BDS              RINEX VERSION / TYPE\n"
+                            << "                                                            END OF HEADER\n";
+    bool follows = true;
+    for (int prn : {3, 6, 45, 60}) {  // GEO without NH, MEO with NH, both with three-stage codes
+        auto provider = ConstellationFactory::create_constellation(ConstellationType::BEIDOU);
+        provider->configure(config);
+        provider->load_ephemeris(nav_path);
+        for (int other = 1; other <= 5; ++other) {
+            provider->apply_command(ControlCommand{ControlCommandType::DISABLE_SATELLITE, ConstellationType::BEIDOU,
+                                                   other, {0.0, 0.0, 0.0}, 0});
+        }
+        provider->apply_command(ControlCommand{ControlCommandType::ENABLE_SATELLITE, ConstellationType::BEIDOU,
+                                               prn, {0.0, 0.0, 0.0}, 0});
+
+        const int64_t start = 5203660 / 100;  // 10 ms in, past several NH chips
+        const int count = 5203660 / 200;      // 5 ms
+        std::vector<std::complex<int16_t>> samples(count);
+        provider->generate_chunk(samples.data(), count, start / config.sampling_rate_hz);
+        std::vector<int> code = reference_b1i_code(taps[prn - 1][0], taps[prn - 1][1], taps[prn - 1][2]);
+        for (int i = 0; i < count; i += 7) {
+            double chips = static_cast<double>(start + i) / config.sampling_rate_hz * 2.046e6;
+            double fraction = chips - std::floor(chips);
+            if (fraction < 0.01 || fraction > 0.99) continue;  // Sample on a chip edge
+            int64_t chip = static_cast<int64_t>(std::floor(chips));
+            int bit = code[chip % 2046] ^ (BeidouB1ICodeTable::is_geo(prn) ? 0 : nh[(chip / 2046) % 20] - '0');
+            int expected = bit ? 900 : -900;
+            follows = follows && std::abs(samples[i].real() - expected) <= 1;
+        }
+    }
+    std::remove(nav_path.c_str());
+    std::cout << "  Provider chips follow code XOR NH (GEO PRN 3/60, MEO PRN 6/45): " << (follows ? "✅" : "❌") << std::endl;
+
+    return matching == 63 && renderer_matching == 63 && distinct.size() == 63 && worst < 205 && rejected == 2 &&
+           follows;
+}
+
+// GPS provider on a synthetic low, eccentric orbit whose Doppler moves fast enough for an
+// epoch-boundary phase error to show; exposes the carrier NCO of its single satellite
+class CarrierProbeProvider : public GpsL1Provider {
+public:
+    explicit CarrierProbeProvider(const GlobalConfig& config) {
+        configure(config);
+        EphemerisData eph;
+        eph.prn = 1;
+        eph.constellation = ConstellationType::GPS;
+        eph.sqrt_a = 2645.0;
+        eph.e = 0.5;
+        eph.m0 = 1.0;
+        eph.is_valid = true;
+        for (auto& sat : active_satellites_) {
+            sat.is_active = (sat.prn == 1);
+            if (sat.prn == 1) sat.ephemeris = eph;
+        }
+        ephemeris_loaded_ = true;
+    }
+
+    // Carrier phase (rad) and Doppler at an absolute sample; samples must be visited in order
+    double phase_at(int64_t sample_index, double& doppler_hz) {
+        SatelliteConfig& sat = active_satellites_.front();
+        update_doppler(sat, sample_index);
+        doppler_hz = sat.doppler_hz;
+        return carrier_phase(sat, sample_index);
+    }
+};
+
+bool test_carrier_phase_continuity() {
+    std::cout << std::endl << "=== Carrier Phase Continuity Test ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 4.092e6;
+    config.center_frequency_hz = 1575.42e6;
+    const int64_t epoch = 4092;                                          // 1 ms Doppler epochs
+    const int64_t start = static_cast<int64_t>(1e5) * epoch * 1000;      // t = 100000 s
+
+    // Across each Doppler update the phase must advance by exactly one sample of the outgoing frequency
+    CarrierProbeProvider probe(config);
+    int continuous = 0;
+    double absolute_time_jump = 0.0;
+    for (int k = 1; k <= 5; ++k) {
+        const int64_t boundary = (start / epoch + k) * epoch;
+        double doppler_before, doppler_after;
+        double before = probe.phase_at(boundary - 1, doppler_before);
+        double after = probe.phase_at(boundary, doppler_after);
+        double expected = 2.0 * M_PI * (1575.42e6 + doppler_before) / config.sampling_rate_hz;
+        if (std::abs(std::remainder(after - before - expected, 2.0 * M_PI)) < 1e-6) {
+            continuous++;
+        }
+        // What phase = 2 pi (f + doppler) t would have jumped by here
+        absolute_time_jump = std::max(absolute_time_jump,
+            std::abs(std::remainder(2.0 * M_PI * (doppler_after - doppler_before) * boundary / config.sampling_rate_hz,
+                                    2.0 * M_PI)));
+    }
+    std::cout << "  Continuous epoch boundaries: " << continuous << "/5 (absolute-time phase would jump "
+              << absolute_time_jump << " rad)" << std::endl;
+
+    // The same stretch cut into different chunk sizes must be bit-exact
+    const int total = static_cast<int>(3 * epoch + 517);
+    std::vector<std::vector<std::complex<int16_t>>> outputs;
+    for (int chunk : {total, static_cast<int>(epoch), 1000, 333}) {
+        CarrierProbeProvider provider(config);
+        std::vector<std::complex<int16_t>> out(total);
+        for (int done = 0; done < total; done += chunk) {
+            int count = std::min(chunk, total - done);
+            provider.generate_chunk(out.data() + done, count,
+                                    static_cast<double>(start + done) / config.sampling_rate_hz);
+        }
+        outputs.push_back(std::move(out));
+    }
+    bool invariant = true;
+    for (const auto& out : outputs) {
+        invariant = invariant && out == outputs.front();
+    }
+    std::cout << "  Chunk sizes " << total << "/" << epoch << "/1000/333 bit-exact: " << (invariant ? "✅" : "❌")
+              << std::endl;
+
+    return continuous == 5 && absolute_time_jump > 0.1 && invariant;
+}
+
+bool test_gps_ca_codes() {
+    std::cout << std::endl << "=== GPS C/A Code Table Test ===" << std::endl;
+    const GpsCaCodeTable& table = GpsCaCodeTable::instance();
+
+    // The multi-band renderer's L1 C/A codes are the provider's, chip for chip
+    int renderer_matching = 0;
+    for (int prn = 1; prn <= GpsCaCodeTable::NUM_PRNS; ++prn) {
+        std::vector<int8_t> rendered = generate_band_code(SignalBand::GPS_L1CA, prn);
+        std::vector<uint8_t> code = table.code(prn);
+        bool same = rendered.size() == code.size();
+        for (size_t c = 0; same && c < code.size(); ++c) {
+            same = rendered[c] == (code[c] ? -1 : 1);
+        }
+        renderer_matching += same ? 1 : 0;
+    }
+    std::cout << "  Multi-band L1 C/A codes matching the provider: " << renderer_matching << "/37" << std::endl;
+
+    // First 10 chips in octal, IS-GPS-200 Table 3-Ia
+    const int first_chips[4] = {01440, 01620, 01710, 01744};
+    int first_matching = 0;
+    for (int prn = 1; prn <= 4; ++prn) {
+        std::vector<uint8_t> code = table.code(prn);
+        int value = 0;
+        for (int c = 0; c < 10; ++c) {
+            value = (value << 1) | code[c];
+        }
+        first_matching += value == first_chips[prn - 1] ? 1 : 0;
+    }
+    std::cout << "  First 10 chips matching the ICD (PRN 1-4): " << first_matching << "/4" << std::endl;
+
+    return renderer_matching == 37 && first_matching == 4;
+}
+
+// Render [start, start + count) of a fresh provider in chunks of the given size
+static std::vector<std::complex<int16_t>> render_span(ConstellationType type, const GlobalConfig& config,
+                                                      int64_t start, int count, int chunk) {
+    auto provider = ConstellationFactory::create_constellation(type);
+    provider->configure(config);
+    provider->set_frequency_offset(provider->get_carrier_frequency() - config.center_frequency_hz);
+    provider->load_ephemeris(mock_ephemeris_path);
+    std::vector<std::complex<int16_t>> out(count);
+    for (int done = 0; done < count; done += chunk) {
+        provider->generate_chunk(out.data() + done, std::min(chunk, count - done),
+                                 static_cast<double>(start + done) / config.sampling_rate_hz);
+    }
+    return out;
+}
+
+bool test_start_offset_invariance() {
+    std::cout << std::endl << "=== Start Offset Invariance Test ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 8.184e6;
+    config.center_frequency_hz = 1568e6;                   // Every provider is mixed by its NCO
+    const int64_t start = static_cast<int64_t>(8184) * 100000;  // t = 100 s
+    const int total = 3 * 8184 + 517;
+    const int offset = 4097;                               // Mid-chip, mid-period
+
+    bool all = true;
+    for (auto type : {ConstellationType::GPS, ConstellationType::GALILEO, ConstellationType::BEIDOU}) {
+        std::vector<std::complex<int16_t>> reference = render_span(type, config, start, total, total);
+        bool chunked = render_span(type, config, start, total, 1000) == reference &&
+                       render_span(type, config, start, total, 333) == reference;
+        std::vector<std::complex<int16_t>> late = render_span(type, config, start + offset, total - offset, 777);
+        bool offset_start = std::equal(late.begin(), late.end(), reference.begin() + offset);
+        std::cout << "  " << ConstellationFactory::get_constellation_name(type)
+                  << ": chunks " << total << "/1000/333 bit-exact " << (chunked ? "✅" : "❌")
+                  << ", start +" << offset << " samples matches the tail " << (offset_start ? "✅" : "❌")
+                  << std::endl;
+        all = all && chunked && offset_start;
+    }
+    return all;
+}
+
 int main() {
+    std::ofstream(mock_ephemeris_path) << "     3.04           N: GNSS NAV DATA    M: MIXED            RINEX VERSION / TYPE\n"
+                                       << "                                                            END OF HEADER\n";
+    int status = 0;
     try {
-        test_cdma_providers();
-        test_digital_mixing();
-        
-        std::cout << std::endl << "✅ All CDMA Provider Tests Completed Successfully!" << std::endl;
-        return 0;
-        
+        if (!test_carrier_phase_continuity()) {
+            std::cerr << "❌ Carrier phase checks failed" << std::endl;
+            status = 1;
+        } else if (!test_beidou_b1i_codes()) {
+            std::cerr << "❌ BeiDou B1I code checks failed" << std::endl;
+            status = 1;
+        } else if (!test_gps_ca_codes()) {
+            std::cerr << "❌ GPS C/A code checks failed" << std::endl;
+            status = 1;
+        } else if (!test_start_offset_invariance()) {
+            std::cerr << "❌ Start offset invariance checks failed" << std::endl;
+            status = 1;
+        } else {
+            test_cdma_providers();
+            test_digital_mixing();
+            std::cout << std::endl << "✅ All CDMA Provider Tests Completed Successfully!" << std::endl;
+        }
     } catch (const std::exception& e) {
         std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
-        return 1;
+        status = 1;
     }
-}
\ No newline at end of file
+    std::remove(mock_ephemeris_path.c_str());
+    return status;
+}
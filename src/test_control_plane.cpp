@@ -0,0 +1,306 @@
+#include "../include/quad_gnss_interface.h"
+#include "../include/control_plane.h"
+#include "../include/telemetry_snapshot.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+// Constant-amplitude constellation whose level follows SET_POWER commands
+class LevelConstellation : public ISatelliteConstellation {
+private:
+    int16_t level_ = 100;
+    bool enabled_ = true;
+
+public:
+    void generate_chunk(std::complex<int16_t>* buffer, int sample_count, double) override {
+        std::fill(buffer, buffer + sample_count,
+                  std::complex<int16_t>(enabled_ ? level_ : 0, 0));
+    }
+    void load_ephemeris(const std::string&) override {}
+    void set_frequency_offset(double) override {}
+    ConstellationType get_constellation_type() const override { return ConstellationType::GPS; }
+    double get_carrier_frequency() const override { return 1575.42e6; }
+    std::vector<SatelliteInfo> get_active_satellites() const override { return {}; }
+    void configure(const GlobalConfig&) override {}
+    bool is_ready() const override { return true; }
+
+    bool apply_command(const ControlCommand& command) override {
+        if (command.prn != 1) return false;
+        if (command.type == ControlCommandType::SET_POWER) {
+            level_ = static_cast<int16_t>(command.value[0] + 300.0);
+            return true;
+        }
+        if (command.type == ControlCommandType::DISABLE_SATELLITE) {
+            enabled_ = false;
+            return true;
+        }
+        return false;
+    }
+};
+
+bool test_queue_multi_producer() {
+    std::cout << "=== MPSC Queue Test ===" << std::endl;
+
+    ControlCommandQueue queue(64);
+    const int producers = 4;
+    const int per_producer = 20000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for (int n = 0; n < per_producer; ++n) {
+                ControlCommand command{};
+                command.prn = p;
+                command.apply_at_sample = static_cast<uint64_t>(n);
+                while (!queue.try_push(command)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int64_t> last_seen(producers, -1);
+    int received = 0;
+    bool ordered = true;
+    while (received < producers * per_producer) {
+        ControlCommand command;
+        if (!queue.try_pop(command)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int64_t n = static_cast<int64_t>(command.apply_at_sample);
+        if (n != last_seen[command.prn] + 1) ordered = false;
+        last_seen[command.prn] = n;
+        received++;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ControlCommand extra;
+    bool empty = !queue.try_pop(extra);
+    std::cout << "  Received " << received << " commands, per-producer order "
+              << (ordered ? "kept" : "BROKEN") << std::endl;
+    return ordered && empty;
+}
+
+bool test_parser_validation() {
+    std::cout << "=== Command Parser Test ===" << std::endl;
+
+    ControlCommand power = ControlCommandParser::parse("power gps 5 -125.5 @1000", 0, 60e6);
+    ControlCommand relative = ControlCommandParser::parse("disable BeiDou 40 @+0.5", 200, 1000.0);
+    ControlCommand position = ControlCommandParser::parse("position 4510000 -120000 4480000", 0, 60e6);
+
+    bool ok = power.type == ControlCommandType::SET_POWER &&
+              power.constellation == ConstellationType::GPS &&
+              power.prn == 5 && power.value[0] == -125.5 &&
+              power.apply_at_sample == 1000 &&
+              relative.type == ControlCommandType::DISABLE_SATELLITE &&
+              relative.apply_at_sample == 700 &&
+              position.type == ControlCommandType::SET_RECEIVER_POSITION &&
+              position.apply_at_sample == 0 && position.value[1] == -120000.0;
+
+    const char* invalid[] = {
+        "power gps 33 -130",        // PRN out of range
+        "power gps 5 -10",          // Power out of range
+        "power gps 5 loud",         // Not a number
+        "enable mars 3",            // Unknown constellation
+        "disable gps",              // Missing PRN
+        "jump gps 3",               // Unknown verb
+        "enable gps 3 @soon",       // Bad timestamp
+        "position 1 2",             // Missing coordinate
+        "@5",                       // Timestamp only
+        "enable gps 3 @99999999999999999999999",   // Sample index past 64 bits
+        "enable gps 3 @+1e300",     // Delay past 64 bits of samples
+    };
+    for (const char* line : invalid) {
+        try {
+            ControlCommandParser::parse(line, 0, 60e6);
+            std::cout << "  Accepted invalid command: " << line << std::endl;
+            ok = false;
+        } catch (const QuadGNSSException&) {
+        }
+    }
+    std::cout << "  Parser " << (ok ? "OK" : "FAILED") << std::endl;
+    return ok;
+}
+
+bool test_sample_accurate_application() {
+    std::cout << "=== Sample-Accurate Application Test ===" << std::endl;
+
+    GlobalConfig config;
+    config.sampling_rate_hz = 1000.0;
+    SignalOrchestrator orchestrator(config);
+    orchestrator.add_constellation(std::make_unique<LevelConstellation>());
+    orchestrator.initialize({});
+
+    ControlCommandQueue queue;
+    orchestrator.attach_control_queue(&queue);
+    ControlServer server(queue, config.sampling_rate_hz);
+
+    // Chunk 0 covers samples [0, 500), chunk 1 covers [500, 1000)
+    bool ok = server.handle_line("power gps 1 -100 @1234") == "OK" &&
+              server.handle_line("power gps 1 -150 @730") == "OK" &&
+              server.handle_line("disable gps 2") == "OK" &&
+              server.handle_line("# comment only").empty() &&
+              server.handle_line("power gps 1").rfind("ERR", 0) == 0;
+
+    std::vector<std::complex<int16_t>> output(1500);
+    for (int chunk = 0; chunk < 3; ++chunk) {
+        orchestrator.mix_all_signals(output.data() + chunk * 500, 500, chunk * 0.5);
+    }
+
+    for (int i = 0; i < 1500; ++i) {
+        int16_t expected = (i < 730) ? 100 : (i < 1234) ? 150 : 200;
+        if (output[i].real() != expected) {
+            std::cout << "  Sample " << i << " = " << output[i].real()
+                      << ", expected " << expected << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    TelemetrySnapshot snapshot;
+    orchestrator.telemetry().read(snapshot);
+    std::cout << "  Applied: " << snapshot.commands_applied
+              << ", rejected: " << snapshot.commands_rejected << std::endl;
+    return ok && snapshot.commands_applied == 2 && snapshot.commands_rejected == 1 && snapshot.commands_dropped == 0 &&
+           server.get_accepted_count() == 3 && server.get_rejected_count() == 1;
+}
+
+bool test_schedule_capacity() {
+    std::cout << "=== Command Schedule Capacity Test ===" << std::endl;
+
+    ControlCommandQueue queue(8);
+    ControlCommandSchedule schedule(4);
+    const uint64_t stamps[] = {900, 300, 600, 300, 100, 50};
+    for (size_t i = 0; i < 6; ++i) {
+        ControlCommand command{ControlCommandType::SET_POWER, ConstellationType::GPS, static_cast<int32_t>(i + 1),
+                               {-130.0, 0.0, 0.0}, stamps[i]};
+        queue.try_push(command);
+    }
+
+    // The fifth and sixth commands find every slot taken and are dropped, not stored
+    bool ok = schedule.drain(queue) == 2 && schedule.size() == 4 && schedule.get_dropped_count() == 2 &&
+              schedule.next_sample() == 300;
+
+    // Due commands come out in stamp order, equal stamps in arrival order
+    std::vector<int32_t> order;
+    size_t applied = schedule.apply_due(600, [&order](const ControlCommand& command) {
+        order.push_back(command.prn);
+        return command.prn != 4;
+    });
+    ok = ok && applied == 3 && order == std::vector<int32_t>{2, 4, 3} && schedule.size() == 1 &&
+         schedule.next_sample() == 900 && schedule.get_applied_count() == 2 && schedule.get_rejected_count() == 1;
+
+    // Freed slots take new commands again
+    ControlCommand late{ControlCommandType::DISABLE_SATELLITE, ConstellationType::GPS, 9, {0.0, 0.0, 0.0}, 700};
+    ok = ok && schedule.add(late) && schedule.next_sample() == 700 &&
+         schedule.apply_due(1000, [](const ControlCommand&) { return true; }) == 2 &&
+         schedule.size() == 0 && schedule.next_sample() == UINT64_MAX && schedule.capacity() == 4;
+    std::cout << "  " << schedule.get_applied_count() << " applied, " << schedule.get_rejected_count()
+              << " rejected, " << schedule.get_dropped_count() << " dropped by a full schedule" << std::endl;
+    return ok;
+}
+
+bool test_unix_socket() {
+    std::cout << "=== UNIX Socket Control Test ===" << std::endl;
+
+    ControlCommandQueue queue;
+    ControlServer server(queue, 60e6, []() { return uint64_t(6000000); });
+    std::string path = "/tmp/quadgnss_control_test_" + std::to_string(getpid()) + ".sock";
+    server.start_unix_socket(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cout << "  connect() failed" << std::endl;
+        return false;
+    }
+
+    std::string request = "enable galileo 12 @+1\nenable galileo 99\n";
+    if (write(fd, request.data(), request.size()) != static_cast<ssize_t>(request.size())) {
+        close(fd);
+        return false;
+    }
+
+    std::string replies;
+    char buffer[256];
+    while (std::count(replies.begin(), replies.end(), '\n') < 2) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        replies.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    server.stop();
+
+    ControlCommand command;
+    bool popped = queue.try_pop(command);
+    std::cout << "  Replies: " << replies.substr(0, replies.find('\n')) << " / "
+              << replies.substr(replies.find('\n') + 1, 3) << std::endl;
+    return replies.rfind("OK\nERR", 0) == 0 && popped &&
+           command.constellation == ConstellationType::GALILEO &&
+           command.prn == 12 && command.apply_at_sample == 66000000 &&
+           access(path.c_str(), F_OK) != 0;
+}
+
+bool test_line_limit() {
+    std::cout << "=== Control Line Limit Test ===" << std::endl;
+
+    ControlCommandQueue queue;
+    ControlServer server(queue, 60e6);
+    std::string path = "/tmp/quadgnss_control_limit_" + std::to_string(getpid()) + ".sock";
+    server.start_unix_socket(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        std::cout << "  connect() failed" << std::endl;
+        return false;
+    }
+
+    // No newline ever arrives: the server must reject and hang up instead of buffering
+    std::string flood(ControlServer::MAX_LINE_BYTES + 512, 'x');
+    ssize_t written = write(fd, flood.data(), flood.size());
+    std::string replies;
+    char buffer[256];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        replies.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    server.stop();
+
+    // An unexpected std exception from parsing is a rejected line, not a crash
+    std::string reply = server.handle_line("enable gps 3 @184467440737095516160");
+
+    std::cout << "  Overlong line: " << replies.substr(0, replies.find('\n')) << std::endl;
+    return written == static_cast<ssize_t>(flood.size()) && replies.rfind("ERR line longer", 0) == 0 &&
+           reply.rfind("ERR", 0) == 0 && server.get_rejected_count() == 2;
+}
+
+int main() {
+    bool ok = test_queue_multi_producer();
+    ok = test_parser_validation() && ok;
+    ok = test_sample_accurate_application() && ok;
+    ok = test_schedule_capacity() && ok;
+    ok = test_unix_socket() && ok;
+    ok = test_line_limit() && ok;
+
+    if (ok) {
+        std::cout << "✅ Control plane tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Control plane tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,234 @@
+#include "../include/batch_runner.h"
+#include "../include/fingerprint.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static const double SAMPLE_RATE_HZ = 25e6;
+static const double START_TIME = 345600.0004;  // Deliberately off the geometry epoch grid
+static const int TOTAL_SAMPLES = 500000;       // 20 ms
+static const uint64_t BLOCK_SAMPLES = 16384;
+
+// Render TOTAL_SAMPLES of L1 C/A and E5a, cutting the stream with next_chunk(), and fingerprint both bands
+template <typename NextChunk>
+static std::vector<StreamFingerprint> render(NextChunk next_chunk) {
+    GlobalConfig config;
+    config.sampling_rate_hz = SAMPLE_RATE_HZ;
+    config.receiver.x_m = 4027894.0;
+    config.receiver.y_m = 307046.0;
+    config.receiver.z_m = 4919474.0;
+
+    MultiBandGenerator generator(config);
+    const int gps[] = {1, 5, 9, 14, 22};
+    for (int prn : gps) {
+        generator.backbone().add_satellite(ConstellationType::GPS, prn, -128.0 - prn % 3);
+    }
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 11, -127.0);
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 19, -131.0);
+    generator.add_band({SignalBand::GPS_L1CA, 1575.42e6 - 3.1e6, 10.0});
+    generator.add_band({SignalBand::GALILEO_E5A, 0.0, 10.0});
+
+    std::vector<StreamFingerprint> prints(2, StreamFingerprint(BLOCK_SAMPLES));
+    std::vector<std::complex<int16_t>> l1(TOTAL_SAMPLES), e5a(TOTAL_SAMPLES);
+    int done = 0;
+    while (done < TOTAL_SAMPLES) {
+        int count = std::min(next_chunk(), TOTAL_SAMPLES - done);
+        std::complex<int16_t>* buffers[2] = {l1.data(), e5a.data()};
+        generator.generate_chunk(buffers, count, START_TIME + done / SAMPLE_RATE_HZ);
+        prints[0].append(l1.data(), count);
+        prints[1].append(e5a.data(), count);
+        done += count;
+    }
+    for (auto& print : prints) print.finish();
+    return prints;
+}
+
+static bool same(const std::vector<StreamFingerprint>& a, const std::vector<StreamFingerprint>& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!compare_fingerprints(a[i], b[i]).match) return false;
+    }
+    return true;
+}
+
+static std::vector<uint64_t> file_fingerprint(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    StreamFingerprint print(4096);
+    print.append(reinterpret_cast<const std::complex<int16_t>*>(data.data()), data.size() / sizeof(std::complex<int16_t>));
+    print.finish();
+    return print.get_hashes();
+}
+
+static std::string drive_scenario(double chunk_duration_s, int threads, const std::string& output) {
+    std::ostringstream json;
+    json << R"({"name": "drive", "sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "start_time_gps": 1000, "duration_s": 0.02, "chunk_duration_s": )" << chunk_duration_s
+         << R"(, "threads": )" << threads << R"(,
+        "trajectory": [{"t": 0, "x_m": 4e6, "y_m": 8e5, "z_m": 4.9e6},
+                       {"t": 0.02, "x_m": 4.0002e6, "y_m": 8e5, "z_m": 4.9e6}],
+        "constellations": [{"type": "GPS", "satellites": [3, 12, 17], "power_dbm": -125}],
+        "sinks": [{"type": "file", "path": ")" << output << R"("}]})";
+    return json.str();
+}
+
+bool test_chunk_invariance(std::vector<StreamFingerprint>& reference) {
+    std::cout << "=== Chunk Size Invariance Test ===" << std::endl;
+    reference = render([] { return TOTAL_SAMPLES; });
+
+    auto one_ms = render([] { return 25000; });
+    auto prime = render([] { return 4093; });
+    uint32_t lcg = 12345;
+    auto ragged = render([&lcg] {
+        lcg = lcg * 1664525u + 1013904223u;
+        return 1 + static_cast<int>(lcg >> 16) % 40000;
+    });
+
+    // Blocks of a live signal all differ; identical hashes would mean an empty stream
+    bool ok = reference[0].get_hashes()[0] != reference[0].get_hashes()[1] &&
+              reference[1].get_hashes()[0] != reference[1].get_hashes()[1];
+    ok = ok && same(reference, one_ms) && same(reference, prime) && same(reference, ragged);
+    std::cout << "  1 chunk / 1 ms / 4093-sample / ragged chunks: " << (ok ? "identical" : "DIFFERENT") << " ("
+              << reference[0].get_hashes().size() << " blocks per band)" << std::endl;
+    return ok;
+}
+
+bool test_thread_invariance() {
+    std::cout << "=== Thread Count Invariance Test ===" << std::endl;
+    const std::string pid = std::to_string(getpid());
+    const struct { double chunk_s; int threads; } runs[] = {{0.005, 1}, {0.002, 3}, {0.0025, 2}};
+
+    BatchRunner runner(3);
+    std::vector<std::string> outputs;
+    for (size_t i = 0; i < 3; ++i) {
+        outputs.push_back("determinism_" + pid + "_" + std::to_string(i) + ".iq");
+        runner.add_scenario(drive_scenario(runs[i].chunk_s, runs[i].threads, outputs.back()));
+    }
+    auto results = runner.run();
+
+    bool ok = results.size() == 3;
+    std::vector<uint64_t> first = ok ? file_fingerprint(outputs[0]) : std::vector<uint64_t>();
+    for (size_t i = 0; i < results.size() && ok; ++i) {
+        ok = results[i].ok && file_fingerprint(outputs[i]) == first;
+        std::cout << "  " << results[i].chunks << " chunks on " << results[i].cores << " core(s): "
+                  << (ok ? "identical" : "DIFFERENT") << std::endl;
+    }
+    ok = ok && first.size() == 20;            // 81840 samples in 4096-sample blocks
+    for (const auto& output : outputs) std::remove(output.c_str());
+    return ok;
+}
+
+// All four constellations at L1: 200000 samples (49 fingerprint blocks) in 1 ms or 2 ms chunks
+static std::string quad_scenario(double chunk_duration_s, int threads, const std::string& output) {
+    std::ostringstream json;
+    json << R"({"name": "quad", "sampling_rate_hz": 50e6, "center_frequency_hz": 1582.5e6,
+        "start_time_gps": 345600.0004, "duration_s": 0.004, "chunk_duration_s": )" << chunk_duration_s
+         << R"(, "threads": )" << threads << R"(,
+        "receiver": {"x_m": 4027894.0, "y_m": 307046.0, "z_m": 4919474.0},
+        "constellations": [{"type": "GPS", "satellites": [5, 14]}, {"type": "GLONASS", "satellites": [1, 2, 8]},
+                           {"type": "GALILEO", "satellites": [11, 19]}, {"type": "BEIDOU", "satellites": [6, 29]}],
+        "sinks": [{"type": "file", "path": ")" << output << R"("}]})";
+    return json.str();
+}
+
+bool test_quad_invariance() {
+    std::cout << "=== Quad Constellation Invariance Test ===" << std::endl;
+    const std::string pid = std::to_string(getpid());
+    const struct { double chunk_s; int threads; } runs[] = {{0.002, 1}, {0.001, 2}};
+
+    BatchRunner runner(2);
+    std::vector<std::string> outputs;
+    for (size_t i = 0; i < 2; ++i) {
+        outputs.push_back("determinism_" + pid + "_quad" + std::to_string(i) + ".iq");
+        runner.add_scenario(quad_scenario(runs[i].chunk_s, runs[i].threads, outputs.back()));
+    }
+    auto results = runner.run();
+
+    bool ok = results.size() == 2 && results[0].ok && results[1].ok && results[0].bands.size() == 4;
+    std::vector<uint64_t> first = ok ? file_fingerprint(outputs[0]) : std::vector<uint64_t>();
+    ok = ok && first.size() == 49 && first[0] != first[1] && file_fingerprint(outputs[1]) == first;
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::cout << "  " << (results[i].ok ? std::to_string(results[i].chunks) + " chunks on " +
+                                                  std::to_string(results[i].cores) + " core(s)"
+                                            : results[i].error)
+                  << std::endl;
+    }
+    std::cout << "  4 bands, " << first.size() << " blocks: " << (ok ? "identical" : "DIFFERENT") << std::endl;
+    for (const auto& output : outputs) std::remove(output.c_str());
+    return ok;
+}
+
+bool test_golden_record(const std::vector<StreamFingerprint>& reference, const std::string& golden_dir, bool update) {
+    std::cout << "=== Golden Record Test ===" << std::endl;
+    if (golden_dir.empty()) {
+        std::cout << "  No golden record directory given" << std::endl;
+        return false;
+    }
+
+    const char* names[] = {"multi_band_l1ca.fp", "multi_band_e5a.fp"};
+    bool ok = true;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        std::string path = golden_dir + "/" + names[i];
+        StreamFingerprint run = reference[i];
+        if (update) {
+            run.save(path);
+            std::cout << "  Wrote " << path << std::endl;
+            continue;
+        }
+        FingerprintComparison result{false, 0, -1, ""};
+        try {
+            result = compare_fingerprints(StreamFingerprint::load(path), run);
+        } catch (const QuadGNSSException& e) {
+            result.message = std::string(e.what()) + " (run with --update-golden to record)";
+        }
+        std::cout << "  " << names[i] << ": " << result.message << std::endl;
+        ok = ok && result.match;
+    }
+
+    // A single flipped sample is caught in its own block
+    std::vector<std::complex<int16_t>> samples(3 * BLOCK_SAMPLES, std::complex<int16_t>(1, -1));
+    StreamFingerprint clean(BLOCK_SAMPLES), flipped(BLOCK_SAMPLES);
+    clean.append(samples.data(), samples.size());
+    samples[BLOCK_SAMPLES + 77] = std::complex<int16_t>(1, 1);
+    flipped.append(samples.data(), samples.size());
+    FingerprintComparison diff = compare_fingerprints(clean, flipped);
+    ok = ok && !diff.match && diff.first_mismatch == 1;
+
+    // A missing record is an error, not an empty match
+    try {
+        StreamFingerprint::load(golden_dir + "/missing.fp");
+        ok = false;
+    } catch (const QuadGNSSException&) {
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::string golden_dir;
+    bool update = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--update-golden") == 0) {
+            update = true;
+        } else {
+            golden_dir = argv[i];
+        }
+    }
+
+    std::vector<StreamFingerprint> reference;
+    bool ok = test_chunk_invariance(reference);
+    ok = test_thread_invariance() && ok;
+    ok = test_quad_invariance() && ok;
+    ok = test_golden_record(reference, golden_dir, update) && ok;
+
+    if (ok) {
+        std::cout << "✅ Determinism tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Determinism tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,339 @@
+#include "../include/iq_stream_server.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static bool wait_until(const std::function<bool()>& condition, int timeout_ms = 3000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return condition();
+}
+
+static int connect_client(uint16_t port, const std::string& subscribe_line, int receive_buffer = 0) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (receive_buffer > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (!subscribe_line.empty()) {
+        std::string line = subscribe_line + "\n";
+        if (send(fd, line.data(), line.size(), 0) != static_cast<ssize_t>(line.size())) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+static bool read_exact(int fd, void* buffer, size_t bytes) {
+    char* out = static_cast<char*>(buffer);
+    while (bytes > 0) {
+        ssize_t n = recv(fd, out, bytes, 0);
+        if (n <= 0) return false;
+        out += n;
+        bytes -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static void fill_chunk(std::vector<std::complex<int16_t>>& samples, uint64_t sequence) {
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = std::complex<int16_t>(static_cast<int16_t>(sequence), static_cast<int16_t>(i));
+    }
+}
+
+static bool chunk_matches(const std::vector<std::complex<int16_t>>& samples, uint64_t sequence,
+                          size_t offset = 0) {
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (samples[i] != std::complex<int16_t>(static_cast<int16_t>(sequence),
+                                                static_cast<int16_t>(i + offset))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static StreamClientStats find_client(const IQStreamServer& server, int index) {
+    auto stats = server.get_client_stats();
+    return index < static_cast<int>(stats.size()) ? stats[index] : StreamClientStats{};
+}
+
+bool test_back_pressure_policies() {
+    std::cout << "=== IQ Stream Back-Pressure Test ===" << std::endl;
+
+    IQStreamServer server;
+    server.start(0);
+
+    const uint32_t chunk = 65536;
+    const uint64_t chunk_count = 48;
+
+    // Clients are accepted in order, so stats index == connection order
+    int reader = connect_client(server.get_port(), "SUBSCRIBE policy=block framed=1 depth=4");
+    int dropper = connect_client(server.get_port(), "SUBSCRIBE policy=drop depth=2", 4096);
+    int decimator = connect_client(server.get_port(), "SUBSCRIBE policy=decimate depth=8 decimation=4", 4096);
+    bool subscribed = wait_until([&]() {
+        auto stats = server.get_client_stats();
+        return stats.size() == 3 && stats[0].options.policy == BackPressurePolicy::BLOCK &&
+               stats[0].options.framed && stats[1].options.max_queued_chunks == 2 &&
+               stats[2].options.policy == BackPressurePolicy::DECIMATE;
+    });
+    if (reader < 0 || dropper < 0 || decimator < 0 || !subscribed) {
+        std::cout << "  Clients failed to subscribe" << std::endl;
+        return false;
+    }
+
+    // Framed BLOCK reader consumes every chunk, slowly at first
+    bool reader_ok = true;
+    uint64_t frames_read = 0;
+    std::thread consumer([&]() {
+        std::vector<std::complex<int16_t>> payload(chunk);
+        for (uint64_t seq = 0; seq < chunk_count; ++seq) {
+            StreamFrameHeader header;
+            if (!read_exact(reader, &header, sizeof(header)) ||
+                header.magic != StreamFrameHeader::MAGIC || header.header_bytes != sizeof(header) ||
+                header.sequence != seq || header.sample_index != seq * chunk ||
+                header.sample_count != chunk ||
+                !read_exact(reader, payload.data(), chunk * sizeof(payload[0])) ||
+                !chunk_matches(payload, seq)) {
+                reader_ok = false;
+                return;
+            }
+            frames_read++;
+            if (seq < 8) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    std::vector<std::complex<int16_t>> samples(chunk);
+    for (uint64_t seq = 0; seq < chunk_count; ++seq) {
+        fill_chunk(samples, seq);
+        server.publish(samples.data(), chunk, seq * chunk, seq * 1e-3);
+    }
+    consumer.join();
+
+    bool drained = wait_until([&]() { return find_client(server, 0).chunks_sent == chunk_count; });
+    StreamClientStats block_stats = find_client(server, 0);
+    StreamClientStats drop_stats = find_client(server, 1);
+    StreamClientStats decimate_stats = find_client(server, 2);
+
+    std::cout << "  BLOCK:    sent " << block_stats.chunks_sent << ", dropped " << block_stats.chunks_dropped << std::endl;
+    std::cout << "  DROP:     sent " << drop_stats.chunks_sent << ", dropped " << drop_stats.chunks_dropped
+              << ", queued " << drop_stats.queued_chunks << std::endl;
+    std::cout << "  DECIMATE: sent " << decimate_stats.chunks_sent << ", dropped " << decimate_stats.chunks_dropped
+              << ", queued " << decimate_stats.queued_chunks << std::endl;
+
+    bool ok = reader_ok && drained && frames_read == chunk_count && block_stats.chunks_dropped == 0;
+    // Non-reading clients never hold more than their depth and account for every chunk
+    ok = ok && drop_stats.chunks_dropped > 0 && drop_stats.queued_chunks <= 2 &&
+         drop_stats.chunks_dropped + drop_stats.chunks_sent + drop_stats.queued_chunks == chunk_count;
+    ok = ok && decimate_stats.chunks_dropped > 0 && decimate_stats.queued_chunks <= 8;
+    // Decimation forwards more than plain DROP would from the same stalled socket
+    ok = ok && decimate_stats.chunks_sent + decimate_stats.queued_chunks >
+               drop_stats.chunks_sent + drop_stats.queued_chunks;
+
+    close(reader);
+    close(dropper);
+    close(decimator);
+    ok = ok && wait_until([&]() { return server.get_client_count() == 0; });
+    server.stop();
+    return ok;
+}
+
+bool test_blocked_publisher_released() {
+    std::cout << "=== Blocked Publisher Release Test ===" << std::endl;
+
+    IQStreamServer server;
+    server.start(0);
+    int stalled = connect_client(server.get_port(), "SUBSCRIBE policy=block depth=1", 4096);
+    if (stalled < 0 || !wait_until([&]() {
+            auto stats = server.get_client_stats();
+            return stats.size() == 1 && stats[0].options.policy == BackPressurePolicy::BLOCK;
+        })) {
+        return false;
+    }
+
+    std::vector<std::complex<int16_t>> samples(65536);
+    std::atomic<int> published(0);
+    std::thread producer([&]() {
+        for (int i = 0; i < 64; ++i) {
+            server.publish(samples.data(), static_cast<uint32_t>(samples.size()), 0, 0.0);
+            published++;
+        }
+    });
+
+    // The producer stalls once the socket buffers and the one-deep queue fill up
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    int stalled_at = published.load();
+    close(stalled);
+    producer.join();
+
+    std::cout << "  Publisher stalled after " << stalled_at << " chunks, released on disconnect" << std::endl;
+    bool ok = stalled_at < 64 && published.load() == 64;
+    server.stop();
+    return ok;
+}
+
+bool test_udp_destination() {
+    std::cout << "=== UDP Destination Test ===" << std::endl;
+
+    int sink = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    socklen_t len = sizeof(addr);
+    timeval timeout{2, 0};
+    setsockopt(sink, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (bind(sink, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(sink, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        close(sink);
+        return false;
+    }
+
+    IQStreamServer server;
+    server.start(0);
+    server.add_udp_destination("127.0.0.1", ntohs(addr.sin_port), 300);
+
+    std::vector<std::complex<int16_t>> samples(1000);
+    fill_chunk(samples, 7);
+    server.publish(samples.data(), 1000, 5000, 1.5);
+
+    // 1000 samples split into 300 + 300 + 300 + 100, each datagram self-describing
+    bool ok = true;
+    std::vector<char> datagram(65536);
+    for (uint32_t offset = 0; offset < 1000; offset += 300) {
+        uint32_t expected = std::min<uint32_t>(300, 1000 - offset);
+        ssize_t n = recv(sink, datagram.data(), datagram.size(), 0);
+        StreamFrameHeader header;
+        if (n != static_cast<ssize_t>(sizeof(header) + expected * 4)) {
+            ok = false;
+            break;
+        }
+        std::memcpy(&header, datagram.data(), sizeof(header));
+        std::vector<std::complex<int16_t>> payload(expected);
+        std::memcpy(payload.data(), datagram.data() + sizeof(header), expected * 4);
+        ok = ok && header.magic == StreamFrameHeader::MAGIC && header.sequence == 0 &&
+             header.sample_index == 5000 + offset && header.sample_count == expected &&
+             header.time_gps == 1.5 && chunk_matches(payload, 7, offset);
+    }
+    std::cout << "  Datagrams " << (ok ? "match" : "do not match") << " the published chunk" << std::endl;
+
+    try {
+        server.add_udp_destination("not-an-address", 1);
+        ok = false;
+    } catch (const QuadGNSSException&) {
+    }
+
+    server.stop();
+    close(sink);
+    return ok;
+}
+
+bool test_udp_unreachable_destination() {
+    std::cout << "=== UDP Unreachable Destination Test ===" << std::endl;
+
+    // Bind and close a socket to find a port nobody listens on
+    int probe = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    socklen_t len = sizeof(addr);
+    if (bind(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        getsockname(probe, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        close(probe);
+        return false;
+    }
+    close(probe);
+
+    IQStreamServer server;
+    server.start(0);
+    server.add_udp_destination("127.0.0.1", ntohs(addr.sin_port));
+
+    // Each one-datagram chunk draws an ICMP port unreachable, left pending as EPOLLERR
+    const uint64_t chunk_count = 20;
+    std::vector<std::complex<int16_t>> samples(1024);
+    for (uint64_t seq = 0; seq < chunk_count; ++seq) {
+        fill_chunk(samples, seq);
+        server.publish(samples.data(), 1024, seq * 1024, 0.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    bool kept = wait_until([&]() {
+        auto stats = server.get_client_stats();
+        return stats.size() == 1 && stats[0].chunks_sent == chunk_count;
+    });
+    std::cout << "  Destination " << (kept ? "kept" : "dropped") << " after unreachable errors" << std::endl;
+    server.stop();
+    return kept;
+}
+
+bool test_decimate_single_chunk_queue() {
+    std::cout << "=== DECIMATE Depth 1 Test ===" << std::endl;
+
+    IQStreamServer server;
+    server.start(0);
+    int reader = connect_client(server.get_port(), "SUBSCRIBE policy=decimate depth=1 decimation=4");
+    timeval timeout{2, 0};   // A decimated chunk fails the read instead of hanging
+    setsockopt(reader, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    bool subscribed = reader >= 0 && wait_until([&]() {
+        auto stats = server.get_client_stats();
+        return stats.size() == 1 && stats[0].options.policy == BackPressurePolicy::DECIMATE &&
+               stats[0].options.max_queued_chunks == 1;
+    });
+    if (!subscribed) {
+        if (reader >= 0) close(reader);
+        return false;
+    }
+
+    // A client that keeps up never lags, so nothing is decimated
+    const uint64_t chunk_count = 16;
+    const uint32_t chunk = 512;
+    std::vector<std::complex<int16_t>> samples(chunk), payload(chunk);
+    bool ok = true;
+    for (uint64_t seq = 0; seq < chunk_count && ok; ++seq) {
+        fill_chunk(samples, seq);
+        server.publish(samples.data(), chunk, seq * chunk, 0.0);
+        ok = read_exact(reader, payload.data(), chunk * sizeof(payload[0])) && chunk_matches(payload, seq);
+    }
+    StreamClientStats stats = find_client(server, 0);
+    std::cout << "  Sent " << stats.chunks_sent << ", dropped " << stats.chunks_dropped << std::endl;
+    ok = ok && stats.chunks_dropped == 0;
+
+    close(reader);
+    server.stop();
+    return ok;
+}
+
+int main() {
+    bool ok = test_back_pressure_policies();
+    ok = test_blocked_publisher_released() && ok;
+    ok = test_udp_destination() && ok;
+    ok = test_udp_unreachable_destination() && ok;
+    ok = test_decimate_single_chunk_queue() && ok;
+
+    if (ok) {
+        std::cout << "✅ IQ stream server tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ IQ stream server tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,452 @@
+#include "../include/fft.h"
+#include "../include/multi_band.h"
+#include "../include/stage_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace QuadGNSS;
+
+// Reference-vs-optimized equivalence harness
+//
+// Every kernel is run through a plain scalar reference and through each
+// optimized variant on randomized parameters. Integer paths must agree bit
+// for bit; lossy paths (lookup tables, fixed point, float arithmetic) are
+// held to a correlation SNR loss or an error SNR against the reference.
+// A failure prints the seed and trial so it can be replayed:
+//   test_kernel_equivalence [seed] [trials]
+
+static const double SPEED_OF_LIGHT = 299792458.0;
+
+class EquivalenceHarness {
+public:
+    EquivalenceHarness(uint64_t seed, int trials) : seed_(seed), trials_(trials), rng_(seed), failures_(0), checks_(0) {}
+
+    std::mt19937_64& rng() { return rng_; }
+    int trials() const { return trials_; }
+
+    double uniform(double low, double high) { return std::uniform_real_distribution<double>(low, high)(rng_); }
+    int uniform_int(int low, int high) { return std::uniform_int_distribution<int>(low, high)(rng_); }
+
+    void expect_exact(const std::string& kernel, const std::string& variant, bool identical, const std::string& params) {
+        record(kernel, variant, identical, identical ? "bit-exact" : "DIFFERS", params);
+    }
+
+    // Correlation SNR loss of the variant against the reference, in dB (>= 0)
+    void expect_loss(const std::string& kernel, const std::string& variant, double loss_db, double max_loss_db,
+                     const std::string& params) {
+        std::ostringstream detail;
+        detail << std::scientific << std::setprecision(2) << loss_db << " dB loss";
+        record(kernel, variant, loss_db <= max_loss_db, detail.str(), params);
+    }
+
+    // Reference power over error power, in dB
+    void expect_snr(const std::string& kernel, const std::string& variant, double snr_db, double min_snr_db,
+                    const std::string& params) {
+        std::ostringstream detail;
+        detail << std::fixed << std::setprecision(1) << snr_db << " dB SNR";
+        record(kernel, variant, snr_db >= min_snr_db, detail.str(), params);
+    }
+
+    bool summary() const {
+        std::cout << "  " << checks_ << " checks, " << failures_ << " failed (seed " << seed_ << ")" << std::endl;
+        return failures_ == 0 && checks_ > 0;
+    }
+
+private:
+    uint64_t seed_;
+    int trials_;
+    std::mt19937_64 rng_;
+    int failures_;
+    int checks_;
+
+    void record(const std::string& kernel, const std::string& variant, bool ok, const std::string& detail,
+                const std::string& params) {
+        checks_++;
+        if (!ok) failures_++;
+        std::cout << "  " << (ok ? "✅ " : "❌ ") << std::left << std::setw(12) << kernel << std::setw(26) << variant
+                  << std::right << detail << "  [" << params << "]" << std::endl;
+    }
+};
+
+template <typename A, typename B>
+static double correlation_loss_db(const std::vector<A>& reference, const std::vector<B>& variant) {
+    std::complex<double> cross = 0.0;
+    double ref_power = 0.0, var_power = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        std::complex<double> r(reference[i].real(), reference[i].imag());
+        std::complex<double> v(variant[i].real(), variant[i].imag());
+        cross += std::conj(r) * v;
+        ref_power += std::norm(r);
+        var_power += std::norm(v);
+    }
+    if (ref_power == 0.0 || var_power == 0.0) return INFINITY;
+    return -10.0 * std::log10(std::norm(cross) / (ref_power * var_power));
+}
+
+template <typename A, typename B>
+static double error_snr_db(const std::vector<A>& reference, const std::vector<B>& variant) {
+    double signal = 0.0, error = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        std::complex<double> r(reference[i].real(), reference[i].imag());
+        std::complex<double> v(variant[i].real(), variant[i].imag());
+        signal += std::norm(r);
+        error += std::norm(v - r);
+    }
+    return error == 0.0 ? INFINITY : 10.0 * std::log10(signal / error);
+}
+
+static int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t q = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? q - 1 : q;
+}
+
+static double secondary_chip(const char* bits, int64_t period) {
+    if (!bits || !*bits) return 1.0;
+    int64_t n = static_cast<int64_t>(std::char_traits<char>::length(bits));
+    return bits[((period % n) + n) % n] == '1' ? -1.0 : 1.0;
+}
+
+// Band renderer reference: every sample evaluated from the epoch geometry in double precision
+static std::vector<std::complex<double>> reference_render(SatelliteBackbone& backbone, const BandStreamConfig& stream,
+                                                          double fs, int64_t first_sample, int count) {
+    const BandInfo& info = get_band_info(stream.band);
+    const int64_t epoch_samples = std::llround(MultiBandGenerator::GEOMETRY_EPOCH_S * fs);
+    const int64_t periods_per_bit = std::llround(info.chip_rate_hz / info.code_length / SatelliteBackbone::NAV_BIT_RATE_HZ);
+
+    std::map<int, std::pair<std::vector<int8_t>, std::vector<int8_t>>> codes;
+    for (const auto& sat : backbone.satellites()) {
+        if (sat.constellation != info.constellation) continue;
+        codes[sat.prn] = {generate_band_code(info.band, sat.prn, false),
+                          info.has_pilot ? generate_band_code(info.band, sat.prn, true) : std::vector<int8_t>()};
+    }
+
+    std::vector<std::complex<double>> out(count);
+    int64_t current_epoch = -1;
+    for (int i = 0; i < count; ++i) {
+        int64_t n = first_sample + i;
+        int64_t epoch_start = floor_div(n, epoch_samples) * epoch_samples;
+        if (epoch_start != current_epoch) {
+            backbone.update(static_cast<double>(epoch_start) / fs, static_cast<double>(epoch_samples) / fs);
+            current_epoch = epoch_start;
+        }
+        double t_epoch = static_cast<double>(epoch_start) / fs;
+        double k = static_cast<double>(n - epoch_start);
+
+        for (const auto& sat : backbone.satellites()) {
+            if (!sat.is_active || sat.constellation != info.constellation) continue;
+            const SatelliteGeometry& g = sat.geometry;
+            double delay = g.range_m / SPEED_OF_LIGHT - g.clock_bias_s;
+            double rate = g.range_rate_m_s / SPEED_OF_LIGHT;
+
+            const double carrier_hz = band_carrier_hz(info.band, sat.frequency_channel);
+            const double if_hz = carrier_hz - stream.center_frequency_hz;
+
+            double chips = (t_epoch - delay) * info.chip_rate_hz + k * info.chip_rate_hz * (1.0 - rate) / fs;
+            int64_t period = static_cast<int64_t>(std::floor(chips / info.code_length));
+            double code_phase = chips - static_cast<double>(period) * info.code_length;
+            size_t chip = std::min<size_t>(info.code_length - 1, static_cast<size_t>(code_phase));
+
+            double amplitude = band_component_amplitude(info.band, sat.power_dbm, stream.gain_db);
+            int bit = SatelliteBackbone::nav_bit(sat, static_cast<uint64_t>(floor_div(period, periods_per_bit)));
+            const auto& code = codes[sat.prn];
+            double re = amplitude * (bit ? -1.0 : 1.0) * secondary_chip(info.data_secondary, period) * code.first[chip];
+            double im = info.has_pilot ? amplitude * secondary_chip(info.pilot_secondary, period) * code.second[chip] : 0.0;
+            if (info.boc_subcarrier) {
+                // BOC(1,1): data minus pilot in phase, split by the square subcarrier
+                double subcarrier = code_phase - std::floor(code_phase) < 0.5 ? 1.0 : -1.0;
+                re = (re - im) * subcarrier;
+                im = 0.0;
+            }
+
+            double cycles = (if_hz * t_epoch - std::floor(if_hz * t_epoch)) -
+                            (carrier_hz * delay - std::floor(carrier_hz * delay)) +
+                            k * (if_hz - carrier_hz * rate) / fs;
+            out[i] += std::complex<double>(re, im) * std::polar(1.0, 2.0 * M_PI * (cycles - std::floor(cycles)));
+        }
+    }
+    return out;
+}
+
+static void check_band_renderer(EquivalenceHarness& h) {
+    std::cout << "=== Band Renderer ===" << std::endl;
+    const SignalBand bands[] = {SignalBand::GPS_L1CA, SignalBand::GPS_L2C, SignalBand::GPS_L5,
+                                SignalBand::GALILEO_E5A, SignalBand::GALILEO_E5B, SignalBand::BEIDOU_B2A,
+                                SignalBand::GALILEO_E1, SignalBand::BEIDOU_B1I, SignalBand::GLONASS_L1OF};
+
+    for (int trial = 0; trial < h.trials(); ++trial) {
+        const BandInfo& info = get_band_info(bands[h.uniform_int(0, 8)]);
+        // FDMA satellites sit on channels -2..2 around the nominal carrier
+        const double spread = 2.0 * info.channel_spacing_hz;
+        GlobalConfig config;
+        config.sampling_rate_hz = std::round((info.main_lobe_hz + spread) * h.uniform(2.05, 4.0) / 1e3) * 1e3;
+        double fs = config.sampling_rate_hz;
+        double max_offset = fs / 2.0 - info.main_lobe_hz - spread;
+        BandStreamConfig stream{info.band, info.carrier_hz + h.uniform(-0.9, 0.9) * max_offset, 10.0};
+        double time_now = h.uniform(0.0, 604800.0);
+        int count = static_cast<int>(fs * 2.5e-3);
+
+        int max_prn = info.constellation == ConstellationType::GPS ? 37
+                    : info.constellation == ConstellationType::GALILEO ? 50
+                    : info.constellation == ConstellationType::GLONASS ? 24 : 63;
+        std::vector<int> prns;
+        int satellites = h.uniform_int(1, 4);
+        while (static_cast<int>(prns.size()) < satellites) {
+            int prn = h.uniform_int(1, max_prn);
+            if (std::find(prns.begin(), prns.end(), prn) == prns.end()) prns.push_back(prn);
+        }
+
+        MultiBandGenerator single(config), chunked(config);
+        SatelliteBackbone reference_backbone;
+        for (int prn : prns) {
+            double power = h.uniform(-133.0, -125.0);
+            int channel = info.channel_spacing_hz != 0.0 ? h.uniform_int(-2, 2) : 0;
+            single.backbone().add_satellite(info.constellation, prn, power, channel);
+            chunked.backbone().add_satellite(info.constellation, prn, power, channel);
+            reference_backbone.add_satellite(info.constellation, prn, power, channel);
+        }
+        single.add_band(stream);
+        chunked.add_band(stream);
+        int tile = h.uniform_int(0, 1) ? h.uniform_int(1, 8192) : 0;
+        chunked.set_render_tile(tile);
+
+        std::vector<std::complex<int16_t>> whole(count), pieces(count);
+        std::complex<int16_t>* buffer = whole.data();
+        single.generate_chunk(&buffer, count, time_now);
+
+        // Random chunk boundaries, times derived from the sample grid the way a streaming caller would
+        int64_t first_sample = std::llround(time_now * fs);
+        int done = 0;
+        while (done < count) {
+            int length = std::min(count - done, h.uniform_int(1, count / 3));
+            buffer = pieces.data() + done;
+            chunked.generate_chunk(&buffer, length, static_cast<double>(first_sample + done) / fs);
+            done += length;
+        }
+
+        std::ostringstream params;
+        params << "trial " << trial << ", " << info.name << ", fs " << fs / 1e6 << " MHz, IF "
+               << std::setprecision(4) << (info.carrier_hz - stream.center_frequency_hz) / 1e6 << " MHz, t "
+               << std::fixed << std::setprecision(4) << time_now << ", rate "
+               << std::setprecision(0) << single.backbone().satellites()[0].geometry.range_rate_m_s
+               << " m/s, " << prns.size() << " PRN(s), tile " << tile;
+        h.expect_exact("renderer", "random chunk boundaries and tile", whole == pieces, params.str());
+
+        auto reference = reference_render(reference_backbone, stream, fs, first_sample, count);
+        h.expect_loss("renderer", "LUT carrier, fixed code", correlation_loss_db(reference, whole), 0.01, params.str());
+    }
+}
+
+// Naive DFT in double precision
+static std::vector<std::complex<double>> reference_dft(const std::vector<std::complex<double>>& x, double sign) {
+    size_t n = x.size();
+    std::vector<std::complex<double>> out(n);
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> sum = 0.0;
+        for (size_t t = 0; t < n; ++t) {
+            sum += x[t] * std::polar(1.0, -sign * 2.0 * M_PI * static_cast<double>((k * t) % n) / n);
+        }
+        out[k] = sum;
+    }
+    return out;
+}
+
+static void check_fft(EquivalenceHarness& h) {
+    std::cout << "=== FFT ===" << std::endl;
+    std::normal_distribution<double> gaussian(0.0, 1000.0);
+    for (int trial = 0; trial < h.trials(); ++trial) {
+        size_t n = size_t(1) << h.uniform_int(1, 10);
+        Fft fft(n);
+        std::vector<std::complex<double>> x(n);
+        for (auto& v : x) v = std::complex<double>(gaussian(h.rng()), gaussian(h.rng()));
+
+        std::ostringstream params;
+        params << "trial " << trial << ", N " << n;
+        const double signs[] = {1.0, -1.0};
+        for (double sign : signs) {
+            std::vector<float> re(n), im(n);
+            for (size_t i = 0; i < n; ++i) {
+                re[i] = static_cast<float>(x[i].real());
+                im[i] = static_cast<float>(x[i].imag());
+            }
+            if (sign > 0.0) fft.forward(re.data(), im.data()); else fft.inverse(re.data(), im.data());
+            std::vector<std::complex<double>> result(n);
+            for (size_t i = 0; i < n; ++i) result[i] = std::complex<double>(re[i], im[i]);
+            h.expect_snr("fft", sign > 0.0 ? "forward radix-2" : "inverse radix-2",
+                         error_snr_db(reference_dft(x, sign), result), 100.0, params.str());
+        }
+    }
+
+    // Large sizes: inverse(forward(x)) / N against x
+    for (int trial = 0; trial < h.trials(); ++trial) {
+        size_t n = size_t(1) << h.uniform_int(11, 16);
+        Fft fft(n);
+        std::vector<std::complex<double>> x(n);
+        std::vector<float> re(n), im(n);
+        for (size_t i = 0; i < n; ++i) {
+            re[i] = static_cast<float>(gaussian(h.rng()));
+            im[i] = static_cast<float>(gaussian(h.rng()));
+            x[i] = std::complex<double>(re[i], im[i]);
+        }
+        fft.forward(re.data(), im.data());
+        fft.inverse(re.data(), im.data());
+        std::vector<std::complex<double>> result(n);
+        for (size_t i = 0; i < n; ++i) result[i] = std::complex<double>(re[i], im[i]) / static_cast<double>(n);
+        std::ostringstream params;
+        params << "trial " << trial << ", N " << n;
+        h.expect_snr("fft", "round trip", error_snr_db(x, result), 100.0, params.str());
+    }
+}
+
+// Int16 source keyed to the absolute sample index
+class PatternSource : public IStage {
+public:
+    PatternSource(uint64_t seed, double fs) : seed_(seed), fs_(fs) {}
+    StageKind kind() const override { return StageKind::SOURCE; }
+    std::vector<PortType> input_types() const override { return {}; }
+    PortType output_type() const override { return PortType::COMPLEX_INT16; }
+    void process(const StageBuffer*, const StageBuffer* output, int sample_count, double time_now) override {
+        int64_t first = std::llround(time_now * fs_);
+        std::complex<int16_t>* out = output->ci16();
+        for (int i = 0; i < sample_count; ++i) {
+            uint64_t x = (static_cast<uint64_t>(first + i) + seed_) * 0x9E3779B97F4A7C15ULL;
+            x ^= x >> 29;
+            out[i] = std::complex<int16_t>(static_cast<int16_t>(x & 0x1FFF) - 4096,
+                                           static_cast<int16_t>((x >> 16) & 0x1FFF) - 4096);
+        }
+    }
+
+private:
+    uint64_t seed_;
+    double fs_;
+};
+
+static void check_stage_graph(EquivalenceHarness& h) {
+    std::cout << "=== Stage Graph Fusion ===" << std::endl;
+    const double fs = 4e6;
+    const int max_chunk = 6000;
+    for (int trial = 0; trial < h.trials(); ++trial) {
+        double gain_db = h.uniform(-12.0, 6.0);
+        double shift_hz = h.uniform(-1.5e6, 1.5e6);
+        double sigma = h.uniform(0.0, 300.0);
+        uint64_t seed = h.rng()();
+        size_t threads = static_cast<size_t>(h.uniform_int(0, 3));
+
+        // Optimized: element-wise chain fused into the combiner and run tile by tile
+        std::vector<std::complex<int16_t>> fused;
+        StageGraph graph(threads);
+        graph.add_stage("a", std::make_unique<PatternSource>(1, fs));
+        graph.add_stage("b", std::make_unique<PatternSource>(2, fs));
+        graph.add_stage("sum", std::make_unique<SumCombinerStage>(2));
+        graph.add_stage("gain", std::make_unique<GainStage>(gain_db));
+        graph.add_stage("shift", std::make_unique<FrequencyShiftStage>(shift_hz, fs));
+        graph.add_stage("noise", std::make_unique<NoiseStage>(sigma, seed));
+        graph.add_stage("quantize", std::make_unique<QuantizeStage>());
+        graph.add_stage("sink", std::make_unique<CallbackSinkStage>(
+            [&fused](const std::complex<int16_t>* samples, int count, double) {
+                fused.insert(fused.end(), samples, samples + count);
+            }));
+        graph.connect("a", "sum", 0);
+        graph.connect("b", "sum", 1);
+        graph.connect("sum", "gain");
+        graph.connect("gain", "shift");
+        graph.connect("shift", "noise");
+        graph.connect("noise", "quantize");
+        graph.connect("quantize", "sink");
+        graph.compile(max_chunk);
+
+        // Reference: the same stages called one after another on whole chunks
+        PatternSource a(1, fs), b(2, fs);
+        SumCombinerStage sum(2);
+        GainStage gain(gain_db);
+        FrequencyShiftStage shift(shift_hz, fs);
+        NoiseStage noise(sigma, seed);
+        QuantizeStage quantize;
+        std::vector<std::complex<int16_t>> reference;
+
+        double time_now = std::floor(h.uniform(0.0, 1000.0) * fs) / fs;
+        for (int chunk = 0; chunk < 6; ++chunk) {
+            int count = h.uniform_int(1, max_chunk);
+            graph.run(count, time_now);
+
+            std::vector<std::complex<float>> pa(count), pb(count), f1(count), f2(count);
+            std::vector<std::complex<float>> out(count);
+            StageBuffer sa{PortType::COMPLEX_INT16, pa.data(), count}, sb{PortType::COMPLEX_INT16, pb.data(), count};
+            StageBuffer s1{PortType::COMPLEX_FLOAT, f1.data(), count}, s2{PortType::COMPLEX_FLOAT, f2.data(), count};
+            StageBuffer so{PortType::COMPLEX_INT16, out.data(), count};
+            a.process(nullptr, &sa, count, time_now);
+            b.process(nullptr, &sb, count, time_now);
+            StageBuffer sum_in[2] = {sa, sb};
+            sum.process(sum_in, &s1, count, time_now);
+            gain.process(&s1, &s2, count, time_now);
+            shift.process(&s2, &s1, count, time_now);
+            noise.process(&s1, &s2, count, time_now);
+            quantize.process(&s2, &so, count, time_now);
+            reference.insert(reference.end(), so.ci16(), so.ci16() + count);
+            time_now += count / fs;
+        }
+
+        std::ostringstream params;
+        params << "trial " << trial << ", " << graph.get_fused_stage_count() << " fused stages, " << threads
+               << " worker(s), gain " << std::setprecision(3) << gain_db << " dB, shift " << shift_hz / 1e3
+               << " kHz, sigma " << sigma;
+        h.expect_exact("stage graph", "fused tiles", fused == reference, params.str());
+    }
+}
+
+static void check_code_tables(EquivalenceHarness& h) {
+    std::cout << "=== Spreading Codes ===" << std::endl;
+
+    // IS-GPS-200 Table 3-Ia: first ten C/A chips (octal) of PRN 1..10
+    const int first_chips_octal[] = {01440, 01620, 01710, 01744, 01133, 01455, 01131, 01454, 01626, 01504};
+    bool ok = true;
+    for (int prn = 1; prn <= 10; ++prn) {
+        auto code = generate_band_code(SignalBand::GPS_L1CA, prn);
+        int first = 0;
+        for (int i = 0; i < 10; ++i) first = (first << 1) | (code[i] < 0 ? 1 : 0);
+        ok = ok && first == first_chips_octal[prn - 1];
+    }
+    h.expect_exact("codes", "L1 C/A registers", ok, "PRN 1-10 against IS-GPS-200");
+
+    // Shared cache returns exactly the generated tables
+    const SignalBand bands[] = {SignalBand::GPS_L1CA, SignalBand::GPS_L5, SignalBand::GALILEO_E5B, SignalBand::BEIDOU_B2A};
+    BandCodeCache cache;
+    for (int trial = 0; trial < h.trials(); ++trial) {
+        SignalBand band = bands[h.uniform_int(0, 3)];
+        const BandInfo& info = get_band_info(band);
+        int prn = h.uniform_int(1, 37);
+        bool pilot = info.has_pilot && h.uniform_int(0, 1) == 1;
+        std::ostringstream params;
+        params << "trial " << trial << ", " << info.name << " PRN " << prn << (pilot ? " pilot" : " data");
+        h.expect_exact("codes", "BandCodeCache", *cache.get(band, prn, pilot) == generate_band_code(band, prn, pilot),
+                       params.str());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t seed = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 20240611;
+    int trials = argc > 2 ? std::atoi(argv[2]) : 8;
+    EquivalenceHarness harness(seed, trials);
+
+    check_band_renderer(harness);
+    check_fft(harness);
+    check_stage_graph(harness);
+    check_code_tables(harness);
+
+    std::cout << "=== Summary ===" << std::endl;
+    if (harness.summary()) {
+        std::cout << "✅ Kernel equivalence tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Kernel equivalence tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,183 @@
+#include "../include/quad_gnss_interface.h"
+#include "../include/lane_reduction.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace QuadGNSS;
+
+static uint64_t xorshift(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Full-scale pseudo-random samples that continue across chunks; sums of several saturate the output
+class NoiseConstellation : public ISatelliteConstellation {
+private:
+    uint64_t state_;
+    ConstellationType type_;
+    bool ready_;
+
+public:
+    NoiseConstellation(uint64_t seed, ConstellationType type, bool ready = true)
+        : state_(seed), type_(type), ready_(ready) {}
+
+    void generate_chunk(std::complex<int16_t>* buffer, int sample_count, double) override {
+        for (int i = 0; i < sample_count; ++i) {
+            uint64_t r = xorshift(state_);
+            buffer[i] = std::complex<int16_t>(static_cast<int16_t>(r), static_cast<int16_t>(r >> 16));
+        }
+    }
+    void load_ephemeris(const std::string&) override {}
+    void set_frequency_offset(double) override {}
+    ConstellationType get_constellation_type() const override { return type_; }
+    double get_carrier_frequency() const override { return 1575.42e6; }
+    std::vector<SatelliteInfo> get_active_satellites() const override { return {}; }
+    void configure(const GlobalConfig&) override {}
+    bool is_ready() const override { return ready_; }
+};
+
+class FailingConstellation : public NoiseConstellation {
+public:
+    FailingConstellation() : NoiseConstellation(1, ConstellationType::GLONASS) {}
+    void generate_chunk(std::complex<int16_t>*, int, double) override {
+        throw QuadGNSSException("channel failed");
+    }
+};
+
+static std::vector<std::complex<int16_t>> mix(size_t threads, size_t constellations, int chunk, int chunks) {
+    GlobalConfig config;
+    SignalOrchestrator orchestrator(config);
+    const ConstellationType types[] = {ConstellationType::GPS, ConstellationType::GLONASS,
+                                       ConstellationType::GALILEO, ConstellationType::BEIDOU};
+    for (size_t c = 0; c < constellations; ++c) {
+        // Every third constellation is idle and must add nothing
+        orchestrator.add_constellation(std::make_unique<NoiseConstellation>(0x9E3779B97F4A7C15ULL * (c + 1),
+                                                                            types[c % 4], c % 3 != 2));
+    }
+    orchestrator.initialize({});
+    orchestrator.set_mixing_threads(threads);
+
+    std::vector<std::complex<int16_t>> out(static_cast<size_t>(chunk) * chunks);
+    for (int k = 0; k < chunks; ++k) {
+        orchestrator.mix_all_signals(out.data() + static_cast<size_t>(k) * chunk, chunk, k * 1e-3);
+    }
+    return out;
+}
+
+bool test_tree_reduction() {
+    std::cout << "=== Fixed-Order Reduction Test ===" << std::endl;
+    const int n = 3 * LaneReducer::BLOCK_SAMPLES + 17;
+    bool ok = true;
+    for (size_t lane_count : {0u, 1u, 2u, 3u, 5u, 8u, 13u}) {
+        std::vector<std::vector<std::complex<int16_t>>> lanes(lane_count, std::vector<std::complex<int16_t>>(n));
+        std::vector<const std::complex<int16_t>*> pointers;
+        uint64_t state = 12345 + lane_count;
+        for (auto& lane : lanes) {
+            for (auto& s : lane) {
+                uint64_t r = xorshift(state);
+                s = std::complex<int16_t>(static_cast<int16_t>(r), static_cast<int16_t>(r >> 16));
+            }
+            pointers.push_back(lane.data());
+        }
+        std::vector<std::complex<int32_t>> expected(n, {0, 0});
+        for (int i = 0; i < n; ++i) {
+            for (const auto& lane : lanes) {
+                expected[i] += std::complex<int32_t>(lane[i].real(), lane[i].imag());
+            }
+        }
+        for (size_t threads : {1u, 2u, 3u, 7u}) {
+            LaneReducer reducer(threads);
+            std::vector<std::complex<int32_t>> sum(n, {77, 77});
+            reducer.reduce(pointers.data(), lane_count, sum.data(), n);
+            ok = ok && sum == expected;
+        }
+    }
+    std::cout << "  0-13 lanes on 1, 2, 3 and 7 threads: " << (ok ? "✅ exact" : "❌ differs") << std::endl;
+
+    // Tasks are all run once, and the first failure reaches the caller
+    LaneReducer pool(4);
+    std::vector<int> runs(1000, 0);
+    pool.parallel_for(runs.size(), [&](size_t worker, size_t i) { runs[i] += worker < 4 ? 1 : 100; });
+    ok = ok && std::all_of(runs.begin(), runs.end(), [](int r) { return r == 1; });
+    bool rethrown = false;
+    try {
+        pool.parallel_for(50, [](size_t, size_t i) {
+            if (i == 20) throw QuadGNSSException("task failed");
+        });
+    } catch (const QuadGNSSException&) {
+        rethrown = true;
+    }
+    pool.parallel_for(3, [&](size_t, size_t i) { runs[i] = 5; });
+    return ok && rethrown && runs[2] == 5;
+}
+
+bool test_thread_count_invariance() {
+    std::cout << "=== Mixing Thread Count Test ===" << std::endl;
+    const auto reference = mix(1, 7, 10007, 3);
+    bool ok = true;
+    for (size_t threads : {2u, 3u, 4u, 8u}) {
+        bool same = mix(threads, 7, 10007, 3) == reference;
+        std::cout << "  " << threads << " threads: " << (same ? "✅ identical" : "❌ differs") << std::endl;
+        ok = ok && same;
+    }
+
+    // Saturating sums clamp to the int16 range exactly as a serial sum would
+    size_t clamped = 0;
+    for (const auto& s : reference) {
+        if (s.real() == 32767 || s.real() == -32768) clamped++;
+    }
+    std::cout << "  " << clamped << " clamped samples" << std::endl;
+
+    GlobalConfig config;
+    SignalOrchestrator failing(config);
+    failing.add_constellation(std::make_unique<NoiseConstellation>(3, ConstellationType::GPS));
+    failing.add_constellation(std::make_unique<FailingConstellation>());
+    failing.initialize({});
+    failing.set_mixing_threads(2);
+    std::vector<std::complex<int16_t>> out(100);
+    bool rethrown = false;
+    try {
+        failing.mix_all_signals(out.data(), 100, 0.0);
+    } catch (const QuadGNSSException&) {
+        rethrown = true;
+    }
+    return ok && clamped > 0 && rethrown && failing.get_mixing_threads() == 2;
+}
+
+void benchmark_scaling() {
+    std::cout << "=== Reduction Scaling ===" << std::endl;
+    const int n = 1 << 20;
+    std::vector<std::vector<std::complex<int16_t>>> lanes(8, std::vector<std::complex<int16_t>>(n, {3, -4}));
+    std::vector<const std::complex<int16_t>*> pointers;
+    for (const auto& lane : lanes) pointers.push_back(lane.data());
+    std::vector<std::complex<int32_t>> sum(n);
+
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= hardware; threads *= 2) {
+        LaneReducer reducer(threads);
+        reducer.reduce(pointers.data(), pointers.size(), sum.data(), n);
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < 5; ++r) {
+            reducer.reduce(pointers.data(), pointers.size(), sum.data(), n);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << threads << " thread(s): " << 5.0 * n / seconds / 1e6 << " MSps of 8 lanes" << std::endl;
+    }
+}
+
+int main() {
+    bool ok = test_tree_reduction();
+    ok = test_thread_count_invariance() && ok;
+    benchmark_scaling();
+
+    if (ok) {
+        std::cout << "✅ Lane reduction tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Lane reduction tests failed" << std::endl;
+    return 1;
+}
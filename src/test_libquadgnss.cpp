@@ -0,0 +1,224 @@
+#include "../include/quadgnss.h"
+#include "../include/batch_runner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+// 4 chunks of 20460 samples
+static std::string scenario(const std::string& output) {
+    return R"({"name": "embedded", "sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "start_time_gps": 2000, "duration_s": 0.02, "chunk_duration_s": 0.005,
+        "receiver": {"x_m": 4027894.0, "y_m": 307046.0, "z_m": 4919474.0},
+        "constellations": [{"type": "GPS", "satellites": [3, 12, 17], "power_dbm": -125}],
+        "sinks": [{"type": "file", "path": ")" + output + R"("}]})";
+}
+
+// The scenario's file output, as written by the batch runner
+static std::vector<int16_t> reference_stream(const std::string& path) {
+    BatchRunner runner(1);
+    runner.add_scenario(scenario(path));
+    auto results = runner.run();
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+    std::vector<int16_t> iq(bytes.size() / sizeof(int16_t));
+    std::memcpy(iq.data(), bytes.data(), iq.size() * sizeof(int16_t));
+    return results.size() == 1 && results[0].ok ? iq : std::vector<int16_t>();
+}
+
+bool test_create() {
+    std::cout << "=== Library Create Test ===" << std::endl;
+    bool ok = quadgnss_abi_version() == QUADGNSS_ABI_VERSION && std::string(quadgnss_version()) == "1.0.0";
+
+    quadgnss_sim* bad = quadgnss_create("{\"name\": ", nullptr);
+    ok = ok && !bad && *quadgnss_last_error() != '\0';
+    std::cout << "  Malformed scenario: " << quadgnss_last_error() << std::endl;
+    ok = ok && !quadgnss_create(nullptr, nullptr) && !quadgnss_create_from_file("no_such_scenario.json");
+    ok = ok && quadgnss_fill(nullptr, nullptr, 0) == QUADGNSS_ERROR_INVALID;
+    quadgnss_destroy(nullptr);
+
+    quadgnss_sim* sim = quadgnss_create(scenario("unused.iq").c_str(), nullptr);
+    ok = ok && sim && quadgnss_sample_rate(sim) == 4.092e6 && quadgnss_center_frequency(sim) == 1575.42e6 &&
+         quadgnss_chunk_samples(sim) == 20460 && quadgnss_total_samples(sim) == 4 * 20460 &&
+         quadgnss_position(sim) == 0 && std::string(quadgnss_last_error()).empty();
+    quadgnss_destroy(sim);
+    return ok;
+}
+
+bool test_stream(const std::vector<int16_t>& reference) {
+    std::cout << "=== Pull Stream Test ===" << std::endl;
+    const size_t total = reference.size() / 2;
+    bool ok = total == 4 * 20460;
+
+    // One fill for everything: whole chunks render straight into the caller's buffer
+    quadgnss_sim* sim = quadgnss_create(scenario("unused.iq").c_str(), nullptr);
+    std::vector<int16_t> bulk(reference.size() + 200, 0);
+    int64_t n = quadgnss_fill(sim, bulk.data(), total + 100);
+    bulk.resize(reference.size());
+    bool bulk_ok = n == static_cast<int64_t>(total) && bulk == reference && quadgnss_fill(sim, bulk.data(), 10) == 0;
+    std::cout << "  Single fill: " << (bulk_ok ? "✅ file stream" : "❌ differs") << std::endl;
+    quadgnss_destroy(sim);
+
+    // Odd pieces, then a mix of fill and borrowed chunks
+    sim = quadgnss_create(scenario("unused.iq").c_str(), nullptr);
+    std::vector<int16_t> pieces;
+    std::vector<int16_t> buffer(2 * 7001);
+    while ((n = quadgnss_fill(sim, buffer.data(), 7001)) > 0) {
+        pieces.insert(pieces.end(), buffer.begin(), buffer.begin() + 2 * n);
+    }
+    bool pieces_ok = pieces == reference && quadgnss_position(sim) == total;
+    std::cout << "  Fill in 7001-sample pieces: " << (pieces_ok ? "✅" : "❌") << std::endl;
+    quadgnss_destroy(sim);
+
+    sim = quadgnss_create(scenario("unused.iq").c_str(), nullptr);
+    std::vector<int16_t> mixed(2 * 5000);
+    bool mixed_ok = quadgnss_fill(sim, mixed.data(), 5000) == 5000 && quadgnss_position(sim) == 5000;
+    quadgnss_chunk chunk;
+    int acquired = 0;
+    while (quadgnss_acquire_chunk(sim, &chunk) == QUADGNSS_OK) {
+        mixed_ok = mixed_ok && chunk.first_sample == mixed.size() / 2 &&
+                   std::abs(chunk.time_gps - (2000.0 + chunk.first_sample / 4.092e6)) < 1e-9;
+        mixed.insert(mixed.end(), chunk.iq, chunk.iq + 2 * chunk.samples);
+        mixed_ok = quadgnss_release_chunk(sim, &chunk) == QUADGNSS_OK && mixed_ok;
+        acquired++;
+        if (acquired == 2) {
+            // Back to fill() in the middle: it stops inside a chunk that the next acquire hands out
+            std::vector<int16_t> some(2 * 3000);
+            mixed_ok = mixed_ok && quadgnss_fill(sim, some.data(), 3000) == 3000;
+            mixed.insert(mixed.end(), some.begin(), some.end());
+        }
+    }
+    mixed_ok = mixed_ok && mixed == reference && acquired == 4 &&
+               quadgnss_acquire_chunk(sim, &chunk) == QUADGNSS_END_OF_STREAM;
+    std::cout << "  Fill + acquire/release: " << (mixed_ok ? "✅" : "❌") << std::endl;
+    quadgnss_destroy(sim);
+
+    return ok && bulk_ok && pieces_ok && mixed_ok;
+}
+
+bool test_ring(const std::vector<int16_t>& reference) {
+    std::cout << "=== Borrowed Ring Test ===" << std::endl;
+    quadgnss_sim* sim = quadgnss_create(scenario("unused.iq").c_str(), nullptr);
+    bool ok = quadgnss_set_ring_chunks(sim, 0) == QUADGNSS_ERROR_INVALID && quadgnss_set_ring_chunks(sim, 2) == QUADGNSS_OK;
+
+    quadgnss_chunk a, b, c;
+    ok = ok && quadgnss_acquire_chunk(sim, &a) == QUADGNSS_OK && quadgnss_acquire_chunk(sim, &b) == QUADGNSS_OK;
+    ok = ok && quadgnss_acquire_chunk(sim, &c) == QUADGNSS_ERROR_BUSY;
+    ok = ok && quadgnss_set_ring_chunks(sim, 3) == QUADGNSS_ERROR_BUSY;
+    int16_t probe[2];
+    ok = ok && quadgnss_fill(sim, probe, 1) == QUADGNSS_ERROR_BUSY;
+
+    // A fill ending mid-chunk is refused whole, not cut short as if the stream had ended
+    const size_t chunk = quadgnss_chunk_samples(sim);
+    std::vector<int16_t> over(2 * (chunk + 1));
+    ok = ok && quadgnss_fill(sim, over.data(), chunk + 1) == QUADGNSS_ERROR_BUSY && quadgnss_position(sim) == 2 * chunk;
+
+    // Both borrowed chunks stay intact while held, and can be released in any order
+    ok = ok && std::equal(a.iq, a.iq + 2 * chunk, reference.begin()) &&
+         std::equal(b.iq, b.iq + 2 * chunk, reference.begin() + 2 * chunk);
+    ok = ok && quadgnss_release_chunk(sim, &b) == QUADGNSS_OK && quadgnss_release_chunk(sim, &b) == QUADGNSS_ERROR_INVALID;
+    ok = ok && quadgnss_acquire_chunk(sim, &c) == QUADGNSS_OK && c.first_sample == 2 * chunk;
+    ok = ok && quadgnss_release_chunk(sim, &a) == QUADGNSS_OK && quadgnss_release_chunk(sim, &c) == QUADGNSS_OK;
+    ok = ok && quadgnss_set_ring_chunks(sim, 1) == QUADGNSS_OK;
+    ok = ok && quadgnss_acquire_chunk(sim, &a) == QUADGNSS_OK &&
+         std::equal(a.iq, a.iq + 2 * chunk, reference.begin() + 6 * chunk);
+    std::cout << "  Busy, out-of-order release and resize: " << (ok ? "✅" : "❌") << std::endl;
+    quadgnss_destroy(sim);
+    return ok;
+}
+
+bool test_truth() {
+    std::cout << "=== Truth Data Test ===" << std::endl;
+    quadgnss_sim* sim = quadgnss_create(scenario("unused.iq").c_str(), nullptr);
+    bool ok = quadgnss_get_truth(sim, 0, nullptr, 0) == 3;
+
+    quadgnss_truth start[3], later[3], again[3];
+    const uint64_t step = 40920;               // 10 ms
+    ok = ok && quadgnss_get_truth(sim, 1234, start, 3) == 3 && quadgnss_get_truth(sim, 1234 + step, later, 3) == 3;
+    ok = ok && quadgnss_get_truth(sim, 1234, again, 3) == 3;
+    for (int i = 0; i < 3; ++i) {
+        double predicted = start[i].range_m + start[i].range_rate_m_s * 0.01;
+        std::cout << "  PRN " << start[i].prn << ": " << start[i].range_m / 1000.0 << " km, "
+                  << start[i].range_rate_m_s << " m/s" << std::endl;
+        ok = ok && start[i].constellation == 0 && start[i].power_dbm == -125.0;
+        ok = ok && start[i].range_m > 1.9e7 && start[i].range_m < 2.7e7 && std::abs(later[i].range_m - predicted) < 1.0;
+        ok = ok && again[i].range_m == start[i].range_m && start[i].receiver_ecef_m[0] == 4027894.0;
+    }
+    ok = ok && start[0].prn == 3 && start[1].prn == 12 && start[2].prn == 17;
+    quadgnss_destroy(sim);
+    return ok;
+}
+
+// All four constellations at L1: 2 chunks of 50000 samples
+static std::string quad_scenario(const std::string& output) {
+    return R"({"name": "embedded-quad", "sampling_rate_hz": 50e6, "center_frequency_hz": 1582.5e6,
+        "start_time_gps": 2000, "duration_s": 0.002, "chunk_duration_s": 0.001,
+        "receiver": {"x_m": 4027894.0, "y_m": 307046.0, "z_m": 4919474.0},
+        "constellations": [{"type": "GPS", "satellites": [3, 12]}, {"type": "GLONASS", "satellites": [1, 2]},
+                           {"type": "GALILEO", "satellites": [4, 19]}, {"type": "BEIDOU", "satellites": [6, 21]}],
+        "sinks": [{"type": "file", "path": ")" + output + R"("}]})";
+}
+
+bool test_constellations() {
+    std::cout << "=== Quad Constellation Test ===" << std::endl;
+    const std::string path = "libquadgnss_" + std::to_string(getpid()) + "_quad.iq";
+    BatchRunner runner(1);
+    runner.add_scenario(quad_scenario(path));
+    auto results = runner.run();
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+    bool ok = results.size() == 1 && results[0].ok && results[0].bands.size() == 4 && bytes.size() == 100000 * 4;
+
+    // Every constellation is in the pulled stream, bit-identical to the file output
+    quadgnss_sim* sim = quadgnss_create(quad_scenario("unused.iq").c_str(), nullptr);
+    std::vector<int16_t> iq(2 * 100000);
+    ok = ok && sim && quadgnss_fill(sim, iq.data(), 100000) == 100000 &&
+         std::memcmp(iq.data(), bytes.data(), bytes.size()) == 0;
+
+    quadgnss_truth truth[8];
+    int seen[4] = {0, 0, 0, 0};
+    ok = ok && quadgnss_get_truth(sim, 0, truth, 8) == 8;
+    for (int i = 0; i < 8 && ok; ++i) {
+        ok = truth[i].constellation >= 0 && truth[i].constellation < 4;
+        if (ok) seen[truth[i].constellation]++;
+    }
+    ok = ok && seen[0] == 2 && seen[1] == 2 && seen[2] == 2 && seen[3] == 2;
+    std::cout << "  4 bands, 8 satellites: " << (ok ? "stream matches the file output" : "MISMATCH") << std::endl;
+    quadgnss_destroy(sim);
+
+    // A constellation with no band in the stream is refused, not silently dropped
+    quadgnss_sim* narrow = quadgnss_create(R"({"sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "duration_s": 0.01, "receiver": {"x_m": 4027894.0, "y_m": 307046.0, "z_m": 4919474.0},
+        "constellations": [{"type": "GPS", "satellites": [3]}, {"type": "GLONASS", "satellites": [1]}]})", nullptr);
+    bool refused = !narrow && std::string(quadgnss_last_error()).find("GLONASS") != std::string::npos;
+    std::cout << "  GLONASS outside a 4 MHz L1 stream: " << quadgnss_last_error() << std::endl;
+    quadgnss_destroy(narrow);
+    return ok && refused;
+}
+
+int main() {
+    const std::string path = "libquadgnss_" + std::to_string(getpid()) + ".iq";
+    std::vector<int16_t> reference = reference_stream(path);
+
+    bool ok = test_create();
+    ok = !reference.empty() && ok;
+    ok = test_stream(reference) && ok;
+    ok = test_ring(reference) && ok;
+    ok = test_truth() && ok;
+    ok = test_constellations() && ok;
+
+    if (ok) {
+        std::cout << "✅ libquadgnss tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ libquadgnss tests failed" << std::endl;
+    return 1;
+}
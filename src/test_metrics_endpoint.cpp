@@ -0,0 +1,225 @@
+#include "../include/metrics_endpoint.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static int connect_client(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Send one raw request and read the response until the server closes
+static std::string http_request(uint16_t port, const std::string& request) {
+    int fd = connect_client(port);
+    if (fd < 0) return "";
+    send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    return response;
+}
+
+static std::string http_get(uint16_t port, const std::string& path) {
+    return http_request(port, "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+}
+
+static std::string body_of(const std::string& response) {
+    size_t end = response.find("\r\n\r\n");
+    return end == std::string::npos ? "" : response.substr(end + 4);
+}
+
+// Sample lines keyed by "name{labels}"; false if a line is not valid exposition format
+static bool parse_page(const std::string& page, std::map<std::string, double>& samples) {
+    std::istringstream lines(page);
+    std::string line, family;
+    while (std::getline(lines, line)) {
+        if (line.rfind("# HELP ", 0) == 0) continue;
+        if (line.rfind("# TYPE ", 0) == 0) {
+            family = line.substr(7, line.find(' ', 7) - 7);
+            continue;
+        }
+        size_t space = line.rfind(' ');
+        std::string key = line.substr(0, space);
+        if (space == std::string::npos || key.compare(0, family.size(), family) != 0 || samples.count(key)) return false;
+        char* end = nullptr;
+        samples[key] = std::strtod(line.c_str() + space + 1, &end);
+        if (*end != '\0') return false;
+    }
+    return true;
+}
+
+static void fill(MetricsChannel& channel, uint64_t chunks) {
+    GenerationMetrics& m = channel.staging();
+    m.chunks = chunks;
+    m.samples = chunks * 1000;
+    m.sampling_rate_hz = 100000.0;
+    m.wall_seconds = chunks * 0.02;
+    m.clipped_samples = chunks / 10;
+    m.underruns = chunks / 100;
+    m.active_satellites[static_cast<size_t>(ConstellationType::GPS)] = 8;
+    m.active_satellites[static_cast<size_t>(ConstellationType::BEIDOU)] = 3;
+    m.queue_depth[static_cast<size_t>(MetricsOutput::FILE)] = 5;
+    m.queue_capacity[static_cast<size_t>(MetricsOutput::FILE)] = 8;
+}
+
+bool test_render() {
+    std::cout << "=== Metrics Page Test ===" << std::endl;
+    MetricsChannel channel({"generate", "say \"hi\""});
+    MetricsServer server(channel);
+
+    std::map<std::string, double> empty;
+    bool ok = parse_page(server.render(), empty) && empty["quadgnss_metrics_published_total"] == 0 &&
+              empty["quadgnss_samples_generated_total"] == 0 && empty["quadgnss_realtime_factor"] == 0 &&
+              !empty.count("quadgnss_output_queue_depth{output=\"file\"}");
+    std::cout << "  Before the first chunk: " << (ok ? "✅" : "❌") << std::endl;
+
+    fill(channel, 500);
+    channel.staging().stage_cpu_seconds[0] = 1.25;
+    channel.publish_staging();
+    std::map<std::string, double> m;
+    bool parsed = parse_page(server.render(), m);
+    bool values = parsed && m["quadgnss_metrics_published_total"] == 1 && m["quadgnss_chunks_generated_total"] == 500 &&
+                  m["quadgnss_samples_generated_total"] == 500000 && m["quadgnss_clipped_samples_total"] == 50 &&
+                  m["quadgnss_underruns_total"] == 5 && std::abs(m["quadgnss_realtime_factor"] - 0.5) < 1e-9 &&
+                  m["quadgnss_active_satellites{constellation=\"gps\"}"] == 8 &&
+                  m["quadgnss_active_satellites{constellation=\"glonass\"}"] == 0 &&
+                  m["quadgnss_active_satellites{constellation=\"beidou\"}"] == 3 &&
+                  m["quadgnss_output_queue_depth{output=\"file\"}"] == 5 &&
+                  m["quadgnss_output_queue_capacity{output=\"file\"}"] == 8 &&
+                  !m.count("quadgnss_output_queue_depth{output=\"stream\"}") && !m.count("quadgnss_ring_slots") &&
+                  m["quadgnss_stage_cpu_seconds_total{stage=\"generate\"}"] == 1.25 &&
+                  m.count("quadgnss_stage_cpu_seconds_total{stage=\"say \\\"hi\\\"\"}") &&
+                  m["quadgnss_last_publish_age_seconds"] >= 0.0 && m["quadgnss_last_publish_age_seconds"] < 5.0;
+    std::cout << "  " << m.size() << " samples, values and labels: " << (values ? "✅" : "❌") << std::endl;
+
+    bool rejected = false;
+    try {
+        MetricsChannel too_many(std::vector<std::string>(GenerationMetrics::MAX_STAGES + 1, "stage"));
+    } catch (const QuadGNSSException&) {
+        rejected = true;
+    }
+    std::cout << "  Too many stages rejected: " << (rejected ? "✅" : "❌") << std::endl;
+    return ok && values && rejected;
+}
+
+bool test_http() {
+    std::cout << "=== Loopback Scrape Test ===" << std::endl;
+    MetricsChannel channel({"generate"});
+    fill(channel, 42);
+    channel.publish_staging();
+    MetricsServer server(channel);
+    server.start(0);
+
+    std::string response = http_get(server.get_port(), "/metrics");
+    std::string body = body_of(response);
+    std::map<std::string, double> m;
+    bool ok = response.rfind("HTTP/1.1 200 OK\r\n", 0) == 0 &&
+              response.find("Content-Type: text/plain; version=0.0.4") != std::string::npos &&
+              response.find("Content-Length: " + std::to_string(body.size()) + "\r\n") != std::string::npos &&
+              parse_page(body, m) && m["quadgnss_chunks_generated_total"] == 42;
+    std::cout << "  GET /metrics on port " << server.get_port() << ": " << (ok ? "✅" : "❌") << std::endl;
+
+    // A client that never sends a request only holds the server until its timeout
+    int idle = connect_client(server.get_port());
+    bool errors = http_get(server.get_port(), "/").rfind("HTTP/1.1 200", 0) == 0 &&
+                  http_get(server.get_port(), "/other").rfind("HTTP/1.1 404", 0) == 0 &&
+                  http_request(server.get_port(), "POST /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0) == 0 &&
+                  body_of(http_request(server.get_port(), "HEAD /metrics HTTP/1.1\r\n\r\n")).empty();
+    close(idle);
+    bool counted = server.get_scrape_count() == 3;
+    std::cout << "  Other paths and methods: " << (errors ? "✅" : "❌") << ", scrapes counted: "
+              << (counted ? "✅" : "❌") << std::endl;
+
+    uint16_t port = server.get_port();
+    server.stop();
+    bool stopped = connect_client(port) < 0;
+    std::cout << "  Port closed after stop: " << (stopped ? "✅" : "❌") << std::endl;
+    return ok && errors && counted && stopped;
+}
+
+bool test_live_scrapes() {
+    std::cout << "=== Scrapes During Generation ===" << std::endl;
+    MetricsChannel channel({"generate", "output"});
+    MetricsServer server(channel);
+    server.start(0);
+
+    // Generation thread: per-chunk accounting and publish, as the live generator does it
+    const uint64_t chunks = 20000;
+    std::atomic<bool> done(false);
+    double publish_ns = 0.0;
+    std::thread generator([&] {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t c = 1; c <= chunks; ++c) {
+            channel.start_stage_clock();
+            channel.charge_stage(0);
+            channel.charge_stage(1);
+            fill(channel, c);
+            channel.publish_staging();
+        }
+        publish_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / chunks;
+        done = true;
+    });
+
+    // Every scrape sees one consistent chunk, never going backwards
+    size_t scrapes = 0;
+    bool consistent = true;
+    double last = 0.0;
+    while (!done || scrapes < 20) {
+        std::map<std::string, double> m;
+        consistent = consistent && parse_page(body_of(http_get(server.get_port(), "/metrics")), m);
+        double chunk = m["quadgnss_chunks_generated_total"];
+        consistent = consistent && m["quadgnss_samples_generated_total"] == chunk * 1000 &&
+                     m["quadgnss_clipped_samples_total"] == std::floor(chunk / 10) && chunk >= last;
+        last = chunk;
+        scrapes++;
+    }
+    generator.join();
+    std::map<std::string, double> final_page;
+    parse_page(server.render(), final_page);
+    consistent = consistent && final_page["quadgnss_chunks_generated_total"] == chunks &&
+                 final_page["quadgnss_metrics_published_total"] == chunks;
+    std::cout << "  " << scrapes << " scrapes, all consistent: " << (consistent ? "✅" : "❌") << std::endl;
+
+    // Per-chunk cost on the generation thread, against a 10 ms chunk
+    bool cheap = publish_ns < 100000.0;
+    std::cout << "  Accounting and publish: " << publish_ns / 1e3 << " us per chunk ("
+              << publish_ns / 1e7 * 100 << "% of a 10 ms chunk): " << (cheap ? "✅" : "❌") << std::endl;
+    return consistent && cheap;
+}
+
+int main() {
+    bool ok = test_render();
+    ok = test_http() && ok;
+    ok = test_live_scrapes() && ok;
+
+    if (ok) {
+        std::cout << "✅ Metrics endpoint tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Metrics endpoint tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,294 @@
+#include "../include/multi_band.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace QuadGNSS;
+
+static double correlation(const std::vector<int8_t>& a, const std::vector<int8_t>& b, size_t lag) {
+    long sum = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum += a[i] * b[(i + lag) % b.size()];
+    }
+    return static_cast<double>(sum) / a.size();
+}
+
+bool test_code_generation() {
+    std::cout << "=== Band Code Generation Test ===" << std::endl;
+    bool ok = true;
+
+    // First 10 C/A chips in octal (IS-GPS-200 Table 3-Ia)
+    const int expected_octal[4] = {01440, 01620, 01710, 01744};
+    for (int prn = 1; prn <= 4; ++prn) {
+        auto code = generate_band_code(SignalBand::GPS_L1CA, prn);
+        int head = 0;
+        for (int i = 0; i < 10; ++i) {
+            head = (head << 1) | (code[i] < 0 ? 1 : 0);
+        }
+        if (head != expected_octal[prn - 1]) {
+            std::cout << "  C/A PRN " << prn << " head " << std::oct << head << std::dec << std::endl;
+            ok = false;
+        }
+    }
+
+    // Gold code autocorrelation is three-valued: 1023, -1, -65, 63
+    auto ca = generate_band_code(SignalBand::GPS_L1CA, 1);
+    for (size_t lag = 1; lag < ca.size() && ok; ++lag) {
+        long value = std::lround(correlation(ca, ca, lag) * 1023.0);
+        ok = value == -1 || value == -65 || value == 63;
+    }
+    std::cout << "  C/A chip heads and autocorrelation " << (ok ? "match" : "do not match") << " the ICD" << std::endl;
+
+    // Long codes: length, balance and low correlation near zero lag
+    const SignalBand long_bands[] = {SignalBand::GPS_L2C, SignalBand::GPS_L5, SignalBand::GALILEO_E5A,
+                                     SignalBand::GALILEO_E5B, SignalBand::BEIDOU_B2A, SignalBand::GALILEO_E1,
+                                     SignalBand::BEIDOU_B1I};
+    for (SignalBand band : long_bands) {
+        const BandInfo& info = get_band_info(band);
+        auto a = generate_band_code(band, 1);
+        auto b = generate_band_code(band, 2);
+        auto pilot = info.has_pilot ? generate_band_code(band, 1, true) : b;
+
+        double worst = 0.0;
+        for (size_t lag = 0; lag < 200; ++lag) {
+            worst = std::max(worst, std::abs(correlation(a, b, lag)));
+            worst = std::max(worst, std::abs(correlation(a, pilot, lag)));
+            if (lag > 0) worst = std::max(worst, std::abs(correlation(a, a, lag)));
+        }
+        long balance = 0;
+        for (int8_t chip : a) balance += chip;
+
+        bool band_ok = a.size() == info.code_length && worst < 0.07 &&
+                       std::abs(static_cast<double>(balance)) < 0.03 * info.code_length;
+        std::cout << "  " << info.name << ": " << a.size() << " chips, balance " << balance
+                  << ", worst correlation " << worst << (band_ok ? "" : "  <-- FAIL") << std::endl;
+        ok = ok && band_ok;
+    }
+
+    // GLONASS ST code: one 511-chip m-sequence for every slot, periodic autocorrelation -1/511 off peak
+    auto st = generate_band_code(SignalBand::GLONASS_L1OF, 1);
+    bool st_ok = st.size() == 511 && st == generate_band_code(SignalBand::GLONASS_L1OF, 24);
+    for (size_t lag = 1; lag < st.size() && st_ok; ++lag) {
+        st_ok = std::lround(correlation(st, st, lag) * 511.0) == -1;
+    }
+    std::cout << "  GLONASS L1OF ST code " << (st_ok ? "is" : "is not") << " a shared m-sequence" << std::endl;
+    return ok && st_ok;
+}
+
+// Sum of block correlation magnitudes against a replica built from the backbone geometry
+// (carrier_hz: the satellite's carrier, if_hz: its offset from the stream centre)
+static double aligned_power(const std::vector<std::complex<int16_t>>& samples, const BandInfo& info,
+                            const std::vector<int8_t>& code, const SatelliteGeometry& g,
+                            double time_now, double fs, double code_offset_chips,
+                            double carrier_hz, double if_hz = 0.0) {
+    const double c = 299792458.0;
+    double delay = g.range_m / c - g.clock_bias_s;
+    double chips = (time_now - delay) * info.chip_rate_hz + code_offset_chips;
+    double code_phase = chips - std::floor(chips / info.code_length) * info.code_length;
+    double code_step = info.chip_rate_hz * (1.0 - g.range_rate_m_s / c) / fs;
+    double carrier = if_hz * time_now - carrier_hz * delay;
+    double carrier_step = (if_hz - carrier_hz * g.range_rate_m_s / c) / fs;
+
+    const int block = 6000;
+    double total = 0.0;
+    std::complex<double> sum(0.0, 0.0);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        int chip = static_cast<int>(code_phase);
+        double subcarrier = info.boc_subcarrier && code_phase - chip >= 0.5 ? -1.0 : 1.0;
+        double angle = -2.0 * M_PI * (carrier - std::floor(carrier));
+        std::complex<double> s(samples[i].real(), samples[i].imag());
+        sum += s * std::polar(1.0, angle) * static_cast<double>(code[chip]) * subcarrier;
+        code_phase += code_step;
+        if (code_phase >= info.code_length) code_phase -= info.code_length;
+        carrier += carrier_step;
+        if ((i + 1) % block == 0) {
+            total += std::abs(sum);
+            sum = 0.0;
+        }
+    }
+    return total / samples.size();
+}
+
+bool test_shared_backbone_rendering() {
+    std::cout << "=== Shared Backbone Rendering Test ===" << std::endl;
+
+    GlobalConfig config;
+    MultiBandGenerator generator(config);
+    generator.backbone().add_satellite(ConstellationType::GPS, 3);
+    generator.backbone().add_satellite(ConstellationType::GPS, 9);
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 11);
+    generator.backbone().add_satellite(ConstellationType::BEIDOU, 40);
+
+    size_t l1 = generator.add_band({SignalBand::GPS_L1CA, 0.0});
+    size_t l5 = generator.add_band({SignalBand::GPS_L5, 0.0});
+    generator.add_band({SignalBand::GALILEO_E5A, 0.0});
+
+    const int sample_count = 60000;
+    const int chunk_count = 3;
+    const double fs = config.sampling_rate_hz;
+    std::vector<std::vector<std::complex<int16_t>>> streams(3, std::vector<std::complex<int16_t>>(sample_count));
+    std::complex<int16_t>* buffers[3] = {streams[0].data(), streams[1].data(), streams[2].data()};
+
+    const double start = 1000.0;
+    for (int chunk = 0; chunk < chunk_count; ++chunk) {
+        generator.generate_chunk(buffers, sample_count, start + chunk * sample_count / fs);
+    }
+    double last_time = start + (chunk_count - 1) * sample_count / fs;
+
+    // One geometry evaluation per satellite per chunk, regardless of band count
+    uint64_t evaluations = generator.backbone().get_geometry_evaluations();
+    bool shared = evaluations == static_cast<uint64_t>(chunk_count) * 4;
+    std::cout << "  Geometry evaluations: " << evaluations << " for " << chunk_count << " chunks x 4 satellites x 3 bands"
+              << std::endl;
+
+    // Every band of PRN 3 must follow the same geometry: correct code phase correlates, a wrong one does not
+    const SatelliteGeometry& g = generator.backbone().satellites()[0].geometry;
+    const double amplitude = 1000.0;
+    const BandInfo& l1_info = get_band_info(SignalBand::GPS_L1CA);
+    const BandInfo& l5_info = get_band_info(SignalBand::GPS_L5);
+    auto l1_code = generate_band_code(SignalBand::GPS_L1CA, 3);
+    auto l5_pilot = generate_band_code(SignalBand::GPS_L5, 3, true);
+
+    double l1_aligned = aligned_power(streams[l1], l1_info, l1_code, g, last_time, fs, 0.0, l1_info.carrier_hz) / amplitude;
+    double l1_offset = aligned_power(streams[l1], l1_info, l1_code, g, last_time, fs, 100.0, l1_info.carrier_hz) / amplitude;
+    double l5_aligned = aligned_power(streams[l5], l5_info, l5_pilot, g, last_time, fs, 0.0, l5_info.carrier_hz) / (amplitude * M_SQRT1_2);
+    double l5_offset = aligned_power(streams[l5], l5_info, l5_pilot, g, last_time, fs, 100.0, l5_info.carrier_hz) / (amplitude * M_SQRT1_2);
+
+    std::cout << "  PRN 3 range " << g.range_m << " m, rate " << g.range_rate_m_s << " m/s" << std::endl;
+    std::cout << "  L1 C/A correlation aligned " << l1_aligned << ", offset " << l1_offset << std::endl;
+    std::cout << "  L5 pilot correlation aligned " << l5_aligned << ", offset " << l5_offset << std::endl;
+
+    return shared && l1_aligned > 0.85 && l1_offset < 0.4 && l5_aligned > 0.85 && l5_offset < 0.4;
+}
+
+// L1 signals of the other constellations share one stream: Galileo BOC(1,1), BeiDou B1I and GLONASS FDMA
+bool test_l1_rendering() {
+    std::cout << "=== L1 Rendering Test ===" << std::endl;
+
+    GlobalConfig config;
+    const double fs = config.sampling_rate_hz;
+    const double centre = config.center_frequency_hz;
+    MultiBandGenerator generator(config);
+    generator.backbone().add_satellite(ConstellationType::GALILEO, 11);
+    generator.backbone().add_satellite(ConstellationType::BEIDOU, 6);
+    generator.backbone().add_satellite(ConstellationType::GLONASS, 2, -130.0, -4);
+    const SignalBand bands[] = {SignalBand::GALILEO_E1, SignalBand::BEIDOU_B1I, SignalBand::GLONASS_L1OF};
+    for (SignalBand band : bands) {
+        generator.add_band({band, centre});
+    }
+
+    const int sample_count = 60000;
+    std::vector<std::vector<std::complex<int16_t>>> streams(3, std::vector<std::complex<int16_t>>(sample_count));
+    std::complex<int16_t>* buffers[3] = {streams[0].data(), streams[1].data(), streams[2].data()};
+    const double time_now = 2000.0;
+    generator.generate_chunk(buffers, sample_count, time_now);
+
+    bool ok = true;
+    for (size_t b = 0; b < 3; ++b) {
+        const BackboneSatellite& sat = generator.backbone().satellites()[b];
+        const BandInfo& info = get_band_info(bands[b]);
+        const double carrier = band_carrier_hz(bands[b], sat.frequency_channel);
+        const double amplitude = band_component_amplitude(bands[b], sat.power_dbm);
+        auto code = generate_band_code(bands[b], sat.prn, info.has_pilot);
+        double aligned = aligned_power(streams[b], info, code, sat.geometry, time_now, fs, 0.0, carrier,
+                                       carrier - centre) / amplitude;
+        double offset = aligned_power(streams[b], info, code, sat.geometry, time_now, fs, 100.0, carrier,
+                                      carrier - centre) / amplitude;
+        // The nominal GLONASS carrier misses the channel: a wrong channel does not correlate either
+        double nominal = aligned_power(streams[b], info, code, sat.geometry, time_now, fs, 0.0, info.carrier_hz,
+                                       info.carrier_hz - centre) / amplitude;
+        std::cout << "  " << info.name << " PRN " << sat.prn << " at " << (carrier - centre) / 1e6
+                  << " MHz: aligned " << aligned << ", offset " << offset << ", nominal carrier " << nominal << std::endl;
+        ok = ok && aligned > 0.85 && offset < 0.4;
+        if (info.channel_spacing_hz != 0.0) ok = ok && nominal < 0.4;
+    }
+
+    // A GLONASS channel outside the stream is refused when the band is added and when rendered
+    GlobalConfig narrow;
+    narrow.sampling_rate_hz = 4.092e6;
+    narrow.center_frequency_hz = 1602e6;
+    MultiBandGenerator edge(narrow);
+    edge.backbone().add_satellite(ConstellationType::GLONASS, 10, -130.0, -7);
+    try {
+        edge.add_band({SignalBand::GLONASS_L1OF, 1602e6});
+        ok = false;
+    } catch (const QuadGNSSException& e) {
+        std::cout << "  " << e.what() << std::endl;
+    }
+    MultiBandGenerator late(narrow);
+    late.add_band({SignalBand::GLONASS_L1OF, 1602e6});
+    late.backbone().add_satellite(ConstellationType::GLONASS, 10, -130.0, -7);
+    std::complex<int16_t>* late_buffer[1] = {streams[0].data()};
+    try {
+        late.generate_chunk(late_buffer, 1000, 0.0);
+        ok = false;
+    } catch (const QuadGNSSException&) {
+    }
+
+    // Band selection: one band per constellation that fits, none for a channel outside the stream
+    std::vector<ConstellationType> unrendered;
+    auto selected = bands_for_stream({{ConstellationType::GPS, 1, 0}, {ConstellationType::GLONASS, 1, 1},
+                                      {ConstellationType::GLONASS, 10, -7}}, 1602e6, 4.092e6, &unrendered);
+    ok = ok && selected.empty() && unrendered.size() == 2;
+    selected = bands_for_stream({{ConstellationType::GPS, 1, 0}, {ConstellationType::GLONASS, 1, 1},
+                                 {ConstellationType::GALILEO, 3, 0}, {ConstellationType::BEIDOU, 9, 0}},
+                                centre, fs, &unrendered);
+    ok = ok && unrendered.empty() &&
+         selected == std::vector<SignalBand>{SignalBand::GPS_L1CA, SignalBand::GALILEO_E1, SignalBand::BEIDOU_B1I,
+                                             SignalBand::GLONASS_L1OF};
+    return ok;
+}
+
+bool test_invalid_arguments() {
+    try {
+        generate_band_code(SignalBand::GPS_L5, 0);
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    try {
+        generate_band_code(SignalBand::GPS_L1CA, 1, true);
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+
+    GlobalConfig config;
+    MultiBandGenerator generator(config);
+    std::vector<std::complex<int16_t>> buffer(16);
+    std::complex<int16_t>* buffers[1] = {buffer.data()};
+    try {
+        generator.generate_chunk(buffers, 16, 0.0);
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    try {
+        // L1 cannot be rendered from a stream centred on L5
+        generator.add_band({SignalBand::GPS_L1CA, 1176.45e6});
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    generator.backbone().add_satellite(ConstellationType::GPS, 1);
+    try {
+        generator.backbone().add_satellite(ConstellationType::GPS, 1);
+        return false;
+    } catch (const QuadGNSSException&) {
+        return true;
+    }
+}
+
+int main() {
+    bool ok = test_code_generation();
+    ok = test_shared_backbone_rendering() && ok;
+    ok = test_l1_rendering() && ok;
+    ok = test_invalid_arguments() && ok;
+
+    if (ok) {
+        std::cout << "✅ Multi-band tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Multi-band tests failed" << std::endl;
+    return 1;
+}
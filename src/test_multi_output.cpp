@@ -0,0 +1,257 @@
+#include "../include/quad_gnss_interface.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace QuadGNSS;
+
+// Phase-continuous complex tone that counts how often it is generated
+class ToneConstellation : public ISatelliteConstellation {
+private:
+    uint64_t next_sample_ = 0;
+    int* generate_calls_;
+
+public:
+    explicit ToneConstellation(int* generate_calls) : generate_calls_(generate_calls) {}
+
+    void generate_chunk(std::complex<int16_t>* buffer, int sample_count, double) override {
+        (*generate_calls_)++;
+        for (int i = 0; i < sample_count; ++i) {
+            double phase = 2.0 * M_PI * 0.013 * static_cast<double>(next_sample_++);
+            buffer[i] = std::complex<int16_t>(static_cast<int16_t>(std::lround(6000.0 * std::cos(phase))),
+                                              static_cast<int16_t>(std::lround(6000.0 * std::sin(phase))));
+        }
+    }
+    void load_ephemeris(const std::string&) override {}
+    void set_frequency_offset(double) override {}
+    ConstellationType get_constellation_type() const override { return ConstellationType::GPS; }
+    double get_carrier_frequency() const override { return 1575.42e6; }
+    std::vector<SatelliteInfo> get_active_satellites() const override { return {}; }
+    void configure(const GlobalConfig&) override {}
+    bool is_ready() const override { return true; }
+};
+
+// Two tones on known lines of sight: +x (along the baseline) and +z (across it)
+class TwoSatelliteConstellation : public ISatelliteConstellation {
+private:
+    uint64_t next_sample_ = 0;
+
+public:
+    static std::complex<int16_t> tone(int source, uint64_t n) {
+        double cycles_per_sample = source == 0 ? 0.011 : -0.007;
+        double phase = 2.0 * M_PI * cycles_per_sample * static_cast<double>(n);
+        return std::complex<int16_t>(static_cast<int16_t>(std::lround(4000.0 * std::cos(phase))),
+                                     static_cast<int16_t>(std::lround(4000.0 * std::sin(phase))));
+    }
+
+    void generate_chunk(std::complex<int16_t>* buffer, int sample_count, double) override {
+        for (int i = 0; i < sample_count; ++i, ++next_sample_) {
+            buffer[i] = tone(0, next_sample_) + tone(1, next_sample_);
+        }
+    }
+    size_t source_count() const override { return 2; }
+    void generate_sources(std::complex<int16_t>* const* buffers, SourceGeometry* geometry,
+                          int sample_count, double) override {
+        for (int i = 0; i < sample_count; ++i, ++next_sample_) {
+            buffers[0][i] = tone(0, next_sample_);
+            buffers[1][i] = tone(1, next_sample_);
+        }
+        geometry[0].active = geometry[1].active = true;
+        geometry[0].line_of_sight[0] = 1.0;
+        geometry[1].line_of_sight[2] = 1.0;
+    }
+    void load_ephemeris(const std::string&) override {}
+    void set_frequency_offset(double) override {}
+    ConstellationType get_constellation_type() const override { return ConstellationType::GPS; }
+    double get_carrier_frequency() const override { return 1575.42e6; }
+    std::vector<SatelliteInfo> get_active_satellites() const override { return {}; }
+    void configure(const GlobalConfig&) override {}
+    bool is_ready() const override { return true; }
+};
+
+static std::unique_ptr<SignalOrchestrator> make_orchestrator(int* generate_calls) {
+    GlobalConfig config;
+    auto orchestrator = std::make_unique<SignalOrchestrator>(config);
+    orchestrator->add_constellation(std::make_unique<ToneConstellation>(generate_calls));
+    orchestrator->initialize({});
+    return orchestrator;
+}
+
+bool test_shared_baseband_rendering() {
+    std::cout << "=== Multi-Output Rendering Test ===" << std::endl;
+
+    const int sample_count = 1000;
+    const int chunk_count = 5;
+    const double fs = GlobalConfig::DEFAULT_SAMPLING_RATE;
+    const double delay_samples = 2.25;
+    const double phase = M_PI / 3.0;
+    const double gain_db = -6.0;
+
+    int single_calls = 0;
+    int multi_calls = 0;
+    auto single = make_orchestrator(&single_calls);
+    auto multi = make_orchestrator(&multi_calls);
+    multi->set_outputs({{"base", 0.0, 0.0, 0.0},
+                        {"element-1", delay_samples / fs, phase, gain_db},
+                        {"element-2", 0.0, M_PI, 0.0}});
+
+    std::vector<std::complex<int16_t>> reference(sample_count * chunk_count);
+    std::vector<std::vector<std::complex<int16_t>>> outputs(3, std::vector<std::complex<int16_t>>(reference.size()));
+    for (int chunk = 0; chunk < chunk_count; ++chunk) {
+        size_t offset = static_cast<size_t>(chunk) * sample_count;
+        single->mix_all_signals(reference.data() + offset, sample_count, chunk * sample_count / fs);
+        std::complex<int16_t>* buffers[3] = {outputs[0].data() + offset, outputs[1].data() + offset,
+                                             outputs[2].data() + offset};
+        multi->mix_all_outputs(buffers, sample_count, chunk * sample_count / fs);
+    }
+
+    // The reference output is bit-identical to the single-output path
+    bool base_identical = outputs[0] == reference;
+
+    // Delayed element: g * e^(j*phase) * reference(n - 2.25), across chunk boundaries
+    double amplitude = std::pow(10.0, gain_db / 20.0);
+    std::complex<double> rotation = std::polar(amplitude, phase);
+    double worst_error = 0.0;
+    for (size_t n = 3; n < reference.size(); ++n) {
+        std::complex<double> newer(reference[n - 2].real(), reference[n - 2].imag());
+        std::complex<double> older(reference[n - 3].real(), reference[n - 3].imag());
+        std::complex<double> expected = rotation * (newer + 0.25 * (older - newer));
+        std::complex<double> actual(outputs[1][n].real(), outputs[1][n].imag());
+        worst_error = std::max(worst_error, std::abs(actual - expected));
+    }
+
+    bool inverted = true;
+    for (size_t n = 0; n < reference.size(); ++n) {
+        if (outputs[2][n] != std::complex<int16_t>(-reference[n].real(), -reference[n].imag())) {
+            inverted = false;
+        }
+    }
+
+    std::cout << "  Constellation generate calls: single " << single_calls
+              << ", three outputs " << multi_calls << std::endl;
+    std::cout << "  Base output identical: " << (base_identical ? "yes" : "no")
+              << ", delayed element max error: " << worst_error << " LSB" << std::endl;
+
+    return base_identical && inverted && worst_error < 1.5 && multi_calls == single_calls;
+}
+
+bool test_interleaved_layout() {
+    std::cout << "=== Interleaved Layout Test ===" << std::endl;
+
+    const int sample_count = 777;
+    std::vector<OutputChannelConfig> layout = {{"base", 0.0, 0.0, 0.0},
+                                               {"rover", 10.5 / GlobalConfig::DEFAULT_SAMPLING_RATE, 1.0, -3.0}};
+    int separate_calls = 0;
+    int interleaved_calls = 0;
+    auto separate = make_orchestrator(&separate_calls);
+    auto interleaved = make_orchestrator(&interleaved_calls);
+    separate->set_outputs(layout);
+    interleaved->set_outputs(layout);
+
+    bool ok = true;
+    std::vector<std::complex<int16_t>> base(sample_count), rover(sample_count), mixed(2 * sample_count);
+    for (int chunk = 0; chunk < 3; ++chunk) {
+        std::complex<int16_t>* buffers[2] = {base.data(), rover.data()};
+        separate->mix_all_outputs(buffers, sample_count, 0.0);
+        interleaved->mix_all_outputs_interleaved(mixed.data(), sample_count, 0.0);
+        for (int i = 0; i < sample_count; ++i) {
+            ok = ok && mixed[2 * i] == base[i] && mixed[2 * i + 1] == rover[i];
+        }
+    }
+    std::cout << "  Interleaved stream " << (ok ? "matches" : "differs from") << " separate buffers" << std::endl;
+    return ok;
+}
+
+bool test_line_of_sight_offsets() {
+    std::cout << "=== Per-Satellite Line-of-Sight Test ===" << std::endl;
+
+    // A baseline of three samples along +x: the +x satellite sees no extra path,
+    // the +z satellite sees |b| of extra path and the matching carrier rotation
+    GlobalConfig config;
+    const double fs = config.sampling_rate_hz;
+    const double c = 299792458.0;
+    const double path_s = 3.0 / fs;
+    OutputChannelConfig east{"east", 0.0, 0.0, 0.0};
+    east.baseline_m[0] = path_s * c;
+
+    SignalOrchestrator orchestrator(config);
+    orchestrator.add_constellation(std::make_unique<TwoSatelliteConstellation>());
+    orchestrator.initialize({});
+    orchestrator.set_outputs({{"base", 0.0, 0.0, 0.0}, east});
+
+    const int sample_count = 500;
+    const int chunk_count = 4;
+    std::vector<std::complex<int16_t>> base(sample_count * chunk_count), shifted(base.size());
+    for (int chunk = 0; chunk < chunk_count; ++chunk) {
+        size_t offset = static_cast<size_t>(chunk) * sample_count;
+        std::complex<int16_t>* buffers[2] = {base.data() + offset, shifted.data() + offset};
+        orchestrator.mix_all_outputs(buffers, sample_count, chunk * sample_count / fs);
+    }
+
+    std::complex<double> rotation = std::polar(1.0, -2.0 * M_PI * config.center_frequency_hz * path_s);
+    bool base_sum = true;
+    double worst_error = 0.0;
+    for (size_t n = 0; n < base.size(); ++n) {
+        base_sum = base_sum && base[n] == TwoSatelliteConstellation::tone(0, n) + TwoSatelliteConstellation::tone(1, n);
+        if (n < 3) continue;
+        std::complex<int16_t> along = TwoSatelliteConstellation::tone(0, n);
+        std::complex<int16_t> across = TwoSatelliteConstellation::tone(1, n - 3);
+        std::complex<double> expected = std::complex<double>(along.real(), along.imag()) +
+                                        rotation * std::complex<double>(across.real(), across.imag());
+        worst_error = std::max(worst_error, std::abs(std::complex<double>(shifted[n].real(), shifted[n].imag()) - expected));
+    }
+
+    bool rejected = false;
+    OutputChannelConfig far{"far", 0.0, 0.0, 0.0};
+    far.baseline_m[1] = 200e3;   // 2|b|/c is past MAX_OUTPUT_DELAY_S
+    try {
+        orchestrator.set_outputs({far});
+    } catch (const QuadGNSSException&) {
+        rejected = true;
+    }
+
+    std::cout << "  Base output is the plain sum: " << (base_sum ? "yes" : "no")
+              << ", baseline output max error: " << worst_error << " LSB"
+              << ", long baseline rejected: " << (rejected ? "yes" : "no") << std::endl;
+    return base_sum && worst_error < 1.5 && rejected;
+}
+
+bool test_invalid_outputs() {
+    int calls = 0;
+    auto orchestrator = make_orchestrator(&calls);
+    std::vector<std::complex<int16_t>> buffer(16);
+    try {
+        orchestrator->mix_all_outputs_interleaved(buffer.data(), 16, 0.0);
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    try {
+        orchestrator->set_outputs({{"early", -1e-6, 0.0, 0.0}});
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    try {
+        orchestrator->set_outputs({});
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    return true;
+}
+
+int main() {
+    bool ok = test_shared_baseband_rendering();
+    ok = test_interleaved_layout() && ok;
+    ok = test_line_of_sight_offsets() && ok;
+    ok = test_invalid_outputs() && ok;
+
+    if (ok) {
+        std::cout << "✅ Multi-output tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Multi-output tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,127 @@
+#include "../include/numa_placement.h"
+#include "../include/batch_runner.h"
+#include "../include/quad_gnss_interface.h"
+#include <algorithm>
+#include <iostream>
+#include <sched.h>
+
+using namespace QuadGNSS;
+
+static bool throws(const std::string& map) {
+    try {
+        CpuTopology::parse(map);
+    } catch (const QuadGNSSException&) {
+        return true;
+    }
+    return false;
+}
+
+static std::string trajectory_scenario() {
+    return R"({"name": "drive", "sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "start_time_gps": 1000, "duration_s": 0.03, "chunk_duration_s": 0.005, "threads": 2,
+        "trajectory": [{"t": 0, "x_m": 4e6, "y_m": 8e5, "z_m": 4.9e6},
+                       {"t": 0.03, "x_m": 4.0003e6, "y_m": 8e5, "z_m": 4.9e6}],
+        "constellations": [{"type": "GPS", "satellites": [3, 12, 17], "power_dbm": -125}]})";
+}
+
+bool test_topology() {
+    std::cout << "=== CPU Topology Test ===" << std::endl;
+    bool ok = CpuTopology::parse_cpu_list("0-3, 8,10-11") == std::vector<int>({0, 1, 2, 3, 8, 10, 11}) &&
+              CpuTopology::parse_cpu_list("").empty();
+
+    // Threads take the nodes in turn, then wrap
+    CpuTopology two = CpuTopology::parse("0-1;2-3");
+    ok = ok && two.node_count() == 2 && two.cpu_count() == 4 && two.node_of(2) == 1 && two.node_of(9) == -1 &&
+         two.placement(4) == std::vector<int>({0, 2, 1, 3}) && two.placement(6) == std::vector<int>({0, 2, 1, 3, 0, 2}) &&
+         two.describe() == "0-1;2-3";
+    CpuTopology uneven = CpuTopology::parse("0,4-6;1");
+    ok = ok && uneven.placement(5) == std::vector<int>({0, 1, 4, 5, 6}) && uneven.describe() == "0,4-6;1";
+
+    bool rejected = throws("0-1;1-2") && throws("0;;1") && throws("") && throws("3-1") && throws("0-x");
+    std::cout << "  Map parsing and placement: " << (ok ? "✅" : "❌") << ", invalid maps rejected: "
+              << (rejected ? "✅" : "❌") << std::endl;
+
+    CpuTopology host = CpuTopology::detect();
+    bool covered = host.node_count() >= 1 && host.cpu_count() >= 1 &&
+                   host.node_of(host.placement(1)[0]) >= 0 && CpuTopology::parse(host.describe()).cpu_count() == host.cpu_count();
+    std::cout << "  Host: " << host.node_count() << " node(s), " << host.cpu_count() << " CPU(s) ["
+              << host.describe() << "] " << (covered ? "✅" : "❌") << std::endl;
+    return ok && rejected && covered;
+}
+
+bool test_placement() {
+    std::cout << "=== Buffer Placement Test ===" << std::endl;
+    CpuTopology host = CpuTopology::detect();
+    const int cpu = host.placement(1)[0];
+    bool pinned = pin_current_thread(cpu) && sched_getcpu() == cpu && !pin_current_thread(-1);
+    std::cout << "  Pinned to CPU " << cpu << ": " << (pinned ? "✅" : "❌") << std::endl;
+
+    // Large buffers are huge-page sized, small ones page sized; both zeroed and resident
+    HugePageBuffer large(3 * HugePageBuffer::HUGE_PAGE_BYTES / 2 + 5);
+    HugePageBuffer small(10000);
+    bool ok = large.mapped_size() == 2 * HugePageBuffer::HUGE_PAGE_BYTES && small.mapped_size() == 12288 &&
+              small.size() == 10000 && !small.hugetlb();
+    const uint8_t* bytes = large.as<uint8_t>();
+    ok = ok && std::all_of(bytes, bytes + large.size(), [](uint8_t b) { return b == 0; });
+    std::fill(large.as<uint8_t>(), large.as<uint8_t>() + large.size(), 0x5a);
+    ok = ok && bytes[large.size() - 1] == 0x5a;
+
+    // First touch on this thread: every page resident, on this CPU's node when the kernel reports it
+    std::vector<int> nodes = page_nodes(small.data(), small.size());
+    const int node = host.node_of(cpu);
+    size_t local = std::count(nodes.begin(), nodes.end(), node);
+    size_t unknown = std::count(nodes.begin(), nodes.end(), -1);
+    ok = ok && nodes.size() == 3 && (local == nodes.size() || unknown == nodes.size());
+    std::cout << "  Buffers (" << (large.hugetlb() ? "hugetlb" : "normal/THP") << "), " << local << "/"
+              << nodes.size() << " pages on node " << node << ": " << (ok ? "✅" : "❌") << std::endl;
+
+    HugePageBuffer preferred(4096, node);
+    ok = ok && preferred.as<int>()[1023] == 0;
+    return pinned && ok;
+}
+
+bool test_pinned_batch() {
+    std::cout << "=== Pinned Batch Test ===" << std::endl;
+    BatchRunner floating(2);
+    floating.add_scenario(trajectory_scenario());
+    auto reference = floating.run();
+
+    // A topology that splits the host into two nodes, so the workers are pinned alternately
+    CpuTopology host = CpuTopology::detect();
+    std::vector<int> cpus = host.placement(host.cpu_count());
+    std::sort(cpus.begin(), cpus.end());
+    CpuTopology split = host;
+    if (cpus.size() > 1) {
+        std::string first, second;
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            std::string& list = i < cpus.size() / 2 ? first : second;
+            list += (list.empty() ? "" : ",") + std::to_string(cpus[i]);
+        }
+        split = CpuTopology::parse(first + ";" + second);
+    }
+    BatchRunner pinned(2);
+    size_t count = pinned.set_topology(split);
+    pinned.add_scenario(trajectory_scenario());
+    auto results = pinned.run();
+
+    bool ok = reference.size() == 1 && reference[0].ok && results.size() == 1 && results[0].ok &&
+              results[0].checksum == reference[0].checksum && count == 2 &&
+              pinned.get_stats().pinned_workers == 2 && pinned.get_stats().numa_nodes == split.node_count();
+    std::cout << "  " << count << " worker(s) pinned over " << split.node_count() << " node(s), checksum "
+              << std::hex << results[0].checksum << std::dec << ": " << (ok ? "✅ identical" : "❌ differs")
+              << std::endl;
+    return ok;
+}
+
+int main() {
+    bool ok = test_topology();
+    ok = test_placement() && ok;
+    ok = test_pinned_batch() && ok;
+
+    if (ok) {
+        std::cout << "✅ NUMA placement tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ NUMA placement tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,168 @@
+#include "../include/realtime.h"
+#include "../include/shm_ring.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static bool close_to(uint64_t measured, double expected) {
+    return std::abs(static_cast<double>(measured) - expected) <= 0.032 * expected + 1.0;
+}
+
+bool test_histogram() {
+    std::cout << "=== Latency Histogram Test ===" << std::endl;
+    bool ok = true;
+
+    // Every value lands in a bucket whose upper edge is within 1/32 above it
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 100000 && ok; ++i) {
+        uint64_t v = rng() >> (rng() % 64);
+        size_t bucket = LatencyHistogram::bucket_of(v);
+        uint64_t high = LatencyHistogram::bucket_high(bucket);
+        ok = bucket < LatencyHistogram::BUCKET_COUNT && high >= v && high - v <= v / 32 &&
+             LatencyHistogram::bucket_of(high) == bucket;
+    }
+    ok = ok && LatencyHistogram::bucket_of(~uint64_t(0)) == LatencyHistogram::BUCKET_COUNT - 1;
+
+    // Uniform 1..100000 us: percentiles within the bucket precision, max exact
+    LatencyHistogram uniform;
+    for (uint64_t us = 1; us <= 100000; ++us) {
+        uniform.record(us * 1000);
+    }
+    bool percentiles = close_to(uniform.percentile(0.5), 50000e3) && close_to(uniform.percentile(0.99), 99000e3) &&
+                       close_to(uniform.percentile(0.999), 99900e3) && uniform.percentile(1.0) == 100000000 &&
+                       uniform.max() == 100000000 && std::abs(uniform.mean() - 50000.5e3) < 1.0;
+    std::cout << "  Bucket bounds: " << (ok ? "✅" : "❌") << ", uniform p50 " << uniform.percentile(0.5) / 1e3
+              << " us, p99.9 " << uniform.percentile(0.999) / 1e3 << " us: " << (percentiles ? "✅" : "❌") << std::endl;
+
+    // Small values are exact; a single outlier is the max and owns the top percentile
+    LatencyHistogram tail;
+    for (int i = 0; i < 999; ++i) tail.record(20);
+    tail.record(5000000);
+    LatencyHistogram merged;
+    merged.merge(tail);
+    merged.merge(tail);
+    bool outlier = tail.percentile(0.5) == 20 && tail.percentile(0.999) == 20 && tail.percentile(1.0) == 5000000 &&
+                   merged.count() == 2000 && merged.percentile(0.999) == 20 && merged.percentile(0.9996) == 5000000;
+    LatencyHistogram empty;
+    outlier = outlier && empty.percentile(0.99) == 0 && empty.mean() == 0.0;
+    tail.reset();
+    outlier = outlier && tail.count() == 0 && tail.max() == 0;
+    std::cout << "  Outlier tail and merge: " << (outlier ? "✅" : "❌") << std::endl;
+    return ok && percentiles && outlier;
+}
+
+bool test_session() {
+    std::cout << "=== Real-Time Session Test ===" << std::endl;
+    int policy = sched_getscheduler(0);
+    cpu_set_t before;
+    sched_getaffinity(0, sizeof(before), &before);
+    int cpu = sched_getcpu();
+
+    bool ok = true;
+    {
+        RealtimeOptions options;
+        options.cpus = {cpu};
+        options.fifo_priority = 10;
+        RealtimeSession session(options);
+        std::cout << "  Memory " << (session.memory_locked() ? "locked" : "not locked") << ", "
+                  << (session.pinned() ? "pinned" : "floating") << ", " << (session.fifo() ? "SCHED_FIFO" : "SCHED_OTHER")
+                  << ", " << session.get_warnings().size() << " warning(s)" << std::endl;
+        for (const auto& warning : session.get_warnings()) {
+            std::cout << "    " << warning << std::endl;
+        }
+        // Whatever was refused is reported; whatever was granted is in effect
+        size_t refused = (session.memory_locked() ? 0 : 1) + (session.pinned() ? 0 : 1) + (session.fifo() ? 0 : 1);
+        ok = session.get_warnings().size() >= refused && (!session.fifo() || sched_getscheduler(0) == SCHED_FIFO) &&
+             (!session.pinned() || sched_getcpu() == cpu);
+    }
+    cpu_set_t after;
+    sched_getaffinity(0, sizeof(after), &after);
+    bool restored = sched_getscheduler(0) == policy && CPU_EQUAL(&before, &after);
+
+    // Impossible requests fall back with warnings instead of failing
+    RealtimeOptions impossible;
+    impossible.lock_memory = false;
+    impossible.cpus = {1 << 20};
+    RealtimeSession fallback(impossible);
+    bool warned = !fallback.pinned() && !fallback.memory_locked() && !fallback.fifo() && !fallback.get_warnings().empty();
+    std::cout << "  Granted settings in effect: " << (ok ? "✅" : "❌") << ", restored afterwards: "
+              << (restored ? "✅" : "❌") << ", invalid CPU falls back: " << (warned ? "✅" : "❌") << std::endl;
+    return ok && restored && warned;
+}
+
+bool test_ring_prefault() {
+    std::cout << "=== Ring Prefault Test ===" << std::endl;
+    const std::string name = "/quadgnss_rt_test_" + std::to_string(getpid());
+    const uint32_t slots = 16, chunk = 20000;
+    ShmRingProducer producer(name, slots, chunk, 2e6);
+    auto resident = [&] {
+        struct stat info;
+        return stat(("/dev/shm" + name).c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_blocks) * 512 : 0;
+    };
+    uint64_t before = resident();
+    producer.prefault();
+    uint64_t after = resident();
+    const uint64_t slot_bytes = uint64_t(chunk) * sizeof(std::complex<int16_t>);
+    bool ok = after >= slots * slot_bytes && before < slot_bytes;
+
+    // The ring works as before; a second prefault is refused once data is in it
+    ShmRingConsumer consumer(name);
+    std::complex<int16_t>* samples = producer.begin_write();
+    samples[chunk - 1] = {3, 4};
+    producer.commit(chunk, 0, 0.0);
+    ShmRingChunk view;
+    ok = ok && consumer.acquire(view) && view.samples[chunk - 1] == std::complex<int16_t>(3, 4) &&
+         view.samples[0] == std::complex<int16_t>(0, 0) && consumer.release();
+    bool refused = false;
+    try {
+        producer.prefault();
+    } catch (const QuadGNSSException&) {
+        refused = true;
+    }
+    std::cout << "  Resident " << before / 1024 << " KiB before, " << after / 1024 << " KiB after: "
+              << (ok ? "✅" : "❌") << ", prefault after writing refused: " << (refused ? "✅" : "❌") << std::endl;
+    return ok && refused;
+}
+
+// Paced 1 ms chunks on this host, as the real-time mode releases them
+void measure_release_latency() {
+    std::cout << "=== Release Latency (1 ms period) ===" << std::endl;
+    RealtimeOptions options;
+    options.fifo_priority = 10;
+    RealtimeSession session(options);
+    LatencyHistogram latency;
+    std::vector<float> work(20000, 1.0f);
+    const auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < 200; ++k) {
+        auto release = start + std::chrono::milliseconds(k);
+        std::this_thread::sleep_until(release);
+        for (auto& w : work) w = w * 1.0001f + 0.5f;
+        latency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - release).count()));
+    }
+    std::cout << "  p50 " << latency.percentile(0.5) / 1e3 << " us, p99 " << latency.percentile(0.99) / 1e3
+              << " us, p99.9 " << latency.percentile(0.999) / 1e3 << " us, max " << latency.max() / 1e3 << " us"
+              << (session.fifo() ? " (SCHED_FIFO)" : "") << std::endl;
+}
+
+int main() {
+    bool ok = test_histogram();
+    ok = test_session() && ok;
+    ok = test_ring_prefault() && ok;
+    measure_release_latency();
+
+    if (ok) {
+        std::cout << "✅ Real-time tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Real-time tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,222 @@
+#include "../include/recording.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static std::string field(double value) {
+    std::ostringstream out;
+    out << std::setw(19) << std::scientific << std::setprecision(12) << value;
+    return out.str();
+}
+
+// Two GPS satellites in the column layout RINEXParser::parse_gps_rinex2() reads
+static void write_gps_nav(const std::string& path) {
+    std::ofstream out(path);
+    out << "     2.11           N: GPS NAV DATA                         RINEX VERSION / TYPE\n";
+    out << "                                                            END OF HEADER\n";
+    const int prns[2] = {3, 7};
+    for (int k = 0; k < 2; ++k) {
+        std::string record = " " + std::to_string(prns[k]) + "  " + std::to_string(prns[k]);
+        record.resize(22, ' ');
+        out << record << field(40) << field(345600) << field(0.0) << "\n";
+        out << field(1e-12) << field(2e-5 * (k + 1)) << field(40) << field(-30.0) << "\n";
+        out << field(4.5e-9) << field(0.4 + 2.1 * k) << field(1e-6) << field(8e-3) << "\n";
+        out << field(5e-6) << field(5153.6) << field(345600) << field(1e-8) << "\n";
+        out << field(1.1 + 1.3 * k) << field(2e-8) << field(0.96) << field(200.0) << "\n";
+        out << field(-0.5) << field(-8e-9) << field(1e-10) << field(0.0) << "\n";
+    }
+}
+
+// 6 chunks of 20460 samples from a navigation file, on a moving receiver
+static std::string scenario(const std::string& nav, const std::string& output) {
+    return R"({"name": "recorded", "sampling_rate_hz": 4.092e6, "center_frequency_hz": 1575.42e6,
+        "start_time_gps": 345600, "duration_s": 0.03, "chunk_duration_s": 0.005, "threads": 2, "seed": 7,
+        "trajectory": [{"t": 0, "lat_deg": 48.1, "lon_deg": 11.6, "height_m": 500},
+                       {"t": 0.03, "lat_deg": 48.1001, "lon_deg": 11.6, "height_m": 500}],
+        "constellations": [{"type": "GPS", "ephemeris": ")" + nav + R"(", "ephemeris_format": "rinex2",
+                            "satellites": "all", "power_dbm": -125}],
+        "sinks": [{"type": "file", "path": ")" + output + R"("}]})";
+}
+
+static std::vector<std::complex<int16_t>> read_iq(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<std::complex<int16_t>> iq(bytes.size() / sizeof(std::complex<int16_t>));
+    std::memcpy(iq.data(), bytes.data(), iq.size() * sizeof(iq[0]));
+    return iq;
+}
+
+static bool range_matches(ProceduralRecording& recording, const std::vector<std::complex<int16_t>>& reference,
+                          uint64_t first, size_t count, size_t threads) {
+    std::vector<std::complex<int16_t>> out(count);
+    recording.read(first, count, out.data(), threads);
+    return std::equal(out.begin(), out.end(), reference.begin() + first);
+}
+
+bool test_replay() {
+    std::cout << "=== Procedural Recording Replay Test ===" << std::endl;
+    const std::string pid = std::to_string(getpid());
+    const std::string nav = "recording_" + pid + ".rnx";
+    const std::string iq_path = "recording_" + pid + ".iq";
+    const std::string path = "recording_" + pid + ".qgr";
+    write_gps_nav(nav);
+
+    BatchRunner runner(2);
+    runner.add_scenario(scenario(nav, iq_path));
+    auto results = runner.run();
+    std::vector<std::complex<int16_t>> reference = read_iq(iq_path);
+    bool ok = results.size() == 1 && results[0].ok && reference.size() == 6 * 20460;
+
+    ProceduralRecording::create(path, scenario(nav, iq_path), "", 0.01, 2);
+    std::remove(nav.c_str());                  // The recording must not need the original files
+    std::remove(iq_path.c_str());
+
+    ProceduralRecording recording(path);
+    std::ifstream size_probe(path, std::ios::binary | std::ios::ate);
+    long recorded_bytes = static_cast<long>(size_probe.tellg());
+    std::cout << "  " << recorded_bytes << " bytes recorded for " << reference.size() * 4 << " bytes of IQ" << std::endl;
+    ok = ok && recorded_bytes > 0 && recorded_bytes * 50 < static_cast<long>(reference.size() * 4);
+
+    const auto& checkpoints = recording.get_checkpoints();
+    ok = ok && checkpoints.size() == 3 && checkpoints[1].chunk == 2 && checkpoints[2].first_sample == 4 * 20460 &&
+         std::abs(checkpoints[1].time_gps - 345600.01) < 1e-9;
+    ok = ok && recording.checkpoint_for(81839).chunk == 2 && recording.checkpoint_for(81840).chunk == 4;
+    ok = ok && recording.plan().get_seed() == 7 && recording.get_total_samples() == reference.size();
+    ok = ok && recording.get_scenario().find("\"nav0_" + nav + "\"") != std::string::npos &&
+         recording.get_scenario().find(iq_path) == std::string::npos;
+    std::cout << "  Seek index: " << (ok ? "✅" : "❌") << std::endl;
+
+    // Whole stream, chunk-straddling ranges, one sample, and a range inside one chunk
+    bool whole = range_matches(recording, reference, 0, reference.size(), 3);
+    bool ranges = range_matches(recording, reference, 20000, 50001, 2) &&
+                  range_matches(recording, reference, reference.size() - 1, 1, 1) &&
+                  range_matches(recording, reference, 61385, 17, 4) &&
+                  range_matches(recording, reference, 40920, 20460, 0);
+    std::cout << "  Regenerated stream: " << (whole && ranges ? "✅ bit-exact" : "❌ differs") << std::endl;
+
+    int64_t mismatch = recording.verify(2);
+    bool beyond = false;
+    try {
+        std::complex<int16_t> sample;
+        recording.read(reference.size(), 1, &sample);
+    } catch (const QuadGNSSException&) {
+        beyond = true;
+    }
+    std::remove(path.c_str());
+    return ok && whole && ranges && mismatch == -1 && beyond;
+}
+
+// All four constellations on their L1 signals: 4 chunks of 50000 samples at 1582.5 MHz
+static std::string quad_scenario(const std::string& output) {
+    return R"({"name": "recorded-quad", "sampling_rate_hz": 50e6, "center_frequency_hz": 1582.5e6,
+        "start_time_gps": 345600, "duration_s": 0.004, "chunk_duration_s": 0.001, "threads": 2, "seed": 3,
+        "receiver": {"lat_deg": 48.1, "lon_deg": 11.6, "height_m": 500},
+        "constellations": [{"type": "GPS", "satellites": [2, 12], "power_dbm": -128},
+                           {"type": "GLONASS", "satellites": [1, 2], "power_dbm": -129},
+                           {"type": "GALILEO", "satellites": [4, 19], "power_dbm": -128},
+                           {"type": "BEIDOU", "satellites": [6, 21], "power_dbm": -131}],
+        "sinks": [{"type": "file", "path": ")" + output + R"("}]})";
+}
+
+bool test_quad_replay() {
+    std::cout << "=== Quad Constellation Replay Test ===" << std::endl;
+    const std::string pid = std::to_string(getpid());
+    const std::string iq_path = "recording_" + pid + "_quad.iq";
+    const std::string path = "recording_" + pid + "_quad.qgr";
+
+    BatchRunner runner(2);
+    runner.add_scenario(quad_scenario(iq_path));
+    auto results = runner.run();
+    std::vector<std::complex<int16_t>> reference = read_iq(iq_path);
+    std::remove(iq_path.c_str());
+    bool ok = results.size() == 1 && results[0].ok && results[0].bands.size() == 4 && reference.size() == 4 * 50000;
+    if (!ok) {
+        std::cout << "  Batch job: " << (results.empty() ? "missing" : results[0].error) << std::endl;
+        return false;
+    }
+
+    ProceduralRecording::create(path, quad_scenario(iq_path), "", 0.002, 2);
+    ProceduralRecording recording(path);
+    ok = recording.get_checkpoints().size() == 2 && recording.get_total_samples() == reference.size();
+    bool ranges = range_matches(recording, reference, 0, reference.size(), 2) &&
+                  range_matches(recording, reference, 99990, 20, 1) &&
+                  range_matches(recording, reference, 123457, 1, 1);
+    int64_t mismatch = recording.verify(2);
+    std::cout << "  Regenerated stream: " << (ranges ? "✅ bit-exact" : "❌ differs") << ", fingerprint "
+              << (mismatch == -1 ? "verified" : "differs at checkpoint " + std::to_string(mismatch)) << std::endl;
+    std::remove(path.c_str());
+    return ok && ranges && mismatch == -1;
+}
+
+bool test_damaged_recordings() {
+    std::cout << "=== Damaged Recording Test ===" << std::endl;
+    const std::string pid = std::to_string(getpid());
+    const std::string nav = "recording_" + pid + "_b.rnx";
+    const std::string path = "recording_" + pid + "_b.qgr";
+    write_gps_nav(nav);
+    ProceduralRecording::create(path, scenario(nav, "unused.iq"), "", 0.01, 1);
+    std::remove(nav.c_str());
+
+    std::ifstream in(path, std::ios::binary);
+    std::string good((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto write = [&](const std::string& bytes) { std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes; };
+
+    // A fingerprint from another build: opens, but verify() points at the checkpoint
+    std::string drifted = good;
+    drifted[drifted.size() - 1] ^= 0x40;
+    write(drifted);
+    bool ok = ProceduralRecording(path).verify(1) == 2;
+
+    std::string bad_magic = good;
+    bad_magic[0] = 'X';
+    std::string bad_seek = good;
+    bad_seek[bad_seek.size() - 24] ^= 1;       // First sample of the last checkpoint
+    const std::string broken[] = {good.substr(0, good.size() - 3), bad_magic, bad_seek, good.substr(0, 12)};
+    int rejected = 0;
+    for (const auto& bytes : broken) {
+        write(bytes);
+        try {
+            ProceduralRecording damaged(path);
+        } catch (const QuadGNSSException& e) {
+            std::cout << "  " << e.what() << std::endl;
+            rejected++;
+        }
+    }
+    std::cout << "  " << rejected << "/4 damaged recordings rejected" << std::endl;
+    std::remove(path.c_str());
+
+    int refused = 0;
+    try {
+        ProceduralRecording::create(path, scenario("/nonexistent/nav.rnx", "unused.iq"));
+    } catch (const QuadGNSSException&) {
+        refused++;
+    }
+    try {
+        ProceduralRecording::create(path, scenario(nav, "unused.iq"), "", 0.0);
+    } catch (const QuadGNSSException&) {
+        refused++;
+    }
+    return ok && rejected == 4 && refused == 2;
+}
+
+int main() {
+    bool ok = test_replay();
+    ok = test_quad_replay() && ok;
+    ok = test_damaged_recordings() && ok;
+
+    if (ok) {
+        std::cout << "✅ Recording tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Recording tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,274 @@
+#include "../include/batch_runner.h"
+#include "../include/scenario.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static const char* VALID_SCENARIO = R"({
+    "name": "drive-test",
+    "sampling_rate_hz": 60e6,
+    "center_frequency_hz": 1582e6,
+    "start_time_gps": 345600,
+    "duration_s": 2.5,
+    "chunk_duration_s": 0.01,
+    "threads": 3,
+    "trajectory": [
+        {"t": 0, "x_m": 4000000, "y_m": 800000, "z_m": 4900000},
+        {"t": 10, "x_m": 4000100, "y_m": 800000, "z_m": 4900000}
+    ],
+    "constellations": [
+        {"type": "GPS", "satellites": [1, 3, 7, 12, 22], "power_dbm": -130,
+         "power_overrides": {"7": -124.5}},
+        {"type": "glonass", "satellites": "all", "exclude": [14]},
+        {"type": "BEIDOU", "satellites": [6, 21], "power_dbm": -133}
+    ],
+    "sinks": [
+        {"type": "file", "path": "out.iq", "backend": "threads"},
+        {"type": "stream", "port": 5555}
+    ],
+    "pipeline": [
+        {"name": "sources", "type": "external"},
+        {"name": "gain", "type": "gain", "gain_db": -3, "inputs": ["sources"]}
+    ]
+})";
+
+bool test_json_parser() {
+    std::cout << "=== JSON Parser Test ===" << std::endl;
+    JsonValue doc = parse_json(R"({"a": [1, 2.5e3, -4], "b": {"c": "x\"é\n"}, "d": true, "e": null})");
+    bool ok = doc.is_object() && doc.find("a")->as_array().size() == 3 &&
+              doc.find("a")->as_array()[1].as_number() == 2500.0 &&
+              doc.find("b")->find("c")->as_string() == "x\"\xc3\xa9\n" &&
+              doc.find("d")->as_bool() && doc.find("e")->is_null();
+
+    // Formatting round-trips every value exactly
+    JsonValue numbers = parse_json(R"([0.1, 4.092e6, 1575.42e6, -1e-300, 9007199254740993, "\u0001"])");
+    std::string text = format_json(numbers);
+    JsonValue again = parse_json(text);
+    ok = ok && format_json(again) == text && format_json(parse_json(format_json(doc))) == format_json(doc);
+    for (size_t i = 0; i < 5; ++i) {
+        ok = ok && again.as_array()[i].as_number() == numbers.as_array()[i].as_number();
+    }
+    ok = ok && again.as_array()[5].as_string() == "\x01";
+
+    try {
+        parse_json("{\n  \"a\": 1,\n  \"b\": [1, 2,, 3]\n}");
+        ok = false;
+    } catch (const QuadGNSSException& e) {
+        std::string message = e.what();
+        std::cout << "  " << message << std::endl;
+        ok = ok && message.find("3:") != std::string::npos;
+    }
+    return ok;
+}
+
+bool test_compile_plan() {
+    std::cout << "=== Scenario Compilation Test ===" << std::endl;
+    std::shared_ptr<const ExecutionPlan> plan = ScenarioCompiler::compile(VALID_SCENARIO);
+    std::cout << plan->describe();
+
+    const auto& sats = plan->get_satellites();
+    size_t gps = 0, glonass = 0, beidou = 0;
+    double prn7_power = 0.0;
+    for (const auto& sat : sats) {
+        if (sat.constellation == ConstellationType::GPS) {
+            gps++;
+            if (sat.prn == 7) prn7_power = sat.power_dbm;
+        }
+        if (sat.constellation == ConstellationType::GLONASS) glonass++;
+        if (sat.constellation == ConstellationType::BEIDOU) beidou++;
+    }
+
+    // GLONASS slots 1..24 but 14 sit on 12 nominal channels (antipodal pairs); GPS and BeiDou have one carrier apiece
+    bool ok = gps == 5 && glonass == 23 && beidou == 2 && prn7_power == -124.5;
+    ok = ok && plan->get_frequency_plan().size() == 14;
+    ok = ok && plan->get_chunk_samples() == 600000 && plan->get_total_chunks() == 250 &&
+         plan->get_chunk_bytes() == 2400000 && plan->get_file_buffer_bytes() % 4096 == 0;
+
+    const ThreadLayout& layout = plan->get_thread_layout();
+    ok = ok && layout.generator_threads == 3 && layout.generator_assignment[0].size() == 1 &&
+         layout.generator_assignment[0][0] == ConstellationType::GLONASS &&
+         layout.sink_threads == 3 && layout.graph_workers == 0;
+
+    double x, y, z;
+    plan->receiver_position(5.0, x, y, z);
+    ok = ok && std::abs(x - 4000050.0) < 1e-6 && plan->get_config().receiver.x_m == 4000000.0;
+    plan->receiver_position(100.0, x, y, z);
+    ok = ok && x == 4000100.0;
+
+    ok = ok && plan->get_pipeline().size() == 2 && plan->get_pipeline()[1].params.at("gain_db") == -3.0 &&
+         plan->get_config().active_constellations.size() == 3;
+
+    // Geodetic receiver: equator / prime meridian is one semi-major axis out on +X
+    auto geodetic = ScenarioCompiler::compile(R"({"receiver": {"lat_deg": 0, "lon_deg": 0, "height_m": 0},
+        "constellations": [{"type": "GALILEO", "satellites": [1]}]})");
+    ok = ok && std::abs(geodetic->get_config().receiver.x_m - 6378137.0) < 1e-3 &&
+         geodetic->get_sinks().size() == 1 && geodetic->get_sinks()[0].type == ScenarioSinkType::STDOUT;
+    return ok;
+}
+
+bool test_validation_errors() {
+    std::cout << "=== Scenario Validation Test ===" << std::endl;
+
+    // Five independent mistakes, all reported in one pass
+    const char* broken = R"({
+        "sampling_rate_hz": 10e6,
+        "center_frequency_hz": 1602e6,
+        "duraton_s": 5,
+        "receiver": {"x_m": 1, "y_m": 2},
+        "constellations": [
+            {"type": "GPS", "satellites": [1, 40]},
+            {"type": "GALILEO", "satellites": [2], "ephemeris": "/nonexistent/galileo.rnx"}
+        ],
+        "sinks": [{"type": "shm", "name": "no-slash"}]
+    })";
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> errors = ScenarioCompiler::validate(broken);
+    double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& e : errors) {
+        std::cout << "  " << e << std::endl;
+    }
+    std::cout << "  " << errors.size() << " errors in " << elapsed_us << " us" << std::endl;
+
+    auto has = [&](const std::string& fragment) {
+        for (const auto& e : errors) {
+            if (e.find(fragment) != std::string::npos) return true;
+        }
+        std::cout << "  missing error: " << fragment << std::endl;
+        return false;
+    };
+    bool ok = has("unknown key \"duraton_s\"") && has("$.receiver.z_m: required") &&
+              has("$.constellations[0].satellites[1]") && has("$.constellations[0]: no GPS signal band fits") &&
+              has("cannot read /nonexistent/galileo.rnx") && has("$.sinks[0].name");
+
+    ok = ok && ScenarioCompiler::validate(VALID_SCENARIO).empty();
+
+    try {
+        ScenarioCompiler::compile(broken);
+        ok = false;
+    } catch (const QuadGNSSException& e) {
+        ok = ok && std::string(e.what()).find("Invalid scenario") != std::string::npos;
+    }
+    try {
+        ScenarioCompiler::compile_file("/nonexistent/scenario.json");
+        ok = false;
+    } catch (const QuadGNSSException&) {
+    }
+    return ok;
+}
+
+// RINEX 3 GLONASS record: epoch line and three orbit lines, frequency number in orbit line 2
+static std::string glonass_record(int slot, int channel) {
+    char text[512];
+    std::snprintf(text, sizeof(text),
+                  "R%02d 2020 01 01 00 15 00%19.12E%19.12E%19.12E\n"
+                  "    %19.12E%19.12E%19.12E%19.12E\n"
+                  "    %19.12E%19.12E%19.12E%19.12E\n"
+                  "    %19.12E%19.12E%19.12E%19.12E\n",
+                  slot, 1e-5, 0.0, 0.0, 1e4, 1.0, 0.0, 0.0, -1e4, 2.0, 0.0, static_cast<double>(channel),
+                  2e4, 3.0, 0.0, 0.0);
+    return text;
+}
+
+bool test_glonass_slots() {
+    std::cout << "=== GLONASS Slot Test ===" << std::endl;
+    const std::string nav = "glonass_nav_" + std::to_string(getpid()) + ".rnx";
+    std::ofstream(nav) << "     3.04           N: GNSS NAV DATA    R: GLONASS          RINEX VERSION / TYPE\n"
+                       << "                                                            END OF HEADER\n"
+                       << glonass_record(3, 5) << glonass_record(17, 2) << glonass_record(24, -7);
+
+    // "all" takes the slots of the file; the broadcast channel beats the nominal one (slot 17 is nominally +4)
+    bool ok = true;
+    try {
+        auto plan = ScenarioCompiler::compile(R"({"receiver": {"x_m": 6378137, "y_m": 0, "z_m": 0},
+            "constellations": [{"type": "GLONASS", "satellites": "all",
+            "ephemeris": ")" + nav + R"("}]})");
+        std::map<int, int> channels;
+        for (const auto& sat : plan->get_satellites()) {
+            channels[sat.prn] = sat.glonass_channel;
+            ok = ok && std::abs(sat.carrier_hz - (1602e6 + sat.glonass_channel * 0.5625e6)) < 1e-3;
+        }
+        std::cout << "  Slots from ephemeris: " << channels.size() << std::endl;
+        ok = ok && channels == std::map<int, int>{{3, 5}, {17, 2}, {24, -7}};
+    } catch (const QuadGNSSException& e) {
+        std::cout << "  " << e.what() << std::endl;
+        ok = false;
+    }
+    std::remove(nav.c_str());
+
+    // Without ephemeris every slot 1..24 is accepted on its nominal channel
+    auto nominal = ScenarioCompiler::compile(R"({"receiver": {"x_m": 6378137, "y_m": 0, "z_m": 0},
+        "constellations": [{"type": "GLONASS", "satellites": [15, 24]}]})");
+    ok = ok && nominal->get_satellites().size() == 2 && nominal->get_satellites()[0].glonass_channel == 0 &&
+         nominal->get_satellites()[1].glonass_channel == 2;
+
+    // Power overrides are range-checked like power_dbm
+    std::vector<std::string> errors = ScenarioCompiler::validate(R"({"receiver": {"x_m": 6378137, "y_m": 0, "z_m": 0},
+        "constellations": [{"type": "GPS",
+        "satellites": [1, 2], "power_overrides": {"1": -20, "2": -140}}]})");
+    ok = ok && errors.size() == 1 && errors[0].find("power_overrides.1") != std::string::npos;
+    for (const auto& e : errors) {
+        std::cout << "  " << e << std::endl;
+    }
+    return ok;
+}
+
+// Validation selects bands exactly as compile() and the renderer do
+bool test_renderability() {
+    std::cout << "=== Renderability Test ===" << std::endl;
+
+    // The documented example (without its ephemeris file) renders GPS L1 C/A and GLONASS L1OF
+    const char* example = R"({"name": "static-urban", "sampling_rate_hz": 60e6, "center_frequency_hz": 1582e6,
+        "start_time_gps": 345600, "duration_s": 30, "chunk_duration_s": 0.001, "threads": 4, "seed": 7,
+        "receiver": {"lat_deg": 48.1, "lon_deg": 11.6, "height_m": 520},
+        "constellations": [
+            {"type": "GPS", "satellites": "all", "power_dbm": -130, "exclude": [4], "power_overrides": {"7": -125}},
+            {"type": "GLONASS", "satellites": [1, 2, 8]}]})";
+    bool ok = ScenarioCompiler::validate(example).empty();
+    auto plan = ScenarioCompiler::compile(example);
+    ok = ok && plan->get_bands() == std::vector<SignalBand>{SignalBand::GPS_L1CA, SignalBand::GLONASS_L1OF};
+    PlanRenderer renderer(plan);
+    std::vector<std::complex<int16_t>> chunk(plan->get_chunk_samples());
+    renderer.render(3, chunk.data());
+    ok = ok && std::any_of(chunk.begin(), chunk.end(), [](std::complex<int16_t> s) { return s.real() != 0; });
+
+    // 4.092 MSps at 1602 MHz: slot 11 (k=0) fits, slot 6 (k=-4) does not, and validate says so like compile
+    const std::string narrow = R"({"sampling_rate_hz": 4.092e6, "center_frequency_hz": 1602e6,
+        "receiver": {"x_m": 6378137, "y_m": 0, "z_m": 0}, "constellations": [{"type": "GLONASS", "satellites": )";
+    ok = ok && ScenarioCompiler::validate(narrow + "[11]}]}").empty();
+    ok = ok && ScenarioCompiler::compile(narrow + "[11]}]}")->get_bands() ==
+               std::vector<SignalBand>{SignalBand::GLONASS_L1OF};
+    std::vector<std::string> errors = ScenarioCompiler::validate(narrow + "[11, 6]}]}");
+    for (const auto& e : errors) {
+        std::cout << "  " << e << std::endl;
+    }
+    ok = ok && errors.size() == 1 && errors[0].find("no GLONASS signal band fits") != std::string::npos;
+    try {
+        ScenarioCompiler::compile(narrow + "[11, 6]}]}");
+        ok = false;
+    } catch (const QuadGNSSException&) {
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = test_json_parser();
+    ok = test_compile_plan() && ok;
+    ok = test_validation_errors() && ok;
+    ok = test_glonass_slots() && ok;
+    ok = test_renderability() && ok;
+
+    if (ok) {
+        std::cout << "✅ Scenario tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Scenario tests failed" << std::endl;
+    return 1;
+}
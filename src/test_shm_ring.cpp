@@ -0,0 +1,124 @@
+#include "../include/shm_ring.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static void fill_chunk(std::complex<int16_t>* samples, uint32_t count, uint64_t sequence) {
+    for (uint32_t i = 0; i < count; ++i) {
+        samples[i] = std::complex<int16_t>(static_cast<int16_t>(sequence), static_cast<int16_t>(i));
+    }
+}
+
+static bool chunk_matches(const ShmRingChunk& chunk, uint64_t sequence, uint32_t count) {
+    if (chunk.sequence != sequence || chunk.sample_count != count ||
+        chunk.sample_index != sequence * count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (chunk.samples[i] != std::complex<int16_t>(static_cast<int16_t>(sequence), static_cast<int16_t>(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_fan_out() {
+    std::cout << "=== Shared-Memory Ring Fan-Out Test ===" << std::endl;
+
+    const std::string name = "/quadgnss_ring_test_" + std::to_string(getpid());
+    const uint32_t chunk = 1000;
+    ShmRingProducer producer(name, 8, chunk, 60e6);
+
+    ShmRingConsumer fast(name);
+    ShmRingConsumer slow(name);
+    if (!fast.is_producer_alive() || fast.get_slot_capacity() != chunk ||
+        fast.get_sampling_rate() != 60e6) {
+        std::cout << "  Header mismatch" << std::endl;
+        return false;
+    }
+
+    ShmRingChunk view;
+    if (fast.acquire(view)) {
+        std::cout << "  Empty ring returned data" << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::vector<std::complex<int16_t>> local(chunk);
+    for (uint64_t seq = 0; seq < 20; ++seq) {
+        std::complex<int16_t>* slot = producer.begin_write();
+        fill_chunk(slot, chunk, seq);
+        producer.commit(chunk, seq * chunk, seq * 1e-3);
+
+        // Fast consumer reads every chunk in place
+        if (!fast.acquire(view) || !chunk_matches(view, seq, chunk) || !fast.release()) {
+            std::cout << "  Fast consumer mismatch at " << seq << std::endl;
+            ok = false;
+        }
+    }
+
+    // Slow consumer was lapped: it keeps the newest slot_count-1 chunks and counts the rest
+    uint64_t expected_seq = 20 - 7;
+    while (slow.read_copy(local.data(), view)) {
+        if (!chunk_matches(view, expected_seq, chunk)) {
+            std::cout << "  Slow consumer mismatch at " << expected_seq << std::endl;
+            ok = false;
+        }
+        expected_seq++;
+    }
+    std::cout << "  Fast overruns: " << fast.get_overrun_count()
+              << ", slow overruns: " << slow.get_overrun_count() << std::endl;
+
+    return ok && fast.get_overrun_count() == 0 && slow.get_overrun_count() == 13 && expected_seq == 20;
+}
+
+bool test_borrowed_slot_overwrite() {
+    std::cout << "=== Borrowed Slot Overwrite Test ===" << std::endl;
+
+    const std::string name = "/quadgnss_ring_test_b_" + std::to_string(getpid());
+    ShmRingProducer producer(name, 4, 64, 1e6);
+    ShmRingConsumer consumer(name, true);
+
+    fill_chunk(producer.begin_write(), 64, 0);
+    producer.commit(64, 0, 0.0);
+
+    ShmRingChunk view;
+    if (!consumer.acquire(view)) return false;
+
+    // Producer laps the borrowed slot while the consumer still holds it
+    for (uint64_t seq = 1; seq <= 4; ++seq) {
+        fill_chunk(producer.begin_write(), 64, seq);
+        producer.commit(64, seq * 64, 0.0);
+    }
+    bool detected = !consumer.release();
+
+    bool resumed = consumer.acquire(view) && consumer.release();
+    std::cout << "  Overwrite detected: " << (detected ? "yes" : "no")
+              << ", resumed at sequence " << view.sequence << std::endl;
+    return detected && resumed && view.sequence == 2;
+}
+
+bool test_invalid_open() {
+    try {
+        ShmRingConsumer missing("/quadgnss_ring_does_not_exist");
+        return false;
+    } catch (const QuadGNSSException&) {
+        return true;
+    }
+}
+
+int main() {
+    bool ok = test_fan_out();
+    ok = test_borrowed_slot_overwrite() && ok;
+    ok = test_invalid_open() && ok;
+
+    if (ok) {
+        std::cout << "✅ Shared-memory ring tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Shared-memory ring tests failed" << std::endl;
+    return 1;
+}
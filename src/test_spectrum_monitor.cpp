@@ -0,0 +1,266 @@
+#include "../include/spectrum_monitor.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+// Spread-spectrum test provider: pseudo-random chips at the constellation's rate, at the assigned offset
+class SpreadConstellation : public ISatelliteConstellation {
+public:
+    SpreadConstellation(ConstellationType type, double carrier_hz, double chip_rate_hz, bool boc, double misplace_hz = 0.0)
+        : type_(type), carrier_hz_(carrier_hz), chip_rate_hz_(chip_rate_hz), boc_(boc)
+        , misplace_hz_(misplace_hz), offset_hz_(0.0), sampling_rate_hz_(1.0) {}
+
+    void generate_chunk(std::complex<int16_t>* buffer, int sample_count, double time_now) override {
+        const double frequency = offset_hz_ + misplace_hz_;
+        double cycles = frequency * time_now;
+        double angle = 2.0 * M_PI * (cycles - std::floor(cycles));
+        double re = std::cos(angle), im = std::sin(angle);
+        const double step_re = std::cos(2.0 * M_PI * frequency / sampling_rate_hz_);
+        const double step_im = std::sin(2.0 * M_PI * frequency / sampling_rate_hz_);
+        for (int i = 0; i < sample_count; ++i) {
+            double t = time_now + i / sampling_rate_hz_;
+            uint64_t chip = static_cast<uint64_t>(t * chip_rate_hz_);
+            uint64_t hash = (chip + static_cast<uint64_t>(type_) * 0x9E3779B97F4A7C15ULL) * 0xD1B54A32D192ED03ULL;
+            double sign = (hash >> 63) ? 1.0 : -1.0;
+            if (boc_ && (static_cast<uint64_t>(t * 2.0 * chip_rate_hz_) & 1)) sign = -sign;
+            buffer[i] = std::complex<int16_t>(static_cast<int16_t>(AMPLITUDE * sign * re),
+                                              static_cast<int16_t>(AMPLITUDE * sign * im));
+            double next = re * step_re - im * step_im;
+            im = re * step_im + im * step_re;
+            re = next;
+        }
+    }
+
+    void load_ephemeris(const std::string&) override {}
+    void set_frequency_offset(double offset_hz) override { offset_hz_ = offset_hz; }
+    ConstellationType get_constellation_type() const override { return type_; }
+    double get_carrier_frequency() const override { return carrier_hz_; }
+    std::vector<SatelliteInfo> get_active_satellites() const override { return {}; }
+    void configure(const GlobalConfig& config) override { sampling_rate_hz_ = config.sampling_rate_hz; }
+    bool is_ready() const override { return true; }
+
+private:
+    static constexpr double AMPLITUDE = 2000.0;
+
+    ConstellationType type_;
+    double carrier_hz_;
+    double chip_rate_hz_;
+    bool boc_;
+    double misplace_hz_;                       // Deliberate error on top of the assigned offset
+    double offset_hz_;
+    double sampling_rate_hz_;
+};
+
+struct RunResult {
+    SpectrumSnapshot snapshot;
+    SpectrumMonitorStats stats;
+    double generation_s;
+};
+
+static void print_snapshot(const SpectrumSnapshot& snapshot, const SpectrumMonitorStats& stats, double generation_s) {
+    std::cout << "  Snapshot " << snapshot.index << ": " << snapshot.segments << " segments, floor "
+              << std::fixed << std::setprecision(1) << snapshot.floor_db << " dB" << std::endl;
+    for (const auto& band : snapshot.bands) {
+        std::cout << "    " << std::left << std::setw(8) << band.name << std::right << " expected "
+                  << std::setprecision(3) << std::setw(8) << band.expected_offset_hz / 1e6 << " MHz, measured "
+                  << std::setw(8) << band.measured_offset_hz / 1e6 << " MHz, excess " << std::setprecision(1)
+                  << std::setw(5) << band.excess_db << " dB  " << band_status_name(band.status) << std::endl;
+    }
+    for (const auto& span : snapshot.unexpected) {
+        std::cout << "    Unexpected power " << std::setprecision(3) << span.low_hz / 1e6 << " .. "
+                  << span.high_hz / 1e6 << " MHz (" << std::setprecision(1) << span.peak_excess_db << " dB)" << std::endl;
+    }
+    // Wall-clock cost is a metric for the log, not a pass criterion: it depends on the host and its load
+    std::cout << "  " << stats.segments_analysed << " analysed, " << stats.segments_skipped << " skipped" << std::endl;
+    std::cout << "  Metric: monitor cost " << std::setprecision(2)
+              << 100.0 * (stats.tap_seconds + stats.analysis_seconds) / generation_s << "% of "
+              << std::setprecision(3) << generation_s << " s generation" << std::endl;
+}
+
+// Generate through the orchestrator, add receiver noise and tap every chunk
+static RunResult run_orchestrator(SignalOrchestrator& orchestrator, const SpectrumMonitorConfig& config,
+                                  double duration_s) {
+    orchestrator.initialize({});
+    SpectrumMonitor monitor(config, expected_spectrum_bands(orchestrator.get_frequency_offsets()));
+
+    std::mt19937 rng(11);
+    std::normal_distribution<float> normal(0.0f, 1000.0f);
+    std::vector<std::complex<int16_t>> noise(1 << 16);
+    for (auto& n : noise) {
+        n = std::complex<int16_t>(static_cast<int16_t>(normal(rng)), static_cast<int16_t>(normal(rng)));
+    }
+
+    const int chunk = static_cast<int>(config.sampling_rate_hz * 0.001);
+    const int chunks = static_cast<int>(std::llround(duration_s / 0.001));
+    std::vector<std::complex<int16_t>> buffer(chunk);
+    size_t noise_index = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < chunks; ++c) {
+        double time_now = 1000.0 + c * 0.001;
+        orchestrator.mix_all_signals(buffer.data(), chunk, time_now);
+        for (auto& s : buffer) {
+            const auto& n = noise[noise_index++ & (noise.size() - 1)];
+            s = std::complex<int16_t>(static_cast<int16_t>(s.real() + n.real()), static_cast<int16_t>(s.imag() + n.imag()));
+        }
+        monitor.tap(buffer.data(), chunk, time_now);
+    }
+    monitor.flush();
+    double generation_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return RunResult{monitor.latest_snapshot(), monitor.get_stats(), generation_s};
+}
+
+static SpectrumMonitorConfig monitor_config(double fs, double center, const std::string& path = "") {
+    SpectrumMonitorConfig config;
+    config.sampling_rate_hz = fs;
+    config.center_frequency_hz = center;
+    config.snapshot_interval_s = 0.05;
+    config.snapshot_path = path;
+    return config;
+}
+
+bool test_band_occupancy() {
+    std::cout << "=== Spectrum Monitor Band Occupancy Test ===" << std::endl;
+    const std::string path = "spectrum_test_" + std::to_string(getpid()) + ".txt";
+    GlobalConfig config;
+    config.sampling_rate_hz = 40e6;
+    config.center_frequency_hz = 1561.098e6;                  // BeiDou at DC, GPS and Galileo at +14.322 MHz
+    config.active_constellations = {ConstellationType::GPS, ConstellationType::GALILEO, ConstellationType::BEIDOU};
+
+    SignalOrchestrator orchestrator(config);
+    orchestrator.add_constellation(std::make_unique<SpreadConstellation>(ConstellationType::GPS, 1575.42e6, 1.023e6, false));
+    orchestrator.add_constellation(std::make_unique<SpreadConstellation>(ConstellationType::GALILEO, 1575.42e6, 1.023e6, true));
+    orchestrator.add_constellation(std::make_unique<SpreadConstellation>(ConstellationType::BEIDOU, 1561.098e6, 2.046e6, false));
+    RunResult run = run_orchestrator(orchestrator, monitor_config(config.sampling_rate_hz, config.center_frequency_hz, path), 0.2);
+    print_snapshot(run.snapshot, run.stats, run.generation_s);
+
+    bool ok = run.snapshot.bands.size() == 3 && run.snapshot.all_bands_ok() && run.snapshot.unexpected.empty() &&
+              run.stats.snapshots >= 3 && run.stats.segments_analysed > 0;
+    for (const auto& band : run.snapshot.bands) {
+        ok = ok && band.excess_db > 10.0 && std::abs(band.measured_offset_hz - band.expected_offset_hz) < 50e3;
+    }
+
+    // The snapshot file holds the last report and one line per bin
+    std::ifstream in(path);
+    std::string line;
+    size_t band_lines = 0, bins = 0;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 5, "band ") == 0) band_lines++;
+        else if (!line.empty() && line[0] != '#' && line.compare(0, 11, "unexpected ") != 0) bins++;
+    }
+    ok = ok && band_lines == 3 && bins == 4096;
+    std::remove(path.c_str());
+    return ok;
+}
+
+bool test_misplaced_providers() {
+    std::cout << "=== Spectrum Monitor Misplaced Provider Test ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 40e6;
+    config.center_frequency_hz = 1561.098e6;
+    config.active_constellations = {ConstellationType::GPS, ConstellationType::BEIDOU};
+
+    // GPS 600 kHz high, BeiDou 15 MHz low: one lobe is off centre, the other is somewhere nobody expects
+    SignalOrchestrator orchestrator(config);
+    orchestrator.add_constellation(std::make_unique<SpreadConstellation>(ConstellationType::GPS, 1575.42e6, 1.023e6, false, 0.6e6));
+    orchestrator.add_constellation(std::make_unique<SpreadConstellation>(ConstellationType::BEIDOU, 1561.098e6, 2.046e6, false, -15e6));
+    RunResult run = run_orchestrator(orchestrator, monitor_config(config.sampling_rate_hz, config.center_frequency_hz), 0.1);
+    print_snapshot(run.snapshot, run.stats, run.generation_s);
+
+    const auto& bands = run.snapshot.bands;
+    auto status = [&](const std::string& name) {
+        for (const auto& b : bands) if (b.name == name) return b.status;
+        return BandStatus::OUTSIDE_STREAM;
+    };
+    bool ok = status("GPS") == BandStatus::OFFSET && status("BeiDou") == BandStatus::MISSING &&
+              !run.snapshot.unexpected.empty();
+    bool covered = false;
+    for (const auto& span : run.snapshot.unexpected) {
+        ok = ok && span.high_hz < -5e6;                      // Nothing but the stray BeiDou lobe and its sidelobes
+        covered = covered || (span.low_hz < -15e6 && span.high_hz > -15e6);
+    }
+    ok = ok && covered;
+    return ok;
+}
+
+bool test_glonass_stage_tap() {
+    std::cout << "=== Spectrum Monitor Stage Graph Tap Test ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 20e6;
+    config.center_frequency_hz = 1598e6;                      // GLONASS L1 at +4 MHz
+    config.active_constellations = {ConstellationType::GLONASS};
+
+    SignalOrchestrator orchestrator(config);
+    auto provider = std::make_unique<SpreadConstellation>(ConstellationType::GLONASS, 1602e6, 0.511e6, false);
+    SpreadConstellation& glonass = *provider;
+    orchestrator.add_constellation(std::move(provider));
+    orchestrator.initialize({});
+
+    SpectrumMonitorConfig monitor_settings = monitor_config(config.sampling_rate_hz, config.center_frequency_hz);
+    monitor_settings.fft_size = 2048;
+    SpectrumMonitor monitor(monitor_settings, expected_spectrum_bands(orchestrator.get_frequency_offsets()));
+
+    // Provider -> float -> noise -> int16 -> spectrum tap
+    StageGraph graph;
+    size_t source = graph.add_stage("glonass", std::make_unique<ConstellationSourceStage>(glonass));
+    size_t sum = graph.add_stage("sum", std::make_unique<SumCombinerStage>(1));
+    size_t noise = graph.add_stage("noise", std::make_unique<NoiseStage>(300.0, 5));
+    size_t quantize = graph.add_stage("quantize", std::make_unique<QuantizeStage>());
+    size_t tap = graph.add_stage("spectrum", std::make_unique<SpectrumTapStage>(monitor));
+    graph.connect(source, sum);
+    graph.connect(sum, noise);
+    graph.connect(noise, quantize);
+    graph.connect(quantize, tap);
+
+    const int chunk = 20000;
+    graph.compile(chunk);
+    for (int c = 0; c < 100; ++c) {
+        graph.run(chunk, 500.0 + c * 0.001);
+    }
+    monitor.flush();
+    SpectrumSnapshot snapshot = monitor.latest_snapshot();
+    SpectrumMonitorStats stats = monitor.get_stats();
+    print_snapshot(snapshot, stats, 1.0);
+
+    return snapshot.bands.size() == 1 && snapshot.bands[0].name == "GLONASS" &&
+           snapshot.bands[0].expected_offset_hz == 4e6 && snapshot.all_bands_ok() && stats.snapshots >= 2;
+}
+
+bool test_invalid_configuration() {
+    std::cout << "=== Spectrum Monitor Configuration Test ===" << std::endl;
+    SpectrumMonitorConfig config = monitor_config(10e6, 1575.42e6);
+    config.fft_size = 1000;
+    try {
+        SpectrumMonitor monitor(config, {});
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    config.fft_size = 1024;
+    config.cpu_budget = 0.0;
+    try {
+        SpectrumMonitor monitor(config, {});
+        return false;
+    } catch (const QuadGNSSException&) {
+    }
+    return true;
+}
+
+int main() {
+    bool ok = test_band_occupancy();
+    ok = test_misplaced_providers() && ok;
+    ok = test_glonass_stage_tap() && ok;
+    ok = test_invalid_configuration() && ok;
+
+    if (ok) {
+        std::cout << "✅ Spectrum monitor tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Spectrum monitor tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,279 @@
+#include "../include/stage_graph.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace QuadGNSS;
+
+// Phase-continuous complex tone
+class ToneConstellation : public ISatelliteConstellation {
+private:
+    double cycles_per_sample_;
+    double amplitude_;
+    uint64_t next_sample_ = 0;
+
+public:
+    ToneConstellation(double cycles_per_sample, double amplitude)
+        : cycles_per_sample_(cycles_per_sample), amplitude_(amplitude) {}
+
+    void generate_chunk(std::complex<int16_t>* buffer, int sample_count, double) override {
+        for (int i = 0; i < sample_count; ++i) {
+            double phase = 2.0 * M_PI * cycles_per_sample_ * static_cast<double>(next_sample_++);
+            buffer[i] = std::complex<int16_t>(static_cast<int16_t>(std::lround(amplitude_ * std::cos(phase))),
+                                              static_cast<int16_t>(std::lround(amplitude_ * std::sin(phase))));
+        }
+    }
+    void load_ephemeris(const std::string&) override {}
+    void set_frequency_offset(double) override {}
+    ConstellationType get_constellation_type() const override { return ConstellationType::GPS; }
+    double get_carrier_frequency() const override { return 1575.42e6; }
+    std::vector<SatelliteInfo> get_active_satellites() const override { return {}; }
+    void configure(const GlobalConfig&) override {}
+    bool is_ready() const override { return true; }
+};
+
+static const double SHIFT_HZ = 125e3;
+static const double GAIN_DB = -3.0;
+
+// gps + glonass -> sum -> gain -> shift -> quantize -> sink
+static std::vector<StageSpec> pipeline_specs() {
+    return {
+        {"iq_out", "external", {}, {"quantize"}},
+        {"quantize", "quantize", {}, {"shift"}},
+        {"shift", "frequency_shift", {{"shift_hz", SHIFT_HZ}}, {"gain"}},
+        {"gain", "gain", {{"gain_db", GAIN_DB}}, {"sum"}},
+        {"sum", "sum", {}, {"gps", "glonass"}},
+        {"gps", "external", {}, {}},
+        {"glonass", "external", {}, {}},
+    };
+}
+
+struct GraphShape {
+    size_t stages, tasks, fused, levels, buffers;
+};
+
+static std::vector<std::complex<int16_t>> run_pipeline(size_t worker_threads, int chunk_samples, int chunk_count,
+                                                       GraphShape* shape = nullptr) {
+    ToneConstellation gps(0.011, 9000.0);
+    ToneConstellation glonass(-0.037, 7000.0);
+    std::vector<std::complex<int16_t>> output;
+
+    std::map<std::string, std::unique_ptr<IStage>> external;
+    external["gps"] = std::make_unique<ConstellationSourceStage>(gps);
+    external["glonass"] = std::make_unique<ConstellationSourceStage>(glonass);
+    external["iq_out"] = std::make_unique<CallbackSinkStage>(
+        [&output](const std::complex<int16_t>* samples, int count, double) {
+            output.insert(output.end(), samples, samples + count);
+        });
+
+    GlobalConfig config;
+    auto graph = build_stage_graph(pipeline_specs(), external, config, worker_threads);
+    graph->compile(chunk_samples);
+    for (int chunk = 0; chunk < chunk_count; ++chunk) {
+        graph->run(chunk_samples, chunk * chunk_samples / config.sampling_rate_hz);
+    }
+    if (shape) {
+        *shape = {graph->get_stage_count(), graph->get_task_count(), graph->get_fused_stage_count(),
+                  graph->get_level_count(), graph->get_buffer_count()};
+    }
+    return output;
+}
+
+bool test_pipeline_output() {
+    std::cout << "=== Stage Graph Pipeline Test ===" << std::endl;
+
+    const int chunk_samples = 5000;
+    const int chunk_count = 4;
+    GraphShape shape;
+    auto output = run_pipeline(0, chunk_samples, chunk_count, &shape);
+
+    // Reference: the same chain written out by hand
+    ToneConstellation gps(0.011, 9000.0);
+    ToneConstellation glonass(-0.037, 7000.0);
+    std::vector<std::complex<int16_t>> a(output.size()), b(output.size());
+    gps.generate_chunk(a.data(), static_cast<int>(a.size()), 0.0);
+    glonass.generate_chunk(b.data(), static_cast<int>(b.size()), 0.0);
+    double gain = std::pow(10.0, GAIN_DB / 20.0);
+    double fs = GlobalConfig::DEFAULT_SAMPLING_RATE;
+    int worst = 0;
+    for (size_t n = 0; n < output.size(); ++n) {
+        std::complex<double> sum(a[n].real() + b[n].real(), a[n].imag() + b[n].imag());
+        std::complex<double> expected = sum * gain * std::polar(1.0, 2.0 * M_PI * SHIFT_HZ * n / fs);
+        worst = std::max(worst, static_cast<int>(std::abs(std::lround(expected.real()) - output[n].real())));
+        worst = std::max(worst, static_cast<int>(std::abs(std::lround(expected.imag()) - output[n].imag())));
+    }
+
+    std::cout << "  " << shape.stages << " stages -> " << shape.tasks << " tasks (" << shape.fused << " fused), "
+              << shape.levels << " levels, " << shape.buffers << " pooled buffers" << std::endl;
+    std::cout << "  Samples: " << output.size() << ", max deviation from reference: " << worst << " LSB" << std::endl;
+
+    // gain and shift fuse into sum; the quantizer reuses a source buffer slot
+    return output.size() == static_cast<size_t>(chunk_samples) * chunk_count && worst <= 1 &&
+           shape.tasks == 5 && shape.fused == 2 && shape.levels == 4 && shape.buffers == 3;
+}
+
+bool test_concurrent_matches_inline() {
+    std::cout << "=== Stage Graph Thread Pool Test ===" << std::endl;
+    auto inline_output = run_pipeline(0, 4096, 6);
+    auto pooled_output = run_pipeline(3, 4096, 6);
+    bool identical = inline_output == pooled_output;
+    std::cout << "  Three workers " << (identical ? "match" : "differ from") << " inline execution" << std::endl;
+    return identical;
+}
+
+// Callback source fanned out to two sinks, as quad_gnss_sim wires generate -> monitor, output
+bool test_callback_fan_out() {
+    std::cout << "=== Stage Graph Fan-Out Test ===" << std::endl;
+    StageGraph graph;
+    uint64_t next_sample = 0;
+    std::vector<std::complex<int16_t>> monitored, written;
+    std::vector<double> times;
+    graph.add_stage("generate", std::make_unique<CallbackSourceStage>(
+        [&next_sample](std::complex<int16_t>* chunk, int count, double) {
+            for (int i = 0; i < count; ++i, ++next_sample) {
+                chunk[i] = std::complex<int16_t>(static_cast<int16_t>(next_sample), static_cast<int16_t>(-1));
+            }
+        }));
+    graph.add_stage("monitor", std::make_unique<CallbackSinkStage>(
+        [&](const std::complex<int16_t>* chunk, int count, double time_now) {
+            monitored.insert(monitored.end(), chunk, chunk + count);
+            times.push_back(time_now);
+        }));
+    graph.add_stage("output", std::make_unique<CallbackSinkStage>(
+        [&](const std::complex<int16_t>* chunk, int count, double) {
+            written.insert(written.end(), chunk, chunk + count);
+        }));
+    graph.connect("generate", "monitor");
+    graph.connect("generate", "output");
+    graph.compile(1000);
+    graph.run(1000, 0.5);
+    graph.run(600, 0.75);
+
+    bool ok = monitored == written && written.size() == 1600 && written[1599].real() == 1599 &&
+              times == std::vector<double>{0.5, 0.75} && graph.get_buffer_count() == 1 && graph.get_level_count() == 2;
+    std::cout << "  " << written.size() << " samples to both sinks from " << graph.get_buffer_count()
+              << " pooled buffer" << std::endl;
+    return ok;
+}
+
+// The stage feeding the output writes into caller slots, as quad_gnss_sim renders into its shared-memory ring
+bool test_output_target() {
+    std::cout << "=== Stage Graph Output Target Test ===" << std::endl;
+    StageGraph graph;
+    std::vector<std::complex<int16_t>> slots[2] = {std::vector<std::complex<int16_t>>(1000),
+                                                   std::vector<std::complex<int16_t>>(1000)};
+    size_t next_slot = 0;
+    std::vector<const std::complex<int16_t>*> seen;
+    bool values_ok = true;
+    graph.add_stage("generate", std::make_unique<CallbackSourceStage>(
+        [](std::complex<int16_t>* chunk, int count, double time_now) {
+            for (int i = 0; i < count; ++i) {
+                chunk[i] = std::complex<int16_t>(static_cast<int16_t>(i), static_cast<int16_t>(time_now));
+            }
+        }));
+    graph.add_stage("sum", std::make_unique<SumCombinerStage>(1));
+    graph.add_stage("gain", std::make_unique<GainStage>(6.0206));
+    size_t quantize = graph.add_stage("quantize", std::make_unique<QuantizeStage>());
+    graph.add_stage("output", std::make_unique<CallbackSinkStage>(
+        [&](const std::complex<int16_t>* chunk, int count, double time_now) {
+            seen.push_back(chunk);
+            for (int i = 0; i < count; ++i) {
+                values_ok = values_ok && chunk[i] == std::complex<int16_t>(static_cast<int16_t>(2 * i),
+                                                                           static_cast<int16_t>(2 * time_now));
+            }
+        }));
+    graph.connect("generate", "sum");
+    graph.connect("sum", "gain");
+    graph.connect("gain", "quantize");
+    graph.connect("quantize", "output");
+    graph.set_output_target(quantize, [&] { return static_cast<void*>(slots[next_slot++ % 2].data()); });
+    graph.compile(1000);
+    graph.run(1000, 3.0);
+    graph.run(400, 5.0);
+
+    bool ok = values_ok && seen.size() == 2 && seen[0] == slots[0].data() && seen[1] == slots[1].data() &&
+              slots[0][999] == std::complex<int16_t>(1998, 6) && slots[1][400] == std::complex<int16_t>(0, 0);
+    std::cout << "  2 chunks quantized straight into caller slots: " << (ok ? "✅" : "❌") << std::endl;
+
+    // Sinks have no output to place
+    try {
+        StageGraph sinkless;
+        size_t sink = sinkless.add_stage("output", std::make_unique<CallbackSinkStage>(
+            [](const std::complex<int16_t>*, int, double) {}));
+        sinkless.set_output_target(sink, [] { return static_cast<void*>(nullptr); });
+        ok = false;
+    } catch (const QuadGNSSException&) {
+    }
+    return ok;
+}
+
+bool test_invalid_graphs() {
+    GlobalConfig config;
+    ToneConstellation tone(0.01, 1000.0);
+
+    // Sink fed with float samples
+    {
+        StageGraph graph;
+        graph.add_stage("src", std::make_unique<ConstellationSourceStage>(tone));
+        graph.add_stage("sum", std::make_unique<SumCombinerStage>(1));
+        graph.add_stage("sink", std::make_unique<CallbackSinkStage>([](const std::complex<int16_t>*, int, double) {}));
+        graph.connect("src", "sum");
+        try {
+            graph.connect("sum", "sink");
+            return false;
+        } catch (const QuadGNSSException&) {
+        }
+        // Unconnected sink input
+        try {
+            graph.compile(128);
+            return false;
+        } catch (const QuadGNSSException&) {
+        }
+    }
+
+    // Cycle through two gains
+    {
+        StageGraph graph;
+        graph.add_stage("a", std::make_unique<GainStage>(0.0));
+        graph.add_stage("b", std::make_unique<GainStage>(0.0));
+        graph.add_stage("q", std::make_unique<QuantizeStage>());
+        graph.add_stage("sink", std::make_unique<CallbackSinkStage>([](const std::complex<int16_t>*, int, double) {}));
+        graph.connect("a", "b");
+        graph.connect("b", "a");
+        graph.connect("b", "q");
+        graph.connect("q", "sink");
+        try {
+            graph.compile(128);
+            return false;
+        } catch (const QuadGNSSException&) {
+        }
+    }
+
+    // Unknown stage type
+    std::map<std::string, std::unique_ptr<IStage>> external;
+    try {
+        build_stage_graph({{"x", "reverb", {}, {}}}, external, config);
+        return false;
+    } catch (const QuadGNSSException&) {
+        return true;
+    }
+}
+
+int main() {
+    bool ok = test_pipeline_output();
+    ok = test_concurrent_matches_inline() && ok;
+    ok = test_callback_fan_out() && ok;
+    ok = test_output_target() && ok;
+    ok = test_invalid_graphs() && ok;
+
+    if (ok) {
+        std::cout << "✅ Stage graph tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Stage graph tests failed" << std::endl;
+    return 1;
+}
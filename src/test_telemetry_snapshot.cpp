@@ -0,0 +1,171 @@
+#include "../include/quad_gnss_interface.h"
+#include "../include/telemetry_snapshot.h"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace QuadGNSS;
+
+// Heap allocations made by this process, to check the per-chunk path does not allocate
+static std::atomic<uint64_t> heap_allocations(0);
+
+void* operator new(size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    std::free(block);
+}
+
+// Payload whose fields are all derived from one counter, so a torn read is detectable
+struct CounterPayload {
+    uint64_t values[64];
+};
+
+bool test_seqlock_consistency() {
+    std::cout << "=== Seqlock Consistency Test ===" << std::endl;
+
+    SeqlockSnapshot<CounterPayload> channel;
+    std::atomic<bool> done(false);
+    std::atomic<int> torn_reads(0);
+    std::atomic<uint64_t> total_reads(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            CounterPayload local;
+            while (!done.load(std::memory_order_relaxed)) {
+                if (channel.read(local) == 0) continue;  // Nothing published yet
+                for (size_t i = 1; i < 64; ++i) {
+                    if (local.values[i] != local.values[0] + i) {
+                        torn_reads++;
+                        break;
+                    }
+                }
+                total_reads++;
+            }
+        });
+    }
+
+    CounterPayload payload;
+    for (uint64_t n = 0; n < 200000; ++n) {
+        for (size_t i = 0; i < 64; ++i) {
+            payload.values[i] = n + i;
+        }
+        channel.publish(payload);
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    std::cout << "  Publishes: " << channel.version() << std::endl;
+    std::cout << "  Reads: " << total_reads.load() << ", torn: " << torn_reads.load() << std::endl;
+    return torn_reads.load() == 0 && channel.version() == 200000;
+}
+
+bool test_orchestrator_telemetry() {
+    std::cout << "=== Orchestrator Telemetry Test ===" << std::endl;
+
+    GlobalConfig config;
+    SignalOrchestrator orchestrator(config);
+    orchestrator.add_constellation(ConstellationFactory::create_constellation(ConstellationType::GPS));
+    orchestrator.add_constellation(ConstellationFactory::create_constellation(ConstellationType::GLONASS));
+    orchestrator.initialize({{ConstellationType::GPS, "gps.brdc"},
+                             {ConstellationType::GLONASS, "glo.rnx"}});
+
+    TelemetrySnapshot snapshot;
+    if (orchestrator.telemetry().version() != 0) {
+        std::cout << "  Telemetry published before first chunk" << std::endl;
+        return false;
+    }
+
+    const int sample_count = 600;
+    const int chunk_count = 500;
+    std::atomic<bool> done(false);
+    std::atomic<bool> monotonic(true);
+
+    // Monitoring thread polls without ever touching the constellations
+    std::thread monitor([&]() {
+        TelemetrySnapshot seen;
+        uint64_t last_chunk = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            if (orchestrator.telemetry().read(seen) == 0) continue;
+            if (seen.chunk_index < last_chunk ||
+                seen.sample_index != seen.chunk_index * sample_count ||
+                seen.satellite_count != 4) {
+                monotonic = false;
+            }
+            last_chunk = seen.chunk_index;
+        }
+    });
+
+    std::vector<std::complex<int16_t>> buffer(sample_count);
+    for (int chunk = 0; chunk < chunk_count; ++chunk) {
+        orchestrator.mix_all_signals(buffer.data(), sample_count, chunk * 1e-5);
+    }
+    done = true;
+    monitor.join();
+
+    uint64_t version = orchestrator.telemetry().read(snapshot);
+    std::cout << "  Snapshots published: " << version << std::endl;
+    std::cout << "  Last chunk: " << snapshot.chunk_index
+              << ", satellites: " << snapshot.satellite_count << std::endl;
+
+    return monotonic.load() &&
+           version == static_cast<uint64_t>(chunk_count) &&
+           snapshot.chunk_index == static_cast<uint64_t>(chunk_count - 1) &&
+           snapshot.satellite_count == 4 &&
+           snapshot.satellites[0].constellation == ConstellationType::GPS &&
+           snapshot.satellites[2].constellation == ConstellationType::GLONASS;
+}
+
+bool test_publish_without_allocation() {
+    std::cout << "=== Allocation-Free Publish Test ===" << std::endl;
+
+    GlobalConfig config;
+    SignalOrchestrator orchestrator(config);
+    orchestrator.add_constellation(ConstellationFactory::create_constellation(ConstellationType::GPS));
+    orchestrator.add_constellation(ConstellationFactory::create_constellation(ConstellationType::BEIDOU));
+    orchestrator.initialize({{ConstellationType::GPS, "gps.brdc"},
+                             {ConstellationType::BEIDOU, "bds.rnx"}});
+
+    // The first chunk sizes the lanes; later chunks only generate and publish
+    std::vector<std::complex<int16_t>> buffer(600);
+    orchestrator.mix_all_signals(buffer.data(), 600, 0.0);
+    uint64_t before = heap_allocations.load();
+    for (int chunk = 1; chunk <= 100; ++chunk) {
+        orchestrator.mix_all_signals(buffer.data(), 600, chunk * 1e-5);
+    }
+    uint64_t allocations = heap_allocations.load() - before;
+
+    TelemetrySnapshot snapshot;
+    orchestrator.telemetry().read(snapshot);
+    std::cout << "  Allocations over 100 chunks: " << allocations
+              << ", satellites: " << snapshot.satellite_count << std::endl;
+    return allocations == 0 && snapshot.satellite_count == 4;
+}
+
+int main() {
+    bool ok = test_seqlock_consistency();
+    ok = test_orchestrator_telemetry() && ok;
+    ok = test_publish_without_allocation() && ok;
+
+    if (ok) {
+        std::cout << "✅ Telemetry snapshot tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Telemetry snapshot tests failed" << std::endl;
+    return 1;
+}
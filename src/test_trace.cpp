@@ -0,0 +1,227 @@
+#include "../include/trace.h"
+#include "../include/multi_band.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace QuadGNSS;
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+static size_t count_of(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) count++;
+    return count;
+}
+
+// Begin minus end events per thread of a Chrome trace; all zero when every slice is closed
+static std::map<std::string, int> open_slices(const std::string& json) {
+    std::map<std::string, int> open;
+    std::istringstream lines(json);
+    std::string line;
+    while (std::getline(lines, line)) {
+        size_t tid = line.find("\"tid\":");
+        if (tid == std::string::npos || line.find("\"ph\":\"M\"") != std::string::npos) continue;
+        std::string thread = line.substr(tid + 6, line.find_first_of(",}", tid) - tid - 6);
+        open[thread] += line.find("\"ph\":\"B\"") != std::string::npos ? 1 : -1;
+    }
+    return open;
+}
+
+// Minimal protobuf reader for the Perfetto output
+struct ProtoField {
+    uint32_t field;
+    uint64_t value;                            // Varint value or payload length
+    std::string bytes;                         // Length-delimited payload
+};
+
+static bool read_varint(const std::string& data, size_t& at, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; at < data.size() && shift < 64; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(data[at++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool parse_proto(const std::string& data, std::vector<ProtoField>& fields) {
+    size_t at = 0;
+    while (at < data.size()) {
+        uint64_t key, value;
+        if (!read_varint(data, at, key) || !read_varint(data, at, value)) return false;
+        ProtoField f{static_cast<uint32_t>(key >> 3), value, ""};
+        if ((key & 7) == 2) {
+            if (value > data.size() - at) return false;
+            f.bytes = data.substr(at, value);
+            at += value;
+        } else if ((key & 7) != 0) {
+            return false;
+        }
+        fields.push_back(f);
+    }
+    return true;
+}
+
+static void traced_work(const std::string& name, int slices) {
+    QGNSS_TRACE_THREAD_NAME(name);
+    for (int i = 0; i < slices; ++i) {
+        QGNSS_TRACE_SCOPE_ARG("test", "outer", "index", i);
+        QGNSS_TRACE_SCOPE("test", "inner");
+    }
+}
+
+bool test_recording() {
+    std::cout << "=== Trace Recording Test ===" << std::endl;
+    traced_work("before start", 10);
+    bool ok = Tracer::stats().events == 0;
+
+    Tracer::start();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back(traced_work, "worker " + std::to_string(t), 1000);
+    }
+    for (auto& thread : threads) thread.join();
+    Tracer::stop();
+    traced_work("after stop", 10);
+    TraceStats stats = Tracer::stats();
+    ok = ok && stats.events == 4 * 1000 * 4 && stats.dropped == 0 && stats.threads == 4;
+    std::cout << "  " << stats.events << " events from " << stats.threads << " threads: " << (ok ? "✅" : "❌")
+              << std::endl;
+
+    const std::string pid = std::to_string(getpid());
+    const std::string json_path = "trace_test_" + pid + ".json";
+    const std::string proto_path = "trace_test_" + pid + ".pftrace";
+    Tracer::write(json_path);
+    Tracer::write(proto_path);
+
+    const std::string json = read_file(json_path);
+    bool balanced = json.rfind("{\"displayTimeUnit", 0) == 0 && json.find("\n]}") != std::string::npos;
+    for (const auto& entry : open_slices(json)) balanced = balanced && entry.second == 0;
+    balanced = balanced && count_of(json, "\"ph\":\"B\"") == 8000 && count_of(json, "\"ph\":\"E\"") == 8000 &&
+               count_of(json, "\"thread_name\"") == 4 && json.find("\"worker 3\"") != std::string::npos &&
+               json.find("\"args\":{\"index\":999}") != std::string::npos;
+    std::cout << "  Chrome JSON balanced per thread: " << (balanced ? "✅" : "❌") << std::endl;
+
+    // Perfetto: one track descriptor per thread, then that thread's slices in time order
+    std::vector<ProtoField> packets;
+    bool decoded = parse_proto(read_file(proto_path), packets);
+    size_t descriptors = 0, begins = 0, ends = 0, named = 0;
+    bool ordered = true;
+    std::map<uint64_t, uint64_t> last_time;
+    for (const auto& packet : packets) {
+        std::vector<ProtoField> fields;
+        decoded = decoded && packet.field == 1 && parse_proto(packet.bytes, fields);
+        uint64_t time = 0, sequence = 0;
+        for (const auto& f : fields) {
+            if (f.field == 8) time = f.value;
+            if (f.field == 10) sequence = f.value;
+            if (f.field == 60) descriptors++;
+            if (f.field != 11) continue;
+            std::vector<ProtoField> event;
+            decoded = decoded && parse_proto(f.bytes, event);
+            for (const auto& e : event) {
+                if (e.field == 9) (e.value == 1 ? begins : ends)++;
+                if (e.field == 23 && (e.bytes == "outer" || e.bytes == "inner")) named++;
+            }
+        }
+        ordered = ordered && time >= last_time[sequence];
+        last_time[sequence] = time;
+    }
+    bool perfetto = decoded && ordered && descriptors == 4 && begins == 8000 && ends == 8000 && named == 8000;
+    std::cout << "  Perfetto protobuf: " << packets.size() << " packets, " << descriptors << " tracks: "
+              << (perfetto ? "✅" : "❌") << std::endl;
+    std::remove(json_path.c_str());
+    std::remove(proto_path.c_str());
+
+    // A full buffer drops whole slices, never an end whose begin was kept
+    Tracer::start(64);
+    traced_work("small buffer", 100);
+    Tracer::stop();
+    TraceStats small = Tracer::stats();
+    Tracer::write(json_path);
+    bool bounded = small.events <= 64 && small.events % 2 == 0 && small.dropped > 0;
+    for (const auto& entry : open_slices(read_file(json_path))) bounded = bounded && entry.second == 0;
+    std::remove(json_path.c_str());
+    std::cout << "  Full buffer: " << small.events << " kept, " << small.dropped << " dropped, balanced: "
+              << (bounded ? "✅" : "❌") << std::endl;
+    return ok && balanced && perfetto && bounded;
+}
+
+bool test_disabled_overhead() {
+    std::cout << "=== Disabled Tracing Overhead ===" << std::endl;
+    GlobalConfig config;
+    config.sampling_rate_hz = 4.092e6;
+    config.center_frequency_hz = 1575.42e6;
+    MultiBandGenerator generator(config);
+    for (int prn : {2, 3, 6, 12, 17, 19, 24, 28}) {
+        generator.backbone().add_satellite(ConstellationType::GPS, prn);
+    }
+    generator.add_band({SignalBand::GPS_L1CA, 0.0});
+    const int sample_count = 40920;
+    std::vector<std::complex<int16_t>> samples(sample_count);
+    std::complex<int16_t>* buffers[1] = {samples.data()};
+
+    // Trace points per 10 ms chunk, counted by tracing one chunk
+    Tracer::start();
+    generator.generate_chunk(buffers, sample_count, 1000.0);
+    Tracer::stop();
+    const uint64_t points = Tracer::stats().events / 2;
+
+    const int chunks = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < chunks; ++k) {
+        generator.generate_chunk(buffers, sample_count, 1000.01 + k * 0.01);
+    }
+    double chunk_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / chunks;
+
+    const int scopes = 2000000;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < scopes; ++i) {
+        QGNSS_TRACE_SCOPE_ARG("test", "off", "i", i);
+    }
+    double scope_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / scopes;
+
+    double overhead = points * scope_s / chunk_s;
+    bool ok = points > 0 && overhead < 0.01;
+    std::cout << "  " << points << " trace points per chunk of " << chunk_s * 1e3 << " ms, " << scope_s * 1e9
+              << " ns each when off: " << overhead * 100 << "% " << (ok ? "✅" : "❌") << std::endl;
+    return ok;
+}
+
+// Built with QUADGNSS_TRACING=0 the trace points are gone even while the tracer runs
+bool test_compiled_out() {
+    std::cout << "=== Tracing Compiled Out ===" << std::endl;
+    Tracer::start();
+    traced_work("compiled out", 100);
+    Tracer::stop();
+    bool ok = Tracer::stats().events == 0 && Tracer::stats().threads == 0;
+    std::cout << "  No events recorded: " << (ok ? "✅" : "❌") << std::endl;
+    return ok;
+}
+
+int main() {
+#if QUADGNSS_TRACING
+    bool ok = test_recording();
+    ok = test_disabled_overhead() && ok;
+#else
+    bool ok = test_compiled_out();
+#endif
+
+    if (ok) {
+        std::cout << "✅ Trace tests passed" << std::endl;
+        return 0;
+    }
+    std::cerr << "❌ Trace tests failed" << std::endl;
+    return 1;
+}
@@ -0,0 +1,344 @@
+#include "../include/trace.h"
+#include "../include/quad_gnss_interface.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace QuadGNSS {
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+
+struct TraceEvent {
+    uint64_t time_ns;
+    const char* category;
+    const char* name;
+    const char* arg_name;
+    int64_t arg;
+    char phase;                                // 'B' or 'E'
+};
+
+// Events of one thread; only the owning thread appends
+struct ThreadBuffer {
+    std::unique_ptr<TraceEvent[]> events;
+    size_t capacity = 0;
+    std::atomic<size_t> count{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> alive{true};
+    size_t depth = 0;                          // Open slices
+    std::atomic<uint64_t> generation{0};       // start() call the events belong to
+    uint32_t track = 0;                        // Sequential thread number
+    int os_tid = 0;
+    std::string name;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;  // Kept after their thread exits
+    std::atomic<uint64_t> generation{0};
+    size_t capacity = Tracer::DEFAULT_EVENTS_PER_THREAD;
+    uint64_t start_ns = 0;
+};
+
+// Never destroyed: threads may still end slices during static destruction
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// The calling thread's buffer, released for reuse when the thread exits
+struct LocalBuffer {
+    ThreadBuffer* buffer = nullptr;
+    std::string name;
+    ~LocalBuffer() {
+        if (buffer) buffer->alive.store(false, std::memory_order_release);
+    }
+};
+thread_local LocalBuffer local;
+
+ThreadBuffer& own_buffer() {
+    if (local.buffer) return *local.buffer;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const uint64_t generation = reg.generation.load(std::memory_order_relaxed);
+    // A buffer of an exited thread whose events are no longer needed
+    for (auto& buffer : reg.buffers) {
+        if (!buffer->alive.load(std::memory_order_acquire) && buffer->generation.load(std::memory_order_relaxed) != generation) {
+            local.buffer = buffer.get();
+            break;
+        }
+    }
+    if (!local.buffer) {
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+        local.buffer = reg.buffers.back().get();
+        local.buffer->track = static_cast<uint32_t>(reg.buffers.size());
+        local.buffer->generation.store(~uint64_t(0), std::memory_order_relaxed);
+    }
+    local.buffer->alive.store(true, std::memory_order_relaxed);
+    local.buffer->os_tid = static_cast<int>(syscall(SYS_gettid));
+    local.buffer->name = local.name.empty() ? "thread " + std::to_string(local.buffer->track) : local.name;
+    return *local.buffer;
+}
+
+void append(ThreadBuffer& buffer, size_t index, char phase, const char* category, const char* name,
+            const char* arg_name, int64_t arg) {
+    buffer.events[index] = TraceEvent{now_ns(), category, name, arg_name, arg, phase};
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+// Buffers holding events of the current trace
+std::vector<const ThreadBuffer*> traced_buffers() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<const ThreadBuffer*> traced;
+    const uint64_t generation = reg.generation.load(std::memory_order_relaxed);
+    for (const auto& buffer : reg.buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) == generation && buffer->count.load(std::memory_order_acquire) > 0) {
+            traced.push_back(buffer.get());
+        }
+    }
+    return traced;
+}
+
+std::string json_string(const char* text) {
+    std::string out = "\"";
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        if (static_cast<unsigned char>(*c) >= 0x20) out += *c;
+    }
+    return out + "\"";
+}
+
+// Protocol buffer encoding, just enough for Perfetto's TracePacket
+void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void put_uint(std::string& out, uint32_t field, uint64_t value) {
+    put_varint(out, static_cast<uint64_t>(field) << 3);
+    put_varint(out, value);
+}
+
+void put_bytes(std::string& out, uint32_t field, const std::string& bytes) {
+    put_varint(out, (static_cast<uint64_t>(field) << 3) | 2);
+    put_varint(out, bytes.size());
+    out += bytes;
+}
+
+// Field numbers from perfetto/protos/perfetto/trace
+enum : uint32_t {
+    TRACE_PACKET = 1,                          // Trace.packet
+    PACKET_TIMESTAMP = 8,
+    PACKET_SEQUENCE_ID = 10,                   // trusted_packet_sequence_id
+    PACKET_TRACK_EVENT = 11,
+    PACKET_SEQUENCE_FLAGS = 13,
+    PACKET_TRACK_DESCRIPTOR = 60,
+    TRACK_UUID = 1,                            // TrackDescriptor
+    TRACK_THREAD = 4,
+    THREAD_PID = 1,                            // ThreadDescriptor
+    THREAD_TID = 2,
+    THREAD_NAME = 5,
+    EVENT_ANNOTATIONS = 4,                     // TrackEvent
+    EVENT_TYPE = 9,
+    EVENT_TRACK_UUID = 11,
+    EVENT_CATEGORIES = 22,
+    EVENT_NAME = 23,
+    ANNOTATION_INT = 4,                        // DebugAnnotation
+    ANNOTATION_NAME = 10,
+    SLICE_BEGIN = 1,
+    SLICE_END = 2,
+    SEQ_INCREMENTAL_STATE_CLEARED = 1
+};
+
+} // namespace
+
+void Tracer::start(size_t events_per_thread) {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.capacity = std::max<size_t>(16, events_per_thread);
+        reg.start_ns = now_ns();
+        // Each thread clears its own buffer when it records the first event of the new generation
+        reg.generation.fetch_add(1, std::memory_order_release);
+    }
+    enabled_.store(true, std::memory_order_release);
+}
+
+void Tracer::stop() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+bool Tracer::begin(const char* category, const char* name, const char* arg_name, int64_t arg) {
+    if (!enabled()) return false;
+    Registry& reg = registry();
+    ThreadBuffer& buffer = own_buffer();
+    const uint64_t generation = reg.generation.load(std::memory_order_acquire);
+    if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+        if (buffer.capacity != reg.capacity) {
+            buffer.events.reset(new TraceEvent[reg.capacity]);
+            buffer.capacity = reg.capacity;
+        }
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.depth = 0;
+        buffer.generation.store(generation, std::memory_order_release);
+    }
+
+    // Room for this slice and the end of every open one
+    const size_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index + buffer.depth + 2 > buffer.capacity) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    append(buffer, index, 'B', category, name, arg_name, arg);
+    buffer.depth++;
+    return true;
+}
+
+void Tracer::end(const char* category, const char* name) {
+    ThreadBuffer* buffer = local.buffer;
+    // Slices begun before the last start() are not part of this trace
+    if (!buffer || buffer->depth == 0 || buffer->generation.load(std::memory_order_relaxed) != registry().generation.load(std::memory_order_acquire)) {
+        return;
+    }
+    append(*buffer, buffer->count.load(std::memory_order_relaxed), 'E', category, name, nullptr, 0);
+    buffer->depth--;
+}
+
+void Tracer::set_thread_name(const std::string& name) {
+    local.name = name;
+    if (local.buffer) {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        local.buffer->name = name;
+    }
+}
+
+TraceStats Tracer::stats() {
+    TraceStats stats{0, 0, 0};
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const uint64_t generation = reg.generation.load(std::memory_order_relaxed);
+    for (const auto& buffer : reg.buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) != generation) continue;
+        stats.events += buffer->count.load(std::memory_order_acquire);
+        stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+        stats.threads++;
+    }
+    return stats;
+}
+
+void Tracer::write(const std::string& path) {
+    const std::string suffix = ".json";
+    if (path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        write_chrome_json(path);
+    } else {
+        write_perfetto(path);
+    }
+}
+
+void Tracer::write_chrome_json(const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        throw QuadGNSSException("Cannot open trace file: " + path);
+    }
+    const int pid = static_cast<int>(getpid());
+    const uint64_t start = registry().start_ns;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    char ts[32];
+    for (const ThreadBuffer* buffer : traced_buffers()) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":"
+            << buffer->os_tid << ",\"args\":{\"name\":" << json_string(buffer->name.c_str()) << "}}";
+        first = false;
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& e = buffer->events[i];
+            // Microseconds with nanosecond digits
+            std::snprintf(ts, sizeof(ts), "%.3f", static_cast<double>(e.time_ns - start) / 1e3);
+            out << ",\n{\"name\":" << json_string(e.name) << ",\"cat\":" << json_string(e.category) << ",\"ph\":\""
+                << e.phase << "\",\"ts\":" << ts << ",\"pid\":" << pid << ",\"tid\":" << buffer->os_tid;
+            if (e.arg_name) {
+                out << ",\"args\":{" << json_string(e.arg_name) << ":" << e.arg << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    if (!out.flush()) {
+        throw QuadGNSSException("Cannot write trace file: " + path);
+    }
+}
+
+void Tracer::write_perfetto(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw QuadGNSSException("Cannot open trace file: " + path);
+    }
+    const int pid = static_cast<int>(getpid());
+    std::string packet, body, nested, trace;
+    for (const ThreadBuffer* buffer : traced_buffers()) {
+        // One packet sequence and one track per thread, opened by the thread's descriptor
+        const uint32_t sequence = buffer->track;
+        const uint64_t track_uuid = (static_cast<uint64_t>(pid) << 32) | buffer->track;
+        nested.clear();
+        put_uint(nested, THREAD_PID, static_cast<uint32_t>(pid));
+        put_uint(nested, THREAD_TID, static_cast<uint32_t>(buffer->os_tid));
+        put_bytes(nested, THREAD_NAME, buffer->name);
+        body.clear();
+        put_uint(body, TRACK_UUID, track_uuid);
+        put_bytes(body, TRACK_THREAD, nested);
+        packet.clear();
+        put_uint(packet, PACKET_SEQUENCE_ID, sequence);
+        put_uint(packet, PACKET_SEQUENCE_FLAGS, SEQ_INCREMENTAL_STATE_CLEARED);
+        put_bytes(packet, PACKET_TRACK_DESCRIPTOR, body);
+        trace.clear();
+        put_bytes(trace, TRACE_PACKET, packet);
+        out.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& e = buffer->events[i];
+            body.clear();
+            put_uint(body, EVENT_TYPE, e.phase == 'B' ? SLICE_BEGIN : SLICE_END);
+            put_uint(body, EVENT_TRACK_UUID, track_uuid);
+            if (e.phase == 'B') {
+                put_bytes(body, EVENT_CATEGORIES, e.category);
+                put_bytes(body, EVENT_NAME, e.name);
+                if (e.arg_name) {
+                    nested.clear();
+                    put_bytes(nested, ANNOTATION_NAME, e.arg_name);
+                    put_uint(nested, ANNOTATION_INT, static_cast<uint64_t>(e.arg));
+                    put_bytes(body, EVENT_ANNOTATIONS, nested);
+                }
+            }
+            packet.clear();
+            put_uint(packet, PACKET_TIMESTAMP, e.time_ns);
+            put_uint(packet, PACKET_SEQUENCE_ID, sequence);
+            put_bytes(packet, PACKET_TRACK_EVENT, body);
+            trace.clear();
+            put_bytes(trace, TRACE_PACKET, packet);
+            out.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+        }
+    }
+    if (!out.flush()) {
+        throw QuadGNSSException("Cannot write trace file: " + path);
+    }
+}
+
+} // namespace QuadGNSS